@@ -13,6 +13,7 @@ onnxruntime_add_static_library(onnxruntime_mlas
   ${MLAS_SRC_DIR}/threading.cpp
   ${MLAS_SRC_DIR}/sgemm.cpp
   ${MLAS_SRC_DIR}/halfgemm.cpp
+  ${MLAS_SRC_DIR}/bf16gemm.cpp
   ${MLAS_SRC_DIR}/qgemm.cpp
   ${MLAS_SRC_DIR}/qdwconv.cpp
   ${MLAS_SRC_DIR}/convolve.cpp
@@ -26,6 +27,11 @@ onnxruntime_add_static_library(onnxruntime_mlas
   ${MLAS_SRC_DIR}/tanh.cpp
   ${MLAS_SRC_DIR}/erf.cpp
   ${MLAS_SRC_DIR}/compute.cpp
+  ${MLAS_SRC_DIR}/reduce.cpp
+  ${MLAS_SRC_DIR}/layernorm.cpp
+  ${MLAS_SRC_DIR}/resize.cpp
+  ${MLAS_SRC_DIR}/flashattn.cpp
+  ${MLAS_SRC_DIR}/sparse_gemm.cpp
   ${MLAS_SRC_DIR}/quantize.cpp
   ${MLAS_SRC_DIR}/qgemm_kernel_default.cpp
   ${MLAS_SRC_DIR}/qladd.cpp
@@ -153,10 +159,12 @@ function(setup_mlas_source_for_windows)
       ${mlas_platform_srcs_avx}
       ${mlas_platform_srcs_avx2}
       ${MLAS_SRC_DIR}/qgemm_kernel_amx.cpp
+      ${MLAS_SRC_DIR}/bf16gemm_kernel_amx.cpp
       ${MLAS_SRC_DIR}/qgemm_kernel_avx2.cpp
       ${MLAS_SRC_DIR}/qgemm_kernel_sse.cpp
       ${MLAS_SRC_DIR}/qgemm_kernel_sse41.cpp
       ${MLAS_SRC_DIR}/intrinsics/avx512/quantize_avx512f.cpp
+      ${MLAS_SRC_DIR}/intrinsics/avx512/sparse_gemm_avx512f.cpp
       ${MLAS_SRC_DIR}/amd64/QgemmU8S8KernelAmx.asm
       ${MLAS_SRC_DIR}/amd64/QgemmU8S8KernelAvx2.asm
       ${MLAS_SRC_DIR}/amd64/QgemmU8U8KernelAvx2.asm
@@ -195,8 +203,12 @@ function(setup_mlas_source_for_windows)
     )
     if (NOT onnxruntime_ORT_MINIMAL_BUILD)
       target_sources(onnxruntime_mlas PRIVATE
+        ${MLAS_SRC_DIR}/q4gemm_avx2.cpp
+        ${MLAS_SRC_DIR}/q4gemm_avxvnni.cpp
         ${MLAS_SRC_DIR}/q4gemm_avx512.cpp
+        ${MLAS_SRC_DIR}/bf16gemm_kernel_avx512bf16.cpp
       )
+      set_property(SOURCE ${MLAS_SRC_DIR}/platform.cpp APPEND PROPERTY COMPILE_DEFINITIONS MLAS_AVXVNNI_INTRINSICS)
     endif()
 
   else()
@@ -505,6 +517,7 @@ else()
           ${MLAS_SRC_DIR}/x86_64/ErfKernelFma3.S
           ${MLAS_SRC_DIR}/intrinsics/avx2/qladd_avx2.cpp
           ${MLAS_SRC_DIR}/intrinsics/avx2/qdwconv_avx2.cpp
+          ${MLAS_SRC_DIR}/intrinsics/avx2/sparse_gemm_avx2.cpp
         )
         set_source_files_properties(${mlas_platform_srcs_avx2} PROPERTIES COMPILE_FLAGS "-mavx2 -mfma")
 
@@ -515,6 +528,7 @@ else()
           ${MLAS_SRC_DIR}/x86_64/SpoolKernelAvx512F.S
           ${MLAS_SRC_DIR}/x86_64/TransKernelAvx512F.S
           ${MLAS_SRC_DIR}/intrinsics/avx512/quantize_avx512f.cpp
+          ${MLAS_SRC_DIR}/intrinsics/avx512/sparse_gemm_avx512f.cpp
         )
         set_source_files_properties(${mlas_platform_srcs_avx512f} PROPERTIES COMPILE_FLAGS "-mavx512f")
 
@@ -542,18 +556,35 @@ else()
         if (NOT onnxruntime_ORT_MINIMAL_BUILD)
           set(mlas_platform_srcs
             ${mlas_platform_srcs}
+            ${MLAS_SRC_DIR}/q4gemm_avx2.cpp
             ${MLAS_SRC_DIR}/q4gemm_avx512.cpp
+            ${MLAS_SRC_DIR}/bf16gemm_kernel_avx512bf16.cpp
           )
+          set_source_files_properties(${MLAS_SRC_DIR}/q4gemm_avx2.cpp PROPERTIES COMPILE_FLAGS "-mavx2 -mfma")
           set_source_files_properties(${MLAS_SRC_DIR}/q4gemm_avx512.cpp PROPERTIES COMPILE_FLAGS "-mfma -mavx512vnni -mavx512bw -mavx512dq -mavx512vl -mavx512f")
+          set_source_files_properties(${MLAS_SRC_DIR}/bf16gemm_kernel_avx512bf16.cpp PROPERTIES COMPILE_FLAGS "-mavx512bf16 -mavx512bw -mavx512dq -mavx512vl -mavx512f")
+
+          # The AVX-VNNI intrinsics require GCC 11 or Clang 12.
+          check_cxx_compiler_flag("-mavxvnni" HAS_AVXVNNI)
+          if (HAS_AVXVNNI)
+            set(mlas_platform_srcs
+              ${mlas_platform_srcs}
+              ${MLAS_SRC_DIR}/q4gemm_avxvnni.cpp
+            )
+            set_source_files_properties(${MLAS_SRC_DIR}/q4gemm_avxvnni.cpp PROPERTIES COMPILE_FLAGS "-mavx2 -mfma -mavxvnni")
+            set_property(SOURCE ${MLAS_SRC_DIR}/platform.cpp APPEND PROPERTY COMPILE_DEFINITIONS MLAS_AVXVNNI_INTRINSICS)
+          endif()
         endif()
         if(NOT APPLE)
           set(mlas_platform_srcs
             ${mlas_platform_srcs}
 	        ${MLAS_SRC_DIR}/x86_64/QgemmU8S8KernelAmxCommon.S
             ${MLAS_SRC_DIR}/qgemm_kernel_amx.cpp
+            ${MLAS_SRC_DIR}/bf16gemm_kernel_amx.cpp
             ${MLAS_SRC_DIR}/x86_64/QgemmU8S8KernelAmx.S
             )
           set_source_files_properties(${MLAS_SRC_DIR}/qgemm_kernel_amx.cpp PROPERTIES COMPILE_FLAGS "-mavx2 -mavx512bw -mavx512dq -mavx512vl -mavx512f")
+          set_source_files_properties(${MLAS_SRC_DIR}/bf16gemm_kernel_amx.cpp PROPERTIES COMPILE_FLAGS "-mavx2 -mavx512bw -mavx512dq -mavx512vl -mavx512f")
           set_source_files_properties(${MLAS_SRC_DIR}/x86_64/QgemmU8S8KernelAmx.S PROPERTIES COMPILE_FLAGS "-mavx2 -mavx512bw -mavx512dq -mavx512vl -mavx512f")
 	    endif()
 
@@ -129,6 +129,27 @@ class OpKernel {
     return Status::OK();
   }
 
+  // Override this function to use pre-packed buffers that were serialized with an ORT format model, or found in the
+  // environment level shared pre-packed weights cache, instead of packing the constant initialized tensor again.
+  // The buffers were produced by PrePack() of the same kernel (with the same attributes and input types) for the same
+  // MLAS packed buffer format version and instruction set, and are in the order PrePack() stored them in
+  // PrePackedWeights.
+  // As PrePack() is skipped, the kernel MUST restore any other state it derives from the tensor in PrePack().
+  // @param tensor: The initialized constant tensor
+  // @param input_idx: The input index of the tensor in this kernel
+  // @param prepacked_buffers: The serialized pre-packed buffers. As in UseSharedPrePackedBuffers(), the deleter of
+  //                           each BufferUniquePtr is NULL as the kernel doesn't own the buffers.
+  // @param prepacked_buffer_sizes: The sizes of the serialized pre-packed buffers (in bytes)
+  // @param used_prepacked_buffers: Boolean flag set by the kernel implementation indicating that the provided
+  //                                buffers have been used. If false, PrePack() is invoked.
+  virtual Status UseSerializedPrePackedBuffers(const Tensor& /*tensor*/, int /*input_idx*/,
+                                               std::vector<BufferUniquePtr>& /*prepacked_buffers*/,
+                                               gsl::span<const size_t> /*prepacked_buffer_sizes*/,
+                                               /*out*/ bool& used_prepacked_buffers) {
+    used_prepacked_buffers = false;
+    return Status::OK();
+  }
+
   const OrtDevice GetDevice(OrtMemType mem_type) const;
   const OpKernelInfo& Info() const {
     return *op_kernel_info_;
@@ -16,6 +16,7 @@ limitations under the License.
 /* Modifications Copyright (c) Microsoft. */
 
 #pragma once
+#include <atomic>
 #include <string>
 #include <vector>
 #include <functional>
@@ -213,6 +214,46 @@ class ThreadPool {
     ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ParallelSection);
   };
 
+  // Thread budgets.
+  //
+  // A thread pool may be shared by several requests running
+  // concurrently, e.g. concurrent InferenceSession::Run calls on one
+  // session.  Without coordination each request sizes its parallel
+  // loops as if it owned every thread in the pool, and the requests
+  // end up oversubscribing the pool and interfering with each other.
+  //
+  // A thread budget scope registers the calling thread as a request
+  // using the pool.  While the scope is active, the degree of
+  // parallelism seen by loops started from the calling thread
+  // (DegreeOfParallelism, TryParallelFor, TrySimpleParallelFor,
+  // TryBatchParallelFor) is limited to the budget of the request:
+  //
+  // - thread_budget > 0 limits the request to that many threads,
+  //   including the calling thread.
+  //
+  // - thread_budget == 0 gives the request a fair share of the
+  //   threads that are not reserved by requests with an explicit
+  //   budget, split between all requests currently in a scope.
+  //
+  // Fair shares are recomputed at the start of each loop, so a
+  // request gets more threads as concurrent requests complete.  Like
+  // parallel sections, thread-local state is used to track the budget
+  // of the current thread.  Thread budgets only apply to the calling
+  // thread, and not to loops started by threads in the pool.
+
+  class ThreadBudgetScope {
+   public:
+    ThreadBudgetScope(ThreadPool* tp, int thread_budget);
+    ~ThreadBudgetScope();
+
+   private:
+    ThreadPool* tp_;
+    int thread_budget_;
+    const ThreadPool* prev_tp_;
+    int prev_thread_budget_;
+    ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ThreadBudgetScope);
+  };
+
   // The below API allows to disable spinning
   // This is used to support real-time scenarios where
   // spinning between relatively infrequent requests
@@ -373,6 +414,11 @@ class ThreadPool {
   // value returned by DegreeOfParallelism to code using the pool.
   int NumThreads() const;
 
+  // Returns the maximum degree of parallelism, including the calling thread, for
+  // loops started by the calling thread.  This is NumThreads() + 1 unless the
+  // calling thread is inside a ThreadBudgetScope for this pool.
+  int ThreadBudgetForCaller() const;
+
   // Returns current thread id between 0 and NumThreads() - 1, if called from a
   // thread in the pool. Returns -1 otherwise.
   int CurrentThreadId() const;
@@ -428,6 +474,11 @@ class ThreadPool {
 
   // Force the thread pool to run in hybrid mode on a normal cpu.
   bool force_hybrid_ = false;
+
+  // Number of active ThreadBudgetScope instances using the default fair share,
+  // and the total number of threads reserved by scopes with an explicit budget.
+  std::atomic<int> fair_share_requests_{0};
+  std::atomic<int> reserved_threads_{0};
 };
 
 }  // namespace concurrency
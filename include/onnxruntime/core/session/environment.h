@@ -13,6 +13,8 @@
 
 struct OrtThreadingOptions;
 namespace onnxruntime {
+class SharedPrepackedWeightsCache;
+
 /** TODO: remove this class
    Provides the runtime environment for onnxruntime.
    Create one instance for the duration of execution.
@@ -79,6 +81,14 @@ class Environment {
    */
   Status UnregisterAllocator(const OrtMemoryInfo& mem_info);
 
+  /**
+   * Returns the cache of pre-packed weights shared by the sessions created from this env, unless they opt out of it
+   * with kOrtSessionOptionsConfigDisableSharedPrepackedWeightsCache.
+   */
+  SharedPrepackedWeightsCache* GetSharedPrepackedWeightsCache() const {
+    return shared_prepacked_weights_cache_.get();
+  }
+
   Environment() = default;
 
   /**
@@ -99,5 +109,6 @@ class Environment {
   std::unique_ptr<onnxruntime::concurrency::ThreadPool> inter_op_thread_pool_;
   bool create_global_thread_pools_{false};
   std::vector<AllocatorPtr> shared_allocators_;
+  std::shared_ptr<SharedPrepackedWeightsCache> shared_prepacked_weights_cache_;
 };
 }  // namespace onnxruntime
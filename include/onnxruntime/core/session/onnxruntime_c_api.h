@@ -299,6 +299,7 @@ ORT_RUNTIME_CLASS(DnnlProviderOptions);
 ORT_RUNTIME_CLASS(Op);
 ORT_RUNTIME_CLASS(OpAttr);
 ORT_RUNTIME_CLASS(Logger);
+ORT_RUNTIME_CLASS(GenerationEngine);
 
 #ifdef _WIN32
 typedef _Return_type_success_(return == 0) OrtStatus* OrtStatusPtr;
@@ -705,6 +706,15 @@ typedef OrtStatus*(ORT_API_CALL* RegisterCustomOpsFn)(OrtSessionOptions* options
  */
 typedef void (*RunAsyncCallbackFn)(void* user_data, OrtValue** outputs, size_t num_outputs, OrtStatusPtr status);
 
+/** \brief Callback function for the tokens generated by an ::OrtGenerationEngine
+ *
+ * \param[in] user_data User specific data that was passed to OrtApi::GenerationEngine_AddRequest
+ * \param[in] request_id Id of the request returned by OrtApi::GenerationEngine_AddRequest
+ * \param[in] token Generated token id
+ * \param[in] finished Non-zero if this is the last token generated for the request
+ */
+typedef void (*OrtGenerationTokenCallbackFn)(void* user_data, int64_t request_id, int32_t token, int finished);
+
 /** \brief The C API
  *
  * All C API functions are defined inside this structure as pointers to functions.
@@ -2762,6 +2772,10 @@ struct OrtApi {
    *  Use -1 to allow ORT to choose the default 1GB for max_power_of_two_extend_bytes.
    *  Ultimately, the allocation size is determined by the allocation memory request.
    *  Further allocation sizes are governed by the arena extend strategy.
+   * "thread_cache_max_bytes": Maximum number of bytes of freed chunks each thread keeps in its own cache.
+   *  Allocations of up to 1MB that hit the calling thread's cache are served without taking the arena lock.
+   *  Chunks that do not fit in the cache are returned to the shared arena. Use -1 to allow ORT to choose
+   *  the default, 0 disables the per-thread caches. Default is 0.
    *
    * \param[in] arena_config_keys Keys to configure the arena
    * \param[in] arena_config_values Values to configure the arena
@@ -4413,6 +4427,75 @@ struct OrtApi {
    * \since Version 1.16.
    */
   ORT_API2_STATUS(KernelContext_GetResource, _In_ const OrtKernelContext* context, _In_ int resouce_version, _In_ int resource_id, _Outptr_ void** resource);
+
+  /// \name OrtGenerationEngine
+  /// @{
+
+  /** \brief Create an ::OrtGenerationEngine that generates tokens with a GPT-2 decoder
+   *
+   * The model of the session is the decoder subgraph of a GreedySearch node: the inputs are input_ids, position_ids and
+   * attention_mask (int32), followed by past_0 .. past_{L-1}, and the outputs are logits, followed by
+   * present_0 .. present_{L-1}.
+   *
+   * Requests are batched continuously: every call to OrtApi::GenerationEngine_Step admits queued requests into the
+   * free slots of the batch, and generates the next token of every sequence in the batch. A sequence leaves the batch
+   * when it generates the EOS token or reaches its maximum number of new tokens. Tokens are selected greedily.
+   *
+   * \param[in] session Session of the decoder. It must outlive the engine.
+   * \param[in] max_batch_size Maximum number of sequences decoded together.
+   * \param[in] eos_token_id Token that ends a sequence. A negative value disables it.
+   * \param[out] out Newly created ::OrtGenerationEngine. Must be freed with OrtApi::ReleaseGenerationEngine
+   *
+   * \snippet{doc} snippets.dox OrtStatus Return Value
+   *
+   * \since Version 1.17.
+   */
+  ORT_API2_STATUS(CreateGenerationEngine, _Inout_ OrtSession* session, _In_ size_t max_batch_size,
+                  _In_ int32_t eos_token_id, _Outptr_ OrtGenerationEngine** out);
+
+  /** \brief Queue a generation request
+   *
+   * The request is admitted into the batch by a later call to OrtApi::GenerationEngine_Step. Requests can be added
+   * from any thread.
+   *
+   * \param[in] engine
+   * \param[in] prompt Token ids of the prompt
+   * \param[in] prompt_length Number of tokens of the prompt. Must be greater than 0.
+   * \param[in] max_new_tokens Maximum number of tokens to generate. Must be greater than 0.
+   * \param[in] callback Called with each generated token, on the thread that calls OrtApi::GenerationEngine_Step
+   * \param[in] user_data User data that is passed back to callback
+   * \param[out] request_id Id of the request, which is passed to callback
+   *
+   * \snippet{doc} snippets.dox OrtStatus Return Value
+   *
+   * \since Version 1.17.
+   */
+  ORT_API2_STATUS(GenerationEngine_AddRequest, _Inout_ OrtGenerationEngine* engine,
+                  _In_reads_(prompt_length) const int32_t* prompt, _In_ size_t prompt_length,
+                  _In_ size_t max_new_tokens, _In_ OrtGenerationTokenCallbackFn callback, _In_opt_ void* user_data,
+                  _Out_ int64_t* request_id);
+
+  /** \brief Admit queued requests and generate the next token of every sequence in the batch
+   *
+   * The tokens are passed to the callbacks of their requests before this function returns. It must not be called
+   * concurrently on the same engine.
+   *
+   * \param[in] engine
+   * \param[out] has_pending_requests Set to non-zero if requests are still queued or being generated
+   *
+   * \snippet{doc} snippets.dox OrtStatus Return Value
+   *
+   * \since Version 1.17.
+   */
+  ORT_API2_STATUS(GenerationEngine_Step, _Inout_ OrtGenerationEngine* engine, _Out_ int* has_pending_requests);
+
+  /** \brief Release an ::OrtGenerationEngine obtained from OrtApi::CreateGenerationEngine
+   *
+   * \since Version 1.17.
+   */
+  ORT_CLASS_RELEASE(GenerationEngine);
+
+  /// @}
 };
 
 /*
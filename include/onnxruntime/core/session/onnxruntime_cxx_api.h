@@ -522,6 +522,7 @@ ORT_DEFINE_RELEASE(Status);
 ORT_DEFINE_RELEASE(OpAttr);
 ORT_DEFINE_RELEASE(Op);
 ORT_DEFINE_RELEASE(KernelInfo);
+ORT_DEFINE_RELEASE(GenerationEngine);
 
 #undef ORT_DEFINE_RELEASE
 
@@ -1859,6 +1860,22 @@ struct IoBinding : detail::IoBindingImpl<OrtIoBinding> {
   UnownedIoBinding GetUnowned() const { return UnownedIoBinding{this->p_}; }
 };
 
+/** \brief Wrapper around ::OrtGenerationEngine
+ *
+ */
+struct GenerationEngine : detail::Base<OrtGenerationEngine> {
+  explicit GenerationEngine(std::nullptr_t) {}  ///< Create an empty GenerationEngine object, must be assigned a valid one to be used
+  /// Wraps OrtApi::CreateGenerationEngine
+  GenerationEngine(Session& session, size_t max_batch_size, int32_t eos_token_id);
+
+  /// Wraps OrtApi::GenerationEngine_AddRequest. Returns the id of the request.
+  int64_t AddRequest(const int32_t* prompt, size_t prompt_length, size_t max_new_tokens,
+                     OrtGenerationTokenCallbackFn callback, void* user_data);
+
+  /// Wraps OrtApi::GenerationEngine_Step. Returns true if requests are still queued or being generated.
+  bool Step();
+};
+
 /*! \struct Ort::ArenaCfg
  * \brief it is a structure that represents the configuration of an arena based allocator
  * \details Please see docs/C_API.md for details
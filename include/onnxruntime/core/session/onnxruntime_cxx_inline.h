@@ -419,6 +419,24 @@ inline ArenaCfg::ArenaCfg(size_t max_mem, int arena_extend_strategy, int initial
   ThrowOnError(GetApi().CreateArenaCfg(max_mem, arena_extend_strategy, initial_chunk_size_bytes, max_dead_bytes_per_chunk, &p_));
 }
 
+inline GenerationEngine::GenerationEngine(Session& session, size_t max_batch_size, int32_t eos_token_id) {
+  ThrowOnError(GetApi().CreateGenerationEngine(session, max_batch_size, eos_token_id, &p_));
+}
+
+inline int64_t GenerationEngine::AddRequest(const int32_t* prompt, size_t prompt_length, size_t max_new_tokens,
+                                            OrtGenerationTokenCallbackFn callback, void* user_data) {
+  int64_t request_id = 0;
+  ThrowOnError(GetApi().GenerationEngine_AddRequest(p_, prompt, prompt_length, max_new_tokens, callback, user_data,
+                                                    &request_id));
+  return request_id;
+}
+
+inline bool GenerationEngine::Step() {
+  int has_pending_requests = 0;
+  ThrowOnError(GetApi().GenerationEngine_Step(p_, &has_pending_requests));
+  return has_pending_requests != 0;
+}
+
 inline ThreadingOptions::ThreadingOptions() {
   ThrowOnError(GetApi().CreateThreadingOptions(&p_));
 }
@@ -26,6 +26,14 @@
 // By default, the value for this key is empty (i.e.) no memory arenas are shrunk
 static const char* const kOrtRunOptionsConfigEnableMemoryArenaShrinkage = "memory.enable_memory_arena_shrinkage";
 
+// Maximum number of intra-op threads, including the thread calling Run, that parallel loops started by this run may
+// use when the intra-op thread pool is shared by concurrent Run calls.
+// "0": the run gets a fair share of the intra-op threads not reserved by runs with an explicit budget, split between
+//      all runs in progress at the time each parallel loop starts. A run without concurrent runs uses every thread.
+// "N" (N > 0): the run uses at most N threads, and reserves them for the duration of the run.
+// The budget applies to parallel loops started on the thread calling Run. The default value is "0".
+static const char* const kOrtRunOptionsConfigIntraOpThreadBudget = "run.intra_op_thread_budget";
+
 // Set to '1' to not synchronize execution providers with CPU at the end of session run.
 // Per default it will be set to '0'
 // Taking CUDA EP as an example, it omit triggering cudaStreamSynchronize on the compute stream.
@@ -20,6 +20,21 @@
 // If the config value is set to "1" then the prepacking is disabled, otherwise prepacking is enabled (default value)
 static const char* const kOrtSessionOptionsConfigDisablePrepacking = "session.disable_prepacking";
 
+// Key for disabling the environment level cache of pre-packed weights.
+// By default ("0"), pre-packed weights of MatMulInteger, QLinearConv, Gemm and Conv nodes assigned to the CPU EP are
+// de-duplicated across all the sessions created from the same environment, so identical weights loaded by several
+// sessions (e.g. replicas of the same model) are only packed and kept in memory once. If the config value is set to
+// "1" the session packs its own copy. The cache is not used for initializers shared via a PrepackedWeightsContainer.
+static const char* const kOrtSessionOptionsConfigDisableSharedPrepackedWeightsCache =
+    "session.disable_shared_prepacked_weights_cache";
+
+// Key for saving the pre-packed weights of the CPU kernels in the main graph when saving an ORT format model.
+// A session that loads the model on a platform using the same MLAS packed buffer format and instruction set
+// then uses the saved buffers instead of pre-packing the weights again. If the model bytes are used directly
+// (see kOrtSessionOptionsConfigUseORTModelBytesForInitializers) no copy of the buffers is made.
+// If the config value is set to "1" then the pre-packed weights are saved. The default is "0".
+static const char* const kOrtSessionOptionsConfigSavePrePackedInitializers = "session.save_prepacked_initializers";
+
 // A value of "1" means allocators registered in the env will be used. "0" means the allocators created in the session
 // will be used. Use this to override the usage of env allocators on a per session level.
 static const char* const kOrtSessionOptionsConfigUseEnvAllocators = "session.use_env_allocators";
@@ -87,6 +102,15 @@ static const char* const kOrtSessionOptionsMemoryOptimizerProbeLevel = "optimiza
 // Using device allocators means the memory allocation is made using malloc/new.
 static const char* const kOrtSessionOptionsUseDeviceAllocatorForInitializers = "session.use_device_allocator_for_initializers";
 
+// Keep external data initializers used on CPU mapped from their file for the whole life of the session.
+// "1": enable; "0": disable. The default is "0".
+// When enabled, initializers whose external data is aligned to 64 bytes in the file are not planned into or
+// allocated from the session's arena at all. The tensor points straight at the mapping, which is never written to,
+// so the pages are shared through the OS page cache by every session and process that maps the same file.
+// Initializers that are not aligned are copied into an arena buffer instead. If all the kernels consuming an
+// initializer pre-pack it, only the pre-packed copy is allocated and the mapping is released.
+static const char* const kOrtSessionOptionsUseMmapForExternalInitializers = "session.use_mmap_for_external_initializers";
+
 // Configure whether to allow the inter_op/intra_op threads spinning a number of times before blocking
 // "0": thread will block if found no job to run
 // "1": default, thread will spin a number of times before blocking
@@ -122,6 +146,16 @@ static const char* const kOrtSessionOptionsQDQIsInt8Allowed = "session.qdqisint8
 // platforms.
 static const char* const kOrtSessionOptionsAvx2PrecisionMode = "session.x64quantprecision";
 
+// Quantizes the constant fp32 weights of MatMul nodes assigned to the CPU EP to int4 blocks, replacing them with
+// the com.microsoft.MatMulFpQ4 operator. Activations stay in fp32. This reduces the memory traffic of the weights,
+// which bounds token generation of large language models, but changes the results of the model.
+// Option values:
+// - "0": disabled. [DEFAULT]
+// - "zp8": blocks of 32 values with a scale and a zero point.
+// - "sym": blocks of 32 values with a scale.
+// Only effective on platforms with an int4 MatMul kernel (x64 with AVX2 or AVX512).
+static const char* const kOrtSessionOptionsMatMulQ4WeightQuantization = "session.matmul_q4_weight_quantization";
+
 // Specifies how minimal build graph optimizations are handled in a full build.
 // These optimizations are at the extended level or higher.
 // Possible values and their effects are:
@@ -218,6 +252,35 @@ static const char* const kDebugLayoutTransformation = "session.debug_layout_tran
 // - "1": CPU EP fallback is disabled.
 static const char* const kOrtSessionOptionsDisableCPUEPFallback = "session.disable_cpu_ep_fallback";
 
+// Rounds up input dimensions to a bucket when caching memory patterns, so that one memory pattern serves all the
+// input shapes of a bucket, e.g. inputs with varying sequence lengths. The pattern of a bucket grows to the largest
+// shapes seen in the bucket. Only used if memory patterns are enabled.
+// Only memory patterns are bucketed. Kernels are selected once when the session is created, and the algorithm
+// choices kernels make from input shapes at run time (e.g. MlasConvPrepare) depend on the exact dimensions.
+// Option values:
+// - "0": memory patterns are cached for the exact input shapes. [DEFAULT]
+// - "pow2": dimensions are rounded up to the next power of 2.
+// - "N" (N > 0): dimensions are rounded up to the next multiple of N.
+static const char* const kOrtSessionOptionsConfigMemoryPatternShapeBucket = "session.memory_pattern_shape_bucket";
+
+// Maximum number of cached memory patterns. The least recently used pattern is evicted when the cache is full.
+// Defaults to "0", which does not limit the number of cached memory patterns.
+static const char* const kOrtSessionOptionsConfigMemoryPatternCacheSize = "session.memory_pattern_cache_size";
+
+// Enables dynamic batching of concurrent Run calls on the session.
+// Concurrent requests with compatible inputs are concatenated along dimension 0, executed once, and each request
+// receives its slice of the outputs. Dimension 0 of every model input and output must be the batch dimension, and
+// must not have a fixed value in the model.
+// Option values:
+// - "0" or "1": dynamic batching is disabled. [DEFAULT]
+// - "N" (N > 1): maximum number of rows of a batch.
+static const char* const kOrtSessionOptionsConfigDynamicBatchingMaxBatchSize = "session.dynamic_batching_max_batch_size";
+
+// Maximum time in microseconds that a request waits for other requests to join its batch when dynamic batching is
+// enabled. Defaults to "1000".
+static const char* const kOrtSessionOptionsConfigDynamicBatchingMaxQueueDelayUs =
+    "session.dynamic_batching_max_queue_delay_us";
+
 // Use this config when serializing a large model after optimization to specify an external initializers file
 static const char* const kOrtSessionOptionsOptimizedModelExternalInitializersFileName =
     "session.optimized_model_external_initializers_file_name";
@@ -199,6 +199,8 @@ Status Attention<T>::Compute(OpKernelContext* context) const {
   const Tensor* mask_index = context->Input<Tensor>(3);
   const Tensor* past = context->Input<Tensor>(4);
   const Tensor* relative_position_bias = context->Input<Tensor>(5);
+  const Tensor* past_seq_len = context->Input<Tensor>(6);
+  const Tensor* page_table = context->Input<Tensor>(7);
 
   const TensorShape& weights_shape = (weights ? weights->Shape() : weight_shape_);
 
@@ -209,7 +211,14 @@ Status Attention<T>::Compute(OpKernelContext* context) const {
                                   mask_index,
                                   past,
                                   relative_position_bias,
-                                  &parameters));
+                                  &parameters,
+                                  past_seq_len,
+                                  page_table));
+
+  if (parameters.past_present_share_buffer && page_table == nullptr) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED,
+                           "CPU Attention supports past_present_share_buffer only with a paged past state");
+  }
 
   const int batch_size = parameters.batch_size;
   const int sequence_length = parameters.sequence_length;
@@ -327,6 +336,12 @@ Status Attention<T>::Compute(OpKernelContext* context) const {
     });
   }
 
+  if (page_table != nullptr) {
+    return ApplyPagedAttention(Q, K, V, mask_index, past, page_table, output,
+                               batch_size, sequence_length, sequence_length, parameters.past_sequence_length,
+                               parameters.head_size, parameters.v_hidden_size, context);
+  }
+
   // Compute the attention score and apply the score to V
   return ApplyAttention(Q, K, V, mask_index, past, nullptr /* past_key */, nullptr /* past_value */,
                         output, nullptr /* present_key */, nullptr /* present_value */,
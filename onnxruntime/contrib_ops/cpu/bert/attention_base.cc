@@ -14,7 +14,8 @@ Status AttentionBase::CheckInputs(const TensorShape& input_shape,
                                   const Tensor* past,
                                   const Tensor* relative_position_bias,
                                   void* parameters,
-                                  const Tensor* past_seq_len) const {
+                                  const Tensor* past_seq_len,
+                                  const Tensor* page_table) const {
   // Abbreviation and Meanings:
   //   B:    batch_size
   //   S:    sequence_length (input sequence length of query)
@@ -38,6 +39,10 @@ Status AttentionBase::CheckInputs(const TensorShape& input_shape,
   //   mask_index              : see below
   //   past         (K/V)      : (2, B, N, P, H) or NULL
   //   relative_position_bias            : (B, N, S, T) or NULL
+  //   page_table              : (B, max_pages_per_sequence) or NULL
+  //
+  // When page_table is given, past and present share a paged cache with shape (2, num_pages, N, page_size, H), and
+  // position t of sequence b is stored at row (t % page_size) of page page_table[b][t / page_size].
 
   // For mask_index, the following shapes are supported:
   //     NULL, (B, 1), (1, 1)
@@ -140,7 +145,7 @@ Status AttentionBase::CheckInputs(const TensorShape& input_shape,
       return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Inputs 'past' dimension 0 shall have length of 2");
     }
 
-    if (past_dims[1] != batch_size) {
+    if (page_table == nullptr && past_dims[1] != batch_size) {
       return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
                              "Inputs 'past' dimension 1 shall have same length as dimension 0 of input 0");
     }
@@ -167,7 +172,25 @@ Status AttentionBase::CheckInputs(const TensorShape& input_shape,
   }
 
   int64_t total_sequence_length = kv_sequence_length + past_sequence_length;
-  if (past != nullptr && past_present_share_buffer_) {
+  if (page_table != nullptr) {
+    if (past == nullptr || !past_present_share_buffer_) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "Input 'page_table' requires past state and past_present_share_buffer to be set");
+    }
+
+    const auto& page_table_dims = page_table->Shape().GetDims();
+    if (page_table_dims.size() != 2 || page_table_dims[0] != batch_size) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "Input 'page_table' is expected to have shape (batch_size, max_pages_per_sequence)");
+    }
+
+    const int64_t page_size = past->Shape().GetDims()[3];
+    if (page_size <= 0 || page_table_dims[1] * page_size < total_sequence_length) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "Input 'page_table' does not have enough pages for total_sequence_length ",
+                             total_sequence_length, " with page size ", page_size);
+    }
+  } else if (past != nullptr && past_present_share_buffer_) {
     const auto& past_dims = past->Shape().GetDims();
     if (past_dims[3] < total_sequence_length) {
       return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
@@ -226,7 +249,11 @@ Status AttentionBase::CheckInputs(const TensorShape& input_shape,
     }
   }
 
-  if (past != nullptr && past_present_share_buffer_) {
+  if (page_table != nullptr) {
+    if (max_sequence_length <= 0) {
+      max_sequence_length = page_table->Shape().GetDims()[1] * past->Shape().GetDims()[3];
+    }
+  } else if (past != nullptr && past_present_share_buffer_) {
     if (max_sequence_length <= 0) {
       max_sequence_length = past->Shape().GetDims()[3];
     }
@@ -332,12 +359,14 @@ Status AttentionBase::CheckInputs(const TensorShape& input_shape,
                                   const Tensor* relative_position_bias,
                                   void* parameters,
                                   const int max_threads_per_block,
-                                  const Tensor* past_seq_len) const {
+                                  const Tensor* past_seq_len,
+                                  const Tensor* page_table) const {
   if (num_heads_ > max_threads_per_block) {
     return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "num_heads should be no larger than ", max_threads_per_block);
   }
 
-  return CheckInputs(input_shape, weights_shape, bias_shape, mask_index, past, relative_position_bias, parameters, past_seq_len);
+  return CheckInputs(input_shape, weights_shape, bias_shape, mask_index, past, relative_position_bias, parameters,
+                     past_seq_len, page_table);
 }
 
 Tensor* AttentionBase::GetPresent(OpKernelContext* context,
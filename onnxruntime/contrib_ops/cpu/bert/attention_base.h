@@ -21,7 +21,8 @@ class AttentionBase {
                      const Tensor* relative_position_bias,
                      void* parameters,
                      const int max_threads_per_block,  // for CUDA
-                     const Tensor* past_seq_len = nullptr) const;
+                     const Tensor* past_seq_len = nullptr,
+                     const Tensor* page_table = nullptr) const;
 
   Tensor* GetPresent(OpKernelContext* context,
                      const Tensor* past,
@@ -64,7 +65,8 @@ class AttentionBase {
                      const Tensor* past,
                      const Tensor* relative_position_bias,
                      void* parameters,
-                     const Tensor* past_seq_len = nullptr) const;
+                     const Tensor* past_seq_len = nullptr,
+                     const Tensor* page_table = nullptr) const;
 
   int num_heads_;                          // number of attention heads
   bool is_unidirectional_;                 // whether every token can only attend to previous tokens.
@@ -3,6 +3,9 @@
 
 #pragma once
 
+#include <algorithm>
+#include <type_traits>
+
 #include "attention_base.h"
 #include "attention_helper.h"
 
@@ -53,13 +56,28 @@ class AttentionCPUBase : public AttentionBase {
     // Total sequence length including that of past state: T = P + L
     const int total_sequence_length = past_sequence_length + kv_sequence_length;
 
+    bool causal = (is_unidirectional_ && sequence_length > 1);
+
+    // Use the tiled kernel of MLAS, which does not materialize the attention probs, when the mask only depends on
+    // the key position, or on the distance between query and key for self-attention.
+    if constexpr (std::is_same<T, float>::value) {
+      gsl::span<const int64_t> dims = mask_index != nullptr ? mask_index->Shape().GetDims()
+                                                            : gsl::span<const int64_t>{};
+      if (relative_position_bias == nullptr &&
+          (!causal || kv_sequence_length == sequence_length) &&
+          IsKeyPaddingMask(dims, batch_size, total_sequence_length)) {
+        return ApplyFlashAttention(Q, K, V, mask_index, past, past_key, past_value, output, present,
+                                   present_key, present_value, batch_size, sequence_length, kv_sequence_length,
+                                   past_sequence_length, qk_head_size == 0 ? v_head_size : qk_head_size,
+                                   v_head_size, causal, allocator, tp);
+      }
+    }
+
     // Compute the attention score.
     size_t bytes = SafeInt<size_t>(batch_size) * num_heads_ * sequence_length * total_sequence_length * sizeof(T);
     auto attention_probs = allocator->Alloc(bytes);
     BufferUniquePtr scratch_buffer(attention_probs, BufferDeleter(allocator));
 
-    bool causal = (is_unidirectional_ && sequence_length > 1);
-
     void* mask_data = nullptr;
     if (mask_index != nullptr || causal) {
       size_t mask_data_bytes = SafeInt<size_t>(batch_size) * sequence_length * total_sequence_length * sizeof(T);
@@ -104,7 +122,278 @@ class AttentionCPUBase : public AttentionBase {
     return Status::OK();
   }
 
+  // Attention with a paged past state. past and present share a cache of shape (2, num_pages, N, page_size, H), and
+  // page_table (B, max_pages_per_sequence) lists the pages of each sequence in order. K and V of the new tokens are
+  // written to positions [P, P + L) of each sequence, so the pages holding these positions shall not be shared with
+  // other sequences. Pages before them may be shared, for example by beams forked from the same sequence.
+  template <typename T>
+  Status ApplyPagedAttention(const T* Q,                // Q data with shape BxNxSxH
+                             const T* K,                // K data with shape BxNxLxH
+                             const T* V,                // V value with size BxNxLxH
+                             const Tensor* mask_index,  // mask index. nullptr if no mask or its size is B
+                             const Tensor* past,        // paged past state
+                             const Tensor* page_table,  // pages of each sequence
+                             Tensor* output,            // output tensor
+                             int batch_size,            // batch size (B)
+                             int sequence_length,       // sequence length of Q (S)
+                             int kv_sequence_length,    // sequence length of K or V (L)
+                             int past_sequence_length,  // sequence length of past state (P)
+                             int head_size,             // head size of Q, K and V (H)
+                             int hidden_size,           // hidden size of V (D)
+                             OpKernelContext* context) const {
+    AllocatorPtr allocator;
+    ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&allocator));
+
+    auto* tp = context->GetOperatorThreadPool();
+
+    const auto& past_dims = past->Shape().GetDims();
+    const int64_t num_pages = past_dims[1];
+    const int page_size = static_cast<int>(past_dims[3]);
+    const int max_pages_per_sequence = static_cast<int>(page_table->Shape()[1]);
+    const int total_sequence_length = past_sequence_length + kv_sequence_length;
+    const int num_used_pages = (total_sequence_length + page_size - 1) / page_size;
+
+    const int32_t* pages = page_table->Data<int32_t>();
+    for (int b = 0; b < batch_size; b++) {
+      for (int j = 0; j < num_used_pages; j++) {
+        const int32_t page = pages[b * max_pages_per_sequence + j];
+        if (page < 0 || page >= num_pages) {
+          return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input 'page_table' has invalid page ", page,
+                                 " for sequence ", b, ". Number of pages is ", num_pages);
+        }
+      }
+    }
+
+    // The present state shares the buffer of the past state, unless the caller provided a separate buffer.
+    Tensor* present = context->Output(1, past->Shape());
+    if (present == nullptr) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Expect to have present state output with paged past state");
+    }
+    T* cache = present->MutableData<T>();
+    if (cache != past->Data<T>()) {
+      memcpy(cache, past->Data<T>(), past->SizeInBytes());
+    }
+
+    const ptrdiff_t page_chunk_length = SafeInt<ptrdiff_t>(page_size) * head_size;  // page_size x H
+    const ptrdiff_t value_cache_offset = SafeInt<ptrdiff_t>(num_pages) * num_heads_ * page_chunk_length;
+    T* key_cache = cache;
+    T* value_cache = cache + value_cache_offset;
+
+    // Address of the row of position t of sequence b and head n in the key or value cache.
+    auto cache_row = [&](T* base, int b, int n, int t) {
+      const int32_t page = pages[b * max_pages_per_sequence + t / page_size];
+      const ptrdiff_t offset = (SafeInt<ptrdiff_t>(page) * num_heads_ + n) * page_chunk_length +
+                               static_cast<ptrdiff_t>(t % page_size) * head_size;
+      return base + offset;
+    };
+
+    const int loop_len = batch_size * num_heads_;
+    const size_t bytes_per_row = SafeInt<size_t>(head_size) * sizeof(T);
+
+    // Append K and V of the new tokens to the cache.
+    const double append_cost = static_cast<double>(kv_sequence_length) * head_size;
+    ThreadPool::TryParallelFor(tp, loop_len, append_cost, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+      for (std::ptrdiff_t i = begin; i != end; ++i) {
+        const int b = static_cast<int>(i) / num_heads_;
+        const int n = static_cast<int>(i) % num_heads_;
+        const ptrdiff_t chunk_offset = SafeInt<ptrdiff_t>(i) * kv_sequence_length * head_size;
+        for (int l = 0; l < kv_sequence_length; l++) {
+          const int t = past_sequence_length + l;
+          memcpy(cache_row(key_cache, b, n, t), K + chunk_offset + l * head_size, bytes_per_row);
+          memcpy(cache_row(value_cache, b, n, t), V + chunk_offset + l * head_size, bytes_per_row);
+        }
+      }
+    });
+
+    size_t bytes = SafeInt<size_t>(batch_size) * num_heads_ * sequence_length * total_sequence_length * sizeof(T);
+    auto attention_probs = static_cast<T*>(allocator->Alloc(bytes));
+    BufferUniquePtr scratch_buffer(attention_probs, BufferDeleter(allocator));
+
+    bool causal = (is_unidirectional_ && sequence_length > 1);
+
+    void* mask_data = nullptr;
+    if (mask_index != nullptr || causal) {
+      size_t mask_data_bytes = SafeInt<size_t>(batch_size) * sequence_length * total_sequence_length * sizeof(T);
+      mask_data = allocator->Alloc(mask_data_bytes);
+      memset(mask_data, 0, mask_data_bytes);
+      PrepareMask(mask_index != nullptr ? mask_index->Data<int32_t>() : nullptr,
+                  mask_index != nullptr ? mask_index->Shape().GetDims() : gsl::span<const int64_t>{},
+                  static_cast<T*>(mask_data), causal, batch_size, sequence_length, past_sequence_length,
+                  mask_filter_value_);
+    }
+    BufferUniquePtr mask_data_buffer(mask_data, BufferDeleter(allocator));
+
+    auto out_tmp_data =
+        static_cast<T*>(allocator->Alloc(SafeInt<size_t>(batch_size) * num_heads_ * sequence_length * head_size * sizeof(T)));
+    BufferUniquePtr out_tmp_buffer(out_tmp_data, BufferDeleter(std::move(allocator)));
+
+    const float alpha = scale_ == 0.0f ? 1.0f / sqrt(static_cast<float>(head_size)) : scale_;
+    const double cost = static_cast<double>(head_size) * sequence_length * total_sequence_length;
+
+    // attention_probs(B, N, S, T) = 1/sqrt(H) x Q(B, N, S, H) x K'(B, N, T, H -> B, N, H, T) + mask(B, S, T)
+    // Each page holds a block of page_size columns of K'.
+    ThreadPool::TryParallelFor(tp, loop_len, cost, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+      for (std::ptrdiff_t i = begin; i != end; ++i) {
+        const int b = static_cast<int>(i) / num_heads_;
+        const int n = static_cast<int>(i) % num_heads_;
+        const size_t probs_size = static_cast<size_t>(sequence_length) * total_sequence_length;
+        T* probs = attention_probs + probs_size * i;
+        if (mask_data != nullptr) {
+          memcpy(probs, static_cast<T*>(mask_data) + probs_size * b, probs_size * sizeof(T));
+        } else {
+          memset(probs, 0, probs_size * sizeof(T));
+        }
+
+        for (int t = 0; t < total_sequence_length; t += page_size) {
+          const int columns = std::min(page_size, total_sequence_length - t);
+          math::GemmEx<T, ThreadPool>(CblasNoTrans, CblasTrans, sequence_length, columns, head_size, alpha,
+                                      Q + static_cast<size_t>(sequence_length) * head_size * i, head_size,
+                                      cache_row(key_cache, b, n, t), head_size, 1.0f,
+                                      probs + t, total_sequence_length, nullptr);
+        }
+      }
+    });
+
+    ComputeAttentionSoftmaxInplace(attention_probs, batch_size * num_heads_ * sequence_length,
+                                   total_sequence_length, tp);
+
+    // out_tmp(B, N, S, H) = attention_probs(B, N, S, T) x V(B, N, T, H), accumulated page by page.
+    // The result is transposed to output(B, S, N, H).
+    ThreadPool::TryParallelFor(tp, loop_len, cost, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+      for (std::ptrdiff_t i = begin; i != end; ++i) {
+        const int b = static_cast<int>(i) / num_heads_;
+        const int n = static_cast<int>(i) % num_heads_;
+        const T* probs = attention_probs + static_cast<size_t>(sequence_length) * total_sequence_length * i;
+        T* out_tmp = out_tmp_data + static_cast<size_t>(sequence_length) * head_size * i;
+
+        for (int t = 0; t < total_sequence_length; t += page_size) {
+          const int rows = std::min(page_size, total_sequence_length - t);
+          math::GemmEx<T, ThreadPool>(CblasNoTrans, CblasNoTrans, sequence_length, head_size, rows, 1.0f,
+                                      probs + t, total_sequence_length,
+                                      cache_row(value_cache, b, n, t), head_size, t == 0 ? 0.0f : 1.0f,
+                                      out_tmp, head_size, nullptr);
+        }
+
+        const ptrdiff_t dest_offset = (SafeInt<ptrdiff_t>(b) * sequence_length * num_heads_ + n) * head_size;
+        T* dest = output->MutableData<T>() + dest_offset;
+        for (int s = 0; s < sequence_length; s++) {
+          memcpy(dest, out_tmp + s * head_size, bytes_per_row);
+          dest += hidden_size;
+        }
+      }
+    });
+
+    return Status::OK();
+  }
+
  private:
+  // Attention computed by MlasFlashAttention. K and V are first concatenated with the past state into the present
+  // state when there is one. Then the softmax of the scores is computed block by block, so only a block of scores
+  // per thread is kept in memory instead of the BxNxSxT attention probs.
+  Status ApplyFlashAttention(const float* Q,            // Q data with shape BxNxSxH
+                             const float* K,            // K data with shape BxNxLxH
+                             const float* V,            // V value with size BxNxLxH_v
+                             const Tensor* mask_index,  // key padding mask. nullptr if no mask.
+                             const Tensor* past,        // past state
+                             const Tensor* past_key,    // past K input tensor (if not using past state)
+                             const Tensor* past_value,  // past V input tensor (if not using past state)
+                             Tensor* output,            // output tensor
+                             Tensor* present,           // present state
+                             Tensor* present_key,       // present K output tensor (if separating present KV)
+                             Tensor* present_value,     // present V output tensor (if separating present KV)
+                             int batch_size,            // batch size (B)
+                             int sequence_length,       // sequence length of Q (S)
+                             int kv_sequence_length,    // sequence length of K or V (L)
+                             int past_sequence_length,  // sequence length of past state (P)
+                             int qk_head_size,          // head size of Q or K (H)
+                             int v_head_size,           // head size of V (H_v)
+                             bool causal,               // has causal (unidirectional) mask
+                             AllocatorPtr allocator,
+                             ThreadPool* tp) const {
+    const int total_sequence_length = past_sequence_length + kv_sequence_length;  // T = P + L
+
+    const float* k = K;
+    const float* v = V;
+    if (present != nullptr || present_key != nullptr || present_value != nullptr) {
+      // Past and present state have shape (2, B, N, P or T, H), with keys followed by values.
+      const ptrdiff_t past_values_offset = SafeInt<ptrdiff_t>(batch_size) * num_heads_ * past_sequence_length *
+                                           v_head_size;
+      const ptrdiff_t present_values_offset = SafeInt<ptrdiff_t>(batch_size) * num_heads_ * total_sequence_length *
+                                              v_head_size;
+
+      const float* past_k = past_key != nullptr ? past_key->Data<float>() : nullptr;
+      const float* past_v = past_value != nullptr ? past_value->Data<float>() : nullptr;
+      if (past != nullptr) {
+        past_k = past->Data<float>();
+        past_v = past_k + past_values_offset;
+      }
+
+      float* present_k = present_key != nullptr ? present_key->MutableData<float>() : nullptr;
+      float* present_v = present_value != nullptr ? present_value->MutableData<float>() : nullptr;
+      if (present != nullptr) {
+        present_k = present->MutableData<float>();
+        present_v = present_k + present_values_offset;
+      }
+
+      // Concatenate past and current K and V: (BxNx)PxH, (BxNx)LxH -> (BxNx)TxH
+      const size_t past_k_chunk_length = static_cast<size_t>(past_sequence_length) * qk_head_size;
+      const size_t past_v_chunk_length = static_cast<size_t>(past_sequence_length) * v_head_size;
+      const size_t k_input_chunk_length = static_cast<size_t>(kv_sequence_length) * qk_head_size;
+      const size_t v_input_chunk_length = static_cast<size_t>(kv_sequence_length) * v_head_size;
+      const size_t k_present_chunk_length = static_cast<size_t>(total_sequence_length) * qk_head_size;
+      const size_t v_present_chunk_length = static_cast<size_t>(total_sequence_length) * v_head_size;
+      const double cost = static_cast<double>(total_sequence_length) * (qk_head_size + v_head_size);
+      const ptrdiff_t loop_len = SafeInt<ptrdiff_t>(batch_size) * num_heads_;
+
+      ThreadPool::TryParallelFor(tp, loop_len, cost, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+        for (std::ptrdiff_t i = begin; i != end; ++i) {
+          if (present_k != nullptr) {
+            ConcatStateChunk(past_k, K + k_input_chunk_length * i, present_k,
+                             past_k_chunk_length, k_present_chunk_length, i);
+          }
+          if (present_v != nullptr) {
+            ConcatStateChunk(past_v, V + v_input_chunk_length * i, present_v,
+                             past_v_chunk_length, v_present_chunk_length, i);
+          }
+        }
+      });
+
+      if (present_k != nullptr) {
+        k = present_k;
+      }
+      if (present_v != nullptr) {
+        v = present_v;
+      }
+    }
+
+    float* key_bias = nullptr;
+    if (mask_index != nullptr) {
+      size_t key_bias_bytes = SafeInt<size_t>(batch_size) * total_sequence_length * sizeof(float);
+      key_bias = static_cast<float*>(allocator->Alloc(key_bias_bytes));
+      PrepareKeyBias(mask_index->Data<int32_t>(), mask_index->Shape().GetDims(), key_bias,
+                     batch_size, total_sequence_length, mask_filter_value_);
+    }
+    BufferUniquePtr key_bias_buffer(key_bias, BufferDeleter(std::move(allocator)));
+
+    MLAS_FLASH_ATTENTION_PARAMS params;
+    params.BatchSize = static_cast<size_t>(batch_size);
+    params.NumHeads = static_cast<size_t>(num_heads_);
+    params.SequenceLength = static_cast<size_t>(sequence_length);
+    params.KvSequenceLength = static_cast<size_t>(total_sequence_length);
+    params.QkHeadSize = static_cast<size_t>(qk_head_size);
+    params.VHeadSize = static_cast<size_t>(v_head_size);
+    params.Scale = scale_ == 0.0f ? 1.0f / sqrt(static_cast<float>(qk_head_size)) : scale_;
+    params.Causal = causal;
+    params.Query = Q;
+    params.Key = k;
+    params.Value = v;
+    params.KeyBias = key_bias;
+    params.Output = output->MutableData<float>();
+    MlasFlashAttention(&params, tp);
+
+    return Status::OK();
+  }
+
   // Helper function to compute the attention probs. It does 2 things:
   //  attention_probs(B, N, S, T) = 1/sqrt(H) x Q(B, N, S, H) x K'(B, N, T, H -> B, N, H, T) +
   //                                1 x mask_data(B, N, S, T)
@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <limits>
 #include "core/util/math.h"
 #include "core/util/math_cpuonly.h"
@@ -153,6 +154,53 @@ void PrepareMask(const int32_t* mask_index,
   }
 }
 
+// Whether the mask only depends on the key position, so that it can be applied as a key bias of shape BxT.
+// This is the case for a raw attention mask with shape (B, T), and for a mask index with the end position (B) or
+// the end and start positions (2B) of each sequence.
+inline bool IsKeyPaddingMask(gsl::span<const int64_t> mask_index_dims, int batch_size, int total_sequence_length) {
+  if (mask_index_dims.empty()) {
+    return true;
+  }
+
+  if (mask_index_dims.size() == 1) {
+    return mask_index_dims[0] == batch_size || mask_index_dims[0] == 2 * static_cast<int64_t>(batch_size);
+  }
+
+  return mask_index_dims.size() == 2 && mask_index_dims[0] == batch_size &&
+         mask_index_dims[1] == total_sequence_length;
+}
+
+// Convert a key padding mask (see IsKeyPaddingMask) to a key bias of shape BxT. Masked positions get
+// mask_filter_value, and the others get 0.
+template <typename T>
+void PrepareKeyBias(const int32_t* mask_index,
+                    gsl::span<const int64_t> mask_index_dims,
+                    T* key_bias,
+                    int batch_size,
+                    int total_sequence_length,
+                    float mask_filter_value) {
+  const bool is_raw_attention_mask = (mask_index_dims.size() == 2);
+  const bool has_mask_start_position = (mask_index_dims.size() == 1 &&
+                                        static_cast<int>(mask_index_dims[0]) == 2 * batch_size);
+
+  for (int b_i = 0; b_i < batch_size; b_i++) {
+    T* p_bias = key_bias + static_cast<ptrdiff_t>(b_i) * total_sequence_length;
+    if (is_raw_attention_mask) {
+      const int32_t* raw_mask = mask_index + static_cast<ptrdiff_t>(b_i) * total_sequence_length;
+      for (int m_i = 0; m_i < total_sequence_length; m_i++) {
+        p_bias[m_i] = (raw_mask[m_i] > 0) ? static_cast<T>(0.0f) : static_cast<T>(mask_filter_value);
+      }
+    } else {
+      const int end_position = std::max(mask_index[b_i], 0);
+      const int start_position = has_mask_start_position ? mask_index[b_i + batch_size] : 0;
+      for (int m_i = 0; m_i < total_sequence_length; m_i++) {
+        p_bias[m_i] = (m_i >= end_position || m_i < start_position) ? static_cast<T>(mask_filter_value)
+                                                                     : static_cast<T>(0.0f);
+      }
+    }
+  }
+}
+
 // Concatenate a past state chunk PxH with input state chunk LxH into present state chunk TxH
 // Returns a pointer to the start of present state chunk.
 template <typename T>
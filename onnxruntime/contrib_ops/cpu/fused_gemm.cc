@@ -9,6 +9,38 @@ namespace contrib {
 constexpr const char* ACTIVATION_NAME_PREFIX = "activation_";
 constexpr size_t ACTIVATION_NAME_PREFIX_LEN = 11;
 
+// Returns the MLAS activation for the activations MLAS can apply in the epilogue of the GEMM.
+static bool GetMlasActivation(const std::string& activation, const NodeAttributes& attrs,
+                              MLAS_ACTIVATION& mlas_activation) {
+  auto get_float_attr = [&attrs](const char* name, float default_value) {
+    auto it = attrs.find(name);
+    return it != attrs.end() ? it->second.f() : default_value;
+  };
+
+  if (activation == "Relu") {
+    mlas_activation.ActivationKind = MlasReluActivation;
+  } else if (activation == "Tanh") {
+    mlas_activation.ActivationKind = MlasTanhActivation;
+  } else if (activation == "Sigmoid") {
+    mlas_activation.ActivationKind = MlasLogisticActivation;
+  } else if (activation == "LeakyRelu") {
+    mlas_activation.ActivationKind = MlasLeakyReluActivation;
+    mlas_activation.Parameters.LeakyRelu.alpha = get_float_attr("alpha", 0.01f);
+  } else if (activation == "HardSigmoid") {
+    mlas_activation.ActivationKind = MlasHardSigmoidActivation;
+    mlas_activation.Parameters.HardSigmoid.alpha = get_float_attr("alpha", 0.2f);
+    mlas_activation.Parameters.HardSigmoid.beta = get_float_attr("beta", 0.5f);
+  } else if (activation == "Gelu") {
+    mlas_activation.ActivationKind = MlasGeluActivation;
+  } else if (activation == "QuickGelu" && get_float_attr("alpha", 1.702f) == 1.0f) {
+    // x * sigmoid(x)
+    mlas_activation.ActivationKind = MlasSiluActivation;
+  } else {
+    return false;
+  }
+  return true;
+}
+
 template <typename T>
 class FusedGemm final : public Gemm<T> {
  public:
@@ -20,7 +52,12 @@ class FusedGemm final : public Gemm<T> {
         attrs[p.first.substr(ACTIVATION_NAME_PREFIX_LEN)] = p.second;
       }
     }
-    ORT_THROW_IF_ERROR(functors::ElementWiseRangedTransform<T>::Create(activation, attrs, this->activation_));
+    MLAS_ACTIVATION mlas_activation;
+    if (std::is_same<T, float>::value && GetMlasActivation(activation, attrs, mlas_activation)) {
+      this->mlas_activation_ = mlas_activation;
+    } else {
+      ORT_THROW_IF_ERROR(functors::ElementWiseRangedTransform<T>::Create(activation, attrs, this->activation_));
+    }
   }
 };
 
@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #include "core/framework/tensor.h"
+#include "core/mlas/inc/mlas.h"
 #include "core/util/math_cpuonly.h"
 #include "core/providers/common.h"
 #include "core/platform/threadpool.h"
@@ -32,6 +33,87 @@ SkipLayerNorm<T>::SkipLayerNorm(const OpKernelInfo& op_kernel_info)
   ORT_ENFORCE(epsilon_ >= 0);
 }
 
+namespace {
+template <typename T>
+void ComputeJob(
+    const T* input_data,
+    const T* skip_data,
+    const T* gamma_data,
+    const T* beta_data,
+    const T* bias_data,
+    ptrdiff_t task_idx,
+    int hidden_size,
+    int64_t skip_size,
+    float epsilon,
+    T* output_data,
+    T* skip_input_bias_add_output_data) {
+  auto offset = task_idx * hidden_size;
+
+  const T* p_input = input_data + offset;
+  const T* p_skip = skip_data + (offset % skip_size);
+  T* p_output = output_data + offset;
+  T* p_skip_input_bias_add_output_data = skip_input_bias_add_output_data != nullptr ? skip_input_bias_add_output_data + offset : nullptr;
+
+  T mean = 0;
+  T mean_square = 0;
+
+  for (int64_t h = 0; h < hidden_size; h++) {
+    T value = p_input[h] + p_skip[h];
+
+    if (nullptr != bias_data) {
+      value += bias_data[h];
+    }
+
+    if (nullptr != p_skip_input_bias_add_output_data) {
+      p_skip_input_bias_add_output_data[h] = value;
+    }
+
+    p_output[h] = value;
+    mean += value;
+    mean_square += value * value;
+  }
+
+  mean = mean / hidden_size;
+  mean_square = sqrt(mean_square / hidden_size - mean * mean + epsilon);
+
+  for (int64_t h = 0; h < hidden_size; h++) {
+    if (nullptr == beta_data) {
+      p_output[h] = (p_output[h] - mean) / mean_square * gamma_data[h];
+    } else {
+      p_output[h] = (p_output[h] - mean) / mean_square * gamma_data[h] + beta_data[h];
+    }
+  }
+}
+
+// The float row is added and normalized by the vectorized MLAS kernel, which gathers the row statistics in the
+// same pass that computes the sum of the input, skip and bias rows.
+void ComputeJob(
+    const float* input_data,
+    const float* skip_data,
+    const float* gamma_data,
+    const float* beta_data,
+    const float* bias_data,
+    ptrdiff_t task_idx,
+    int hidden_size,
+    int64_t skip_size,
+    float epsilon,
+    float* output_data,
+    float* skip_input_bias_add_output_data) {
+  auto offset = task_idx * hidden_size;
+
+  MlasSkipLayerNormalization(input_data + offset,
+                             skip_data + (offset % skip_size),
+                             bias_data,
+                             gamma_data,
+                             beta_data,
+                             output_data + offset,
+                             skip_input_bias_add_output_data != nullptr ? skip_input_bias_add_output_data + offset : nullptr,
+                             static_cast<size_t>(hidden_size),
+                             epsilon,
+                             false);
+}
+}  // namespace
+
 template <typename T>
 Status SkipLayerNorm<T>::Compute(OpKernelContext* p_ctx) const {
   const Tensor* input = p_ctx->Input<Tensor>(0);
@@ -75,42 +157,8 @@ Status SkipLayerNorm<T>::Compute(OpKernelContext* p_ctx) const {
   concurrency::ThreadPool::TryBatchParallelFor(
       p_ctx->GetOperatorThreadPool(), static_cast<int32_t>(task_count),
       [&](ptrdiff_t task_idx) {
-        auto offset = task_idx * hidden_size;
-
-        const T* p_input = input_data + offset;
-        const T* p_skip = skip_data + (offset % skip_size);
-        T* p_output = output_data + offset;
-        T* p_skip_input_bias_add_output_data = skip_input_bias_add_output_data != nullptr ? skip_input_bias_add_output_data + offset : nullptr;
-
-        T mean = 0;
-        T mean_square = 0;
-
-        for (int64_t h = 0; h < hidden_size; h++) {
-          T value = p_input[h] + p_skip[h];
-
-          if (nullptr != bias_data) {
-            value += bias_data[h];
-          }
-
-          if (nullptr != p_skip_input_bias_add_output_data) {
-            p_skip_input_bias_add_output_data[h] = value;
-          }
-
-          p_output[h] = value;
-          mean += value;
-          mean_square += value * value;
-        }
-
-        mean = mean / hidden_size;
-        mean_square = sqrt(mean_square / hidden_size - mean * mean + epsilon_);
-
-        for (int64_t h = 0; h < hidden_size; h++) {
-          if (nullptr == beta_data) {
-            p_output[h] = (p_output[h] - mean) / mean_square * gamma_data[h];
-          } else {
-            p_output[h] = (p_output[h] - mean) / mean_square * gamma_data[h] + beta_data[h];
-          }
-        }
+        ComputeJob(input_data, skip_data, gamma_data, beta_data, bias_data, task_idx, hidden_size, skip_size,
+                   epsilon_, output_data, skip_input_bias_add_output_data);
       },
       0);
 
@@ -6,8 +6,11 @@
 #include "core/common/utf8_util.h"
 #include "core/framework/tensor.h"
 #include "core/framework/op_kernel.h"
+#include "core/platform/threadpool.h"
 #include "re2/re2.h"
 
+#include <algorithm>
+
 namespace onnxruntime {
 namespace contrib {
 
@@ -21,15 +24,14 @@ class Tokenizer final : public OpKernel {
   Status Compute(OpKernelContext* context) const override;
 
  private:
-  Status CharTokenize(OpKernelContext* context, size_t N, size_t C,
-                      gsl::span<const int64_t> input_dims) const;
+  // The following tokenize one input string. Rows are independent, so they run in parallel.
+  Status CharTokenize(const std::string& s, size_t& tokens) const;
+
+  Status SeparatorExpressionTokenizer(const std::string& s, std::vector<re2::StringPiece>& row) const;
 
-  Status SeparatorExpressionTokenizer(OpKernelContext* context, size_t N, size_t C,
-                                      gsl::span<const int64_t> input_dims) const;
+  Status TokenExpression(const std::string& s, std::vector<re2::StringPiece>& row) const;
 
-  Status TokenExpression(OpKernelContext* ctx,
-                         size_t N, size_t C,
-                         gsl::span<const int64_t> input_dims) const;
+  void OutputRow(gsl::span<const re2::StringPiece> tokens, size_t max_tokens, std::string* output) const;
 
   bool mark_{false};
   std::string pad_value_;
@@ -52,6 +54,27 @@ ONNX_CPU_OPERATOR_TYPED_MS_KERNEL(
 namespace tokenizer_details {
 constexpr char start_text = 0x2;
 constexpr char end_text = 0x3;
+
+// Smallest number of rows worth handing to another thread.
+constexpr size_t kMinRowsPerBatch = 64;
+
+// Calls fn(first_row, last_row) for batches of rows in parallel.
+// Returns the error of the first batch that failed, as tokenizing the rows in order would.
+template <typename Fn>
+Status ParallelForRows(concurrency::ThreadPool* tp, size_t num_rows, const Fn& fn) {
+  const size_t num_batches = std::clamp<size_t>(num_rows / kMinRowsPerBatch, 1,
+                                                concurrency::ThreadPool::DegreeOfParallelism(tp));
+  std::vector<Status> status(num_batches);
+  concurrency::ThreadPool::TrySimpleParallelFor(tp, narrow<std::ptrdiff_t>(num_batches), [&](std::ptrdiff_t b) {
+    const auto work = concurrency::ThreadPool::PartitionWork(b, narrow<std::ptrdiff_t>(num_batches),
+                                                             narrow<std::ptrdiff_t>(num_rows));
+    status[b] = fn(narrow<size_t>(work.start), narrow<size_t>(work.end));
+  });
+  for (const auto& s : status) {
+    ORT_RETURN_IF_ERROR(s);
+  }
+  return Status::OK();
+}
 }  // namespace tokenizer_details
 
 using namespace tokenizer_details;
@@ -114,349 +137,158 @@ Tokenizer::Tokenizer(const OpKernelInfo& info) : OpKernel(info) {
   }
 }
 
-Status Tokenizer::CharTokenize(OpKernelContext* ctx, size_t N, size_t C,
-                               gsl::span<const int64_t> input_dims) const {
-  // With char tokenzation we get as many tokens as the number of
-  // utf8 characters in the string. So for every string we calculate its character(utf8) length
-  // add padding and add start/end test separators if necessary
-  size_t max_tokens = 0;
-  auto X = ctx->Input<Tensor>(0);
-  auto const input_data = X->Data<std::string>();
-  auto curr_input = input_data;
-  auto const last = input_data + N * C;
-  while (curr_input != last) {
-    const auto& s = *curr_input;
-    size_t tokens = 0;  // length in utf8 chars
-    if (!utf8_validate(reinterpret_cast<const unsigned char*>(s.data()), s.size(),
-                       tokens)) {
-      // Please do not include the input text in the error message as it could
-      // be deemed as a compliance violation by teams using this operator
-      return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
-                    "Input string contains invalid utf8 chars");
-    }
-    max_tokens = std::max(max_tokens, tokens);
-    ++curr_input;
-  }
-
-  std::vector<int64_t> output_dims(input_dims.begin(), input_dims.end());
-  // Check if we have no output due to apparently empty strings input.
-  if (max_tokens == 0) {
-    output_dims.push_back(0);
-    TensorShape output_shape(output_dims);
-    ctx->Output(0, output_shape);
-    return Status::OK();
-  }
 
-  if (mark_) {
-    max_tokens += 2;  // Start/end markers as separate tokens
-  }
-
-  output_dims.push_back(max_tokens);
-  TensorShape output_shape(output_dims);
-  auto output_tensor = ctx->Output(0, output_shape);
-  auto const output_data = output_tensor->MutableData<std::string>();
-  size_t output_index = 0;
-  curr_input = input_data;
-  while (curr_input != last) {
-    const auto& s = *curr_input;
-    if (mark_) {
-      (output_data + output_index)->assign(&start_text, 1);
-      ++output_index;
-    }
-    size_t tokens = 0;
-    const size_t str_len = s.size();
-    for (size_t token_idx = 0; token_idx < str_len;) {
-      size_t tlen = 0;
-      bool result = utf8_bytes(static_cast<unsigned char>(s[token_idx]), tlen);
-      assert(result);
-      (void)result;
-      assert(token_idx + tlen <= str_len);
-      *(output_data + output_index) = s.substr(token_idx, tlen);
-      ++output_index;
-      token_idx += tlen;
-      ++tokens;
-    }
-    if (mark_) {
-      (output_data + output_index)->assign(&end_text, 1);
-      ++output_index;
-    }
-    // Padding strings
-    assert(tokens + (static_cast<size_t>(mark_) * 2) <= max_tokens);
-    const size_t pads = max_tokens - (static_cast<size_t>(mark_) * 2) - tokens;
-    for (size_t p = 0; p < pads; ++p) {
-      *(output_data + output_index) = pad_value_;
-      ++output_index;
-    }
-    ++curr_input;
+Status Tokenizer::CharTokenize(const std::string& s, size_t& tokens) const {
+  // With char tokenzation we get as many tokens as the number of
+  // utf8 characters in the string.
+  tokens = 0;  // length in utf8 chars
+  if (!utf8_validate(reinterpret_cast<const unsigned char*>(s.data()), s.size(),
+                     tokens)) {
+    // Please do not include the input text in the error message as it could
+    // be deemed as a compliance violation by teams using this operator
+    return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
+                  "Input string contains invalid utf8 chars");
   }
   return Status::OK();
 }
 
-Status Tokenizer::SeparatorExpressionTokenizer(OpKernelContext* ctx,
-                                               size_t N, size_t C,
-                                               gsl::span<const int64_t> input_dims) const {
+Status Tokenizer::SeparatorExpressionTokenizer(const std::string& s,
+                                               std::vector<re2::StringPiece>& row) const {
   using namespace re2;
-  std::vector<std::vector<StringPiece>> rows;
-  rows.reserve(N * C);
-
   // We do not constraint the search to match
   // on the beginning or end of the string
   const RE2::Anchor anchor = RE2::UNANCHORED;
 
-  // Scan all strings and attempt to find separators in them
-  // collect all the output tokens here
-  size_t max_tokens = 0;
-  auto X = ctx->Input<Tensor>(0);
-  auto const input_data = X->Data<std::string>();
-  auto curr_input = input_data;
-  auto const last = input_data + N * C;
-  while (curr_input != last) {
-    const auto& s = *curr_input;
-    size_t utf8_chars = 0;  // length in utf8 chars
-    if (!utf8_validate(reinterpret_cast<const unsigned char*>(s.data()), s.size(),
-                       utf8_chars)) {
-      return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
-                    "Input string contains invalid utf8 chars: " + s);
-    }
+  size_t utf8_chars = 0;  // length in utf8 chars
+  if (!utf8_validate(reinterpret_cast<const unsigned char*>(s.data()), s.size(),
+                     utf8_chars)) {
+    return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
+                  "Input string contains invalid utf8 chars: " + s);
+  }
 
-    std::vector<StringPiece> row{s};
-
-    for (const auto& sep : separators_) {
-      std::vector<StringPiece> tokens;
-      for (const auto& text : row) {
-        const auto end_pos = text.length();
-        size_t start_pos = 0;
-        StringPiece submatch;
-
-        bool match = true;
-        do {
-          match = sep->Match(text, start_pos, end_pos, anchor, &submatch, 1);
-          if (match) {
-            // Record  pos/len
-            assert(submatch.data() != nullptr);
-            size_t match_pos = submatch.data() - text.data();
-            assert(match_pos >= start_pos);
-            auto token_len = match_pos - start_pos;
-            utf8_chars = 0;
-            bool valid = utf8_len(reinterpret_cast<const unsigned char*>(text.data() + start_pos),
-                                  token_len, utf8_chars);
-            if (!valid) {
-              return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
-                            "Match contains invalid utf8 chars: " + std::string{submatch});
-            }
-            if (utf8_chars >= size_t(mincharnum_)) {
-              tokens.emplace_back(text.data() + start_pos, token_len);
-            }
-            // Update starting position
-            // Guard against empty string match
-            auto match_len = submatch.length();
-            if (match_len > 0) {
-              start_pos = match_pos + match_len;
-            } else {
-              size_t bytes = 0;
-              utf8_bytes(*submatch.data(), bytes);
-              start_pos = match_pos + bytes;
-            }
+  row.assign(1, StringPiece(s));
+
+  std::vector<StringPiece> tokens;
+  for (const auto& sep : separators_) {
+    tokens.clear();
+    for (const auto& text : row) {
+      const auto end_pos = text.length();
+      size_t start_pos = 0;
+      StringPiece submatch;
+
+      bool match = true;
+      do {
+        match = sep->Match(text, start_pos, end_pos, anchor, &submatch, 1);
+        if (match) {
+          // Record  pos/len
+          assert(submatch.data() != nullptr);
+          size_t match_pos = submatch.data() - text.data();
+          assert(match_pos >= start_pos);
+          auto token_len = match_pos - start_pos;
+          utf8_chars = 0;
+          bool valid = utf8_len(reinterpret_cast<const unsigned char*>(text.data() + start_pos),
+                                token_len, utf8_chars);
+          if (!valid) {
+            return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
+                          "Match contains invalid utf8 chars: " + std::string{submatch});
+          }
+          if (utf8_chars >= size_t(mincharnum_)) {
+            tokens.emplace_back(text.data() + start_pos, token_len);
+          }
+          // Update starting position
+          // Guard against empty string match
+          auto match_len = submatch.length();
+          if (match_len > 0) {
+            start_pos = match_pos + match_len;
           } else {
-            // record trailing token
-            auto trailing_len = end_pos - start_pos;
-            utf8_chars = 0;
-            utf8_len(reinterpret_cast<const unsigned char*>(text.data() + start_pos),
-                     trailing_len, utf8_chars);
-            if (utf8_chars >= size_t(mincharnum_)) {
-              tokens.emplace_back(text.data() + start_pos, trailing_len);
-            }
+            size_t bytes = 0;
+            utf8_bytes(*submatch.data(), bytes);
+            start_pos = match_pos + bytes;
           }
-        } while (match);
-      }  // row
-      // Replace the row with the results of this tokenezation
-      row.swap(tokens);
-    }  // separators_
-    max_tokens = std::max(max_tokens, row.size());
-    rows.push_back(std::move(row));
-    ++curr_input;
-  }
-
-  std::vector<int64_t> output_dims(input_dims.begin(), input_dims.end());
-  // Check if we have no output due to either empty input
-  // everything is a separator
-  if (max_tokens == 0) {
-    output_dims.push_back(0);
-    TensorShape output_shape(output_dims);
-    ctx->Output(0, output_shape);
-    return Status::OK();
-  }
-
-  if (mark_) {
-    max_tokens += 2;  // Start/end markers as separate tokens
-  }
-
-  output_dims.push_back(max_tokens);
-  TensorShape output_shape(output_dims);
-
-  auto output_tensor = ctx->Output(0, output_shape);
-  auto const output_data = output_tensor->MutableData<std::string>();
-
-#ifdef _DEBUG
-  const size_t max_output_index = N * C * max_tokens;
-#endif
-  size_t output_index = 0;
-  curr_input = input_data;
-  for (auto& row : rows) {
-#ifdef _DEBUG
-    size_t c_idx = output_index;
-#endif
-    if (mark_) {
-      (output_data + output_index)->assign(&start_text, 1);
-      ++output_index;
-    }
-    // Output tokens for this row
-    for (const auto& token : row) {
-      (output_data + output_index)->assign(token.data(), token.size());
-      ++output_index;
-    }
-    if (mark_) {
-      (output_data + output_index)->assign(&end_text, 1);
-      ++output_index;
-    }
-    const size_t pads = max_tokens - (static_cast<size_t>(mark_) * 2) - row.size();
-    for (size_t p = 0; p < pads; ++p) {
-      *(output_data + output_index) = pad_value_;
-      ++output_index;
-    }
-#ifdef _DEBUG
-    assert(output_index <= max_output_index);
-    assert((output_index - c_idx) <= max_tokens);
-#endif
-    ++curr_input;
-  }
+        } else {
+          // record trailing token
+          auto trailing_len = end_pos - start_pos;
+          utf8_chars = 0;
+          utf8_len(reinterpret_cast<const unsigned char*>(text.data() + start_pos),
+                   trailing_len, utf8_chars);
+          if (utf8_chars >= size_t(mincharnum_)) {
+            tokens.emplace_back(text.data() + start_pos, trailing_len);
+          }
+        }
+      } while (match);
+    }  // row
+    // Replace the row with the results of this tokenezation
+    row.swap(tokens);
+  }  // separators_
   return Status::OK();
 }
 
-Status Tokenizer::TokenExpression(OpKernelContext* ctx,
-                                  size_t N, size_t C,
-                                  gsl::span<const int64_t> input_dims) const {
+Status Tokenizer::TokenExpression(const std::string& s,
+                                  std::vector<re2::StringPiece>& row) const {
   using namespace re2;
-  // Represents a token that will be output after
-  // first is the index, second is the size;
-  std::vector<std::vector<StringPiece>> tokens;
-  tokens.reserve(N * C);
-
-  size_t max_tokens = 0;
-  auto X = ctx->Input<Tensor>(0);
-  auto const input_data = X->Data<std::string>();
-  auto curr_input = input_data;
-  auto const last = input_data + N * C;
-
   // We do not constraint the search to match
   // on the beginning or end of the string
   const RE2::Anchor anchor = RE2::UNANCHORED;
 
-  while (curr_input != last) {
-    const auto& s = *curr_input;
+  size_t utf8_chars = 0;
+  if (!utf8_validate(reinterpret_cast<const unsigned char*>(s.data()), s.size(),
+                     utf8_chars)) {
+    return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
+                  "Input string contains invalid utf8 chars: " + s);
+  }
 
-    size_t utf8_chars = 0;
-    if (!utf8_validate(reinterpret_cast<const unsigned char*>(s.data()), s.size(),
-                       utf8_chars)) {
-      return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
-                    "Input string contains invalid utf8 chars: " + s);
+  StringPiece text(s);
+  const auto end_pos = s.length();
+  size_t start_pos = 0;
+  StringPiece submatch;
+
+  bool match = true;
+  do {
+    match = regex_->Match(text, start_pos, end_pos, anchor, &submatch, 1);
+    if (match) {
+      // Record  pos/len
+      assert(submatch.data() != nullptr);
+      size_t match_pos = submatch.data() - s.data();
+      assert(match_pos >= start_pos);
+      // Guard against empty match and make
+      // sure we make progress either way
+      auto token_len = submatch.length();
+      utf8_chars = 0;
+      if (!utf8_len(reinterpret_cast<const unsigned char*>(submatch.data()), token_len, utf8_chars)) {
+        return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
+                      "Match contains invalid utf8 chars: " + std::string{submatch});
+      }
+      if (utf8_chars >= size_t(mincharnum_)) {
+        row.push_back(submatch);
+        start_pos = match_pos + token_len;
+      } else {
+        size_t bytes = 0;
+        utf8_bytes(*submatch.data(), bytes);
+        start_pos = match_pos + bytes;
+      }
     }
+  } while (match);
+  return Status::OK();
+}
 
-    tokens.emplace_back();
-    auto& row = tokens.back();
-
-    StringPiece text(s);
-    const auto end_pos = s.length();
-    size_t start_pos = 0;
-    StringPiece submatch;
-
-    bool match = true;
-    do {
-      match = regex_->Match(text, start_pos, end_pos, anchor, &submatch, 1);
-      if (match) {
-        // Record  pos/len
-        assert(submatch.data() != nullptr);
-        size_t match_pos = submatch.data() - s.data();
-        assert(match_pos >= start_pos);
-        // Guard against empty match and make
-        // sure we make progress either way
-        auto token_len = submatch.length();
-        utf8_chars = 0;
-        if (!utf8_len(reinterpret_cast<const unsigned char*>(submatch.data()), token_len, utf8_chars)) {
-          return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
-                        "Match contains invalid utf8 chars: " + std::string{submatch});
-        }
-        if (utf8_chars >= size_t(mincharnum_)) {
-          row.push_back(submatch);
-          start_pos = match_pos + token_len;
-        } else {
-          size_t bytes = 0;
-          utf8_bytes(*submatch.data(), bytes);
-          start_pos = match_pos + bytes;
-        }
-      }
-    } while (match);
-    max_tokens = std::max(max_tokens, row.size());
-    ++curr_input;
+void Tokenizer::OutputRow(gsl::span<const re2::StringPiece> tokens, size_t max_tokens,
+                          std::string* output) const {
+  assert(tokens.size() + (static_cast<size_t>(mark_) * 2) <= max_tokens);
+  std::string* const row_end = output + max_tokens;
+  if (mark_) {
+    (output++)->assign(&start_text, 1);
   }
-
-  // Check for empty output
-  std::vector<int64_t> output_dims(input_dims.begin(), input_dims.end());
-  // Check if we have no output due to either empty input
-  // everything is a separator
-  if (max_tokens == 0) {
-    output_dims.push_back(0);
-    TensorShape output_shape(output_dims);
-    ctx->Output(0, output_shape);
-    return Status::OK();
+  // Output tokens for this row
+  for (const auto& token : tokens) {
+    (output++)->assign(token.data(), token.size());
   }
-
   if (mark_) {
-    max_tokens += 2;  // Start/end markers as separate tokens
+    (output++)->assign(&end_text, 1);
   }
-
-  output_dims.push_back(max_tokens);
-  TensorShape output_shape(output_dims);
-
-  auto output_tensor = ctx->Output(0, output_shape);
-  auto const output_data = output_tensor->MutableData<std::string>();
-
-#ifdef _DEBUG
-  const size_t max_output_index = N * C * max_tokens;
-#endif
-  curr_input = input_data;
-  size_t output_index = 0;
-  for (const auto& row : tokens) {
-    assert(curr_input != last);
-#ifdef _DEBUG
-    size_t c_idx = output_index;
-#endif
-    if (mark_) {
-      (output_data + output_index)->assign(&start_text, 1);
-      ++output_index;
-    }
-    // Output tokens for this row
-    for (const auto& token : row) {
-      (output_data + output_index)->assign(token.data(), token.length());
-      ++output_index;
-    }
-    if (mark_) {
-      (output_data + output_index)->assign(&end_text, 1);
-      ++output_index;
-    }
-    const size_t pads = max_tokens - (static_cast<size_t>(mark_) * 2) - row.size();
-    for (size_t p = 0; p < pads; ++p) {
-      *(output_data + output_index) = pad_value_;
-      ++output_index;
-    }
-#ifdef _DEBUG
-    assert(output_index <= max_output_index);
-    assert((output_index - c_idx) <= max_tokens);
-#endif
-    ++curr_input;
+  // Padding strings
+  while (output != row_end) {
+    *output++ = pad_value_;
   }
-
-  return Status::OK();
 }
 
 Status Tokenizer::Compute(OpKernelContext* ctx) const {
@@ -484,7 +316,6 @@ Status Tokenizer::Compute(OpKernelContext* ctx) const {
   }
 
   // Empty input
-  Status s;
   if (input_shape.Size() == 0) {
     std::vector<int64_t> output_dims;
     if (input_dims.size() == 2) {
@@ -494,20 +325,85 @@ Status Tokenizer::Compute(OpKernelContext* ctx) const {
 
     TensorShape output_shape(output_dims);
     ctx->Output(0, output_shape);
-    return s;
+    return Status::OK();
   }
 
-  if (char_tokenezation_) {
-    s = CharTokenize(ctx, N, C, input_dims);
-  } else {
-    if (!separators_.empty()) {
-      s = SeparatorExpressionTokenizer(ctx, N, C, input_dims);
-    } else {
-      assert(regex_ != nullptr);
-      s = TokenExpression(ctx, N, C, input_dims);
+  concurrency::ThreadPool* tp = ctx->GetOperatorThreadPool();
+  auto const input_data = X->Data<std::string>();
+  const size_t num_rows = N * C;
+
+  // Char tokenization only needs the number of characters of each row,
+  // the others collect the tokens of all the rows.
+  std::vector<size_t> row_tokens(num_rows);
+  std::vector<std::vector<re2::StringPiece>> rows;
+  if (!char_tokenezation_) {
+    rows.resize(num_rows);
+  }
+  ORT_RETURN_IF_ERROR(ParallelForRows(tp, num_rows, [&](size_t first, size_t last) -> Status {
+    for (size_t r = first; r < last; ++r) {
+      if (char_tokenezation_) {
+        ORT_RETURN_IF_ERROR(CharTokenize(input_data[r], row_tokens[r]));
+      } else {
+        if (!separators_.empty()) {
+          ORT_RETURN_IF_ERROR(SeparatorExpressionTokenizer(input_data[r], rows[r]));
+        } else {
+          assert(regex_ != nullptr);
+          ORT_RETURN_IF_ERROR(TokenExpression(input_data[r], rows[r]));
+        }
+        row_tokens[r] = rows[r].size();
+      }
     }
+    return Status::OK();
+  }));
+
+  size_t max_tokens = *std::max_element(row_tokens.cbegin(), row_tokens.cend());
+  std::vector<int64_t> output_dims(input_dims.begin(), input_dims.end());
+  // Check if we have no output due to either empty input
+  // everything is a separator
+  if (max_tokens == 0) {
+    output_dims.push_back(0);
+    TensorShape output_shape(output_dims);
+    ctx->Output(0, output_shape);
+    return Status::OK();
   }
-  return s;
+
+  if (mark_) {
+    max_tokens += 2;  // Start/end markers as separate tokens
+  }
+
+  output_dims.push_back(max_tokens);
+  TensorShape output_shape(output_dims);
+
+  auto output_tensor = ctx->Output(0, output_shape);
+  auto const output_data = output_tensor->MutableData<std::string>();
+
+  return ParallelForRows(tp, num_rows, [&](size_t first, size_t last) -> Status {
+    std::vector<re2::StringPiece> chars;
+    for (size_t r = first; r < last; ++r) {
+      std::string* output = output_data + r * max_tokens;
+      if (!char_tokenezation_) {
+        OutputRow(rows[r], max_tokens, output);
+        continue;
+      }
+      // Every utf8 character is a token, and ASCII ones are a single byte.
+      const std::string& s = input_data[r];
+      const size_t str_len = s.size();
+      chars.clear();
+      for (size_t token_idx = 0; token_idx < str_len;) {
+        size_t tlen = 1;
+        if (static_cast<unsigned char>(s[token_idx]) >= 0x80u) {
+          bool result = utf8_bytes(static_cast<unsigned char>(s[token_idx]), tlen);
+          assert(result);
+          (void)result;
+        }
+        assert(token_idx + tlen <= str_len);
+        chars.emplace_back(s.data() + token_idx, tlen);
+        token_idx += tlen;
+      }
+      OutputRow(chars, max_tokens, output);
+    }
+    return Status::OK();
+  });
 }
 }  // namespace contrib
 }  // namespace onnxruntime
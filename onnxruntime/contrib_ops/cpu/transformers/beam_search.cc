@@ -192,6 +192,9 @@ Status BeamSearch::Compute(OpKernelContext* ctx) const {
     ORT_ENFORCE(init_run_decoder_feeds_fetches_manager_, "CreateFeedsFetchesManager must be called prior to execution of graph.");
     ORT_ENFORCE(init_run_gpt_subgraph_ && gpt_subgraph_ && init_run_gpt_subgraph_->past_present_share_buffer_ == gpt_subgraph_->past_present_share_buffer_,
                 "past_present_share_buffer mode must be same for init decoder and decoder subgraphes");
+    ORT_ENFORCE(init_run_gpt_subgraph_->use_paged_kv_cache_ == gpt_subgraph_->use_paged_kv_cache_ &&
+                    init_run_gpt_subgraph_->kv_cache_page_size == gpt_subgraph_->kv_cache_page_size,
+                "paged past state must be same for init decoder and decoder subgraphes");
   }
 
   concurrency::ThreadPool* thread_pool = ctx->GetOperatorThreadPool();
@@ -76,7 +76,8 @@ class BeamSearchGpt : public BeamSearchBase<T> {
                             OrtValue& expanded_input_ids,
                             std::vector<OrtValue>& feeds,
                             IAllocatorUniquePtr<char>& buffer,
-                            bool need_cache_indir);
+                            bool need_cache_indir,
+                            const PagedKVCache* paged_kv_cache);
 
   // Update the input for next iteration.
   Status UpdateFeeds(
@@ -115,7 +116,8 @@ Status BeamSearchGpt<T>::CreateInitialFeeds(gsl::span<int32_t>& sequence_lengths
                                             OrtValue& expanded_input_ids,
                                             std::vector<OrtValue>& feeds,
                                             IAllocatorUniquePtr<char>& buffer,
-                                            bool need_cache_indir) {
+                                            bool need_cache_indir,
+                                            const PagedKVCache* paged_kv_cache) {
   const OrtValue* input_ids_value = this->context_.GetInputOrtValue(0);
   const Tensor& input_ids = input_ids_value->Get<Tensor>();
   const OrtValue* attn_mask_value = this->context_.GetInputOrtValue(9);
@@ -134,7 +136,8 @@ Status BeamSearchGpt<T>::CreateInitialFeeds(gsl::span<int32_t>& sequence_lengths
                                                       buffer,
                                                       this->ort_stream_,
                                                       this->parameters_->max_length,
-                                                      need_cache_indir);
+                                                      need_cache_indir,
+                                                      paged_kv_cache);
   }
 
   return gpt_subgraph_.CreateInitialFeeds(input_ids,
@@ -150,7 +153,8 @@ Status BeamSearchGpt<T>::CreateInitialFeeds(gsl::span<int32_t>& sequence_lengths
                                           buffer,
                                           this->ort_stream_,
                                           this->parameters_->max_length,
-                                          need_cache_indir);
+                                          need_cache_indir,
+                                          paged_kv_cache);
 }
 
 template <typename T>
@@ -217,13 +221,32 @@ Status BeamSearchGpt<T>::Execute(const FeedsFetchesManager* init_run_feeds_fetch
                                this->cpu_allocator_,
                                this->IsCuda()};
 
+  // Past state in pages that beams share after reordering, instead of copying it
+  std::unique_ptr<PagedKVCache> paged_kv_cache;
+  if (gpt_subgraph_.use_paged_kv_cache_) {
+    paged_kv_cache = std::make_unique<PagedKVCache>(gpt_subgraph_.num_layers,
+                                                    static_cast<int>(parameters->BatchBeamSize()),
+                                                    gpt_subgraph_.num_heads,
+                                                    gpt_subgraph_.head_size,
+                                                    gpt_subgraph_.kv_cache_page_size,
+                                                    parameters->max_length,
+                                                    DataTypeImpl::GetType<T>(),
+                                                    this->temp_space_allocator_,
+                                                    this->cpu_allocator_);
+    ORT_RETURN_IF_ERROR(paged_kv_cache->Reserve(0, parameters->sequence_length));
+  }
+
   // buffer in GPU for input_ids, position_ids and attention_mask
   IAllocatorUniquePtr<char> buffer;
   OrtValue expanded_input_ids_in_cpu;
   ORT_RETURN_IF_ERROR(CreateInitialFeeds(cpu_state.sequence_lengths, expanded_input_ids_in_cpu, feeds, buffer,
-                                         gpt_subgraph_.has_decoder_masked_attention_));
+                                         gpt_subgraph_.has_decoder_masked_attention_, paged_kv_cache.get()));
 
-  if (gpt_subgraph_.past_present_share_buffer_) {  // Reuse past and present
+  if (paged_kv_cache != nullptr) {  // Past and present share the paged cache
+    paged_kv_cache->SetFeedsAndFetches(feeds, fetches,
+                                       gpt_subgraph_.GetFirstPastInputIndex(),
+                                       gpt_subgraph_.GetFirstPresentOutputIndex());
+  } else if (gpt_subgraph_.past_present_share_buffer_) {  // Reuse past and present
     fetches.reserve(static_cast<size_t>(gpt_subgraph_.GetFirstPresentOutputIndex()) + gpt_subgraph_.num_layers);
     fetches.resize(gpt_subgraph_.GetFirstPresentOutputIndex(), OrtValue());
     for (int layer = 0; layer < gpt_subgraph_.num_layers; layer++) {
@@ -373,6 +396,15 @@ Status BeamSearchGpt<T>::Execute(const FeedsFetchesManager* init_run_feeds_fetch
                                       current_length - 1,
                                       parameters->sequence_length,
                                       gpt_subgraph_.has_decoder_masked_attention_));
+
+      if (paged_kv_cache != nullptr) {
+        // Each beam continues from the pages of its source beam, and only its last page is copied when shared.
+        paged_kv_cache->Reorder(ReinterpretAsSpan<const int32_t>(this->beam_scorer_->GetNextIndicesCPU()));
+        ORT_RETURN_IF_ERROR(paged_kv_cache->Reserve(current_length - 1, current_length));
+        paged_kv_cache->SetFeedsAndFetches(feeds, fetches,
+                                           gpt_subgraph_.GetFirstPastInputIndex(),
+                                           gpt_subgraph_.GetFirstPresentOutputIndex());
+      }
     }
 
     if (this->beam_scorer_->IsDoneLater())
@@ -3,6 +3,8 @@
 
 #pragma once
 #include <algorithm>
+#include <cstring>
+#include <numeric>
 #include <vector>
 
 #include "core/common/span_utils.h"
@@ -21,6 +23,30 @@ std::pair<Status, std::unique_ptr<GptSubgraph>> CreateGptSubgraphAndUpdateParame
     const std::string& attribute_name,
     const SessionState& subgraph_session_state,
     /*out*/ BeamSearchParameters& parameters);
+
+// Gather the slices of a tensor at the given indices of a dimension.
+inline void GatherSlices(const Tensor& input,
+                         size_t axis,
+                         gsl::span<const int32_t> indices,
+                         AllocatorPtr allocator,
+                         OrtValue& output) {
+  const TensorShape& shape = input.Shape();
+  TensorShape output_shape = shape;
+  output_shape[axis] = static_cast<int64_t>(indices.size());
+  Tensor::InitOrtValue(input.DataType(), output_shape, std::move(allocator), output);
+
+  const size_t slice_bytes = SafeInt<size_t>(shape.SizeFromDimension(axis + 1)) * input.DataType()->Size();
+  const int64_t outer_size = shape.SizeToDimension(axis);
+  const auto* source = static_cast<const uint8_t*>(input.DataRaw());
+  auto* target = static_cast<uint8_t*>(output.GetMutable<Tensor>()->MutableDataRaw());
+  for (int64_t i = 0; i < outer_size; i++) {
+    for (int32_t index : indices) {
+      const size_t offset = SafeInt<size_t>(i * shape[axis] + index) * slice_bytes;
+      memcpy(target, source + offset, slice_bytes);
+      target += slice_bytes;
+    }
+  }
+}
 }  // namespace gpt_details
 
 // Greedy search implementation for GPT-2 model.
@@ -89,7 +115,8 @@ class GreedySearchGpt : public GreedySearchBase<T, ParametersT> {
   Status CreateInitialFeeds(gsl::span<int32_t>& sequence_lengths,
                             OrtValue& expanded_input_ids,
                             std::vector<OrtValue>& feeds,
-                            IAllocatorUniquePtr<char>& buffer);
+                            IAllocatorUniquePtr<char>& buffer,
+                            const PagedKVCache* paged_kv_cache);
 
   // Update the input for next iteration.
   Status UpdateFeeds(
@@ -101,6 +128,18 @@ class GreedySearchGpt : public GreedySearchBase<T, ParametersT> {
       gsl::span<const int32_t> next_tokens,
       int past_sequence_length);
 
+  // Remove the rows of the sequences that have finished from the state carried to the next iteration (attention
+  // mask, position ids and past state), so that the subgraph only computes the unfinished ones. It is called
+  // before UpdateFeeds, which appends the next tokens of the rows in active_batch_ids. active_batch_ids maps each
+  // row of the subgraph inputs and outputs to its sequence.
+  Status RetireFinishedSequences(gsl::span<const bool> eos_meet,
+                                 std::vector<int32_t>& active_batch_ids,
+                                 gsl::span<int32_t> next_positions,
+                                 std::vector<OrtValue>& feeds,
+                                 std::vector<OrtValue>& fetches,
+                                 OrtValue& position_ids,
+                                 PagedKVCache* paged_kv_cache);
+
   const SessionState* init_run_decoder_session_state_ = nullptr;
   GptSubgraph* init_run_gpt_subgraph_ = nullptr;
   GptSubgraph& gpt_subgraph_;
@@ -122,7 +161,8 @@ template <typename T, typename ParametersT>
 Status GreedySearchGpt<T, ParametersT>::CreateInitialFeeds(gsl::span<int32_t>& sequence_lengths,
                                                            OrtValue& expanded_input_ids,
                                                            std::vector<OrtValue>& feeds,
-                                                           IAllocatorUniquePtr<char>& buffer) {
+                                                           IAllocatorUniquePtr<char>& buffer,
+                                                           const PagedKVCache* paged_kv_cache) {
   const OrtValue* input_ids_value = this->context_.GetInputOrtValue(0);
   const Tensor& input_ids = input_ids_value->Get<Tensor>();
   const OrtValue* attn_mask_value = this->context_.GetInputOrtValue(6);
@@ -140,7 +180,9 @@ Status GreedySearchGpt<T, ParametersT>::CreateInitialFeeds(gsl::span<int32_t>& s
                                                       this->add_to_feeds_func_,
                                                       buffer,
                                                       this->ort_stream_,
-                                                      this->parameters_->max_length);
+                                                      this->parameters_->max_length,
+                                                      false /* need_cache_indir */,
+                                                      paged_kv_cache);
   }
 
   return gpt_subgraph_.CreateInitialFeeds(input_ids,
@@ -155,7 +197,9 @@ Status GreedySearchGpt<T, ParametersT>::CreateInitialFeeds(gsl::span<int32_t>& s
                                           this->add_to_feeds_func_,
                                           buffer,
                                           this->ort_stream_,
-                                          this->parameters_->max_length);
+                                          this->parameters_->max_length,
+                                          false /* need_cache_indir */,
+                                          paged_kv_cache);
 }
 
 template <typename T, typename ParametersT>
@@ -187,6 +231,78 @@ Status GreedySearchGpt<T, ParametersT>::UpdateFeeds(
                             false);
 }
 
+template <typename T, typename ParametersT>
+Status GreedySearchGpt<T, ParametersT>::RetireFinishedSequences(gsl::span<const bool> eos_meet,
+                                                                std::vector<int32_t>& active_batch_ids,
+                                                                gsl::span<int32_t> next_positions,
+                                                                std::vector<OrtValue>& feeds,
+                                                                std::vector<OrtValue>& fetches,
+                                                                OrtValue& position_ids,
+                                                                PagedKVCache* paged_kv_cache) {
+  std::vector<int32_t> kept_rows;
+  kept_rows.reserve(active_batch_ids.size());
+  for (size_t i = 0; i < active_batch_ids.size(); i++) {
+    if (!eos_meet[active_batch_ids[i]]) {
+      kept_rows.push_back(static_cast<int32_t>(i));
+    }
+  }
+
+  if (kept_rows.empty() || kept_rows.size() == active_batch_ids.size()) {
+    return Status::OK();
+  }
+
+  for (size_t i = 0; i < kept_rows.size(); i++) {
+    active_batch_ids[i] = active_batch_ids[kept_rows[i]];
+    next_positions[i] = next_positions[kept_rows[i]];
+  }
+  active_batch_ids.resize(kept_rows.size());
+
+  // attention_mask. input_ids is replaced by the next tokens in UpdateFeeds.
+  OrtValue kept_mask;
+  gpt_details::GatherSlices(feeds[2].Get<Tensor>(), 0, kept_rows, this->temp_space_allocator_, kept_mask);
+  feeds[2] = kept_mask;
+
+  // position_ids uses the memory buffer owned by next_positions.
+  int64_t dims[] = {static_cast<int64_t>(kept_rows.size()), 1};
+  TensorShape shape(&dims[0], 2);
+  Tensor::InitOrtValue(DataTypeImpl::GetType<int32_t>(),
+                       shape,
+                       next_positions.data(),
+                       this->temp_space_allocator_->Info(),
+                       position_ids);
+
+  if (paged_kv_cache != nullptr) {
+    // The page table is updated in the feeds by the caller via PagedKVCache::SetFeedsAndFetches.
+    paged_kv_cache->Compact(kept_rows);
+    return Status::OK();
+  }
+
+  // Past state has shape (2, batch_size, num_heads, past_sequence_length, head_size). Without a shared buffer,
+  // UpdateFeeds feeds the present outputs of this iteration to the past inputs of the next one.
+  for (int layer = 0; layer < gpt_subgraph_.num_layers; layer++) {
+    const int feed_idx = gpt_subgraph_.GetFirstPastInputIndex() + layer;
+    const size_t fetch_idx = static_cast<size_t>(gpt_subgraph_.GetFirstPresentOutputIndex()) + layer;
+    if (!gpt_subgraph_.past_present_share_buffer_) {
+      OrtValue kept;
+      gpt_details::GatherSlices(fetches[fetch_idx].Get<Tensor>(), 1, kept_rows, this->temp_space_allocator_, kept);
+      fetches[fetch_idx] = kept;
+      continue;
+    }
+
+    OrtValue kept;
+    gpt_details::GatherSlices(feeds[feed_idx].Get<Tensor>(), 1, kept_rows, this->temp_space_allocator_, kept);
+    feeds[feed_idx] = kept;
+
+    Tensor* past_tensor = kept.GetMutable<Tensor>();
+    OrtValue present_tensor_value;
+    Tensor::InitOrtValue(past_tensor->DataType(), past_tensor->Shape(), past_tensor->MutableData<T>(),
+                         past_tensor->Location(), present_tensor_value);
+    fetches[fetch_idx] = present_tensor_value;
+  }
+
+  return Status::OK();
+}
+
 template <typename T, typename ParametersT>
 Status GreedySearchGpt<T, ParametersT>::Execute(const FeedsFetchesManager* init_run_feeds_fetches_manager,
                                                 const FeedsFetchesManager& feeds_fetches_manager) {
@@ -224,11 +340,30 @@ Status GreedySearchGpt<T, ParametersT>::Execute(const FeedsFetchesManager* init_
                         this->IsCuda());
   }
 
+  std::unique_ptr<PagedKVCache> paged_kv_cache;
+  if (gpt_subgraph_.use_paged_kv_cache_) {
+    paged_kv_cache = std::make_unique<PagedKVCache>(gpt_subgraph_.num_layers,
+                                                    static_cast<int>(parameters->BatchBeamSize()),
+                                                    gpt_subgraph_.num_heads,
+                                                    gpt_subgraph_.head_size,
+                                                    gpt_subgraph_.kv_cache_page_size,
+                                                    parameters->max_length,
+                                                    DataTypeImpl::GetType<T>(),
+                                                    this->temp_space_allocator_,
+                                                    this->cpu_allocator_);
+    ORT_RETURN_IF_ERROR(paged_kv_cache->Reserve(0, parameters->sequence_length));
+  }
+
   IAllocatorUniquePtr<char> buffer;
   OrtValue expanded_input_ids_in_cpu;
-  ORT_RETURN_IF_ERROR(CreateInitialFeeds(greedy_state.sequence_lengths, expanded_input_ids_in_cpu, feeds, buffer));
-
-  if (gpt_subgraph_.past_present_share_buffer_) {  // Reuse past and present
+  ORT_RETURN_IF_ERROR(CreateInitialFeeds(greedy_state.sequence_lengths, expanded_input_ids_in_cpu, feeds, buffer,
+                                         paged_kv_cache.get()));
+
+  if (paged_kv_cache != nullptr) {  // Past and present share the paged cache
+    paged_kv_cache->SetFeedsAndFetches(feeds, fetches,
+                                       gpt_subgraph_.GetFirstPastInputIndex(),
+                                       gpt_subgraph_.GetFirstPresentOutputIndex());
+  } else if (gpt_subgraph_.past_present_share_buffer_) {  // Reuse past and present
     fetches.reserve(static_cast<size_t>(gpt_subgraph_.GetFirstPresentOutputIndex()) + gpt_subgraph_.num_layers);
     fetches.resize(gpt_subgraph_.GetFirstPresentOutputIndex(), OrtValue());
     for (int layer = 0; layer < gpt_subgraph_.num_layers; layer++) {
@@ -266,6 +401,13 @@ Status GreedySearchGpt<T, ParametersT>::Execute(const FeedsFetchesManager* init_
                        this->temp_space_allocator_->Info(),
                        position_ids);
 
+  // Sequence of each row of the subgraph inputs. On CPU, finished sequences are removed from the subgraph inputs,
+  // and the logits of the remaining rows are scattered back to all sequences before generating next tokens.
+  std::vector<int32_t> active_batch_ids(static_cast<size_t>(parameters->BatchBeamSize()));
+  std::iota(active_batch_ids.begin(), active_batch_ids.end(), 0);
+  std::vector<int32_t> active_next_tokens_buffer;
+  OrtValue all_logits;
+
   int current_length = parameters->sequence_length;
   int iteration_counter = 0;
   while (current_length < parameters->max_length) {
@@ -310,10 +452,29 @@ Status GreedySearchGpt<T, ParametersT>::Execute(const FeedsFetchesManager* init_
 
     ORT_RETURN_IF_ERROR(status);
 
-    const OrtValue& logits = fetches[0];
+    const OrtValue* logits = &fetches[0];
+    if (active_batch_ids.size() < static_cast<size_t>(parameters->BatchBeamSize())) {
+      const Tensor& active_logits = fetches[0].Get<Tensor>();
+      if (!all_logits.IsAllocated()) {
+        // Logits of finished sequences are not used, so they are left as zeros.
+        TensorShape logits_shape = active_logits.Shape();
+        logits_shape[0] = parameters->BatchBeamSize();
+        Tensor::InitOrtValue(active_logits.DataType(), logits_shape, this->temp_space_allocator_, all_logits);
+        memset(all_logits.GetMutable<Tensor>()->MutableDataRaw(), 0, all_logits.Get<Tensor>().SizeInBytes());
+      }
+
+      const size_t row_bytes = active_logits.SizeInBytes() / active_batch_ids.size();
+      const auto* source = static_cast<const uint8_t*>(active_logits.DataRaw());
+      auto* target = static_cast<uint8_t*>(all_logits.GetMutable<Tensor>()->MutableDataRaw());
+      for (size_t i = 0; i < active_batch_ids.size(); i++) {
+        memcpy(target + SafeInt<size_t>(active_batch_ids[i]) * row_bytes, source + i * row_bytes, row_bytes);
+      }
+      logits = &all_logits;
+    }
+
     gsl::span<int32_t> next_tokens;
 
-    ORT_RETURN_IF_ERROR(this->GenerateNextToken(logits,
+    ORT_RETURN_IF_ERROR(this->GenerateNextToken(*logits,
                                                 next_tokens,
                                                 greedy_state,
                                                 sampling_state,
@@ -359,10 +520,32 @@ Status GreedySearchGpt<T, ParametersT>::Execute(const FeedsFetchesManager* init_
     if (current_length < parameters->max_length) {
       bool increase_position = (iteration_counter > 1);
 
+      gsl::span<const int32_t> active_next_tokens = ReinterpretAsSpan<const int32_t>(next_tokens);
+      if (!this->IsCuda()) {
+        ORT_RETURN_IF_ERROR(RetireFinishedSequences(greedy_state.eos_meet, active_batch_ids,
+                                                    greedy_state.next_positions, feeds, fetches,
+                                                    position_ids, paged_kv_cache.get()));
+
+        if (active_batch_ids.size() < static_cast<size_t>(parameters->BatchBeamSize())) {
+          active_next_tokens_buffer.resize(active_batch_ids.size());
+          for (size_t i = 0; i < active_batch_ids.size(); i++) {
+            active_next_tokens_buffer[i] = next_tokens[active_batch_ids[i]];
+          }
+          active_next_tokens = active_next_tokens_buffer;
+        }
+      }
+
       ORT_RETURN_IF_ERROR(UpdateFeeds(fetches, feeds, current_length,
                                       position_ids, increase_position,
-                                      ReinterpretAsSpan<const int32_t>(next_tokens),
+                                      active_next_tokens,
                                       current_length - 1));
+
+      if (paged_kv_cache != nullptr) {
+        ORT_RETURN_IF_ERROR(paged_kv_cache->Reserve(current_length - 1, current_length));
+        paged_kv_cache->SetFeedsAndFetches(feeds, fetches,
+                                           gpt_subgraph_.GetFirstPastInputIndex(),
+                                           gpt_subgraph_.GetFirstPresentOutputIndex());
+      }
     }
     if (gpt_subgraph_.past_present_share_buffer_) {
       // clear fetched values before presents[]
@@ -0,0 +1,230 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/transformers/paged_kv_cache.h"
+
+#include <algorithm>
+#include <cstring>
+#include "core/common/safeint.h"
+#include "core/framework/tensor.h"
+
+namespace onnxruntime {
+namespace contrib {
+namespace transformers {
+
+PagedKVCache::PagedKVCache(int num_layers,
+                           int num_sequences,
+                           int num_heads,
+                           int head_size,
+                           int page_size,
+                           int max_sequence_length,
+                           MLDataType element_type,
+                           AllocatorPtr allocator,
+                           AllocatorPtr cpu_allocator)
+    : num_layers_(num_layers),
+      num_sequences_(num_sequences),
+      page_size_(page_size),
+      max_pages_per_sequence_((max_sequence_length + page_size - 1) / page_size),
+      page_bytes_(SafeInt<size_t>(num_heads) * page_size * head_size * element_type->Size()),
+      element_type_(element_type),
+      allocator_(std::move(allocator)),
+      cpu_allocator_(std::move(cpu_allocator)),
+      num_pages_(0),
+      sequence_num_pages_(num_sequences, 0) {
+  ORT_ENFORCE(page_size > 0, "Page size of paged past state shall be positive. Got ", page_size);
+
+  TensorShape cache_shape{2, 0, num_heads, page_size, head_size};
+  caches_.resize(num_layers);
+  for (auto& cache : caches_) {
+    Tensor::InitOrtValue(element_type_, cache_shape, allocator_, cache);
+  }
+
+  TensorShape page_table_shape{num_sequences, max_pages_per_sequence_};
+  Tensor::InitOrtValue(DataTypeImpl::GetType<int32_t>(), page_table_shape, cpu_allocator_, page_table_);
+  auto page_table = page_table_.GetMutable<Tensor>()->MutableDataAsSpan<int32_t>();
+  std::fill(page_table.begin(), page_table.end(), 0);
+}
+
+int32_t* PagedKVCache::SequencePages(int sequence_index) {
+  return page_table_.GetMutable<Tensor>()->MutableData<int32_t>() +
+         static_cast<ptrdiff_t>(sequence_index) * max_pages_per_sequence_;
+}
+
+Status PagedKVCache::Reserve(int past_sequence_length, int sequence_length) {
+  const int num_required_pages = (sequence_length + page_size_ - 1) / page_size_;
+  ORT_RETURN_IF(num_required_pages > max_pages_per_sequence_,
+                "Sequence length ", sequence_length, " exceeds the capacity of the page table");
+
+  for (int i = 0; i < num_sequences_; i++) {
+    int32_t* pages = SequencePages(i);
+    int& num_pages = sequence_num_pages_[i];
+
+    // Copy on write: the next run appends to the last page, which might be shared with other sequences.
+    for (int j = past_sequence_length / page_size_; j < num_pages; j++) {
+      if (ref_counts_[pages[j]] > 1) {
+        int32_t page = 0;
+        ORT_RETURN_IF_ERROR(AllocatePage(page));
+        CopyPage(pages[j], page);
+        ReleasePage(pages[j]);
+        pages[j] = page;
+      }
+    }
+
+    for (; num_pages < num_required_pages; num_pages++) {
+      ORT_RETURN_IF_ERROR(AllocatePage(pages[num_pages]));
+    }
+  }
+
+  return Status::OK();
+}
+
+void PagedKVCache::Reorder(gsl::span<const int32_t> source_indices) {
+  ORT_ENFORCE(source_indices.size() == static_cast<size_t>(num_sequences_));
+
+  const auto page_table = page_table_.Get<Tensor>().DataAsSpan<int32_t>();
+  std::vector<int32_t> old_page_table(page_table.begin(), page_table.end());
+  std::vector<int> old_sequence_num_pages = sequence_num_pages_;
+
+  // Add the references of the new page tables before releasing the old ones, so that pages kept by any sequence are
+  // not freed.
+  for (int i = 0; i < num_sequences_; i++) {
+    const int source = source_indices[i];
+    ORT_ENFORCE(source >= 0 && source < num_sequences_, "Invalid source sequence index: ", source);
+
+    const int32_t* source_pages = old_page_table.data() + static_cast<ptrdiff_t>(source) * max_pages_per_sequence_;
+    std::copy(source_pages, source_pages + max_pages_per_sequence_, SequencePages(i));
+    sequence_num_pages_[i] = old_sequence_num_pages[source];
+    for (int j = 0; j < sequence_num_pages_[i]; j++) {
+      ref_counts_[source_pages[j]]++;
+    }
+  }
+
+  for (int i = 0; i < num_sequences_; i++) {
+    const int32_t* pages = old_page_table.data() + static_cast<ptrdiff_t>(i) * max_pages_per_sequence_;
+    for (int j = 0; j < old_sequence_num_pages[i]; j++) {
+      ReleasePage(pages[j]);
+    }
+  }
+}
+
+void PagedKVCache::Compact(gsl::span<const int32_t> kept_sequences) {
+  const int num_kept_sequences = static_cast<int>(kept_sequences.size());
+  ORT_ENFORCE(num_kept_sequences > 0 && num_kept_sequences <= num_sequences_,
+              "Invalid number of kept sequences: ", num_kept_sequences);
+
+  const auto page_table = page_table_.Get<Tensor>().DataAsSpan<int32_t>();
+  std::vector<int32_t> old_page_table(page_table.begin(), page_table.end());
+  std::vector<int> old_sequence_num_pages = sequence_num_pages_;
+  const int old_num_sequences = num_sequences_;
+
+  TensorShape page_table_shape{num_kept_sequences, max_pages_per_sequence_};
+  Tensor::InitOrtValue(DataTypeImpl::GetType<int32_t>(), page_table_shape, cpu_allocator_, page_table_);
+  num_sequences_ = num_kept_sequences;
+  sequence_num_pages_.assign(num_kept_sequences, 0);
+
+  std::vector<bool> kept(old_num_sequences, false);
+  for (int i = 0; i < num_kept_sequences; i++) {
+    const int source = kept_sequences[i];
+    ORT_ENFORCE(source >= 0 && source < old_num_sequences && !kept[source],
+                "Invalid kept sequence index: ", source);
+    kept[source] = true;
+
+    // The kept sequence takes over the references of its pages.
+    const int32_t* source_pages = old_page_table.data() + static_cast<ptrdiff_t>(source) * max_pages_per_sequence_;
+    std::copy(source_pages, source_pages + max_pages_per_sequence_, SequencePages(i));
+    sequence_num_pages_[i] = old_sequence_num_pages[source];
+  }
+
+  for (int i = 0; i < old_num_sequences; i++) {
+    if (!kept[i]) {
+      const int32_t* pages = old_page_table.data() + static_cast<ptrdiff_t>(i) * max_pages_per_sequence_;
+      for (int j = 0; j < old_sequence_num_pages[i]; j++) {
+        ReleasePage(pages[j]);
+      }
+    }
+  }
+}
+
+void PagedKVCache::SetFeedsAndFetches(std::vector<OrtValue>& feeds,
+                                      std::vector<OrtValue>& fetches,
+                                      int first_past_input_index,
+                                      int first_present_output_index) const {
+  if (fetches.size() < static_cast<size_t>(first_present_output_index) + num_layers_) {
+    fetches.resize(static_cast<size_t>(first_present_output_index) + num_layers_);
+  }
+
+  for (int layer = 0; layer < num_layers_; layer++) {
+    const OrtValue& cache = caches_[layer];
+    feeds[static_cast<size_t>(first_past_input_index) + layer] = cache;
+
+    // The present output shares the buffer of the past input.
+    Tensor* cache_tensor = const_cast<OrtValue&>(cache).GetMutable<Tensor>();
+    OrtValue present;
+    Tensor::InitOrtValue(cache_tensor->DataType(), cache_tensor->Shape(), cache_tensor->MutableDataRaw(),
+                         cache_tensor->Location(), present);
+    fetches[static_cast<size_t>(first_present_output_index) + layer] = present;
+  }
+
+  feeds[static_cast<size_t>(first_past_input_index) + num_layers_] = page_table_;
+}
+
+Status PagedKVCache::AllocatePage(int32_t& page) {
+  if (free_pages_.empty()) {
+    ORT_RETURN_IF_ERROR(Grow(std::max(num_pages_ * 2, num_pages_ + num_sequences_)));
+  }
+
+  page = free_pages_.back();
+  free_pages_.pop_back();
+  ref_counts_[page] = 1;
+  return Status::OK();
+}
+
+void PagedKVCache::ReleasePage(int32_t page) {
+  if (--ref_counts_[page] == 0) {
+    free_pages_.push_back(page);
+  }
+}
+
+void PagedKVCache::CopyPage(int32_t source, int32_t target) {
+  for (auto& cache : caches_) {
+    auto* data = static_cast<uint8_t*>(cache.GetMutable<Tensor>()->MutableDataRaw());
+    uint8_t* keys = data;
+    uint8_t* values = data + SafeInt<size_t>(num_pages_) * page_bytes_;
+    memcpy(keys + target * page_bytes_, keys + source * page_bytes_, page_bytes_);
+    memcpy(values + target * page_bytes_, values + source * page_bytes_, page_bytes_);
+  }
+}
+
+Status PagedKVCache::Grow(int num_pages) {
+  for (auto& cache : caches_) {
+    const Tensor& old_cache = cache.Get<Tensor>();
+    TensorShape shape = old_cache.Shape();
+    shape[1] = num_pages;
+
+    OrtValue new_cache;
+    Tensor::InitOrtValue(element_type_, shape, allocator_, new_cache);
+
+    // Keys and values of the existing pages keep their page indices.
+    const size_t used_bytes = SafeInt<size_t>(num_pages_) * page_bytes_;
+    if (used_bytes > 0) {
+      const auto* source = static_cast<const uint8_t*>(old_cache.DataRaw());
+      auto* target = static_cast<uint8_t*>(new_cache.GetMutable<Tensor>()->MutableDataRaw());
+      memcpy(target, source, used_bytes);
+      memcpy(target + SafeInt<size_t>(num_pages) * page_bytes_, source + used_bytes, used_bytes);
+    }
+
+    cache = new_cache;
+  }
+
+  ref_counts_.resize(num_pages, 0);
+  for (int32_t page = num_pages - 1; page >= num_pages_; page--) {
+    free_pages_.push_back(page);
+  }
+
+  num_pages_ = num_pages;
+  return Status::OK();
+}
+
+}  // namespace transformers
+}  // namespace contrib
+}  // namespace onnxruntime
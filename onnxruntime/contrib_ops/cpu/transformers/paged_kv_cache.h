@@ -0,0 +1,91 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <vector>
+#include "core/common/gsl.h"
+#include "core/framework/allocator.h"
+#include "core/framework/ort_value.h"
+
+namespace onnxruntime {
+namespace contrib {
+namespace transformers {
+
+// Past state of a GPT subgraph stored in fixed-size pages.
+//
+// The cache of each layer has shape (2, num_pages, num_heads, page_size, head_size), and the page table with shape
+// (num_sequences, max_pages_per_sequence) lists the pages of each sequence in order. The subgraph reads and writes
+// the cache through the page table, see the page_table input of the Attention operator.
+//
+// Pages are reference counted so that sequences can share them: when beams are reordered, a beam picks the page
+// table of its source beam instead of copying its past state. A shared page is only copied when a sequence is about
+// to write to it. The cache grows on demand, so memory scales with the actual sequence lengths instead of being
+// reserved for the maximum length up front.
+class PagedKVCache {
+ public:
+  PagedKVCache(int num_layers,
+               int num_sequences,
+               int num_heads,
+               int head_size,
+               int page_size,
+               int max_sequence_length,
+               MLDataType element_type,
+               AllocatorPtr allocator,
+               AllocatorPtr cpu_allocator);
+
+  // Make sure that every sequence has pages for positions [0, sequence_length), and that the pages of positions
+  // [past_sequence_length, sequence_length) that will be written by the next run are not shared.
+  Status Reserve(int past_sequence_length, int sequence_length);
+
+  // Sequence i continues sequence source_indices[i], and shares its pages.
+  void Reorder(gsl::span<const int32_t> source_indices);
+
+  // Keep only the sequences listed in kept_sequences, in that order, and release the pages of the others.
+  // The page table shrinks to (kept_sequences.size(), max_pages_per_sequence).
+  void Compact(gsl::span<const int32_t> kept_sequences);
+
+  // Set the cache of each layer as past input, and a view of it as present output, of the subgraph. The page table
+  // is set as the input that follows the past state.
+  // The cache might be reallocated by Reserve, and the page table by Compact, so this shall be called again after them.
+  void SetFeedsAndFetches(std::vector<OrtValue>& feeds,
+                          std::vector<OrtValue>& fetches,
+                          int first_past_input_index,
+                          int first_present_output_index) const;
+
+  const OrtValue& GetCache(int layer) const { return caches_[layer]; }
+
+  const OrtValue& GetPageTable() const { return page_table_; }
+
+  int NumPages() const { return num_pages_; }
+
+  int NumFreePages() const { return static_cast<int>(free_pages_.size()); }
+
+ private:
+  int32_t* SequencePages(int sequence_index);
+
+  Status AllocatePage(int32_t& page);
+  void ReleasePage(int32_t page);
+  void CopyPage(int32_t source, int32_t target);
+  Status Grow(int num_pages);
+
+  const int num_layers_;
+  int num_sequences_;
+  const int page_size_;
+  const int max_pages_per_sequence_;
+  const size_t page_bytes_;  // bytes of key or value of one page in one layer
+  MLDataType element_type_;
+  AllocatorPtr allocator_;
+  AllocatorPtr cpu_allocator_;
+
+  int num_pages_;
+  std::vector<OrtValue> caches_;  // one per layer
+  OrtValue page_table_;
+  std::vector<int> sequence_num_pages_;
+  std::vector<int> ref_counts_;
+  std::vector<int32_t> free_pages_;
+};
+
+}  // namespace transformers
+}  // namespace contrib
+}  // namespace onnxruntime
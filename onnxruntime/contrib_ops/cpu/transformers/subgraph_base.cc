@@ -28,6 +28,8 @@ Subgraph::Subgraph(
       num_layers(0),
       past_present_share_buffer_(false),
       has_decoder_masked_attention_(false),
+      use_paged_kv_cache_(false),
+      kv_cache_page_size(0),
       allocator_(nullptr),
       is_output_float16_(false) {
   num_implicit_inputs = static_cast<int>(node.ImplicitInputDefs().size());
@@ -90,6 +92,10 @@ Status Subgraph::Setup(const SessionState& session_state,
         past_present_share_buffer_ = true;
         // past_sequence_length is on CPU memory
         feed_locations.push_back(OrtDevice());
+      } else if (feed_names[i] == "page_table") {
+        use_paged_kv_cache_ = true;
+        // page_table is on CPU memory
+        feed_locations.push_back(OrtDevice());
       } else if (feed_names[i] == "beam_width") {
         // beam_width is on CPU memory
         feed_locations.push_back(OrtDevice());
@@ -45,6 +45,8 @@ class Subgraph {
   int num_layers;
   bool past_present_share_buffer_;
   bool has_decoder_masked_attention_;
+  bool use_paged_kv_cache_;  // past state is a paged cache accessed through a page_table input
+  int kv_cache_page_size;
 
   // Setup execution
   Status Setup(const SessionState& session_state,
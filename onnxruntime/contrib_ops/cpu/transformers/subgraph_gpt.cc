@@ -28,7 +28,8 @@ Status GptSubgraph::CreateInitialFeeds(
     IAllocatorUniquePtr<char>& buffer,
     Stream* ort_stream,
     int past_present_share_buffer_max_seq_len,
-    bool need_cache_indir) {
+    bool need_cache_indir,
+    const PagedKVCache* paged_kv_cache) {
   ORT_ENFORCE(session_state_ != nullptr, "Setup must be called before CreateInitialFeeds");
 
   const IExecutionProvider* provider = GetProvider();
@@ -86,6 +87,17 @@ Status GptSubgraph::CreateInitialFeeds(
     for (int i = first_past_input_index_; i < num_subgraph_inputs; ++i) {
       feeds.push_back(empty_past);
     }
+  } else if (use_paged_kv_cache_) {
+    ORT_ENFORCE(paged_kv_cache != nullptr, "Paged past state is required by the subgraph");
+
+    // The remaining inputs are the paged past state of each layer, followed by `page_table` and
+    // `past_sequence_length`.
+    for (int i = first_past_input_index_; i < num_subgraph_inputs - 2; ++i) {
+      feeds.push_back(paged_kv_cache->GetCache(i - first_past_input_index_));
+    }
+
+    feeds.push_back(paged_kv_cache->GetPageTable());
+    ORT_RETURN_IF_ERROR(AppendPastSequenceLength(feeds, cpu_allocator, 0));
   } else {
     // Past state feeds
     TensorShape past_shape{2, batch_size * num_beams, num_heads, past_present_share_buffer_max_seq_len, head_size};
@@ -127,11 +139,23 @@ Status GptSubgraph::Validate(const std::vector<const NodeArg*>& subgraph_inputs,
 
   ORT_RETURN_IF(!((num_subgraph_inputs == num_subgraph_outputs + 2) ||
                   (num_subgraph_inputs == num_subgraph_outputs + 3) ||
+                  (num_subgraph_inputs == num_subgraph_outputs + 4) ||
                   (num_subgraph_inputs == num_subgraph_outputs + 5)),
                 "Invalid GPT-2 subgraph: number of inputs shall be number of outputs plus 2 or "
                 "3 (if past_present_share_buffer) or "
+                "4 (if past_present_share_buffer with page_table) or "
                 "5 (if past_present_share_buffer and use_decoder_masked_self_attention for BeamSearch)");
 
+  if (use_paged_kv_cache_) {
+    ORT_RETURN_IF(num_subgraph_inputs != num_subgraph_outputs + 4 ||
+                      subgraph_inputs[num_subgraph_inputs - 2]->Name() != "page_table" ||
+                      subgraph_inputs[num_subgraph_inputs - 1]->Name() != "past_sequence_length",
+                  "Invalid GPT-2 subgraph: the last inputs shall be page_table and past_sequence_length "
+                  "when past state is paged");
+    ORT_RETURN_IF(GetProvider()->Type() != kCpuExecutionProvider,
+                  "Paged past state is only supported by the CPU execution provider");
+  }
+
   ORT_RETURN_IF(subgraph_inputs[0]->Name() != "input_ids",
                 "subgraph input 0 shall be named as input_ids, got: ", subgraph_inputs[0]->Name());
   ORT_RETURN_IF(subgraph_inputs[1]->Name() != "position_ids",
@@ -173,6 +197,13 @@ Status GptSubgraph::Validate(const std::vector<const NodeArg*>& subgraph_inputs,
   // Save parameters related to the subgraph.
   num_heads = static_cast<int>(past_shape->dim(2).dim_value());
   head_size = static_cast<int>(past_shape->dim(4).dim_value());
+  if (use_paged_kv_cache_) {
+    // Paged past state shape is like (2, num_pages, num_heads, page_size, hidden_size/num_heads).
+    constexpr int default_page_size = 16;
+    kv_cache_page_size = past_shape->dim(3).has_dim_value() ? static_cast<int>(past_shape->dim(3).dim_value())
+                                                            : default_page_size;
+    ORT_RETURN_IF(kv_cache_page_size <= 0, "subgraph past state dimension 3 shall be a positive page size");
+  }
   vocab_size = static_cast<int>(logits_shape->dim(2).dim_value());
   num_layers = static_cast<int>(subgraph_outputs.size()) - 1;
 
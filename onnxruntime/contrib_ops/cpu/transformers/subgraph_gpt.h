@@ -4,6 +4,7 @@
 #pragma once
 
 #include "contrib_ops/cpu/transformers/subgraph_base.h"
+#include "contrib_ops/cpu/transformers/paged_kv_cache.h"
 
 namespace onnxruntime {
 namespace contrib {
@@ -35,7 +36,8 @@ class GptSubgraph : public Subgraph {
       IAllocatorUniquePtr<char>& buffer,
       Stream* ort_stream,
       int past_present_share_buffer_max_seq_len = -1,
-      bool need_cache_indir = false);
+      bool need_cache_indir = false,
+      const PagedKVCache* paged_kv_cache = nullptr);
 
   Status Validate(const std::vector<const NodeArg*>& subgraph_inputs,
                   const std::vector<const NodeArg*>& subgraph_outputs) override;
@@ -19,6 +19,7 @@ namespace contrib {
 namespace cuda {
 
 constexpr int kPastSequenceLengthInputIndex = 6;
+constexpr int kPageTableInputIndex = 7;
 constexpr int kPastInputIndex = 4;
 constexpr int kPresentOutputIndex = 1;
 
@@ -82,6 +83,10 @@ Status Attention<T>::ComputeInternal(OpKernelContext* context) const {
   const Tensor* relative_position_bias = context->Input<Tensor>(5);
   const Tensor* past_seq_len = context->Input<Tensor>(kPastSequenceLengthInputIndex);
 
+  if (context->Input<Tensor>(kPageTableInputIndex) != nullptr) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "Paged past state is only supported by the CPU Attention");
+  }
+
   auto& device_prop = GetDeviceProp();
   AttentionParameters parameters;
   // Use the second dimension from weight for bias to get q_hidden_size when bias is nullptr
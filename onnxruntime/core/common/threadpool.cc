@@ -420,7 +420,7 @@ void ThreadPool::ParallelForFixedBlockSizeScheduling(const std::ptrdiff_t total,
     // Split the work across threads in the pool.  Each work item will run a loop claiming iterations,
     // hence we need at most one for each thread, even if the number of blocks of iterations is larger.
     auto num_blocks = total / block_size;
-    auto num_threads_inc_main = NumThreads() + 1;
+    auto num_threads_inc_main = ThreadBudgetForCaller();
     int num_work_items = static_cast<int>(std::min(static_cast<std::ptrdiff_t>(num_threads_inc_main), num_blocks));
     assert(num_work_items > 0);
 
@@ -459,7 +459,7 @@ void ThreadPool::ParallelForFixedBlockSizeScheduling(const std::ptrdiff_t total,
     };
     // Distribute task among all threads in the pool, reduce number of work items if
     // num_of_blocks is smaller than number of threads.
-    RunInParallel(run_work, std::min(NumThreads() + 1, num_of_blocks), base_block_size);
+    RunInParallel(run_work, std::min(ThreadBudgetForCaller(), num_of_blocks), base_block_size);
   }
 }
 
@@ -515,6 +515,57 @@ ThreadPool::ParallelSection::~ParallelSection() {
   }
 }
 
+namespace {
+// Thread budget of the request running on the current thread, as set by ThreadPool::ThreadBudgetScope.
+// A budget of 0 requests a fair share of the pool.
+thread_local const ThreadPool* current_budget_tp = nullptr;
+thread_local int current_thread_budget = 0;
+}  // namespace
+
+ThreadPool::ThreadBudgetScope::ThreadBudgetScope(ThreadPool* tp, int thread_budget)
+    : tp_(tp), thread_budget_(thread_budget), prev_tp_(current_budget_tp), prev_thread_budget_(current_thread_budget) {
+  ORT_ENFORCE(thread_budget >= 0, "Thread budget must be non-negative: ", thread_budget);
+  if (tp_) {
+    if (thread_budget_ > 0) {
+      tp_->reserved_threads_.fetch_add(thread_budget_, std::memory_order_relaxed);
+    } else {
+      tp_->fair_share_requests_.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+  current_budget_tp = tp_;
+  current_thread_budget = thread_budget_;
+}
+
+ThreadPool::ThreadBudgetScope::~ThreadBudgetScope() {
+  if (tp_) {
+    if (thread_budget_ > 0) {
+      tp_->reserved_threads_.fetch_sub(thread_budget_, std::memory_order_relaxed);
+    } else {
+      tp_->fair_share_requests_.fetch_sub(1, std::memory_order_relaxed);
+    }
+  }
+  current_budget_tp = prev_tp_;
+  current_thread_budget = prev_thread_budget_;
+}
+
+int ThreadPool::ThreadBudgetForCaller() const {
+  const int num_threads_inc_main = NumThreads() + 1;
+  if (current_budget_tp != this || CurrentThreadId() != -1) {
+    return num_threads_inc_main;
+  }
+
+  if (current_thread_budget > 0) {
+    return std::min(current_thread_budget, num_threads_inc_main);
+  }
+
+  // Split the threads not reserved by explicit budgets evenly between the requests
+  // using a fair share.  Every request keeps at least its own thread.
+  const int fair_share_requests = std::max(1, fair_share_requests_.load(std::memory_order_relaxed));
+  const int reserved_threads = reserved_threads_.load(std::memory_order_relaxed);
+  const int available_threads = std::max(num_threads_inc_main - reserved_threads, fair_share_requests);
+  return std::max(1, available_threads / fair_share_requests);
+}
+
 void ThreadPool::RunInParallel(std::function<void(unsigned idx)> fn, unsigned n, std::ptrdiff_t block_size) {
   if (underlying_threadpool_) {
     if (current_parallel_section.has_value()) {
@@ -546,6 +597,12 @@ bool ThreadPool::ShouldParallelizeLoop(const std::ptrdiff_t num_iterations,
     return false;
   }
 
+  // Do not parallelize loops if the thread budget of the calling request
+  // leaves it with only its own thread.
+  if (ThreadBudgetForCaller() == 1) {
+    return false;
+  }
+
   return true;
 }
 
@@ -637,12 +694,13 @@ bool ThreadPool::ShouldParallelize(const concurrency::ThreadPool* tp) {
 
 int ThreadPool::DegreeOfParallelism(const concurrency::ThreadPool* tp) {
   // When not using OpenMP, we parallelise over the N threads created by the pool
-  // tp, plus 1 for the thread entering a loop.
+  // tp, plus 1 for the thread entering a loop, limited by the thread budget of
+  // the calling request.
   if (tp) {
     if (tp->force_hybrid_ || CPUIDInfo::GetCPUIDInfo().IsHybrid()) {
-      return ((tp->NumThreads() + 1)) * TaskGranularityFactor;
+      return tp->ThreadBudgetForCaller() * TaskGranularityFactor;
     } else {
-      return ((tp->NumThreads() + 1));
+      return tp->ThreadBudgetForCaller();
     }
   } else {
     return 1;
@@ -0,0 +1,27 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <cstddef>
+
+namespace onnxruntime {
+namespace utf8_util {
+
+// Simple (one to one) case mappings of the Unicode Character Database. They don't depend on any locale, so
+// characters whose case changes into several characters, such as the german eszett, are left as they are.
+char32_t to_upper(char32_t code_point);
+char32_t to_lower(char32_t code_point);
+
+// A case change at most turns a 2 byte character into a 3 byte one.
+inline size_t utf8_change_case_bound(size_t len) {
+  return len + len / 2;
+}
+
+// Writes `s` with all of its characters changed to upper or lower case to `out`, which must have room for
+// utf8_change_case_bound(len) bytes, and sets `out_len` to the number of bytes written.
+// Returns false if `s` is not well formed utf8.
+bool utf8_change_case(const unsigned char* s, size_t len, bool upper, unsigned char* out, size_t& out_len);
+
+}  // namespace utf8_util
+}  // namespace onnxruntime
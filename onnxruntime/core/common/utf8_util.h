@@ -3,6 +3,9 @@
 
 #pragma once
 
+#include <cstdint>
+#include <cstring>
+
 #include "core/common/common.h"
 
 namespace onnxruntime {
@@ -31,10 +34,33 @@ inline bool utf8_bytes(unsigned char ch, size_t& len) {
   return false;
 }
 
+// Returns the number of leading ASCII bytes of `s`, looking at 8 bytes at a time
+inline size_t utf8_ascii_prefix(const unsigned char* s, size_t len) {
+  size_t idx = 0;
+  for (; idx + 8 <= len; idx += 8) {
+    uint64_t word;
+    memcpy(&word, s + idx, sizeof(word));
+    if ((word & 0x8080808080808080ULL) != 0) {
+      break;
+    }
+  }
+  while (idx < len && s[idx] < 0x80u) {
+    ++idx;
+  }
+  return idx;
+}
+
 // Computes length of the utf8 string in characters
 inline bool utf8_len(const unsigned char* s, size_t bytes, size_t& len) {
   size_t result = 0;
   while (bytes > 0) {
+    if (*s < 0x80u) {
+      const size_t ascii = utf8_ascii_prefix(s, bytes);
+      result += ascii;
+      s += ascii;
+      bytes -= ascii;
+      continue;
+    }
     size_t char_bytes = 0;
     bool valid = utf8_bytes(*s, char_bytes);
     if (!valid || bytes < char_bytes) {
@@ -52,6 +78,12 @@ inline bool utf8_validate(const unsigned char* s, size_t len, size_t& utf8_chars
   size_t utf8_len = 0;
   size_t idx = 0;
   while (idx < len) {
+    if (s[idx] < 0x80u) {
+      const size_t ascii = utf8_ascii_prefix(s + idx, len - idx);
+      idx += ascii;
+      utf8_len += ascii;
+      continue;
+    }
     size_t bytes = 0;
     auto ch = s[idx];
     if (utf8_bytes(ch, bytes)) {
@@ -142,5 +174,70 @@ inline bool utf8_validate(const unsigned char* s, size_t len, size_t& utf8_chars
   return true;
 }
 
+// Decodes the character at the start of `s`. Returns its length in bytes, or 0 if `s` does not start with
+// a well formed utf8 sequence: truncated, overlong, a surrogate or above U+10FFFF.
+inline size_t utf8_decode(const unsigned char* s, size_t len, char32_t& code_point) {
+  const unsigned char ch = s[0];
+  if (ch < 0x80u) {
+    code_point = ch;
+    return 1;
+  }
+  size_t bytes = 0;
+  char32_t min_code_point = 0;
+  if (ch >= 0xC2u && ch <= 0xDFu) {
+    bytes = 2;
+    code_point = ch & 0x1Fu;
+    min_code_point = 0x80;
+  } else if ((ch & 0xF0u) == 0xE0u) {
+    bytes = 3;
+    code_point = ch & 0x0Fu;
+    min_code_point = 0x800;
+  } else if (ch >= 0xF0u && ch <= 0xF4u) {
+    bytes = 4;
+    code_point = ch & 0x07u;
+    min_code_point = 0x10000;
+  } else {
+    return 0;
+  }
+  if (len < bytes) {
+    return 0;
+  }
+  for (size_t i = 1; i < bytes; ++i) {
+    if ((s[i] & 0xC0u) != 0x80u) {
+      return 0;
+    }
+    code_point = (code_point << 6) | (s[i] & 0x3Fu);
+  }
+  if (code_point < min_code_point || code_point > 0x10FFFF || (code_point >= 0xD800 && code_point <= 0xDFFF)) {
+    return 0;
+  }
+  return bytes;
+}
+
+// Writes the utf8 encoding of a valid code point to `out`, which must have room for 4 bytes.
+// Returns the number of bytes written.
+inline size_t utf8_encode(char32_t code_point, unsigned char* out) {
+  if (code_point < 0x80) {
+    out[0] = static_cast<unsigned char>(code_point);
+    return 1;
+  }
+  if (code_point < 0x800) {
+    out[0] = static_cast<unsigned char>(0xC0u | (code_point >> 6));
+    out[1] = static_cast<unsigned char>(0x80u | (code_point & 0x3Fu));
+    return 2;
+  }
+  if (code_point < 0x10000) {
+    out[0] = static_cast<unsigned char>(0xE0u | (code_point >> 12));
+    out[1] = static_cast<unsigned char>(0x80u | ((code_point >> 6) & 0x3Fu));
+    out[2] = static_cast<unsigned char>(0x80u | (code_point & 0x3Fu));
+    return 3;
+  }
+  out[0] = static_cast<unsigned char>(0xF0u | (code_point >> 18));
+  out[1] = static_cast<unsigned char>(0x80u | ((code_point >> 12) & 0x3Fu));
+  out[2] = static_cast<unsigned char>(0x80u | ((code_point >> 6) & 0x3Fu));
+  out[3] = static_cast<unsigned char>(0x80u | (code_point & 0x3Fu));
+  return 4;
+}
+
 }  // namespace utf8_util
 }  // namespace onnxruntime
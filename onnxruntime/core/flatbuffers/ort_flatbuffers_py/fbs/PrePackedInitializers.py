@@ -0,0 +1,71 @@
+# automatically generated by the FlatBuffers compiler, do not modify
+
+# namespace: fbs
+
+import flatbuffers
+from flatbuffers.compat import import_numpy
+np = import_numpy()
+
+class PrePackedInitializers(object):
+    __slots__ = ['_tab']
+
+    @classmethod
+    def GetRootAsPrePackedInitializers(cls, buf, offset):
+        n = flatbuffers.encode.Get(flatbuffers.packer.uoffset, buf, offset)
+        x = PrePackedInitializers()
+        x.Init(buf, n + offset)
+        return x
+
+    @classmethod
+    def PrePackedInitializersBufferHasIdentifier(cls, buf, offset, size_prefixed=False):
+        return flatbuffers.util.BufferHasIdentifier(buf, offset, b"\x4F\x52\x54\x4D", size_prefixed=size_prefixed)
+
+    # PrePackedInitializers
+    def Init(self, buf, pos):
+        self._tab = flatbuffers.table.Table(buf, pos)
+
+    # PrePackedInitializers
+    def PackedBufferFormatVersion(self):
+        o = flatbuffers.number_types.UOffsetTFlags.py_type(self._tab.Offset(4))
+        if o != 0:
+            return self._tab.Get(flatbuffers.number_types.Uint32Flags, o + self._tab.Pos)
+        return 0
+
+    # PrePackedInitializers
+    def Isa(self):
+        o = flatbuffers.number_types.UOffsetTFlags.py_type(self._tab.Offset(6))
+        if o != 0:
+            return self._tab.String(o + self._tab.Pos)
+        return None
+
+    # PrePackedInitializers
+    def Initializers(self, j):
+        o = flatbuffers.number_types.UOffsetTFlags.py_type(self._tab.Offset(8))
+        if o != 0:
+            x = self._tab.Vector(o)
+            x += flatbuffers.number_types.UOffsetTFlags.py_type(j) * 4
+            x = self._tab.Indirect(x)
+            from ort_flatbuffers_py.fbs.PrePackedInitializer import PrePackedInitializer
+            obj = PrePackedInitializer()
+            obj.Init(self._tab.Bytes, x)
+            return obj
+        return None
+
+    # PrePackedInitializers
+    def InitializersLength(self):
+        o = flatbuffers.number_types.UOffsetTFlags.py_type(self._tab.Offset(8))
+        if o != 0:
+            return self._tab.VectorLen(o)
+        return 0
+
+    # PrePackedInitializers
+    def InitializersIsNone(self):
+        o = flatbuffers.number_types.UOffsetTFlags.py_type(self._tab.Offset(8))
+        return o == 0
+
+def PrePackedInitializersStart(builder): builder.StartObject(3)
+def PrePackedInitializersAddPackedBufferFormatVersion(builder, packedBufferFormatVersion): builder.PrependUint32Slot(0, packedBufferFormatVersion, 0)
+def PrePackedInitializersAddIsa(builder, isa): builder.PrependUOffsetTRelativeSlot(1, flatbuffers.number_types.UOffsetTFlags.py_type(isa), 0)
+def PrePackedInitializersAddInitializers(builder, initializers): builder.PrependUOffsetTRelativeSlot(2, flatbuffers.number_types.UOffsetTFlags.py_type(initializers), 0)
+def PrePackedInitializersStartInitializersVector(builder, numElems): return builder.StartVector(4, numElems, 4)
+def PrePackedInitializersEnd(builder): return builder.EndObject()
@@ -98,6 +98,15 @@ struct OpIdKernelTypeStrArgsEntryBuilder;
 struct KernelTypeStrResolver;
 struct KernelTypeStrResolverBuilder;
 
+struct PrePackedBuffer;
+struct PrePackedBufferBuilder;
+
+struct PrePackedInitializer;
+struct PrePackedInitializerBuilder;
+
+struct PrePackedInitializers;
+struct PrePackedInitializersBuilder;
+
 struct InferenceSession;
 struct InferenceSessionBuilder;
 
@@ -2979,12 +2988,227 @@ inline flatbuffers::Offset<KernelTypeStrResolver> CreateKernelTypeStrResolverDir
       op_kernel_type_str_args__);
 }
 
+/// a buffer produced by the PrePack() method of a kernel
+struct PrePackedBuffer FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
+  typedef PrePackedBufferBuilder Builder;
+  enum FlatBuffersVTableOffset FLATBUFFERS_VTABLE_UNDERLYING_TYPE {
+    VT_DATA = 4
+  };
+  const flatbuffers::Vector<uint8_t> *data() const {
+    return GetPointer<const flatbuffers::Vector<uint8_t> *>(VT_DATA);
+  }
+  bool Verify(flatbuffers::Verifier &verifier) const {
+    return VerifyTableStart(verifier) &&
+           VerifyOffset(verifier, VT_DATA) &&
+           verifier.VerifyVector(data()) &&
+           verifier.EndTable();
+  }
+};
+
+struct PrePackedBufferBuilder {
+  typedef PrePackedBuffer Table;
+  flatbuffers::FlatBufferBuilder &fbb_;
+  flatbuffers::uoffset_t start_;
+  void add_data(flatbuffers::Offset<flatbuffers::Vector<uint8_t>> data) {
+    fbb_.AddOffset(PrePackedBuffer::VT_DATA, data);
+  }
+  explicit PrePackedBufferBuilder(flatbuffers::FlatBufferBuilder &_fbb)
+        : fbb_(_fbb) {
+    start_ = fbb_.StartTable();
+  }
+  PrePackedBufferBuilder &operator=(const PrePackedBufferBuilder &);
+  flatbuffers::Offset<PrePackedBuffer> Finish() {
+    const auto end = fbb_.EndTable(start_);
+    auto o = flatbuffers::Offset<PrePackedBuffer>(end);
+    return o;
+  }
+};
+
+inline flatbuffers::Offset<PrePackedBuffer> CreatePrePackedBuffer(
+    flatbuffers::FlatBufferBuilder &_fbb,
+    flatbuffers::Offset<flatbuffers::Vector<uint8_t>> data = 0) {
+  PrePackedBufferBuilder builder_(_fbb);
+  builder_.add_data(data);
+  return builder_.Finish();
+}
+
+inline flatbuffers::Offset<PrePackedBuffer> CreatePrePackedBufferDirect(
+    flatbuffers::FlatBufferBuilder &_fbb,
+    const std::vector<uint8_t> *data = nullptr) {
+  auto data__ = data ? _fbb.CreateVector<uint8_t>(*data) : 0;
+  return onnxruntime::fbs::CreatePrePackedBuffer(
+      _fbb,
+      data__);
+}
+
+/// the pre-packed buffers a kernel produced for one of its constant initializer inputs
+struct PrePackedInitializer FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
+  typedef PrePackedInitializerBuilder Builder;
+  enum FlatBuffersVTableOffset FLATBUFFERS_VTABLE_UNDERLYING_TYPE {
+    VT_NODE_INDEX = 4,
+    VT_INPUT_INDEX = 6,
+    VT_BUFFERS = 8
+  };
+  uint32_t node_index() const {
+    return GetField<uint32_t>(VT_NODE_INDEX, 0);
+  }
+  uint32_t input_index() const {
+    return GetField<uint32_t>(VT_INPUT_INDEX, 0);
+  }
+  const flatbuffers::Vector<flatbuffers::Offset<onnxruntime::fbs::PrePackedBuffer>> *buffers() const {
+    return GetPointer<const flatbuffers::Vector<flatbuffers::Offset<onnxruntime::fbs::PrePackedBuffer>> *>(VT_BUFFERS);
+  }
+  bool Verify(flatbuffers::Verifier &verifier) const {
+    return VerifyTableStart(verifier) &&
+           VerifyField<uint32_t>(verifier, VT_NODE_INDEX) &&
+           VerifyField<uint32_t>(verifier, VT_INPUT_INDEX) &&
+           VerifyOffset(verifier, VT_BUFFERS) &&
+           verifier.VerifyVector(buffers()) &&
+           verifier.VerifyVectorOfTables(buffers()) &&
+           verifier.EndTable();
+  }
+};
+
+struct PrePackedInitializerBuilder {
+  typedef PrePackedInitializer Table;
+  flatbuffers::FlatBufferBuilder &fbb_;
+  flatbuffers::uoffset_t start_;
+  void add_node_index(uint32_t node_index) {
+    fbb_.AddElement<uint32_t>(PrePackedInitializer::VT_NODE_INDEX, node_index, 0);
+  }
+  void add_input_index(uint32_t input_index) {
+    fbb_.AddElement<uint32_t>(PrePackedInitializer::VT_INPUT_INDEX, input_index, 0);
+  }
+  void add_buffers(flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<onnxruntime::fbs::PrePackedBuffer>>> buffers) {
+    fbb_.AddOffset(PrePackedInitializer::VT_BUFFERS, buffers);
+  }
+  explicit PrePackedInitializerBuilder(flatbuffers::FlatBufferBuilder &_fbb)
+        : fbb_(_fbb) {
+    start_ = fbb_.StartTable();
+  }
+  PrePackedInitializerBuilder &operator=(const PrePackedInitializerBuilder &);
+  flatbuffers::Offset<PrePackedInitializer> Finish() {
+    const auto end = fbb_.EndTable(start_);
+    auto o = flatbuffers::Offset<PrePackedInitializer>(end);
+    return o;
+  }
+};
+
+inline flatbuffers::Offset<PrePackedInitializer> CreatePrePackedInitializer(
+    flatbuffers::FlatBufferBuilder &_fbb,
+    uint32_t node_index = 0,
+    uint32_t input_index = 0,
+    flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<onnxruntime::fbs::PrePackedBuffer>>> buffers = 0) {
+  PrePackedInitializerBuilder builder_(_fbb);
+  builder_.add_buffers(buffers);
+  builder_.add_input_index(input_index);
+  builder_.add_node_index(node_index);
+  return builder_.Finish();
+}
+
+inline flatbuffers::Offset<PrePackedInitializer> CreatePrePackedInitializerDirect(
+    flatbuffers::FlatBufferBuilder &_fbb,
+    uint32_t node_index = 0,
+    uint32_t input_index = 0,
+    const std::vector<flatbuffers::Offset<onnxruntime::fbs::PrePackedBuffer>> *buffers = nullptr) {
+  auto buffers__ = buffers ? _fbb.CreateVector<flatbuffers::Offset<onnxruntime::fbs::PrePackedBuffer>>(*buffers) : 0;
+  return onnxruntime::fbs::CreatePrePackedInitializer(
+      _fbb,
+      node_index,
+      input_index,
+      buffers__);
+}
+
+/// pre-packed weights of the kernels in the main graph
+/// they are only valid for the packed buffer format version and instruction set they were packed for
+struct PrePackedInitializers FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
+  typedef PrePackedInitializersBuilder Builder;
+  enum FlatBuffersVTableOffset FLATBUFFERS_VTABLE_UNDERLYING_TYPE {
+    VT_PACKED_BUFFER_FORMAT_VERSION = 4,
+    VT_ISA = 6,
+    VT_INITIALIZERS = 8
+  };
+  /// MLAS_PACKED_BUFFER_FORMAT_VERSION of the build that packed the buffers
+  uint32_t packed_buffer_format_version() const {
+    return GetField<uint32_t>(VT_PACKED_BUFFER_FORMAT_VERSION, 0);
+  }
+  /// the instruction set the buffers were packed for, see MlasGetPackedBufferIsa()
+  const flatbuffers::String *isa() const {
+    return GetPointer<const flatbuffers::String *>(VT_ISA);
+  }
+  const flatbuffers::Vector<flatbuffers::Offset<onnxruntime::fbs::PrePackedInitializer>> *initializers() const {
+    return GetPointer<const flatbuffers::Vector<flatbuffers::Offset<onnxruntime::fbs::PrePackedInitializer>> *>(VT_INITIALIZERS);
+  }
+  bool Verify(flatbuffers::Verifier &verifier) const {
+    return VerifyTableStart(verifier) &&
+           VerifyField<uint32_t>(verifier, VT_PACKED_BUFFER_FORMAT_VERSION) &&
+           VerifyOffset(verifier, VT_ISA) &&
+           verifier.VerifyString(isa()) &&
+           VerifyOffset(verifier, VT_INITIALIZERS) &&
+           verifier.VerifyVector(initializers()) &&
+           verifier.VerifyVectorOfTables(initializers()) &&
+           verifier.EndTable();
+  }
+};
+
+struct PrePackedInitializersBuilder {
+  typedef PrePackedInitializers Table;
+  flatbuffers::FlatBufferBuilder &fbb_;
+  flatbuffers::uoffset_t start_;
+  void add_packed_buffer_format_version(uint32_t packed_buffer_format_version) {
+    fbb_.AddElement<uint32_t>(PrePackedInitializers::VT_PACKED_BUFFER_FORMAT_VERSION, packed_buffer_format_version, 0);
+  }
+  void add_isa(flatbuffers::Offset<flatbuffers::String> isa) {
+    fbb_.AddOffset(PrePackedInitializers::VT_ISA, isa);
+  }
+  void add_initializers(flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<onnxruntime::fbs::PrePackedInitializer>>> initializers) {
+    fbb_.AddOffset(PrePackedInitializers::VT_INITIALIZERS, initializers);
+  }
+  explicit PrePackedInitializersBuilder(flatbuffers::FlatBufferBuilder &_fbb)
+        : fbb_(_fbb) {
+    start_ = fbb_.StartTable();
+  }
+  PrePackedInitializersBuilder &operator=(const PrePackedInitializersBuilder &);
+  flatbuffers::Offset<PrePackedInitializers> Finish() {
+    const auto end = fbb_.EndTable(start_);
+    auto o = flatbuffers::Offset<PrePackedInitializers>(end);
+    return o;
+  }
+};
+
+inline flatbuffers::Offset<PrePackedInitializers> CreatePrePackedInitializers(
+    flatbuffers::FlatBufferBuilder &_fbb,
+    uint32_t packed_buffer_format_version = 0,
+    flatbuffers::Offset<flatbuffers::String> isa = 0,
+    flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<onnxruntime::fbs::PrePackedInitializer>>> initializers = 0) {
+  PrePackedInitializersBuilder builder_(_fbb);
+  builder_.add_initializers(initializers);
+  builder_.add_isa(isa);
+  builder_.add_packed_buffer_format_version(packed_buffer_format_version);
+  return builder_.Finish();
+}
+
+inline flatbuffers::Offset<PrePackedInitializers> CreatePrePackedInitializersDirect(
+    flatbuffers::FlatBufferBuilder &_fbb,
+    uint32_t packed_buffer_format_version = 0,
+    const char *isa = nullptr,
+    const std::vector<flatbuffers::Offset<onnxruntime::fbs::PrePackedInitializer>> *initializers = nullptr) {
+  auto isa__ = isa ? _fbb.CreateString(isa) : 0;
+  auto initializers__ = initializers ? _fbb.CreateVector<flatbuffers::Offset<onnxruntime::fbs::PrePackedInitializer>>(*initializers) : 0;
+  return onnxruntime::fbs::CreatePrePackedInitializers(
+      _fbb,
+      packed_buffer_format_version,
+      isa__,
+      initializers__);
+}
+
 struct InferenceSession FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
   typedef InferenceSessionBuilder Builder;
   enum FlatBuffersVTableOffset FLATBUFFERS_VTABLE_UNDERLYING_TYPE {
     VT_ORT_VERSION = 4,
     VT_MODEL = 6,
-    VT_KERNEL_TYPE_STR_RESOLVER = 10
+    VT_KERNEL_TYPE_STR_RESOLVER = 10,
+    VT_PREPACKED_INITIALIZERS = 12
   };
   const flatbuffers::String *ort_version() const {
     return GetPointer<const flatbuffers::String *>(VT_ORT_VERSION);
@@ -2995,6 +3219,9 @@ struct InferenceSession FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
   const onnxruntime::fbs::KernelTypeStrResolver *kernel_type_str_resolver() const {
     return GetPointer<const onnxruntime::fbs::KernelTypeStrResolver *>(VT_KERNEL_TYPE_STR_RESOLVER);
   }
+  const onnxruntime::fbs::PrePackedInitializers *prepacked_initializers() const {
+    return GetPointer<const onnxruntime::fbs::PrePackedInitializers *>(VT_PREPACKED_INITIALIZERS);
+  }
   bool Verify(flatbuffers::Verifier &verifier) const {
     return VerifyTableStart(verifier) &&
            VerifyOffset(verifier, VT_ORT_VERSION) &&
@@ -3003,6 +3230,8 @@ struct InferenceSession FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
            verifier.VerifyTable(model()) &&
            VerifyOffset(verifier, VT_KERNEL_TYPE_STR_RESOLVER) &&
            verifier.VerifyTable(kernel_type_str_resolver()) &&
+           VerifyOffset(verifier, VT_PREPACKED_INITIALIZERS) &&
+           verifier.VerifyTable(prepacked_initializers()) &&
            verifier.EndTable();
   }
 };
@@ -3020,6 +3249,9 @@ struct InferenceSessionBuilder {
   void add_kernel_type_str_resolver(flatbuffers::Offset<onnxruntime::fbs::KernelTypeStrResolver> kernel_type_str_resolver) {
     fbb_.AddOffset(InferenceSession::VT_KERNEL_TYPE_STR_RESOLVER, kernel_type_str_resolver);
   }
+  void add_prepacked_initializers(flatbuffers::Offset<onnxruntime::fbs::PrePackedInitializers> prepacked_initializers) {
+    fbb_.AddOffset(InferenceSession::VT_PREPACKED_INITIALIZERS, prepacked_initializers);
+  }
   explicit InferenceSessionBuilder(flatbuffers::FlatBufferBuilder &_fbb)
         : fbb_(_fbb) {
     start_ = fbb_.StartTable();
@@ -3036,8 +3268,10 @@ inline flatbuffers::Offset<InferenceSession> CreateInferenceSession(
     flatbuffers::FlatBufferBuilder &_fbb,
     flatbuffers::Offset<flatbuffers::String> ort_version = 0,
     flatbuffers::Offset<onnxruntime::fbs::Model> model = 0,
-    flatbuffers::Offset<onnxruntime::fbs::KernelTypeStrResolver> kernel_type_str_resolver = 0) {
+    flatbuffers::Offset<onnxruntime::fbs::KernelTypeStrResolver> kernel_type_str_resolver = 0,
+    flatbuffers::Offset<onnxruntime::fbs::PrePackedInitializers> prepacked_initializers = 0) {
   InferenceSessionBuilder builder_(_fbb);
+  builder_.add_prepacked_initializers(prepacked_initializers);
   builder_.add_kernel_type_str_resolver(kernel_type_str_resolver);
   builder_.add_model(model);
   builder_.add_ort_version(ort_version);
@@ -3048,13 +3282,15 @@ inline flatbuffers::Offset<InferenceSession> CreateInferenceSessionDirect(
     flatbuffers::FlatBufferBuilder &_fbb,
     const char *ort_version = nullptr,
     flatbuffers::Offset<onnxruntime::fbs::Model> model = 0,
-    flatbuffers::Offset<onnxruntime::fbs::KernelTypeStrResolver> kernel_type_str_resolver = 0) {
+    flatbuffers::Offset<onnxruntime::fbs::KernelTypeStrResolver> kernel_type_str_resolver = 0,
+    flatbuffers::Offset<onnxruntime::fbs::PrePackedInitializers> prepacked_initializers = 0) {
   auto ort_version__ = ort_version ? _fbb.CreateString(ort_version) : 0;
   return onnxruntime::fbs::CreateInferenceSession(
       _fbb,
       ort_version__,
       model,
-      kernel_type_str_resolver);
+      kernel_type_str_resolver,
+      prepacked_initializers);
 }
 
 inline bool VerifyTypeInfoValue(flatbuffers::Verifier &verifier, const void *obj, TypeInfoValue type) {
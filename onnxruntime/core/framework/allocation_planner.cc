@@ -1697,7 +1697,8 @@ class PlannerImpl {
             break;
           }
         }
-        if (is_all_consumer_same_stream) {
+        // with the work-stealing schedule the nodes of the stream don't run in order, so always use ref counting.
+        if (is_all_consumer_same_stream && !plan_.HasWorkStealingSchedule()) {
           // all the consumers are on the same stream, so the first element is the last consumer int the stream.
           process_consumer(release_action_idx, value_consumers[i][0]);
         } else {
@@ -1711,6 +1712,74 @@ class PlannerImpl {
     return Status::OK();
   }
 
+  // For parallel execution of a plan with a single CPU stream, count the dependencies between the nodes so the
+  // executor can dispatch each node as soon as its producers completed instead of running the stream in order.
+  Status BuildWorkStealingSchedule() {
+    if (!context_->IsParallelExecutionEnabled() || num_logic_streams_ != 1 ||
+        plan_.execution_plan.size() != 1 || plan_.execution_plan[0] == nullptr ||
+        plan_.execution_plan[0]->device_.Type() != OrtDevice::CPU) {
+      return Status::OK();
+    }
+
+    const auto& nodes = stream_nodes_[0];
+    const size_t num_node_indices = SafeInt<size_t>(graph_viewer_.MaxNodeIndex()) + 1;
+    InlinedHashSet<NodeIndex> nodes_in_stream(nodes.begin(), nodes.end());
+
+    plan_.node_num_producers.assign(num_node_indices, 0);
+    plan_.node_consumers.assign(num_node_indices, {});
+
+    // producer of each value output by a node of the stream
+    InlinedHashMap<std::string_view, NodeIndex> value_producers;
+    for (auto node_index : nodes) {
+      for (const auto* output : graph_viewer_.GetNode(node_index)->OutputDefs()) {
+        if (output->Exists()) {
+          value_producers.insert({output->Name(), node_index});
+        }
+      }
+    }
+
+    InlinedHashSet<NodeIndex> producers;
+    for (auto node_index : nodes) {
+      const auto* node = graph_viewer_.GetNode(node_index);
+      producers.clear();
+
+      auto add_producer = [&](NodeIndex producer_index) {
+        if (producer_index != node_index && nodes_in_stream.count(producer_index) > 0) {
+          producers.insert(producer_index);
+        }
+      };
+
+      // data and control edges
+      for (auto it = node->InputEdgesBegin(), end = node->InputEdgesEnd(); it != end; ++it) {
+        add_producer(it->GetNode().Index());
+      }
+
+      // explicit and implicit inputs, in case an edge is missing
+      auto process_input = [&](const NodeArg& input, size_t /*arg_idx*/) {
+        if (input.Exists()) {
+          auto producer = value_producers.find(input.Name());
+          if (producer != value_producers.end()) {
+            add_producer(producer->second);
+          }
+        }
+        return Status::OK();
+      };
+      ORT_RETURN_IF_ERROR(Node::ForEachWithIndex(node->InputDefs(), process_input));
+      ORT_RETURN_IF_ERROR(Node::ForEachWithIndex(node->ImplicitInputDefs(), process_input));
+
+      plan_.node_num_producers[node_index] = static_cast<int>(producers.size());
+      for (auto producer_index : producers) {
+        plan_.node_consumers[producer_index].push_back(node_index);
+      }
+
+      if (producers.empty()) {
+        plan_.entry_nodes.push_back(node_index);
+      }
+    }
+
+    return Status::OK();
+  }
+
 #ifndef ORT_ENABLE_STREAM
   void PartitionIntoStreams(const logging::Logger& /*logger*/,
                             const ExecutionProviders& /*execution_providers*/,
@@ -2150,6 +2219,9 @@ Status PlannerImpl::CreatePlan(
   ORT_RETURN_IF_ERROR(ComputeAllocationOrder());
 #endif
 
+  // count the node dependencies for parallel execution
+  ORT_RETURN_IF_ERROR(BuildWorkStealingSchedule());
+
   // convert information in the freelist_ into a deallocation plan in required format
   ORT_RETURN_IF_ERROR(GenerateDeallocationPlan());
 
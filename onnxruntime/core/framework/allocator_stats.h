@@ -22,6 +22,9 @@ struct AllocatorStats {
                                   // is known. Certain allocator may return 0 to indicate the limit is
                                   // unknown.
   int64_t bytes_limit;
+  int64_t num_thread_cache_hits;    // Allocations served by a per-thread cache (Relevant only for arena based allocators)
+  int64_t num_thread_cache_misses;  // Cacheable allocations that had to go to the shared arena bins.
+  int64_t bytes_in_thread_caches;   // Bytes of freed chunks currently held by the per-thread caches.
 
   AllocatorStats() { Clear(); }
 
@@ -35,6 +38,9 @@ struct AllocatorStats {
     this->max_alloc_size = 0;
     this->bytes_limit = 0;
     this->total_allocated_bytes = 0;
+    this->num_thread_cache_hits = 0;
+    this->num_thread_cache_misses = 0;
+    this->bytes_in_thread_caches = 0;
   }
 
   std::string DebugString() const {
@@ -47,7 +53,10 @@ struct AllocatorStats {
        << "NumReserves:              " << this->num_reserves << "\n"
        << "NumArenaExtensions:       " << this->num_arena_extensions << "\n"
        << "NumArenaShrinkages:       " << this->num_arena_shrinkages << "\n"
-       << "MaxAllocSize:             " << this->max_alloc_size << "\n";
+       << "MaxAllocSize:             " << this->max_alloc_size << "\n"
+       << "NumThreadCacheHits:       " << this->num_thread_cache_hits << "\n"
+       << "NumThreadCacheMisses:     " << this->num_thread_cache_misses << "\n"
+       << "BytesInThreadCaches:      " << this->bytes_in_thread_caches << "\n";
     return ss.str();
   }
 };
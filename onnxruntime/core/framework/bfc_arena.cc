@@ -3,16 +3,20 @@
 
 #include "core/framework/allocator.h"
 #include "core/framework/bfc_arena.h"
+#include <algorithm>
 #include <type_traits>
 
 namespace onnxruntime {
+std::atomic<uint64_t> BFCArena::next_arena_id_{1};
+
 BFCArena::BFCArena(std::unique_ptr<IAllocator> resource_allocator,
                    size_t total_memory,
                    ArenaExtendStrategy arena_extend_strategy,
                    int initial_chunk_size_bytes,
                    int max_dead_bytes_per_chunk,
                    int initial_growth_chunk_size_bytes,
-                   int64_t max_power_of_two_extend_bytes)
+                   int64_t max_power_of_two_extend_bytes,
+                   int64_t thread_cache_max_bytes)
     : IAllocator(OrtMemoryInfo(resource_allocator->Info().name,
                                OrtAllocatorType::OrtArenaAllocator,
                                resource_allocator->Info().device,
@@ -25,12 +29,20 @@ BFCArena::BFCArena(std::unique_ptr<IAllocator> resource_allocator,
       initial_chunk_size_bytes_(initial_chunk_size_bytes),
       max_dead_bytes_per_chunk_(max_dead_bytes_per_chunk),
       initial_growth_chunk_size_bytes_(initial_growth_chunk_size_bytes),
-      max_power_of_two_extend_bytes_(max_power_of_two_extend_bytes) {
+      max_power_of_two_extend_bytes_(max_power_of_two_extend_bytes),
+      thread_cache_max_bytes_(thread_cache_max_bytes),
+      arena_id_(next_arena_id_++) {
+  if (thread_cache_max_bytes_ > 0) {
+    thread_cache_owner_ = std::make_shared<ThreadCacheOwner>();
+    thread_cache_owner_->arena = this;
+  }
+
   LOGS_DEFAULT(INFO) << "Creating BFCArena for " << device_allocator_->Info().name
                      << " with following configs: initial_chunk_size_bytes: " << initial_chunk_size_bytes_
                      << " max_dead_bytes_per_chunk: " << max_dead_bytes_per_chunk_
                      << " initial_growth_chunk_size_bytes: " << initial_growth_chunk_size_bytes_
                      << " max_power_of_two_extend_bytes: " << max_power_of_two_extend_bytes_
+                     << " thread_cache_max_bytes: " << thread_cache_max_bytes_
                      << " memory limit: " << total_memory
                      << " arena_extend_strategy: " << static_cast<int32_t>(arena_extend_strategy);
 
@@ -78,6 +90,12 @@ BFCArena::BFCArena(std::unique_ptr<IAllocator> resource_allocator,
 }
 
 BFCArena::~BFCArena() {
+  if (thread_cache_owner_) {
+    // threads that exit from now on must not give their caches back.
+    std::lock_guard<OrtMutex> owner_lock(thread_cache_owner_->mutex);
+    thread_cache_owner_->arena = nullptr;
+  }
+
   for (const auto& region : region_manager_.regions()) {
     device_allocator_->Free(region.ptr());
   }
@@ -255,6 +273,7 @@ void BFCArena::DeallocateChunk(ChunkHandle h) {
   // clean the stream / timestamp when deallocate chunk
   c->stream = nullptr;
   c->stream_timestamp = 0;
+  c->thread_cache = nullptr;
   c->next = free_chunks_list_;
   free_chunks_list_ = h;
 }
@@ -269,9 +288,198 @@ size_t BFCArena::RoundedBytes(size_t bytes) {
 }
 
 void* BFCArena::Alloc(size_t size) {
+  if (thread_cache_max_bytes_ > 0 && size > 0 && size <= kMaxThreadCacheChunkSize) {
+    return AllocateFromThreadCache(size);
+  }
   return AllocateRawInternal(size, false, nullptr, false, nullptr);
 }
 
+// The caches of a thread. When the thread exits, the caches go back to the arenas that still exist, so the chunks
+// they hold aren't kept out of the arena by threads that are gone.
+struct BFCArena::ThreadCacheEntries {
+  struct Entry {
+    uint64_t arena_id;
+    ThreadCache* cache;
+    std::weak_ptr<ThreadCacheOwner> owner;
+  };
+
+  ~ThreadCacheEntries() {
+    for (const auto& entry : entries) {
+      if (auto owner = entry.owner.lock()) {
+        std::lock_guard<OrtMutex> owner_lock(owner->mutex);
+        if (owner->arena != nullptr) {
+          owner->arena->ReleaseThreadCache(entry.cache);
+        }
+      }
+    }
+  }
+
+  std::vector<Entry> entries;
+};
+
+BFCArena::ThreadCache* BFCArena::GetThreadCache(bool create) {
+  // Arena ids are never reused, so a matching id means the arena (and the cache it owns) is alive.
+  thread_local ThreadCacheEntries thread_cache_entries;
+  auto& entries = thread_cache_entries.entries;
+
+  for (const auto& entry : entries) {
+    if (entry.arena_id == arena_id_) {
+      return entry.cache;
+    }
+  }
+
+  if (!create) {
+    return nullptr;
+  }
+
+  ThreadCache* cache = nullptr;
+  {
+    std::lock_guard<OrtMutex> lock(lock_);
+    if (thread_caches_.size() >= kMaxThreadCaches) {
+      return nullptr;
+    }
+    thread_caches_.push_back(std::make_unique<ThreadCache>());
+    cache = thread_caches_.back().get();
+  }
+
+  // drop the entries of arenas that no longer exist before adding a new one
+  entries.erase(std::remove_if(entries.begin(), entries.end(),
+                               [](const ThreadCacheEntries::Entry& entry) { return entry.owner.expired(); }),
+                entries.end());
+  entries.push_back({arena_id_, cache, thread_cache_owner_});
+  return cache;
+}
+
+void BFCArena::ReleaseThreadCache(ThreadCache* cache) {
+  std::lock_guard<OrtMutex> lock(lock_);
+  auto it = std::find_if(thread_caches_.begin(), thread_caches_.end(),
+                         [cache](const std::unique_ptr<ThreadCache>& c) { return c.get() == cache; });
+  if (it == thread_caches_.end()) {
+    return;
+  }
+
+  {
+    std::lock_guard<OrtMutex> cache_lock(cache->mutex);
+    for (auto& bin : cache->free_chunks) {
+      for (const auto& free_chunk : bin) {
+        BFCArena::ChunkHandle h = region_manager_.get_handle(free_chunk.first);
+        ORT_ENFORCE(h != kInvalidChunkHandle);
+        ChunkFromHandle(h)->thread_cache = nullptr;
+        FreeAndMaybeCoalesce(h);
+      }
+    }
+
+    // chunks that are still in use are freed to the shared bins by whichever thread frees them.
+    for (const auto& live_chunk : cache->live_chunks) {
+      BFCArena::ChunkHandle h = region_manager_.get_handle(live_chunk.first);
+      ORT_ENFORCE(h != kInvalidChunkHandle);
+      ChunkFromHandle(h)->thread_cache = nullptr;
+    }
+
+    // keep the counters of the cache in the stats of the arena
+    stats_.num_thread_cache_hits += cache->num_hits;
+    stats_.num_thread_cache_misses += cache->num_misses;
+  }
+
+  thread_caches_.erase(it);
+}
+
+void* BFCArena::AllocateFromThreadCache(size_t num_bytes) {
+  ThreadCache* cache = GetThreadCache(true);
+  if (cache == nullptr) {
+    return AllocateRawInternal(num_bytes, false, nullptr, false, nullptr);
+  }
+  const size_t rounded_bytes = RoundedBytes(num_bytes);
+
+  {
+    std::lock_guard<OrtMutex> cache_lock(cache->mutex);
+    // Best fit among the free chunks of the matching bin. A bin only holds chunks
+    // of less than twice its size so the waste is bounded like it is for the shared bins.
+    auto& bin = cache->free_chunks[BinNumForSize(rounded_bytes)];
+    auto best = bin.end();
+    for (auto it = bin.begin(); it != bin.end(); ++it) {
+      if (it->second >= rounded_bytes && (best == bin.end() || it->second < best->second)) {
+        best = it;
+      }
+    }
+
+    if (best != bin.end()) {
+      void* ptr = best->first;
+      const size_t chunk_size = best->second;
+      *best = bin.back();
+      bin.pop_back();
+      cache->cached_bytes -= chunk_size;
+      cache->live_chunks.emplace(ptr, chunk_size);
+      ++cache->num_hits;
+      return ptr;
+    }
+
+    ++cache->num_misses;
+  }
+
+  void* ptr = AllocateRawInternal(num_bytes, false, nullptr, false, nullptr);
+
+  size_t chunk_size = 0;
+  {
+    std::lock_guard<OrtMutex> lock(lock_);
+    BFCArena::ChunkHandle h = region_manager_.get_handle(ptr);
+    ORT_ENFORCE(h != kInvalidChunkHandle);
+    BFCArena::Chunk* c = ChunkFromHandle(h);
+    c->thread_cache = cache;
+    chunk_size = c->size;
+  }
+
+  std::lock_guard<OrtMutex> cache_lock(cache->mutex);
+  cache->live_chunks.emplace(ptr, chunk_size);
+  return ptr;
+}
+
+bool BFCArena::FreeToThreadCache(void* ptr) {
+  // only the thread that allocated a chunk through its cache can take it back, so don't create a cache here.
+  ThreadCache* cache = GetThreadCache(false);
+  if (cache == nullptr) {
+    return false;
+  }
+
+  {
+    std::lock_guard<OrtMutex> cache_lock(cache->mutex);
+    auto it = cache->live_chunks.find(ptr);
+    if (it == cache->live_chunks.end()) {
+      // not handed out by this thread. the shared path will remove it from the owning cache if there is one.
+      return false;
+    }
+
+    const size_t chunk_size = it->second;
+    cache->live_chunks.erase(it);
+    if (cache->cached_bytes + chunk_size <= static_cast<size_t>(thread_cache_max_bytes_)) {
+      cache->free_chunks[BinNumForSize(chunk_size)].emplace_back(ptr, chunk_size);
+      cache->cached_bytes += chunk_size;
+      return true;
+    }
+  }
+
+  // the cache is full. send the chunk back to the shared bins.
+  std::lock_guard<OrtMutex> lock(lock_);
+  DeallocateRawInternal(ptr);
+  return true;
+}
+
+void BFCArena::FlushThreadCaches() {
+  for (const auto& cache : thread_caches_) {
+    std::lock_guard<OrtMutex> cache_lock(cache->mutex);
+    for (auto& bin : cache->free_chunks) {
+      for (const auto& free_chunk : bin) {
+        BFCArena::ChunkHandle h = region_manager_.get_handle(free_chunk.first);
+        ORT_ENFORCE(h != kInvalidChunkHandle);
+        ChunkFromHandle(h)->thread_cache = nullptr;
+        FreeAndMaybeCoalesce(h);
+      }
+      bin.clear();
+    }
+    cache->cached_bytes = 0;
+  }
+}
+
 void* BFCArena::Reserve(size_t size) {
   if (size == 0)
     return nullptr;
@@ -349,6 +557,22 @@ void* BFCArena::AllocateRawInternal(size_t num_bytes,
 
   // Try to extend
   auto status = Extend(rounded_bytes);
+
+  // If the arena can't grow, the chunks sitting idle in the thread caches may be enough to
+  // satisfy the request once they are returned to the bins.
+  if (!status.IsOK() && !thread_caches_.empty()) {
+    FlushThreadCaches();
+    chunk = FindChunkPtr(bin_num, rounded_bytes, num_bytes, stream, enable_cross_stream_reusing, wait_fn);
+    if (chunk != nullptr) {
+      if (chunk->stream == nullptr) {
+        chunk->stream = stream;
+        if (stream)
+          chunk->stream_timestamp = stream->GetCurrentTimestamp();
+      }
+      return chunk->ptr;
+    }
+  }
+
   if (status.IsOK()) {
     chunk = FindChunkPtr(bin_num, rounded_bytes, num_bytes, stream, false);
     if (chunk != nullptr) {
@@ -379,6 +603,17 @@ void* BFCArena::AllocateRawInternal(size_t num_bytes,
 void BFCArena::GetStats(AllocatorStats* stats) {
   std::lock_guard<OrtMutex> lock(lock_);
   *stats = stats_;
+
+  for (const auto& cache : thread_caches_) {
+    std::lock_guard<OrtMutex> cache_lock(cache->mutex);
+    stats->num_thread_cache_hits += cache->num_hits;
+    stats->num_thread_cache_misses += cache->num_misses;
+    stats->bytes_in_thread_caches += static_cast<int64_t>(cache->cached_bytes);
+  }
+
+  // cache hits never reach the shared bins, and chunks idle in a thread cache are not in use by anyone
+  stats->num_allocs += stats->num_thread_cache_hits;
+  stats->bytes_in_use -= stats->bytes_in_thread_caches;
 }
 
 BFCArena::Chunk* BFCArena::SplitFreeChunkFromBin(BFCArena::Bin::FreeChunkSet* free_chunks,
@@ -496,6 +731,11 @@ void BFCArena::Free(void* p) {
   if (p == nullptr) {
     return;
   }
+
+  if (thread_cache_max_bytes_ > 0 && FreeToThreadCache(p)) {
+    return;
+  }
+
   std::lock_guard<OrtMutex> lock(lock_);
   auto it = reserved_chunks_.find(p);
   if (it != reserved_chunks_.end()) {
@@ -510,6 +750,8 @@ void BFCArena::Free(void* p) {
 
 Status BFCArena::Shrink() {
   std::lock_guard<OrtMutex> lock(lock_);
+  FlushThreadCaches();
+
   auto num_regions = region_manager_.regions().size();
   std::vector<void*> region_ptrs;
   std::vector<size_t> region_sizes;
@@ -578,6 +820,15 @@ void BFCArena::DeallocateRawInternal(void* ptr) {
   BFCArena::ChunkHandle h = region_manager_.get_handle(ptr);
   ORT_ENFORCE(h != kInvalidChunkHandle);
 
+  // A chunk handed out through a thread cache may be freed by a different thread.
+  // Make sure the owning cache forgets about it.
+  Chunk* c = ChunkFromHandle(h);
+  if (c->thread_cache != nullptr) {
+    std::lock_guard<OrtMutex> cache_lock(c->thread_cache->mutex);
+    c->thread_cache->live_chunks.erase(ptr);
+    c->thread_cache = nullptr;
+  }
+
   // Consider coalescing it.
   FreeAndMaybeCoalesce(h);
 }
@@ -16,13 +16,16 @@ limitations under the License.
 
 #pragma once
 #include <array>
+#include <atomic>
 #include <memory>
 #include <mutex>
 #include <sstream>
+#include <vector>
 
 #include "onnxruntime_config.h"
 
 #include "core/common/common.h"
+#include "core/common/inlined_containers.h"
 #include "core/common/logging/logging.h"
 #include "core/common/logging/severity.h"
 #include "core/common/safeint.h"
@@ -61,6 +64,8 @@ class BFCArena : public IAllocator {
   static const int DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES = 2 * 1024 * 1024;
   static const int64_t DEFAULT_MAX_POWER_OF_TWO_EXTEND_BYTES = 1024 * 1024 * 1024;  // 1GB
   static const size_t DEFAULT_MAX_MEM = std::numeric_limits<size_t>::max();
+  // Per-thread chunk cache is disabled by default.
+  static const int64_t DEFAULT_THREAD_CACHE_MAX_BYTES = 0;
 
   enum ArenaType {
     BaseArena,
@@ -73,7 +78,8 @@ class BFCArena : public IAllocator {
            int initial_chunk_size_bytes = DEFAULT_INITIAL_CHUNK_SIZE_BYTES,
            int max_dead_bytes_per_chunk = DEFAULT_MAX_DEAD_BYTES_PER_CHUNK,
            int initial_growth_chunk_size_bytes = DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES,
-           int64_t max_power_of_two_extend_bytes = DEFAULT_MAX_POWER_OF_TWO_EXTEND_BYTES);
+           int64_t max_power_of_two_extend_bytes = DEFAULT_MAX_POWER_OF_TWO_EXTEND_BYTES,
+           int64_t thread_cache_max_bytes = DEFAULT_THREAD_CACHE_MAX_BYTES);
 
   ~BFCArena() override;
 
@@ -86,6 +92,7 @@ class BFCArena : public IAllocator {
   void Free(void* p) override;
 
   // Frees all allocation regions in which no chunk is in use.
+  // Chunks held by the per-thread caches are returned to the bins first.
   // Does not free any reserved chunks.
   // Resets the size that the arena will grow by in the next allocation to
   // `initial_growth_chunk_size_bytes_` but ultimately all
@@ -132,6 +139,8 @@ class BFCArena : public IAllocator {
   static const int kInvalidBinNum = -1;
   static const int kNumBins = 21;
 
+  struct ThreadCache;
+
   // Chunks point to memory.  Their prev/next pointers form a
   // doubly-linked list of addresses sorted by base address that
   // must be contiguous.  Chunks contain information about whether
@@ -170,6 +179,11 @@ class BFCArena : public IAllocator {
 
     uint64_t stream_timestamp = 0;
 
+    // If not nullptr, the chunk was handed out through this per-thread cache.
+    // From the arena's point of view the chunk stays in use until the cache
+    // gives it back. Only modified while holding lock_.
+    ThreadCache* thread_cache = nullptr;
+
     bool in_use() const { return allocation_id != -1; }
 
     std::string DebugString(BFCArena* a, bool recurse) {
@@ -223,6 +237,40 @@ class BFCArena : public IAllocator {
   static const size_t kMinAllocationBits = 8;
   static const size_t kMinAllocationSize = 1 << kMinAllocationBits;
 
+  // Largest request that is served through the per-thread caches.
+  static const size_t kMaxThreadCacheChunkSize = 1 << 20;
+
+  // Most threads that get a cache. Allocations from other threads go to the shared bins.
+  static const size_t kMaxThreadCaches = 64;
+
+  // A per-thread cache of recently freed chunks, grouped by bin. It lets a thread
+  // reuse its own chunks without taking lock_. The cache mutex is normally only
+  // taken by the owning thread, so it is uncontended. Lock order is lock_ first,
+  // then the cache mutex; the owning thread never holds the cache mutex while it
+  // acquires lock_.
+  struct ThreadCache {
+    OrtMutex mutex;
+
+    // Free chunks (ptr, chunk size) owned by this cache, indexed by bin.
+    std::array<std::vector<std::pair<void*, size_t>>, kNumBins> free_chunks;
+
+    // Chunks handed out through this cache that are still in use by the caller.
+    InlinedHashMap<void*, size_t> live_chunks;
+
+    size_t cached_bytes = 0;
+    int64_t num_hits = 0;
+    int64_t num_misses = 0;
+  };
+
+  // Shared with the thread local cache entries so that a thread that exits can give its cache back to the arena,
+  // or find out that the arena no longer exists. `arena` is reset under `mutex` when the arena is destroyed.
+  struct ThreadCacheOwner {
+    OrtMutex mutex;
+    BFCArena* arena;
+  };
+
+  struct ThreadCacheEntries;
+
   // AllocationRegion maps pointers to ChunkHandles for a single
   // contiguous memory region.
   //
@@ -412,6 +460,25 @@ class BFCArena : public IAllocator {
 
   void DumpMemoryLog(size_t num_bytes);
 
+  // Returns the cache of the calling thread. If it has none, creates one if `create` is true and the arena has
+  // fewer than kMaxThreadCaches caches, otherwise returns nullptr.
+  ThreadCache* GetThreadCache(bool create);
+
+  // Called when the thread that owns `cache` exits. Returns its free chunks to the shared bins, detaches the
+  // chunks it handed out so that they are freed to the shared bins, and destroys the cache.
+  void ReleaseThreadCache(ThreadCache* cache);
+
+  // Allocates through the calling thread's cache, falling back to the shared bins on a miss.
+  void* AllocateFromThreadCache(size_t num_bytes);
+
+  // Returns true if 'ptr' was handed out by the calling thread's cache and has been
+  // taken back by it (or released to the shared bins if the cache is full).
+  bool FreeToThreadCache(void* ptr);
+
+  // Returns all the free chunks held by the thread caches to the shared bins.
+  // Requires lock_ to be held.
+  void FlushThreadCaches();
+
   ChunkHandle AllocateChunk();
   void DeallocateChunk(ChunkHandle h);
 
@@ -508,6 +575,16 @@ class BFCArena : public IAllocator {
   const int max_dead_bytes_per_chunk_;
   const int initial_growth_chunk_size_bytes_;
   const int64_t max_power_of_two_extend_bytes_;
+  const int64_t thread_cache_max_bytes_;
+
+  // Unique id of this arena, used to look up the calling thread's cache.
+  // Never reused, so a stale thread local entry can never match a new arena.
+  const uint64_t arena_id_;
+  static std::atomic<uint64_t> next_arena_id_;
+
+  // All the thread caches of live threads. Guarded by lock_.
+  std::vector<std::unique_ptr<ThreadCache>> thread_caches_;
+  std::shared_ptr<ThreadCacheOwner> thread_cache_owner_;
 
   // This flag is only relevant if Shrink() is invoked.
   // This is a boolean flag that controls whether the first allocation region
@@ -398,10 +398,13 @@ ExecutionFrame::ExecutionFrame(gsl::span<const int> feed_mlvalue_idxs, gsl::span
     // if there are some traditional ml value type in inputs disable the memory pattern optimization.
     if (all_tensors) {
       mem_patterns_ = session_state.GetMemoryPatternGroup(feeds, feed_mlvalue_idxs, inferred_shapes_);
-      // if no existing patterns, generate one in this execution frame
-      if (!mem_patterns_) {
+      // if no existing patterns, generate one in this execution frame.
+      // a bucketed pattern is also traced so it can be grown if it's too small for this execution.
+      if (!mem_patterns_ || session_state.UseMemoryPatternShapeBuckets()) {
         planner_.emplace(*session_state.GetExecutionPlan());
-      } else {
+      }
+
+      if (mem_patterns_) {
         // pre-allocate the big chunk requested in memory pattern.
         // all the internal kernel's input/output tensors will be allocated on these buffer.
         buffers_.reserve(mem_patterns_->locations.size());
@@ -548,13 +551,24 @@ Status ExecutionFrame::AllocateMLValueTensorSelfOwnBufferHelper(OrtValue& ort_va
       if (block) {
         auto it = buffers_.find(location);
         if (it != buffers_.end()) {
+          // a bucketed pattern was generated for the largest shapes seen in the bucket so it can serve smaller ones.
+          const bool use_buckets = session_state_.UseMemoryPatternShapeBuckets();
           // if the block is not correct, log message then fall back to default behavior
-          if (block->size_ == size) {
+          if (block->size_ == size || (use_buckets && block->size_ > size)) {
             void* buffer = it->second.get();
             auto status = AllocateTensorWithPreAllocateBufferHelper(
                 ort_value, static_cast<void*>(static_cast<char*>(buffer) + block->offset_), element_type, location,
                 shape);
+            // keep the size of the block in case the pattern needs to be regenerated
+            TraceAllocate(ort_value_index, block->size_);
             return status;
+          } else if (use_buckets) {
+            // grow the pattern of the bucket at the end of the execution
+            mem_patterns_too_small_ = true;
+            LOGS(session_state_.Logger(), VERBOSE) << "For ort_value with index: " << ort_value_index
+                                                   << ", block in bucketed memory pattern size is: " << block->size_
+                                                   << " but the actual size is: " << size
+                                                   << ", fall back to default allocation behavior";
           } else {
             // the block size may vary especially if the model has NonZero ops, or different sequence lengths are
             // fed in, so use VERBOSE as the log level as it's expected.
@@ -567,6 +581,10 @@ Status ExecutionFrame::AllocateMLValueTensorSelfOwnBufferHelper(OrtValue& ort_va
           }
         }
         // else { we couldn't allocate the large block for the buffer so we didn't insert an entry }
+      } else if (session_state_.UseMemoryPatternShapeBuckets() &&
+                 !utils::IsDataTypeString(element_type)) {
+        // the tensor wasn't allocated when the pattern was generated
+        mem_patterns_too_small_ = true;
       }
     }
   }
@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include <atomic>
+#include <memory>
 #include <mutex>
 #include <vector>
 
@@ -164,6 +166,12 @@ class ExecutionFrame final : public IExecutionFrame {
     return planner_.has_value();
   }
 
+  // Whether the memory pattern traced in this execution should be cached: either there was no cached
+  // pattern for the input shapes, or a bucketed pattern was too small for this execution.
+  bool HasMemoryPatternsToCache() const {
+    return planner_.has_value() && (mem_patterns_ == nullptr || mem_patterns_too_small_);
+  }
+
   // This function try retrieve the inferred shapes for the given NodeArg index.
   // If the retrival is sucessful, this function returns true and false otherwise.
   bool TryGetInferredShape(int index, TensorShape& shape) const override;
@@ -229,12 +237,17 @@ class ExecutionFrame final : public IExecutionFrame {
   // If we already have cached memory pattern on these input shapes
   // Use this mem pattern that create a big chunk for all the internal
   // kernel's input/output tensors.
-  const MemoryPatternGroup* mem_patterns_;
+  std::shared_ptr<const MemoryPatternGroup> mem_patterns_;
 
   // If no cached memory pattern, and we enable the memory pattern optimization
   // use this planner_ to trace the memory allocation in current executor.
+  // With bucketed memory patterns the allocations are also traced if there is a cached pattern,
+  // so that the pattern can be grown if it's too small for the shapes of this execution.
   std::optional<OrtValuePatternPlanner> planner_;
 
+  // Set if a bucketed memory pattern didn't have a large enough block for a tensor.
+  std::atomic<bool> mem_patterns_too_small_{false};
+
   // Big chunks on different locations that will be used by mem_pattern.
   InlinedHashMap<OrtDevice, BufferUniquePtr> buffers_;
 
@@ -243,7 +256,7 @@ class ExecutionFrame final : public IExecutionFrame {
   // by i, if the key i exists.
   // inferred_shapes_ is generated together with mem_patterns_.
   // It is never updated after creation
-  const InlinedHashMap<int, TensorShape>* inferred_shapes_{nullptr};
+  std::shared_ptr<const InlinedHashMap<int, TensorShape>> inferred_shapes_;
 
 #if !defined(ORT_MINIMAL_BUILD) && defined(ORT_MEMORY_PROFILE)
   // Size of virtual memory allocated before any kernel execution.
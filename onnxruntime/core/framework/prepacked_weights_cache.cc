@@ -0,0 +1,70 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/prepacked_weights_cache.h"
+
+#include "core/framework/allocator_utils.h"
+#include "core/graph/constants.h"
+
+namespace onnxruntime {
+
+SharedPrepackedWeightsCache::SharedPrepackedWeightsCache(std::unordered_set<std::string> op_types)
+    : op_types_(op_types.empty()
+                    ? std::unordered_set<std::string>{"MatMulInteger", "QLinearConv", "Gemm", "Conv"}
+                    : std::move(op_types)) {
+  // The cached buffers outlive the session that produced them, so they can't come from a session's arena.
+  AllocatorCreationInfo device_info{[](int) { return std::make_unique<CPUAllocator>(); },
+                                    0, false};
+  allocator_ = CreateAllocator(device_info);
+}
+
+bool SharedPrepackedWeightsCache::IsCachedOpType(const std::string& domain, const std::string& op_type) const {
+  return (domain.empty() || domain == kOnnxDomain) && op_types_.count(op_type) > 0;
+}
+
+std::shared_ptr<const PrePackedWeights> SharedPrepackedWeightsCache::Find(const std::string& key) const {
+  std::lock_guard<OrtMutex> lock(mutex_);
+
+  auto iter = entries_.find(key);
+  return iter != entries_.end() ? iter->second.lock() : nullptr;
+}
+
+std::shared_ptr<const PrePackedWeights> SharedPrepackedWeightsCache::GetOrInsert(const std::string& key,
+                                                                                 PrePackedWeights&& weights,
+                                                                                 bool& found_existing) {
+  std::lock_guard<OrtMutex> lock(mutex_);
+
+  found_existing = false;
+  auto iter = entries_.find(key);
+  if (iter != entries_.end()) {
+    // another session may have inserted the weights after this one looked them up
+    if (auto existing = iter->second.lock()) {
+      found_existing = true;
+      return existing;
+    }
+  }
+
+  PruneExpiredEntries();
+
+  auto entry = std::make_shared<const PrePackedWeights>(std::move(weights));
+  entries_[key] = entry;
+  return entry;
+}
+
+size_t SharedPrepackedWeightsCache::GetNumberOfElements() const {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  PruneExpiredEntries();
+  return entries_.size();
+}
+
+void SharedPrepackedWeightsCache::PruneExpiredEntries() const {
+  for (auto iter = entries_.begin(); iter != entries_.end();) {
+    if (iter->second.expired()) {
+      iter = entries_.erase(iter);
+    } else {
+      ++iter;
+    }
+  }
+}
+
+}  // namespace onnxruntime
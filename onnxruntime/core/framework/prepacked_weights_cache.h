@@ -0,0 +1,69 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "core/framework/allocator.h"
+#include "core/platform/ort_mutex.h"
+#include "prepacked_weights.h"
+
+namespace onnxruntime {
+
+// Process wide cache of pre-packed weights owned by the Environment and shared by every session created from it.
+//
+// Unlike PrepackedWeightsContainer, which only de-duplicates pre-packed weights of initializers that the user
+// explicitly shares across sessions via a container they wire into each session, this cache is keyed by the
+// contents of the initializer: the key is derived from the raw bytes of the initializer together with everything
+// else the packed layout depends on (the kernel, its attributes and input types, the input index and the ISA MLAS
+// packs for), so identical weights loaded by independent sessions (e.g. replicas of the same model) resolve to a
+// single copy, and a session that finds an entry hands it to the kernel without pre-packing the weight again.
+//
+// Entries are reference counted: the cache itself only holds weak references and each SessionState that uses an
+// entry holds a strong one, so an entry is released as soon as the last session using it is destroyed.
+class SharedPrepackedWeightsCache final {
+ public:
+  // Caches pre-packed weights for the ONNX domain ops in `op_types`.
+  // If `op_types` is empty, the default set (MatMulInteger, QLinearConv, Gemm and Conv) is used.
+  explicit SharedPrepackedWeightsCache(std::unordered_set<std::string> op_types = {});
+
+  ~SharedPrepackedWeightsCache() = default;
+
+  // Returns true if pre-packed weights of nodes with the given op type should be looked up in this cache.
+  bool IsCachedOpType(const std::string& domain, const std::string& op_type) const;
+
+  // Returns the (non-arena) CPU allocator that pre-packed weights to be inserted into the cache must be
+  // allocated with, so they can outlive the session that produced them.
+  AllocatorPtr GetAllocator() const {
+    return allocator_;
+  }
+
+  // Returns the cached PrePackedWeights instance for `key` if one is alive, nullptr otherwise.
+  std::shared_ptr<const PrePackedWeights> Find(const std::string& key) const;
+
+  // Returns the cached PrePackedWeights instance for `key` if one is alive, setting `found_existing` to true.
+  // Otherwise `weights` is moved into the cache and returned.
+  std::shared_ptr<const PrePackedWeights> GetOrInsert(const std::string& key, PrePackedWeights&& weights,
+                                                      /*out*/ bool& found_existing);
+
+  // Returns the number of entries that are still referenced by at least one session.
+  size_t GetNumberOfElements() const;
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(SharedPrepackedWeightsCache);
+
+ private:
+  // Drops entries that are no longer referenced by any session. Requires mutex_ to be held.
+  void PruneExpiredEntries() const;
+
+  const std::unordered_set<std::string> op_types_;
+  AllocatorPtr allocator_;
+
+  mutable OrtMutex mutex_;
+  mutable std::unordered_map<std::string, std::weak_ptr<const PrePackedWeights>> entries_;
+};
+
+}  // namespace onnxruntime
@@ -165,6 +165,20 @@ struct SequentialExecutionPlan : public ExecutionPlanBase {
 
   size_t num_barriers{0};
 
+  // Dependency counts for the work-stealing schedule used by ORT_PARALLEL execution. They are only populated
+  // when the plan consists of a single CPU logic stream. Instead of running the steps of that stream in order,
+  // the executor dispatches each node to the inter-op thread pool as soon as all its producers completed.
+  // node_num_producers[i]: number of distinct nodes in the plan that node i depends on. indexed by node index.
+  std::vector<int> node_num_producers;
+  // node_consumers[i]: distinct nodes in the plan that depend on node i. indexed by node index.
+  std::vector<InlinedVector<NodeIndex>> node_consumers;
+  // nodes in the plan that don't depend on any other node in the plan.
+  InlinedVector<NodeIndex> entry_nodes;
+
+  bool HasWorkStealingSchedule() const {
+    return !entry_nodes.empty();
+  }
+
 #ifdef ENABLE_TRAINING
   InlinedVector<NodeIndex> node_execution_order_in_training;
   InlinedHashMap<NodeIndex, size_t> node_index_2_toposort_index;
@@ -538,10 +538,16 @@ onnxruntime::Status ExecuteThePlan(const SessionState& session_state, gsl::span<
       valid_streams++;
   }
 
+  // with the work-stealing schedule there is a task for each node without producers instead of each stream
+  const bool use_work_stealing_schedule = !single_thread_mode && execution_plan->HasWorkStealingSchedule();
+  const int32_t num_tasks = use_work_stealing_schedule
+                                ? gsl::narrow<int32_t>(execution_plan->entry_nodes.size())
+                                : valid_streams;
+
   // prepare the execution context, notifications got initialized.
 #ifdef ORT_ENABLE_STREAM
   StreamExecutionContext ctx(session_state,
-                             valid_streams,
+                             num_tasks,
                              execution_plan->notification_owners,
                              execution_plan->num_barriers,
                              device_streams,
@@ -554,7 +560,7 @@ onnxruntime::Status ExecuteThePlan(const SessionState& session_state, gsl::span<
                              single_thread_mode);
 #else
   StreamExecutionContext ctx(session_state,
-                             valid_streams,
+                             num_tasks,
                              feed_mlvalue_idxs,
                              feeds,
                              fetch_mlvalue_idxs,
@@ -576,23 +582,31 @@ onnxruntime::Status ExecuteThePlan(const SessionState& session_state, gsl::span<
 
   auto* tp = single_thread_mode ? nullptr : session_state.GetInterOpThreadPool();
 
-  for (size_t i = 0; i < execution_plan->execution_plan.size(); ++i) {
-    if (execution_plan->execution_plan[i]->steps_.empty()) {
-      // execution context is initialized with number of valid streams
-      // for invalid stream (0 steps), it doesn't count in number of tasks
-      // so don't need to invoke CompleteTask here
-      // ctx.CompleteTask();
-    } else {
-      concurrency::ThreadPool::Schedule(tp, [i, &ctx, &terminate_flag, &session_scope]() {
-        RunSince(i, ctx, session_scope, terminate_flag, 0);
+  if (use_work_stealing_schedule) {
+    for (auto node_index : execution_plan->entry_nodes) {
+      concurrency::ThreadPool::Schedule(tp, [node_index, &ctx, &terminate_flag, &session_scope]() {
+        RunNodesSince(ctx, session_scope, terminate_flag, node_index);
       });
     }
+  } else {
+    for (size_t i = 0; i < execution_plan->execution_plan.size(); ++i) {
+      if (execution_plan->execution_plan[i]->steps_.empty()) {
+        // execution context is initialized with number of valid streams
+        // for invalid stream (0 steps), it doesn't count in number of tasks
+        // so don't need to invoke CompleteTask here
+        // ctx.CompleteTask();
+      } else {
+        concurrency::ThreadPool::Schedule(tp, [i, &ctx, &terminate_flag, &session_scope]() {
+          RunSince(i, ctx, session_scope, terminate_flag, 0);
+        });
+      }
+    }
   }
 
   ctx.WaitAll();
   ORT_RETURN_IF_ERROR(ctx.TaskStatus());
   ORT_RETURN_IF_ERROR(ctx.GetExecutionFrame().GetOutputs(fetches));
-  if (ctx.GetExecutionFrame().HasMemoryPatternPlanner()) {
+  if (ctx.GetExecutionFrame().HasMemoryPatternsToCache()) {
     bool all_tensors = true;
     for (const auto& feed : feeds) {
       if (!(feed.IsTensor())) {
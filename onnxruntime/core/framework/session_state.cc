@@ -3,18 +3,25 @@
 
 #include "core/framework/session_state.h"
 
+#include <algorithm>
+#include <limits>
 #include <sstream>
 
 #include "core/platform/ort_mutex.h"
+#include "core/common/hash_combine.h"
 #include "core/common/logging/logging.h"
+#include "core/common/narrow.h"
+#include "core/common/parse_string.h"
 #include "core/common/safeint.h"
 #include "core/flatbuffers/schema/ort.fbs.h"
 #include "core/framework/allocator.h"
+#include "core/framework/murmurhash3.h"
 #include "core/framework/node_index_info.h"
 #include "core/framework/op_kernel.h"
 #include "core/framework/ort_value_pattern_planner.h"
 #include "core/framework/session_state_utils.h"
 #include "core/framework/utils.h"
+#include "core/mlas/inc/mlas.h"
 #include "core/providers/cpu/controlflow/utils.h"
 #include "core/session/onnxruntime_session_options_config_keys.h"
 
@@ -70,7 +77,8 @@ SessionState::SessionState(Graph& graph,
                            profiling::Profiler& profiler,
                            const SessionOptions& sess_options,
                            PrepackedWeightsContainer* prepacked_weights_container,
-                           AllocatorMap* parent_allocators)
+                           AllocatorMap* parent_allocators,
+                           SharedPrepackedWeightsCache* shared_prepacked_weights_cache)
     : graph_(graph),
       execution_providers_(execution_providers),
       logger_(logger),
@@ -79,7 +87,8 @@ SessionState::SessionState(Graph& graph,
       inter_op_thread_pool_(inter_op_thread_pool),
       data_transfer_mgr_(data_transfer_mgr),
       sess_options_(sess_options),
-      prepacked_weights_container_(prepacked_weights_container)
+      prepacked_weights_container_(prepacked_weights_container),
+      shared_prepacked_weights_cache_(shared_prepacked_weights_cache)
 #ifdef ORT_ENABLE_STREAM
       ,
       stream_handles_registry_(std::make_unique<StreamCommandHandleRegistryImpl>())
@@ -394,6 +403,193 @@ static std::string GenerateKeyForPrepackedWeightsMap(const std::string& op_type,
   return ss_1.str();
 }
 
+// The key of a constant initializer in the shared pre-packed weights cache covers everything PrePack() depends on:
+// the raw bytes of the initializer, the kernel and its attributes and input types, the input index and the ISA
+// MLAS packs for. This allows a session to use a cached entry without pre-packing the initializer first.
+static std::string GenerateKeyForSharedPrepackedWeightsCache(const Node& node, int input_idx, const Tensor& tensor) {
+  uint32_t hash[4] = {0, 0, 0, 0};
+
+  auto hash_bytes = [&hash](const void* data, size_t len) {
+    // MurmurHash3 takes the length as an int, so large initializers are hashed in chunks
+    constexpr size_t max_chunk_size = static_cast<size_t>(std::numeric_limits<int32_t>::max());
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    do {
+      const size_t chunk_size = std::min(len, max_chunk_size);
+      MurmurHash3::x86_128(bytes, static_cast<int32_t>(chunk_size), hash[0], &hash);
+      bytes += chunk_size;
+      len -= chunk_size;
+    } while (len > 0);
+  };
+  auto hash_str = [&hash_bytes](const std::string& str) { hash_bytes(str.data(), str.size()); };
+
+  const int32_t elem_type = tensor.GetElementType();
+  const auto dims = tensor.Shape().GetDims();
+  hash_bytes(&elem_type, sizeof(elem_type));
+  hash_bytes(dims.data(), dims.size() * sizeof(int64_t));
+  hash_bytes(tensor.DataRaw(), tensor.SizeInBytes());
+
+  // attributes are hashed in name order as NodeAttributes is unordered
+  const auto& attributes = node.GetAttributes();
+  std::vector<const std::string*> attribute_names;
+  attribute_names.reserve(attributes.size());
+  for (const auto& attribute : attributes) {
+    attribute_names.push_back(&attribute.first);
+  }
+  std::sort(attribute_names.begin(), attribute_names.end(),
+            [](const std::string* a, const std::string* b) { return *a < *b; });
+  for (const auto* name : attribute_names) {
+    hash_str(*name);
+    hash_str(attributes.at(*name).SerializeAsString());
+  }
+
+  // the packed layout of the quantized kernels depends on the type of the other inputs
+  for (const auto* input_def : node.InputDefs()) {
+    const auto* type = input_def->Exists() ? input_def->Type() : nullptr;
+    hash_str(type != nullptr ? *type : std::string());
+  }
+
+  std::ostringstream ss;
+  ss << node.Domain() << ":" << node.OpType() << ":" << node.SinceVersion() << ":" << node.GetExecutionProviderType()
+     << ":" << input_idx << ":" << MlasGetPackedBufferIsa() << "+"
+     << std::hex << hash[0] << "_" << hash[1] << "_" << hash[2] << "_" << hash[3];
+
+  return ss.str();
+}
+
+#if !defined(ORT_MINIMAL_BUILD)
+Status SessionState::SavePrePackedInitializersToOrtFormat(
+    flatbuffers::FlatBufferBuilder& builder,
+    flatbuffers::Offset<fbs::PrePackedInitializers>& fbs_prepacked_initializers) const {
+  fbs_prepacked_initializers = 0;
+  if (prepacked_weights_to_save_.empty()) {
+    return Status::OK();
+  }
+
+  std::vector<flatbuffers::Offset<fbs::PrePackedInitializer>> fbs_initializers;
+  fbs_initializers.reserve(prepacked_weights_to_save_.size());
+
+  for (const auto& [key, weights] : prepacked_weights_to_save_) {
+    std::vector<flatbuffers::Offset<fbs::PrePackedBuffer>> fbs_buffers;
+    fbs_buffers.reserve(weights->buffers_.size());
+
+    for (size_t i = 0, end = weights->buffers_.size(); i < end; ++i) {
+      flatbuffers::Offset<flatbuffers::Vector<uint8_t>> fbs_data;
+      const size_t buffer_size = weights->buffer_sizes_[i];
+      if (weights->buffers_[i] != nullptr && buffer_size > 0) {
+        // align the data so the kernels can use it directly from the model bytes
+        builder.ForceVectorAlignment(buffer_size, sizeof(uint8_t), MlasGetPreferredBufferAlignment());
+        fbs_data = builder.CreateVector(static_cast<const uint8_t*>(weights->buffers_[i].get()), buffer_size);
+      }
+
+      fbs_buffers.push_back(fbs::CreatePrePackedBuffer(builder, fbs_data));
+    }
+
+    fbs_initializers.push_back(fbs::CreatePrePackedInitializer(builder,
+                                                               narrow<uint32_t>(key.first),
+                                                               narrow<uint32_t>(key.second),
+                                                               builder.CreateVector(fbs_buffers)));
+  }
+
+  fbs_prepacked_initializers = fbs::CreatePrePackedInitializers(builder,
+                                                                MLAS_PACKED_BUFFER_FORMAT_VERSION,
+                                                                builder.CreateString(MlasGetPackedBufferIsa()),
+                                                                builder.CreateVector(fbs_initializers));
+  return Status::OK();
+}
+#endif  // !defined(ORT_MINIMAL_BUILD)
+
+void SessionState::SetPrePackedInitializersFromOrtFormat(const fbs::PrePackedInitializers& fbs_prepacked_initializers,
+                                                         bool can_use_flatbuffer_for_buffers) {
+  serialized_prepacked_initializers_.clear();
+
+  const auto* fbs_isa = fbs_prepacked_initializers.isa();
+  const char* isa = MlasGetPackedBufferIsa();
+  if (fbs_prepacked_initializers.packed_buffer_format_version() != MLAS_PACKED_BUFFER_FORMAT_VERSION ||
+      fbs_isa == nullptr || fbs_isa->str() != isa) {
+    LOGS(logger_, INFO) << "Ignoring the pre-packed weights in the ORT format model as they were packed for "
+                        << (fbs_isa ? fbs_isa->str() : std::string("<unknown>"))
+                        << " (format version " << fbs_prepacked_initializers.packed_buffer_format_version()
+                        << ") and this platform uses " << isa
+                        << " (format version " << MLAS_PACKED_BUFFER_FORMAT_VERSION << ").";
+    return;
+  }
+
+  const auto* fbs_initializers = fbs_prepacked_initializers.initializers();
+  if (fbs_initializers == nullptr) {
+    return;
+  }
+
+  for (const auto* fbs_initializer : *fbs_initializers) {
+    if (fbs_initializer != nullptr && fbs_initializer->buffers() != nullptr) {
+      serialized_prepacked_initializers_[{static_cast<NodeIndex>(fbs_initializer->node_index()),
+                                          narrow<int>(fbs_initializer->input_index())}] = fbs_initializer;
+    }
+  }
+
+  can_use_flatbuffer_for_prepacked_buffers_ = can_use_flatbuffer_for_buffers;
+}
+
+Status SessionState::UseSerializedPrePackedWeights(OpKernel& kernel, NodeIndex node_index, int input_idx,
+                                                   const Tensor& tensor,
+                                                   /*out*/ bool& used_serialized_prepacked_weights) {
+  used_serialized_prepacked_weights = false;
+
+  auto entry = serialized_prepacked_initializers_.find({node_index, input_idx});
+  if (entry == serialized_prepacked_initializers_.end()) {
+    return Status::OK();
+  }
+
+  const auto& fbs_buffers = *entry->second->buffers();
+  const size_t alignment = MlasGetPreferredBufferAlignment();
+
+  std::vector<BufferUniquePtr> prepacked_buffers;
+  std::vector<size_t> prepacked_buffer_sizes;
+  prepacked_buffers.reserve(fbs_buffers.size());
+  prepacked_buffer_sizes.reserve(fbs_buffers.size());
+
+  // buffers copied out of the flatbuffer. they are released if the kernel doesn't use them.
+  auto copied_weights = std::make_unique<PrePackedWeights>();
+
+  for (const auto* fbs_buffer : fbs_buffers) {
+    const auto* fbs_data = fbs_buffer != nullptr ? fbs_buffer->data() : nullptr;
+    if (fbs_data == nullptr || fbs_data->size() == 0) {
+      prepacked_buffers.emplace_back(nullptr, BufferDeleter(nullptr));
+      prepacked_buffer_sizes.push_back(0);
+      continue;
+    }
+
+    const uint8_t* data = fbs_data->Data();
+    const size_t size = fbs_data->size();
+    void* buffer = nullptr;
+
+    if (can_use_flatbuffer_for_prepacked_buffers_ && reinterpret_cast<uintptr_t>(data) % alignment == 0) {
+      // the kernels only read the pre-packed buffers
+      buffer = const_cast<uint8_t*>(data);
+    } else {
+      AllocatorPtr session_cpu_alloc = GetAllocator(kernel.Info().GetDevice(OrtMemType::OrtMemTypeDefault));
+      auto copy = IAllocator::MakeUniquePtr<void>(session_cpu_alloc, size, true);
+      memcpy(copy.get(), data, size);
+      buffer = copy.get();
+      copied_weights->buffers_.push_back(std::move(copy));
+      copied_weights->buffer_sizes_.push_back(size);
+    }
+
+    // the kernel doesn't own the buffer
+    prepacked_buffers.emplace_back(buffer, BufferDeleter(nullptr));
+    prepacked_buffer_sizes.push_back(size);
+  }
+
+  ORT_RETURN_IF_ERROR(kernel.UseSerializedPrePackedBuffers(tensor, input_idx, prepacked_buffers,
+                                                           prepacked_buffer_sizes,
+                                                           used_serialized_prepacked_weights));
+
+  if (used_serialized_prepacked_weights && !copied_weights->buffers_.empty()) {
+    owned_prepacked_weights_.push_back(std::move(copied_weights));
+  }
+
+  return Status::OK();
+}
+
 Status SessionState::PrepackConstantInitializedTensors(InlinedHashMap<std::string, size_t>& constant_initializers_use_count,
                                                        const std::unordered_map<std::string, const OrtValue*>& initializers_to_share_map) {
   auto prepacked_constant_weights = [this, &constant_initializers_use_count, &initializers_to_share_map](
@@ -419,8 +615,17 @@ Status SessionState::PrepackConstantInitializedTensors(InlinedHashMap<std::strin
                 auto iter = initializers_to_share_map.find(input_name);
                 bool is_shared_initializer = (iter != initializers_to_share_map.end());
 
-                // Caching pre-packed weights is limited to shared initializers associated with the CPU EP for now
-                if (is_shared_initializer && should_cache_prepacked_weights_for_shared_initializers &&
+                bool used_serialized_prepacked_weights = false;
+                ORT_RETURN_IF_ERROR(UseSerializedPrePackedWeights(*kernel, node.Index(), input_idx,
+                                                                  const_initialized_tensor,
+                                                                  used_serialized_prepacked_weights));
+
+                if (used_serialized_prepacked_weights) {
+                  is_packed = true;
+                  ++used_serialized_pre_packed_weights_counter_;
+
+                  // Caching pre-packed weights is limited to shared initializers associated with the CPU EP for now
+                } else if (is_shared_initializer && should_cache_prepacked_weights_for_shared_initializers &&
                     node.GetExecutionProviderType() == kCpuExecutionProvider) {  // caching of pre-packed weights' turned ON
 
                   AllocatorPtr allocator_for_caching = prepacked_weights_container_->GetOrCreateAllocator(CPU);
@@ -474,6 +679,88 @@ Status SessionState::PrepackConstantInitializedTensors(InlinedHashMap<std::strin
                                                                           prepacked_weights_container_->GetWeight(prepacked_weights_container_key),
                                                                           node.Name()));
                     }
+
+                    if (save_prepacked_initializers_) {
+                      prepacked_weights_to_save_[{node.Index(), input_idx}] =
+                          &prepacked_weights_container_->GetWeight(prepacked_weights_container_key);
+                    }
+                  }
+
+                } else if (shared_prepacked_weights_cache_ != nullptr &&
+                           node.GetExecutionProviderType() == kCpuExecutionProvider &&
+                           shared_prepacked_weights_cache_->IsCachedOpType(node.Domain(), node.OpType()) &&
+                           !const_initialized_tensor.IsDataTypeString()) {
+                  // Look up the environment level cache before pre-packing. An entry that is found is handed to the
+                  // kernel via UseSerializedPrePackedBuffers() as, unlike UseSharedPrePackedBuffers(), it lets the
+                  // kernel derive the rest of its state from the weight without packing it.
+                  const std::string cache_key = GenerateKeyForSharedPrepackedWeightsCache(node, input_idx,
+                                                                                          const_initialized_tensor);
+                  auto cached_weights = shared_prepacked_weights_cache_->Find(cache_key);
+                  if (cached_weights != nullptr) {
+                    std::vector<BufferUniquePtr> prepacked_buffers;
+                    prepacked_buffers.reserve(cached_weights->buffers_.size());
+                    for (const auto& buffer : cached_weights->buffers_) {
+                      // the kernel doesn't own the buffer
+                      prepacked_buffers.emplace_back(buffer.get(), BufferDeleter(nullptr));
+                    }
+
+                    ORT_RETURN_IF_ERROR(kernel->UseSerializedPrePackedBuffers(const_initialized_tensor, input_idx,
+                                                                              prepacked_buffers,
+                                                                              cached_weights->buffer_sizes_,
+                                                                              is_packed));
+                    if (is_packed) {
+                      LOGS(logger_, INFO) << "Using pre-packed weight from the shared cache for constant initializer: "
+                                          << input_name << " used in the node: " << node.Name()
+                                          << " which is of op type: " << node.OpType();
+                      ++used_shared_pre_packed_weights_counter_;
+                    } else {
+                      cached_weights.reset();
+                    }
+                  }
+
+                  if (!is_packed) {
+                    PrePackedWeights weights_to_be_filled_in;
+                    ORT_RETURN_IF_ERROR(kernel->PrePack(const_initialized_tensor, input_idx,
+                                                        shared_prepacked_weights_cache_->GetAllocator(),
+                                                        is_packed,
+                                                        &weights_to_be_filled_in));
+
+                    // Kernels that didn't hand out their pre-packed buffers keep using their own copy
+                    if (is_packed && !weights_to_be_filled_in.buffers_.empty()) {
+                      bool found_existing = false;
+                      cached_weights = shared_prepacked_weights_cache_->GetOrInsert(cache_key,
+                                                                                    std::move(weights_to_be_filled_in),
+                                                                                    found_existing);
+                      ORT_RETURN_IF_ERROR(KernelUseSharedPrePackedBuffers(*kernel, input_idx, *cached_weights,
+                                                                          node.Name()));
+                      if (found_existing) {
+                        ++used_shared_pre_packed_weights_counter_;
+                      }
+                    }
+                  }
+
+                  if (cached_weights != nullptr) {
+                    if (save_prepacked_initializers_) {
+                      prepacked_weights_to_save_[{node.Index(), input_idx}] = cached_weights.get();
+                    }
+                    shared_prepacked_weights_.push_back(std::move(cached_weights));
+                  }
+
+                } else if (save_prepacked_initializers_ &&
+                           node.GetExecutionProviderType() == kCpuExecutionProvider) {
+                  // Ask the kernel for its pre-packed buffers so they can be serialized when saving the model
+                  AllocatorPtr session_cpu_alloc = GetAllocator(kernel->Info().GetDevice(OrtMemType::OrtMemTypeDefault));
+                  auto weights_to_be_filled_in = std::make_unique<PrePackedWeights>();
+                  ORT_RETURN_IF_ERROR(kernel->PrePack(const_initialized_tensor, input_idx,
+                                                      session_cpu_alloc,
+                                                      is_packed,
+                                                      weights_to_be_filled_in.get()));
+
+                  if (is_packed && !weights_to_be_filled_in->buffers_.empty()) {
+                    ORT_RETURN_IF_ERROR(KernelUseSharedPrePackedBuffers(*kernel, input_idx, *weights_to_be_filled_in,
+                                                                        node.Name()));
+                    prepacked_weights_to_save_[{node.Index(), input_idx}] = weights_to_be_filled_in.get();
+                    owned_prepacked_weights_.push_back(std::move(weights_to_be_filled_in));
                   }
 
                 } else {  // caching of pre-packed weights' turned OFF
@@ -523,14 +810,50 @@ Status SessionState::PrepackConstantInitializedTensors(InlinedHashMap<std::strin
   }
 }
 
-static int64_t CalculateMemoryPatternsKey(const gsl::span<const OrtValue>& tensor_inputs) {
-  int64_t key = 0;
+size_t SessionState::CalculateMemoryPatternsKey(gsl::span<const OrtValue> tensor_inputs) const {
+  size_t key = 0;
   for (const auto& input : tensor_inputs) {
-    for (auto dim : input.Get<Tensor>().Shape().GetDims()) key ^= dim;
+    const auto dims = input.Get<Tensor>().Shape().GetDims();
+    HashCombine(dims.size(), key);
+    for (int64_t dim : dims) {
+      HashCombine(RoundUpToShapeBucket(dim), key);
+    }
   }
   return key;
 }
 
+int64_t SessionState::RoundUpToShapeBucket(int64_t dim) const {
+  if (dim > 0 && mem_pattern_shape_bucket_ < 0) {
+    int64_t bucket = 1;
+    while (bucket < dim) {
+      bucket <<= 1;
+    }
+    return bucket;
+  }
+  if (dim > 0 && mem_pattern_shape_bucket_ > 0) {
+    return (dim + mem_pattern_shape_bucket_ - 1) / mem_pattern_shape_bucket_ * mem_pattern_shape_bucket_;
+  }
+  return dim;
+}
+
+void SessionState::InsertMemoryPatternCacheEntry(size_t key,
+                                                 std::shared_ptr<const MemoryPatternCacheEntry> entry) const {
+  auto index_it = mem_patterns_index_.find(key);
+  if (index_it != mem_patterns_index_.end()) {
+    mem_patterns_.erase(index_it->second);
+    mem_patterns_index_.erase(index_it);
+  }
+
+  mem_patterns_.emplace_front(key, std::move(entry));
+  mem_patterns_index_.insert_or_assign(key, mem_patterns_.begin());
+
+  // cached patterns may still be in use by running execution frames, which hold a reference to them
+  while (mem_pattern_cache_capacity_ != 0 && mem_patterns_.size() > mem_pattern_cache_capacity_) {
+    mem_patterns_index_.erase(mem_patterns_.back().first);
+    mem_patterns_.pop_back();
+  }
+}
+
 #ifdef ENABLE_TRAINING
 namespace {
 Status ResolveDimParams(const GraphViewer& graph,
@@ -765,38 +1088,75 @@ Status SessionState::GeneratePatternGroupCache(gsl::span<const OrtValue> tensor_
 
 #endif
 
-// MemoryPatternGroup pointer is cached. It only inserted upon creation
-// and is not updated if already present.
-const MemoryPatternGroup* SessionState::GetMemoryPatternGroup(
+Status SessionState::ParseMemoryPatternCacheOptions(const SessionOptions& session_options) {
+  const std::string shape_bucket =
+      session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigMemoryPatternShapeBucket, "0");
+  if (shape_bucket == "pow2") {
+    mem_pattern_shape_bucket_ = -1;
+  } else {
+    ORT_RETURN_IF_NOT(TryParseStringWithClassicLocale(shape_bucket, mem_pattern_shape_bucket_) &&
+                          mem_pattern_shape_bucket_ >= 0,
+                      "Invalid value for ", kOrtSessionOptionsConfigMemoryPatternShapeBucket, ": ", shape_bucket);
+  }
+
+  ORT_RETURN_IF_ERROR(ParseStringWithClassicLocale(
+      session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigMemoryPatternCacheSize, "0"),
+      mem_pattern_cache_capacity_));
+
+#ifdef ENABLE_TRAINING
+  // the shapes inferred along with a memory pattern are only valid for the exact input shapes
+  if (mem_pattern_shape_bucket_ != 0) {
+    LOGS(logger_, WARNING) << kOrtSessionOptionsConfigMemoryPatternShapeBucket
+                           << " is not supported in training builds and will be ignored.";
+    mem_pattern_shape_bucket_ = 0;
+  }
+#endif
+
+  return Status::OK();
+}
+
+// MemoryPatternGroup is cached. It is only inserted upon creation, and replaced
+// if a bucketed pattern was too small for a run.
+std::shared_ptr<const MemoryPatternGroup> SessionState::GetMemoryPatternGroup(
     gsl::span<const OrtValue> tensor_inputs,
     gsl::span<const int> feed_mlvalue_idxs,
-    const InlinedHashMap<int, TensorShape>*& out_inferred_shapes) const {
+    std::shared_ptr<const InlinedHashMap<int, TensorShape>>& out_inferred_shapes) const {
   out_inferred_shapes = nullptr;
-  int64_t key = CalculateMemoryPatternsKey(tensor_inputs);
+  const size_t key = CalculateMemoryPatternsKey(tensor_inputs);
   std::lock_guard<OrtMutex> lock(mem_patterns_lock_);
-  auto it = mem_patterns_.find(key);
-  if (it == mem_patterns_.end()) {
+  auto it = mem_patterns_index_.find(key);
+  if (it == mem_patterns_index_.end()) {
 #ifdef ENABLE_TRAINING
-    MemoryPatternGroup mem_patterns;
-    InlinedHashMap<int, TensorShape> inferred_shapes;
-    if (GeneratePatternGroupCache(tensor_inputs, feed_mlvalue_idxs, mem_patterns, inferred_shapes).IsOK()) {
-      auto patt_insert = mem_patterns_.insert_or_assign(key, std::move(mem_patterns));
-      auto ptr = &patt_insert.first->second;
-      auto shape_insert = shape_patterns_.insert_or_assign(key, std::move(inferred_shapes));
-      out_inferred_shapes = &shape_insert.first->second;
-      return ptr;
+    auto entry = std::make_shared<MemoryPatternCacheEntry>();
+    if (GeneratePatternGroupCache(tensor_inputs, feed_mlvalue_idxs, entry->mem_patterns, entry->inferred_shapes)
+            .IsOK()) {
+      InsertMemoryPatternCacheEntry(key, entry);
+      out_inferred_shapes = std::shared_ptr<const InlinedHashMap<int, TensorShape>>(entry, &entry->inferred_shapes);
+      return std::shared_ptr<const MemoryPatternGroup>(entry, &entry->mem_patterns);
     }
 #else
-    ORT_UNUSED_PARAMETER(feed_mlvalue_idxs);
+    // the symbolic pattern can be evaluated for any input shapes, so there's no need to trace a run first.
+    if (symbolic_mem_pattern_planner_) {
+      auto entry = std::make_shared<MemoryPatternCacheEntry>();
+      const auto status = GenerateSymbolicMemoryPatterns(tensor_inputs, feed_mlvalue_idxs, entry->mem_patterns);
+      if (status.IsOK()) {
+        InsertMemoryPatternCacheEntry(key, entry);
+        return std::shared_ptr<const MemoryPatternGroup>(entry, &entry->mem_patterns);
+      }
+      LOGS(logger_, VERBOSE) << "Memory patterns will be traced as the symbolic patterns can't be used: "
+                             << status.ErrorMessage();
+    }
 #endif
     return nullptr;
   }
 
-  auto patt_hit = shape_patterns_.find(key);
-  if (patt_hit != shape_patterns_.cend()) {
-    out_inferred_shapes = &patt_hit->second;
+  // move to the front as the most recently used entry
+  mem_patterns_.splice(mem_patterns_.begin(), mem_patterns_, it->second);
+  const auto& entry = it->second->second;
+  if (!entry->inferred_shapes.empty()) {
+    out_inferred_shapes = std::shared_ptr<const InlinedHashMap<int, TensorShape>>(entry, &entry->inferred_shapes);
   }
-  return &it->second;
+  return std::shared_ptr<const MemoryPatternGroup>(entry, &entry->mem_patterns);
 }
 
 void SessionState::ResolveMemoryPatternFlag() {
@@ -842,16 +1202,150 @@ void SessionState::ResolveMemoryPatternFlag() {
         }
       }
     }
+
+#ifndef ENABLE_TRAINING
+    if (enable_mem_pattern_) {
+      PlanSymbolicMemoryPatterns();
+    }
+#endif
+  }
+}
+
+#ifndef ENABLE_TRAINING
+void SessionState::PlanSymbolicMemoryPatterns() {
+  const auto& exe_plan = *GetExecutionPlan();
+  // the values are allocated and released in the order of the steps only if there is a single stream.
+  if (exe_plan.execution_plan.size() != 1 || exe_plan.HasWorkStealingSchedule()) {
+    return;
+  }
+
+  InlinedVector<const NodeArg*> inputs(graph_viewer_->GetInputs().begin(), graph_viewer_->GetInputs().end());
+  if (graph_viewer_->IsSubgraph()) {
+    for (const auto* implicit_input : graph_viewer_->ParentNode()->ImplicitInputDefs()) {
+      inputs.push_back(implicit_input);
+    }
+  }
+  SymbolicShapeInference shapes(*graph_viewer_, inputs);
+
+  auto planner = std::make_unique<SymbolicMemPatternPlanner>();
+  std::vector<size_t> release_counts;
+  release_counts.reserve(exe_plan.release_actions.size());
+  for (const auto& action : exe_plan.release_actions) {
+    release_counts.push_back(action.ref_count);
+  }
+
+  std::vector<bool> planned_nodes(graph_viewer_->MaxNodeIndex(), false);
+  for (const auto& step : exe_plan.execution_plan[0]->steps_) {
+    const NodeIndex node_index = step->GetNodeIndex();
+    const Node* node = graph_viewer_->GetNode(node_index);
+    if (node == nullptr || planned_nodes[node_index]) {
+      continue;
+    }
+    planned_nodes[node_index] = true;
+
+    // allocate the outputs of the node, then release the values it was the last consumer of.
+    for (const auto* output : node->OutputDefs()) {
+      int ort_value_idx;
+      if (!output->Exists() || !ort_value_name_idx_map_.GetIdx(output->Name(), ort_value_idx).IsOK()) {
+        continue;
+      }
+      const auto& per_alloc_plan = exe_plan.allocation_plan[ort_value_idx];
+      if (per_alloc_plan.alloc_kind != AllocKind::kAllocate || per_alloc_plan.value_type == nullptr ||
+          !per_alloc_plan.value_type->IsTensorType()) {
+        continue;
+      }
+      const auto* element_type = static_cast<const TensorTypeBase*>(per_alloc_plan.value_type)->GetElementType();
+      if (utils::IsDataTypeString(element_type)) {
+        continue;
+      }
+
+      auto size = shapes.GetSize(output->Name());
+      if (size.has_value()) {
+        size = size->Multiply(SymbolicDim(static_cast<int64_t>(element_type->Size())));
+      }
+      if (!size.has_value()) {
+        LOGS(logger_, VERBOSE) << "Memory patterns are not planned from symbolic shapes as the size of "
+                               << output->Name() << " is not known in terms of the input dimensions.";
+        return;
+      }
+      planner->TraceAllocation(ort_value_idx, per_alloc_plan.location, *size);
+    }
+
+    for (size_t action_idx : exe_plan.node_release_list[node_index]) {
+      if (--release_counts[action_idx] == 0) {
+        planner->TraceFree(static_cast<int>(exe_plan.release_actions[action_idx].value_index));
+      }
+    }
+  }
+
+  for (const auto* input : inputs) {
+    int ort_value_idx;
+    const auto* shape = shapes.GetShape(input->Name());
+    if (shape != nullptr && ort_value_name_idx_map_.GetIdx(input->Name(), ort_value_idx).IsOK()) {
+      symbolic_input_shapes_.insert_or_assign(ort_value_idx, *shape);
+    }
+  }
+  num_symbolic_dims_ = shapes.SymbolNames().size();
+  symbolic_mem_pattern_planner_ = std::move(planner);
+}
+
+Status SessionState::GenerateSymbolicMemoryPatterns(gsl::span<const OrtValue> tensor_inputs,
+                                                    gsl::span<const int> feed_mlvalue_idxs,
+                                                    MemoryPatternGroup& output) const {
+  // bind the symbols to the dimensions of the inputs, rounded up to their bucket, as the pattern is cached for it.
+  std::vector<int64_t> symbol_values(num_symbolic_dims_, 0);
+  for (size_t i = 0, end = feed_mlvalue_idxs.size(); i < end; ++i) {
+    auto it = symbolic_input_shapes_.find(feed_mlvalue_idxs[i]);
+    if (it == symbolic_input_shapes_.end()) {
+      continue;
+    }
+    const auto dims = tensor_inputs[i].Get<Tensor>().Shape().GetDims();
+    ORT_RETURN_IF(dims.size() != it->second.size(), "The rank of an input differs from its declared rank.");
+    for (size_t d = 0; d < dims.size(); ++d) {
+      const auto& dim = it->second[d];
+      if (dim.has_value() && dim->Coefficient() == 1 && dim->Symbols().size() == 1) {
+        int64_t& value = symbol_values[dim->Symbols()[0]];
+        const int64_t bucket = RoundUpToShapeBucket(dims[d]);
+        ORT_RETURN_IF(value != 0 && value != bucket, "Inconsistent values of a symbolic dimension.");
+        value = bucket;
+      }
+    }
+  }
+
+  // the other dimensions must be consistent with the symbols.
+  for (size_t i = 0, end = feed_mlvalue_idxs.size(); i < end; ++i) {
+    auto it = symbolic_input_shapes_.find(feed_mlvalue_idxs[i]);
+    if (it == symbolic_input_shapes_.end()) {
+      continue;
+    }
+    const auto dims = tensor_inputs[i].Get<Tensor>().Shape().GetDims();
+    for (size_t d = 0; d < dims.size(); ++d) {
+      const auto& dim = it->second[d];
+      int64_t value = 0;
+      if (dim.has_value() && dim->Evaluate(symbol_values, value)) {
+        ORT_RETURN_IF(UseMemoryPatternShapeBuckets() ? value < dims[d] : value != dims[d],
+                      "An input dimension doesn't match its symbolic dimension.");
+      }
+    }
   }
+
+  return symbolic_mem_pattern_planner_->GeneratePatterns(symbol_values, output);
 }
+#endif
 
 Status SessionState::UpdateMemoryPatternGroupCache(gsl::span<const OrtValue> tensor_inputs,
                                                    MemoryPatternGroup mem_patterns) const {
-  int64_t key = CalculateMemoryPatternsKey(tensor_inputs);
+  const size_t key = CalculateMemoryPatternsKey(tensor_inputs);
 
   std::lock_guard<OrtMutex> lock(mem_patterns_lock_);
-  // Do not update if present, as the pointer to the existing one is cached
-  mem_patterns_.emplace(key, std::move(mem_patterns));
+  // Do not update if present unless the patterns are bucketed, in which case the new pattern was generated
+  // because the existing one was too small for the shapes of a run
+  if (UseMemoryPatternShapeBuckets() || mem_patterns_index_.find(key) == mem_patterns_index_.end()) {
+    auto entry = std::make_shared<MemoryPatternCacheEntry>();
+    entry->mem_patterns = std::move(mem_patterns);
+    InsertMemoryPatternCacheEntry(key, std::move(entry));
+  }
+
   return Status::OK();
 }
 
@@ -1047,7 +1541,8 @@ Status SessionState::CreateSubgraphSessionState() {
           std::make_unique<SessionState>(*subgraph, execution_providers_,
                                          thread_pool_, inter_op_thread_pool_, data_transfer_mgr_,
                                          logger_, profiler_, sess_options_,
-                                         prepacked_weights_container_, allocators_);
+                                         prepacked_weights_container_, allocators_,
+                                         shared_prepacked_weights_cache_);
 
       // Pass fused function manager to subgraph
       subgraph_session_state->fused_funcs_mgr_.SetFusedFuncs(fused_funcs_mgr_);
@@ -1184,6 +1679,11 @@ Status SessionState::FinalizeSessionState(const std::basic_string<PATH_CHAR_TYPE
   ORT_RETURN_IF_ERROR(VerifyEachNodeIsAssignedToAnEp(graph_, logger_, execution_providers_));
   ORT_RETURN_IF_ERROR(PopulateKernelCreateInfo(kernel_registry_manager, saving_ort_format));
 
+  // pre-packed weights are only saved for the main graph
+  save_prepacked_initializers_ =
+      saving_ort_format &&
+      sess_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigSavePrePackedInitializers, "0") == "1";
+
   InlinedHashMap<std::string, size_t> constant_initializers_use_count;
   ComputeConstantInitializerUseCount(graph_, constant_initializers_use_count);
   return FinalizeSessionStateImpl(graph_location, kernel_registry_manager, nullptr, sess_options_,
@@ -1327,6 +1827,8 @@ Status SessionState::FinalizeSessionStateImpl(const std::basic_string<PATH_CHAR_
     CreateGraphInfo();
   }
 
+  ORT_RETURN_IF_ERROR(ParseMemoryPatternCacheOptions(session_options));
+
 #if defined(ORT_EXTENDED_MINIMAL_BUILD)
   // Remove any unused initializers.
   // Not needed in a full build because unused initializers should have been removed earlier by Graph::Resolve().
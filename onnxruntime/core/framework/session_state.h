@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <list>
 #include <memory>
 #include <map>
 #include <unordered_map>
@@ -23,6 +24,7 @@
 #include "core/framework/stream_execution_context.h"
 #include "core/framework/feeds_fetches_manager.h"
 #include "core/framework/framework_common.h"
+#include "core/framework/prepacked_weights_cache.h"
 #include "core/framework/prepacked_weights_container.h"
 #include "core/framework/fuse_nodes_funcs.h"
 #include "core/framework/kernel_registry_manager.h"
@@ -43,12 +45,16 @@
 #include "core/framework/stream_handles.h"
 #ifdef ENABLE_TRAINING
 #include "core/framework/program_region.h"
+#else
+#include "core/framework/symbolic_mem_pattern_planner.h"
 #endif
 
 namespace onnxruntime {
 
 namespace fbs {
 struct SessionState;
+struct PrePackedInitializer;
+struct PrePackedInitializers;
 }  // namespace fbs
 
 class ExecutionProviders;
@@ -96,7 +102,8 @@ class SessionState {
                profiling::Profiler& profiler,
                const SessionOptions& sess_options,
                PrepackedWeightsContainer* prepacked_weights_container = nullptr,
-               AllocatorMap* parent_allocators = nullptr);
+               AllocatorMap* parent_allocators = nullptr,
+               SharedPrepackedWeightsCache* shared_prepacked_weights_cache = nullptr);
 
   ~SessionState() {
     for (auto& kvp : deleter_for_initialized_tensors_) {
@@ -214,25 +221,31 @@ class SessionState {
   /**
   Get cached memory pattern based on input shapes
   Must be called only when all values contain tensors
-  In training scenarios, the cache may be updated so
-  the callers would receive a copy of inferred shapes
-  made under mutex being held. In inference scenarios,
-  it is not mutable, we do not obtain a lock and simply get a pointer
-  w/o copying a hashtable
+  The input shapes are rounded up to their bucket if shape buckets are enabled.
+  The returned pattern and inferred shapes stay valid while the caller holds them,
+  even if the cache entry is evicted or replaced in the meantime.
   */
-  const MemoryPatternGroup* GetMemoryPatternGroup(
+  std::shared_ptr<const MemoryPatternGroup> GetMemoryPatternGroup(
       gsl::span<const OrtValue> tensor_inputs,
       gsl::span<const int> feed_mlvalue_idxs,
-      const InlinedHashMap<int, TensorShape>*& inferred_shapes) const;
+      std::shared_ptr<const InlinedHashMap<int, TensorShape>>& inferred_shapes) const;
 
   /**
   Set generated memory pattern with a given input shapes.
   Const as it's an internal cache update only.
   All inputs must represent Tensors
+  An existing pattern is only replaced if shape buckets are enabled, as the new pattern
+  was generated because the cached one was too small for the shapes of a run.
   */
   Status UpdateMemoryPatternGroupCache(gsl::span<const OrtValue> tensor_inputs,
                                        MemoryPatternGroup mem_patterns) const;
 
+  /**
+  Whether memory patterns are cached per bucket of input shapes rather than per exact input shapes.
+  If so, a cached pattern may be used for a run if its blocks are large enough.
+  */
+  bool UseMemoryPatternShapeBuckets() const { return mem_pattern_shape_bucket_ != 0; }
+
   bool GetUseDeterministicCompute() const { return sess_options_.use_deterministic_compute; }
 
   /**
@@ -249,6 +262,8 @@ class SessionState {
   /**
   Update enable_mem_pattern_ flag according to the presence of graph inputs' shape
   If any one of the graph input is shapeless, enable_mem_pattern_ will be set to false
+  If memory patterns remain enabled, they are planned in terms of the symbolic dimensions of the inputs where
+  possible, so the pattern for new input shapes doesn't need a traced run.
   */
   void ResolveMemoryPatternFlag();
 
@@ -323,6 +338,28 @@ class SessionState {
     return used_shared_pre_packed_weights_counter_;
   }
 
+  size_t GetUsedSerializedPrePackedWeightCounter() const {
+    return used_serialized_pre_packed_weights_counter_;
+  }
+
+#if !defined(ORT_MINIMAL_BUILD)
+  // Serialize the pre-packed weights of the kernels in the main graph that were recorded by FinalizeSessionState
+  // when saving an ORT format model with kOrtSessionOptionsConfigSavePrePackedInitializers enabled.
+  // fbs_prepacked_initializers is left as a null offset if there is nothing to save.
+  Status SavePrePackedInitializersToOrtFormat(
+      flatbuffers::FlatBufferBuilder& builder,
+      flatbuffers::Offset<fbs::PrePackedInitializers>& fbs_prepacked_initializers) const;
+#endif  // !defined(ORT_MINIMAL_BUILD)
+
+  // Use the pre-packed weights serialized in an ORT format model instead of pre-packing the constant initializers
+  // of the main graph in FinalizeSessionState. They are ignored if they were produced for a different MLAS packed
+  // buffer format version or instruction set.
+  // If can_use_flatbuffer_for_buffers is true, the kernels use the serialized bytes directly when they are suitably
+  // aligned, so the flatbuffer must outlive this instance. Otherwise it must only remain valid until
+  // FinalizeSessionState returns.
+  void SetPrePackedInitializersFromOrtFormat(const fbs::PrePackedInitializers& fbs_prepacked_initializers,
+                                             bool can_use_flatbuffer_for_buffers);
+
   const KernelCreateInfoMap& GetKernelCreateInfoMap() const {
     return kernel_create_info_map_;
   }
@@ -371,6 +408,10 @@ class SessionState {
    * Prepack the constant initialized tensors for better performance.
    * The original constant initialized tensors will be removed to save memory.
    */
+  // Give the kernel the pre-packed weights serialized in the ORT format model for the given input if there are any.
+  Status UseSerializedPrePackedWeights(OpKernel& kernel, NodeIndex node_index, int input_idx,
+                                       const Tensor& tensor, /*out*/ bool& used_serialized_prepacked_weights);
+
   Status PrepackConstantInitializedTensors(InlinedHashMap<std::string, size_t>& constant_initializers_use_count,
                                            const std::unordered_map<std::string, const OrtValue*>& initializers_to_share_map);
 
@@ -399,6 +440,14 @@ class SessionState {
       gsl::span<const int> feed_mlvalue_idxs,
       MemoryPatternGroup& output,
       InlinedHashMap<int, TensorShape>& inferred_shapes) const;
+#else
+  // Plans the memory patterns with the sizes of the values in terms of the symbolic dimensions of the inputs.
+  // Nothing is planned if the execution order of the nodes is not fixed, or the size of a value is not known.
+  void PlanSymbolicMemoryPatterns();
+
+  Status GenerateSymbolicMemoryPatterns(gsl::span<const OrtValue> tensor_inputs,
+                                        gsl::span<const int> feed_mlvalue_idxs,
+                                        MemoryPatternGroup& output) const;
 #endif
 
   // KernelCreateInfo for each node so we do kernel lookup once
@@ -483,17 +532,44 @@ class SessionState {
   // switch for enable memory pattern optimization or not.
   bool enable_mem_pattern_;
 
+  // Memory pattern cached for a set of input shapes, and the shapes inferred
+  // when generating it in training scenarios.
+  struct MemoryPatternCacheEntry {
+    MemoryPatternGroup mem_patterns;
+    InlinedHashMap<int, TensorShape> inferred_shapes;
+  };
+  using MemoryPatternCacheList = std::list<std::pair<size_t, std::shared_ptr<const MemoryPatternCacheEntry>>>;
+
+  Status ParseMemoryPatternCacheOptions(const SessionOptions& session_options);
+
+  size_t CalculateMemoryPatternsKey(gsl::span<const OrtValue> tensor_inputs) const;
+
+  int64_t RoundUpToShapeBucket(int64_t dim) const;
+
+  // Insert an entry at the front of the cache and evict the least recently used entries above the capacity.
+  // mem_patterns_lock_ must be held.
+  void InsertMemoryPatternCacheEntry(size_t key, std::shared_ptr<const MemoryPatternCacheEntry> entry) const;
+
   // lock for the mem_patterns_
   mutable OrtMutex mem_patterns_lock_;
-  // cache for the generated mem_patterns. key is calculated based on input shapes.
-  // must be a node based container as a pointer is cached.
-  mutable NodeHashMap<int64_t, MemoryPatternGroup> mem_patterns_;
-  // This is mutable under mutex in training scenarios so execution frame would make a copy
-  // of the value when created.
-#ifdef ENABLE_TRAINING
-  mutable NodeHashMap<int64_t, InlinedHashMap<int, TensorShape>> shape_patterns_;
-#else
-  NodeHashMap<int64_t, InlinedHashMap<int, TensorShape>> shape_patterns_;
+  // LRU cache for the generated mem_patterns, most recently used first. key is calculated based on input shapes.
+  mutable MemoryPatternCacheList mem_patterns_;
+  mutable InlinedHashMap<size_t, MemoryPatternCacheList::iterator> mem_patterns_index_;
+
+  // Input dimensions are rounded up to a bucket when looking up memory patterns.
+  // No kernel state is cached per bucket, as kernels are created once per session and any shape
+  // dependent choices they make at run time need the exact input dimensions.
+  // 0 uses the exact dimensions, -1 rounds up to a power of 2 and N > 0 rounds up to a multiple of N.
+  int64_t mem_pattern_shape_bucket_{0};
+  // Maximum number of cached memory patterns. 0 means no limit.
+  size_t mem_pattern_cache_capacity_{0};
+
+#ifndef ENABLE_TRAINING
+  // Memory patterns planned by PlanSymbolicMemoryPatterns. nullptr if they couldn't be planned.
+  std::unique_ptr<SymbolicMemPatternPlanner> symbolic_mem_pattern_planner_;
+  // The symbolic shapes of the inputs, including the implicit inputs of a subgraph, keyed by OrtValue index.
+  InlinedHashMap<int, SymbolicShape> symbolic_input_shapes_;
+  size_t num_symbolic_dims_{0};
 #endif
 
   NameNodeInfoMapType input_names_to_nodeinfo_mapping_;
@@ -517,6 +593,29 @@ class SessionState {
   // prepacked_weights_container_ can be nullptr if no caching is required for prepacked weights
   PrepackedWeightsContainer* const prepacked_weights_container_{};
 
+  // Environment level cache of pre-packed weights that de-duplicates identical pre-packed weights of the
+  // op types it supports across all sessions in the process. Can be nullptr if the cache is disabled.
+  SharedPrepackedWeightsCache* const shared_prepacked_weights_cache_{};
+
+  // References to the entries of shared_prepacked_weights_cache_ used by the kernels in this session state.
+  // Holding them keeps the entries alive while the kernels use them.
+  std::vector<std::shared_ptr<const PrePackedWeights>> shared_prepacked_weights_;
+
+  // Whether to record the pre-packed weights of the kernels so they can be saved in an ORT format model.
+  bool save_prepacked_initializers_ = false;
+
+  // The pre-packed weights recorded for saving keyed on node index and input index. The buffers are owned by
+  // prepacked_weights_container_, shared_prepacked_weights_ or owned_prepacked_weights_.
+  std::map<std::pair<NodeIndex, int>, const PrePackedWeights*> prepacked_weights_to_save_;
+
+  // The pre-packed weights serialized in the ORT format model this instance was loaded from.
+  std::map<std::pair<NodeIndex, int>, const fbs::PrePackedInitializer*> serialized_prepacked_initializers_;
+  bool can_use_flatbuffer_for_prepacked_buffers_ = false;
+
+  // Pre-packed weights owned by this instance that the kernels use via UseSharedPrePackedBuffers or
+  // UseSerializedPrePackedBuffers.
+  std::vector<std::unique_ptr<PrePackedWeights>> owned_prepacked_weights_;
+
 #ifdef ENABLE_TRAINING
 // Needed for ORTTrainer. Should be removed along with ORTTrainer code
 #ifndef DISABLE_ABSEIL
@@ -547,6 +646,9 @@ class SessionState {
   // a constant initialized weight was used by the session state
   size_t used_shared_pre_packed_weights_counter_ = 0;
 
+  // Counter for number of times pre-packed weights serialized in the ORT format model were used by kernels.
+  size_t used_serialized_pre_packed_weights_counter_ = 0;
+
 #ifdef DEBUG_NODE_INPUTS_OUTPUTS
   // Counter for number of times the session graph has been executed
   size_t graph_executions_counter_ = 0;
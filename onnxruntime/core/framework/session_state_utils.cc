@@ -33,6 +33,10 @@
 namespace onnxruntime {
 namespace session_state_utils {
 
+// Minimum alignment of external data in its file for it to be used in place with
+// kOrtSessionOptionsUseMmapForExternalInitializers. Matches the widest SIMD loads done by MLAS.
+static constexpr size_t kMinMappedInitializerAlignment = 64;
+
 // The following method will allocate memory directly using the device allocator.
 // It can handle arena-based allocators and non-arena based allocators.
 static common::Status AllocateBufferUsingDeviceAllocatorFromShapeAndType(const TensorShape& tensor_shape, const DataTypeImpl* type,
@@ -93,11 +97,29 @@ static inline common::Status ExtDataTensorProtoToTensor(const Env& env,
   return common::Status::OK();
 }
 
+// given a tensor proto with external data create an OrtValue whose tensor points directly at the mmap'd data.
+// nothing is allocated for the tensor data, the mapping is released when the OrtValue is.
+static common::Status ExtDataTensorProtoToOrtValue(const Env& env,
+                                                   const std::basic_string<PATH_CHAR_TYPE>& proto_path,
+                                                   const ONNX_NAMESPACE::TensorProto& tensor_proto,
+                                                   OrtValue& ort_value) {
+  auto p_tensor = std::make_unique<Tensor>();
+  OrtCallback ext_data_deleter;
+  ORT_RETURN_IF_ERROR(ExtDataTensorProtoToTensor(env, proto_path, tensor_proto, *p_tensor, ext_data_deleter));
+
+  ExtDataValueDeleter deleter{ext_data_deleter, p_tensor.get()};
+
+  MLDataType ml_tensor_type = DataTypeImpl::GetType<Tensor>();
+  ort_value.Init(p_tensor.release(), ml_tensor_type, deleter);
+  return common::Status::OK();
+}
+
 static common::Status DeserializeTensorProto(const Env& env, const std::basic_string<PATH_CHAR_TYPE>& proto_path,
                                              const ONNX_NAMESPACE::TensorProto& tensor_proto, const MemBuffer* m,
                                              const AllocatorPtr& alloc, const AllocatorPtr& default_cpu_alloc,
                                              OrtValue& ort_value, const DataTransferManager& data_transfer_mgr,
-                                             bool use_device_allocator_for_initializers = false) {
+                                             bool use_device_allocator_for_initializers = false,
+                                             bool map_external_data = true) {
   if (bool(alloc) == (m != nullptr)) {
     return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
                   "DeserializeTensorProto() takes either pre-allocated buffer or an allocator!");
@@ -128,18 +150,11 @@ static common::Status DeserializeTensorProto(const Env& env, const std::basic_st
 
   if (p_tensor->Location().device.Type() == OrtDevice::CPU) {
     // deserialize directly to CPU tensor
-    if (utils::HasExternalData(tensor_proto)) {
+    if (utils::HasExternalData(tensor_proto) && map_external_data) {
       // NB: The file containing external data for the tensor is mmap'd. If the tensor will be used on CPU we can
-      // utilize the mmap'd buffer directly by calling ExtDataTensorProtoToTensor. If we called
+      // utilize the mmap'd buffer directly by calling ExtDataTensorProtoToOrtValue. If we called
       // TensorProtoToTensor it would copy the data, causing unnecessary overhead
-      OrtCallback ext_data_deleter;
-      ORT_RETURN_IF_ERROR(ExtDataTensorProtoToTensor(env, proto_path, tensor_proto, *p_tensor, ext_data_deleter));
-
-      ExtDataValueDeleter deleter{ext_data_deleter, p_tensor.get()};
-
-      MLDataType ml_tensor_type = DataTypeImpl::GetType<Tensor>();
-      ort_value.Init(p_tensor.release(), ml_tensor_type, deleter);
-      return common::Status::OK();
+      return ExtDataTensorProtoToOrtValue(env, proto_path, tensor_proto, ort_value);
     }
     ORT_RETURN_IF_ERROR(utils::TensorProtoToTensor(env, proto_path.c_str(), tensor_proto, *p_tensor));
   } else {  // non-cpu tensor
@@ -230,6 +245,22 @@ common::Status SaveInitializedTensors(
     return retval;
   };
 
+  // With kOrtSessionOptionsUseMmapForExternalInitializers only external data that is suitably aligned in its file
+  // is used in place. Anything else is copied into a planned buffer so kernels never see misaligned weights.
+  const bool use_mmap_for_external_initializers =
+      session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsUseMmapForExternalInitializers, "0") == "1";
+
+  // Returns true if the initializer will be backed by its mmap'd external data rather than a buffer of its own.
+  auto maps_external_data = [&exec_plan, use_mmap_for_external_initializers](
+                                int ort_value_index, const ONNX_NAMESPACE::TensorProto& tensor_proto) -> bool {
+    if (!utils::HasExternalData(tensor_proto) || exec_plan.GetLocation(ort_value_index).Type() != OrtDevice::CPU) {
+      return false;
+    }
+
+    return !use_mmap_for_external_initializers ||
+           utils::HasAlignedExternalData(tensor_proto, kMinMappedInitializerAlignment);
+  };
+
   // 1. first plan the memory
   const InitializedTensorSet& initialized_tensor_set = graph.GetAllInitializedTensors();
   InlinedHashMap<int, const ONNX_NAMESPACE::TensorProto*> id_to_initialized_tensor;
@@ -256,7 +287,7 @@ common::Status SaveInitializedTensors(
     const auto entry = initialized_tensors_to_allocate.find(ort_value_index);
     ORT_ENFORCE(entry != initialized_tensors_to_allocate.end(),
                 "OrtValue index: ", ort_value_index, " from initializer_allocation_order not found among initialized tensors");
-    if (!(utils::HasExternalData(*entry->second) && exec_plan.GetLocation(ort_value_index).Type() == OrtDevice::CPU)) {
+    if (!maps_external_data(ort_value_index, *entry->second)) {
       // can not trace string tensor
       ORT_ENFORCE(entry->second->data_type() != ONNX_NAMESPACE::TensorProto_DataType_STRING, "Can not trace string tensor");
       ORT_RETURN_IF_ERROR(planner.Trace(entry->first, entry->second));
@@ -273,6 +304,10 @@ common::Status SaveInitializedTensors(
       // do not trace string tensor
       continue;
     }
+    // nothing needs to be allocated for initializers that stay mmap'd
+    if (use_mmap_for_external_initializers && maps_external_data(entry.first, *entry.second)) {
+      continue;
+    }
     ORT_RETURN_IF_ERROR(planner.Trace(entry.first, entry.second));
   }
   // 2. allocate weight buffer on different locations
@@ -307,6 +342,13 @@ common::Status SaveInitializedTensors(
     if (user_supplied_initializer_ids.find(entry.first) != user_supplied_initializer_ids.end()) {
       ort_value = *(session_options.initializers_to_share_map.at(name));
       LOGS(logger, INFO) << "Using user supplied initializer with name (" << name << ").";
+    } else if (use_mmap_for_external_initializers && maps_external_data(ort_value_index, *entry.second)) {
+      Status st = ExtDataTensorProtoToOrtValue(env, graph_loc, *entry.second, ort_value);
+      if (!st.IsOK()) {
+        std::ostringstream oss;
+        oss << "Mapping external data of tensor " << name << " failed." << st.ErrorMessage();
+        return Status(st.Category(), st.Code(), oss.str());
+      }
     } else {
       const ONNX_NAMESPACE::TensorProto& tensor_proto = *(entry.second);
 
@@ -319,7 +361,8 @@ common::Status SaveInitializedTensors(
 
       Status st = DeserializeTensorProto(env, graph_loc, tensor_proto, (m.has_value()) ? &*m : nullptr, alloc,
                                          default_cpu_alloc, ort_value, data_transfer_mgr,
-                                         use_device_allocator_for_initializers);
+                                         use_device_allocator_for_initializers,
+                                         maps_external_data(ort_value_index, tensor_proto));
       if (!st.IsOK()) {
         std::ostringstream oss;
         oss << "Deserialize tensor " << name << " failed." << st.ErrorMessage();
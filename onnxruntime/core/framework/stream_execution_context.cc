@@ -4,10 +4,33 @@
 #include "core/framework/execution_provider.h"
 #include "core/framework/execution_frame.h"
 #include "core/framework/bfc_arena.h"
+#include "core/framework/sequential_executor.h"
 #include "core/framework/session_state.h"
 #include "core/common/spin_pause.h"
 
 namespace onnxruntime {
+
+static void InitializeNodePendingProducers(const SessionState& sess_state, bool single_thread_mode,
+                                           std::unique_ptr<std::atomic_int[]>& node_pending_producers) {
+  const auto* plan = sess_state.GetExecutionPlan();
+  if (single_thread_mode || !plan->HasWorkStealingSchedule()) {
+    return;
+  }
+
+  const auto& node_num_producers = plan->node_num_producers;
+#ifdef _WIN32
+#pragma warning(push)
+#pragma warning(disable : 26409 26400)
+#endif
+  node_pending_producers = std::unique_ptr<std::atomic_int[]>(new std::atomic_int[node_num_producers.size()]);
+#ifdef _WIN32
+#pragma warning(pop)
+#endif
+  for (size_t i = 0; i < node_num_producers.size(); ++i) {
+    node_pending_producers[i] = node_num_producers[i];
+  }
+}
+
 #ifdef ORT_ENABLE_STREAM
 StreamExecutionContext::StreamExecutionContext(const SessionState& sess_state,
                                                int32_t num_streams,
@@ -62,6 +85,7 @@ StreamExecutionContext::StreamExecutionContext(const SessionState& sess_state,
   for (size_t i = 0; i < release_actions.size(); ++i) {
     release_plan_[i] = static_cast<int>(release_actions[i].ref_count);
   }
+  InitializeNodePendingProducers(sess_state, single_thread_mode, node_pending_producers_);
 }
 
 synchronize::Notification* StreamExecutionContext ::GetNotification(size_t idx) { return notifications_[idx].get(); }
@@ -114,6 +138,7 @@ StreamExecutionContext::StreamExecutionContext(const SessionState& sess_state,
   for (size_t i = 0; i < release_actions.size(); ++i) {
     release_plan_[i] = static_cast<int>(release_actions[i].ref_count);
   }
+  InitializeNodePendingProducers(sess_state, single_thread_mode, node_pending_producers_);
 }
 
 synchronize::Notification* StreamExecutionContext ::GetNotification(size_t /*idx*/) {
@@ -173,6 +198,10 @@ void StreamExecutionContext::RecycleNodeInputs(onnxruntime::NodeIndex node_index
   }
 }
 
+bool StreamExecutionContext::DecPendingProducers(onnxruntime::NodeIndex node_index) {
+  return --node_pending_producers_[node_index] == 0;
+}
+
 void RunSince(size_t stream_idx, StreamExecutionContext& ctx, SessionScope& session_scope, const bool& terminate_flag, size_t since) {
   if (!ctx.TaskStatus().IsOK()) {
     // already in bad status, terminate it
@@ -242,6 +271,75 @@ void RunSince(size_t stream_idx, StreamExecutionContext& ctx, SessionScope& sess
   return;
 }
 
+void RunNodesSince(StreamExecutionContext& ctx, SessionScope& session_scope, const bool& terminate_flag,
+                   onnxruntime::NodeIndex node_index) {
+  const auto* plan = ctx.GetSessionState().GetExecutionPlan();
+  auto* tp = ctx.GetSessionState().GetInterOpThreadPool();
+
+  // all the nodes of the plan run on the single CPU stream
+  constexpr size_t stream_idx = 0;
+
+  for (;;) {
+    if (!ctx.TaskStatus().IsOK()) {
+      // already in bad status, terminate it
+      break;
+    }
+    if (terminate_flag) {
+      Status status_made = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Exiting due to terminate flag being set to true.");
+      ctx.SetStatus(status_made);
+      break;
+    }
+
+    Status status;
+#ifdef ENABLE_TRAINING
+    // legacy code required by ORTTrainer. Should be removed when ORTTrainer is removed
+    auto* node_to_execute = ctx.GetNodeToExecute();
+    if (!node_to_execute || node_to_execute->count(node_index) > 0)
+#endif
+    {
+      ORT_TRY {
+        status = ExecuteKernel(ctx, node_index, stream_idx, terminate_flag, session_scope);
+      }
+      ORT_CATCH(const std::exception& ex) {
+        ORT_HANDLE_EXCEPTION([&]() {
+          status = ORT_MAKE_STATUS(ONNXRUNTIME, RUNTIME_EXCEPTION, ex.what());
+        });
+      }
+    }
+    if (!status.IsOK()) {
+      ctx.SetStatus(status);
+      break;
+    }
+
+    // continue with the first consumer that became ready, and hand the others to the thread pool
+    bool has_next = false;
+    onnxruntime::NodeIndex next_node_index = 0;
+    for (auto consumer : plan->node_consumers[node_index]) {
+      if (!ctx.DecPendingProducers(consumer)) {
+        continue;
+      }
+
+      if (!has_next) {
+        has_next = true;
+        next_node_index = consumer;
+      } else {
+        // increase the task count before scheduling the consumer
+        ctx.AddTask();
+        concurrency::ThreadPool::Schedule(tp, [&ctx, &session_scope, &terminate_flag, consumer]() {
+          RunNodesSince(ctx, session_scope, terminate_flag, consumer);
+        });
+      }
+    }
+
+    if (!has_next) {
+      break;
+    }
+    node_index = next_node_index;
+  }
+
+  ctx.CompleteTask();
+}
+
 void ScheduleDownstream(StreamExecutionContext& ctx, size_t trigger, bool single_thread_mode,
                         const bool& terminate_flag, SessionScope& session_scope) {
   auto* plan = ctx.GetSessionState().GetExecutionPlan();
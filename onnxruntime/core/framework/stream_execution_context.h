@@ -116,6 +116,10 @@ class StreamExecutionContext {
   // Release the OrtValues after a step, based on the execution plan.
   void RecycleNodeInputs(onnxruntime::NodeIndex node_index);
 
+  // Decrease the number of producers a node is waiting on by 1.
+  // Returns true if the node is ready to run.
+  bool DecPendingProducers(onnxruntime::NodeIndex node_index);
+
 #ifdef ENABLE_TRAINING
   void SetOrtValueCache(OrtValueCachePtr cache) {
     cache_ = std::move(cache);
@@ -156,6 +160,9 @@ class StreamExecutionContext {
 
   std::unique_ptr<std::atomic_int[]> release_plan_;
 
+  // number of producers each node is still waiting on. nullptr if the work-stealing schedule isn't used.
+  std::unique_ptr<std::atomic_int[]> node_pending_producers_;
+
   CountDownBarrier remain_tasks_;
 
   Status task_status_{Status::OK()};
@@ -189,6 +196,15 @@ void RunSince(size_t stream_idx,
               const bool& terminate_flag,
               size_t since);
 
+// Execute the node at 'node_index' with execution context 'ctx' using the work-stealing schedule of the plan,
+// followed by the nodes that become ready once it completes. The first of them keeps running on the current
+// thread so it can consume the outputs while they are hot in the cache. The others are scheduled on the inter-op
+// thread pool where idle workers pick them up.
+void RunNodesSince(StreamExecutionContext& ctx,
+                   SessionScope& session_scope,
+                   const bool& terminate_flag,
+                   onnxruntime::NodeIndex node_index);
+
 // Schedule the downstream jobs from other streams at 'trigger' step, based on the execution plan.
 void ScheduleDownstream(StreamExecutionContext& ctx,
                         size_t trigger,
@@ -0,0 +1,121 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/symbolic_mem_pattern_planner.h"
+
+#include <limits>
+
+#include "core/framework/allocator.h"
+
+namespace onnxruntime {
+
+void SymbolicMemPatternPlanner::TraceAllocation(int ort_value_idx, const OrtDevice& location,
+                                                const SymbolicDim& size) {
+  size_t location_idx = 0;
+  while (location_idx < locations_.size() && !(locations_[location_idx].device == location)) {
+    ++location_idx;
+  }
+  if (location_idx == locations_.size()) {
+    locations_.push_back(Location{location, {}});
+  }
+  auto& slots = locations_[location_idx].slots;
+
+  // Prefer a slot that is large enough for the value over one that has to grow, and among those the one closest
+  // to the size of the value.
+  size_t best = slots.size();
+  bool best_fits = false;
+  size_t best_degree_diff = 0;
+  int64_t best_coefficient_diff = 0;
+  for (size_t i = 0; i < slots.size(); ++i) {
+    const Slot& slot = slots[i];
+    if (slot.in_use) {
+      continue;
+    }
+    const bool fits = size.IsBoundedBy(slot.size);
+    if (!fits && !slot.size.IsBoundedBy(size)) {
+      continue;
+    }
+    const SymbolicDim& larger = fits ? slot.size : size;
+    const SymbolicDim& smaller = fits ? size : slot.size;
+    const size_t degree_diff = larger.Symbols().size() - smaller.Symbols().size();
+    const int64_t coefficient_diff = larger.Coefficient() - smaller.Coefficient();
+    if (best == slots.size() || (fits && !best_fits) ||
+        (fits == best_fits && (degree_diff < best_degree_diff ||
+                               (degree_diff == best_degree_diff && coefficient_diff < best_coefficient_diff)))) {
+      best = i;
+      best_fits = fits;
+      best_degree_diff = degree_diff;
+      best_coefficient_diff = coefficient_diff;
+    }
+  }
+
+  if (best == slots.size()) {
+    slots.push_back(Slot{size, false});
+  } else if (!best_fits) {
+    // the previous values of the slot are bounded by its size, so they are bounded by the new size as well.
+    slots[best].size = size;
+  }
+  slots[best].in_use = true;
+  values_.insert_or_assign(ort_value_idx, Value{location_idx, best, size});
+}
+
+void SymbolicMemPatternPlanner::TraceFree(int ort_value_idx) {
+  auto it = values_.find(ort_value_idx);
+  if (it != values_.end()) {
+    locations_[it->second.location].slots[it->second.slot].in_use = false;
+  }
+}
+
+size_t SymbolicMemPatternPlanner::NumSlots() const {
+  size_t num_slots = 0;
+  for (const auto& location : locations_) {
+    num_slots += location.slots.size();
+  }
+  return num_slots;
+}
+
+namespace {
+Status EvaluateAlignedSize(const SymbolicDim& size, gsl::span<const int64_t> symbol_values, size_t& aligned_size) {
+  int64_t value = 0;
+  if (!size.Evaluate(symbol_values, value) ||
+      static_cast<uint64_t>(value) > std::numeric_limits<size_t>::max() ||
+      !IAllocator::CalcMemSizeForArrayWithAlignment<kAllocAlignment>(static_cast<size_t>(value), 1, &aligned_size)) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Size overflow");
+  }
+  return Status::OK();
+}
+}  // namespace
+
+Status SymbolicMemPatternPlanner::GeneratePatterns(gsl::span<const int64_t> symbol_values,
+                                                   MemoryPatternGroup& out) const {
+  for (int64_t value : symbol_values) {
+    ORT_RETURN_IF_NOT(value > 0, "Symbolic dimensions must be positive. Got ", value);
+  }
+
+  MemoryPatternGroup group;
+  std::vector<std::vector<size_t>> offsets(locations_.size());
+  for (size_t i = 0; i < locations_.size(); ++i) {
+    size_t offset = 0;
+    offsets[i].reserve(locations_[i].slots.size());
+    for (const auto& slot : locations_[i].slots) {
+      size_t slot_size = 0;
+      ORT_RETURN_IF_ERROR(EvaluateAlignedSize(slot.size, symbol_values, slot_size));
+      offsets[i].push_back(offset);
+      ORT_RETURN_IF(slot_size > std::numeric_limits<size_t>::max() - offset, "Size overflow");
+      offset += slot_size;
+    }
+    group.locations.push_back(locations_[i].device);
+    group.patterns.emplace_back().peak_size_ = offset;
+  }
+
+  for (const auto& [ort_value_idx, value] : values_) {
+    size_t size = 0;
+    ORT_RETURN_IF_ERROR(EvaluateAlignedSize(value.size, symbol_values, size));
+    group.patterns[value.location].patterns_[ort_value_idx] = MemoryBlock(offsets[value.location][value.slot], size);
+  }
+
+  out = std::move(group);
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,62 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/gsl.h"
+#include "core/common/inlined_containers.h"
+#include "core/framework/mem_pattern.h"
+#include "core/framework/ortdevice.h"
+#include "core/framework/symbolic_shape_inference.h"
+
+namespace onnxruntime {
+// SymbolicMemPatternPlanner plans the memory pattern of an execution plan once, with the sizes of the values in terms
+// of the symbolic dimensions of the inputs, so the pattern for a new set of input shapes is an evaluation of the
+// planned sizes and offsets instead of a run traced with MemPatternPlanner.
+//
+// Each value is placed in a slot, a region of the buffer of its location that holds one live value at a time.
+// A free slot is reused by a value if one of their sizes is bounded by the other for all values of the symbols,
+// e.g. 64 * seq and 64 * batch * seq bytes, and grows to the larger size. So the size of a slot is a product of
+// symbols, and its offset the sum of the sizes of the slots before it, which holds for any values of the symbols.
+// Not thread-safe.
+class SymbolicMemPatternPlanner {
+ public:
+  SymbolicMemPatternPlanner() = default;
+
+  // `size` is in bytes.
+  void TraceAllocation(int ort_value_idx, const OrtDevice& location, const SymbolicDim& size);
+
+  void TraceFree(int ort_value_idx);
+
+  // Generates the patterns for the given values of the symbols, which must be positive.
+  // The block sizes are aligned in the same way as the allocations of an ExecutionFrame.
+  Status GeneratePatterns(gsl::span<const int64_t> symbol_values, MemoryPatternGroup& out) const;
+
+  size_t NumSlots() const;
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(SymbolicMemPatternPlanner);
+
+  struct Slot {
+    SymbolicDim size;
+    bool in_use{false};
+  };
+
+  struct Location {
+    OrtDevice device;
+    std::vector<Slot> slots;
+  };
+
+  struct Value {
+    size_t location;
+    size_t slot;
+    SymbolicDim size;
+  };
+
+  std::vector<Location> locations_;
+  InlinedHashMap<int, Value> values_;
+};
+}  // namespace onnxruntime
@@ -0,0 +1,661 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/symbolic_shape_inference.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#include "core/framework/op_node_proto_helper.h"
+#include "core/framework/tensorprotoutils.h"
+#include "core/graph/constants.h"
+#include "core/graph/graph_viewer.h"
+
+namespace onnxruntime {
+
+namespace {
+bool MultiplyNonNegative(int64_t a, int64_t b, int64_t& result) {
+  if (a != 0 && b > std::numeric_limits<int64_t>::max() / a) {
+    return false;
+  }
+  result = a * b;
+  return true;
+}
+}  // namespace
+
+std::optional<SymbolicDim> SymbolicDim::Multiply(const SymbolicDim& other) const {
+  SymbolicDim result;
+  if (!MultiplyNonNegative(coefficient_, other.coefficient_, result.coefficient_)) {
+    return std::nullopt;
+  }
+  result.symbols_.reserve(symbols_.size() + other.symbols_.size());
+  std::merge(symbols_.begin(), symbols_.end(), other.symbols_.begin(), other.symbols_.end(),
+             std::back_inserter(result.symbols_));
+  return result;
+}
+
+std::optional<SymbolicDim> SymbolicDim::Divide(const SymbolicDim& other) const {
+  if (other.coefficient_ == 0 || coefficient_ % other.coefficient_ != 0 ||
+      !std::includes(symbols_.begin(), symbols_.end(), other.symbols_.begin(), other.symbols_.end())) {
+    return std::nullopt;
+  }
+  SymbolicDim result(coefficient_ / other.coefficient_);
+  std::set_difference(symbols_.begin(), symbols_.end(), other.symbols_.begin(), other.symbols_.end(),
+                      std::back_inserter(result.symbols_));
+  return result;
+}
+
+std::optional<SymbolicDim> SymbolicDim::Add(const SymbolicDim& other) const {
+  if (symbols_ != other.symbols_ || coefficient_ > std::numeric_limits<int64_t>::max() - other.coefficient_) {
+    return std::nullopt;
+  }
+  SymbolicDim result = *this;
+  result.coefficient_ += other.coefficient_;
+  return result;
+}
+
+bool SymbolicDim::IsBoundedBy(const SymbolicDim& other) const {
+  // the symbols are at least 1, so c1 * s <= c2 * s * t for any values if c1 <= c2.
+  return coefficient_ <= other.coefficient_ &&
+         std::includes(other.symbols_.begin(), other.symbols_.end(), symbols_.begin(), symbols_.end());
+}
+
+bool SymbolicDim::Evaluate(gsl::span<const int64_t> symbol_values, int64_t& value) const {
+  value = coefficient_;
+  for (int symbol : symbols_) {
+    if (!MultiplyNonNegative(value, symbol_values[symbol], value)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+std::string SymbolicDim::ToString(gsl::span<const std::string> symbol_names) const {
+  std::string result;
+  if (coefficient_ != 1 || symbols_.empty()) {
+    result = std::to_string(coefficient_);
+  }
+  for (int symbol : symbols_) {
+    if (!result.empty()) {
+      result += '*';
+    }
+    result += symbol_names[symbol];
+  }
+  return result;
+}
+
+namespace {
+using Shape = SymbolicShape;
+using Dim = std::optional<SymbolicDim>;
+
+bool IsOne(const Dim& dim) {
+  return dim.has_value() && dim->IsConstant() && dim->Coefficient() == 1;
+}
+
+Dim Product(const Shape& shape, size_t begin, size_t end) {
+  Dim product = SymbolicDim(1);
+  for (size_t i = begin; i < end && product.has_value(); ++i) {
+    product = shape[i].has_value() ? product->Multiply(*shape[i]) : std::nullopt;
+  }
+  return product;
+}
+
+bool NormalizeAxis(int64_t& axis, size_t rank) {
+  const auto r = static_cast<int64_t>(rank);
+  if (axis < -r || axis >= r) {
+    return false;
+  }
+  if (axis < 0) {
+    axis += r;
+  }
+  return true;
+}
+
+// Multidirectional broadcast. The result of a dimension is known if the dimensions that are not 1 are the same,
+// or if one of them is a constant other than 1, as a valid model can't broadcast it with anything else.
+std::optional<Shape> Broadcast(gsl::span<const Shape* const> shapes) {
+  size_t rank = 0;
+  for (const Shape* shape : shapes) {
+    if (shape == nullptr) {
+      return std::nullopt;
+    }
+    rank = std::max(rank, shape->size());
+  }
+
+  Shape result(rank);
+  for (size_t i = 0; i < rank; ++i) {
+    Dim dim = SymbolicDim(1);
+    bool mismatch = false;
+    for (const Shape* shape : shapes) {
+      if (shape->size() + i < rank) {
+        continue;
+      }
+      const Dim& other = (*shape)[shape->size() + i - rank];
+      if (IsOne(other)) {
+        continue;
+      }
+      if (other.has_value() && other->IsConstant()) {
+        dim = other;
+        break;
+      }
+      if (IsOne(dim)) {
+        dim = other;
+      } else if (dim != other) {
+        mismatch = true;
+      }
+    }
+    if (mismatch && !(dim.has_value() && dim->IsConstant())) {
+      dim = std::nullopt;
+    }
+    result[i] = dim;
+  }
+  return result;
+}
+
+// Ops whose first output has the shape of the first input.
+const InlinedHashSet<std::string_view>& SameShapeOps() {
+  static const InlinedHashSet<std::string_view> ops{
+      "Abs", "Acos", "Acosh", "Asin", "Asinh", "Atan", "Atanh", "BatchNormalization", "BiasGelu", "BitwiseNot",
+      "Cast", "CastLike", "Ceil", "Celu", "Clip", "Cos", "Cosh", "CumSum", "Dropout", "Elu", "Erf", "Exp", "FastGelu",
+      "Floor", "Gelu", "Hardmax", "HardSigmoid", "HardSwish", "Identity", "InstanceNormalization", "IsInf", "IsNaN",
+      "LayerNormalization", "LeakyRelu", "Log", "LogSoftmax", "LpNormalization", "MeanVarianceNormalization", "Mish",
+      "Neg", "Not", "QuickGelu", "Reciprocal", "Relu", "Round", "Selu", "Shrink", "Sigmoid", "Sign",
+      "SimplifiedLayerNormalization", "Sin", "Sinh", "SkipLayerNormalization", "SkipSimplifiedLayerNormalization",
+      "Softmax", "Softplus", "Softsign", "Sqrt", "Tan", "Tanh", "ThresholdedRelu", "Trilu"};
+  return ops;
+}
+
+const InlinedHashSet<std::string_view>& BroadcastOps() {
+  static const InlinedHashSet<std::string_view> ops{
+      "Add", "And", "BitShift", "BitwiseAnd", "BitwiseOr", "BitwiseXor", "Div", "Equal", "Greater", "GreaterOrEqual",
+      "Less", "LessOrEqual", "Max", "Mean", "Min", "Mod", "Mul", "Or", "Pow", "PRelu", "Sub", "Sum", "Where", "Xor"};
+  return ops;
+}
+
+const InlinedHashSet<std::string_view>& ReduceOps() {
+  static const InlinedHashSet<std::string_view> ops{
+      "ReduceL1", "ReduceL2", "ReduceLogSum", "ReduceLogSumExp", "ReduceMax", "ReduceMean", "ReduceMin",
+      "ReduceProd", "ReduceSum", "ReduceSumSquare"};
+  return ops;
+}
+
+// Values of a constant int64 input. nullopt if the input is missing or not a constant.
+std::optional<std::vector<int64_t>> GetConstantInts(const GraphViewer& graph_viewer, const Node& node,
+                                                    size_t input_index) {
+  const auto& input_defs = node.InputDefs();
+  if (input_index >= input_defs.size() || !input_defs[input_index]->Exists()) {
+    return std::nullopt;
+  }
+  const auto* initializer = graph_viewer.GetConstantInitializer(input_defs[input_index]->Name(), true);
+  if (initializer == nullptr || initializer->data_type() != ONNX_NAMESPACE::TensorProto_DataType_INT64) {
+    return std::nullopt;
+  }
+  std::vector<uint8_t> data;
+  if (!utils::UnpackInitializerData(*initializer, data).IsOK()) {
+    return std::nullopt;
+  }
+  std::vector<int64_t> values(data.size() / sizeof(int64_t));
+  memcpy(values.data(), data.data(), values.size() * sizeof(int64_t));
+  return values;
+}
+
+// The axes of ops that take them as an attribute in older opsets and as an optional input in newer ones.
+// Empty if neither is present, nullopt if the input is not a constant.
+std::optional<std::vector<int64_t>> GetAxes(const GraphViewer& graph_viewer, const Node& node,
+                                            const OpNodeProtoHelper<ProtoHelperNodeContext>& info) {
+  std::vector<int64_t> axes;
+  if (info.GetAttrs<int64_t>("axes", axes).IsOK()) {
+    return axes;
+  }
+  if (node.InputDefs().size() > 1 && node.InputDefs()[1]->Exists()) {
+    return GetConstantInts(graph_viewer, node, 1);
+  }
+  return axes;
+}
+
+std::optional<Shape> InferMatMul(const Shape* a, const Shape* b) {
+  if (a == nullptr || b == nullptr || a->empty() || b->empty()) {
+    return std::nullopt;
+  }
+  Shape lhs = *a;
+  Shape rhs = *b;
+  if (lhs.size() == 1) {
+    lhs.insert(lhs.begin(), SymbolicDim(1));
+  }
+  if (rhs.size() == 1) {
+    rhs.push_back(SymbolicDim(1));
+  }
+  const Shape lhs_batch(lhs.begin(), lhs.end() - 2);
+  const Shape rhs_batch(rhs.begin(), rhs.end() - 2);
+  const Shape* batches[] = {&lhs_batch, &rhs_batch};
+  auto result = Broadcast(batches);
+  if (a->size() != 1) {
+    result->push_back(lhs[lhs.size() - 2]);
+  }
+  if (b->size() != 1) {
+    result->push_back(rhs.back());
+  }
+  return result;
+}
+
+std::optional<Shape> InferReshape(const Shape* input, const std::vector<int64_t>& target, bool allow_zero) {
+  Shape result(target.size());
+  std::optional<size_t> inferred_axis;
+  for (size_t i = 0; i < target.size(); ++i) {
+    if (target[i] == 0 && !allow_zero) {
+      if (input != nullptr && i < input->size()) {
+        result[i] = (*input)[i];
+      }
+    } else if (target[i] == -1 && !inferred_axis.has_value()) {
+      inferred_axis = i;
+    } else if (target[i] >= 0) {
+      result[i] = SymbolicDim(target[i]);
+    } else {
+      return std::nullopt;
+    }
+  }
+
+  if (inferred_axis.has_value() && input != nullptr) {
+    const Dim total = Product(*input, 0, input->size());
+    result[*inferred_axis] = SymbolicDim(1);
+    const Dim rest = Product(result, 0, result.size());
+    result[*inferred_axis] = total.has_value() && rest.has_value() ? total->Divide(*rest) : std::nullopt;
+  }
+  return result;
+}
+
+std::optional<Shape> InferSqueeze(const Shape& data, const std::vector<int64_t>& axes) {
+  InlinedVector<bool> is_axis(data.size(), false);
+  for (int64_t axis : axes) {
+    if (!NormalizeAxis(axis, data.size())) {
+      return std::nullopt;
+    }
+    is_axis[axis] = true;
+  }
+  Shape result;
+  for (size_t i = 0; i < data.size(); ++i) {
+    if (axes.empty()) {
+      // the dimensions that are 1 are removed, which a symbol may be.
+      if (!data[i].has_value() || !data[i]->IsConstant()) {
+        return std::nullopt;
+      }
+      if (!IsOne(data[i])) {
+        result.push_back(data[i]);
+      }
+    } else if (!is_axis[i]) {
+      result.push_back(data[i]);
+    }
+  }
+  return result;
+}
+
+std::optional<Shape> InferUnsqueeze(const Shape& data, const std::vector<int64_t>& axes) {
+  const size_t rank = data.size() + axes.size();
+  InlinedVector<bool> is_axis(rank, false);
+  for (int64_t axis : axes) {
+    if (!NormalizeAxis(axis, rank) || is_axis[axis]) {
+      return std::nullopt;
+    }
+    is_axis[axis] = true;
+  }
+  Shape result;
+  for (size_t i = 0, j = 0; i < rank; ++i) {
+    result.push_back(is_axis[i] ? Dim(SymbolicDim(1)) : data[j++]);
+  }
+  return result;
+}
+
+std::optional<Shape> InferConcat(gsl::span<const Shape* const> inputs, int64_t axis) {
+  if (inputs.empty() || std::any_of(inputs.begin(), inputs.end(), [&inputs](const Shape* shape) {
+        return shape == nullptr || shape->size() != inputs[0]->size();
+      })) {
+    return std::nullopt;
+  }
+  if (!NormalizeAxis(axis, inputs[0]->size())) {
+    return std::nullopt;
+  }
+  Shape result = *inputs[0];
+  for (size_t i = 1; i < inputs.size(); ++i) {
+    for (size_t d = 0; d < result.size(); ++d) {
+      const Dim& dim = (*inputs[i])[d];
+      if (static_cast<int64_t>(d) == axis) {
+        result[d] = result[d].has_value() && dim.has_value() ? result[d]->Add(*dim) : std::nullopt;
+      } else if (!result[d].has_value()) {
+        result[d] = dim;
+      }
+    }
+  }
+  return result;
+}
+
+// Reduces `data` along the axes that are set in `is_axis`.
+Shape InferReduce(const Shape& data, const InlinedVector<bool>& is_axis, bool keep_dims) {
+  Shape result;
+  for (size_t i = 0; i < data.size(); ++i) {
+    if (!is_axis[i]) {
+      result.push_back(data[i]);
+    } else if (keep_dims) {
+      result.push_back(SymbolicDim(1));
+    }
+  }
+  return result;
+}
+
+std::optional<Shape> InferFirstOutput(const GraphViewer& graph_viewer, const Node& node,
+                                      gsl::span<const Shape* const> inputs) {
+  auto input = [&inputs](size_t i) -> const Shape* { return i < inputs.size() ? inputs[i] : nullptr; };
+  ProtoHelperNodeContext node_context(node);
+  OpNodeProtoHelper<ProtoHelperNodeContext> info(&node_context);
+  const std::string& op_type = node.OpType();
+
+  if (SameShapeOps().count(op_type) != 0) {
+    return input(0) != nullptr ? std::optional<Shape>(*input(0)) : std::nullopt;
+  }
+
+  if (BroadcastOps().count(op_type) != 0) {
+    return Broadcast(inputs);
+  }
+
+  if (op_type == "MatMul") {
+    return InferMatMul(input(0), input(1));
+  }
+
+  if (op_type == "Gemm") {
+    const Shape* a = input(0);
+    const Shape* b = input(1);
+    if (a == nullptr || b == nullptr || a->size() != 2 || b->size() != 2) {
+      return std::nullopt;
+    }
+    const bool trans_a = info.GetAttrOrDefault<int64_t>("transA", 0) != 0;
+    const bool trans_b = info.GetAttrOrDefault<int64_t>("transB", 0) != 0;
+    return Shape{(*a)[trans_a ? 1 : 0], (*b)[trans_b ? 0 : 1]};
+  }
+
+  if (op_type == "Transpose") {
+    const Shape* data = input(0);
+    if (data == nullptr) {
+      return std::nullopt;
+    }
+    std::vector<int64_t> perm;
+    if (!info.GetAttrs<int64_t>("perm", perm).IsOK()) {
+      for (size_t i = data->size(); i > 0; --i) {
+        perm.push_back(static_cast<int64_t>(i - 1));
+      }
+    }
+    if (perm.size() != data->size()) {
+      return std::nullopt;
+    }
+    Shape result;
+    for (int64_t axis : perm) {
+      if (!NormalizeAxis(axis, data->size())) {
+        return std::nullopt;
+      }
+      result.push_back((*data)[axis]);
+    }
+    return result;
+  }
+
+  if (op_type == "Reshape") {
+    auto target = GetConstantInts(graph_viewer, node, 1);
+    if (!target.has_value()) {
+      return std::nullopt;
+    }
+    return InferReshape(input(0), *target, info.GetAttrOrDefault<int64_t>("allowzero", 0) != 0);
+  }
+
+  if (op_type == "Flatten") {
+    const Shape* data = input(0);
+    int64_t axis = info.GetAttrOrDefault<int64_t>("axis", 1);
+    if (data == nullptr || (axis != static_cast<int64_t>(data->size()) && !NormalizeAxis(axis, data->size()))) {
+      return std::nullopt;
+    }
+    const auto split = static_cast<size_t>(axis);
+    return Shape{Product(*data, 0, split), Product(*data, split, data->size())};
+  }
+
+  if (op_type == "Squeeze" || op_type == "Unsqueeze") {
+    const Shape* data = input(0);
+    auto axes = GetAxes(graph_viewer, node, info);
+    if (data == nullptr || !axes.has_value()) {
+      return std::nullopt;
+    }
+    return op_type == "Squeeze" ? InferSqueeze(*data, *axes) : InferUnsqueeze(*data, *axes);
+  }
+
+  if (op_type == "Concat") {
+    return InferConcat(inputs, info.GetAttrOrDefault<int64_t>("axis", 0));
+  }
+
+  if (op_type == "Gather") {
+    const Shape* data = input(0);
+    const Shape* indices = input(1);
+    int64_t axis = info.GetAttrOrDefault<int64_t>("axis", 0);
+    if (data == nullptr || indices == nullptr || !NormalizeAxis(axis, data->size())) {
+      return std::nullopt;
+    }
+    Shape result(data->begin(), data->begin() + axis);
+    result.insert(result.end(), indices->begin(), indices->end());
+    result.insert(result.end(), data->begin() + axis + 1, data->end());
+    return result;
+  }
+
+  if (op_type == "Expand") {
+    auto target = GetConstantInts(graph_viewer, node, 1);
+    if (!target.has_value()) {
+      return std::nullopt;
+    }
+    Shape target_shape;
+    for (int64_t dim : *target) {
+      target_shape.push_back(SymbolicDim(dim));
+    }
+    const Shape* shapes[] = {input(0), &target_shape};
+    return Broadcast(shapes);
+  }
+
+  if (op_type == "Shape") {
+    const Shape* data = input(0);
+    if (data == nullptr) {
+      return std::nullopt;
+    }
+    const auto rank = static_cast<int64_t>(data->size());
+    int64_t start = info.GetAttrOrDefault<int64_t>("start", 0);
+    int64_t end = info.GetAttrOrDefault<int64_t>("end", rank);
+    start = std::clamp(start < 0 ? start + rank : start, int64_t{0}, rank);
+    end = std::clamp(end < 0 ? end + rank : end, int64_t{0}, rank);
+    return Shape{SymbolicDim(std::max(end - start, int64_t{0}))};
+  }
+
+  if (ReduceOps().count(op_type) != 0 || op_type == "ArgMax" || op_type == "ArgMin") {
+    const Shape* data = input(0);
+    if (data == nullptr) {
+      return std::nullopt;
+    }
+    std::optional<std::vector<int64_t>> axes;
+    if (op_type == "ArgMax" || op_type == "ArgMin") {
+      axes = std::vector<int64_t>{info.GetAttrOrDefault<int64_t>("axis", 0)};
+    } else {
+      axes = GetAxes(graph_viewer, node, info);
+    }
+    if (!axes.has_value()) {
+      return std::nullopt;
+    }
+    const bool noop = axes->empty() && info.GetAttrOrDefault<int64_t>("noop_with_empty_axes", 0) != 0;
+    InlinedVector<bool> is_axis(data->size(), axes->empty() && !noop);
+    for (int64_t axis : *axes) {
+      if (!NormalizeAxis(axis, data->size())) {
+        return std::nullopt;
+      }
+      is_axis[axis] = true;
+    }
+    return InferReduce(*data, is_axis, info.GetAttrOrDefault<int64_t>("keepdims", 1) != 0);
+  }
+
+  return std::nullopt;
+}
+}  // namespace
+
+SymbolicShapeInference::SymbolicShapeInference(const GraphViewer& graph_viewer,
+                                               gsl::span<const NodeArg* const> inputs) {
+  for (const NodeArg* input : inputs) {
+    ParseInputShape(*input);
+  }
+
+  for (const auto& [name, initializer] : graph_viewer.GetAllInitializedTensors()) {
+    if (shapes_.find(name) == shapes_.end()) {
+      Shape shape;
+      for (int64_t dim : initializer->dims()) {
+        shape.push_back(SymbolicDim(dim));
+      }
+      shapes_.emplace(name, std::move(shape));
+    }
+  }
+
+  for (NodeIndex node_index : graph_viewer.GetNodesInTopologicalOrder()) {
+    const Node* node = graph_viewer.GetNode(node_index);
+    if (node != nullptr) {
+      InferNode(graph_viewer, *node);
+    }
+  }
+}
+
+const SymbolicShape* SymbolicShapeInference::GetShape(const std::string& name) const {
+  auto it = shapes_.find(name);
+  return it == shapes_.end() ? nullptr : &it->second;
+}
+
+std::optional<SymbolicDim> SymbolicShapeInference::GetSize(const std::string& name) const {
+  const Shape* shape = GetShape(name);
+  return shape == nullptr ? std::nullopt : Product(*shape, 0, shape->size());
+}
+
+int SymbolicShapeInference::GetSymbol(const std::string& dim_param) const {
+  auto it = symbols_.find(dim_param);
+  return it == symbols_.end() ? -1 : it->second;
+}
+
+std::optional<SymbolicDim> SymbolicShapeInference::ParseDimParam(const std::string& dim_param, bool add_symbols) {
+  SymbolicDim result;
+  size_t begin = 0;
+  while (begin <= dim_param.size()) {
+    size_t end = std::min(dim_param.find('*', begin), dim_param.size());
+    size_t first = dim_param.find_first_not_of(' ', begin);
+    size_t last = dim_param.find_last_not_of(' ', end - 1);
+    if (first == std::string::npos || first >= end || last < first) {
+      return std::nullopt;
+    }
+    const std::string token = dim_param.substr(first, last - first + 1);
+
+    std::optional<SymbolicDim> factor;
+    if (std::all_of(token.begin(), token.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+      if (token.size() < 19) {
+        factor = SymbolicDim(std::stoll(token));
+      }
+    } else if (std::all_of(token.begin(), token.end(), [](char c) {
+                 return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+                        c == '_' || c == '.' || c == ':' || c == '/';
+               })) {
+      int symbol = GetSymbol(token);
+      if (symbol < 0 && add_symbols) {
+        symbol = static_cast<int>(symbol_names_.size());
+        symbols_.emplace(token, symbol);
+        symbol_names_.push_back(token);
+      }
+      if (symbol >= 0) {
+        factor = SymbolicDim::Symbol(symbol);
+      }
+    }
+    if (!factor.has_value()) {
+      return std::nullopt;
+    }
+    auto product = result.Multiply(*factor);
+    if (!product.has_value()) {
+      return std::nullopt;
+    }
+    result = std::move(*product);
+    begin = end + 1;
+  }
+  return result;
+}
+
+std::optional<SymbolicShape> SymbolicShapeInference::DeclaredShape(const NodeArg& arg, bool add_symbols) {
+  const auto* shape = arg.Shape();
+  if (shape == nullptr) {
+    return std::nullopt;
+  }
+  Shape result;
+  result.reserve(shape->dim_size());
+  for (const auto& dim : shape->dim()) {
+    if (utils::HasDimValue(dim) && dim.dim_value() >= 0) {
+      result.push_back(SymbolicDim(dim.dim_value()));
+    } else if (utils::HasDimParam(dim)) {
+      result.push_back(ParseDimParam(dim.dim_param(), add_symbols));
+    } else {
+      result.push_back(std::nullopt);
+    }
+  }
+  return result;
+}
+
+void SymbolicShapeInference::ParseInputShape(const NodeArg& input) {
+  auto shape = DeclaredShape(input, true);
+  if (shape.has_value()) {
+    shapes_.insert_or_assign(input.Name(), std::move(*shape));
+  }
+}
+
+void SymbolicShapeInference::InferNode(const GraphViewer& graph_viewer, const Node& node) {
+  const auto& input_defs = node.InputDefs();
+  const auto& output_defs = node.OutputDefs();
+  InlinedVector<const Shape*> inputs;
+  inputs.reserve(input_defs.size());
+  for (const NodeArg* input : input_defs) {
+    const Shape* shape = nullptr;
+    if (input->Exists()) {
+      shape = GetShape(input->Name());
+      if (shape == nullptr) {
+        // a value of an outer scope that is not an implicit input.
+        auto declared = DeclaredShape(*input, false);
+        if (declared.has_value()) {
+          shape = &shapes_.emplace(input->Name(), std::move(*declared)).first->second;
+        }
+      }
+    }
+    inputs.push_back(shape);
+  }
+
+  std::vector<std::optional<Shape>> inferred(output_defs.size());
+  if (!inferred.empty() && (node.Domain() == kOnnxDomain || node.Domain() == kMSDomain)) {
+    inferred[0] = InferFirstOutput(graph_viewer, node, inputs);
+    // outputs other than the first one with the shape of the first input.
+    const std::string& op_type = node.OpType();
+    if (op_type == "Dropout" && inferred.size() > 1) {
+      inferred[1] = inferred[0];
+    } else if ((op_type == "SkipLayerNormalization" || op_type == "SkipSimplifiedLayerNormalization") &&
+               inferred.size() > 3) {
+      inferred[3] = inferred[0];
+    }
+  }
+
+  // the dimensions in the NodeArgs take precedence if they are in terms of the symbols.
+  for (size_t i = 0; i < output_defs.size(); ++i) {
+    if (!output_defs[i]->Exists()) {
+      continue;
+    }
+    auto shape = DeclaredShape(*output_defs[i], false);
+    if (!shape.has_value()) {
+      shape = std::move(inferred[i]);
+    } else if (inferred[i].has_value() && inferred[i]->size() == shape->size()) {
+      for (size_t d = 0; d < shape->size(); ++d) {
+        if (!(*shape)[d].has_value()) {
+          (*shape)[d] = (*inferred[i])[d];
+        }
+      }
+    }
+    if (shape.has_value()) {
+      shapes_.insert_or_assign(output_defs[i]->Name(), std::move(*shape));
+    }
+  }
+}
+
+}  // namespace onnxruntime
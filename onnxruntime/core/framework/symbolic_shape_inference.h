@@ -0,0 +1,106 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/gsl.h"
+#include "core/common/inlined_containers.h"
+
+namespace onnxruntime {
+class GraphViewer;
+class Node;
+class NodeArg;
+
+// A dimension, or the product of several dimensions, as a constant times a product of symbolic dimensions,
+// e.g. 4 * batch * seq. Symbols are indices into a symbol table and stand for positive integers at runtime.
+class SymbolicDim {
+ public:
+  SymbolicDim() = default;
+  explicit SymbolicDim(int64_t value) : coefficient_(value) {}
+
+  static SymbolicDim Symbol(int symbol) {
+    SymbolicDim dim;
+    dim.symbols_.push_back(symbol);
+    return dim;
+  }
+
+  int64_t Coefficient() const { return coefficient_; }
+
+  // Sorted, a symbol occurs once for each time it is a factor.
+  gsl::span<const int> Symbols() const { return symbols_; }
+
+  bool IsConstant() const { return symbols_.empty(); }
+
+  // nullopt if the coefficient overflows.
+  std::optional<SymbolicDim> Multiply(const SymbolicDim& other) const;
+
+  // nullopt if `other` doesn't divide this for all values of the symbols.
+  std::optional<SymbolicDim> Divide(const SymbolicDim& other) const;
+
+  // nullopt unless both have the same symbols, as the sum is not a product otherwise.
+  std::optional<SymbolicDim> Add(const SymbolicDim& other) const;
+
+  // Whether this is not larger than `other` for all values of the symbols.
+  bool IsBoundedBy(const SymbolicDim& other) const;
+
+  // Value for the given values of the symbols. Returns false if the value overflows.
+  bool Evaluate(gsl::span<const int64_t> symbol_values, int64_t& value) const;
+
+  bool operator==(const SymbolicDim& other) const {
+    return coefficient_ == other.coefficient_ && symbols_ == other.symbols_;
+  }
+  bool operator!=(const SymbolicDim& other) const { return !(*this == other); }
+
+  std::string ToString(gsl::span<const std::string> symbol_names) const;
+
+ private:
+  int64_t coefficient_{1};
+  InlinedVector<int, 4> symbols_;
+};
+
+// A shape with a known rank. Dimensions that can't be expressed in terms of the symbols are nullopt.
+using SymbolicShape = InlinedVector<std::optional<SymbolicDim>>;
+
+// Infers the shapes of the values of a graph in terms of the symbolic dimensions of its inputs.
+// The dim_params of the inputs are the symbols, e.g. a graph with input shapes [batch, seq] and [batch, seq, 768]
+// infers [batch, seq, 3072] for the output of a MatMul of the second input with a [768, 3072] initializer.
+// The shapes the ONNX shape inference stored in the NodeArgs are used where they are in terms of the symbols,
+// and refined with the ops' shape rules where they are not, e.g. for the result of a Reshape to [0, 0, 12, 64].
+class SymbolicShapeInference {
+ public:
+  // `inputs` are the values whose dim_params are the symbols, typically the graph inputs and for a subgraph the
+  // implicit inputs of its parent node. A dim_param of the form "batch*seq" is the product of the symbols.
+  SymbolicShapeInference(const GraphViewer& graph_viewer, gsl::span<const NodeArg* const> inputs);
+
+  // nullptr if the rank of the value isn't known.
+  const SymbolicShape* GetShape(const std::string& name) const;
+
+  // Number of elements of the value, nullopt if it isn't known.
+  std::optional<SymbolicDim> GetSize(const std::string& name) const;
+
+  // Symbol for a dim_param of an input, -1 if there is no such symbol.
+  int GetSymbol(const std::string& dim_param) const;
+
+  const std::vector<std::string>& SymbolNames() const { return symbol_names_; }
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(SymbolicShapeInference);
+
+  // Parses a dim_param of the form "[N*]name[*name...]". nullopt if it isn't of that form, or if `add_symbols` is
+  // false and a name isn't a symbol yet.
+  std::optional<SymbolicDim> ParseDimParam(const std::string& dim_param, bool add_symbols);
+  std::optional<SymbolicShape> DeclaredShape(const NodeArg& arg, bool add_symbols);
+  void ParseInputShape(const NodeArg& input);
+  void InferNode(const GraphViewer& graph_viewer, const Node& node);
+
+  std::vector<std::string> symbol_names_;
+  InlinedHashMap<std::string, int> symbols_;
+  InlinedHashMap<std::string, SymbolicShape> shapes_;
+};
+
+}  // namespace onnxruntime
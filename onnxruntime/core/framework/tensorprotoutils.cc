@@ -841,6 +841,21 @@ Status GetExtDataFromTensorProto(const Env& env, const ORTCHAR_T* model_path,
   return Status::OK();
 }
 
+bool HasAlignedExternalData(const ONNX_NAMESPACE::TensorProto& tensor_proto, size_t alignment) {
+  if (!HasExternalData(tensor_proto)) {
+    return false;
+  }
+
+  std::unique_ptr<ExternalDataInfo> external_data_info;
+  if (!ExternalDataInfo::Create(tensor_proto.external_data(), external_data_info).IsOK()) {
+    return false;
+  }
+
+  // for kTensorProtoMemoryAddressTag the offset is the address of the data
+  const auto offset = external_data_info->GetOffset();
+  return offset >= 0 && static_cast<size_t>(offset) % alignment == 0;
+}
+
 #define CASE_PROTO(X, Y)                                                      \
   case ONNX_NAMESPACE::TensorProto_DataType::TensorProto_DataType_##X:        \
     ORT_RETURN_IF_ERROR(                                                      \
@@ -105,6 +105,10 @@ common::Status GetExtDataFromTensorProto(const Env& env, const ORTCHAR_T* model_
                                          void*& ext_data_buf, SafeInt<size_t>& ext_data_len,
                                          OrtCallback& ext_data_deleter);
 
+// Returns true if the external data of the tensor proto starts at a file offset (or memory address)
+// that is a multiple of 'alignment'. Returns false if the external data info can't be parsed.
+bool HasAlignedExternalData(const ONNX_NAMESPACE::TensorProto& tensor_proto, size_t alignment);
+
 // Convert the AttributeProto from a Constant node into a TensorProto that can be used as an initializer
 // If AttributeProto contains a TensorProto, this tensor proto is converted as is including the case when the
 // the data location is external. i.e. it does not load the external data.
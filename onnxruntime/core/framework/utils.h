@@ -120,6 +120,18 @@ common::Status ExecuteSubgraph(const SessionState& session_state, const FeedsFet
                                subgraph fetches, i.e. the loop condition*/
                                bool sync_subgraph_fetches = false);
 
+#ifdef ORT_ENABLE_STREAM
+// Execute a subgraph on the device streams held by the caller. A control flow node that executes its subgraph once per
+// iteration uses this to acquire the device streams once instead of in every call.
+common::Status ExecuteSubgraph(const SessionState& session_state, const FeedsFetchesManager& feeds_fetches_manager,
+                               gsl::span<const OrtValue> feeds, std::vector<OrtValue>& fetches,
+                               const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators,
+                               ExecutionMode execution_mode, const bool& terminate_flag, const logging::Logger& logger,
+                               Stream* parent_stream,
+                               DeviceStreamCollectionHolder& device_stream_collection_holder,
+                               bool sync_subgraph_fetches = false);
+#endif
+
 bool IsInputOnCpu(const Node& node, const KernelCreateInfo* p_kci, size_t index);
 
 template <typename T>
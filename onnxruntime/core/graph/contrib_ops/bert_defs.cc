@@ -332,6 +332,14 @@ ONNX_MS_OPERATOR_SET_SCHEMA(
                "When past_present_share_buffer is used, it is required to specify past_sequence_length (could be 0).",
                "M",
                OpSchema::Optional)
+        .Input(7,
+               "page_table",
+               "Pages of each sequence with shape (batch_size, max_pages_per_sequence). When it is given, "
+               "past_present_share_buffer shall be set, and past and present are a paged cache with shape "
+               "(2, num_pages, num_heads, page_size, head_size). Position t of a sequence is stored in row "
+               "t % page_size of page page_table[batch_index][t / page_size].",
+               "M",
+               OpSchema::Optional)
         .Output(0,
                 "output",
                 "3D output tensor with shape (batch_size, sequence_length, v_hidden_size)",
@@ -115,6 +115,7 @@ namespace onnxruntime {
         class ThreadPool;
     };
     struct MLFloat16;
+    struct BFloat16;
 };  // namespace onnxruntime
 
 using MLAS_THREADPOOL = onnxruntime::concurrency::ThreadPool;
@@ -130,6 +131,20 @@ MlasGetPreferredBufferAlignment(
     void
     );
 
+//
+// Version of the layouts of the buffers produced by the packing routines of
+// this library. Increment whenever the layout produced by any of the packing
+// routines changes, so that previously serialized packed buffers are rejected.
+//
+
+#define MLAS_PACKED_BUFFER_FORMAT_VERSION 1
+
+const char*
+MLASCALL
+MlasGetPackedBufferIsa(
+    void
+    );
+
 #ifdef MLAS_TARGET_AMD64_IX86
 
 /**
@@ -158,6 +173,8 @@ enum MLAS_ACTIVATION_KIND {
     MlasLogisticActivation,
     MlasClipActivation,
     MlasHardSigmoidActivation,
+    MlasGeluActivation,
+    MlasSiluActivation,
     MlasActivationKindCount,
 };
 
@@ -190,6 +207,45 @@ MlasActivation(
     size_t ldc
     );
 
+/**
+ * @brief Operations fused into the store of the output of a GEMM:
+ *
+ *        C = Activation(C + Bias + Residual)
+ *
+ *        The epilogue is applied to each block of C right after the block is
+ *        computed, while it is still in the cache of the computing thread,
+ *        instead of in separate passes over the whole output.
+ */
+struct MLAS_GEMM_EPILOGUE {
+    const float* Bias = nullptr;     /**< Supplies the optional bias vector, one element per column of C */
+    const float* Residual = nullptr; /**< Supplies the optional matrix added to C, same shape as C */
+    size_t ldr = 0;                  /**< Supplies the first dimension of the residual matrix */
+    MLAS_ACTIVATION Activation{MlasIdentityActivation, {}}; /**< Supplies the activation */
+};
+
+/**
+ * @brief Applies a GEMM epilogue to a block of the output matrix
+ *
+ * @param Epilogue  Supplies the operations to apply
+ * @param C         Supplies the address of the block of the output matrix
+ * @param ldc       Supplies the first dimension of the output matrix
+ * @param StartM    Supplies the first row of the block, used to index the residual
+ * @param StartN    Supplies the first column of the block, used to index the bias and the residual
+ * @param CountM    Supplies the number of rows of the block
+ * @param CountN    Supplies the number of columns of the block
+ */
+void
+MLASCALL
+MlasGemmEpilogue(
+    const MLAS_GEMM_EPILOGUE* Epilogue,
+    float* C,
+    size_t ldc,
+    size_t StartM,
+    size_t StartN,
+    size_t CountM,
+    size_t CountN
+    );
+
 //
 // Matrix/matrix multiply routines.
 // C := alpha * op(A) * op(B) + beta * C
@@ -209,6 +265,7 @@ struct MLAS_SGEMM_DATA_PARAMS {
     float alpha = 1.0f;       /**< Supplies the scalar alpha multiplier (see SGEMM definition) */
     float beta = 0.0f;        /**< Supplies the scalar beta multiplier (see SGEMM definition) */
     bool BIsPacked = false;   /**< Whether B is pre-packed */
+    const MLAS_GEMM_EPILOGUE* Epilogue = nullptr; /**< Supplies the optional operations fused into the store of C */
 };
 
 /**
@@ -523,13 +580,15 @@ public:
         const float* Scale,
         const float* Bias,
         MLAS_QGEMM_OUTPUT_MODE Mode = MLAS_QGEMM_OUTPUT_MODE::ZeroMode,
-        MLAS_QUANTIZATION_GRANULARITY QuantGran = MLAS_QUANTIZATION_GRANULARITY::PerMatrix) :
+        MLAS_QUANTIZATION_GRANULARITY QuantGran = MLAS_QUANTIZATION_GRANULARITY::PerMatrix,
+        const MLAS_GEMM_EPILOGUE* Epilogue = nullptr) :
             Output_(Output),
             LeadingDimensionOutput_(LeadingDimensionOutput),
             Scale_(Scale),
             Bias_(Bias),
             OutputMode_(Mode),
-            QuantGran_(QuantGran)
+            QuantGran_(QuantGran),
+            Epilogue_(Epilogue)
     {
     }
 
@@ -563,6 +622,7 @@ private:
     const float* Bias_;
     MLAS_QGEMM_OUTPUT_MODE OutputMode_;
     MLAS_QUANTIZATION_GRANULARITY QuantGran_;
+    const MLAS_GEMM_EPILOGUE* Epilogue_;
 };
 
 /**
@@ -1021,6 +1081,127 @@ MlasComputeTanh(
     size_t N
     );
 
+//
+// Reduction routines.
+//
+
+enum MLAS_REDUCE_KIND {
+    MlasReduceSum,
+    MlasReduceSumSquare,
+    MlasReduceSumAbsolute,
+    MlasReduceMaximum,
+    MlasReduceMinimum,
+    MlasReduceLogSumExp,
+    MlasReduceKindCount,
+};
+
+//
+// Reduces each of CountM rows of CountK contiguous elements to a single value.
+// Rows are ldi elements apart.
+//
+
+void
+MLASCALL
+MlasReduceRows(
+    MLAS_REDUCE_KIND ReduceKind,
+    const float* Input,
+    size_t ldi,
+    float* Output,
+    size_t CountM,
+    size_t CountK
+    );
+
+//
+// Reduces CountK rows of CountN contiguous elements to a single row of CountN
+// values. Rows are ldi elements apart.
+//
+
+void
+MLASCALL
+MlasReduceColumns(
+    MLAS_REDUCE_KIND ReduceKind,
+    const float* Input,
+    size_t ldi,
+    float* Output,
+    size_t CountK,
+    size_t CountN
+    );
+
+//
+// Layer normalization routines.
+//
+
+//
+// Normalizes each of CountM rows of CountN contiguous elements to zero mean
+// and unit variance, then applies the per column Scale and optional Bias.
+// When Simplified is set, the rows are instead divided by their root mean
+// square (RMSNorm) and Bias must be null. The optional Mean and InvStdDev
+// buffers receive the per row statistics.
+//
+
+void
+MLASCALL
+MlasLayerNormalization(
+    const float* Input,
+    const float* Scale,
+    const float* Bias,
+    float* Output,
+    float* Mean,
+    float* InvStdDev,
+    size_t CountM,
+    size_t CountN,
+    float Epsilon,
+    bool Simplified
+    );
+
+//
+// Normalizes the sum of a row of CountN elements with a skip row and an
+// optional SkipBias row, as done by SkipLayerNormalization. The optional
+// SkipOutput buffer receives the sum before normalization.
+//
+
+void
+MLASCALL
+MlasSkipLayerNormalization(
+    const float* Input,
+    const float* Skip,
+    const float* SkipBias,
+    const float* Scale,
+    const float* Bias,
+    float* Output,
+    float* SkipOutput,
+    size_t CountN,
+    float Epsilon,
+    bool Simplified
+    );
+
+//
+// Attention routines.
+//
+
+struct MLAS_FLASH_ATTENTION_PARAMS {
+    size_t BatchSize;           // B
+    size_t NumHeads;            // N
+    size_t SequenceLength;      // S: number of queries
+    size_t KvSequenceLength;    // T: number of keys and values, including past ones
+    size_t QkHeadSize;          // H: head size of queries and keys
+    size_t VHeadSize;           // H_v: head size of values
+    float Scale;                // scale of Q x K'
+    bool Causal;                // query i only attends to keys [0, T - S + i]
+    const float* Query;         // shape (B, N, S, H)
+    const float* Key;           // shape (B, N, T, H)
+    const float* Value;         // shape (B, N, T, H_v)
+    const float* KeyBias;       // optional additive bias of keys, like a padding mask, with shape (B, T)
+    float* Output;              // shape (B, S, N, H_v)
+};
+
+void
+MLASCALL
+MlasFlashAttention(
+    const MLAS_FLASH_ATTENTION_PARAMS* Params,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
 //
 // Half-precision floating-point routines.
 //
@@ -1204,6 +1385,58 @@ MlasNchwcUpsampleLinear(
     float* Output
     );
 
+//
+// Resize routines.
+//
+
+//
+// Computes a row of OutputWidth pixels of Channels interleaved elements by
+// bilinear interpolation. The two input rows are first blended with the row
+// weights into Buffer (InputWidth * Channels elements), then each output
+// pixel blends the buffered pixels at InputColumn1[x] and InputColumn2[x]
+// with ColumnWeight1[x] and ColumnWeight2[x].
+//
+
+void
+MLASCALL
+MlasBilinearResizeRow(
+    const float* InputRow1,
+    const float* InputRow2,
+    float RowWeight1,
+    float RowWeight2,
+    const int32_t* InputColumn1,
+    const int32_t* InputColumn2,
+    const float* ColumnWeight1,
+    const float* ColumnWeight2,
+    size_t InputWidth,
+    size_t OutputWidth,
+    size_t Channels,
+    float* Buffer,
+    float* Output
+    );
+
+//
+// Computes a row of OutputWidth pixels of Channels interleaved elements by
+// bicubic interpolation. The four input rows are first blended with the four
+// row weights into Buffer (InputWidth * Channels elements), then each output
+// pixel x blends the four buffered pixels at InputColumns[4 * x + i] with
+// ColumnWeights[4 * x + i].
+//
+
+void
+MLASCALL
+MlasBicubicResizeRow(
+    const float* const* InputRows,
+    const float* RowWeights,
+    const int32_t* InputColumns,
+    const float* ColumnWeights,
+    size_t InputWidth,
+    size_t OutputWidth,
+    size_t Channels,
+    float* Buffer,
+    float* Output
+    );
+
 //
 // Linear quantization routines.
 //
@@ -1689,3 +1922,188 @@ MlasNhwcAvgPool(
     );
 
 #endif
+
+//
+// BFloat16 routines
+//
+
+using MLAS_BF16 = onnxruntime::BFloat16;
+
+/**
+ * @brief Whether current CPU supports bfloat16 dot product acceleration
+ *        (AVX512-BF16 or AMX-BF16).
+*/
+bool MLASCALL
+MlasBf16AccelerationSupported();
+
+/**
+ * @brief Data parameters for bfloat16 GEMM routine
+ *        All except C are [in] parameters
+*/
+struct MLAS_BF16_GEMM_DATA_PARAMS {
+    const MLAS_BF16* A = nullptr;     /**< address of A, row major */
+    const void* B = nullptr;          /**< address of B, row major, or packed when ldb is 0 */
+    const float* Bias = nullptr;      /**< address of Bias, vector size N */
+    void* C = nullptr;                /**< address of result matrix, float or bfloat16 */
+    size_t lda = 0;                   /**< leading dimension of A */
+    size_t ldb = 0;                   /**< leading dimension of B, 0 when B is pre-packed*/
+    size_t ldc = 0;                   /**< leading dimension of C*/
+    bool CIsBf16 = false;             /**< the result is rounded to bfloat16, else stored as float */
+};
+
+/**
+ * @brief BFloat16 Batched GEMM:  C = A * B + Bias
+ *        The products are accumulated in single precision.
+ *
+ * Note:  We only support uniform batching, so shapes and types of the
+ *        input must be same across all parameter blocks.
+ *
+ * @param[in]  M       row size of matrix A and C
+ * @param[in]  N       column size of matrix B and C
+ * @param[in]  K       column size of matrix A and row size of matrix B
+ * @param[in]  BatchN  number of batches
+ * @param[inout]  DataParams  An array (size BatchN) of parameter blocks
+ * @param[in]  ThreadPool
+ * @return
+*/
+void
+MLASCALL
+MlasBf16GemmBatch(
+    const size_t M,
+    const size_t N,
+    const size_t K,
+    const size_t BatchN,
+    const MLAS_BF16_GEMM_DATA_PARAMS* DataParams,
+    MLAS_THREADPOOL* ThreadPool = nullptr
+    );
+
+/**
+ * @brief For bfloat16 GEMM, returns size of the
+ *        packing buffer needed for right hand side
+ * @param[in] N   Number of columns
+ * @param[in] K   Number of rows
+ * @return  size of the packing buffer
+*/
+size_t
+MLASCALL
+MlasBf16GemmPackBSize(
+    size_t N,
+    size_t K
+    );
+
+/**
+ * @brief For bfloat16 GEMM, pack the right hand
+ *        side matrix B
+ *
+ * @param[in]  TransB   Whether B is stored transposed (N x K)
+ * @param[in]  N        Number of columns
+ * @param[in]  K        Number of rows
+ * @param[in]  B        Address of matrix B
+ * @param[in]  ldb      leading dimension of input matrix B
+ * @param[out] PackedB  Address of the packed matrix
+*/
+void
+MLASCALL
+MlasBf16GemmPackB(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const MLAS_BF16* B,
+    size_t ldb,
+    void* PackedB
+    );
+
+//
+// Sparse GEMM routines.
+//
+
+/**
+ * @brief Returns the fraction of non-zero elements of a weight matrix below
+ *        which MlasSparseGemm is faster than MlasGemm on this processor.
+*/
+float
+MLASCALL
+MlasSparseGemmDensityThreshold();
+
+/**
+ * @brief For sparse GEMM, returns size of the packing buffer needed for
+ *        the right hand side matrix B
+ *
+ * @param[in]  TransB          Whether B is stored transposed (N x K)
+ * @param[in]  N               Number of columns
+ * @param[in]  K               Number of rows
+ * @param[in]  B               Address of matrix B
+ * @param[in]  ldb             leading dimension of input matrix B
+ * @param[in]  MaximumDensity  Maximum fraction of non-zero elements of B
+ * @return  size of the packing buffer, 0 if B holds more than
+ *          MaximumDensity * N * K non-zero elements
+*/
+size_t
+MLASCALL
+MlasSparseGemmPackBSize(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb,
+    float MaximumDensity
+    );
+
+/**
+ * @brief For sparse GEMM, pack the non-zero elements of the right hand
+ *        side matrix B
+ *
+ * @param[in]  TransB   Whether B is stored transposed (N x K)
+ * @param[in]  N        Number of columns
+ * @param[in]  K        Number of rows
+ * @param[in]  B        Address of matrix B
+ * @param[in]  ldb      leading dimension of input matrix B
+ * @param[out] PackedB  Address of the packed matrix
+*/
+void
+MLASCALL
+MlasSparseGemmPackB(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb,
+    void* PackedB
+    );
+
+/**
+ * @brief Single precision GEMM with a sparse B packed by MlasSparseGemmPackB:
+ *        C = alpha * A * B + beta * C
+ *
+ *        Only the non-zero elements of B are multiplied, so an infinite or
+ *        NaN element of A does not propagate through the zero elements of B.
+ *
+ * @param[in]     TransA      Whether A is stored transposed (K x M)
+ * @param[in]     M           row size of matrix A and C
+ * @param[in]     N           column size of matrix B and C
+ * @param[in]     K           column size of matrix A and row size of matrix B
+ * @param[in]     alpha       scale of the product
+ * @param[in]     A           address of matrix A
+ * @param[in]     lda         leading dimension of A
+ * @param[in]     PackedB     address of the packed matrix B
+ * @param[in]     beta        scale of C, C is not read when beta is 0
+ * @param[inout]  C           address of matrix C
+ * @param[in]     ldc         leading dimension of C
+ * @param[in]     ThreadPool
+*/
+void
+MLASCALL
+MlasSparseGemm(
+    CBLAS_TRANSPOSE TransA,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const void* PackedB,
+    float beta,
+    float* C,
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool
+    );
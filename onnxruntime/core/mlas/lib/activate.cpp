@@ -404,6 +404,75 @@ Return Value:
     }
 }
 
+template<MLAS_ACTIVATION_KIND ActivationKind>
+void
+MlasActivationComputeRow(
+    float* Buffer,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine applies an activation function that is computed from a
+    vectorized math routine to a row of the output matrix. The row is processed
+    in chunks that fit in a temporary buffer on the stack.
+
+Arguments:
+
+    Buffer - Supplies the row of the output matrix.
+
+    N - Supplies the number of columns of the output matrix.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    constexpr size_t ChunkSize = 256;
+    float Temp[ChunkSize];
+
+    while (N > 0) {
+
+        const size_t n = std::min(N, ChunkSize);
+
+        if constexpr (ActivationKind == MlasGeluActivation) {
+
+            //
+            // Gelu(x) = 0.5 * x * (1 + erf(x / sqrt(2)))
+            //
+
+            for (size_t i = 0; i < n; i++) {
+                Temp[i] = Buffer[i] * 0.70710678118654752f;
+            }
+
+            MlasComputeErf(Temp, Temp, n);
+
+            for (size_t i = 0; i < n; i++) {
+                Buffer[i] = 0.5f * Buffer[i] * (1.0f + Temp[i]);
+            }
+
+        } else {
+
+            static_assert(ActivationKind == MlasSiluActivation);
+
+            //
+            // Silu(x) = x * sigmoid(x)
+            //
+
+            MlasComputeLogistic(Buffer, Temp, n);
+
+            for (size_t i = 0; i < n; i++) {
+                Buffer[i] *= Temp[i];
+            }
+        }
+
+        Buffer += n;
+        N -= n;
+    }
+}
+
 void
 MLASCALL
 MlasActivation(
@@ -510,6 +579,34 @@ Return Value:
             break;
         }
 
+        case MlasGeluActivation:
+        {
+            if (Bias != nullptr) {
+                MlasActivationKernel<MlasIdentityActivation, true>(Activation, Buffer, Bias, M, N, ldc);
+            }
+
+            while (M-- > 0) {
+                MlasActivationComputeRow<MlasGeluActivation>(Buffer, N);
+                Buffer += ldc;
+            }
+
+            break;
+        }
+
+        case MlasSiluActivation:
+        {
+            if (Bias != nullptr) {
+                MlasActivationKernel<MlasIdentityActivation, true>(Activation, Buffer, Bias, M, N, ldc);
+            }
+
+            while (M-- > 0) {
+                MlasActivationComputeRow<MlasSiluActivation>(Buffer, N);
+                Buffer += ldc;
+            }
+
+            break;
+        }
+
         case MlasActivationKindCount:
         {
             MLAS_THROW_EX(std::runtime_error, "bad mlas activation kind");
@@ -517,3 +614,92 @@ Return Value:
         }
     }
 }
+
+void
+MLASCALL
+MlasGemmEpilogue(
+    const MLAS_GEMM_EPILOGUE* Epilogue,
+    float* C,
+    size_t ldc,
+    size_t StartM,
+    size_t StartN,
+    size_t CountM,
+    size_t CountN
+    )
+/*++
+
+Routine Description:
+
+    This routine applies the epilogue of a GEMM operation to a block of the
+    output matrix.
+
+Arguments:
+
+    Epilogue - Supplies the operations to apply.
+
+    C - Supplies the address of the block of the output matrix.
+
+    ldc - Supplies the first dimension of the output matrix.
+
+    StartM - Supplies the first row of the block in the output matrix.
+
+    StartN - Supplies the first column of the block in the output matrix.
+
+    CountM - Supplies the number of rows of the block.
+
+    CountN - Supplies the number of columns of the block.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const float* Bias = (Epilogue->Bias != nullptr) ? Epilogue->Bias + StartN : nullptr;
+    const float* Residual = (Epilogue->Residual != nullptr) ?
+        Epilogue->Residual + StartM * Epilogue->ldr + StartN : nullptr;
+
+    if (Bias != nullptr || Residual != nullptr) {
+
+        for (size_t m = 0; m < CountM; m++) {
+
+            float* c = C + m * ldc;
+            const float* r = (Residual != nullptr) ? Residual + m * Epilogue->ldr : nullptr;
+            size_t n = 0;
+
+            for (; n + 4 <= CountN; n += 4) {
+
+                MLAS_FLOAT32X4 Vector = MlasLoadFloat32x4(c + n);
+
+                if (Bias != nullptr) {
+                    Vector = MlasAddFloat32x4(Vector, MlasLoadFloat32x4(Bias + n));
+                }
+
+                if (r != nullptr) {
+                    Vector = MlasAddFloat32x4(Vector, MlasLoadFloat32x4(r + n));
+                }
+
+                MlasStoreFloat32x4(c + n, Vector);
+            }
+
+            for (; n < CountN; n++) {
+
+                float Scalar = c[n];
+
+                if (Bias != nullptr) {
+                    Scalar += Bias[n];
+                }
+
+                if (r != nullptr) {
+                    Scalar += r[n];
+                }
+
+                c[n] = Scalar;
+            }
+        }
+    }
+
+    if (Epilogue->Activation.ActivationKind != MlasIdentityActivation) {
+        MlasActivation(&Epilogue->Activation, C, nullptr, CountM, CountN, ldc);
+    }
+}
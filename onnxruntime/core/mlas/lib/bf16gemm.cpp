@@ -0,0 +1,498 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    bf16gemm.cpp
+
+Abstract:
+
+    This module implements the bfloat16 matrix/matrix multiply operation.
+
+    The products are accumulated in single precision. The result is stored
+    in single precision, or rounded to bfloat16 after the bias is added.
+
+--*/
+
+#include "mlasi.h"
+#include "bf16gemm.h"
+
+#include <vector>
+
+//
+// Define the default striding parameters. The packed blocks of A and B and
+// the accumulators of a block of C use 320KB, which fits in the L2 cache.
+//
+
+constexpr size_t MLAS_BF16_GEMM_STRIDEM = 128;
+constexpr size_t MLAS_BF16_GEMM_STRIDEN = 256;
+constexpr size_t MLAS_BF16_GEMM_STRIDEK = 256;
+
+static_assert(MLAS_BF16_GEMM_STRIDEK % MLAS_BF16_GEMM_PACKED_K == 0);
+static_assert(MLAS_BF16_GEMM_STRIDEN % MLAS_BF16_GEMM_PANEL_N == 0);
+
+void
+MlasBf16GemmKernel(
+    const uint16_t* A,
+    size_t lda,
+    const uint16_t* PackedB,
+    size_t PanelStride,
+    float* C,
+    size_t ldc,
+    size_t CountM,
+    size_t CountN,
+    size_t CountK,
+    bool ZeroMode
+    )
+/*++
+
+Routine Description:
+
+    This routine is the fallback implementation of the bfloat16 GEMM kernel
+    for processors without bfloat16 dot product instructions. The blocks of A
+    and B are widened to single precision, which is exact, and multiplied with
+    the single precision GEMM.
+
+Arguments:
+
+    See MLAS_BF16_GEMM_KERNEL.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t PaddedN = MlasDivRoundup(CountN, MLAS_BF16_GEMM_PANEL_N) * MLAS_BF16_GEMM_PANEL_N;
+
+    static thread_local std::vector<float> FloatBuffer;
+    FloatBuffer.resize(CountM * CountK + CountK * PaddedN);
+
+    float* FloatA = FloatBuffer.data();
+    float* FloatB = FloatA + CountM * CountK;
+
+    for (size_t m = 0; m < CountM; m++) {
+        for (size_t k = 0; k < CountK; k++) {
+            FloatA[m * CountK + k] = MlasBf16ToFloat(A[m * lda + k]);
+        }
+    }
+
+    //
+    // Deinterleave the pairs of rows of the packed panels.
+    //
+
+    for (size_t n = 0; n < PaddedN; n += MLAS_BF16_GEMM_PANEL_N) {
+
+        const uint16_t* b = PackedB + (n / MLAS_BF16_GEMM_PANEL_N) * PanelStride;
+
+        for (size_t k = 0; k < CountK; k += 2) {
+
+            float* Row0 = FloatB + k * PaddedN + n;
+            float* Row1 = Row0 + PaddedN;
+
+            for (size_t i = 0; i < MLAS_BF16_GEMM_PANEL_N; i++) {
+                Row0[i] = MlasBf16ToFloat(b[2 * i]);
+                Row1[i] = MlasBf16ToFloat(b[2 * i + 1]);
+            }
+
+            b += 2 * MLAS_BF16_GEMM_PANEL_N;
+        }
+    }
+
+    MlasGemm(CblasNoTrans, CblasNoTrans, CountM, CountN, CountK, 1.0f, FloatA, CountK,
+             FloatB, PaddedN, ZeroMode ? 0.0f : 1.0f, C, ldc, nullptr);
+}
+
+const MLAS_BF16_GEMM_DISPATCH MlasBf16GemmDispatchDefault = {
+    MlasBf16GemmKernel,
+};
+
+MLAS_FORCEINLINE
+const MLAS_BF16_GEMM_DISPATCH*
+MlasBf16GemmGetDispatch()
+{
+    const MLAS_BF16_GEMM_DISPATCH* Dispatch = GetMlasPlatform().Bf16GemmDispatch;
+    return (Dispatch != nullptr) ? Dispatch : &MlasBf16GemmDispatchDefault;
+}
+
+bool
+MLASCALL
+MlasBf16AccelerationSupported()
+{
+    return GetMlasPlatform().Bf16GemmDispatch != nullptr;
+}
+
+void
+MlasBf16GemmCopyPackB(
+    uint16_t* D,
+    const uint16_t* B,
+    size_t ldb,
+    bool TransB,
+    size_t CountN,
+    size_t CountK,
+    size_t PaddedK
+    )
+/*++
+
+Routine Description:
+
+    This routine copies a block of matrix B to the packed format described in
+    bf16gemm.h. The depth is padded with zeros to PaddedK and the columns to a
+    multiple of the panel width.
+
+Arguments:
+
+    D - Supplies the address of the packed buffer.
+
+    B - Supplies the address of the block of matrix B.
+
+    ldb - Supplies the leading dimension of matrix B.
+
+    TransB - Supplies true if matrix B is stored transposed (N x K).
+
+    CountN - Supplies the number of columns of the block.
+
+    CountK - Supplies the number of rows of the block.
+
+    PaddedK - Supplies the padded depth of the packed block.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    for (size_t n = 0; n < CountN; n += MLAS_BF16_GEMM_PANEL_N) {
+
+        const size_t CountPanelN = std::min(CountN - n, MLAS_BF16_GEMM_PANEL_N);
+
+        for (size_t k = 0; k < PaddedK; k += 2) {
+
+            uint16_t* d = D + k * MLAS_BF16_GEMM_PANEL_N;
+
+            for (size_t i = 0; i < MLAS_BF16_GEMM_PANEL_N; i++) {
+
+                uint16_t b0 = 0;
+                uint16_t b1 = 0;
+
+                if (i < CountPanelN) {
+                    if (TransB) {
+                        const uint16_t* b = B + (n + i) * ldb + k;
+                        b0 = (k < CountK) ? b[0] : 0;
+                        b1 = (k + 1 < CountK) ? b[1] : 0;
+                    } else {
+                        const uint16_t* b = B + k * ldb + n + i;
+                        b0 = (k < CountK) ? b[0] : 0;
+                        b1 = (k + 1 < CountK) ? b[ldb] : 0;
+                    }
+                }
+
+                d[2 * i] = b0;
+                d[2 * i + 1] = b1;
+            }
+        }
+
+        D += PaddedK * MLAS_BF16_GEMM_PANEL_N;
+    }
+}
+
+void
+MlasBf16GemmCopyA(
+    uint16_t* D,
+    const uint16_t* A,
+    size_t lda,
+    size_t CountM,
+    size_t CountK,
+    size_t PaddedK
+    )
+/*++
+
+Routine Description:
+
+    This routine copies a block of matrix A to a buffer with PaddedK columns
+    and a row count padded to a multiple of 16. The padding is zero filled.
+
+Arguments:
+
+    D - Supplies the address of the buffer.
+
+    A - Supplies the address of the block of matrix A.
+
+    lda - Supplies the leading dimension of matrix A.
+
+    CountM - Supplies the number of rows of the block.
+
+    CountK - Supplies the number of columns of the block.
+
+    PaddedK - Supplies the padded number of columns of the buffer.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t PaddedM = MlasDivRoundup(CountM, 16) * 16;
+
+    for (size_t m = 0; m < PaddedM; m++) {
+        if (m < CountM) {
+            std::memcpy(D, A + m * lda, CountK * sizeof(uint16_t));
+            std::fill_n(D + CountK, PaddedK - CountK, uint16_t(0));
+        } else {
+            std::fill_n(D, PaddedK, uint16_t(0));
+        }
+        D += PaddedK;
+    }
+}
+
+void
+MlasBf16GemmOperation(
+    const MLAS_BF16_GEMM_DISPATCH* Dispatch,
+    const size_t N,
+    const size_t K,
+    const MLAS_BF16_GEMM_DATA_PARAMS* Data,
+    const size_t RangeStartM,
+    const size_t RangeCountM,
+    const size_t RangeStartN,
+    const size_t RangeCountN
+    )
+/*++
+
+Routine Description:
+
+    This routine computes a block of the result matrix. RangeCountM shall not
+    exceed MLAS_BF16_GEMM_STRIDEM, and RangeStartN shall be a multiple of the
+    panel width.
+
+Arguments:
+
+    Dispatch - Supplies the kernel dispatch.
+
+    N - Supplies the number of columns of matrix B and C.
+
+    K - Supplies the depth of the multiplication.
+
+    Data - Supplies the parameters of the operation.
+
+    RangeStartM, RangeCountM - Supplies the rows of the block.
+
+    RangeStartN, RangeCountN - Supplies the columns of the block.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_UNREFERENCED_PARAMETER(N);
+
+    const size_t PackedASize = UpAlignSize(MLAS_BF16_GEMM_STRIDEM * MLAS_BF16_GEMM_STRIDEK * sizeof(uint16_t));
+    const size_t PackedBSize = UpAlignSize(MLAS_BF16_GEMM_STRIDEN * MLAS_BF16_GEMM_STRIDEK * sizeof(uint16_t));
+    const size_t AccumulatorSize = UpAlignSize(MLAS_BF16_GEMM_STRIDEM * MLAS_BF16_GEMM_STRIDEN * sizeof(float));
+
+    MlasThreadedBufAlloc(PackedASize + PackedBSize + AccumulatorSize);
+    uint8_t* Buffer = ThreadedBufHolder.get();
+
+    uint16_t* PackedA = reinterpret_cast<uint16_t*>(Buffer);
+    uint16_t* PackedBBuffer = reinterpret_cast<uint16_t*>(Buffer + PackedASize);
+    float* Accumulators = reinterpret_cast<float*>(Buffer + PackedASize + PackedBSize);
+
+    const uint16_t* A = reinterpret_cast<const uint16_t*>(Data->A) + RangeStartM * Data->lda;
+    const bool BIsPacked = (Data->ldb == 0);
+    const size_t TotalPaddedK = MlasDivRoundup(K, MLAS_BF16_GEMM_PACKED_K) * MLAS_BF16_GEMM_PACKED_K;
+
+    for (size_t n = 0; n < RangeCountN; n += MLAS_BF16_GEMM_STRIDEN) {
+
+        const size_t CountN = std::min(RangeCountN - n, MLAS_BF16_GEMM_STRIDEN);
+        const size_t StartN = RangeStartN + n;
+
+        //
+        // Accumulate in the result matrix when it is single precision, else in
+        // the thread local buffer.
+        //
+
+        float* C;
+        size_t ldc;
+
+        if (Data->CIsBf16) {
+            C = Accumulators;
+            ldc = MLAS_BF16_GEMM_STRIDEN;
+        } else {
+            C = reinterpret_cast<float*>(Data->C) + RangeStartM * Data->ldc + StartN;
+            ldc = Data->ldc;
+        }
+
+        if (K == 0) {
+            for (size_t m = 0; m < RangeCountM; m++) {
+                std::fill_n(C + m * ldc, CountN, 0.0f);
+            }
+        }
+
+        for (size_t k = 0; k < K; k += MLAS_BF16_GEMM_STRIDEK) {
+
+            const size_t CountK = std::min(K - k, MLAS_BF16_GEMM_STRIDEK);
+            const size_t PaddedK = MlasDivRoundup(CountK, MLAS_BF16_GEMM_PACKED_K) * MLAS_BF16_GEMM_PACKED_K;
+
+            const uint16_t* PackedB;
+            size_t PanelStride;
+
+            if (BIsPacked) {
+                PanelStride = TotalPaddedK * MLAS_BF16_GEMM_PANEL_N;
+                PackedB = reinterpret_cast<const uint16_t*>(Data->B) +
+                    (StartN / MLAS_BF16_GEMM_PANEL_N) * PanelStride + k * MLAS_BF16_GEMM_PANEL_N;
+            } else {
+                PanelStride = PaddedK * MLAS_BF16_GEMM_PANEL_N;
+                MlasBf16GemmCopyPackB(PackedBBuffer,
+                                      reinterpret_cast<const uint16_t*>(Data->B) + k * Data->ldb + StartN,
+                                      Data->ldb, false, CountN, CountK, PaddedK);
+                PackedB = PackedBBuffer;
+            }
+
+            MlasBf16GemmCopyA(PackedA, A + k, Data->lda, RangeCountM, CountK, PaddedK);
+
+            Dispatch->Kernel(PackedA, PaddedK, PackedB, PanelStride, C, ldc,
+                             RangeCountM, CountN, PaddedK, k == 0);
+        }
+
+        //
+        // Add the bias and convert the result to bfloat16 if requested.
+        //
+
+        const float* Bias = (Data->Bias != nullptr) ? Data->Bias + StartN : nullptr;
+
+        if (Data->CIsBf16) {
+
+            uint16_t* Output = reinterpret_cast<uint16_t*>(Data->C) + RangeStartM * Data->ldc + StartN;
+
+            for (size_t m = 0; m < RangeCountM; m++) {
+                const float* c = C + m * ldc;
+                uint16_t* o = Output + m * Data->ldc;
+                for (size_t i = 0; i < CountN; i++) {
+                    o[i] = MlasFloatToBf16((Bias != nullptr) ? c[i] + Bias[i] : c[i]);
+                }
+            }
+
+        } else if (Bias != nullptr) {
+
+            for (size_t m = 0; m < RangeCountM; m++) {
+                float* c = C + m * ldc;
+                for (size_t i = 0; i < CountN; i++) {
+                    c[i] += Bias[i];
+                }
+            }
+        }
+    }
+}
+
+void
+MLASCALL
+MlasBf16GemmBatch(
+    const size_t M,
+    const size_t N,
+    const size_t K,
+    const size_t BatchN,
+    const MLAS_BF16_GEMM_DATA_PARAMS* DataParams,
+    MLAS_THREADPOOL* ThreadPool
+    )
+{
+    //
+    // Nothing to compute for an empty output. This also keeps the thread
+    // partitioning below from dividing by zero.
+    //
+
+    if (M == 0 || N == 0 || BatchN == 0) {
+        return;
+    }
+
+    const MLAS_BF16_GEMM_DISPATCH* Dispatch = MlasBf16GemmGetDispatch();
+
+    const size_t StrideM = MLAS_BF16_GEMM_STRIDEM;
+    const size_t ThreadCountM = MlasDivRoundup(M, StrideM);
+
+    //
+    // Compute the number of target threads given the complexity of the
+    // operation. Small requests should run using the single threaded path.
+    //
+
+    const double Complexity = double(M) * double(N) * double(K) * double(BatchN);
+
+    ptrdiff_t TargetThreadCount = ptrdiff_t(Complexity / double(MLAS_QGEMM_THREAD_COMPLEXITY)) + 1;
+
+    ptrdiff_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (TargetThreadCount >= MaximumThreadCount) {
+        TargetThreadCount = MaximumThreadCount;
+    }
+
+    //
+    // Split the columns when there are fewer blocks of rows than threads. The
+    // column stride stays a multiple of the panel width.
+    //
+
+    size_t StrideN = N;
+
+    if (size_t(TargetThreadCount) > ThreadCountM * BatchN) {
+        const size_t ThreadsPerGemm = MlasDivRoundup(size_t(TargetThreadCount), BatchN);
+        const size_t ThreadCountN = MlasDivRoundup(ThreadsPerGemm, ThreadCountM);
+        StrideN = MlasDivRoundup(N, ThreadCountN);
+        StrideN = MlasDivRoundup(StrideN, MLAS_BF16_GEMM_PANEL_N) * MLAS_BF16_GEMM_PANEL_N;
+    }
+
+    if (StrideN == 0) {
+        StrideN = MLAS_BF16_GEMM_PANEL_N;
+    }
+
+    const size_t ThreadCountN = MlasDivRoundup(N, StrideN);
+    const size_t ThreadsPerGemm = ThreadCountM * ThreadCountN;
+
+    MlasTrySimpleParallel(ThreadPool, ThreadsPerGemm * BatchN, [&](ptrdiff_t tid) {
+        const auto gemm_i = tid / ThreadsPerGemm;
+        const auto blk_i = tid % ThreadsPerGemm;
+        auto Data = &DataParams[gemm_i];
+
+        const size_t ThreadIdN = blk_i / ThreadCountM;
+        const size_t ThreadIdM = blk_i % ThreadCountM;
+
+        const size_t RangeStartM = ThreadIdM * StrideM;
+        const size_t RangeCountM = std::min(M - RangeStartM, StrideM);
+
+        const size_t RangeStartN = ThreadIdN * StrideN;
+        const size_t RangeCountN = std::min(N - RangeStartN, StrideN);
+
+        MlasBf16GemmOperation(Dispatch, N, K, Data, RangeStartM, RangeCountM, RangeStartN, RangeCountN);
+    });
+}
+
+size_t
+MLASCALL
+MlasBf16GemmPackBSize(
+    size_t N,
+    size_t K
+    )
+{
+    const size_t PaddedN = MlasDivRoundup(N, MLAS_BF16_GEMM_PANEL_N) * MLAS_BF16_GEMM_PANEL_N;
+    const size_t PaddedK = MlasDivRoundup(K, MLAS_BF16_GEMM_PACKED_K) * MLAS_BF16_GEMM_PACKED_K;
+    const size_t BytesRequired = PaddedN * PaddedK * sizeof(uint16_t);
+    const size_t BufferAlignment = MlasGetPreferredBufferAlignment();
+    return (BytesRequired + BufferAlignment - 1) & ~(BufferAlignment - 1);
+}
+
+void
+MLASCALL
+MlasBf16GemmPackB(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const MLAS_BF16* B,
+    size_t ldb,
+    void* PackedB
+    )
+{
+    const size_t PaddedK = MlasDivRoundup(K, MLAS_BF16_GEMM_PACKED_K) * MLAS_BF16_GEMM_PACKED_K;
+
+    MlasBf16GemmCopyPackB(reinterpret_cast<uint16_t*>(PackedB), reinterpret_cast<const uint16_t*>(B),
+                          ldb, TransB == CblasTrans, N, K, PaddedK);
+}
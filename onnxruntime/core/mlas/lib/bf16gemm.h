@@ -0,0 +1,111 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    bf16gemm.h
+
+Abstract:
+
+    This module defines the packing format and the kernel interface of the
+    bfloat16 matrix/matrix multiply operation.
+
+    Matrix B is packed in panels of 16 columns. Each panel holds pairs of
+    consecutive rows of B, interleaved per column, so that a row of the panel
+    is laid out as:
+
+        B[k][n], B[k+1][n], B[k][n+1], B[k+1][n+1], ... B[k+1][n+15]
+
+    This is the operand layout of the VDPBF16PS and TDPBF16PS instructions.
+    The depth of the packed matrix is padded with zeros to a multiple of
+    MLAS_BF16_GEMM_PACKED_K, and the columns to a multiple of 16.
+
+    Matrix A is copied by the driver into a buffer whose row count is padded
+    to a multiple of 16 and whose depth is padded to a multiple of
+    MLAS_BF16_GEMM_PACKED_K, so that the kernels can process full tiles
+    without bounds checks on A.
+
+--*/
+
+#pragma once
+
+#include "mlasi.h"
+
+#include <cstring>
+
+constexpr size_t MLAS_BF16_GEMM_PANEL_N = 16;
+constexpr size_t MLAS_BF16_GEMM_PACKED_K = 32;
+
+/**
+ * @brief Convert a bfloat16 value to single precision.
+ */
+MLAS_FORCEINLINE
+float
+MlasBf16ToFloat(
+    uint16_t Value
+    )
+{
+    uint32_t Bits = uint32_t(Value) << 16;
+    float Result;
+    std::memcpy(&Result, &Bits, sizeof(Result));
+    return Result;
+}
+
+/**
+ * @brief Convert a single precision value to bfloat16, rounding to the
+ *        nearest even value.
+ */
+MLAS_FORCEINLINE
+uint16_t
+MlasFloatToBf16(
+    float Value
+    )
+{
+    uint32_t Bits;
+    std::memcpy(&Bits, &Value, sizeof(Bits));
+    if ((Bits & 0x7FFFFFFF) > 0x7F800000) {
+        // Keep NaN a quiet NaN.
+        return uint16_t((Bits >> 16) | 0x0040);
+    }
+    Bits += 0x7FFF + ((Bits >> 16) & 1);
+    return uint16_t(Bits >> 16);
+}
+
+/**
+ * @brief Bfloat16 GEMM kernel: C (+)= A x B for a block of A and B
+ *
+ * @param[in]  A            Address of the copied block of A, rows padded to a
+ *                          multiple of 16
+ * @param[in]  lda          Leading dimension of A, in elements
+ * @param[in]  PackedB      Address of the first panel of the packed block of B
+ * @param[in]  PanelStride  Distance between consecutive panels, in elements
+ * @param[out] C            Address of the result matrix
+ * @param[in]  ldc          Leading dimension of C
+ * @param[in]  CountM       # of rows to compute
+ * @param[in]  CountN       # of columns to compute
+ * @param[in]  CountK       Depth of the block, multiple of MLAS_BF16_GEMM_PACKED_K
+ * @param[in]  ZeroMode     Whether C is overwritten instead of accumulated
+ */
+typedef
+void
+(MLAS_BF16_GEMM_KERNEL)(
+    const uint16_t* A,
+    size_t lda,
+    const uint16_t* PackedB,
+    size_t PanelStride,
+    float* C,
+    size_t ldc,
+    size_t CountM,
+    size_t CountN,
+    size_t CountK,
+    bool ZeroMode
+    );
+
+struct MLAS_BF16_GEMM_DISPATCH {
+    MLAS_BF16_GEMM_KERNEL* Kernel;
+};
+
+MLAS_BF16_GEMM_KERNEL MlasBf16GemmKernel;
@@ -0,0 +1,259 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    bf16gemm_kernel_amx.cpp
+
+Abstract:
+
+    This module implements the bfloat16 GEMM kernel using the AMX-BF16
+    TDPBF16PS instruction.
+
+    All tiles are configured with 16 rows of 64 bytes. A tile of A holds 16
+    rows of 32 elements, a tile of B holds 16 rows of a packed panel, which
+    are 32 rows of B interleaved in pairs, and a tile of C holds 16 x 16
+    single precision accumulators. The kernel computes 32 x 32 blocks of C
+    with four accumulator tiles.
+
+--*/
+
+#include "mlasi.h"
+#include "bf16gemm.h"
+#include "amx_common.h"
+
+#define TMM0 0
+#define TMM1 1
+#define TMM2 2
+#define TMM3 3
+#define TMM4 4
+#define TMM5 5
+#define TMM6 6
+#define TMM7 7
+
+constexpr size_t TILE_M = 16;
+constexpr size_t TILE_N = 16;
+constexpr size_t TILE_ROW_BYTES = 64;
+
+// Tile configure structure
+struct MLAS_BF16_TILECONFIG {
+    uint8_t palette_id = 0;
+    uint8_t start_row = 0;
+    uint8_t reserved1[14] = {0};
+    uint16_t colb[8] = {0};
+    uint8_t reserved2[16] = {0};
+    uint8_t rows[8] = {0};
+    uint8_t reserved3[8] = {0};
+};
+
+static
+void
+MlasBf16GemmAmxThreadInit()
+/*++
+
+Routine Description:
+
+    This routine loads the tile configuration of the kernel, unless the
+    current thread already uses it.
+
+Arguments:
+
+    None.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    static thread_local MLAS_BF16_TILECONFIG tc;
+
+    if (tc.palette_id == 0) {
+        tc.palette_id = 1;
+        for (int t = 0; t < 8; t++) {
+            tc.rows[t] = TILE_M;
+            tc.colb[t] = TILE_ROW_BYTES;
+        }
+    }
+
+    MLAS_BF16_TILECONFIG current_tc;
+    tile_storeconfig(&current_tc);
+
+    if (std::memcmp(&current_tc, &tc, sizeof(tc)) != 0) {
+        tile_loadconfig(&tc);
+    }
+}
+
+static
+MLAS_FORCEINLINE
+const float*
+MlasBf16GemmAmxLoadTileSource(
+    const float* C,
+    size_t ldc,
+    size_t CountM,
+    size_t CountN,
+    bool ZeroMode,
+    float* Tile,
+    size_t& Stride
+    )
+/*++
+
+Routine Description:
+
+    This routine returns the address of the initial values of an accumulator
+    tile. A full tile is loaded directly from the result matrix, else the
+    valid elements are copied to a zero filled buffer.
+
+--*/
+{
+    if (!ZeroMode && CountM == TILE_M && CountN == TILE_N) {
+        Stride = ldc * sizeof(float);
+        return C;
+    }
+
+    std::fill_n(Tile, TILE_M * TILE_N, 0.0f);
+
+    if (!ZeroMode) {
+        for (size_t m = 0; m < CountM; m++) {
+            std::copy_n(C + m * ldc, CountN, Tile + m * TILE_N);
+        }
+    }
+
+    Stride = TILE_ROW_BYTES;
+    return Tile;
+}
+
+static
+MLAS_FORCEINLINE
+void
+MlasBf16GemmAmxStoreTile(
+    float* C,
+    size_t ldc,
+    size_t CountM,
+    size_t CountN,
+    const float* Tile
+    )
+{
+    const __mmask16 Mask = __mmask16((uint32_t(1) << CountN) - 1);
+
+    for (size_t m = 0; m < CountM; m++) {
+        _mm512_mask_storeu_ps(C + m * ldc, Mask, _mm512_loadu_ps(Tile + m * TILE_N));
+    }
+}
+
+void
+MlasBf16GemmKernelAmx(
+    const uint16_t* A,
+    size_t lda,
+    const uint16_t* PackedB,
+    size_t PanelStride,
+    float* C,
+    size_t ldc,
+    size_t CountM,
+    size_t CountN,
+    size_t CountK,
+    bool ZeroMode
+    )
+{
+    MlasBf16GemmAmxThreadInit();
+
+    MLAS_DECLSPEC_ALIGN(float Tile4[TILE_M * TILE_N], 64);
+    MLAS_DECLSPEC_ALIGN(float Tile5[TILE_M * TILE_N], 64);
+    MLAS_DECLSPEC_ALIGN(float Tile6[TILE_M * TILE_N], 64);
+    MLAS_DECLSPEC_ALIGN(float Tile7[TILE_M * TILE_N], 64);
+
+    const size_t StrideA = lda * sizeof(uint16_t);
+
+    for (size_t n = 0; n < CountN; n += 2 * TILE_N) {
+
+        const size_t n0 = std::min(CountN - n, TILE_N);
+        const size_t n1 = (CountN - n > TILE_N) ? std::min(CountN - n - TILE_N, TILE_N) : 0;
+
+        const uint16_t* b0 = PackedB + (n / TILE_N) * PanelStride;
+        const uint16_t* b1 = b0 + PanelStride;
+
+        for (size_t m = 0; m < CountM; m += 2 * TILE_M) {
+
+            //
+            // The rows of the copied A are padded to a multiple of 16, so the
+            // second tile of rows can be loaded whenever it has a valid row.
+            //
+
+            const size_t m0 = std::min(CountM - m, TILE_M);
+            const size_t m1 = (CountM - m > TILE_M) ? std::min(CountM - m - TILE_M, TILE_M) : 0;
+
+            float* c = C + m * ldc + n;
+            float* c16 = c + TILE_M * ldc;
+            size_t Stride;
+            const float* Source;
+
+            Source = MlasBf16GemmAmxLoadTileSource(c, ldc, m0, n0, ZeroMode, Tile4, Stride);
+            tile_loadd(TMM4, Source, Stride);
+            if (n1 != 0) {
+                Source = MlasBf16GemmAmxLoadTileSource(c + TILE_N, ldc, m0, n1, ZeroMode, Tile6, Stride);
+                tile_loadd(TMM6, Source, Stride);
+            }
+            if (m1 != 0) {
+                Source = MlasBf16GemmAmxLoadTileSource(c16, ldc, m1, n0, ZeroMode, Tile5, Stride);
+                tile_loadd(TMM5, Source, Stride);
+                if (n1 != 0) {
+                    Source = MlasBf16GemmAmxLoadTileSource(c16 + TILE_N, ldc, m1, n1, ZeroMode, Tile7, Stride);
+                    tile_loadd(TMM7, Source, Stride);
+                }
+            }
+
+            const uint16_t* a = A + m * lda;
+            const uint16_t* a16 = a + TILE_M * lda;
+
+            for (size_t k = 0; k < CountK; k += MLAS_BF16_GEMM_PACKED_K) {
+
+                tile_loadd(TMM0, b0 + k * TILE_N, TILE_ROW_BYTES);
+                tile_loadd(TMM2, a + k, StrideA);
+                tile_dpbf16ps(TMM4, TMM2, TMM0);
+
+                if (n1 != 0) {
+                    tile_loadd(TMM1, b1 + k * TILE_N, TILE_ROW_BYTES);
+                    tile_dpbf16ps(TMM6, TMM2, TMM1);
+                }
+
+                if (m1 != 0) {
+                    tile_loadd(TMM3, a16 + k, StrideA);
+                    tile_dpbf16ps(TMM5, TMM3, TMM0);
+                    if (n1 != 0) {
+                        tile_dpbf16ps(TMM7, TMM3, TMM1);
+                    }
+                }
+            }
+
+            if (m0 == TILE_M && n0 == TILE_N) {
+                tile_stored(TMM4, c, ldc * sizeof(float));
+            } else {
+                tile_stored(TMM4, Tile4, TILE_ROW_BYTES);
+                MlasBf16GemmAmxStoreTile(c, ldc, m0, n0, Tile4);
+            }
+            if (n1 != 0) {
+                if (m0 == TILE_M && n1 == TILE_N) {
+                    tile_stored(TMM6, c + TILE_N, ldc * sizeof(float));
+                } else {
+                    tile_stored(TMM6, Tile6, TILE_ROW_BYTES);
+                    MlasBf16GemmAmxStoreTile(c + TILE_N, ldc, m0, n1, Tile6);
+                }
+            }
+            if (m1 != 0) {
+                tile_stored(TMM5, Tile5, TILE_ROW_BYTES);
+                MlasBf16GemmAmxStoreTile(c16, ldc, m1, n0, Tile5);
+                if (n1 != 0) {
+                    tile_stored(TMM7, Tile7, TILE_ROW_BYTES);
+                    MlasBf16GemmAmxStoreTile(c16 + TILE_N, ldc, m1, n1, Tile7);
+                }
+            }
+        }
+    }
+}
+
+const MLAS_BF16_GEMM_DISPATCH MlasBf16GemmDispatchAmx = {
+    MlasBf16GemmKernelAmx,
+};
@@ -0,0 +1,212 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    bf16gemm_kernel_avx512bf16.cpp
+
+Abstract:
+
+    This module implements the bfloat16 GEMM kernel using the AVX512-BF16
+    VDPBF16PS instruction.
+
+    Each instruction multiplies a pair of consecutive elements of a row of A,
+    broadcast to all lanes, with the interleaved pairs of a row of a packed
+    panel of B, and accumulates the sum of the two products of each of the 16
+    columns in single precision.
+
+--*/
+
+#include "mlasi.h"
+#include "bf16gemm.h"
+
+#include <utility>
+
+template<size_t PanelCount>
+MLAS_FORCEINLINE
+void
+MlasBf16GemmKernelAvx512Bf16Row(
+    __m512 (&Accumulators)[PanelCount],
+    const uint16_t* a,
+    const __m512i (&BElements)[PanelCount]
+    )
+{
+    int32_t APair;
+    std::memcpy(&APair, a, sizeof(APair));
+    const __m512bh ABroadcast = (__m512bh)_mm512_set1_epi32(APair);
+
+    Accumulators[0] = _mm512_dpbf16_ps(Accumulators[0], ABroadcast, (__m512bh)BElements[0]);
+    if constexpr (PanelCount > 1) {
+        Accumulators[1] = _mm512_dpbf16_ps(Accumulators[1], ABroadcast, (__m512bh)BElements[1]);
+    }
+}
+
+template<size_t PanelCount>
+MLAS_FORCEINLINE
+void
+MlasBf16GemmKernelAvx512Bf16StoreRow(
+    const __m512 (&Accumulators)[PanelCount],
+    float* c,
+    const __mmask16 (&Masks)[PanelCount],
+    bool ZeroMode
+    )
+{
+    for (size_t p = 0; p < PanelCount; p++) {
+
+        __m512 Result = Accumulators[p];
+
+        if (!ZeroMode) {
+            Result = _mm512_add_ps(Result, _mm512_maskz_loadu_ps(Masks[p], c + p * MLAS_BF16_GEMM_PANEL_N));
+        }
+
+        _mm512_mask_storeu_ps(c + p * MLAS_BF16_GEMM_PANEL_N, Masks[p], Result);
+    }
+}
+
+template<size_t PanelCount, size_t... Rows>
+MLAS_FORCEINLINE
+void
+MlasBf16GemmKernelAvx512Bf16Block(
+    const uint16_t* A,
+    size_t lda,
+    const uint16_t* PackedB,
+    size_t PanelStride,
+    float* C,
+    size_t ldc,
+    size_t CountN,
+    size_t CountK,
+    bool ZeroMode,
+    std::index_sequence<Rows...>
+    )
+/*++
+
+Routine Description:
+
+    This routine computes a block of up to 8 rows and 2 panels of the result
+    matrix. The rows are expanded with a parameter pack so that the
+    accumulators stay in registers.
+
+Arguments:
+
+    See MLAS_BF16_GEMM_KERNEL. CountN is the number of columns of the block.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    constexpr size_t RowCount = sizeof...(Rows);
+
+    __m512 Accumulators[RowCount][PanelCount];
+
+    ((Accumulators[Rows][0] = _mm512_setzero_ps()), ...);
+    if constexpr (PanelCount > 1) {
+        ((Accumulators[Rows][1] = _mm512_setzero_ps()), ...);
+    }
+
+    for (size_t k = 0; k < CountK; k += 2) {
+
+        __m512i BElements[PanelCount];
+
+        BElements[0] = _mm512_loadu_si512(PackedB + k * MLAS_BF16_GEMM_PANEL_N);
+        if constexpr (PanelCount > 1) {
+            BElements[1] = _mm512_loadu_si512(PackedB + PanelStride + k * MLAS_BF16_GEMM_PANEL_N);
+        }
+
+        (MlasBf16GemmKernelAvx512Bf16Row<PanelCount>(Accumulators[Rows], A + Rows * lda + k, BElements), ...);
+    }
+
+    __mmask16 Masks[PanelCount];
+
+    for (size_t p = 0; p < PanelCount; p++) {
+        const size_t ColumnCount = std::min(CountN - p * MLAS_BF16_GEMM_PANEL_N, MLAS_BF16_GEMM_PANEL_N);
+        Masks[p] = __mmask16((uint32_t(1) << ColumnCount) - 1);
+    }
+
+    (MlasBf16GemmKernelAvx512Bf16StoreRow<PanelCount>(Accumulators[Rows], C + Rows * ldc, Masks, ZeroMode), ...);
+}
+
+template<size_t PanelCount>
+MLAS_FORCEINLINE
+void
+MlasBf16GemmKernelAvx512Bf16Panels(
+    const uint16_t* A,
+    size_t lda,
+    const uint16_t* PackedB,
+    size_t PanelStride,
+    float* C,
+    size_t ldc,
+    size_t CountM,
+    size_t CountN,
+    size_t CountK,
+    bool ZeroMode
+    )
+{
+    while (CountM >= 8) {
+        MlasBf16GemmKernelAvx512Bf16Block<PanelCount>(A, lda, PackedB, PanelStride, C, ldc, CountN, CountK,
+                                                      ZeroMode, std::make_index_sequence<8>());
+        A += 8 * lda;
+        C += 8 * ldc;
+        CountM -= 8;
+    }
+
+    if (CountM >= 4) {
+        MlasBf16GemmKernelAvx512Bf16Block<PanelCount>(A, lda, PackedB, PanelStride, C, ldc, CountN, CountK,
+                                                      ZeroMode, std::make_index_sequence<4>());
+        A += 4 * lda;
+        C += 4 * ldc;
+        CountM -= 4;
+    }
+
+    switch (CountM) {
+        case 3:
+            MlasBf16GemmKernelAvx512Bf16Block<PanelCount>(A, lda, PackedB, PanelStride, C, ldc, CountN, CountK,
+                                                          ZeroMode, std::make_index_sequence<3>());
+            break;
+        case 2:
+            MlasBf16GemmKernelAvx512Bf16Block<PanelCount>(A, lda, PackedB, PanelStride, C, ldc, CountN, CountK,
+                                                          ZeroMode, std::make_index_sequence<2>());
+            break;
+        case 1:
+            MlasBf16GemmKernelAvx512Bf16Block<PanelCount>(A, lda, PackedB, PanelStride, C, ldc, CountN, CountK,
+                                                          ZeroMode, std::make_index_sequence<1>());
+            break;
+    }
+}
+
+void
+MlasBf16GemmKernelAvx512Bf16(
+    const uint16_t* A,
+    size_t lda,
+    const uint16_t* PackedB,
+    size_t PanelStride,
+    float* C,
+    size_t ldc,
+    size_t CountM,
+    size_t CountN,
+    size_t CountK,
+    bool ZeroMode
+    )
+{
+    for (size_t n = 0; n < CountN; n += 2 * MLAS_BF16_GEMM_PANEL_N) {
+
+        const size_t BlockN = std::min(CountN - n, 2 * MLAS_BF16_GEMM_PANEL_N);
+        const uint16_t* b = PackedB + (n / MLAS_BF16_GEMM_PANEL_N) * PanelStride;
+
+        if (BlockN > MLAS_BF16_GEMM_PANEL_N) {
+            MlasBf16GemmKernelAvx512Bf16Panels<2>(A, lda, b, PanelStride, C + n, ldc,
+                                                  CountM, BlockN, CountK, ZeroMode);
+        } else {
+            MlasBf16GemmKernelAvx512Bf16Panels<1>(A, lda, b, PanelStride, C + n, ldc,
+                                                  CountM, BlockN, CountK, ZeroMode);
+        }
+    }
+}
+
+const MLAS_BF16_GEMM_DISPATCH MlasBf16GemmDispatchAvx512Bf16 = {
+    MlasBf16GemmKernelAvx512Bf16,
+};
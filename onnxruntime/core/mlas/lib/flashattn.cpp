@@ -0,0 +1,329 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    flashattn.cpp
+
+Abstract:
+
+    This module implements a tiled attention routine that computes the softmax
+    of the attention scores online, so that the scores of all queries and keys
+    are never materialized at once.
+
+    The queries of a head are processed in blocks. For each block, the keys and
+    values are visited in blocks while a running maximum and a running sum of
+    the exponentials are maintained for each query, and the partial output is
+    rescaled whenever the maximum changes.
+
+--*/
+
+#include "mlasi.h"
+
+#include <cmath>
+#include <limits>
+
+//
+// Number of queries and keys processed per block. The scores of a block use
+// 64KB, which fits in the L2 cache together with the output accumulators.
+//
+
+constexpr size_t MLAS_FLASH_ATTENTION_QUERY_BLOCK = 64;
+constexpr size_t MLAS_FLASH_ATTENTION_KV_BLOCK = 256;
+
+struct MLAS_FLASH_ATTENTION_WORK_BLOCK {
+    const MLAS_FLASH_ATTENTION_PARAMS* Params;
+    size_t QueryBlockCount;
+    ptrdiff_t ThreadCount;
+};
+
+void
+MlasFlashAttentionQueryBlock(
+    const MLAS_FLASH_ATTENTION_PARAMS* Params,
+    size_t BatchIndex,
+    size_t HeadIndex,
+    size_t QueryStart,
+    size_t QueryCount,
+    float* Scores,
+    float* Accumulation,
+    float* RowMaximum,
+    float* RowSum
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the attention output of a block of queries of one
+    head.
+
+Arguments:
+
+    Params - Supplies the attention parameters.
+
+    BatchIndex - Supplies the batch index of the head.
+
+    HeadIndex - Supplies the index of the head.
+
+    QueryStart - Supplies the index of the first query of the block.
+
+    QueryCount - Supplies the number of queries of the block.
+
+    Scores - Supplies a buffer of QueryCount x MLAS_FLASH_ATTENTION_KV_BLOCK
+        elements for the scores of a block of keys.
+
+    Accumulation - Supplies a buffer of QueryCount x VHeadSize elements for the
+        unnormalized output.
+
+    RowMaximum - Supplies a buffer of QueryCount elements for the running
+        maximum of the scores.
+
+    RowSum - Supplies a buffer of QueryCount elements for the running sum of
+        the exponentials.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t S = Params->SequenceLength;
+    const size_t T = Params->KvSequenceLength;
+    const size_t H = Params->QkHeadSize;
+    const size_t Hv = Params->VHeadSize;
+    const size_t HeadOffset = BatchIndex * Params->NumHeads + HeadIndex;
+
+    const float* Query = Params->Query + (HeadOffset * S + QueryStart) * H;
+    const float* Key = Params->Key + HeadOffset * T * H;
+    const float* Value = Params->Value + HeadOffset * T * Hv;
+    const float* KeyBias = (Params->KeyBias != nullptr) ? Params->KeyBias + BatchIndex * T : nullptr;
+
+    //
+    // With a causal mask, query i attends to keys [0, T - S + i], so the keys
+    // after the last query of the block are skipped.
+    //
+
+    const size_t PastLength = T - S;
+    const size_t KeyEnd = Params->Causal ? (std::min)(T, PastLength + QueryStart + QueryCount) : T;
+
+    for (size_t i = 0; i < QueryCount; i++) {
+        RowMaximum[i] = -std::numeric_limits<float>::infinity();
+        RowSum[i] = 0.0f;
+    }
+    std::fill_n(Accumulation, QueryCount * Hv, 0.0f);
+
+    for (size_t KeyStart = 0; KeyStart < KeyEnd; KeyStart += MLAS_FLASH_ATTENTION_KV_BLOCK) {
+
+        const size_t KeyCount = (std::min)(MLAS_FLASH_ATTENTION_KV_BLOCK, KeyEnd - KeyStart);
+
+        //
+        // Scores = Scale * Query x Key'
+        //
+
+        MlasGemm(CblasNoTrans, CblasTrans, QueryCount, KeyCount, H, Params->Scale,
+                 Query, H, Key + KeyStart * H, H, 0.0f, Scores, KeyCount, nullptr);
+
+        for (size_t i = 0; i < QueryCount; i++) {
+
+            float* Row = Scores + i * KeyCount;
+            size_t ValidCount = KeyCount;
+
+            if (Params->Causal) {
+                const size_t Limit = PastLength + QueryStart + i + 1;
+                ValidCount = (Limit > KeyStart) ? (std::min)(KeyCount, Limit - KeyStart) : 0;
+            }
+
+            if (ValidCount == 0) {
+                std::fill_n(Row, KeyCount, 0.0f);
+                continue;
+            }
+
+            if (KeyBias != nullptr) {
+                for (size_t j = 0; j < ValidCount; j++) {
+                    Row[j] += KeyBias[KeyStart + j];
+                }
+            }
+
+            //
+            // Update the running maximum, replace the scores with their
+            // exponentials, and rescale the partial results of the previous
+            // blocks.
+            //
+
+#if defined(MLAS_TARGET_AMD64)
+            const float BlockMaximum = GetMlasPlatform().ReduceMaximumF32Kernel(Row, ValidCount);
+#else
+            const float BlockMaximum = MlasReduceMaximumF32Kernel(Row, ValidCount);
+#endif
+            const float Maximum = (std::max)(RowMaximum[i], BlockMaximum);
+            float NegativeMaximum = -Maximum;
+
+#if defined(MLAS_TARGET_AMD64)
+            const float BlockSum = GetMlasPlatform().ComputeSumExpF32Kernel(Row, Row, ValidCount, &NegativeMaximum);
+#else
+            const float BlockSum = MlasComputeSumExpF32Kernel(Row, Row, ValidCount, &NegativeMaximum);
+#endif
+            std::fill(Row + ValidCount, Row + KeyCount, 0.0f);
+
+            const float Correction = std::exp(RowMaximum[i] - Maximum);
+            if (Correction != 1.0f) {
+                float* Output = Accumulation + i * Hv;
+                for (size_t d = 0; d < Hv; d++) {
+                    Output[d] *= Correction;
+                }
+            }
+
+            RowSum[i] = RowSum[i] * Correction + BlockSum;
+            RowMaximum[i] = Maximum;
+        }
+
+        //
+        // Accumulation += Scores x Value
+        //
+
+        MlasGemm(CblasNoTrans, CblasNoTrans, QueryCount, Hv, KeyCount, 1.0f,
+                 Scores, KeyCount, Value + KeyStart * Hv, Hv, 1.0f, Accumulation, Hv, nullptr);
+    }
+
+    //
+    // Normalize and store the output with shape (B, S, N, H_v).
+    //
+
+    for (size_t i = 0; i < QueryCount; i++) {
+        const float Reciprocal = 1.0f / RowSum[i];
+        const float* Source = Accumulation + i * Hv;
+        float* Output = Params->Output +
+            ((BatchIndex * S + QueryStart + i) * Params->NumHeads + HeadIndex) * Hv;
+        for (size_t d = 0; d < Hv; d++) {
+            Output[d] = Source[d] * Reciprocal;
+        }
+    }
+}
+
+void
+MlasFlashAttentionThreaded(
+    void* Context,
+    ptrdiff_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    flash attention operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const auto* WorkBlock = (MLAS_FLASH_ATTENTION_WORK_BLOCK*)Context;
+    const MLAS_FLASH_ATTENTION_PARAMS* Params = WorkBlock->Params;
+
+    //
+    // Partition the operation along the blocks of queries of all heads.
+    //
+
+    const size_t QueryBlockCount = WorkBlock->QueryBlockCount;
+    const size_t TotalWork = Params->BatchSize * Params->NumHeads * QueryBlockCount;
+
+    size_t WorkIndex;
+    size_t WorkRemaining;
+
+    MlasPartitionWork(Index, WorkBlock->ThreadCount, TotalWork, &WorkIndex, &WorkRemaining);
+
+    if (WorkRemaining == 0) {
+        return;
+    }
+
+    const size_t QueryBlock = (std::min)(MLAS_FLASH_ATTENTION_QUERY_BLOCK, Params->SequenceLength);
+    const size_t ScoresSize = UpAlignSize(QueryBlock * MLAS_FLASH_ATTENTION_KV_BLOCK * sizeof(float));
+    const size_t AccumulationSize = UpAlignSize(QueryBlock * Params->VHeadSize * sizeof(float));
+    const size_t RowSize = UpAlignSize(QueryBlock * sizeof(float));
+
+    MlasThreadedBufAlloc(ScoresSize + AccumulationSize + RowSize * 2);
+    uint8_t* Buffer = ThreadedBufHolder.get();
+
+    float* Scores = reinterpret_cast<float*>(Buffer);
+    float* Accumulation = reinterpret_cast<float*>(Buffer + ScoresSize);
+    float* RowMaximum = reinterpret_cast<float*>(Buffer + ScoresSize + AccumulationSize);
+    float* RowSum = reinterpret_cast<float*>(Buffer + ScoresSize + AccumulationSize + RowSize);
+
+    for (size_t w = WorkIndex; w < WorkIndex + WorkRemaining; w++) {
+
+        const size_t HeadOffset = w / QueryBlockCount;
+        const size_t QueryStart = (w % QueryBlockCount) * QueryBlock;
+        const size_t QueryCount = (std::min)(QueryBlock, Params->SequenceLength - QueryStart);
+
+        MlasFlashAttentionQueryBlock(Params, HeadOffset / Params->NumHeads, HeadOffset % Params->NumHeads,
+                                     QueryStart, QueryCount, Scores, Accumulation, RowMaximum, RowSum);
+    }
+}
+
+void
+MLASCALL
+MlasFlashAttention(
+    const MLAS_FLASH_ATTENTION_PARAMS* Params,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the attention output
+        Output = Softmax(Scale * Query x Key' + KeyBias) x Value
+    per head, without materializing the attention scores of all queries and
+    keys.
+
+    Keys excluded by the causal mask are skipped, so they do not contribute to
+    the output even when all other keys are masked by the key bias.
+
+Arguments:
+
+    Params - Supplies the attention parameters.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (Params->SequenceLength == 0 || Params->BatchSize == 0 || Params->NumHeads == 0) {
+        return;
+    }
+
+    MLAS_FLASH_ATTENTION_WORK_BLOCK WorkBlock;
+
+    WorkBlock.Params = Params;
+
+    const size_t QueryBlock = (std::min)(MLAS_FLASH_ATTENTION_QUERY_BLOCK, Params->SequenceLength);
+    WorkBlock.QueryBlockCount = (Params->SequenceLength + QueryBlock - 1) / QueryBlock;
+
+    //
+    // Limit the number of threads to the number of query blocks of all heads.
+    //
+
+    const size_t TotalWork = Params->BatchSize * Params->NumHeads * WorkBlock.QueryBlockCount;
+
+    ptrdiff_t ThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (size_t(ThreadCount) > TotalWork) {
+        ThreadCount = ptrdiff_t(TotalWork);
+    }
+
+    WorkBlock.ThreadCount = ThreadCount;
+
+    MlasExecuteThreaded(MlasFlashAttentionThreaded, &WorkBlock, ThreadCount, ThreadPool);
+}
@@ -0,0 +1,85 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    sparse_gemm_avx2.cpp
+
+Abstract:
+
+    This module implements the sparse GEMM kernel with AVX2/FMA3 instructions.
+
+    A tile of 16 rows of A is held in two ymm registers. Pairs of non-zero
+    elements of B are accumulated in separate registers to hide the latency
+    of the multiply-add instructions.
+
+--*/
+
+#include "mlasi.h"
+#include "sparse_gemm.h"
+
+void
+MlasSparseGemmKernelAvx2(
+    const float* AT,
+    const float* Values,
+    const uint16_t* Rows,
+    const uint32_t* ColumnStart,
+    size_t CountN,
+    float* CT,
+    bool ZeroMode
+    )
+{
+    for (size_t n = 0; n < CountN; n++) {
+
+        __m256 Accumulator0 = _mm256_setzero_ps();
+        __m256 Accumulator1 = _mm256_setzero_ps();
+        __m256 Accumulator2 = _mm256_setzero_ps();
+        __m256 Accumulator3 = _mm256_setzero_ps();
+
+        size_t i = ColumnStart[n];
+        const size_t End = ColumnStart[n + 1];
+
+        for (; i + 2 <= End; i += 2) {
+
+            const float* a0 = AT + size_t(Rows[i]) * MLAS_SPARSE_GEMM_TILE_M;
+            const float* a1 = AT + size_t(Rows[i + 1]) * MLAS_SPARSE_GEMM_TILE_M;
+            const __m256 BElement0 = _mm256_broadcast_ss(Values + i);
+            const __m256 BElement1 = _mm256_broadcast_ss(Values + i + 1);
+
+            Accumulator0 = _mm256_fmadd_ps(_mm256_loadu_ps(a0), BElement0, Accumulator0);
+            Accumulator1 = _mm256_fmadd_ps(_mm256_loadu_ps(a0 + 8), BElement0, Accumulator1);
+            Accumulator2 = _mm256_fmadd_ps(_mm256_loadu_ps(a1), BElement1, Accumulator2);
+            Accumulator3 = _mm256_fmadd_ps(_mm256_loadu_ps(a1 + 8), BElement1, Accumulator3);
+        }
+
+        if (i < End) {
+
+            const float* a0 = AT + size_t(Rows[i]) * MLAS_SPARSE_GEMM_TILE_M;
+            const __m256 BElement0 = _mm256_broadcast_ss(Values + i);
+
+            Accumulator0 = _mm256_fmadd_ps(_mm256_loadu_ps(a0), BElement0, Accumulator0);
+            Accumulator1 = _mm256_fmadd_ps(_mm256_loadu_ps(a0 + 8), BElement0, Accumulator1);
+        }
+
+        Accumulator0 = _mm256_add_ps(Accumulator0, Accumulator2);
+        Accumulator1 = _mm256_add_ps(Accumulator1, Accumulator3);
+
+        if (!ZeroMode) {
+            Accumulator0 = _mm256_add_ps(Accumulator0, _mm256_loadu_ps(CT));
+            Accumulator1 = _mm256_add_ps(Accumulator1, _mm256_loadu_ps(CT + 8));
+        }
+
+        _mm256_storeu_ps(CT, Accumulator0);
+        _mm256_storeu_ps(CT + 8, Accumulator1);
+
+        CT += MLAS_SPARSE_GEMM_TILE_M;
+    }
+}
+
+const MLAS_SPARSE_GEMM_DISPATCH MlasSparseGemmDispatchAvx2 = {
+    MlasSparseGemmKernelAvx2,
+    0.2f,
+};
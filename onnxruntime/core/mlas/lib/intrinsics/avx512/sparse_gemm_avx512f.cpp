@@ -0,0 +1,78 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    sparse_gemm_avx512f.cpp
+
+Abstract:
+
+    This module implements the sparse GEMM kernel with AVX512F instructions.
+
+    A tile of 16 rows of A is held in a zmm register. Groups of four non-zero
+    elements of B are accumulated in separate registers to hide the latency
+    of the multiply-add instructions.
+
+--*/
+
+#include "mlasi.h"
+#include "sparse_gemm.h"
+
+void
+MlasSparseGemmKernelAvx512F(
+    const float* AT,
+    const float* Values,
+    const uint16_t* Rows,
+    const uint32_t* ColumnStart,
+    size_t CountN,
+    float* CT,
+    bool ZeroMode
+    )
+{
+    for (size_t n = 0; n < CountN; n++) {
+
+        __m512 Accumulator0 = _mm512_setzero_ps();
+        __m512 Accumulator1 = _mm512_setzero_ps();
+        __m512 Accumulator2 = _mm512_setzero_ps();
+        __m512 Accumulator3 = _mm512_setzero_ps();
+
+        size_t i = ColumnStart[n];
+        const size_t End = ColumnStart[n + 1];
+
+        for (; i + 4 <= End; i += 4) {
+
+            Accumulator0 = _mm512_fmadd_ps(_mm512_loadu_ps(AT + size_t(Rows[i]) * MLAS_SPARSE_GEMM_TILE_M),
+                                           _mm512_set1_ps(Values[i]), Accumulator0);
+            Accumulator1 = _mm512_fmadd_ps(_mm512_loadu_ps(AT + size_t(Rows[i + 1]) * MLAS_SPARSE_GEMM_TILE_M),
+                                           _mm512_set1_ps(Values[i + 1]), Accumulator1);
+            Accumulator2 = _mm512_fmadd_ps(_mm512_loadu_ps(AT + size_t(Rows[i + 2]) * MLAS_SPARSE_GEMM_TILE_M),
+                                           _mm512_set1_ps(Values[i + 2]), Accumulator2);
+            Accumulator3 = _mm512_fmadd_ps(_mm512_loadu_ps(AT + size_t(Rows[i + 3]) * MLAS_SPARSE_GEMM_TILE_M),
+                                           _mm512_set1_ps(Values[i + 3]), Accumulator3);
+        }
+
+        for (; i < End; i++) {
+            Accumulator0 = _mm512_fmadd_ps(_mm512_loadu_ps(AT + size_t(Rows[i]) * MLAS_SPARSE_GEMM_TILE_M),
+                                           _mm512_set1_ps(Values[i]), Accumulator0);
+        }
+
+        Accumulator0 = _mm512_add_ps(_mm512_add_ps(Accumulator0, Accumulator1),
+                                     _mm512_add_ps(Accumulator2, Accumulator3));
+
+        if (!ZeroMode) {
+            Accumulator0 = _mm512_add_ps(Accumulator0, _mm512_loadu_ps(CT));
+        }
+
+        _mm512_storeu_ps(CT, Accumulator0);
+
+        CT += MLAS_SPARSE_GEMM_TILE_M;
+    }
+}
+
+const MLAS_SPARSE_GEMM_DISPATCH MlasSparseGemmDispatchAvx512F = {
+    MlasSparseGemmKernelAvx512F,
+    0.15f,
+};
@@ -0,0 +1,512 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    layernorm.cpp
+
+Abstract:
+
+    This module implements routines to compute the layer normalization of a
+    row of single precision values, including the skip and bias additions of
+    SkipLayerNormalization and the root mean square variant (RMSNorm).
+
+    The statistics of a row are gathered in a single pass that accumulates
+    the sum and the sum of squares, then a second pass normalizes the row.
+
+--*/
+
+#include "mlasi.h"
+
+void
+MlasLayerNormalizationStatisticsKernel(
+    const float* Input,
+    size_t N,
+    float* Sum,
+    float* SumSquare
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the sum and the sum of squares of a vector.
+
+Arguments:
+
+    Input - Supplies the input vector.
+
+    N - Supplies the number of elements to process.
+
+    Sum - Receives the sum of the elements.
+
+    SumSquare - Receives the sum of the squares of the elements.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    float Accumulator = 0.0f;
+    float AccumulatorSquare = 0.0f;
+
+    if (N >= 4) {
+
+        MLAS_FLOAT32X4 Accumulator0 = MlasZeroFloat32x4();
+        MLAS_FLOAT32X4 AccumulatorSquare0 = MlasZeroFloat32x4();
+
+        if (N >= 8) {
+
+            MLAS_FLOAT32X4 Accumulator1 = MlasZeroFloat32x4();
+            MLAS_FLOAT32X4 AccumulatorSquare1 = MlasZeroFloat32x4();
+
+            while (N >= 8) {
+
+                MLAS_FLOAT32X4 Vector0 = MlasLoadFloat32x4(Input);
+                MLAS_FLOAT32X4 Vector1 = MlasLoadFloat32x4(Input + 4);
+
+                Accumulator0 = MlasAddFloat32x4(Accumulator0, Vector0);
+                Accumulator1 = MlasAddFloat32x4(Accumulator1, Vector1);
+                AccumulatorSquare0 = MlasMultiplyAddFloat32x4(Vector0, Vector0, AccumulatorSquare0);
+                AccumulatorSquare1 = MlasMultiplyAddFloat32x4(Vector1, Vector1, AccumulatorSquare1);
+
+                Input += 8;
+                N -= 8;
+            }
+
+            Accumulator0 = MlasAddFloat32x4(Accumulator0, Accumulator1);
+            AccumulatorSquare0 = MlasAddFloat32x4(AccumulatorSquare0, AccumulatorSquare1);
+        }
+
+        if (N >= 4) {
+
+            MLAS_FLOAT32X4 Vector0 = MlasLoadFloat32x4(Input);
+
+            Accumulator0 = MlasAddFloat32x4(Accumulator0, Vector0);
+            AccumulatorSquare0 = MlasMultiplyAddFloat32x4(Vector0, Vector0, AccumulatorSquare0);
+
+            Input += 4;
+            N -= 4;
+        }
+
+        Accumulator = MlasReduceAddFloat32x4(Accumulator0);
+        AccumulatorSquare = MlasReduceAddFloat32x4(AccumulatorSquare0);
+    }
+
+    while (N > 0) {
+
+        Accumulator += *Input;
+        AccumulatorSquare += *Input * *Input;
+
+        Input += 1;
+        N -= 1;
+    }
+
+    *Sum = Accumulator;
+    *SumSquare = AccumulatorSquare;
+}
+
+template<bool HasSkipBias>
+void
+MlasLayerNormalizationSkipStatisticsKernel(
+    const float* Input,
+    const float* Skip,
+    const float* SkipBias,
+    float* SkipOutput,
+    size_t N,
+    float* Sum,
+    float* SumSquare
+    )
+/*++
+
+Routine Description:
+
+    This routine adds a skip vector and an optional bias vector to the input
+    vector, stores the result and computes its sum and sum of squares.
+
+Arguments:
+
+    Input - Supplies the input vector.
+
+    Skip - Supplies the skip vector.
+
+    SkipBias - Supplies the optional bias vector.
+
+    SkipOutput - Supplies the vector that receives the sum of the vectors.
+
+    N - Supplies the number of elements to process.
+
+    Sum - Receives the sum of the elements.
+
+    SumSquare - Receives the sum of the squares of the elements.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    float Accumulator = 0.0f;
+    float AccumulatorSquare = 0.0f;
+
+    if (N >= 4) {
+
+        MLAS_FLOAT32X4 Accumulator0 = MlasZeroFloat32x4();
+        MLAS_FLOAT32X4 AccumulatorSquare0 = MlasZeroFloat32x4();
+
+        while (N >= 4) {
+
+            MLAS_FLOAT32X4 Vector0 = MlasAddFloat32x4(MlasLoadFloat32x4(Input), MlasLoadFloat32x4(Skip));
+
+            if (HasSkipBias) {
+                Vector0 = MlasAddFloat32x4(Vector0, MlasLoadFloat32x4(SkipBias));
+                SkipBias += 4;
+            }
+
+            MlasStoreFloat32x4(SkipOutput, Vector0);
+
+            Accumulator0 = MlasAddFloat32x4(Accumulator0, Vector0);
+            AccumulatorSquare0 = MlasMultiplyAddFloat32x4(Vector0, Vector0, AccumulatorSquare0);
+
+            Input += 4;
+            Skip += 4;
+            SkipOutput += 4;
+            N -= 4;
+        }
+
+        Accumulator = MlasReduceAddFloat32x4(Accumulator0);
+        AccumulatorSquare = MlasReduceAddFloat32x4(AccumulatorSquare0);
+    }
+
+    while (N > 0) {
+
+        float Value = *Input++ + *Skip++;
+
+        if (HasSkipBias) {
+            Value += *SkipBias++;
+        }
+
+        *SkipOutput++ = Value;
+
+        Accumulator += Value;
+        AccumulatorSquare += Value * Value;
+
+        N -= 1;
+    }
+
+    *Sum = Accumulator;
+    *SumSquare = AccumulatorSquare;
+}
+
+template<bool HasBias>
+void
+MlasLayerNormalizationNormalizeKernel(
+    const float* Input,
+    const float* Scale,
+    const float* Bias,
+    float* Output,
+    size_t N,
+    float Mean,
+    float InvStdDev
+    )
+/*++
+
+Routine Description:
+
+    This routine normalizes a vector with the supplied statistics and applies
+    the scale and the optional bias vectors.
+
+Arguments:
+
+    Input - Supplies the input vector.
+
+    Scale - Supplies the scale vector.
+
+    Bias - Supplies the optional bias vector.
+
+    Output - Supplies the output vector. This may alias the input vector.
+
+    N - Supplies the number of elements to process.
+
+    Mean - Supplies the value subtracted from each element.
+
+    InvStdDev - Supplies the value multiplied with each centered element.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_FLOAT32X4 MeanVector = MlasBroadcastFloat32x4(Mean);
+    MLAS_FLOAT32X4 InvStdDevVector = MlasBroadcastFloat32x4(InvStdDev);
+
+    while (N >= 8) {
+
+        MLAS_FLOAT32X4 Vector0 = MlasSubtractFloat32x4(MlasLoadFloat32x4(Input), MeanVector);
+        MLAS_FLOAT32X4 Vector1 = MlasSubtractFloat32x4(MlasLoadFloat32x4(Input + 4), MeanVector);
+
+        Vector0 = MlasMultiplyFloat32x4(MlasMultiplyFloat32x4(Vector0, InvStdDevVector), MlasLoadFloat32x4(Scale));
+        Vector1 = MlasMultiplyFloat32x4(MlasMultiplyFloat32x4(Vector1, InvStdDevVector), MlasLoadFloat32x4(Scale + 4));
+
+        if (HasBias) {
+            Vector0 = MlasAddFloat32x4(Vector0, MlasLoadFloat32x4(Bias));
+            Vector1 = MlasAddFloat32x4(Vector1, MlasLoadFloat32x4(Bias + 4));
+            Bias += 8;
+        }
+
+        MlasStoreFloat32x4(Output, Vector0);
+        MlasStoreFloat32x4(Output + 4, Vector1);
+
+        Input += 8;
+        Scale += 8;
+        Output += 8;
+        N -= 8;
+    }
+
+    if (N >= 4) {
+
+        MLAS_FLOAT32X4 Vector0 = MlasSubtractFloat32x4(MlasLoadFloat32x4(Input), MeanVector);
+
+        Vector0 = MlasMultiplyFloat32x4(MlasMultiplyFloat32x4(Vector0, InvStdDevVector), MlasLoadFloat32x4(Scale));
+
+        if (HasBias) {
+            Vector0 = MlasAddFloat32x4(Vector0, MlasLoadFloat32x4(Bias));
+            Bias += 4;
+        }
+
+        MlasStoreFloat32x4(Output, Vector0);
+
+        Input += 4;
+        Scale += 4;
+        Output += 4;
+        N -= 4;
+    }
+
+    while (N > 0) {
+
+        float Value = (*Input++ - Mean) * InvStdDev * *Scale++;
+
+        if (HasBias) {
+            Value += *Bias++;
+        }
+
+        *Output++ = Value;
+
+        N -= 1;
+    }
+}
+
+void
+MlasLayerNormalizationComputeStatistics(
+    float Sum,
+    float SumSquare,
+    size_t N,
+    float Epsilon,
+    bool Simplified,
+    float* Mean,
+    float* InvStdDev
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the mean and the inverse of the standard deviation
+    (or of the root mean square) from the sum and the sum of squares of a row.
+
+Arguments:
+
+    Sum - Supplies the sum of the elements.
+
+    SumSquare - Supplies the sum of the squares of the elements.
+
+    N - Supplies the number of elements.
+
+    Epsilon - Supplies the value added to the variance for numeric stability.
+
+    Simplified - Supplies true to compute the root mean square statistics.
+
+    Mean - Receives the mean, or zero for the simplified form.
+
+    InvStdDev - Receives the inverse of the standard deviation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const float MeanSquare = SumSquare / float(N);
+
+    if (Simplified) {
+        *Mean = 0.0f;
+        *InvStdDev = 1.0f / std::sqrt(MeanSquare + Epsilon);
+    } else {
+        const float RowMean = Sum / float(N);
+        //
+        // The variance may round to a small negative value when computed
+        // from the sum of squares of nearly constant rows.
+        //
+        const float Variance = std::max(MeanSquare - RowMean * RowMean, 0.0f);
+        *Mean = RowMean;
+        *InvStdDev = 1.0f / std::sqrt(Variance + Epsilon);
+    }
+}
+
+void
+MLASCALL
+MlasLayerNormalization(
+    const float* Input,
+    const float* Scale,
+    const float* Bias,
+    float* Output,
+    float* Mean,
+    float* InvStdDev,
+    size_t CountM,
+    size_t CountN,
+    float Epsilon,
+    bool Simplified
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the layer normalization of a set of rows.
+
+Arguments:
+
+    Input - Supplies the input rows.
+
+    Scale - Supplies the scale vector of CountN elements.
+
+    Bias - Supplies the optional bias vector of CountN elements. This must be
+        null for the simplified form.
+
+    Output - Supplies the output rows. This may alias the input rows.
+
+    Mean - Supplies the optional buffer that receives the mean of each row.
+        This is not written for the simplified form.
+
+    InvStdDev - Supplies the optional buffer that receives the inverse of the
+        standard deviation (or of the root mean square) of each row.
+
+    CountM - Supplies the number of rows to process.
+
+    CountN - Supplies the number of elements of each row.
+
+    Epsilon - Supplies the value added to the variance for numeric stability.
+
+    Simplified - Supplies true to compute the root mean square normalization
+        (SimplifiedLayerNormalization/RMSNorm).
+
+Return Value:
+
+    None.
+
+--*/
+{
+    for (size_t m = 0; m < CountM; m++) {
+
+        float Sum;
+        float SumSquare;
+        float RowMean;
+        float RowInvStdDev;
+
+        MlasLayerNormalizationStatisticsKernel(Input, CountN, &Sum, &SumSquare);
+        MlasLayerNormalizationComputeStatistics(Sum, SumSquare, CountN, Epsilon, Simplified, &RowMean, &RowInvStdDev);
+
+        if (Bias != nullptr) {
+            MlasLayerNormalizationNormalizeKernel<true>(Input, Scale, Bias, Output, CountN, RowMean, RowInvStdDev);
+        } else {
+            MlasLayerNormalizationNormalizeKernel<false>(Input, Scale, nullptr, Output, CountN, RowMean, RowInvStdDev);
+        }
+
+        if (Mean != nullptr && !Simplified) {
+            Mean[m] = RowMean;
+        }
+
+        if (InvStdDev != nullptr) {
+            InvStdDev[m] = RowInvStdDev;
+        }
+
+        Input += CountN;
+        Output += CountN;
+    }
+}
+
+void
+MLASCALL
+MlasSkipLayerNormalization(
+    const float* Input,
+    const float* Skip,
+    const float* SkipBias,
+    const float* Scale,
+    const float* Bias,
+    float* Output,
+    float* SkipOutput,
+    size_t CountN,
+    float Epsilon,
+    bool Simplified
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the layer normalization of the sum of an input row,
+    a skip row and an optional bias row.
+
+Arguments:
+
+    Input - Supplies the input row.
+
+    Skip - Supplies the skip row.
+
+    SkipBias - Supplies the optional bias row added to the input row.
+
+    Scale - Supplies the scale vector of CountN elements.
+
+    Bias - Supplies the optional bias vector of CountN elements added after
+        normalization.
+
+    Output - Supplies the output row.
+
+    SkipOutput - Supplies the optional buffer that receives the sum of the
+        input, skip and bias rows. If null, the sum is staged in the output
+        row.
+
+    CountN - Supplies the number of elements of the row.
+
+    Epsilon - Supplies the value added to the variance for numeric stability.
+
+    Simplified - Supplies true to compute the root mean square normalization.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    float* Sum = (SkipOutput != nullptr) ? SkipOutput : Output;
+
+    float RowSum;
+    float RowSumSquare;
+    float RowMean;
+    float RowInvStdDev;
+
+    if (SkipBias != nullptr) {
+        MlasLayerNormalizationSkipStatisticsKernel<true>(Input, Skip, SkipBias, Sum, CountN, &RowSum, &RowSumSquare);
+    } else {
+        MlasLayerNormalizationSkipStatisticsKernel<false>(Input, Skip, nullptr, Sum, CountN, &RowSum, &RowSumSquare);
+    }
+
+    MlasLayerNormalizationComputeStatistics(RowSum, RowSumSquare, CountN, Epsilon, Simplified, &RowMean, &RowInvStdDev);
+
+    if (Bias != nullptr) {
+        MlasLayerNormalizationNormalizeKernel<true>(Sum, Scale, Bias, Output, CountN, RowMean, RowInvStdDev);
+    } else {
+        MlasLayerNormalizationNormalizeKernel<false>(Sum, Scale, nullptr, Output, CountN, RowMean, RowInvStdDev);
+    }
+}
@@ -270,6 +270,13 @@ operator!=(const MLFloat16& left, const MLFloat16& right)
     return left.val != right.val;
 }
 
+struct BFloat16 {
+    uint16_t val{0};
+
+    BFloat16() = default;
+    explicit constexpr BFloat16(uint16_t x) : val(x) {}
+};
+
 }
 
 #endif  // BUILD_MLAS_NO_ONNXRUNTIME
@@ -838,7 +845,10 @@ MlasSgemmOperation(
     size_t ldb,
     float beta,
     float* C,
-    size_t ldc
+    size_t ldc,
+    const MLAS_GEMM_EPILOGUE* Epilogue = nullptr,
+    size_t StartM = 0,
+    size_t StartN = 0
     );
 
 //
@@ -884,12 +894,25 @@ extern const MLAS_CONV_SYM_DISPATCH MlasConvSymS8DispatchDot;
 
 struct MLAS_Q8Q4GEMM_DISPATCH;
 
+extern const MLAS_Q8Q4GEMM_DISPATCH MlasQ8Q4GemmDispatchAvx2;
+extern const MLAS_Q8Q4GEMM_DISPATCH MlasQ8Q4GemmDispatchAvxVnni;
 extern const MLAS_Q8Q4GEMM_DISPATCH MlasQ8Q4GemmDispatchAvx512vnni;
 
 struct MLAS_FPQ4GEMM_DISPATCH;
 
+extern const MLAS_FPQ4GEMM_DISPATCH MlasFpQ4GemmDispatchAvx2;
 extern const MLAS_FPQ4GEMM_DISPATCH MlasFpQ4GemmDispatchAvx512;
 
+struct MLAS_BF16_GEMM_DISPATCH;
+
+extern const MLAS_BF16_GEMM_DISPATCH MlasBf16GemmDispatchAvx512Bf16;
+extern const MLAS_BF16_GEMM_DISPATCH MlasBf16GemmDispatchAmx;
+
+struct MLAS_SPARSE_GEMM_DISPATCH;
+
+extern const MLAS_SPARSE_GEMM_DISPATCH MlasSparseGemmDispatchAvx2;
+extern const MLAS_SPARSE_GEMM_DISPATCH MlasSparseGemmDispatchAvx512F;
+
 //
 // Quantized depthwise convolution kernels.
 //
@@ -1021,6 +1044,14 @@ struct MLAS_PLATFORM {
 
     const MLAS_FPQ4GEMM_DISPATCH* FpQ4GemmDispatch{nullptr};
     const MLAS_Q8Q4GEMM_DISPATCH* Q8Q4GemmDispatch{nullptr};
+    const MLAS_BF16_GEMM_DISPATCH* Bf16GemmDispatch{nullptr};
+    const MLAS_SPARSE_GEMM_DISPATCH* SparseGemmDispatch{nullptr};
+
+    //
+    // Identifies the instruction set the packing routines were selected for.
+    //
+
+    const char* PackedBufferIsa{"generic"};
 };
 
 inline
@@ -208,6 +208,7 @@ Return Value:
     this->GemmFloatKernel = MlasGemmFloatKernelSse;
     this->GemmU8S8Dispatch = &MlasGemmU8X8DispatchSse;
     this->GemmU8U8Dispatch = &MlasGemmU8X8DispatchSse;
+    this->PackedBufferIsa = "sse2";
 
 #if defined(MLAS_TARGET_AMD64)
 
@@ -258,6 +259,7 @@ Return Value:
 
     if ((Cpuid1[2] & 0x80000) != 0) {
         this->GemmU8S8Dispatch = &MlasGemmU8S8DispatchSse41;
+        this->PackedBufferIsa = "sse41";
     }
 
 #endif
@@ -316,6 +318,7 @@ Return Value:
                 this->GemmU8U8Dispatch = &MlasGemmU8U8DispatchAvx2;
                 this->GemmU8U8Kernel = MlasGemmU8U8KernelAvx2;
                 this->ConvSymU8S8Dispatch = &MlasConvSymDispatchAvx2;
+                this->PackedBufferIsa = "avx2";
 
                 this->GemmFloatKernel = MlasGemmFloatKernelFma3;
                 this->GemmDoubleKernel = MlasGemmDoubleKernelFma3;
@@ -334,6 +337,11 @@ Return Value:
                 this->ConvDepthwiseS8S8Kernel = MlasConvDepthwiseKernelAvx2<int8_t, int8_t>;
                 this->ConvDepthwiseS8U8Kernel = MlasConvDepthwiseKernelAvx2<int8_t, uint8_t>;
                 this->ComputeSumExpF32Kernel = MlasComputeSumExpF32KernelFma3;
+                this->SparseGemmDispatch = &MlasSparseGemmDispatchAvx2;
+#if !defined(ORT_MINIMAL_BUILD)
+                this->FpQ4GemmDispatch = &MlasFpQ4GemmDispatchAvx2;
+                this->Q8Q4GemmDispatch = &MlasQ8Q4GemmDispatchAvx2;
+#endif
 
                 //
                 // Check if the processor supports Hybrid core architecture.
@@ -360,6 +368,10 @@ Return Value:
                     this->GemmU8S8Kernel = MlasGemmU8S8KernelAvxVnni;
                     this->GemvU8S8Kernel = MlasGemvU8S8KernelAvxVnni;
                     this->ConvSymU8S8Dispatch = &MlasConvSymDispatchAvxVnni;
+                    this->PackedBufferIsa = "avxvnni";
+#if !defined(ORT_MINIMAL_BUILD) && defined(MLAS_AVXVNNI_INTRINSICS)
+                    this->Q8Q4GemmDispatch = &MlasQ8Q4GemmDispatchAvxVnni;
+#endif
                 }
 
 #if !defined(ORT_MINIMAL_BUILD)
@@ -384,8 +396,10 @@ Return Value:
                     this->ComputeSumExpF32Kernel = MlasComputeSumExpF32KernelAvx512F;
                     this->QuantizeLinearS8Kernel = MlasQuantizeLinearS8KernelAvx512F;
                     this->QuantizeLinearU8Kernel = MlasQuantizeLinearU8KernelAvx512F;
+                    this->SparseGemmDispatch = &MlasSparseGemmDispatchAvx512F;
                     this->NchwcBlockSize = 16;
                     this->PreferredBufferAlignment = 64;
+                    this->PackedBufferIsa = "avx512f";
 
                     //
                     // Check if the processor supports AVX512 core features
@@ -399,6 +413,7 @@ Return Value:
                         this->GemmU8U8Kernel = MlasGemmU8U8KernelAvx512Core;
                         this->ConvSymU8S8Dispatch = &MlasConvSymDispatchAvx512Core;
                         this->FpQ4GemmDispatch = &MlasFpQ4GemmDispatchAvx512;
+                        this->PackedBufferIsa = "avx512core";
 
                         //
                         // Check if the processor supports AVX512VNNI.
@@ -411,6 +426,15 @@ Return Value:
                             this->GemvU8S8Kernel = MlasGemvU8S8KernelAvx512Vnni;
                             this->ConvSymU8S8Dispatch = &MlasConvSymDispatchAvx512Vnni;
                             this->Q8Q4GemmDispatch = &MlasQ8Q4GemmDispatchAvx512vnni;
+                            this->PackedBufferIsa = "avx512vnni";
+                        }
+
+                        //
+                        // Check if the processor supports AVX512-BF16.
+                        //
+
+                        if ((Cpuid7_1[0] & 0x20) != 0) {
+                            this->Bf16GemmDispatch = &MlasBf16GemmDispatchAvx512Bf16;
                         }
                     }
                 }
@@ -426,6 +450,15 @@ Return Value:
                     if (MlasInitAMX()) {
                         this->GemmU8U8Dispatch = &MlasGemmU8S8DispatchAmx;
                         this->GemmU8S8Dispatch = &MlasGemmU8S8DispatchAmx;
+                        this->PackedBufferIsa = "amx";
+
+                        //
+                        // Check if the processor supports AMX-BF16.
+                        //
+
+                        if ((Cpuid7[3] & 0b1 << 22) != 0) {
+                            this->Bf16GemmDispatch = &MlasBf16GemmDispatchAmx;
+                        }
                     }
                 }
 #endif // __APPLE__
@@ -449,6 +482,7 @@ Return Value:
     this->SymmQgemmDispatch = &MlasSymmQgemmS8DispatchNeon;
     this->ConvSymU8S8Dispatch = &MlasConvSymU8DispatchNeon;
     this->ConvSymS8S8Dispatch = &MlasConvSymS8DispatchNeon;
+    this->PackedBufferIsa = "neon";
 
     //
     // Check if the processor supports ASIMD dot product instructions.
@@ -474,6 +508,7 @@ Return Value:
         this->SymmQgemmDispatch = &MlasSymmQgemmS8DispatchSdot;
         this->ConvSymU8S8Dispatch = &MlasConvSymU8DispatchDot;
         this->ConvSymS8S8Dispatch = &MlasConvSymS8DispatchDot;
+        this->PackedBufferIsa = "neon_dot";
     }
 
 #endif // MLAS_TARGET_ARM64
@@ -484,6 +519,7 @@ Return Value:
     this->QuantizeLinearU8Kernel = MlasQuantizeLinearU8Kernel;
     this->QuantizeLinearS16Kernel = MlasQuantizeLinearS16Kernel;
     this->QuantizeLinearU16Kernel = MlasQuantizeLinearU16Kernel;
+    this->PackedBufferIsa = "power";
 
 #if defined(__linux__)
     unsigned long hwcap2 = getauxval(AT_HWCAP2);
@@ -502,6 +538,7 @@ Return Value:
         this->GemmFloatKernel = MlasSgemmKernelPOWER10;
         this->GemmDoubleKernel = MlasDgemmKernelPOWER10;
         this->GemmU8X8Dispatch = &MlasGemm8X8DispatchPOWER10;
+        this->PackedBufferIsa = "power10";
     }
 #endif
 #endif
@@ -541,6 +578,34 @@ Return Value:
 #endif
 }
 
+const char*
+MLASCALL
+MlasGetPackedBufferIsa(
+    void
+    )
+/*++
+
+Routine Description:
+
+    This routine returns a string identifying the instruction set that the
+    packing routines of this library (MlasGemmPackB, MlasSymmQgemmPackB, ...)
+    produce buffers for. Buffers packed by a process that returned a different
+    identifier or a different MLAS_PACKED_BUFFER_FORMAT_VERSION must not be
+    used by this process.
+
+Arguments:
+
+    None.
+
+Return Value:
+
+    Returns the instruction set identifier.
+
+--*/
+{
+    return GetMlasPlatform().PackedBufferIsa;
+}
+
 #ifdef MLAS_TARGET_AMD64_IX86
 
 bool
@@ -70,7 +70,12 @@ MlasQ4GemmOperation(
     float* C = DataParams->C + RangeStartM * ldc + RangeStartN;
     const float* Bias = DataParams->Bias;
 
-    if (RangeCountM == 1) {
+    //
+    // Small matrices A are multiplied by the GEMV kernel, which streams the
+    // packed blocks of B, dequantizing them on the fly.
+    //
+
+    if (RangeCountM <= KERNEL::GemvMaximumM) {
         size_t CountN;
         for (size_t n = 0; n < RangeCountN; n += CountN) {
             CountN = std::min(RangeCountN - n, (size_t)128);
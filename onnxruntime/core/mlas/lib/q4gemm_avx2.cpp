@@ -0,0 +1,673 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    q4gemm_avx2.cpp
+
+Abstract:
+
+    This module implements the fp32 matrix multiplication with compressed
+    weight tensor (right hand side) for AVX2/FMA3 processors.
+
+    When matrix A has few rows, as in the token generation of large language
+    models, the kernel streams the packed int4 blocks of B and dequantizes
+    them on the fly, reusing every dequantized unit of B for up to 4 rows of
+    A. Larger matrices dequantize panels of B into fp32 and use the SGEMM
+    kernel.
+
+--*/
+
+#include "q4gemm_avx2.h"
+
+#include <utility>
+
+struct MLAS_FP_Q4_GEMM_KERNEL_AVX2 {
+    static constexpr size_t StrideM = 256;
+
+    //
+    // Matrices A with up to this number of rows are multiplied by the GEMV
+    // kernel, which does not materialize the dequantized B.
+    //
+    static constexpr size_t GemvMaximumM = 8;
+
+    /**
+     * @brief Accumulate the dot products of groups of 4 unsigned bytes with
+     *        4 signed bytes into 32-bit integers
+     */
+    static
+    MLAS_FORCEINLINE
+    __m256i
+    DotProduct(
+        __m256i Accumulator,
+        __m256i UnsignedBytes,
+        __m256i SignedBytes
+        )
+    {
+        // The products of the int4 values and int8 values can't saturate
+        // the 16-bit sums of pairs.
+        const __m256i Pairs = _mm256_maddubs_epi16(UnsignedBytes, SignedBytes);
+        return _mm256_add_epi32(Accumulator, _mm256_madd_epi16(Pairs, _mm256_set1_epi16(1)));
+    }
+};
+
+/**
+ * @brief Dequantize a unit of 32 values of a blob into 4 vectors
+ */
+template<typename Q4Type>
+MLAS_FORCEINLINE
+void
+MlasQ4DequantUnitAvx2(
+    const uint8_t* Blob,
+    size_t UnitOffset,
+    __m256 (&BValues)[4]
+    )
+{
+    const __m256i Bytes = MlasQ4UnpackUnitAvx2<Q4Type>(Blob, MlasQ4BlkData<Q4Type>(Blob) + UnitOffset);
+    const __m256 Scale = _mm256_set1_ps(MlasQ4BlkScale<Q4Type>(Blob));
+
+    const __m128i Lo = _mm256_castsi256_si128(Bytes);
+    const __m128i Hi = _mm256_extracti128_si256(Bytes, 1);
+
+    BValues[0] = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(Lo)), Scale);
+    BValues[1] = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(_mm_srli_si128(Lo, 8))), Scale);
+    BValues[2] = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(Hi)), Scale);
+    BValues[3] = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(_mm_srli_si128(Hi, 8))), Scale);
+}
+
+MLAS_FORCEINLINE
+void
+MlasQ4GemvRowAvx2(
+    __m256& Accumulator,
+    const float* a,
+    const __m256 (&BValues)[4]
+    )
+{
+    Accumulator = _mm256_fmadd_ps(_mm256_loadu_ps(a), BValues[0], Accumulator);
+    Accumulator = _mm256_fmadd_ps(_mm256_loadu_ps(a + 8), BValues[1], Accumulator);
+    Accumulator = _mm256_fmadd_ps(_mm256_loadu_ps(a + 16), BValues[2], Accumulator);
+    Accumulator = _mm256_fmadd_ps(_mm256_loadu_ps(a + 24), BValues[3], Accumulator);
+}
+
+template<typename Q4Type, size_t Col, size_t RowCount, size_t ColCount, size_t... Rows>
+MLAS_FORCEINLINE
+void
+MlasQ4GemvColumnAvx2(
+    __m256 (&Accumulators)[RowCount][ColCount],
+    const uint8_t* Blob,
+    size_t UnitOffset,
+    const float* a,
+    size_t lda,
+    std::index_sequence<Rows...>
+    )
+{
+    __m256 BValues[4];
+    MlasQ4DequantUnitAvx2<Q4Type>(Blob, UnitOffset, BValues);
+
+    (MlasQ4GemvRowAvx2(Accumulators[Rows][Col], a + Rows * lda, BValues), ...);
+}
+
+template<size_t ColCount>
+MLAS_FORCEINLINE
+void
+MlasQ4GemvStoreRowAvx2(
+    const __m256 (&Accumulators)[ColCount],
+    float* c,
+    const float* Bias,
+    size_t CountN
+    )
+{
+    static_assert(ColCount == 2 || ColCount == 4);
+
+    MLAS_DECLSPEC_ALIGN(float Sums[4], 16);
+
+    if constexpr (ColCount == 4) {
+        _mm_store_ps(Sums, MlasFoldAccumulatorsAvx2(Accumulators[0], Accumulators[1],
+                                                     Accumulators[2], Accumulators[3]));
+    } else {
+        _mm_store_ps(Sums, MlasFoldAccumulatorsAvx2(Accumulators[0], Accumulators[1],
+                                                     Accumulators[0], Accumulators[1]));
+    }
+
+    for (size_t n = 0; n < CountN; n++) {
+        c[n] = Sums[n] + (Bias == nullptr ? 0.0f : Bias[n]);
+    }
+}
+
+template<typename Q4Type, size_t... Rows, size_t... Cols>
+MLAS_FORCEINLINE
+void
+MlasQ4GemvBlockAvx2(
+    const float* A,
+    size_t lda,
+    const uint8_t* PackedB,
+    size_t ldb,
+    float* C,
+    size_t ldc,
+    size_t CountN,
+    size_t CountK,
+    const float* Bias,
+    std::index_sequence<Rows...> RowSequence,
+    std::index_sequence<Cols...>
+    )
+/*++
+
+Routine Description:
+
+    This routine computes a block of up to 4 rows and 4 columns of the result
+    matrix. The rows and the columns are expanded with parameter packs so
+    that the accumulators stay in registers.
+
+Arguments:
+
+    A - Supplies the address of the first row of the block of A.
+
+    lda - Supplies the leading dimension of A.
+
+    PackedB - Supplies the address of the first packed column of B.
+
+    ldb - Supplies the size in bytes of a packed column of B.
+
+    C - Supplies the address of the block of the result matrix.
+
+    ldc - Supplies the leading dimension of C.
+
+    CountN - Supplies the number of valid columns of the block. Columns past
+        the end of B repeat the last column of B, and are not stored.
+
+    CountK - Supplies the number of columns of A and rows of B.
+
+    Bias - Optionally supplies the address of the bias of the first column.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    constexpr size_t RowCount = sizeof...(Rows);
+    constexpr size_t ColCount = sizeof...(Cols);
+
+    __m256 Accumulators[RowCount][ColCount];
+    const uint8_t* b[ColCount];
+
+    ((Accumulators[Rows][0] = _mm256_setzero_ps()), ...);
+    ((Accumulators[Rows][1] = _mm256_setzero_ps()), ...);
+    if constexpr (ColCount > 2) {
+        ((Accumulators[Rows][2] = _mm256_setzero_ps()), ...);
+        ((Accumulators[Rows][3] = _mm256_setzero_ps()), ...);
+    }
+    ((b[Cols] = PackedB + ldb * std::min(Cols, CountN - 1)), ...);
+
+    MLAS_DECLSPEC_ALIGN(float APadded[RowCount][MLAS_QUANT4_BLK_UNIT], 32);
+
+    for (size_t k = 0; k < CountK; k += Q4Type::BlkLen) {
+        const size_t ck = std::min(CountK - k, Q4Type::BlkLen);
+
+        for (size_t kk = 0; kk < ck; kk += MLAS_QUANT4_BLK_UNIT) {
+            const size_t kklen = std::min(ck - kk, MLAS_QUANT4_BLK_UNIT);
+            const float* a = A + k + kk;
+            size_t a_stride = lda;
+
+            //
+            // Copy the last partial unit of A to a zero padded buffer.
+            //
+
+            if (kklen < MLAS_QUANT4_BLK_UNIT) {
+                for (size_t r = 0; r < RowCount; r++) {
+                    std::copy_n(a + r * lda, kklen, APadded[r]);
+                    std::fill_n(APadded[r] + kklen, MLAS_QUANT4_BLK_UNIT - kklen, 0.0f);
+                }
+                a = &APadded[0][0];
+                a_stride = MLAS_QUANT4_BLK_UNIT;
+            }
+
+            (MlasQ4GemvColumnAvx2<Q4Type, Cols>(Accumulators, b[Cols], kk / 2, a, a_stride, RowSequence), ...);
+        }
+
+        ((b[Cols] += Q4Type::BlobSize), ...);
+    }
+
+    (MlasQ4GemvStoreRowAvx2<ColCount>(Accumulators[Rows], C + Rows * ldc, Bias, CountN), ...);
+}
+
+template<typename Q4Type, size_t RowCount, size_t ColCount>
+MLAS_FORCEINLINE
+void
+MlasQ4GemvRowsAvx2(
+    const float* A,
+    const uint8_t* PackedB,
+    float* C,
+    size_t CountN,
+    size_t CountK,
+    size_t lda,
+    size_t ldb,
+    size_t ldc,
+    const float* Bias
+    )
+{
+    for (size_t n = 0; n < CountN; n += ColCount) {
+        MlasQ4GemvBlockAvx2<Q4Type>(A, lda, PackedB + n * ldb, ldb, C + n, ldc,
+                                    std::min(CountN - n, ColCount), CountK,
+                                    Bias == nullptr ? nullptr : Bias + n,
+                                    std::make_index_sequence<RowCount>(),
+                                    std::make_index_sequence<ColCount>());
+    }
+}
+
+template<typename Q4Type>
+MLAS_FORCEINLINE
+size_t
+MlasQ4GemmKernelAvx2(
+    const float* A,
+    const uint8_t* PackedB,
+    float* C,
+    size_t CountM,
+    size_t CountN,
+    size_t CountK,
+    size_t lda,
+    size_t ldb,
+    size_t ldc,
+    const float* Bias
+    )
+{
+    static_assert(MLAS_QUANT4_BLK_UNIT == 32);
+    static_assert(Q4Type::BlkLen % MLAS_QUANT4_BLK_UNIT == 0);
+
+    //
+    // Every dequantized unit of B is reused for all the rows of the block, so
+    // prefer the blocks with the most rows. The number of columns of a block
+    // is limited by the 16 vector registers.
+    //
+
+    if (CountM >= 4) {
+        MlasQ4GemvRowsAvx2<Q4Type, 4, 2>(A, PackedB, C, CountN, CountK, lda, ldb, ldc, Bias);
+        return 4;
+    }
+
+    if (CountM == 3) {
+        MlasQ4GemvRowsAvx2<Q4Type, 3, 2>(A, PackedB, C, CountN, CountK, lda, ldb, ldc, Bias);
+        return 3;
+    }
+
+    if (CountM == 2) {
+        MlasQ4GemvRowsAvx2<Q4Type, 2, 4>(A, PackedB, C, CountN, CountK, lda, ldb, ldc, Bias);
+        return 2;
+    }
+
+    MlasQ4GemvRowsAvx2<Q4Type, 1, 4>(A, PackedB, C, CountN, CountK, lda, ldb, ldc, Bias);
+    return 1;
+}
+
+template<>
+MLAS_FORCEINLINE
+size_t
+MlasQ4GemmKernel<MLAS_Q4TYPE_BLK0, MLAS_FP_Q4_GEMM_KERNEL_AVX2>(
+    const float* A,
+    const uint8_t* PackedB,
+    float* C,
+    size_t CountM,
+    size_t CountN,
+    size_t CountK,
+    size_t lda,
+    size_t ldb,
+    size_t ldc,
+    const float* Bias
+    )
+{
+    return MlasQ4GemmKernelAvx2<MLAS_Q4TYPE_BLK0>(A, PackedB, C, CountM, CountN, CountK, lda,
+                                                  ldb, ldc, Bias);
+}
+
+template<>
+MLAS_FORCEINLINE
+size_t
+MlasQ4GemmKernel<MLAS_Q4TYPE_BLK1, MLAS_FP_Q4_GEMM_KERNEL_AVX2>(
+    const float* A,
+    const uint8_t* PackedB,
+    float* C,
+    size_t CountM,
+    size_t CountN,
+    size_t CountK,
+    size_t lda,
+    size_t ldb,
+    size_t ldc,
+    const float* Bias
+    )
+{
+    return MlasQ4GemmKernelAvx2<MLAS_Q4TYPE_BLK1>(A, PackedB, C, CountM, CountN, CountK, lda,
+                                                  ldb, ldc, Bias);
+}
+
+template<>
+MLAS_FORCEINLINE
+size_t
+MlasQ4GemmKernel<MLAS_Q4TYPE_BLK2, MLAS_FP_Q4_GEMM_KERNEL_AVX2>(
+    const float* A,
+    const uint8_t* PackedB,
+    float* C,
+    size_t CountM,
+    size_t CountN,
+    size_t CountK,
+    size_t lda,
+    size_t ldb,
+    size_t ldc,
+    const float* Bias
+    )
+{
+    return MlasQ4GemmKernelAvx2<MLAS_Q4TYPE_BLK2>(A, PackedB, C, CountM, CountN, CountK, lda,
+                                                  ldb, ldc, Bias);
+}
+
+template<>
+MLAS_FORCEINLINE
+size_t
+MlasQ4GemmKernel<MLAS_Q4TYPE_BLK4, MLAS_FP_Q4_GEMM_KERNEL_AVX2>(
+    const float* A,
+    const uint8_t* PackedB,
+    float* C,
+    size_t CountM,
+    size_t CountN,
+    size_t CountK,
+    size_t lda,
+    size_t ldb,
+    size_t ldc,
+    const float* Bias
+    )
+{
+    return MlasQ4GemmKernelAvx2<MLAS_Q4TYPE_BLK4>(A, PackedB, C, CountM, CountN, CountK, lda,
+                                                  ldb, ldc, Bias);
+}
+
+MLAS_FORCEINLINE
+void
+Transpose8x8Avx2(
+    float* Output,
+    size_t ldo,
+    size_t RowCount,
+    __m256 (&Rows)[8]
+    )
+/*++
+
+Routine Description:
+
+    This routine transposes an 8x8 block of single precision values and
+    stores the first RowCount rows of the transposed block.
+
+--*/
+{
+    const __m256 t0 = _mm256_unpacklo_ps(Rows[0], Rows[1]);
+    const __m256 t1 = _mm256_unpackhi_ps(Rows[0], Rows[1]);
+    const __m256 t2 = _mm256_unpacklo_ps(Rows[2], Rows[3]);
+    const __m256 t3 = _mm256_unpackhi_ps(Rows[2], Rows[3]);
+    const __m256 t4 = _mm256_unpacklo_ps(Rows[4], Rows[5]);
+    const __m256 t5 = _mm256_unpackhi_ps(Rows[4], Rows[5]);
+    const __m256 t6 = _mm256_unpacklo_ps(Rows[6], Rows[7]);
+    const __m256 t7 = _mm256_unpackhi_ps(Rows[6], Rows[7]);
+
+    const __m256 tt0 = _mm256_shuffle_ps(t0, t2, 0x44);
+    const __m256 tt1 = _mm256_shuffle_ps(t0, t2, 0xEE);
+    const __m256 tt2 = _mm256_shuffle_ps(t1, t3, 0x44);
+    const __m256 tt3 = _mm256_shuffle_ps(t1, t3, 0xEE);
+    const __m256 tt4 = _mm256_shuffle_ps(t4, t6, 0x44);
+    const __m256 tt5 = _mm256_shuffle_ps(t4, t6, 0xEE);
+    const __m256 tt6 = _mm256_shuffle_ps(t5, t7, 0x44);
+    const __m256 tt7 = _mm256_shuffle_ps(t5, t7, 0xEE);
+
+    Rows[0] = _mm256_permute2f128_ps(tt0, tt4, 0x20);
+    Rows[1] = _mm256_permute2f128_ps(tt1, tt5, 0x20);
+    Rows[2] = _mm256_permute2f128_ps(tt2, tt6, 0x20);
+    Rows[3] = _mm256_permute2f128_ps(tt3, tt7, 0x20);
+    Rows[4] = _mm256_permute2f128_ps(tt0, tt4, 0x31);
+    Rows[5] = _mm256_permute2f128_ps(tt1, tt5, 0x31);
+    Rows[6] = _mm256_permute2f128_ps(tt2, tt6, 0x31);
+    Rows[7] = _mm256_permute2f128_ps(tt3, tt7, 0x31);
+
+    for (size_t r = 0; r < RowCount; r++) {
+        _mm256_storeu_ps(Output + r * ldo, Rows[r]);
+    }
+}
+
+template<typename Q4Type>
+MLAS_FORCEINLINE
+void
+BlkQ4DequantBAvx2(
+    float* FpData,
+    const uint8_t* PackedB,
+    size_t CountN,
+    size_t CountK,
+    size_t ldb
+    )
+/*++
+
+Routine Description:
+
+    This routine dequantizes columns of B into the packed format of the SGEMM
+    kernel: panels of 16 columns, with the rows of a panel stored
+    contiguously. The columns of the last panel past CountN are zero.
+
+--*/
+{
+    MLAS_DECLSPEC_ALIGN(float Unit[16][MLAS_QUANT4_BLK_UNIT], 32);
+
+    for (size_t n = 0; n < CountN; n += 16) {
+        const size_t nblk = std::min(CountN - n, size_t(16));
+        const uint8_t* b_col = PackedB + n * ldb;
+
+        if (nblk < 16) {
+            std::fill_n(&Unit[nblk][0], (16 - nblk) * MLAS_QUANT4_BLK_UNIT, 0.0f);
+        }
+
+        for (size_t k = 0; k < CountK; k += Q4Type::BlkLen) {
+            const size_t ck = std::min(CountK - k, Q4Type::BlkLen);
+
+            for (size_t kk = 0; kk < ck; kk += MLAS_QUANT4_BLK_UNIT) {
+                const size_t kklen = std::min(ck - kk, MLAS_QUANT4_BLK_UNIT);
+
+                for (size_t nn = 0; nn < nblk; nn++) {
+                    __m256 BValues[4];
+                    MlasQ4DequantUnitAvx2<Q4Type>(b_col + nn * ldb, kk / 2, BValues);
+                    _mm256_store_ps(&Unit[nn][0], BValues[0]);
+                    _mm256_store_ps(&Unit[nn][8], BValues[1]);
+                    _mm256_store_ps(&Unit[nn][16], BValues[2]);
+                    _mm256_store_ps(&Unit[nn][24], BValues[3]);
+                }
+
+                for (size_t r = 0; r < kklen; r += 8) {
+                    const size_t RowCount = std::min(kklen - r, size_t(8));
+
+                    for (size_t c = 0; c < 16; c += 8) {
+                        __m256 Rows[8];
+                        for (size_t i = 0; i < 8; i++) {
+                            Rows[i] = _mm256_load_ps(&Unit[c + i][r]);
+                        }
+                        Transpose8x8Avx2(FpData + r * 16 + c, 16, RowCount, Rows);
+                    }
+                }
+
+                FpData += 16 * kklen;
+            }
+
+            b_col += Q4Type::BlobSize;
+        }
+    }
+}
+
+template<>
+MLAS_FORCEINLINE
+void
+MlasBlkQ4DequantB<MLAS_Q4TYPE_BLK0, MLAS_FP_Q4_GEMM_KERNEL_AVX2>(
+    float* FpData, const uint8_t* PackedB, size_t CountN, size_t CountK, size_t ldb)
+{
+    BlkQ4DequantBAvx2<MLAS_Q4TYPE_BLK0>(FpData, PackedB, CountN, CountK, ldb);
+}
+
+template<>
+MLAS_FORCEINLINE
+void
+MlasBlkQ4DequantB<MLAS_Q4TYPE_BLK1, MLAS_FP_Q4_GEMM_KERNEL_AVX2>(
+    float* FpData, const uint8_t* PackedB, size_t CountN, size_t CountK, size_t ldb)
+{
+    BlkQ4DequantBAvx2<MLAS_Q4TYPE_BLK1>(FpData, PackedB, CountN, CountK, ldb);
+}
+
+template<>
+MLAS_FORCEINLINE
+void
+MlasBlkQ4DequantB<MLAS_Q4TYPE_BLK2, MLAS_FP_Q4_GEMM_KERNEL_AVX2>(
+    float* FpData, const uint8_t* PackedB, size_t CountN, size_t CountK, size_t ldb)
+{
+    BlkQ4DequantBAvx2<MLAS_Q4TYPE_BLK2>(FpData, PackedB, CountN, CountK, ldb);
+}
+
+template<>
+MLAS_FORCEINLINE
+void
+MlasBlkQ4DequantB<MLAS_Q4TYPE_BLK4, MLAS_FP_Q4_GEMM_KERNEL_AVX2>(
+    float* FpData, const uint8_t* PackedB, size_t CountN, size_t CountK, size_t ldb)
+{
+    BlkQ4DequantBAvx2<MLAS_Q4TYPE_BLK4>(FpData, PackedB, CountN, CountK, ldb);
+}
+
+template<>
+MLAS_FORCEINLINE
+void
+AddBiasAvx<MLAS_FP_Q4_GEMM_KERNEL_AVX2>(
+    const float* Bias,
+    float* C,
+    size_t CountM,
+    size_t CountN,
+    size_t ldc
+    )
+{
+    for (size_t m = 0; m < CountM; m++) {
+        size_t n = 0;
+        for (; n + 8 <= CountN; n += 8) {
+            _mm256_storeu_ps(C + n, _mm256_add_ps(_mm256_loadu_ps(C + n), _mm256_loadu_ps(Bias + n)));
+        }
+        for (; n < CountN; n++) {
+            C[n] += Bias[n];
+        }
+        C += ldc;
+    }
+}
+
+static MLAS_Q4GEMM_OPERATION* Q4Operations_avx2[] = {
+    MlasQ4GemmOperation<MLAS_Q4TYPE_BLK0, MLAS_FP_Q4_GEMM_KERNEL_AVX2>,
+    MlasQ4GemmOperation<MLAS_Q4TYPE_BLK1, MLAS_FP_Q4_GEMM_KERNEL_AVX2>,
+    MlasQ4GemmOperation<MLAS_Q4TYPE_BLK2, MLAS_FP_Q4_GEMM_KERNEL_AVX2>,
+    nullptr,
+    MlasQ4GemmOperation<MLAS_Q4TYPE_BLK4, MLAS_FP_Q4_GEMM_KERNEL_AVX2>
+};
+
+const MLAS_FPQ4GEMM_DISPATCH MlasFpQ4GemmDispatchAvx2 = {
+    Q4Operations_avx2
+};
+
+
+////////////////////////////////////////////////////////////
+//  Q8Q4 GEMM using the AVX2 byte dot product
+
+static MLAS_Q80_BLKQUANT* Q80Quant_avx2[] = {
+    MlasQ80BlkQuantAvx2<MLAS_Q4TYPE_BLK0, MLAS_FP_Q4_GEMM_KERNEL_AVX2>,
+    MlasQ80BlkQuantAvx2<MLAS_Q4TYPE_BLK1, MLAS_FP_Q4_GEMM_KERNEL_AVX2>,
+    MlasQ80BlkQuantAvx2<MLAS_Q4TYPE_BLK2, MLAS_FP_Q4_GEMM_KERNEL_AVX2>,
+    nullptr,
+    MlasQ80BlkQuantAvx2<MLAS_Q4TYPE_BLK4, MLAS_FP_Q4_GEMM_KERNEL_AVX2>
+};
+
+template<>
+MLAS_FORCEINLINE
+size_t
+MlasQ8Q4GemmKernel<MLAS_Q4TYPE_BLK0, MLAS_FP_Q4_GEMM_KERNEL_AVX2>(
+    const int8_t* QuantA,
+    const uint8_t* PackedB,
+    float* C,
+    size_t CountM,
+    size_t CountN,
+    size_t CountK,
+    size_t lda,
+    size_t ldb,
+    size_t ldc,
+    const float* Bias
+    )
+{
+    return MlasQ8Q4GemmKernelAvx2<MLAS_Q4TYPE_BLK0, MLAS_FP_Q4_GEMM_KERNEL_AVX2>(
+        QuantA, PackedB, C, CountM, CountN, CountK, lda, ldb, ldc, Bias);
+}
+
+template<>
+MLAS_FORCEINLINE
+size_t
+MlasQ8Q4GemmKernel<MLAS_Q4TYPE_BLK1, MLAS_FP_Q4_GEMM_KERNEL_AVX2>(
+    const int8_t* QuantA,
+    const uint8_t* PackedB,
+    float* C,
+    size_t CountM,
+    size_t CountN,
+    size_t CountK,
+    size_t lda,
+    size_t ldb,
+    size_t ldc,
+    const float* Bias
+    )
+{
+    return MlasQ8Q4GemmKernelAvx2<MLAS_Q4TYPE_BLK1, MLAS_FP_Q4_GEMM_KERNEL_AVX2>(
+        QuantA, PackedB, C, CountM, CountN, CountK, lda, ldb, ldc, Bias);
+}
+
+template<>
+MLAS_FORCEINLINE
+size_t
+MlasQ8Q4GemmKernel<MLAS_Q4TYPE_BLK2, MLAS_FP_Q4_GEMM_KERNEL_AVX2>(
+    const int8_t* QuantA,
+    const uint8_t* PackedB,
+    float* C,
+    size_t CountM,
+    size_t CountN,
+    size_t CountK,
+    size_t lda,
+    size_t ldb,
+    size_t ldc,
+    const float* Bias
+    )
+{
+    return MlasQ8Q4GemmKernelAvx2<MLAS_Q4TYPE_BLK2, MLAS_FP_Q4_GEMM_KERNEL_AVX2>(
+        QuantA, PackedB, C, CountM, CountN, CountK, lda, ldb, ldc, Bias);
+}
+
+template<>
+MLAS_FORCEINLINE
+size_t
+MlasQ8Q4GemmKernel<MLAS_Q4TYPE_BLK4, MLAS_FP_Q4_GEMM_KERNEL_AVX2>(
+    const int8_t* QuantA,
+    const uint8_t* PackedB,
+    float* C,
+    size_t CountM,
+    size_t CountN,
+    size_t CountK,
+    size_t lda,
+    size_t ldb,
+    size_t ldc,
+    const float* Bias
+    )
+{
+    return MlasQ8Q4GemmKernelAvx2<MLAS_Q4TYPE_BLK4, MLAS_FP_Q4_GEMM_KERNEL_AVX2>(
+        QuantA, PackedB, C, CountM, CountN, CountK, lda, ldb, ldc, Bias);
+}
+
+static MLAS_Q8Q4GEMM_OPERATION* Q8Q4Operations_avx2[] = {
+    MlasQ8Q4GemmOperation<MLAS_Q4TYPE_BLK0, MLAS_FP_Q4_GEMM_KERNEL_AVX2>,
+    MlasQ8Q4GemmOperation<MLAS_Q4TYPE_BLK1, MLAS_FP_Q4_GEMM_KERNEL_AVX2>,
+    MlasQ8Q4GemmOperation<MLAS_Q4TYPE_BLK2, MLAS_FP_Q4_GEMM_KERNEL_AVX2>,
+    nullptr,
+    MlasQ8Q4GemmOperation<MLAS_Q4TYPE_BLK4, MLAS_FP_Q4_GEMM_KERNEL_AVX2>
+};
+
+const MLAS_Q8Q4GEMM_DISPATCH MlasQ8Q4GemmDispatchAvx2 = {
+    Q80Quant_avx2,
+    Q8Q4Operations_avx2
+};
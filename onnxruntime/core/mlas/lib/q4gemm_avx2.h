@@ -0,0 +1,296 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    q4gemm_avx2.h
+
+Abstract:
+
+    This module contains the AVX2 building blocks of the int4 block quantized
+    GEMM kernels that are shared by the AVX2 and AVX-VNNI translation units.
+
+    The kernel tag of each translation unit supplies the integer dot product
+    of the Q8Q4 kernel. The templates are parameterized by the kernel tag, so
+    that every translation unit instantiates its own copy, compiled for its
+    own instruction set.
+
+--*/
+
+#pragma once
+
+#include "q4gemm.h"
+
+#include <type_traits>
+#include <immintrin.h>
+
+/**
+ * @brief Expand a unit of 32 int4 values of a blob into 32 signed bytes,
+ *        with the zero point of the block subtracted.
+ *
+ *        The low nibbles of the 16 bytes hold the first 16 values, the high
+ *        nibbles the last 16 values.
+ */
+template<typename Q4Type>
+static
+MLAS_FORCEINLINE
+__m256i
+MlasQ4UnpackUnitAvx2(
+    const uint8_t* Blob,
+    const uint8_t* Data
+    )
+{
+    const __m128i LowMask = _mm_set1_epi8(0xF);
+    const __m128i PackedValues = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Data));
+
+    __m256i Bytes = _mm256_set_m128i(_mm_and_si128(_mm_srli_epi16(PackedValues, 4), LowMask),
+                                     _mm_and_si128(PackedValues, LowMask));
+
+    if constexpr (std::is_same_v<Q4Type, MLAS_Q4TYPE_BLK1>) {
+        Bytes = _mm256_sub_epi8(Bytes, _mm256_set1_epi8(MlasQ4BlkZeroPoint<MLAS_Q4TYPE_BLK1>(Blob)));
+    } else {
+        MLAS_UNREFERENCED_PARAMETER(Blob);
+        Bytes = _mm256_sub_epi8(Bytes, _mm256_set1_epi8(8));
+    }
+
+    return Bytes;
+}
+
+/**
+ * @brief Horizontally sum 4 vectors, returning the 4 sums in a vector
+ */
+static
+MLAS_FORCEINLINE
+__m128
+MlasFoldAccumulatorsAvx2(
+    __m256 acc0,
+    __m256 acc1,
+    __m256 acc2,
+    __m256 acc3
+    )
+{
+    const __m256 acc01 = _mm256_hadd_ps(acc0, acc1);
+    const __m256 acc23 = _mm256_hadd_ps(acc2, acc3);
+    const __m256 acc0123 = _mm256_hadd_ps(acc01, acc23);
+    return _mm_add_ps(_mm256_extractf128_ps(acc0123, 1), _mm256_castps256_ps128(acc0123));
+}
+
+////////////////////////////////////////////////////////////
+//  Block int8 quantization of matrix A, symmetric with no
+//  zero-point, in the format of q4gemm_avx512.cpp
+
+template<typename QType, typename KERNEL>
+MLAS_FORCEINLINE
+void
+MlasQ80BlkQuantRowAvx2(
+    const float* A,
+    void* Qblob,
+    size_t size
+    )
+{
+    static_assert(QType::BlkLen % 32 == 0);
+
+    const __m256 signBit = _mm256_set1_ps(-0.0f);
+    const __m256i index = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    const __m256i permute = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+    int8_t* blob = reinterpret_cast<int8_t*>(Qblob);
+
+    for (size_t k = 0; k < size; k += QType::BlkLen) {
+        const size_t step = std::min(QType::BlkLen, size - k);
+
+        __m256 maxAbs = _mm256_setzero_ps();
+        for (size_t kk = 0; kk < step; kk += 8) {
+            const size_t klen = std::min(size_t(8), step - kk);
+            const __m256i mask = _mm256_cmpgt_epi32(_mm256_set1_epi32(int32_t(klen)), index);
+            const __m256 v0 = _mm256_maskload_ps(A + k + kk, mask);
+
+            maxAbs = _mm256_max_ps(maxAbs, _mm256_andnot_ps(signBit, v0));
+        }
+
+        __m128 max4 = _mm_max_ps(_mm256_extractf128_ps(maxAbs, 1), _mm256_castps256_ps128(maxAbs));
+        max4 = _mm_max_ps(max4, _mm_movehl_ps(max4, max4));
+        max4 = _mm_max_ss(max4, _mm_movehdup_ps(max4));
+        const float maxScalar = _mm_cvtss_f32(max4);
+
+        // Quantize these floats
+        const float scale = maxScalar / 127.f;
+        *reinterpret_cast<float*>(blob) = scale;
+        blob += sizeof(float);
+
+        const float inverse_scale = (maxScalar != 0.0f) ? 127.f / maxScalar : 0.0f;
+        const __m256 mul = _mm256_set1_ps(inverse_scale);
+
+        for (size_t kk = 0; kk < QType::BlkLen; kk += 32) {
+            __m256i i[4];
+
+            for (size_t j = 0; j < 4; j++) {
+                const size_t offset = kk + j * 8;
+                const size_t klen = offset < step ? std::min(size_t(8), step - offset) : 0;
+                const __m256i mask = _mm256_cmpgt_epi32(_mm256_set1_epi32(int32_t(klen)), index);
+                __m256 v0 = _mm256_maskload_ps(A + k + std::min(offset, step), mask);
+                v0 = _mm256_mul_ps(v0, mul);
+
+                // Round to nearest integer and convert to integers
+                i[j] = _mm256_cvtps_epi32(_mm256_round_ps(v0, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+            }
+
+            // Convert int32 to int8, the packs interleave the 128-bit lanes
+            const __m256i i01 = _mm256_packs_epi32(i[0], i[1]);
+            const __m256i i23 = _mm256_packs_epi32(i[2], i[3]);
+            const __m256i i0123 = _mm256_permutevar8x32_epi32(_mm256_packs_epi16(i01, i23), permute);
+
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(blob + kk), i0123);
+        }
+
+        blob += QType::BlkLen;
+    }
+}
+
+template<typename QType, typename KERNEL>
+void
+MlasQ80BlkQuantAvx2(
+    void* Qblob,
+    const float* A,
+    size_t M,
+    size_t K,
+    size_t lda,
+    MLAS_THREADPOOL* ThreadPool
+    )
+{
+    const size_t parts = (size_t)ceil(double(M) * K / (16.0 * 1024));
+    const size_t TargetThreadCnt =
+        std::max(std::min(parts, (size_t)MlasGetMaximumThreadCount(ThreadPool)), (size_t)1);
+    const size_t linesize = MlasQ80BlkQuantSizeImpl<QType>(1, K);
+
+    size_t M_stride = MlasDivRoundup(M, TargetThreadCnt);
+    size_t threads = MlasDivRoundup(M, M_stride);
+    MlasTrySimpleParallel(ThreadPool, threads, [&](ptrdiff_t tid) {
+        const size_t m = tid * M_stride;
+        const float* src = A + lda * m;
+        uint8_t* dst = reinterpret_cast<uint8_t*>(Qblob) + m * linesize;
+        for (size_t i = 0; i < std::min(M_stride, M - m); i++) {
+            MlasQ80BlkQuantRowAvx2<QType, KERNEL>(src, dst, K);
+            src += lda;
+            dst += linesize;
+        }
+    });
+}
+
+////////////////////////////////////////////////////////////
+//  Q8Q4 kernel, int8 blocks of A times int4 blocks of B
+
+template<typename Q4Type, typename KERNEL>
+MLAS_FORCEINLINE
+size_t
+MlasQ8Q4GemmKernelAvx2(
+    const int8_t* QuantA,
+    const uint8_t* PackedB,
+    float* C,
+    size_t CountM,
+    size_t CountN,
+    size_t CountK,
+    size_t lda,
+    size_t ldb,
+    size_t ldc,
+    const float* Bias
+    )
+{
+    static_assert(MLAS_QUANT4_BLK_UNIT == 32);
+    static_assert(Q4Type::BlkLen % MLAS_QUANT4_BLK_UNIT == 0);
+
+    for (size_t m = 0; m < CountM; m++) {
+        const uint8_t* b_col = PackedB;
+        float* sum_ptr = C;
+        const float* bias_ptr = Bias;
+
+        for (size_t n = 0; n < CountN; n += 4) {
+            const size_t nblk = std::min(CountN - n, size_t(4));
+
+            //
+            // Columns past the end of B repeat the last column, their sums
+            // are discarded.
+            //
+
+            const uint8_t* b[4];
+            for (size_t nn = 0; nn < 4; nn++) {
+                b[nn] = b_col + ldb * std::min(nn, nblk - 1);
+            }
+
+            __m256 acc0 = _mm256_setzero_ps();
+            __m256 acc1 = _mm256_setzero_ps();
+            __m256 acc2 = _mm256_setzero_ps();
+            __m256 acc3 = _mm256_setzero_ps();
+            const int8_t* ablob = QuantA;
+
+            for (size_t k = 0; k < CountK; k += Q4Type::BlkLen) {
+                const float a_scale = *reinterpret_cast<const float*>(ablob);
+                ablob += sizeof(float);
+
+                __m256i isum0 = _mm256_setzero_si256();
+                __m256i isum1 = _mm256_setzero_si256();
+                __m256i isum2 = _mm256_setzero_si256();
+                __m256i isum3 = _mm256_setzero_si256();
+
+                for (size_t kk = 0; kk < Q4Type::BlkLen; kk += MLAS_QUANT4_BLK_UNIT) {
+                    const __m256i a_bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ablob));
+                    ablob += MLAS_QUANT4_BLK_UNIT;
+
+                    const size_t offset = kk / 2;
+                    const __m256i b0 = MlasQ4UnpackUnitAvx2<Q4Type>(b[0], MlasQ4BlkData<Q4Type>(b[0]) + offset);
+                    const __m256i b1 = MlasQ4UnpackUnitAvx2<Q4Type>(b[1], MlasQ4BlkData<Q4Type>(b[1]) + offset);
+                    const __m256i b2 = MlasQ4UnpackUnitAvx2<Q4Type>(b[2], MlasQ4BlkData<Q4Type>(b[2]) + offset);
+                    const __m256i b3 = MlasQ4UnpackUnitAvx2<Q4Type>(b[3], MlasQ4BlkData<Q4Type>(b[3]) + offset);
+
+                    // The dot product multiplies unsigned by signed bytes, so
+                    // negate the negative values of B to make them positive,
+                    // and negate the corresponding values of A to compensate.
+                    isum0 = KERNEL::DotProduct(isum0, _mm256_sign_epi8(b0, b0), _mm256_sign_epi8(a_bytes, b0));
+                    isum1 = KERNEL::DotProduct(isum1, _mm256_sign_epi8(b1, b1), _mm256_sign_epi8(a_bytes, b1));
+                    isum2 = KERNEL::DotProduct(isum2, _mm256_sign_epi8(b2, b2), _mm256_sign_epi8(a_bytes, b2));
+                    isum3 = KERNEL::DotProduct(isum3, _mm256_sign_epi8(b3, b3), _mm256_sign_epi8(a_bytes, b3));
+                }
+
+                acc0 = _mm256_fmadd_ps(_mm256_set1_ps(MlasQ4BlkScale<Q4Type>(b[0]) * a_scale),
+                                       _mm256_cvtepi32_ps(isum0), acc0);
+                acc1 = _mm256_fmadd_ps(_mm256_set1_ps(MlasQ4BlkScale<Q4Type>(b[1]) * a_scale),
+                                       _mm256_cvtepi32_ps(isum1), acc1);
+                acc2 = _mm256_fmadd_ps(_mm256_set1_ps(MlasQ4BlkScale<Q4Type>(b[2]) * a_scale),
+                                       _mm256_cvtepi32_ps(isum2), acc2);
+                acc3 = _mm256_fmadd_ps(_mm256_set1_ps(MlasQ4BlkScale<Q4Type>(b[3]) * a_scale),
+                                       _mm256_cvtepi32_ps(isum3), acc3);
+
+                for (size_t nn = 0; nn < 4; nn++) {
+                    b[nn] += Q4Type::BlobSize;
+                }
+            }
+
+            __m128 acc_x = MlasFoldAccumulatorsAvx2(acc0, acc1, acc2, acc3);
+            if (Bias != nullptr) {
+                MLAS_DECLSPEC_ALIGN(float bias_x[4], 16) = {};
+                std::copy_n(bias_ptr, nblk, bias_x);
+                acc_x = _mm_add_ps(acc_x, _mm_load_ps(bias_x));
+                bias_ptr += 4;
+            }
+
+            if (nblk == 4) {
+                _mm_storeu_ps(sum_ptr, acc_x);
+            } else {
+                MLAS_DECLSPEC_ALIGN(float sums[4], 16);
+                _mm_store_ps(sums, acc_x);
+                std::copy_n(sums, nblk, sum_ptr);
+            }
+
+            // move to next 4 columns
+            b_col += 4 * ldb;
+            sum_ptr += 4;
+        }
+
+        // Prepare pointers for the next row
+        C += ldc;
+        QuantA += lda;
+    }
+    return CountM;
+}
@@ -24,6 +24,7 @@ Abstract:
 
 struct MLAS_FP_Q4_GEMM_KERNEL_AVX512VNNI {
     static constexpr size_t StrideM = 256;
+    static constexpr size_t GemvMaximumM = 1;
 };
 
 /**
@@ -0,0 +1,137 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    q4gemm_avxvnni.cpp
+
+Abstract:
+
+    This module implements the matrix multiplication of int8 block quantized
+    matrix A with int4 block quantized matrix B for AVX-VNNI processors.
+
+--*/
+
+#include "q4gemm_avx2.h"
+
+struct MLAS_FP_Q4_GEMM_KERNEL_AVXVNNI {
+    /**
+     * @brief Accumulate the dot products of groups of 4 unsigned bytes with
+     *        4 signed bytes into 32-bit integers
+     */
+    static
+    MLAS_FORCEINLINE
+    __m256i
+    DotProduct(
+        __m256i Accumulator,
+        __m256i UnsignedBytes,
+        __m256i SignedBytes
+        )
+    {
+        return _mm256_dpbusd_avx_epi32(Accumulator, UnsignedBytes, SignedBytes);
+    }
+};
+
+static MLAS_Q80_BLKQUANT* Q80Quant_avxvnni[] = {
+    MlasQ80BlkQuantAvx2<MLAS_Q4TYPE_BLK0, MLAS_FP_Q4_GEMM_KERNEL_AVXVNNI>,
+    MlasQ80BlkQuantAvx2<MLAS_Q4TYPE_BLK1, MLAS_FP_Q4_GEMM_KERNEL_AVXVNNI>,
+    MlasQ80BlkQuantAvx2<MLAS_Q4TYPE_BLK2, MLAS_FP_Q4_GEMM_KERNEL_AVXVNNI>,
+    nullptr,
+    MlasQ80BlkQuantAvx2<MLAS_Q4TYPE_BLK4, MLAS_FP_Q4_GEMM_KERNEL_AVXVNNI>
+};
+
+template<>
+MLAS_FORCEINLINE
+size_t
+MlasQ8Q4GemmKernel<MLAS_Q4TYPE_BLK0, MLAS_FP_Q4_GEMM_KERNEL_AVXVNNI>(
+    const int8_t* QuantA,
+    const uint8_t* PackedB,
+    float* C,
+    size_t CountM,
+    size_t CountN,
+    size_t CountK,
+    size_t lda,
+    size_t ldb,
+    size_t ldc,
+    const float* Bias
+    )
+{
+    return MlasQ8Q4GemmKernelAvx2<MLAS_Q4TYPE_BLK0, MLAS_FP_Q4_GEMM_KERNEL_AVXVNNI>(
+        QuantA, PackedB, C, CountM, CountN, CountK, lda, ldb, ldc, Bias);
+}
+
+template<>
+MLAS_FORCEINLINE
+size_t
+MlasQ8Q4GemmKernel<MLAS_Q4TYPE_BLK1, MLAS_FP_Q4_GEMM_KERNEL_AVXVNNI>(
+    const int8_t* QuantA,
+    const uint8_t* PackedB,
+    float* C,
+    size_t CountM,
+    size_t CountN,
+    size_t CountK,
+    size_t lda,
+    size_t ldb,
+    size_t ldc,
+    const float* Bias
+    )
+{
+    return MlasQ8Q4GemmKernelAvx2<MLAS_Q4TYPE_BLK1, MLAS_FP_Q4_GEMM_KERNEL_AVXVNNI>(
+        QuantA, PackedB, C, CountM, CountN, CountK, lda, ldb, ldc, Bias);
+}
+
+template<>
+MLAS_FORCEINLINE
+size_t
+MlasQ8Q4GemmKernel<MLAS_Q4TYPE_BLK2, MLAS_FP_Q4_GEMM_KERNEL_AVXVNNI>(
+    const int8_t* QuantA,
+    const uint8_t* PackedB,
+    float* C,
+    size_t CountM,
+    size_t CountN,
+    size_t CountK,
+    size_t lda,
+    size_t ldb,
+    size_t ldc,
+    const float* Bias
+    )
+{
+    return MlasQ8Q4GemmKernelAvx2<MLAS_Q4TYPE_BLK2, MLAS_FP_Q4_GEMM_KERNEL_AVXVNNI>(
+        QuantA, PackedB, C, CountM, CountN, CountK, lda, ldb, ldc, Bias);
+}
+
+template<>
+MLAS_FORCEINLINE
+size_t
+MlasQ8Q4GemmKernel<MLAS_Q4TYPE_BLK4, MLAS_FP_Q4_GEMM_KERNEL_AVXVNNI>(
+    const int8_t* QuantA,
+    const uint8_t* PackedB,
+    float* C,
+    size_t CountM,
+    size_t CountN,
+    size_t CountK,
+    size_t lda,
+    size_t ldb,
+    size_t ldc,
+    const float* Bias
+    )
+{
+    return MlasQ8Q4GemmKernelAvx2<MLAS_Q4TYPE_BLK4, MLAS_FP_Q4_GEMM_KERNEL_AVXVNNI>(
+        QuantA, PackedB, C, CountM, CountN, CountK, lda, ldb, ldc, Bias);
+}
+
+static MLAS_Q8Q4GEMM_OPERATION* Q8Q4Operations_avxvnni[] = {
+    MlasQ8Q4GemmOperation<MLAS_Q4TYPE_BLK0, MLAS_FP_Q4_GEMM_KERNEL_AVXVNNI>,
+    MlasQ8Q4GemmOperation<MLAS_Q4TYPE_BLK1, MLAS_FP_Q4_GEMM_KERNEL_AVXVNNI>,
+    MlasQ8Q4GemmOperation<MLAS_Q4TYPE_BLK2, MLAS_FP_Q4_GEMM_KERNEL_AVXVNNI>,
+    nullptr,
+    MlasQ8Q4GemmOperation<MLAS_Q4TYPE_BLK4, MLAS_FP_Q4_GEMM_KERNEL_AVXVNNI>
+};
+
+const MLAS_Q8Q4GEMM_DISPATCH MlasQ8Q4GemmDispatchAvxVnni = {
+    Q80Quant_avxvnni,
+    Q8Q4Operations_avxvnni
+};
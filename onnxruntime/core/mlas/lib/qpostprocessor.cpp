@@ -98,6 +98,16 @@ void MLAS_QGEMM_SCALE_BIAS_OUTPUT_PROCESSOR::Process(
                 ldc);
         }
     }
+
+    //
+    // Apply the epilogue to the converted block while it is still in the
+    // cache.
+    //
+
+    if (Epilogue_ != nullptr) {
+        MlasGemmEpilogue(Epilogue_, Output_ + StartM * LeadingDimensionOutput_ + StartN,
+                         LeadingDimensionOutput_, StartM, StartN, CountM, CountN);
+    }
 }
 
 template<bool HasBias, MLAS_QGEMM_OUTPUT_MODE Mode, MLAS_QUANTIZATION_GRANULARITY QuantGran>
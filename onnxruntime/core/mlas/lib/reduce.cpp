@@ -0,0 +1,583 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    reduce.cpp
+
+Abstract:
+
+    This module implements routines to reduce the rows or the columns of a
+    single precision matrix, such as the sum, the maximum or the log of the
+    sum of exponentials.
+
+    Reductions are bound by the memory bandwidth, so the kernels use several
+    independent accumulators to keep enough loads in flight instead of wider
+    vectors. The log-sum-exp reductions use the platform specific exponential
+    kernels.
+
+--*/
+
+#include "mlasi.h"
+
+//
+// Define the number of columns reduced per pass by MlasReduceColumns. The
+// partial results of a block of columns stay resident in the L1 cache while
+// the rows of the block are streamed through.
+//
+
+constexpr size_t MLAS_REDUCE_COLUMN_BLOCK = 512;
+
+//
+// Define the operations applied by the reduction kernels for each kind of
+// reduction.
+//
+
+struct MLAS_REDUCE_SUM_OPERATION {
+
+    static float Identity() { return 0.0f; }
+
+    static float Accumulate(float Accumulator, float Value) { return Accumulator + Value; }
+
+    static MLAS_FLOAT32X4 Accumulate(MLAS_FLOAT32X4 Accumulator, MLAS_FLOAT32X4 Vector)
+    {
+        return MlasAddFloat32x4(Accumulator, Vector);
+    }
+
+    static MLAS_FLOAT32X4 Combine(MLAS_FLOAT32X4 Vector1, MLAS_FLOAT32X4 Vector2)
+    {
+        return MlasAddFloat32x4(Vector1, Vector2);
+    }
+
+    static float Reduce(MLAS_FLOAT32X4 Vector) { return MlasReduceAddFloat32x4(Vector); }
+};
+
+struct MLAS_REDUCE_SUM_SQUARE_OPERATION : MLAS_REDUCE_SUM_OPERATION {
+
+    static float Accumulate(float Accumulator, float Value) { return Accumulator + Value * Value; }
+
+    static MLAS_FLOAT32X4 Accumulate(MLAS_FLOAT32X4 Accumulator, MLAS_FLOAT32X4 Vector)
+    {
+        return MlasMultiplyAddFloat32x4(Vector, Vector, Accumulator);
+    }
+};
+
+struct MLAS_REDUCE_SUM_ABSOLUTE_OPERATION : MLAS_REDUCE_SUM_OPERATION {
+
+    static float Accumulate(float Accumulator, float Value) { return Accumulator + std::fabs(Value); }
+
+    static MLAS_FLOAT32X4 Accumulate(MLAS_FLOAT32X4 Accumulator, MLAS_FLOAT32X4 Vector)
+    {
+        return MlasAddFloat32x4(Accumulator, MlasAndNotFloat32x4(MlasBroadcastFloat32x4(-0.0f), Vector));
+    }
+};
+
+struct MLAS_REDUCE_MAXIMUM_OPERATION {
+
+    static float Identity() { return -std::numeric_limits<float>::infinity(); }
+
+    static float Accumulate(float Accumulator, float Value) { return std::max(Accumulator, Value); }
+
+    static MLAS_FLOAT32X4 Accumulate(MLAS_FLOAT32X4 Accumulator, MLAS_FLOAT32X4 Vector)
+    {
+        return MlasMaximumFloat32x4(Accumulator, Vector);
+    }
+
+    static MLAS_FLOAT32X4 Combine(MLAS_FLOAT32X4 Vector1, MLAS_FLOAT32X4 Vector2)
+    {
+        return MlasMaximumFloat32x4(Vector1, Vector2);
+    }
+
+    static float Reduce(MLAS_FLOAT32X4 Vector) { return MlasReduceMaximumFloat32x4(Vector); }
+};
+
+struct MLAS_REDUCE_MINIMUM_OPERATION {
+
+    static float Identity() { return std::numeric_limits<float>::infinity(); }
+
+    static float Accumulate(float Accumulator, float Value) { return std::min(Accumulator, Value); }
+
+    static MLAS_FLOAT32X4 Accumulate(MLAS_FLOAT32X4 Accumulator, MLAS_FLOAT32X4 Vector)
+    {
+        return MlasMinimumFloat32x4(Accumulator, Vector);
+    }
+
+    static MLAS_FLOAT32X4 Combine(MLAS_FLOAT32X4 Vector1, MLAS_FLOAT32X4 Vector2)
+    {
+        return MlasMinimumFloat32x4(Vector1, Vector2);
+    }
+
+    static float Reduce(MLAS_FLOAT32X4 Vector) { return MlasReduceMinimumFloat32x4(Vector); }
+};
+
+template<typename ReduceOperation>
+float
+MlasReduceRowKernel(
+    const float* Input,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine reduces a contiguous vector to a single value.
+
+Arguments:
+
+    Input - Supplies the input vector.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    Returns the reduced value.
+
+--*/
+{
+    float Accumulator = ReduceOperation::Identity();
+
+    if (N >= 4) {
+
+        MLAS_FLOAT32X4 Accumulator0 = MlasBroadcastFloat32x4(Accumulator);
+
+        if (N >= 16) {
+
+            MLAS_FLOAT32X4 Accumulator1 = Accumulator0;
+            MLAS_FLOAT32X4 Accumulator2 = Accumulator0;
+            MLAS_FLOAT32X4 Accumulator3 = Accumulator0;
+
+            while (N >= 16) {
+
+                Accumulator0 = ReduceOperation::Accumulate(Accumulator0, MlasLoadFloat32x4(Input));
+                Accumulator1 = ReduceOperation::Accumulate(Accumulator1, MlasLoadFloat32x4(Input + 4));
+                Accumulator2 = ReduceOperation::Accumulate(Accumulator2, MlasLoadFloat32x4(Input + 8));
+                Accumulator3 = ReduceOperation::Accumulate(Accumulator3, MlasLoadFloat32x4(Input + 12));
+
+                Input += 16;
+                N -= 16;
+            }
+
+            Accumulator0 = ReduceOperation::Combine(Accumulator0, Accumulator1);
+            Accumulator2 = ReduceOperation::Combine(Accumulator2, Accumulator3);
+            Accumulator0 = ReduceOperation::Combine(Accumulator0, Accumulator2);
+        }
+
+        while (N >= 4) {
+
+            Accumulator0 = ReduceOperation::Accumulate(Accumulator0, MlasLoadFloat32x4(Input));
+
+            Input += 4;
+            N -= 4;
+        }
+
+        Accumulator = ReduceOperation::Reduce(Accumulator0);
+    }
+
+    while (N > 0) {
+
+        Accumulator = ReduceOperation::Accumulate(Accumulator, *Input);
+
+        Input += 1;
+        N -= 1;
+    }
+
+    return Accumulator;
+}
+
+template<typename ReduceOperation>
+void
+MlasReduceColumnKernel(
+    const float* Input,
+    size_t ldi,
+    float* Output,
+    size_t CountK,
+    size_t CountN
+    )
+/*++
+
+Routine Description:
+
+    This routine reduces a block of columns of a matrix. The partial results
+    are accumulated in the output buffer, four rows at a time.
+
+Arguments:
+
+    Input - Supplies the input matrix.
+
+    ldi - Supplies the first dimension of the input matrix.
+
+    Output - Supplies the output buffer.
+
+    CountK - Supplies the number of rows to reduce.
+
+    CountN - Supplies the number of columns to reduce.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    std::fill_n(Output, CountN, ReduceOperation::Identity());
+
+    while (CountK >= 4) {
+
+        const float* Row0 = Input;
+        const float* Row1 = Row0 + ldi;
+        const float* Row2 = Row1 + ldi;
+        const float* Row3 = Row2 + ldi;
+
+        size_t n = 0;
+
+        for (; n + 4 <= CountN; n += 4) {
+
+            MLAS_FLOAT32X4 Accumulator = MlasLoadFloat32x4(Output + n);
+
+            Accumulator = ReduceOperation::Accumulate(Accumulator, MlasLoadFloat32x4(Row0 + n));
+            Accumulator = ReduceOperation::Accumulate(Accumulator, MlasLoadFloat32x4(Row1 + n));
+            Accumulator = ReduceOperation::Accumulate(Accumulator, MlasLoadFloat32x4(Row2 + n));
+            Accumulator = ReduceOperation::Accumulate(Accumulator, MlasLoadFloat32x4(Row3 + n));
+
+            MlasStoreFloat32x4(Output + n, Accumulator);
+        }
+
+        for (; n < CountN; n++) {
+
+            float Accumulator = Output[n];
+
+            Accumulator = ReduceOperation::Accumulate(Accumulator, Row0[n]);
+            Accumulator = ReduceOperation::Accumulate(Accumulator, Row1[n]);
+            Accumulator = ReduceOperation::Accumulate(Accumulator, Row2[n]);
+            Accumulator = ReduceOperation::Accumulate(Accumulator, Row3[n]);
+
+            Output[n] = Accumulator;
+        }
+
+        Input += 4 * ldi;
+        CountK -= 4;
+    }
+
+    while (CountK > 0) {
+
+        size_t n = 0;
+
+        for (; n + 4 <= CountN; n += 4) {
+            MLAS_FLOAT32X4 Accumulator = MlasLoadFloat32x4(Output + n);
+            MlasStoreFloat32x4(Output + n, ReduceOperation::Accumulate(Accumulator, MlasLoadFloat32x4(Input + n)));
+        }
+
+        for (; n < CountN; n++) {
+            Output[n] = ReduceOperation::Accumulate(Output[n], Input[n]);
+        }
+
+        Input += ldi;
+        CountK -= 1;
+    }
+}
+
+template<typename ReduceOperation>
+void
+MlasReduceRowsOperation(
+    const float* Input,
+    size_t ldi,
+    float* Output,
+    size_t CountM,
+    size_t CountK
+    )
+{
+    for (size_t m = 0; m < CountM; m++) {
+        Output[m] = MlasReduceRowKernel<ReduceOperation>(Input + m * ldi, CountK);
+    }
+}
+
+template<typename ReduceOperation>
+void
+MlasReduceColumnsOperation(
+    const float* Input,
+    size_t ldi,
+    float* Output,
+    size_t CountK,
+    size_t CountN
+    )
+{
+    for (size_t n = 0; n < CountN; n += MLAS_REDUCE_COLUMN_BLOCK) {
+        const size_t CountBlock = std::min(CountN - n, MLAS_REDUCE_COLUMN_BLOCK);
+        MlasReduceColumnKernel<ReduceOperation>(Input + n, ldi, Output + n, CountK, CountBlock);
+    }
+}
+
+void
+MlasReduceRowsLogSumExp(
+    const float* Input,
+    size_t ldi,
+    float* Output,
+    size_t CountM,
+    size_t CountK
+    )
+/*++
+
+Routine Description:
+
+    This routine computes log(sum(exp(x))) of each row of a matrix. The
+    maximum of the row is subtracted before the exponential so that the
+    intermediate results do not overflow.
+
+Arguments:
+
+    See MlasReduceRows.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    for (size_t m = 0; m < CountM; m++) {
+
+        const float* Row = Input + m * ldi;
+        const float Maximum = MlasReduceRowKernel<MLAS_REDUCE_MAXIMUM_OPERATION>(Row, CountK);
+
+        //
+        // The result is infinite if any element is positive infinity or if
+        // all elements are negative infinity (including an empty row).
+        //
+
+        if (std::isinf(Maximum)) {
+            Output[m] = Maximum;
+            continue;
+        }
+
+        float NegativeMaximum = -Maximum;
+
+#if defined(MLAS_TARGET_AMD64)
+        const float Accumulation = GetMlasPlatform().ComputeSumExpF32Kernel(Row, nullptr, CountK, &NegativeMaximum);
+#else
+        const float Accumulation = MlasComputeSumExpF32Kernel(Row, nullptr, CountK, &NegativeMaximum);
+#endif
+
+        Output[m] = std::log(Accumulation) + Maximum;
+    }
+}
+
+void
+MlasReduceColumnsLogSumExp(
+    const float* Input,
+    size_t ldi,
+    float* Output,
+    size_t CountK,
+    size_t CountN
+    )
+/*++
+
+Routine Description:
+
+    This routine computes log(sum(exp(x))) of each column of a matrix.
+
+    The column maximums of a block are computed first. The rows of the block
+    are then shifted by the maximums and batched into a buffer so that the
+    exponentials are computed by a few calls to MlasComputeExp even when the
+    block is narrow.
+
+Arguments:
+
+    See MlasReduceColumns.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_DECLSPEC_ALIGN(float Shift[MLAS_REDUCE_COLUMN_BLOCK], 64);
+    MLAS_DECLSPEC_ALIGN(float Accumulation[MLAS_REDUCE_COLUMN_BLOCK], 64);
+    MLAS_DECLSPEC_ALIGN(float Buffer[MLAS_REDUCE_COLUMN_BLOCK], 64);
+
+    for (size_t n = 0; n < CountN; n += MLAS_REDUCE_COLUMN_BLOCK) {
+
+        const size_t CountBlock = std::min(CountN - n, MLAS_REDUCE_COLUMN_BLOCK);
+        const size_t RowsPerBatch = MLAS_REDUCE_COLUMN_BLOCK / CountBlock;
+        float* Maximum = Output + n;
+
+        MlasReduceColumnKernel<MLAS_REDUCE_MAXIMUM_OPERATION>(Input + n, ldi, Maximum, CountK, CountBlock);
+
+        for (size_t j = 0; j < CountBlock; j++) {
+            Shift[j] = std::isinf(Maximum[j]) ? 0.0f : Maximum[j];
+            Accumulation[j] = 0.0f;
+        }
+
+        for (size_t k = 0; k < CountK; k += RowsPerBatch) {
+
+            const size_t CountRows = std::min(CountK - k, RowsPerBatch);
+
+            for (size_t r = 0; r < CountRows; r++) {
+
+                const float* Row = Input + (k + r) * ldi + n;
+                float* BufferRow = Buffer + r * CountBlock;
+
+                for (size_t j = 0; j < CountBlock; j++) {
+                    BufferRow[j] = Row[j] - Shift[j];
+                }
+            }
+
+            MlasComputeExp(Buffer, Buffer, CountRows * CountBlock);
+
+            for (size_t r = 0; r < CountRows; r++) {
+
+                const float* BufferRow = Buffer + r * CountBlock;
+                size_t j = 0;
+
+                for (; j + 4 <= CountBlock; j += 4) {
+                    MLAS_FLOAT32X4 Vector = MlasAddFloat32x4(MlasLoadFloat32x4(Accumulation + j), MlasLoadFloat32x4(BufferRow + j));
+                    MlasStoreFloat32x4(Accumulation + j, Vector);
+                }
+
+                for (; j < CountBlock; j++) {
+                    Accumulation[j] += BufferRow[j];
+                }
+            }
+        }
+
+        for (size_t j = 0; j < CountBlock; j++) {
+            if (!std::isinf(Maximum[j])) {
+                Maximum[j] = std::log(Accumulation[j]) + Maximum[j];
+            }
+        }
+    }
+}
+
+void
+MLASCALL
+MlasReduceRows(
+    MLAS_REDUCE_KIND ReduceKind,
+    const float* Input,
+    size_t ldi,
+    float* Output,
+    size_t CountM,
+    size_t CountK
+    )
+/*++
+
+Routine Description:
+
+    This routine reduces each row of a matrix to a single value.
+
+Arguments:
+
+    ReduceKind - Supplies the kind of reduction.
+
+    Input - Supplies the input matrix.
+
+    ldi - Supplies the first dimension of the input matrix.
+
+    Output - Supplies the output buffer, one value per row.
+
+    CountM - Supplies the number of rows.
+
+    CountK - Supplies the number of elements to reduce in each row.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    switch (ReduceKind) {
+
+        case MlasReduceSum:
+            MlasReduceRowsOperation<MLAS_REDUCE_SUM_OPERATION>(Input, ldi, Output, CountM, CountK);
+            break;
+
+        case MlasReduceSumSquare:
+            MlasReduceRowsOperation<MLAS_REDUCE_SUM_SQUARE_OPERATION>(Input, ldi, Output, CountM, CountK);
+            break;
+
+        case MlasReduceSumAbsolute:
+            MlasReduceRowsOperation<MLAS_REDUCE_SUM_ABSOLUTE_OPERATION>(Input, ldi, Output, CountM, CountK);
+            break;
+
+        case MlasReduceMaximum:
+            MlasReduceRowsOperation<MLAS_REDUCE_MAXIMUM_OPERATION>(Input, ldi, Output, CountM, CountK);
+            break;
+
+        case MlasReduceMinimum:
+            MlasReduceRowsOperation<MLAS_REDUCE_MINIMUM_OPERATION>(Input, ldi, Output, CountM, CountK);
+            break;
+
+        case MlasReduceLogSumExp:
+            MlasReduceRowsLogSumExp(Input, ldi, Output, CountM, CountK);
+            break;
+
+        default:
+            MLAS_THROW_EX(std::runtime_error, "bad mlas reduction kind");
+    }
+}
+
+void
+MLASCALL
+MlasReduceColumns(
+    MLAS_REDUCE_KIND ReduceKind,
+    const float* Input,
+    size_t ldi,
+    float* Output,
+    size_t CountK,
+    size_t CountN
+    )
+/*++
+
+Routine Description:
+
+    This routine reduces the rows of a matrix to a single row.
+
+Arguments:
+
+    ReduceKind - Supplies the kind of reduction.
+
+    Input - Supplies the input matrix.
+
+    ldi - Supplies the first dimension of the input matrix.
+
+    Output - Supplies the output buffer, one value per column.
+
+    CountK - Supplies the number of rows to reduce.
+
+    CountN - Supplies the number of columns.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    switch (ReduceKind) {
+
+        case MlasReduceSum:
+            MlasReduceColumnsOperation<MLAS_REDUCE_SUM_OPERATION>(Input, ldi, Output, CountK, CountN);
+            break;
+
+        case MlasReduceSumSquare:
+            MlasReduceColumnsOperation<MLAS_REDUCE_SUM_SQUARE_OPERATION>(Input, ldi, Output, CountK, CountN);
+            break;
+
+        case MlasReduceSumAbsolute:
+            MlasReduceColumnsOperation<MLAS_REDUCE_SUM_ABSOLUTE_OPERATION>(Input, ldi, Output, CountK, CountN);
+            break;
+
+        case MlasReduceMaximum:
+            MlasReduceColumnsOperation<MLAS_REDUCE_MAXIMUM_OPERATION>(Input, ldi, Output, CountK, CountN);
+            break;
+
+        case MlasReduceMinimum:
+            MlasReduceColumnsOperation<MLAS_REDUCE_MINIMUM_OPERATION>(Input, ldi, Output, CountK, CountN);
+            break;
+
+        case MlasReduceLogSumExp:
+            MlasReduceColumnsLogSumExp(Input, ldi, Output, CountK, CountN);
+            break;
+
+        default:
+            MLAS_THROW_EX(std::runtime_error, "bad mlas reduction kind");
+    }
+}
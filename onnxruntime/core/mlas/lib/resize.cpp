@@ -0,0 +1,378 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    resize.cpp
+
+Abstract:
+
+    This module implements routines to resize images stored in the NCHW or
+    NHWC layouts.
+
+    Bilinear and bicubic interpolation are separable: the two or four input
+    rows that contribute to an output row are blended once with vector
+    operations, then each output pixel only blends two or four pixels of the
+    blended row instead of four or sixteen pixels of the input rows.
+
+--*/
+
+#include "mlasi.h"
+
+void
+MlasBilinearResizeBlendRows(
+    const float* InputRow1,
+    const float* InputRow2,
+    float RowWeight1,
+    float RowWeight2,
+    float* Buffer,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the weighted sum of two rows.
+
+Arguments:
+
+    InputRow1 - Supplies the first input row.
+
+    InputRow2 - Supplies the second input row.
+
+    RowWeight1 - Supplies the weight of the first input row.
+
+    RowWeight2 - Supplies the weight of the second input row.
+
+    Buffer - Supplies the buffer that receives the weighted sum.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_FLOAT32X4 RowWeight1Vector = MlasBroadcastFloat32x4(RowWeight1);
+    MLAS_FLOAT32X4 RowWeight2Vector = MlasBroadcastFloat32x4(RowWeight2);
+
+    while (N >= 8) {
+
+        MLAS_FLOAT32X4 Vector0 = MlasMultiplyFloat32x4(MlasLoadFloat32x4(InputRow1), RowWeight1Vector);
+        MLAS_FLOAT32X4 Vector1 = MlasMultiplyFloat32x4(MlasLoadFloat32x4(InputRow1 + 4), RowWeight1Vector);
+
+        Vector0 = MlasMultiplyAddFloat32x4(MlasLoadFloat32x4(InputRow2), RowWeight2Vector, Vector0);
+        Vector1 = MlasMultiplyAddFloat32x4(MlasLoadFloat32x4(InputRow2 + 4), RowWeight2Vector, Vector1);
+
+        MlasStoreFloat32x4(Buffer, Vector0);
+        MlasStoreFloat32x4(Buffer + 4, Vector1);
+
+        InputRow1 += 8;
+        InputRow2 += 8;
+        Buffer += 8;
+        N -= 8;
+    }
+
+    if (N >= 4) {
+
+        MLAS_FLOAT32X4 Vector0 = MlasMultiplyFloat32x4(MlasLoadFloat32x4(InputRow1), RowWeight1Vector);
+
+        Vector0 = MlasMultiplyAddFloat32x4(MlasLoadFloat32x4(InputRow2), RowWeight2Vector, Vector0);
+
+        MlasStoreFloat32x4(Buffer, Vector0);
+
+        InputRow1 += 4;
+        InputRow2 += 4;
+        Buffer += 4;
+        N -= 4;
+    }
+
+    while (N > 0) {
+
+        *Buffer++ = *InputRow1++ * RowWeight1 + *InputRow2++ * RowWeight2;
+
+        N -= 1;
+    }
+}
+
+void
+MLASCALL
+MlasBilinearResizeRow(
+    const float* InputRow1,
+    const float* InputRow2,
+    float RowWeight1,
+    float RowWeight2,
+    const int32_t* InputColumn1,
+    const int32_t* InputColumn2,
+    const float* ColumnWeight1,
+    const float* ColumnWeight2,
+    size_t InputWidth,
+    size_t OutputWidth,
+    size_t Channels,
+    float* Buffer,
+    float* Output
+    )
+/*++
+
+Routine Description:
+
+    This routine computes a row of a bilinear resize operation.
+
+Arguments:
+
+    InputRow1 - Supplies the first input row of InputWidth pixels.
+
+    InputRow2 - Supplies the second input row of InputWidth pixels. This may
+        be the same row as the first input row.
+
+    RowWeight1 - Supplies the weight of the first input row.
+
+    RowWeight2 - Supplies the weight of the second input row.
+
+    InputColumn1 - Supplies the first input column of each output pixel.
+
+    InputColumn2 - Supplies the second input column of each output pixel.
+
+    ColumnWeight1 - Supplies the weight of the first input column of each
+        output pixel.
+
+    ColumnWeight2 - Supplies the weight of the second input column of each
+        output pixel.
+
+    InputWidth - Supplies the number of pixels of the input rows.
+
+    OutputWidth - Supplies the number of pixels of the output row.
+
+    Channels - Supplies the number of interleaved elements of each pixel. This
+        is one for the NCHW layout.
+
+    Buffer - Supplies a buffer of InputWidth * Channels elements that receives
+        the blended input rows.
+
+    Output - Supplies the output row.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const float* BlendedRow = InputRow1;
+
+    if (InputRow1 != InputRow2 && RowWeight2 != 0.0f) {
+        MlasBilinearResizeBlendRows(InputRow1, InputRow2, RowWeight1, RowWeight2, Buffer, InputWidth * Channels);
+        BlendedRow = Buffer;
+    } else if (RowWeight1 + RowWeight2 != 1.0f) {
+        MlasBilinearResizeBlendRows(InputRow1, InputRow1, RowWeight1, RowWeight2, Buffer, InputWidth * Channels);
+        BlendedRow = Buffer;
+    }
+
+    if (Channels == 1) {
+
+        for (size_t x = 0; x < OutputWidth; x++) {
+            Output[x] = BlendedRow[InputColumn1[x]] * ColumnWeight1[x] + BlendedRow[InputColumn2[x]] * ColumnWeight2[x];
+        }
+
+        return;
+    }
+
+    for (size_t x = 0; x < OutputWidth; x++) {
+
+        const float* Pixel1 = BlendedRow + size_t(InputColumn1[x]) * Channels;
+        const float* Pixel2 = BlendedRow + size_t(InputColumn2[x]) * Channels;
+        const float Weight1 = ColumnWeight1[x];
+        const float Weight2 = ColumnWeight2[x];
+
+        MLAS_FLOAT32X4 Weight1Vector = MlasBroadcastFloat32x4(Weight1);
+        MLAS_FLOAT32X4 Weight2Vector = MlasBroadcastFloat32x4(Weight2);
+
+        size_t c = 0;
+
+        for (; c + 4 <= Channels; c += 4) {
+
+            MLAS_FLOAT32X4 Vector = MlasMultiplyFloat32x4(MlasLoadFloat32x4(Pixel1 + c), Weight1Vector);
+
+            Vector = MlasMultiplyAddFloat32x4(MlasLoadFloat32x4(Pixel2 + c), Weight2Vector, Vector);
+
+            MlasStoreFloat32x4(Output + c, Vector);
+        }
+
+        for (; c < Channels; c++) {
+            Output[c] = Pixel1[c] * Weight1 + Pixel2[c] * Weight2;
+        }
+
+        Output += Channels;
+    }
+}
+
+void
+MlasBicubicResizeBlendRows(
+    const float* const* InputRows,
+    const float* RowWeights,
+    float* Buffer,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the weighted sum of four rows.
+
+Arguments:
+
+    InputRows - Supplies the four input rows.
+
+    RowWeights - Supplies the weights of the four input rows.
+
+    Buffer - Supplies the buffer that receives the weighted sum.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const float* InputRow0 = InputRows[0];
+    const float* InputRow1 = InputRows[1];
+    const float* InputRow2 = InputRows[2];
+    const float* InputRow3 = InputRows[3];
+
+    MLAS_FLOAT32X4 RowWeight0Vector = MlasBroadcastFloat32x4(RowWeights[0]);
+    MLAS_FLOAT32X4 RowWeight1Vector = MlasBroadcastFloat32x4(RowWeights[1]);
+    MLAS_FLOAT32X4 RowWeight2Vector = MlasBroadcastFloat32x4(RowWeights[2]);
+    MLAS_FLOAT32X4 RowWeight3Vector = MlasBroadcastFloat32x4(RowWeights[3]);
+
+    while (N >= 4) {
+
+        MLAS_FLOAT32X4 Vector = MlasMultiplyFloat32x4(MlasLoadFloat32x4(InputRow0), RowWeight0Vector);
+
+        Vector = MlasMultiplyAddFloat32x4(MlasLoadFloat32x4(InputRow1), RowWeight1Vector, Vector);
+        Vector = MlasMultiplyAddFloat32x4(MlasLoadFloat32x4(InputRow2), RowWeight2Vector, Vector);
+        Vector = MlasMultiplyAddFloat32x4(MlasLoadFloat32x4(InputRow3), RowWeight3Vector, Vector);
+
+        MlasStoreFloat32x4(Buffer, Vector);
+
+        InputRow0 += 4;
+        InputRow1 += 4;
+        InputRow2 += 4;
+        InputRow3 += 4;
+        Buffer += 4;
+        N -= 4;
+    }
+
+    while (N > 0) {
+
+        *Buffer++ = *InputRow0++ * RowWeights[0] + *InputRow1++ * RowWeights[1] +
+            *InputRow2++ * RowWeights[2] + *InputRow3++ * RowWeights[3];
+
+        N -= 1;
+    }
+}
+
+void
+MLASCALL
+MlasBicubicResizeRow(
+    const float* const* InputRows,
+    const float* RowWeights,
+    const int32_t* InputColumns,
+    const float* ColumnWeights,
+    size_t InputWidth,
+    size_t OutputWidth,
+    size_t Channels,
+    float* Buffer,
+    float* Output
+    )
+/*++
+
+Routine Description:
+
+    This routine computes a row of a bicubic resize operation.
+
+Arguments:
+
+    InputRows - Supplies the four input rows of InputWidth pixels. Rows may
+        repeat at the borders of the image.
+
+    RowWeights - Supplies the weights of the four input rows.
+
+    InputColumns - Supplies the four input columns of each output pixel.
+
+    ColumnWeights - Supplies the weights of the four input columns of each
+        output pixel.
+
+    InputWidth - Supplies the number of pixels of the input rows.
+
+    OutputWidth - Supplies the number of pixels of the output row.
+
+    Channels - Supplies the number of interleaved elements of each pixel. This
+        is one for the NCHW layout.
+
+    Buffer - Supplies a buffer of InputWidth * Channels elements that receives
+        the blended input rows.
+
+    Output - Supplies the output row.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasBicubicResizeBlendRows(InputRows, RowWeights, Buffer, InputWidth * Channels);
+
+    if (Channels == 1) {
+
+        for (size_t x = 0; x < OutputWidth; x++) {
+
+            const int32_t* Columns = InputColumns + 4 * x;
+            const float* Weights = ColumnWeights + 4 * x;
+
+            Output[x] = Buffer[Columns[0]] * Weights[0] + Buffer[Columns[1]] * Weights[1] +
+                Buffer[Columns[2]] * Weights[2] + Buffer[Columns[3]] * Weights[3];
+        }
+
+        return;
+    }
+
+    for (size_t x = 0; x < OutputWidth; x++) {
+
+        const int32_t* Columns = InputColumns + 4 * x;
+        const float* Weights = ColumnWeights + 4 * x;
+
+        const float* Pixel0 = Buffer + size_t(Columns[0]) * Channels;
+        const float* Pixel1 = Buffer + size_t(Columns[1]) * Channels;
+        const float* Pixel2 = Buffer + size_t(Columns[2]) * Channels;
+        const float* Pixel3 = Buffer + size_t(Columns[3]) * Channels;
+
+        MLAS_FLOAT32X4 Weight0Vector = MlasBroadcastFloat32x4(Weights[0]);
+        MLAS_FLOAT32X4 Weight1Vector = MlasBroadcastFloat32x4(Weights[1]);
+        MLAS_FLOAT32X4 Weight2Vector = MlasBroadcastFloat32x4(Weights[2]);
+        MLAS_FLOAT32X4 Weight3Vector = MlasBroadcastFloat32x4(Weights[3]);
+
+        size_t c = 0;
+
+        for (; c + 4 <= Channels; c += 4) {
+
+            MLAS_FLOAT32X4 Vector = MlasMultiplyFloat32x4(MlasLoadFloat32x4(Pixel0 + c), Weight0Vector);
+
+            Vector = MlasMultiplyAddFloat32x4(MlasLoadFloat32x4(Pixel1 + c), Weight1Vector, Vector);
+            Vector = MlasMultiplyAddFloat32x4(MlasLoadFloat32x4(Pixel2 + c), Weight2Vector, Vector);
+            Vector = MlasMultiplyAddFloat32x4(MlasLoadFloat32x4(Pixel3 + c), Weight3Vector, Vector);
+
+            MlasStoreFloat32x4(Output + c, Vector);
+        }
+
+        for (; c < Channels; c++) {
+            Output[c] = Pixel0[c] * Weights[0] + Pixel1[c] * Weights[1] + Pixel2[c] * Weights[2] +
+                Pixel3[c] * Weights[3];
+        }
+
+        Output += Channels;
+    }
+}
@@ -1015,7 +1015,10 @@ MlasSgemmKernelLoop(
     size_t lda,
     size_t ldc,
     float alpha,
-    bool ZeroMode
+    bool ZeroMode,
+    const MLAS_GEMM_EPILOGUE* Epilogue,
+    size_t StartM,
+    size_t StartN
     )
 /*++
 
@@ -1051,6 +1054,14 @@ Arguments:
     ZeroMode - Supplies true if the output matrix must be zero initialized,
         else false if the output matrix is accumulated into.
 
+    Epilogue - Supplies the optional epilogue to apply to the rows computed by
+        each call of the kernel, if this is the last slice along the K
+        dimension.
+
+    StartM - Supplies the row of matrix C in the epilogue.
+
+    StartN - Supplies the column of matrix C in the epilogue.
+
 Return Value:
 
     Returns the next address of matrix C.
@@ -1071,6 +1082,15 @@ Return Value:
         }
 #endif
 
+        //
+        // Apply the epilogue while the rows are still in the cache.
+        //
+
+        if (Epilogue != nullptr) {
+            MlasGemmEpilogue(Epilogue, C, ldc, StartM, StartN, RowsHandled, CountN);
+            StartM += RowsHandled;
+        }
+
         C += ldc * RowsHandled;
         A += lda * RowsHandled;
         CountM -= RowsHandled;
@@ -1093,7 +1113,10 @@ MlasSgemmOperation(
     size_t ldb,
     float beta,
     float* C,
-    size_t ldc
+    size_t ldc,
+    const MLAS_GEMM_EPILOGUE* Epilogue,
+    size_t StartM,
+    size_t StartN
     )
 /*++
 
@@ -1131,6 +1154,12 @@ Arguments:
 
     ldc - Supplies the first dimension of matrix C.
 
+    Epilogue - Supplies the optional epilogue to apply to matrix C.
+
+    StartM - Supplies the row of matrix C in the epilogue.
+
+    StartN - Supplies the column of matrix C in the epilogue.
+
 Return Value:
 
     None.
@@ -1147,6 +1176,9 @@ Return Value:
 
     if (K == 0) {
         MlasSgemmMultiplyBeta(C, M, N, ldc, beta);
+        if (Epilogue != nullptr) {
+            MlasGemmEpilogue(Epilogue, C, ldc, StartM, StartN, M, N);
+        }
         return;
     }
 
@@ -1170,6 +1202,9 @@ Return Value:
 
         if (SgemmKernelM1Routine != nullptr) {
             SgemmKernelM1Routine(A, B, C, K, N, ldb, beta);
+            if (Epilogue != nullptr) {
+                MlasGemmEpilogue(Epilogue, C, ldc, StartM, StartN, M, N);
+            }
             return;
         }
 
@@ -1177,6 +1212,9 @@ Return Value:
 
         if (TransB == CblasNoTrans) {
             MlasGemvFloatKernel(A, B, C, K, N, ldb, (beta == 0.0f));
+            if (Epilogue != nullptr) {
+                MlasGemmEpilogue(Epilogue, C, ldc, StartM, StartN, M, N);
+            }
             return;
         }
 
@@ -1205,6 +1243,9 @@ Return Value:
 
         if (SgemmKernelM1Routine != nullptr) {
             SgemmKernelM1Routine(B, A, C, K, M, lda, beta);
+            if (Epilogue != nullptr) {
+                MlasGemmEpilogue(Epilogue, C, ldc, StartM, StartN, M, N);
+            }
             return;
         }
 
@@ -1267,6 +1308,8 @@ Return Value:
 
             CountK = std::min(K - k, StrideK);
 
+            const MLAS_GEMM_EPILOGUE* KernelEpilogue = (k + CountK == K) ? Epilogue : nullptr;
+
             //
             // Copy or transpose a panel of matrix B to a local packed buffer.
             //
@@ -1285,7 +1328,8 @@ Return Value:
 
             if (TransA == CblasNoTrans) {
 
-                MlasSgemmKernelLoop(A + k, PanelB, c, CountK, M, CountN, lda, ldc, alpha, ZeroMode);
+                MlasSgemmKernelLoop(A + k, PanelB, c, CountK, M, CountN, lda, ldc, alpha, ZeroMode,
+                    KernelEpilogue, StartM, StartN + n);
 
             } else {
 
@@ -1309,7 +1353,8 @@ Return Value:
                     // Step through the rows of the local buffer.
                     //
 
-                    c = MlasSgemmKernelLoop(PanelA, PanelB, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha, ZeroMode);
+                    c = MlasSgemmKernelLoop(PanelA, PanelB, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha, ZeroMode,
+                        KernelEpilogue, StartM + (M - RowsRemaining - RowsTransposed), StartN + n);
                 }
             }
 
@@ -1332,7 +1377,9 @@ MlasSgemmPackedOperation(
     size_t AlignedN,
     float beta,
     float* C,
-    size_t ldc
+    size_t ldc,
+    const MLAS_GEMM_EPILOGUE* Epilogue,
+    size_t StartM
     )
 /*++
 
@@ -1372,6 +1419,11 @@ Arguments:
 
     ldc - Supplies the first dimension of matrix C.
 
+    Epilogue - Supplies the optional epilogue to apply to matrix C.
+
+    StartM - Supplies the row of matrix C in the epilogue. The column is
+        RangeStartN.
+
 Return Value:
 
     None.
@@ -1380,6 +1432,19 @@ Return Value:
 {
     float PanelA[MLAS_SGEMM_TRANSA_ROWS * MLAS_SGEMM_PACKED_STRIDEK];
 
+    //
+    // Handle the special case of K equals zero. Apply the beta multiplier to
+    // the output matrix and exit.
+    //
+
+    if (K == 0) {
+        MlasSgemmMultiplyBeta(C, M, RangeCountN, ldc, beta);
+        if (Epilogue != nullptr) {
+            MlasGemmEpilogue(Epilogue, C, ldc, StartM, RangeStartN, M, RangeCountN);
+        }
+        return;
+    }
+
     //
     // Step through each slice of matrix B along the N dimension.
     //
@@ -1411,6 +1476,8 @@ Return Value:
 
             CountK = std::min(K - k, size_t(MLAS_SGEMM_PACKED_STRIDEK));
 
+            const MLAS_GEMM_EPILOGUE* KernelEpilogue = (k + CountK == K) ? Epilogue : nullptr;
+
             //
             // Step through each slice of matrix A along the M dimension.
             //
@@ -1420,7 +1487,8 @@ Return Value:
 
             if (TransA == CblasNoTrans) {
 
-                MlasSgemmKernelLoop(A + k, pb, c, CountK, M, CountN, lda, ldc, alpha, ZeroMode);
+                MlasSgemmKernelLoop(A + k, pb, c, CountK, M, CountN, lda, ldc, alpha, ZeroMode,
+                    KernelEpilogue, StartM, SliceStartN);
 
             } else {
 
@@ -1444,7 +1512,8 @@ Return Value:
                     // Step through the rows of the local buffer.
                     //
 
-                    c = MlasSgemmKernelLoop(PanelA, pb, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha, ZeroMode);
+                    c = MlasSgemmKernelLoop(PanelA, pb, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha, ZeroMode,
+                        KernelEpilogue, StartM + (M - RowsRemaining - RowsTransposed), SliceStartN);
                 }
             }
 
@@ -1540,7 +1609,8 @@ Return Value:
 
         MlasSgemmPackedOperation(TransA, RangeCountM, RangeStartN, RangeCountN,
             K, DataParams->alpha, A, lda, DataParams->B,
-            BlockedN * MLAS_SGEMM_STRIDEN_THREAD_ALIGN, DataParams->beta, C, ldc);
+            BlockedN * MLAS_SGEMM_STRIDEN_THREAD_ALIGN, DataParams->beta, C, ldc,
+            DataParams->Epilogue, RangeStartM);
 
     } else {
 
@@ -1549,7 +1619,8 @@ Return Value:
         const float* B = (const float*)DataParams->B + RangeStartN * ((TransB == CblasNoTrans) ? 1 : ldb);
 
         MlasSgemmOperation(TransA, TransB, RangeCountM, RangeCountN, K,
-            DataParams->alpha, A, lda, B, ldb, DataParams->beta, C, ldc);
+            DataParams->alpha, A, lda, B, ldb, DataParams->beta, C, ldc,
+            DataParams->Epilogue, RangeStartM, RangeStartN);
     }
 }
 #if defined(_MSC_VER) && !defined(__clang__)
@@ -0,0 +1,588 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    sparse_gemm.cpp
+
+Abstract:
+
+    This module implements the single precision matrix/matrix multiply
+    operation with a sparse matrix B, such as the weights of a pruned model.
+
+    Only the non-zero elements of B are multiplied, so the work is
+    proportional to the number of non-zero elements instead of N * K.
+
+--*/
+
+#include "mlasi.h"
+#include "sparse_gemm.h"
+
+//
+// Define the default striding parameters. A thread computes blocks of up to
+// MLAS_SPARSE_GEMM_STRIDEM rows, and a transposed tile of A is multiplied by
+// MLAS_SPARSE_GEMM_STRIDEN columns of B at a time.
+//
+
+constexpr size_t MLAS_SPARSE_GEMM_STRIDEM = 128;
+constexpr size_t MLAS_SPARSE_GEMM_STRIDEN = 128;
+
+static_assert(MLAS_SPARSE_GEMM_STRIDEM % MLAS_SPARSE_GEMM_TILE_M == 0);
+static_assert(MLAS_SPARSE_GEMM_TILE_M == 16, "the kernels hold a tile in four 4-float vectors");
+
+void
+MlasSparseGemmKernel(
+    const float* AT,
+    const float* Values,
+    const uint16_t* Rows,
+    const uint32_t* ColumnStart,
+    size_t CountN,
+    float* CT,
+    bool ZeroMode
+    )
+/*++
+
+Routine Description:
+
+    This routine is the portable implementation of the sparse GEMM kernel.
+
+Arguments:
+
+    See MLAS_SPARSE_GEMM_KERNEL.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    for (size_t n = 0; n < CountN; n++) {
+
+        MLAS_FLOAT32X4 Accumulator0 = MlasZeroFloat32x4();
+        MLAS_FLOAT32X4 Accumulator1 = MlasZeroFloat32x4();
+        MLAS_FLOAT32X4 Accumulator2 = MlasZeroFloat32x4();
+        MLAS_FLOAT32X4 Accumulator3 = MlasZeroFloat32x4();
+
+        for (size_t i = ColumnStart[n]; i < ColumnStart[n + 1]; i++) {
+
+            const float* a = AT + size_t(Rows[i]) * MLAS_SPARSE_GEMM_TILE_M;
+            const MLAS_FLOAT32X4 BElement = MlasBroadcastFloat32x4(Values[i]);
+
+            Accumulator0 = MlasMultiplyAddFloat32x4(MlasLoadFloat32x4(a), BElement, Accumulator0);
+            Accumulator1 = MlasMultiplyAddFloat32x4(MlasLoadFloat32x4(a + 4), BElement, Accumulator1);
+            Accumulator2 = MlasMultiplyAddFloat32x4(MlasLoadFloat32x4(a + 8), BElement, Accumulator2);
+            Accumulator3 = MlasMultiplyAddFloat32x4(MlasLoadFloat32x4(a + 12), BElement, Accumulator3);
+        }
+
+        if (!ZeroMode) {
+            Accumulator0 = MlasAddFloat32x4(Accumulator0, MlasLoadFloat32x4(CT));
+            Accumulator1 = MlasAddFloat32x4(Accumulator1, MlasLoadFloat32x4(CT + 4));
+            Accumulator2 = MlasAddFloat32x4(Accumulator2, MlasLoadFloat32x4(CT + 8));
+            Accumulator3 = MlasAddFloat32x4(Accumulator3, MlasLoadFloat32x4(CT + 12));
+        }
+
+        MlasStoreFloat32x4(CT, Accumulator0);
+        MlasStoreFloat32x4(CT + 4, Accumulator1);
+        MlasStoreFloat32x4(CT + 8, Accumulator2);
+        MlasStoreFloat32x4(CT + 12, Accumulator3);
+
+        CT += MLAS_SPARSE_GEMM_TILE_M;
+    }
+}
+
+const MLAS_SPARSE_GEMM_DISPATCH MlasSparseGemmDispatchDefault = {
+    MlasSparseGemmKernel,
+    0.1f,
+};
+
+MLAS_FORCEINLINE
+const MLAS_SPARSE_GEMM_DISPATCH*
+MlasSparseGemmGetDispatch()
+{
+    const MLAS_SPARSE_GEMM_DISPATCH* Dispatch = GetMlasPlatform().SparseGemmDispatch;
+    return (Dispatch != nullptr) ? Dispatch : &MlasSparseGemmDispatchDefault;
+}
+
+MLAS_FORCEINLINE
+void
+MlasSparseGemmTranspose4x4(
+    MLAS_FLOAT32X4& Vector0,
+    MLAS_FLOAT32X4& Vector1,
+    MLAS_FLOAT32X4& Vector2,
+    MLAS_FLOAT32X4& Vector3
+    )
+{
+    const MLAS_FLOAT32X4 Low02 = MlasInterleaveLowFloat32x4(Vector0, Vector2);
+    const MLAS_FLOAT32X4 High02 = MlasInterleaveHighFloat32x4(Vector0, Vector2);
+    const MLAS_FLOAT32X4 Low13 = MlasInterleaveLowFloat32x4(Vector1, Vector3);
+    const MLAS_FLOAT32X4 High13 = MlasInterleaveHighFloat32x4(Vector1, Vector3);
+
+    Vector0 = MlasInterleaveLowFloat32x4(Low02, Low13);
+    Vector1 = MlasInterleaveHighFloat32x4(Low02, Low13);
+    Vector2 = MlasInterleaveLowFloat32x4(High02, High13);
+    Vector3 = MlasInterleaveHighFloat32x4(High02, High13);
+}
+
+void
+MlasSparseGemmCopyTransposeA(
+    float* AT,
+    const float* A,
+    size_t lda,
+    bool TransA,
+    size_t CountM,
+    size_t CountK
+    )
+/*++
+
+Routine Description:
+
+    This routine copies a tile of up to MLAS_SPARSE_GEMM_TILE_M rows of matrix
+    A to a buffer holding the tile transposed. The rows of the buffer past
+    CountM are zeroed.
+
+Arguments:
+
+    AT - Supplies the address of the buffer, CountK rows of
+        MLAS_SPARSE_GEMM_TILE_M floats.
+
+    A - Supplies the address of the tile of matrix A.
+
+    lda - Supplies the leading dimension of matrix A.
+
+    TransA - Supplies true if matrix A is stored transposed (K x M).
+
+    CountM - Supplies the number of rows of the tile.
+
+    CountK - Supplies the number of columns of the tile.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (TransA) {
+
+        for (size_t k = 0; k < CountK; k++) {
+            std::copy_n(A + k * lda, CountM, AT + k * MLAS_SPARSE_GEMM_TILE_M);
+            std::fill_n(AT + k * MLAS_SPARSE_GEMM_TILE_M + CountM, MLAS_SPARSE_GEMM_TILE_M - CountM, 0.0f);
+        }
+
+        return;
+    }
+
+    //
+    // Transpose groups of 4 rows by blocks of 4 columns, then copy the
+    // remaining elements one at a time.
+    //
+
+    const size_t CountM4 = CountM & ~size_t(3);
+    const size_t CountK4 = CountK & ~size_t(3);
+
+    for (size_t m = 0; m < CountM4; m += 4) {
+
+        const float* a = A + m * lda;
+
+        for (size_t k = 0; k < CountK4; k += 4) {
+
+            MLAS_FLOAT32X4 Vector0 = MlasLoadFloat32x4(a + k);
+            MLAS_FLOAT32X4 Vector1 = MlasLoadFloat32x4(a + lda + k);
+            MLAS_FLOAT32X4 Vector2 = MlasLoadFloat32x4(a + 2 * lda + k);
+            MLAS_FLOAT32X4 Vector3 = MlasLoadFloat32x4(a + 3 * lda + k);
+
+            MlasSparseGemmTranspose4x4(Vector0, Vector1, Vector2, Vector3);
+
+            float* at = AT + k * MLAS_SPARSE_GEMM_TILE_M + m;
+
+            MlasStoreFloat32x4(at, Vector0);
+            MlasStoreFloat32x4(at + MLAS_SPARSE_GEMM_TILE_M, Vector1);
+            MlasStoreFloat32x4(at + 2 * MLAS_SPARSE_GEMM_TILE_M, Vector2);
+            MlasStoreFloat32x4(at + 3 * MLAS_SPARSE_GEMM_TILE_M, Vector3);
+        }
+
+        for (size_t i = 0; i < 4; i++) {
+            for (size_t k = CountK4; k < CountK; k++) {
+                AT[k * MLAS_SPARSE_GEMM_TILE_M + m + i] = a[i * lda + k];
+            }
+        }
+    }
+
+    for (size_t m = CountM4; m < CountM; m++) {
+        const float* a = A + m * lda;
+        for (size_t k = 0; k < CountK; k++) {
+            AT[k * MLAS_SPARSE_GEMM_TILE_M + m] = a[k];
+        }
+    }
+
+    if (CountM < MLAS_SPARSE_GEMM_TILE_M) {
+        for (size_t k = 0; k < CountK; k++) {
+            std::fill_n(AT + k * MLAS_SPARSE_GEMM_TILE_M + CountM, MLAS_SPARSE_GEMM_TILE_M - CountM, 0.0f);
+        }
+    }
+}
+
+void
+MlasSparseGemmStoreTransposeC(
+    const float* CT,
+    float* C,
+    size_t ldc,
+    size_t CountM,
+    size_t CountN,
+    float alpha,
+    float beta
+    )
+/*++
+
+Routine Description:
+
+    This routine transposes a tile of the result to matrix C, computing
+    C = alpha * CT^T + beta * C.
+
+Arguments:
+
+    CT - Supplies the address of the transposed result tile, CountN columns of
+        MLAS_SPARSE_GEMM_TILE_M floats.
+
+    C - Supplies the address of the tile of matrix C.
+
+    ldc - Supplies the leading dimension of matrix C.
+
+    CountM - Supplies the number of rows of the tile.
+
+    CountN - Supplies the number of columns of the tile.
+
+    alpha, beta - Supplies the scales of the product and of matrix C. Matrix C
+        is not read when beta is zero.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t CountM4 = CountM & ~size_t(3);
+    const size_t CountN4 = CountN & ~size_t(3);
+
+    const MLAS_FLOAT32X4 AlphaBroadcast = MlasBroadcastFloat32x4(alpha);
+    const MLAS_FLOAT32X4 BetaBroadcast = MlasBroadcastFloat32x4(beta);
+
+    for (size_t m = 0; m < CountM4; m += 4) {
+
+        float* c = C + m * ldc;
+
+        for (size_t n = 0; n < CountN4; n += 4) {
+
+            const float* ct = CT + n * MLAS_SPARSE_GEMM_TILE_M + m;
+
+            MLAS_FLOAT32X4 Vector[4];
+            Vector[0] = MlasLoadFloat32x4(ct);
+            Vector[1] = MlasLoadFloat32x4(ct + MLAS_SPARSE_GEMM_TILE_M);
+            Vector[2] = MlasLoadFloat32x4(ct + 2 * MLAS_SPARSE_GEMM_TILE_M);
+            Vector[3] = MlasLoadFloat32x4(ct + 3 * MLAS_SPARSE_GEMM_TILE_M);
+
+            MlasSparseGemmTranspose4x4(Vector[0], Vector[1], Vector[2], Vector[3]);
+
+            for (size_t i = 0; i < 4; i++) {
+                MLAS_FLOAT32X4 Result = MlasMultiplyFloat32x4(Vector[i], AlphaBroadcast);
+                if (beta != 0.0f) {
+                    Result = MlasMultiplyAddFloat32x4(MlasLoadFloat32x4(c + i * ldc + n), BetaBroadcast, Result);
+                }
+                MlasStoreFloat32x4(c + i * ldc + n, Result);
+            }
+        }
+    }
+
+    //
+    // Store the remaining columns of the groups of 4 rows, then the remaining
+    // rows.
+    //
+
+    for (size_t m = 0; m < CountM; m++) {
+
+        float* c = C + m * ldc;
+        const float* ct = CT + m;
+        const size_t StartN = (m < CountM4) ? CountN4 : 0;
+
+        for (size_t n = StartN; n < CountN; n++) {
+            const float Result = alpha * ct[n * MLAS_SPARSE_GEMM_TILE_M];
+            c[n] = (beta != 0.0f) ? Result + beta * c[n] : Result;
+        }
+    }
+}
+
+void
+MlasSparseGemmOperation(
+    const MLAS_SPARSE_GEMM_DISPATCH* Dispatch,
+    bool TransA,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const void* PackedB,
+    float beta,
+    float* C,
+    size_t ldc,
+    size_t RangeStartM,
+    size_t RangeCountM,
+    size_t RangeStartN,
+    size_t RangeCountN
+    )
+/*++
+
+Routine Description:
+
+    This routine computes a block of the result matrix.
+
+Arguments:
+
+    Dispatch - Supplies the kernel dispatch.
+
+    TransA - Supplies true if matrix A is stored transposed.
+
+    N - Supplies the number of columns of matrix B and C.
+
+    K - Supplies the depth of the multiplication.
+
+    alpha, A, lda, PackedB, beta, C, ldc - See MlasSparseGemm.
+
+    RangeStartM, RangeCountM - Supplies the rows of the block.
+
+    RangeStartN, RangeCountN - Supplies the columns of the block.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t KBlockCount = MlasDivRoundup(K, MLAS_SPARSE_GEMM_STRIDEK);
+    const uint32_t* ColumnStart = reinterpret_cast<const uint32_t*>(PackedB);
+    const size_t NonZeroCount = ColumnStart[KBlockCount * N];
+    const float* Values = reinterpret_cast<const float*>(ColumnStart + KBlockCount * N + 1);
+    const uint16_t* Rows = reinterpret_cast<const uint16_t*>(Values + NonZeroCount);
+
+    const size_t TransposedASize = UpAlignSize(K * MLAS_SPARSE_GEMM_TILE_M * sizeof(float));
+    const size_t AccumulatorSize = UpAlignSize(MLAS_SPARSE_GEMM_STRIDEN * MLAS_SPARSE_GEMM_TILE_M * sizeof(float));
+
+    MlasThreadedBufAlloc(TransposedASize + AccumulatorSize);
+    uint8_t* Buffer = ThreadedBufHolder.get();
+
+    float* AT = reinterpret_cast<float*>(Buffer);
+    float* CT = reinterpret_cast<float*>(Buffer + TransposedASize);
+
+    for (size_t m = 0; m < RangeCountM; m += MLAS_SPARSE_GEMM_TILE_M) {
+
+        const size_t CountM = std::min(RangeCountM - m, MLAS_SPARSE_GEMM_TILE_M);
+        const size_t StartM = RangeStartM + m;
+
+        MlasSparseGemmCopyTransposeA(AT, TransA ? A + StartM : A + StartM * lda, lda, TransA, CountM, K);
+
+        for (size_t n = 0; n < RangeCountN; n += MLAS_SPARSE_GEMM_STRIDEN) {
+
+            const size_t CountN = std::min(RangeCountN - n, MLAS_SPARSE_GEMM_STRIDEN);
+            const size_t StartN = RangeStartN + n;
+
+            if (K == 0) {
+                std::fill_n(CT, CountN * MLAS_SPARSE_GEMM_TILE_M, 0.0f);
+            }
+
+            for (size_t kb = 0; kb < KBlockCount; kb++) {
+                Dispatch->Kernel(AT + kb * MLAS_SPARSE_GEMM_STRIDEK * MLAS_SPARSE_GEMM_TILE_M, Values, Rows,
+                                 ColumnStart + kb * N + StartN, CountN, CT, kb == 0);
+            }
+
+            MlasSparseGemmStoreTransposeC(CT, C + StartM * ldc + StartN, ldc, CountM, CountN, alpha, beta);
+        }
+    }
+}
+
+float
+MLASCALL
+MlasSparseGemmDensityThreshold()
+{
+    return MlasSparseGemmGetDispatch()->DensityThreshold;
+}
+
+void
+MLASCALL
+MlasSparseGemm(
+    CBLAS_TRANSPOSE TransA,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const void* PackedB,
+    float beta,
+    float* C,
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool
+    )
+{
+    if (M == 0 || N == 0) {
+        return;
+    }
+
+    const MLAS_SPARSE_GEMM_DISPATCH* Dispatch = MlasSparseGemmGetDispatch();
+
+    const size_t KBlockCount = MlasDivRoundup(K, MLAS_SPARSE_GEMM_STRIDEK);
+    const size_t NonZeroCount = reinterpret_cast<const uint32_t*>(PackedB)[KBlockCount * N];
+
+    const size_t StrideM = MLAS_SPARSE_GEMM_STRIDEM;
+    const size_t ThreadCountM = MlasDivRoundup(M, StrideM);
+
+    //
+    // Compute the number of target threads given the complexity of the
+    // operation, which is proportional to the number of non-zero elements of
+    // B. Small requests should run using the single threaded path.
+    //
+
+    const double Complexity = double(M) * double(NonZeroCount + N);
+
+    ptrdiff_t TargetThreadCount = ptrdiff_t(Complexity / double(MLAS_SGEMM_THREAD_COMPLEXITY)) + 1;
+
+    ptrdiff_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (TargetThreadCount >= MaximumThreadCount) {
+        TargetThreadCount = MaximumThreadCount;
+    }
+
+    //
+    // Split the columns when there are fewer blocks of rows than threads. Each
+    // thread then transposes its own copy of the tiles of A.
+    //
+
+    size_t StrideN = N;
+
+    if (size_t(TargetThreadCount) > ThreadCountM) {
+        const size_t ThreadCountN = MlasDivRoundup(size_t(TargetThreadCount), ThreadCountM);
+        StrideN = MlasDivRoundup(N, ThreadCountN);
+        StrideN = MlasDivRoundup(StrideN, MLAS_SPARSE_GEMM_TILE_M) * MLAS_SPARSE_GEMM_TILE_M;
+    }
+
+    const size_t ThreadCountN = MlasDivRoundup(N, StrideN);
+
+    MlasTrySimpleParallel(ThreadPool, ThreadCountM * ThreadCountN, [&](ptrdiff_t tid) {
+        const size_t ThreadIdN = size_t(tid) / ThreadCountM;
+        const size_t ThreadIdM = size_t(tid) % ThreadCountM;
+
+        const size_t RangeStartM = ThreadIdM * StrideM;
+        const size_t RangeCountM = std::min(M - RangeStartM, StrideM);
+
+        const size_t RangeStartN = ThreadIdN * StrideN;
+        const size_t RangeCountN = std::min(N - RangeStartN, StrideN);
+
+        MlasSparseGemmOperation(Dispatch, TransA == CblasTrans, N, K, alpha, A, lda, PackedB, beta, C, ldc,
+                                RangeStartM, RangeCountM, RangeStartN, RangeCountN);
+    });
+}
+
+size_t
+MLASCALL
+MlasSparseGemmPackBSize(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb,
+    float MaximumDensity
+    )
+{
+    if (N == 0 || K == 0) {
+        return 0;
+    }
+
+    size_t NonZeroCount = 0;
+
+    if (TransB == CblasTrans) {
+        for (size_t n = 0; n < N; n++) {
+            const float* b = B + n * ldb;
+            for (size_t k = 0; k < K; k++) {
+                NonZeroCount += (b[k] != 0.0f);
+            }
+        }
+    } else {
+        for (size_t k = 0; k < K; k++) {
+            const float* b = B + k * ldb;
+            for (size_t n = 0; n < N; n++) {
+                NonZeroCount += (b[n] != 0.0f);
+            }
+        }
+    }
+
+    if (double(NonZeroCount) > double(MaximumDensity) * double(N) * double(K) ||
+        NonZeroCount > std::numeric_limits<uint32_t>::max()) {
+        return 0;
+    }
+
+    const size_t KBlockCount = MlasDivRoundup(K, MLAS_SPARSE_GEMM_STRIDEK);
+    const size_t BytesRequired = (KBlockCount * N + 1) * sizeof(uint32_t) +
+        NonZeroCount * (sizeof(float) + sizeof(uint16_t));
+    const size_t BufferAlignment = MlasGetPreferredBufferAlignment();
+    return (BytesRequired + BufferAlignment - 1) & ~(BufferAlignment - 1);
+}
+
+void
+MLASCALL
+MlasSparseGemmPackB(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb,
+    void* PackedB
+    )
+{
+    const size_t KBlockCount = MlasDivRoundup(K, MLAS_SPARSE_GEMM_STRIDEK);
+    const size_t RowStride = (TransB == CblasTrans) ? 1 : ldb;
+    const size_t ColumnStride = (TransB == CblasTrans) ? ldb : 1;
+
+    //
+    // Count the non-zero elements of each column of each block of rows to
+    // locate the arrays of values and rows.
+    //
+
+    uint32_t* ColumnStart = reinterpret_cast<uint32_t*>(PackedB);
+    uint32_t NonZeroCount = 0;
+
+    for (size_t kb = 0; kb < KBlockCount; kb++) {
+
+        const size_t StartK = kb * MLAS_SPARSE_GEMM_STRIDEK;
+        const size_t CountK = std::min(K - StartK, MLAS_SPARSE_GEMM_STRIDEK);
+
+        for (size_t n = 0; n < N; n++) {
+            ColumnStart[kb * N + n] = NonZeroCount;
+            const float* b = B + StartK * RowStride + n * ColumnStride;
+            for (size_t k = 0; k < CountK; k++) {
+                NonZeroCount += (b[k * RowStride] != 0.0f);
+            }
+        }
+    }
+
+    ColumnStart[KBlockCount * N] = NonZeroCount;
+
+    float* Values = reinterpret_cast<float*>(ColumnStart + KBlockCount * N + 1);
+    uint16_t* Rows = reinterpret_cast<uint16_t*>(Values + NonZeroCount);
+
+    for (size_t kb = 0; kb < KBlockCount; kb++) {
+
+        const size_t StartK = kb * MLAS_SPARSE_GEMM_STRIDEK;
+        const size_t CountK = std::min(K - StartK, MLAS_SPARSE_GEMM_STRIDEK);
+
+        for (size_t n = 0; n < N; n++) {
+            const float* b = B + StartK * RowStride + n * ColumnStride;
+            for (size_t k = 0; k < CountK; k++) {
+                const float Value = b[k * RowStride];
+                if (Value != 0.0f) {
+                    *Values++ = Value;
+                    *Rows++ = uint16_t(k);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,87 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    sparse_gemm.h
+
+Abstract:
+
+    This module defines the packing format and the kernel interface of the
+    single precision matrix/matrix multiply operation with a sparse matrix B.
+
+    The rows of matrix B are split in blocks of MLAS_SPARSE_GEMM_STRIDEK. The
+    non-zero elements of each column of a block are stored in order of their
+    row, and the columns of a block are stored one after another:
+
+        ColumnStart[KBlockCount * N + 1]  index of the first element of the
+                                          column n of the block kb, at
+                                          ColumnStart[kb * N + n]
+        Values[NonZeroCount]              values of the elements
+        Rows[NonZeroCount]                rows of the elements, relative to the
+                                          first row of their block
+
+    The format does not depend on the kernel, so a packed matrix can be
+    shared between processors with different instruction sets.
+
+    The driver transposes a tile of MLAS_SPARSE_GEMM_TILE_M rows of matrix A
+    into a buffer, so that a row of the buffer holds the same element of each
+    row of the tile. The product of the tile and a non-zero element of B then
+    is a single vector multiply-add of a row of the buffer and the broadcast
+    element.
+
+--*/
+
+#pragma once
+
+#include "mlasi.h"
+
+constexpr size_t MLAS_SPARSE_GEMM_TILE_M = 16;
+constexpr size_t MLAS_SPARSE_GEMM_STRIDEK = 256;
+
+static_assert(MLAS_SPARSE_GEMM_STRIDEK <= 65536, "rows are stored in 16 bits");
+
+/**
+ * @brief Sparse GEMM kernel: computes a block of the transposed result tile
+ *
+ *  CT[n][m] (+)= sum over the non-zero elements B[k][n] of the block of
+ *                AT[k][m] * B[k][n]
+ *
+ * @param[in]  AT           Address of the transposed tile of A for the block of
+ *                          rows of B, MLAS_SPARSE_GEMM_TILE_M floats per row
+ * @param[in]  Values       Values of the non-zero elements of B
+ * @param[in]  Rows         Rows of the non-zero elements of B
+ * @param[in]  ColumnStart  Index of the first element of each column, CountN + 1
+ *                          entries
+ * @param[in]  CountN       # of columns to compute
+ * @param[out] CT           Address of the transposed result tile,
+ *                          MLAS_SPARSE_GEMM_TILE_M floats per column
+ * @param[in]  ZeroMode     Whether CT is overwritten instead of accumulated
+ */
+typedef
+void
+(MLAS_SPARSE_GEMM_KERNEL)(
+    const float* AT,
+    const float* Values,
+    const uint16_t* Rows,
+    const uint32_t* ColumnStart,
+    size_t CountN,
+    float* CT,
+    bool ZeroMode
+    );
+
+struct MLAS_SPARSE_GEMM_DISPATCH {
+    MLAS_SPARSE_GEMM_KERNEL* Kernel;
+
+    //
+    // Fraction of non-zero elements of B below which the kernel is faster than
+    // the dense single precision GEMM of the processor.
+    //
+
+    float DensityThreshold;
+};
+
+MLAS_SPARSE_GEMM_KERNEL MlasSparseGemmKernel;
@@ -18,6 +18,14 @@ bool IsSupportedOptypeVersionAndDomain(const Node& node, const std::string& op_t
           graph_utils::MatchesOpSetDomain(node, domain));
 }
 
+#ifndef DISABLE_CONTRIB_OPS
+// QuickGelu(x) = x * sigmoid(alpha * x) is SiLU when alpha is 1.
+bool IsSilu(const Node& node) {
+  const auto* alpha = graph_utils::GetNodeAttribute(node, "alpha");
+  return alpha != nullptr && alpha->f() == 1.0f;
+}
+#endif
+
 // If the op has multiple versions, here we require it must have a single implementation that can work across all the
 // versions. Because in the fusion, we discarded the op version information.
 bool IsFusableActivation(const Node& node) {
@@ -33,6 +41,9 @@ bool IsFusableActivation(const Node& node) {
 #ifndef DISABLE_CONTRIB_OPS
          IsSupportedOptypeVersionAndDomain(node, "ScaledTanh", {1}, kOnnxDomain) ||
          IsSupportedOptypeVersionAndDomain(node, "ParametricSoftplus", {1}, kOnnxDomain) ||
+         // Applied by MLAS in the epilogue of the GEMM, see FusedGemm.
+         IsSupportedOptypeVersionAndDomain(node, "Gelu", {1}, kMSDomain) ||
+         (IsSupportedOptypeVersionAndDomain(node, "QuickGelu", {1}, kMSDomain) && IsSilu(node)) ||
 #endif
          IsSupportedOptypeVersionAndDomain(node, "ThresholdedRelu", {1, 10}, kOnnxDomain);
 }
@@ -38,7 +38,7 @@ Status GemmSumFusion::Apply(Graph& graph, Node& gemm_node, RewriteRuleEffect& mo
 
   Node& new_gemm_node = graph.AddNode(graph.GenerateNodeName(gemm_node.Name() + "_sum_transformed"),
                                       gemm_node.OpType(),
-                                      "Fused Gemm with Sum",
+                                      "Fused Gemm with " + sum_node.OpType(),
                                       new_gemm_input_defs,
                                       new_gemm_output_defs,
                                       {},
@@ -112,9 +112,10 @@ bool GemmSumFusion::SatisfyCondition(const Graph& graph, const Node& node, const
   const NodeArg* node_output = node.OutputDefs()[0];
   const Node& output_node = node.OutputEdgesBegin()->GetNode();
 
-  // Fusion can be applied if the only output node is a Sum with exactly two inputs.
+  // Fusion can be applied if the only output node is a Sum with exactly two inputs, or an Add.
   if (
-      !graph_utils::IsSupportedOptypeVersionAndDomain(output_node, "Sum", {1, 6, 8, 13}) ||
+      !(graph_utils::IsSupportedOptypeVersionAndDomain(output_node, "Sum", {1, 6, 8, 13}) ||
+        graph_utils::IsSupportedOptypeVersionAndDomain(output_node, "Add", {7, 13, 14})) ||
       output_node.InputDefs().size() != 2 ||
       // Make sure the two nodes do not span execution providers.
       output_node.GetExecutionProviderType() != node.GetExecutionProviderType()) {
@@ -10,14 +10,14 @@ namespace onnxruntime {
 /**
 @Class GemmSumFusion
 
-Rewrite rule that fuses Gemm and Sum nodes to a single Gemm node.
+Rewrite rule that fuses Gemm and Sum (or Add) nodes to a single Gemm node.
 This fusion can be applied in the following scenario:
 1) Sum at output of Gemm: when the output of a Gemm is immedietly summed with
     exactly one other element, we can fuse this Sum with Gemm by using the other
     Sum input as C, provided that the C input to the Gemm is missing.
     This is supported for opset >= 11, as this is when Gemm input C became optional.
-
-TODO: Support the Add use case: Sum(x, y) ~= Add.
+2) Add at output of Gemm: same as 1) as Add(x, y) == Sum(x, y). This covers residual
+    connections, which the CPU Gemm kernel adds in the epilogue of the GEMM.
 
 This patterm is attempted to be triggered only on nodes with op type "Gemm".
 
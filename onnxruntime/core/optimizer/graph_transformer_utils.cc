@@ -48,6 +48,7 @@
 #include "core/optimizer/matmul_activation_fusion.h"
 #include "core/optimizer/matmul_add_fusion.h"
 #include "core/optimizer/matmul_integer_to_float.h"
+#include "core/optimizer/matmul_q4_weight_quantization.h"
 #include "core/optimizer/matmul_scale_fusion.h"
 #include "core/optimizer/matmul_transpose_fusion.h"
 #include "core/optimizer/nchwc_transformer.h"
@@ -255,6 +256,8 @@ InlinedVector<std::unique_ptr<GraphTransformer>> GenerateTransformers(
                                                             QDQIsInt8Allowed() ? "1" : "0") == "1";
       const bool enable_gelu_approximation =
           session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsEnableGeluApproximation, "0") == "1";
+      const std::string matmul_q4_weight_quantization =
+          session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsMatMulQ4WeightQuantization, "0");
 
       const InlinedHashSet<std::string_view> cuda_rocm_eps = {onnxruntime::kCudaExecutionProvider,
                                                               onnxruntime::kRocmExecutionProvider};
@@ -341,6 +344,12 @@ InlinedVector<std::unique_ptr<GraphTransformer>> GenerateTransformers(
       }
 #endif
 
+      // MatMulQ4WeightQuantization changes the results of the model, so it needs to be manually enabled.
+      if (matmul_q4_weight_quantization == "zp8" || matmul_q4_weight_quantization == "sym") {
+        transformers.emplace_back(std::make_unique<MatMulQ4WeightQuantization>(
+            matmul_q4_weight_quantization == "sym" ? 0 : 1, cpu_ep));
+      }
+
 #endif  // !defined(DISABLE_CONTRIB_OPS)
       // The QDQFinalCleanupTransformer must run AFTER other transformers that fuse Q/DQ nodes. Otherwise, their
       // fusions might be prevented if this one removes a Q/DQ node too early.
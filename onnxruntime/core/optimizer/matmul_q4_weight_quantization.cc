@@ -0,0 +1,108 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#if !defined(DISABLE_CONTRIB_OPS)
+
+#include "core/optimizer/matmul_q4_weight_quantization.h"
+
+#include "core/graph/graph_utils.h"
+#include "core/mlas/inc/mlas_q4.h"
+#include "core/optimizer/initializer.h"
+
+namespace onnxruntime {
+
+// Returns the packed int4 initializer of the weight, creating it on first use so that
+// MatMul nodes sharing a weight also share its quantized form.
+static NodeArg& GetOrAddQ4Weight(Graph& graph, const ONNX_NAMESPACE::TensorProto& weight_tensor_proto,
+                                 MLAS_BLK_QUANT_TYPE qtype, size_t K, size_t N,
+                                 InlinedHashMap<std::string, NodeArg*>& q4_weights) {
+  NodeArg*& blob_arg = q4_weights[weight_tensor_proto.name()];
+  if (blob_arg != nullptr) {
+    return *blob_arg;
+  }
+
+  Initializer weight(weight_tensor_proto, graph.ModelPath());
+
+  const size_t blob_size = MlasQ4GemmPackBSize(qtype, N, K);
+  std::vector<uint8_t> blob(blob_size);
+  MlasQ4GemmPackB(qtype, blob.data(), weight.data<float>(), N, K, N);
+
+  ONNX_NAMESPACE::TensorProto blob_proto;
+  const char* suffix = qtype == BlkQ4Sym ? "_q4_sym" : "_q4_zp8";
+  blob_proto.set_name(graph.GenerateNodeArgName(weight_tensor_proto.name() + suffix));
+  blob_proto.set_data_type(ONNX_NAMESPACE::TensorProto_DataType_UINT8);
+  blob_proto.add_dims(static_cast<int64_t>(blob_size));
+  blob_proto.set_raw_data(blob.data(), blob_size);
+
+  blob_arg = &graph_utils::AddInitializer(graph, blob_proto);
+  return *blob_arg;
+}
+
+Status MatMulQ4WeightQuantization::ApplyImpl(Graph& graph, bool& modified, int graph_level,
+                                             const logging::Logger& logger) const {
+  const MLAS_BLK_QUANT_TYPE qtype = blk_quant_type_ == 0 ? BlkQ4Sym : BlkQ4Zp8;
+
+  InlinedHashMap<std::string, NodeArg*> q4_weights;
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+
+  for (auto node_index : node_topology_list) {
+    auto* node_ptr = graph.GetNode(node_index);
+    if (node_ptr == nullptr)
+      continue;  // node removed as part of an earlier fusion
+
+    Node& matmul_node = *node_ptr;
+    ORT_RETURN_IF_ERROR(Recurse(matmul_node, modified, graph_level, logger));
+
+    if (!graph_utils::IsSupportedOptypeVersionAndDomain(matmul_node, "MatMul", {1, 9, 13}) ||
+        !graph_utils::IsSupportedProvider(matmul_node, GetCompatibleExecutionProviders())) {
+      continue;
+    }
+
+    const NodeArg& weight_arg = *matmul_node.InputDefs()[1];
+    const ONNX_NAMESPACE::TensorProto* weight_tensor_proto = nullptr;
+    if (!graph_utils::NodeArgIsConstant(graph, weight_arg) ||
+        !graph.GetInitializedTensor(weight_arg.Name(), weight_tensor_proto) ||
+        weight_tensor_proto->data_type() != ONNX_NAMESPACE::TensorProto_DataType_FLOAT ||
+        weight_tensor_proto->dims_size() != 2) {
+      continue;
+    }
+
+    const int64_t K = weight_tensor_proto->dims(0);
+    const int64_t N = weight_tensor_proto->dims(1);
+    if (K <= 0 || N <= 0 ||
+        MlasQ4GemmPackBSize(qtype, static_cast<size_t>(N), static_cast<size_t>(K)) == 0) {
+      continue;  // no int4 kernel for this platform
+    }
+
+    NodeArg& blob_arg = GetOrAddQ4Weight(graph, *weight_tensor_proto, qtype,
+                                         static_cast<size_t>(K), static_cast<size_t>(N), q4_weights);
+
+    ONNX_NAMESPACE::TensorProto shape_proto;
+    shape_proto.set_name(graph.GenerateNodeArgName(weight_arg.Name() + "_shape"));
+    shape_proto.set_data_type(ONNX_NAMESPACE::TensorProto_DataType_INT64);
+    shape_proto.add_dims(2);
+    shape_proto.add_int64_data(K);
+    shape_proto.add_int64_data(N);
+    NodeArg& shape_arg = graph_utils::AddInitializer(graph, shape_proto);
+
+    Node& q4_node = graph.AddNode(graph.GenerateNodeName(matmul_node.Name() + "_Q4"),
+                                  "MatMulFpQ4",
+                                  "MatMul with int4 block quantized weight",
+                                  {matmul_node.MutableInputDefs()[0], &blob_arg, &shape_arg},
+                                  {matmul_node.MutableOutputDefs()[0]},
+                                  nullptr,
+                                  kMSDomain);
+    q4_node.AddAttribute("blk_quant_type", blk_quant_type_ == 0 ? int64_t{0} : int64_t{1});
+    q4_node.SetExecutionProviderType(matmul_node.GetExecutionProviderType());
+
+    graph_utils::FinalizeNodeFusion(graph, {matmul_node}, q4_node);
+    modified = true;
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
+
+#endif  // !defined(DISABLE_CONTRIB_OPS)
@@ -0,0 +1,44 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#if !defined(DISABLE_CONTRIB_OPS)
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+ * @brief Quantize constant fp32 MatMul weights to int4 blocks.
+ *
+ * Replaces a MatMul whose right hand side is a constant 2D float initializer
+ * with the contrib op MatMulFpQ4, packing the weight into the block quantized
+ * int4 blob consumed by MlasQ4GemmBatch. The activations stay in fp32, so this
+ * is a weight-only quantization: it cuts the weight memory traffic by about 7x,
+ * which is what bounds the token generation (small M) phase of large language
+ * models on CPU, at the cost of quantization error in the weights.
+ *
+ * It changes the results of the model, so it only runs when enabled through
+ * the session option kOrtSessionOptionsMatMulQ4WeightQuantization.
+ *
+ * @param blk_quant_type  value of the blk_quant_type attribute of MatMulFpQ4:
+ *                        0 for symmetric blocks, 1 for blocks with a zero point.
+ */
+class MatMulQ4WeightQuantization : public GraphTransformer {
+ public:
+  explicit MatMulQ4WeightQuantization(
+      int64_t blk_quant_type,
+      const InlinedHashSet<std::string_view>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("MatMulQ4WeightQuantization", compatible_execution_providers),
+        blk_quant_type_(blk_quant_type) {}
+
+ private:
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+
+  int64_t blk_quant_type_;
+};
+
+}  // namespace onnxruntime
+
+#endif  // !defined(DISABLE_CONTRIB_OPS)
@@ -13,6 +13,7 @@
 #include "core/providers/cpu/controlflow/utils.h"
 
 #include "core/framework/allocator.h"
+#include "core/framework/device_stream_collection.h"
 #include "core/framework/framework_common.h"
 #include "core/framework/op_kernel_context_internal.h"
 #include "core/framework/session_state.h"
@@ -24,6 +25,7 @@
 #include "core/providers/utils.h"
 
 #include "core/common/gsl.h"
+#include "core/common/narrow.h"
 
 #ifdef _MSC_VER
 #pragma warning(pop)
@@ -181,8 +183,51 @@ Loop::Info::Info(const onnxruntime::Node& node, const GraphViewer& subgraph_in)
     auto& output = subgraph_outputs[i];
     subgraph_output_names.push_back(output->Name());
   }
+
+  // 'cond' may be passed through directly or via an Identity node
+  const auto& cond_input_name = subgraph_input_names[1];
+  const auto& cond_output_name = subgraph_output_names[0];
+  cond_passthrough = cond_output_name == cond_input_name;
+  if (!cond_passthrough) {
+    for (const auto& node : subgraph.Nodes()) {
+      if (node.OpType() == "Identity" && node.Domain() == kOnnxDomain &&
+          node.OutputDefs()[0]->Name() == cond_output_name) {
+        cond_passthrough = node.InputDefs()[0]->Name() == cond_input_name;
+        break;
+      }
+    }
+  }
 }
 
+namespace {
+// Buffers for the loop carried variables produced by the subgraph, recycled across iterations.
+// The value produced for a variable in iteration i is the feed for iteration i + 1 and is released once iteration
+// i + 2 starts, so reusing the last released buffer alternates each variable between two buffers instead of allocating
+// a new one every iteration. A buffer is only handed out again once no OrtValue refers to it.
+class LoopStateBuffers : public std::enable_shared_from_this<LoopStateBuffers> {
+ public:
+  explicit LoopStateBuffers(size_t num_loop_carried_vars) : released_(num_loop_carried_vars) {}
+
+  void Allocate(size_t loop_carried_var_idx, MLDataType element_type, const TensorShape& shape,
+                AllocatorPtr allocator, OrtValue& ort_value) {
+    std::unique_ptr<Tensor> tensor = std::move(released_[loop_carried_var_idx]);
+    if (!tensor || tensor->DataType() != element_type || tensor->Shape() != shape ||
+        tensor->Location().device != allocator->Info().device) {
+      tensor = std::make_unique<Tensor>(element_type, shape, std::move(allocator));
+    }
+
+    // the subgraph runs on the thread executing the Loop node so values are released there as well
+    ort_value.Init(tensor.release(), DataTypeImpl::GetType<Tensor>(),
+                   [buffers = shared_from_this(), loop_carried_var_idx](void* p) {
+                     buffers->released_[loop_carried_var_idx].reset(static_cast<Tensor*>(p));
+                   });
+  }
+
+ private:
+  std::vector<std::unique_ptr<Tensor>> released_;
+};
+}  // namespace
+
 class LoopImpl {
  public:
   LoopImpl(OpKernelContextInternal& context,
@@ -201,9 +246,22 @@ class LoopImpl {
   void CreateInitialFeeds(std::vector<OrtValue>& feeds);
   void SaveOutputsAndUpdateFeeds(const std::vector<OrtValue>& last_outputs, std::vector<OrtValue>& next_inputs);
 
+  // setup the custom allocators that recycle the buffers of the loop carried variables
+  void CreateLoopStateAllocators();
+
   // create the single Loop output from a collection of per-iteration outputs
   Status ConcatenateLoopOutput(std::vector<OrtValue>& per_iteration_output, int output_index);
 
+  // When the number of iterations is known up front the Loop outputs are allocated after the first iteration and each
+  // iteration writes its outputs directly into its slice of them.
+  // Returns false if the outputs of the first iteration can't be written in place.
+  bool CanWriteLoopOutputsInPlace(const std::vector<OrtValue>& first_outputs) const;
+  Status AllocateLoopOutputs(const std::vector<OrtValue>& first_outputs);
+  // add the slices of the Loop outputs to fetches so the subgraph writes to them
+  void AddLoopOutputSlices(int64_t iter_num, std::vector<OrtValue>& fetches) const;
+  // copy any output that the subgraph didn't write in place, e.g. because it's a subgraph input
+  Status SaveOutputsInPlace(const std::vector<OrtValue>& last_outputs, int64_t iter_num);
+
   OpKernelContextInternal& context_;
   const SessionState& session_state_;
   const Loop::Info& info_;
@@ -221,6 +279,15 @@ class LoopImpl {
   std::vector<std::vector<OrtValue>> loop_output_tensors_;
 
   const Loop::ConcatOutput& concat_output_func_;
+
+  // the Loop runs exactly max_trip_count_ iterations unless the subgraph fails
+  bool trip_count_is_exact_;
+
+  std::shared_ptr<LoopStateBuffers> loop_state_buffers_;
+  std::unordered_map<size_t, IExecutor::CustomAllocator> fetch_allocators_;
+
+  // Loop outputs written in place. empty if the per-iteration outputs are concatenated at the end.
+  std::vector<Tensor*> in_place_outputs_;
 };
 
 static Status ConcatenateCpuOutput(void* /*stream*/,
@@ -382,6 +449,8 @@ LoopImpl::LoopImpl(OpKernelContextInternal& context,
 
   auto cond_tensor = context.Input<Tensor>(1);
   condition_ = cond_tensor ? *cond_tensor->Data<bool>() : true;
+
+  trip_count_is_exact_ = max_trip_count_tensor != nullptr && info_.cond_passthrough;
 }
 
 Status LoopImpl::Initialize() {
@@ -422,9 +491,39 @@ Status LoopImpl::Initialize() {
 
   loop_output_tensors_.resize(static_cast<size_t>(info_.num_outputs) - info_.num_loop_carried_vars);
 
+  CreateLoopStateAllocators();
+
   return status;
 }
 
+void LoopImpl::CreateLoopStateAllocators() {
+  loop_state_buffers_ = std::make_shared<LoopStateBuffers>(info_.num_loop_carried_vars);
+
+  auto& subgraph_outputs = info_.subgraph.GetOutputs();
+  for (int i = 0; i < info_.num_loop_carried_vars; ++i) {
+    // + 1 as first subgraph output is condition value
+    const size_t fetch_idx = static_cast<size_t>(i) + 1;
+    const auto* type_proto = subgraph_outputs[fetch_idx]->TypeAsProto();
+    if (type_proto == nullptr || !type_proto->has_tensor_type()) {
+      // sequences and optional values are allocated by the execution frame
+      continue;
+    }
+
+    MLDataType element_type =
+        DataTypeImpl::TensorTypeFromONNXEnum(type_proto->tensor_type().elem_type())->GetElementType();
+    fetch_allocators_[fetch_idx] = [this, i, element_type](const TensorShape& shape, const OrtDevice& location,
+                                                           OrtValue& ort_value, bool& allocated) {
+      AllocatorPtr allocator = session_state_.GetAllocator(location);
+      if (allocator) {
+        loop_state_buffers_->Allocate(static_cast<size_t>(i), element_type, shape, std::move(allocator), ort_value);
+        allocated = true;
+      }
+
+      return Status::OK();
+    };
+  }
+}
+
 void LoopImpl::CreateInitialFeeds(std::vector<OrtValue>& feeds) {
   feeds.reserve(static_cast<size_t>(info_.num_subgraph_inputs) + info_.num_implicit_inputs);
 
@@ -453,6 +552,10 @@ void LoopImpl::SaveOutputsAndUpdateFeeds(const std::vector<OrtValue>& last_outpu
     next_inputs[i] = last_outputs[i - 1];
   }
 
+  if (!in_place_outputs_.empty()) {
+    return;
+  }
+
   // save loop outputs as we have to concatenate at the end
   for (ptrdiff_t j = info_.num_loop_carried_vars; j < info_.num_outputs; ++j) {
     ORT_ENFORCE(last_outputs[j + 1].IsTensor(), "All scan outputs MUST be tensors");
@@ -480,6 +583,83 @@ Status LoopImpl::ConcatenateLoopOutput(std::vector<OrtValue>& per_iteration_outp
   return Status::OK();
 }
 
+bool LoopImpl::CanWriteLoopOutputsInPlace(const std::vector<OrtValue>& first_outputs) const {
+  if (!trip_count_is_exact_ || info_.num_outputs == info_.num_loop_carried_vars) {
+    return false;
+  }
+
+  for (int i = info_.num_loop_carried_vars; i < info_.num_outputs; ++i) {
+    const auto& ort_value = first_outputs[static_cast<ptrdiff_t>(i) + 1];  // skip cond
+    // strings can't be copied as bytes so leave them to the concatenation
+    if (!ort_value.IsTensor() || ort_value.Get<Tensor>().IsDataTypeString()) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+Status LoopImpl::AllocateLoopOutputs(const std::vector<OrtValue>& first_outputs) {
+  in_place_outputs_.reserve(static_cast<size_t>(info_.num_outputs) - info_.num_loop_carried_vars);
+
+  for (int i = info_.num_loop_carried_vars; i < info_.num_outputs; ++i) {
+    const auto& per_iteration_dims = first_outputs[static_cast<ptrdiff_t>(i) + 1].Get<Tensor>().Shape().GetDims();
+
+    std::vector<int64_t> dims;
+    dims.reserve(1 + per_iteration_dims.size());
+
+    // first dimension is number of iterations
+    dims.push_back(max_trip_count_);
+    std::copy(per_iteration_dims.begin(), per_iteration_dims.end(), std::back_inserter(dims));
+
+    in_place_outputs_.push_back(context_.Output(i, TensorShape(dims)));
+  }
+
+  // the first iteration couldn't write in place as the output shapes weren't known yet
+  return SaveOutputsInPlace(first_outputs, 0);
+}
+
+void LoopImpl::AddLoopOutputSlices(int64_t iter_num, std::vector<OrtValue>& fetches) const {
+  // need empty entries in fetches for the outputs the subgraph allocates so the order matches the output names
+  fetches.resize(info_.num_subgraph_outputs);
+
+  for (int i = info_.num_loop_carried_vars; i < info_.num_outputs; ++i) {
+    Tensor& output = *in_place_outputs_[static_cast<ptrdiff_t>(i) - info_.num_loop_carried_vars];
+    const size_t bytes_per_iteration = output.SizeInBytes() / narrow<size_t>(max_trip_count_);
+    void* slice = static_cast<gsl::byte*>(output.MutableDataRaw()) + narrow<size_t>(iter_num) * bytes_per_iteration;
+
+    Tensor::InitOrtValue(output.DataType(), output.Shape().Slice(1), slice, output.Location(),
+                         fetches[static_cast<ptrdiff_t>(i) + 1]);  // skip cond
+  }
+}
+
+Status LoopImpl::SaveOutputsInPlace(const std::vector<OrtValue>& last_outputs, int64_t iter_num) {
+  Stream* ort_stream = context_.GetComputeStream();
+
+  for (int i = info_.num_loop_carried_vars; i < info_.num_outputs; ++i) {
+    const auto& ort_value = last_outputs[static_cast<ptrdiff_t>(i) + 1];  // skip cond
+    ORT_ENFORCE(ort_value.IsTensor(), "All scan outputs MUST be tensors");
+
+    Tensor& output = *in_place_outputs_[static_cast<ptrdiff_t>(i) - info_.num_loop_carried_vars];
+    const auto& iteration_data = ort_value.Get<Tensor>();
+    const TensorShape per_iteration_shape = output.Shape().Slice(1);
+    if (iteration_data.Shape() != per_iteration_shape) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Inconsistent shape in loop output for output. ",
+                             " Expected:", per_iteration_shape, " Got:", iteration_data.Shape());
+    }
+
+    const size_t bytes_per_iteration = iteration_data.SizeInBytes();
+    void* slice = static_cast<gsl::byte*>(output.MutableDataRaw()) + narrow<size_t>(iter_num) * bytes_per_iteration;
+    if (iteration_data.DataRaw() != slice) {
+      std::vector<OrtValue> per_iteration_output{ort_value};
+      ORT_RETURN_IF_ERROR(concat_output_func_(ort_stream ? ort_stream->GetHandle() : nullptr, per_iteration_output,
+                                              slice, bytes_per_iteration));
+    }
+  }
+
+  return Status::OK();
+}
+
 Status LoopImpl::Execute(const FeedsFetchesManager& ffm) {
   auto status = Status::OK();
 
@@ -490,15 +670,27 @@ Status LoopImpl::Execute(const FeedsFetchesManager& ffm) {
 
   auto& iter_num_value = *iter_num_mlvalue_.GetMutable<Tensor>()->MutableData<int64_t>();
 
+#ifdef ORT_ENABLE_STREAM
+  // acquire the device streams once for all the iterations
+  DeviceStreamCollectionHolder device_stream_collection_holder(&session_state_);
+#endif
+
   while (iter_num_value < max_trip_count_ && *condition_mlvalue_.GetMutable<Tensor>()->MutableData<bool>()) {
     if (iter_num_value != 0) {
       SaveOutputsAndUpdateFeeds(fetches, feeds);
       fetches.clear();
+
+      if (!in_place_outputs_.empty()) {
+        AddLoopOutputSlices(iter_num_value, fetches);
+      }
     }
 
-    status = utils::ExecuteSubgraph(session_state_, ffm, feeds, fetches, {},
+    status = utils::ExecuteSubgraph(session_state_, ffm, feeds, fetches, fetch_allocators_,
                                     ExecutionMode::ORT_SEQUENTIAL, context_.GetTerminateFlag(), context_.Logger(),
                                     context_.GetComputeStream(),
+#ifdef ORT_ENABLE_STREAM
+                                    device_stream_collection_holder,
+#endif
                                     // because the fetch[0] is the loop condition which we need to access on CPU,
                                     // have to perofrm a stream sync to make sure the data arrived.
                                     true);
@@ -506,6 +698,12 @@ Status LoopImpl::Execute(const FeedsFetchesManager& ffm) {
 
     condition_mlvalue_ = fetches[0];
 
+    if (!in_place_outputs_.empty()) {
+      ORT_RETURN_IF_ERROR(SaveOutputsInPlace(fetches, iter_num_value));
+    } else if (iter_num_value == 0 && max_trip_count_ > 1 && CanWriteLoopOutputsInPlace(fetches)) {
+      ORT_RETURN_IF_ERROR(AllocateLoopOutputs(fetches));
+    }
+
     ++iter_num_value;
   }
 
@@ -581,7 +779,7 @@ Status LoopImpl::Execute(const FeedsFetchesManager& ffm) {
       ORT_RETURN_IF_ERROR(copy_mlvalue_to_output(fetches[static_cast<ptrdiff_t>(i) + 1], i, iter_num_value, *info_.loop_carried_vars_types[static_cast<ptrdiff_t>(i)]));  // skip cond
     }
 
-    for (int i = info_.num_loop_carried_vars; i < info_.num_outputs; ++i) {
+    for (int i = info_.num_loop_carried_vars; i < info_.num_outputs && in_place_outputs_.empty(); ++i) {
       // add last output
       auto& per_iteration_outputs = loop_output_tensors_[static_cast<ptrdiff_t>(i) - info_.num_loop_carried_vars];
       per_iteration_outputs.push_back(fetches[static_cast<ptrdiff_t>(i) + 1]);  // skip cond
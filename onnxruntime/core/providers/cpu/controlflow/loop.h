@@ -38,6 +38,10 @@ class Loop : public controlflow::IControlFlowKernel {
     std::vector<std::string> subgraph_output_names;
 
     std::vector<const ONNX_NAMESPACE::TypeProto*> loop_carried_vars_types;
+
+    // true if the subgraph returns its 'cond' input as the 'cond' output, so the Loop runs exactly 'M' iterations
+    // when 'M' is provided and 'cond' is initially true.
+    bool cond_passthrough;
   };
 
   // function to concatenate the OrtValue instances from each Loop iteration into a single output buffer.
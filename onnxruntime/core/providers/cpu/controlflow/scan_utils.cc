@@ -208,6 +208,11 @@ Status IterateSequence(OpKernelContextInternal& context, const SessionState& ses
     feeds[num_variadic_inputs + i] = *implicit_inputs[i];
   }
 
+#ifdef ORT_ENABLE_STREAM
+  // acquire the device streams once for all the iterations
+  DeviceStreamCollectionHolder device_stream_collection_holder(&session_state);
+#endif
+
   int64_t seq_no = 0;
   for (; seq_no < seq_length; ++seq_no) {
     for (int input = 0; input < num_variadic_inputs; ++input) {
@@ -272,7 +277,11 @@ Status IterateSequence(OpKernelContextInternal& context, const SessionState& ses
     // Create Executor and run graph.
     status = utils::ExecuteSubgraph(session_state, ffm, feeds, fetches, fetch_allocators,
                                     ExecutionMode::ORT_SEQUENTIAL, context.GetTerminateFlag(), context.Logger(),
+#ifdef ORT_ENABLE_STREAM
+                                    context.GetComputeStream(), device_stream_collection_holder);
+#else
                                     context.GetComputeStream());
+#endif
 
     ORT_RETURN_IF_ERROR(status);
 
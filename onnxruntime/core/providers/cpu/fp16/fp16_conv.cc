@@ -57,6 +57,11 @@ class FusedConvFp16 final : public OpKernel {
                                    int input_idx,
                                    /*out*/ bool& used_shared_buffers) override;
 
+  Status UseSerializedPrePackedBuffers(const Tensor& tensor, int input_idx,
+                                       std::vector<BufferUniquePtr>& prepacked_buffers,
+                                       gsl::span<const size_t> prepacked_buffer_sizes,
+                                       /*out*/ bool& used_prepacked_buffers) override;
+
  protected:
   bool channels_last_{false};
 
@@ -230,6 +235,51 @@ Status FusedConvFp16::UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& pr
   return Status::OK();
 }
 
+Status FusedConvFp16::UseSerializedPrePackedBuffers(const Tensor& tensor, int input_idx,
+                                                    std::vector<BufferUniquePtr>& prepacked_buffers,
+                                                    gsl::span<const size_t> prepacked_buffer_sizes,
+                                                    /*out*/ bool& used_prepacked_buffers) {
+  used_prepacked_buffers = false;
+  if (input_idx != 1 || prepacked_buffers.size() != prepacked_buffer_sizes.size()) {
+    return Status::OK();
+  }
+
+  const auto& shape = tensor.Shape().GetDims();
+  const size_t rank = shape.size();
+  if (rank <= 2 || shape[0] % conv_attrs_.group != 0) {
+    return Status::OK();
+  }
+
+  const size_t output_channels = static_cast<size_t>(shape[0]);
+  const size_t group_input_channels = static_cast<size_t>(shape[1]);
+  const size_t kernel_size =
+      static_cast<size_t>(std::accumulate(shape.data() + 2, shape.data() + rank, 1LL, std::multiplies<int64_t>()));
+  const size_t group_count = static_cast<size_t>(conv_attrs_.group);
+  const size_t kernel_dim = group_input_channels * kernel_size;
+
+  if (prepacked_buffers.size() == 1) {  // This means that only packed_W_ exists
+    const size_t packed_W_size = MlasHalfGemmPackBSize(output_channels / group_count, kernel_dim, false);
+    if (packed_W_size == 0 || prepacked_buffer_sizes[0] != static_cast<size_t>(SafeInt<size_t>(group_count) * packed_W_size)) {
+      return Status::OK();
+    }
+    packed_W_size_ = packed_W_size;
+    packed_W_buffer_ = std::move(prepacked_buffers[0]);
+  } else if (prepacked_buffers.size() == 2) {  // This means that only reordered_W_ exists
+    if (prepacked_buffers[0].get() != nullptr ||
+        prepacked_buffer_sizes[1] != static_cast<size_t>(SafeInt<size_t>(sizeof(MLFloat16)) * output_channels * kernel_dim)) {
+      return Status::OK();
+    }
+    reordered_W_buffer_ = std::move(prepacked_buffers[1]);
+  } else {
+    return Status::OK();
+  }
+
+  W_shape_ = shape;
+  is_W_packed_ = true;
+  used_prepacked_buffers = true;
+  return Status::OK();
+}
+
 Status FusedConvFp16::Compute(OpKernelContext* context) const {
   size_t num_inputs = OpKernel::Node().InputDefs().size();
   const Tensor* X = context->Input<Tensor>(0);
@@ -100,15 +100,50 @@ ONNX_CPU_OPERATOR_TYPED_KERNEL(
     KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<MLFloat16>()),
     Gemm<MLFloat16>);
 
+namespace {
+// Allocates the buffer of a packed B and writes its header. Returns the address of the packed data.
+void* AllocatePackedB(AllocatorPtr& alloc, size_t packed_b_size, GemmPackedBFormat format,
+                      IAllocatorUniquePtr<void>& packed_b) {
+  packed_b = IAllocator::MakeUniquePtr<void>(alloc, packed_b_size, true);
+
+  // Initialize memory to 0 as there could be some padding associated with pre-packed
+  // buffer memory and we don not want it uninitialized and generate different hashes
+  // if and when we try to cache this pre-packed buffer for sharing between sessions.
+  memset(packed_b.get(), 0, packed_b_size);
+
+  memcpy(packed_b.get(), &format, sizeof(format));
+  return static_cast<uint8_t*>(packed_b.get()) + kGemmPackedBHeaderSize;
+}
+}  // namespace
+
+GemmPackedBFormat GemmPackedBFormatOf(const void* packed_b) {
+  GemmPackedBFormat format;
+  memcpy(&format, packed_b, sizeof(format));
+  return format;
+}
+
+size_t GemmPackBFp32Size(const TensorShape& b_shape, bool trans_b) {
+  // Only handle the common case of a 2D weight matrix. Additional matrices
+  // could be handled by stacking the packed buffers.
+  if (b_shape.NumDimensions() != 2) {
+    return 0;
+  }
+
+  const size_t K = trans_b ? static_cast<size_t>(b_shape[1]) : static_cast<size_t>(b_shape[0]);
+  const size_t N = trans_b ? static_cast<size_t>(b_shape[0]) : static_cast<size_t>(b_shape[1]);
+
+  const size_t packed_b_data_size = MlasGemmPackBSize(N, K);
+  return packed_b_data_size == 0 ? 0 : kGemmPackedBHeaderSize + packed_b_data_size;
+}
+
 bool GemmPackBFp32(AllocatorPtr& alloc,
                    const Tensor& tensor_b,
                    bool trans_b,
                    IAllocatorUniquePtr<void>& packed_b,
                    size_t& packed_b_size,
                    TensorShape& b_shape) {
-  // Only handle the common case of a 2D weight matrix. Additional matrices
-  // could be handled by stacking the packed buffers.
-  if (tensor_b.Shape().NumDimensions() != 2) {
+  packed_b_size = GemmPackBFp32Size(tensor_b.Shape(), trans_b);
+  if (packed_b_size == 0) {
     return false;
   }
   b_shape = tensor_b.Shape();
@@ -116,19 +151,7 @@ bool GemmPackBFp32(AllocatorPtr& alloc,
   const size_t K = trans_b ? static_cast<size_t>(b_shape[1]) : static_cast<size_t>(b_shape[0]);
   const size_t N = trans_b ? static_cast<size_t>(b_shape[0]) : static_cast<size_t>(b_shape[1]);
 
-  packed_b_size = MlasGemmPackBSize(N, K);
-  if (packed_b_size == 0) {
-    return false;
-  }
-
-  packed_b = IAllocator::MakeUniquePtr<void>(alloc, packed_b_size, true);
-  auto* packed_b_data = packed_b.get();
-
-  // Initialize memory to 0 as there could be some padding associated with pre-packed
-  // buffer memory and we don not want it uninitialized and generate different hashes
-  // if and when we try to cache this pre-packed buffer for sharing between sessions.
-  memset(packed_b_data, 0, packed_b_size);
-
+  void* packed_b_data = AllocatePackedB(alloc, packed_b_size, GemmPackedBFormat::Dense, packed_b);
   MlasGemmPackB(trans_b ? CblasTrans : CblasNoTrans,
                 N,
                 K,
@@ -138,6 +161,65 @@ bool GemmPackBFp32(AllocatorPtr& alloc,
   return true;
 }
 
+size_t GemmPackBFp32SparseSize(const Tensor& tensor_b, bool trans_b, float maximum_density) {
+  const auto& b_shape = tensor_b.Shape();
+  if (b_shape.NumDimensions() != 2) {
+    return 0;
+  }
+
+  const size_t K = trans_b ? static_cast<size_t>(b_shape[1]) : static_cast<size_t>(b_shape[0]);
+  const size_t N = trans_b ? static_cast<size_t>(b_shape[0]) : static_cast<size_t>(b_shape[1]);
+
+  const size_t packed_b_data_size = MlasSparseGemmPackBSize(trans_b ? CblasTrans : CblasNoTrans,
+                                                            N,
+                                                            K,
+                                                            tensor_b.Data<float>(),
+                                                            trans_b ? K : N,
+                                                            maximum_density);
+  return packed_b_data_size == 0 ? 0 : kGemmPackedBHeaderSize + packed_b_data_size;
+}
+
+bool GemmPackBFp32Sparse(AllocatorPtr& alloc,
+                         const Tensor& tensor_b,
+                         bool trans_b,
+                         IAllocatorUniquePtr<void>& packed_b,
+                         size_t& packed_b_size,
+                         TensorShape& b_shape) {
+  packed_b_size = GemmPackBFp32SparseSize(tensor_b, trans_b, MlasSparseGemmDensityThreshold());
+  if (packed_b_size == 0) {
+    return false;
+  }
+  b_shape = tensor_b.Shape();
+
+  const size_t K = trans_b ? static_cast<size_t>(b_shape[1]) : static_cast<size_t>(b_shape[0]);
+  const size_t N = trans_b ? static_cast<size_t>(b_shape[0]) : static_cast<size_t>(b_shape[1]);
+
+  void* packed_b_data = AllocatePackedB(alloc, packed_b_size, GemmPackedBFormat::Sparse, packed_b);
+  MlasSparseGemmPackB(trans_b ? CblasTrans : CblasNoTrans,
+                      N,
+                      K,
+                      tensor_b.Data<float>(),
+                      trans_b ? K : N,
+                      packed_b_data);
+  return true;
+}
+
+size_t GemmPackedBFp32Size(const Tensor& tensor_b, bool trans_b, const void* packed_b, size_t packed_b_size) {
+  if (packed_b_size < kGemmPackedBHeaderSize) {
+    return 0;
+  }
+
+  switch (GemmPackedBFormatOf(packed_b)) {
+    case GemmPackedBFormat::Dense:
+      return GemmPackBFp32Size(tensor_b.Shape(), trans_b);
+    case GemmPackedBFormat::Sparse:
+      // The buffer may have been packed on a processor with a higher density threshold.
+      return GemmPackBFp32SparseSize(tensor_b, trans_b, 1.0f);
+    default:
+      return 0;
+  }
+}
+
 template <typename T>
 void Gemm<T>::ComputeGemm(CBLAS_TRANSPOSE trans_a, CBLAS_TRANSPOSE trans_b,
                           ptrdiff_t M, ptrdiff_t N, ptrdiff_t K,
@@ -253,7 +335,8 @@ Status Gemm<float>::PrePack(const Tensor& tensor, int input_idx,
   // only pack Matrix B
   if (input_idx == 1) {
     size_t packed_b_size;
-    is_packed = GemmPackBFp32(alloc, tensor, trans_B_ != CblasNoTrans, packed_b_, packed_b_size, b_shape_);
+    is_packed = GemmPackBFp32Sparse(alloc, tensor, trans_B_ != CblasNoTrans, packed_b_, packed_b_size, b_shape_) ||
+                GemmPackBFp32(alloc, tensor, trans_B_ != CblasNoTrans, packed_b_, packed_b_size, b_shape_);
     bool share_prepacked_weights = (prepacked_weights != nullptr);
     if (is_packed && share_prepacked_weights) {
       prepacked_weights->buffers_.push_back(std::move(packed_b_));
@@ -284,6 +367,34 @@ Status Gemm<float>::UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prep
   return Status::OK();
 }
 
+template <typename T>
+Status Gemm<T>::UseSerializedPrePackedBuffers(const Tensor& /*tensor*/, int /*input_idx*/,
+                                              std::vector<BufferUniquePtr>& /*prepacked_buffers*/,
+                                              gsl::span<const size_t> /*prepacked_buffer_sizes*/,
+                                              /*out*/ bool& used_prepacked_buffers) {
+  used_prepacked_buffers = false;
+  return Status::OK();
+}
+
+template <>
+Status Gemm<float>::UseSerializedPrePackedBuffers(const Tensor& tensor, int input_idx,
+                                                  std::vector<BufferUniquePtr>& prepacked_buffers,
+                                                  gsl::span<const size_t> prepacked_buffer_sizes,
+                                                  /*out*/ bool& used_prepacked_buffers) {
+  used_prepacked_buffers = false;
+
+  if (input_idx == 1 && prepacked_buffers.size() == 1) {
+    const size_t packed_b_size = GemmPackedBFp32Size(tensor, trans_B_ != CblasNoTrans,
+                                                     prepacked_buffers[0].get(), prepacked_buffer_sizes[0]);
+    if (packed_b_size != 0 && packed_b_size == prepacked_buffer_sizes[0]) {
+      used_prepacked_buffers = true;
+      b_shape_ = tensor.Shape();
+      packed_b_ = std::move(prepacked_buffers[0]);
+    }
+  }
+  return Status::OK();
+}
+
 template <typename T>
 void Gemm<T>::ComputeActivation(_Inout_updates_(y_size) T* y_data, ptrdiff_t y_size, _Inout_opt_ concurrency::ThreadPool* thread_pool) const {
   if (activation_) {
@@ -408,12 +519,9 @@ Status Gemm<float>::Compute(OpKernelContext* context) const {
   const float* c_data = C != nullptr ? C->Data<float>() : nullptr;
   const TensorShape* c_shape = C != nullptr ? &C->Shape() : nullptr;
 
-  if (B) {
-    ComputeGemm(trans_A_, trans_B_, M, N, K, alpha_, A->Data<float>(), B->Data<float>(), beta_,
-                c_data, c_shape, y_data, thread_pool);
-  } else {
+  if (packed_b_ && GemmPackedBFormatOf(packed_b_.get()) == GemmPackedBFormat::Sparse) {
     GemmBroadcastBias(M, N, beta_, c_data, c_shape, y_data);
-    MlasGemm(
+    MlasSparseGemm(
         trans_A_,
         static_cast<size_t>(M),
         static_cast<size_t>(N),
@@ -421,11 +529,55 @@ Status Gemm<float>::Compute(OpKernelContext* context) const {
         alpha_,
         A->Data<float>(),
         static_cast<size_t>(trans_A_ != CblasNoTrans ? M : K),
-        packed_b_.get(),
+        GemmPackedBData(packed_b_.get()),
         c_data != nullptr ? beta_ : 0.0f,
         y_data,
         static_cast<size_t>(N),
         thread_pool);
+    if (mlas_activation_) {
+      MlasActivation(&*mlas_activation_, y_data, nullptr, static_cast<size_t>(M), static_cast<size_t>(N),
+                     static_cast<size_t>(N));
+    }
+  } else {
+    // A bias that is a row vector, or a residual of the shape of the output, is added in the epilogue of the GEMM
+    // instead of being broadcast to the output first.
+    MLAS_GEMM_EPILOGUE epilogue;
+    float beta = c_data != nullptr ? beta_ : 0.0f;
+    if (c_data != nullptr && beta_ == 1.0f && c_shape->Size() == N &&
+        (c_shape->NumDimensions() == 1 || (c_shape->NumDimensions() == 2 && (*c_shape)[0] == 1))) {
+      epilogue.Bias = c_data;
+      beta = 0.0f;
+    } else if (c_data != nullptr && beta_ == 1.0f && c_shape->NumDimensions() == 2 &&
+               (*c_shape)[0] == M && (*c_shape)[1] == N) {
+      epilogue.Residual = c_data;
+      epilogue.ldr = static_cast<size_t>(N);
+      beta = 0.0f;
+    } else {
+      GemmBroadcastBias(M, N, beta_, c_data, c_shape, y_data);
+    }
+    if (mlas_activation_) {
+      epilogue.Activation = *mlas_activation_;
+    }
+
+    MLAS_SGEMM_DATA_PARAMS data;
+    data.A = A->Data<float>();
+    data.lda = static_cast<size_t>(trans_A_ != CblasNoTrans ? M : K);
+    if (B) {
+      data.B = B->Data<float>();
+      data.ldb = static_cast<size_t>(trans_B_ != CblasNoTrans ? K : N);
+    } else {
+      data.B = static_cast<const float*>(GemmPackedBData(packed_b_.get()));
+      data.BIsPacked = true;
+    }
+    data.C = y_data;
+    data.ldc = static_cast<size_t>(N);
+    data.alpha = alpha_;
+    data.beta = beta;
+    const bool has_epilogue = epilogue.Bias != nullptr || epilogue.Residual != nullptr || mlas_activation_;
+    data.Epilogue = has_epilogue ? &epilogue : nullptr;
+
+    MlasGemm(trans_A_, trans_B_, static_cast<size_t>(M), static_cast<size_t>(N), static_cast<size_t>(K),
+             data, thread_pool);
   }
 
   ComputeActivation(y_data, SafeInt<size_t>(M) * N, thread_pool);
@@ -3,11 +3,14 @@
 
 #pragma once
 
+#include <optional>
+
 #include "gemm_base.h"
 
 #include "core/framework/op_kernel.h"
 #include "core/common/common.h"
 #include "core/util/math.h"
+#include "core/mlas/inc/mlas.h"
 #include "core/providers/cpu/activation/activations.h"
 
 namespace onnxruntime {
@@ -28,6 +31,11 @@ class Gemm : protected GemmBase, public OpKernel {
                                    int input_idx,
                                    /*out*/ bool& used_shared_buffers) override;
 
+  Status UseSerializedPrePackedBuffers(const Tensor& tensor, int input_idx,
+                                       std::vector<BufferUniquePtr>& prepacked_buffers,
+                                       gsl::span<const size_t> prepacked_buffer_sizes,
+                                       /*out*/ bool& used_prepacked_buffers) override;
+
   static void ComputeGemm(CBLAS_TRANSPOSE trans_a, CBLAS_TRANSPOSE trans_b,
                           ptrdiff_t M, ptrdiff_t N, ptrdiff_t K,
                           T alpha,
@@ -43,6 +51,9 @@ class Gemm : protected GemmBase, public OpKernel {
 
   // For fused gemm + activation
   std::unique_ptr<functors::ElementWiseRangedTransform<T>> activation_;
+  // For fused gemm + activation that MLAS applies in the epilogue of the float GEMM, while the output is still
+  // in cache, instead of in a separate pass.
+  std::optional<MLAS_ACTIVATION> mlas_activation_;
 
   void ComputeActivation(_Inout_updates_(y_size) T* y_data, ptrdiff_t y_size, _Inout_opt_ concurrency::ThreadPool* thread_pool) const;
 };
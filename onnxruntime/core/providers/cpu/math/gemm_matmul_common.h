@@ -7,6 +7,22 @@
 
 namespace onnxruntime {
 
+// Format of a B matrix packed by GemmPackBFp32() or GemmPackBFp32Sparse().
+enum class GemmPackedBFormat : uint32_t {
+  Dense = 0,   // packed by MlasGemmPackB
+  Sparse = 1,  // packed by MlasSparseGemmPackB
+};
+
+// A packed B starts with a header holding its GemmPackedBFormat, so that a shared or serialized buffer is used in
+// the format it was packed in. The header size keeps the packed data aligned for MLAS.
+constexpr size_t kGemmPackedBHeaderSize = 64;
+
+GemmPackedBFormat GemmPackedBFormatOf(const void* packed_b);
+
+inline const void* GemmPackedBData(const void* packed_b) {
+  return static_cast<const uint8_t*>(packed_b) + kGemmPackedBHeaderSize;
+}
+
 bool GemmPackBFp32(AllocatorPtr& alloc,
                    const Tensor& tensor_b,
                    bool trans_b,
@@ -14,4 +30,24 @@ bool GemmPackBFp32(AllocatorPtr& alloc,
                    size_t& packed_b_size,
                    TensorShape& b_shape);
 
+// Returns the size of the buffer GemmPackBFp32() packs the given B matrix into, or 0 if it doesn't pack it.
+size_t GemmPackBFp32Size(const TensorShape& b_shape, bool trans_b);
+
+// Packs the non-zero elements of B for MlasSparseGemm if B is sparse enough for it to be faster than
+// the dense GEMM on this processor. Returns false if B is not packed.
+bool GemmPackBFp32Sparse(AllocatorPtr& alloc,
+                         const Tensor& tensor_b,
+                         bool trans_b,
+                         IAllocatorUniquePtr<void>& packed_b,
+                         size_t& packed_b_size,
+                         TensorShape& b_shape);
+
+// Returns the size of the buffer B is packed into for MlasSparseGemm, or 0 if B holds more than
+// maximum_density * N * K non-zero elements.
+size_t GemmPackBFp32SparseSize(const Tensor& tensor_b, bool trans_b, float maximum_density);
+
+// Returns the size that a buffer holding B packed in the format of the header of packed_b shall have, or 0 if the
+// buffer can't hold a packed B.
+size_t GemmPackedBFp32Size(const Tensor& tensor_b, bool trans_b, const void* packed_b, size_t packed_b_size);
+
 };  // namespace onnxruntime
@@ -89,6 +89,13 @@ ONNX_CPU_OPERATOR_TYPED_KERNEL(
         .TypeConstraint("T", BuildKernelDefConstraints<int64_t, uint64_t>()),
     MatMul<int64_t>);
 
+ONNX_CPU_OPERATOR_TYPED_KERNEL(
+    MatMul,
+    13,
+    BFloat16,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<BFloat16>()),
+    MatMul<BFloat16>);
+
 template <typename T>
 Status MatMul<T>::Compute(OpKernelContext* ctx) const {
   concurrency::ThreadPool* thread_pool = ctx->GetOperatorThreadPool();
@@ -134,7 +141,8 @@ Status MatMul<float>::PrePack(const Tensor& tensor, int input_idx, /*out*/ Alloc
   // only pack Matrix B
   if (input_idx == 1) {
     size_t packed_b_size;
-    is_packed = GemmPackBFp32(alloc, tensor, trans_b_attr_ != 0, packed_b_, packed_b_size, b_shape_);
+    is_packed = GemmPackBFp32Sparse(alloc, tensor, trans_b_attr_ != 0, packed_b_, packed_b_size, b_shape_) ||
+                GemmPackBFp32(alloc, tensor, trans_b_attr_ != 0, packed_b_, packed_b_size, b_shape_);
     bool share_prepacked_weights = (prepacked_weights != nullptr);
     if (is_packed && share_prepacked_weights) {
       prepacked_weights->buffers_.push_back(std::move(packed_b_));
@@ -157,6 +165,25 @@ Status MatMul<float>::UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& pr
   return Status::OK();
 }
 
+Status MatMul<float>::UseSerializedPrePackedBuffers(const Tensor& tensor, int input_idx,
+                                                    std::vector<BufferUniquePtr>& prepacked_buffers,
+                                                    gsl::span<const size_t> prepacked_buffer_sizes,
+                                                    /*out*/ bool& used_prepacked_buffers) {
+  used_prepacked_buffers = false;
+
+  if (input_idx == 1 && prepacked_buffers.size() == 1) {
+    const size_t packed_b_size = GemmPackedBFp32Size(tensor, trans_b_attr_ != 0,
+                                                     prepacked_buffers[0].get(), prepacked_buffer_sizes[0]);
+    if (packed_b_size != 0 && packed_b_size == prepacked_buffer_sizes[0]) {
+      used_prepacked_buffers = true;
+      b_shape_ = tensor.Shape();
+      packed_b_ = std::move(prepacked_buffers[0]);
+    }
+  }
+
+  return Status::OK();
+}
+
 Status MatMul<float>::Compute(OpKernelContext* ctx) const {
   concurrency::ThreadPool* thread_pool = ctx->GetOperatorThreadPool();
 
@@ -187,12 +214,22 @@ Status MatMul<float>::Compute(OpKernelContext* ctx) const {
   const size_t lda = helper.Lda(trans_a);
   const size_t ldb = helper.Ldb(trans_b);
 
+  if (packed_b_ && GemmPackedBFormatOf(packed_b_.get()) == GemmPackedBFormat::Sparse) {
+    for (size_t i = 0; i < max_len; i++) {
+      MlasSparseGemm(trans_a ? CblasTrans : CblasNoTrans, M, N, K, alpha_attr_,
+                     a_data + helper.LeftOffsets()[i], lda, GemmPackedBData(packed_b_.get()),
+                     0.0f, y_data + helper.OutputOffsets()[i], N, thread_pool);
+    }
+    return Status::OK();
+  }
+
   std::vector<MLAS_SGEMM_DATA_PARAMS> data(max_len);
   for (size_t i = 0; i < max_len; i++) {
     data[i].BIsPacked = bool(packed_b_);
     data[i].A = a_data + helper.LeftOffsets()[i];
     data[i].lda = lda;
-    data[i].B = data[i].BIsPacked ? (float*)packed_b_.get() : b_data + helper.RightOffsets()[i];
+    data[i].B = data[i].BIsPacked ? static_cast<const float*>(GemmPackedBData(packed_b_.get()))
+                                  : b_data + helper.RightOffsets()[i];
     data[i].ldb = ldb;
     data[i].C = y_data + helper.OutputOffsets()[i];
     data[i].ldc = N;
@@ -205,4 +242,92 @@ Status MatMul<float>::Compute(OpKernelContext* ctx) const {
   return Status::OK();
 }
 
+Status MatMul<BFloat16>::PrePack(const Tensor& tensor, int input_idx, /*out*/ AllocatorPtr alloc,
+                                 /*out*/ bool& is_packed,
+                                 /*out*/ PrePackedWeights* prepacked_weights) {
+  is_packed = false;
+
+  // only pack Matrix B
+  if (input_idx != 1 || tensor.Shape().NumDimensions() != 2) {
+    return Status::OK();
+  }
+
+  b_shape_ = tensor.Shape();
+  const size_t K = static_cast<size_t>(b_shape_[0]);
+  const size_t N = static_cast<size_t>(b_shape_[1]);
+  const size_t packed_b_size = MlasBf16GemmPackBSize(N, K);
+  if (packed_b_size == 0) {
+    return Status::OK();
+  }
+
+  packed_b_ = IAllocator::MakeUniquePtr<void>(alloc, packed_b_size, true);
+  // Zero the alignment padding so that equal weights produce equal buffers when shared between sessions.
+  memset(packed_b_.get(), 0, packed_b_size);
+  MlasBf16GemmPackB(CblasNoTrans, N, K, tensor.Data<BFloat16>(), N, packed_b_.get());
+  is_packed = true;
+
+  if (prepacked_weights != nullptr) {
+    prepacked_weights->buffers_.push_back(std::move(packed_b_));
+    prepacked_weights->buffer_sizes_.push_back(packed_b_size);
+  }
+  return Status::OK();
+}
+
+Status MatMul<BFloat16>::UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers,
+                                                   int input_idx,
+                                                   /*out*/ bool& used_shared_buffers) {
+  used_shared_buffers = false;
+
+  if (input_idx == 1) {
+    used_shared_buffers = true;
+    packed_b_ = std::move(prepacked_buffers[0]);
+  }
+
+  return Status::OK();
+}
+
+Status MatMul<BFloat16>::Compute(OpKernelContext* ctx) const {
+  concurrency::ThreadPool* thread_pool = ctx->GetOperatorThreadPool();
+
+  const Tensor* a = ctx->Input<Tensor>(0);
+  const Tensor* b = packed_b_ ? nullptr : ctx->Input<Tensor>(1);
+  const auto& b_shape = b ? b->Shape() : b_shape_;
+
+  MatMulComputeHelper helper;
+  ORT_RETURN_IF_ERROR(helper.Compute(a->Shape(), b_shape));
+  Tensor* y = ctx->Output(0, helper.OutputShape());
+
+  // Bail out early if the output is going to be empty
+  if (y->Shape().Size() == 0)
+    return Status::OK();
+
+  const auto* a_data = a->Data<BFloat16>();
+  const auto* b_data = b ? b->Data<BFloat16>() : nullptr;
+  auto* y_data = y->MutableData<BFloat16>();
+
+  const size_t max_len = helper.OutputOffsets().size();
+  const size_t M = static_cast<size_t>(helper.M());
+  const size_t N = static_cast<size_t>(helper.N());
+  const size_t K = static_cast<size_t>(helper.K());
+
+  std::vector<MLAS_BF16_GEMM_DATA_PARAMS> data(max_len);
+  for (size_t i = 0; i < max_len; i++) {
+    data[i].A = a_data + helper.LeftOffsets()[i];
+    data[i].lda = K;
+    if (packed_b_) {
+      data[i].B = packed_b_.get();
+      data[i].ldb = 0;
+    } else {
+      data[i].B = b_data + helper.RightOffsets()[i];
+      data[i].ldb = N;
+    }
+    data[i].C = y_data + helper.OutputOffsets()[i];
+    data[i].ldc = N;
+    data[i].CIsBf16 = true;
+  }
+  MlasBf16GemmBatch(M, N, K, max_len, data.data(), thread_pool);
+
+  return Status::OK();
+}
+
 }  // namespace onnxruntime
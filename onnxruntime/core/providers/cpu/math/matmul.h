@@ -36,6 +36,11 @@ class MatMul<float> final : public OpKernel {
   Status UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers, int input_idx,
                                    /*out*/ bool& used_shared_buffers) override;
 
+  Status UseSerializedPrePackedBuffers(const Tensor& tensor, int input_idx,
+                                       std::vector<BufferUniquePtr>& prepacked_buffers,
+                                       gsl::span<const size_t> prepacked_buffer_sizes,
+                                       /*out*/ bool& used_prepacked_buffers) override;
+
   Status Compute(OpKernelContext* context) const override;
 
  private:
@@ -50,4 +55,25 @@ class MatMul<float> final : public OpKernel {
   bool trans_batch_b_;
 };
 
+// Multiplies in bfloat16 with single precision accumulation. A constant B is packed once in the layout of the
+// MLAS bfloat16 GEMM kernels.
+template <>
+class MatMul<BFloat16> final : public OpKernel {
+ public:
+  MatMul(const OpKernelInfo& info) : OpKernel(info) {}
+
+  Status PrePack(const Tensor& tensor, int input_idx, AllocatorPtr alloc,
+                 /*out*/ bool& is_packed,
+                 /*out*/ PrePackedWeights* prepacked_weights) override;
+
+  Status UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers, int input_idx,
+                                   /*out*/ bool& used_shared_buffers) override;
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  TensorShape b_shape_;
+  IAllocatorUniquePtr<void> packed_b_;
+};
+
 }  // namespace onnxruntime
@@ -2,7 +2,6 @@
 // Licensed under the MIT License.
 
 #include "core/providers/cpu/ml/category_mapper.h"
-#include <algorithm>
 #include "core/common/gsl.h"
 using namespace ::onnxruntime::common;
 
@@ -33,33 +32,36 @@ Status CategoryMapper::Compute(OpKernelContext* context) const {
 
     auto input = gsl::make_span(X.Data<std::string>(), onnxruntime::narrow<size_t>(shape.Size()));
     auto output = gsl::make_span(Y.MutableData<int64_t>(), onnxruntime::narrow<size_t>(shape.Size()));
-    auto out = output.begin();
 
-    // map isn't going to change so get end() once instead of calling inside the for_each loop
-    const auto map_end = string_to_int_map_.end();
-
-    std::for_each(input.begin(), input.end(),
-                  [&out, &map_end, this](const std::string& value) {
-                    auto map_to = string_to_int_map_.find(value);
-                    *out = map_to == map_end ? default_int_ : map_to->second;
-                    ++out;
-                  });
+    concurrency::ThreadPool::TryParallelFor(
+        context->GetOperatorThreadPool(), static_cast<std::ptrdiff_t>(input.size()),
+        TensorOpCost{static_cast<double>(sizeof(std::string)), static_cast<double>(sizeof(int64_t)), 64.0},
+        [this, &input, &output](std::ptrdiff_t first, std::ptrdiff_t last) {
+          for (size_t i = static_cast<size_t>(first), end = static_cast<size_t>(last); i < end; ++i) {
+            const uint32_t id = strings_.Find(input[i]);
+            output[i] = id == StringTable::kNotFound ? default_int_ : string_to_int_[id];
+          }
+        });
   } else {
     if (!Y.IsDataTypeString())
       return Status(ONNXRUNTIME, FAIL, "Input of int64 must have output of string ");
 
     auto input = gsl::make_span(X.Data<int64_t>(), onnxruntime::narrow<size_t>(shape.Size()));
     auto output = gsl::make_span(Y.MutableData<std::string>(), onnxruntime::narrow<size_t>(shape.Size()));
-    auto out = output.begin();
-
-    const auto map_end = int_to_string_map_.end();
 
-    std::for_each(input.begin(), input.end(),
-                  [&out, &map_end, this](const int64_t& value) {
-                    auto map_to = int_to_string_map_.find(value);
-                    *out = map_to == map_end ? default_string_ : map_to->second;
-                    ++out;
-                  });
+    concurrency::ThreadPool::TryParallelFor(
+        context->GetOperatorThreadPool(), static_cast<std::ptrdiff_t>(input.size()),
+        TensorOpCost{static_cast<double>(sizeof(int64_t)), static_cast<double>(sizeof(std::string)), 128.0},
+        [this, &input, &output](std::ptrdiff_t first, std::ptrdiff_t last) {
+          for (size_t i = static_cast<size_t>(first), end = static_cast<size_t>(last); i < end; ++i) {
+            const uint32_t id = int_to_string_id_.Find(static_cast<uint64_t>(input[i]));
+            if (id == StringTable::kNotFound) {
+              output[i] = default_string_;
+            } else {
+              output[i] = strings_.Get(id);
+            }
+          }
+        });
   }
 
   return Status::OK();
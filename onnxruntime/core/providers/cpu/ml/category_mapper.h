@@ -6,6 +6,7 @@
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
 #include "core/providers/cpu/ml/ml_common.h"
+#include "core/providers/cpu/string_table.h"
 
 namespace onnxruntime {
 namespace ml {
@@ -26,23 +27,36 @@ class CategoryMapper final : public OpKernel {
 
     ORT_ENFORCE(num_entries == int_categories.size());
 
-    string_to_int_map_.reserve(num_entries);
-    int_to_string_map_.reserve(num_entries);
+    strings_ = StringTable(string_categories);
+    string_to_int_.resize(strings_.IdBound(), default_int_);
 
+    // Later entries replace earlier ones with the same key.
+    InlinedHashMap<int64_t, uint32_t> int_to_string_id;
+    int_to_string_id.reserve(num_entries);
     for (size_t i = 0; i < num_entries; ++i) {
-      const std::string& str = string_categories[i];
+      const uint32_t id = strings_.Find(string_categories[i]);
       int64_t index = int_categories[i];
 
-      string_to_int_map_[str] = index;
-      int_to_string_map_[index] = str;
+      string_to_int_[id] = index;
+      int_to_string_id[index] = id;
     }
+
+    std::vector<std::pair<uint64_t, uint32_t>> entries;
+    entries.reserve(int_to_string_id.size());
+    for (const auto& entry : int_to_string_id) {
+      entries.emplace_back(static_cast<uint64_t>(entry.first), entry.second);
+    }
+    int_to_string_id_ = PerfectHashMap<uint32_t>(entries, StringTable::kNotFound);
   }
 
   Status Compute(OpKernelContext* context) const override;
 
  private:
-  std::unordered_map<std::string, int64_t> string_to_int_map_;
-  std::unordered_map<int64_t, std::string> int_to_string_map_;
+  // Categories are stored once in strings_. string_to_int_ is indexed by the id of a string and
+  // int_to_string_id_ maps an integer category to the id of its string.
+  StringTable strings_;
+  std::vector<int64_t> string_to_int_;
+  PerfectHashMap<uint32_t> int_to_string_id_;
 
   std::string default_string_;
   int64_t default_int_;
@@ -6,6 +6,7 @@
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
 #include "core/providers/cpu/ml/ml_common.h"
+#include "core/providers/cpu/string_table.h"
 
 namespace onnxruntime {
 namespace ml {
@@ -22,27 +23,79 @@ class LabelEncoder final : public OpKernel {
 
     auto num_entries = string_classes.size();
 
-    string_to_int_map_.reserve(num_entries);
-    int_to_string_map_.reserve(num_entries);
+    classes_ = StringTable(string_classes);
+    string_to_int_.resize(classes_.IdBound(), default_int_);
+    class_ids_.resize(num_entries);
 
+    // Later entries replace earlier ones with the same string.
     for (size_t i = 0; i < num_entries; ++i) {
-      const std::string& str = string_classes[i];
+      const uint32_t id = classes_.Find(string_classes[i]);
 
-      string_to_int_map_[str] = i;
-      int_to_string_map_[i] = str;
+      string_to_int_[id] = static_cast<int64_t>(i);
+      class_ids_[i] = id;
     }
   }
 
   Status Compute(OpKernelContext* context) const override;
 
  private:
-  std::unordered_map<std::string, int64_t> string_to_int_map_;
-  std::unordered_map<int64_t, std::string> int_to_string_map_;
+  // Classes are stored once in classes_. string_to_int_ is indexed by the id of a string and
+  // class_ids_[i] is the id of the i-th class.
+  StringTable classes_;
+  std::vector<int64_t> string_to_int_;
+  std::vector<uint32_t> class_ids_;
 
   std::string default_string_;
   int64_t default_int_;
 };
 
+// The key-value pairs of LabelEncoder_2. The first pair with a given key is used.
+template <typename TKey, typename TValue>
+class LabelEncoderMap {
+ public:
+  void Initialize(const std::vector<TKey>& keys, const std::vector<TValue>& values) {
+    map_.reserve(keys.size());
+    for (size_t i = 0; i < keys.size(); ++i)
+      map_.emplace(keys[i], values[i]);
+  }
+
+  // Returns nullptr if `key` isn't mapped.
+  const TValue* Find(const TKey& key) const {
+    const auto found = map_.find(key);
+    return found == map_.end() ? nullptr : &found->second;
+  }
+
+ private:
+  InlinedHashMap<TKey, TValue> map_;
+};
+
+// String keys are stored in a StringTable and the values are indexed by the id of their key.
+template <typename TValue>
+class LabelEncoderMap<std::string, TValue> {
+ public:
+  void Initialize(const std::vector<std::string>& keys, const std::vector<TValue>& values) {
+    keys_ = StringTable(keys);
+    values_.resize(keys_.IdBound());
+    std::vector<uint8_t> assigned(keys_.IdBound(), 0);
+    for (size_t i = 0; i < keys.size(); ++i) {
+      const uint32_t id = keys_.Find(keys[i]);
+      if (!assigned[id]) {
+        assigned[id] = 1;
+        values_[id] = values[i];
+      }
+    }
+  }
+
+  const TValue* Find(const std::string& key) const {
+    const uint32_t id = keys_.Find(key);
+    return id == StringTable::kNotFound ? nullptr : &values_[id];
+  }
+
+ private:
+  StringTable keys_;
+  std::vector<TValue> values_;
+};
+
 template <typename TKey, typename TValue>
 class LabelEncoder_2 final : public OpKernel {
  public:
@@ -63,9 +116,7 @@ class LabelEncoder_2 final : public OpKernel {
                 "(name: ", info.node().Name(), ") must have the same length. ",
                 "However, the number of key is ", num_keys, " and the number of ",
                 "values is ", num_values, ".");
-    _map.reserve(num_keys);
-    for (size_t i = 0; i < num_keys; ++i)
-      _map.emplace(keys[i], values[i]);
+    _map.Initialize(keys, values);
   }
 
   Status Compute(OpKernelContext* context) const override {
@@ -78,13 +129,18 @@ class LabelEncoder_2 final : public OpKernel {
     auto input = X.template DataAsSpan<TKey>();
     auto output = Y.template MutableDataAsSpan<TValue>();
 
-    for (int64_t i = 0; i < shape.Size(); ++i) {
-      const auto found = _map.find(input[onnxruntime::narrow<size_t>(i)]);
-      if (found == _map.end())
-        output[onnxruntime::narrow<size_t>(i)] = _default_value;
-      else
-        output[onnxruntime::narrow<size_t>(i)] = found->second;
-    }
+    concurrency::ThreadPool::TryParallelFor(
+        context->GetOperatorThreadPool(), static_cast<std::ptrdiff_t>(input.size()),
+        TensorOpCost{static_cast<double>(sizeof(TKey)), static_cast<double>(sizeof(TValue)), 64.0},
+        [this, &input, &output](std::ptrdiff_t first, std::ptrdiff_t last) {
+          for (size_t i = static_cast<size_t>(first), end = static_cast<size_t>(last); i < end; ++i) {
+            const TValue* found = _map.Find(input[i]);
+            if (found == nullptr)
+              output[i] = _default_value;
+            else
+              output[i] = *found;
+          }
+        });
 
     return Status::OK();
   }
@@ -98,7 +154,7 @@ class LabelEncoder_2 final : public OpKernel {
   // A collection of key-value pairs. Each (a_key, a_value) pair
   // means that the "a_key" in the input would be mapped to "a_value".
   // If _map doesn't contain "a_key", we use _default_value as its output.
-  InlinedHashMap<TKey, TValue> _map;
+  LabelEncoderMap<TKey, TValue> _map;
   TValue _default_value;
   // ONNX attribute name to load keys.
   std::string _key_field_name;
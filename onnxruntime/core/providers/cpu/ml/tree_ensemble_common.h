@@ -3,6 +3,9 @@
 
 #pragma once
 
+#include <algorithm>
+#include <functional>
+
 #include "tree_ensemble_aggregator.h"
 #include "core/platform/ort_mutex.h"
 #include "core/platform/threadpool.h"
@@ -29,9 +32,7 @@ class TreeEnsembleCommonAttributes {
   int64_t n_trees_;
   bool same_mode_;
   bool has_missing_tracks_;
-  int parallel_tree_;    // starts parallelizing the computing by trees if n_tree >= parallel_tree_
-  int parallel_tree_N_;  // batch size if parallelizing by trees
-  int parallel_N_;       // starts parallelizing the computing by rows if n_rows <= parallel_N_
+  int parallel_tree_N_;  // number of rows evaluated on every tree before moving to the next one
 };
 
 // TI: input type
@@ -48,15 +49,35 @@ class TreeEnsembleCommon : public TreeEnsembleCommonAttributes {
   std::vector<SparseValue<ThresholdType>> weights_;
   std::vector<TreeNodeElement<ThresholdType>*> roots_;
 
+  // Structure-of-arrays copy of nodes_ built by CompileTrees and used for inference, entry k describes nodes_[k].
+  // flat_children_[2 * k] is the false child and flat_children_[2 * k + 1] the true child so the comparison result
+  // indexes the next node. Both children of a leaf are the leaf itself: a block of rows walks a tree in lockstep
+  // until no row moves.
+  std::vector<int32_t> flat_feature_ids_;
+  std::vector<ThresholdType> flat_thresholds_;
+  std::vector<uint32_t> flat_children_;
+  std::vector<uint8_t> flat_missing_tracks_true_;
+  std::vector<uint32_t> flat_roots_;
+  NODE_MODE branch_mode_;
+
+  // cumulated_tree_costs_[j] is the average number of nodes a row visits in trees 0 to j - 1, the last value is
+  // the cost of one row. It decides whether trees or rows are evaluated in parallel and balances the trees
+  // between threads.
+  std::vector<double> cumulated_tree_costs_;
+
+  // Number of rows walking a tree together.
+  static constexpr int64_t kRowBlock = 16;
+
+  // Minimum number of visited nodes worth sending to another thread.
+  static constexpr double kMinCostPerThread = 16384;
+
  public:
   TreeEnsembleCommon() {}
 
   virtual Status Init(const OpKernelInfo& info);
   virtual Status compute(OpKernelContext* ctx, const Tensor* X, Tensor* Y, Tensor* label) const;
 
-  Status Init(int parallel_tree,
-              int parallel_tree_N,
-              int parallel_N,
+  Status Init(int parallel_tree_N,
               const std::string& aggregate_function,
               const std::vector<float>& base_values,
               const std::vector<ThresholdType>& base_values_as_tensor,
@@ -87,6 +108,64 @@ class TreeEnsembleCommon : public TreeEnsembleCommonAttributes {
   void ComputeAgg(concurrency::ThreadPool* ttp, const Tensor* X, Tensor* Y, Tensor* label, const AGG& agg) const;
 
  private:
+  void CompileTrees();
+
+  template <typename ScoresType, typename AGG>
+  void ComputeAggImpl(concurrency::ThreadPool* ttp, const InputType* x_data, int64_t N, int64_t stride,
+                      OutputType* z_data, int64_t* label_data, const AGG& agg) const;
+
+  template <typename ScoresType, typename AGG>
+  void ComputeRows(const InputType* x_data, int64_t stride, int64_t row_begin, int64_t row_end,
+                   OutputType* z_data, int64_t* label_data, const AGG& agg) const;
+
+  // Calls fn(row, leaf) for every tree in [tree_begin, tree_end) and every row in [row_begin, row_end),
+  // trees in the outer loop.
+  template <typename Fn>
+  void EvaluateTrees(size_t tree_begin, size_t tree_end, const InputType* x_data, int64_t stride,
+                     int64_t row_begin, int64_t row_end, Fn&& fn) const;
+
+  template <typename Compare, bool HasMissingTracks, typename Fn>
+  void EvaluateTreeBlocks(size_t tree_begin, size_t tree_end, const InputType* x_data, int64_t stride,
+                          int64_t row_begin, int64_t row_end, Fn& fn) const;
+
+  void ResetScores(ScoreValue<ThresholdType>& scores) const { scores = {0, 0}; }
+  void ResetScores(InlinedVector<ScoreValue<ThresholdType>>& scores) const {
+    scores.assign(onnxruntime::narrow<size_t>(n_targets_or_classes_), {0, 0});
+  }
+
+  template <typename AGG>
+  void ProcessLeaf(const AGG& agg, ScoreValue<ThresholdType>& scores,
+                   const TreeNodeElement<ThresholdType>& leaf) const {
+    agg.ProcessTreeNodePrediction1(scores, leaf);
+  }
+  template <typename AGG>
+  void ProcessLeaf(const AGG& agg, InlinedVector<ScoreValue<ThresholdType>>& scores,
+                   const TreeNodeElement<ThresholdType>& leaf) const {
+    agg.ProcessTreeNodePrediction(scores, leaf, weights_);
+  }
+
+  template <typename AGG>
+  void MergeScores(const AGG& agg, ScoreValue<ThresholdType>& scores, ScoreValue<ThresholdType>& scores2) const {
+    agg.MergePrediction1(scores, scores2);
+  }
+  template <typename AGG>
+  void MergeScores(const AGG& agg, InlinedVector<ScoreValue<ThresholdType>>& scores,
+                   InlinedVector<ScoreValue<ThresholdType>>& scores2) const {
+    agg.MergePrediction(scores, scores2);
+  }
+
+  template <typename AGG>
+  void FinalizeScores(const AGG& agg, ScoreValue<ThresholdType>& scores, OutputType* z_data, int64_t* label_data,
+                      int64_t i) const {
+    agg.FinalizeScores1(z_data + i, scores, label_data == nullptr ? nullptr : (label_data + i));
+  }
+  template <typename AGG>
+  void FinalizeScores(const AGG& agg, InlinedVector<ScoreValue<ThresholdType>>& scores, OutputType* z_data,
+                      int64_t* label_data, int64_t i) const {
+    agg.FinalizeScores(scores, z_data + i * n_targets_or_classes_, -1,
+                       label_data == nullptr ? nullptr : (label_data + i));
+  }
+
   size_t AddNodes(const size_t i, const InlinedVector<NODE_MODE>& cmodes, const InlinedVector<size_t>& truenode_ids,
                   const InlinedVector<size_t>& falsenode_ids, const std::vector<int64_t>& nodes_featureids,
                   const std::vector<ThresholdType>& nodes_values_as_tensor, const std::vector<float>& node_values,
@@ -106,9 +185,7 @@ Status TreeEnsembleCommon<InputType, ThresholdType, OutputType>::Init(const OpKe
 #endif
 
   return Init(
-      80,
       128,
-      50,
       info.GetAttrOrDefault<std::string>("aggregate_function", "SUM"),
       info.GetAttrsOrDefault<float>("base_values"),
       base_values_as_tensor,
@@ -134,9 +211,7 @@ Status TreeEnsembleCommon<InputType, ThresholdType, OutputType>::Init(const OpKe
 
 template <typename InputType, typename ThresholdType, typename OutputType>
 Status TreeEnsembleCommon<InputType, ThresholdType, OutputType>::Init(
-    int parallel_tree,
     int parallel_tree_N,
-    int parallel_N,
     const std::string& aggregate_function,
     const std::vector<float>& base_values,
     const std::vector<ThresholdType>& base_values_as_tensor,
@@ -158,9 +233,7 @@ Status TreeEnsembleCommon<InputType, ThresholdType, OutputType>::Init(
     const std::vector<int64_t>& target_class_treeids,
     const std::vector<float>& target_class_weights,
     const std::vector<ThresholdType>& target_class_weights_as_tensor) {
-  parallel_tree_ = parallel_tree;
   parallel_tree_N_ = parallel_tree_N;
-  parallel_N_ = parallel_N;
 
   ORT_ENFORCE(n_targets_or_classes > 0);
   ORT_ENFORCE(nodes_falsenodeids.size() == nodes_featureids.size());
@@ -338,6 +411,7 @@ Status TreeEnsembleCommon<InputType, ThresholdType, OutputType>::Init(
     }
   }
 
+  CompileTrees();
   return Status::OK();
 }
 
@@ -396,6 +470,90 @@ size_t TreeEnsembleCommon<InputType, ThresholdType, OutputType>::AddNodes(
   return node_pos;
 }
 
+template <typename InputType, typename ThresholdType, typename OutputType>
+void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::CompileTrees() {
+  const size_t n_nodes = nodes_.size();
+  flat_feature_ids_.resize(n_nodes);
+  flat_thresholds_.resize(n_nodes);
+  flat_children_.resize(2 * n_nodes);
+  flat_missing_tracks_true_.resize(n_nodes);
+  branch_mode_ = NODE_MODE::BRANCH_LEQ;
+  bool has_branch = false;
+  for (size_t k = 0; k < n_nodes; ++k) {
+    const TreeNodeElement<ThresholdType>& node = nodes_[k];
+    if (node.is_not_leaf()) {
+      flat_feature_ids_[k] = node.feature_id;
+      flat_thresholds_[k] = node.value_or_unique_weight;
+      flat_children_[2 * k] = static_cast<uint32_t>(k + 1);
+      flat_children_[2 * k + 1] = static_cast<uint32_t>(node.truenode_or_weight.ptr - nodes_.data());
+      flat_missing_tracks_true_[k] = node.is_missing_track_true() ? 1 : 0;
+      if (!has_branch) {
+        // Only used when same_mode_ is true.
+        branch_mode_ = node.mode();
+        has_branch = true;
+      }
+    } else {
+      // Feature 0 always exists and the comparison does not matter since both branches lead back to the leaf.
+      flat_feature_ids_[k] = 0;
+      flat_thresholds_[k] = 0;
+      flat_children_[2 * k] = static_cast<uint32_t>(k);
+      flat_children_[2 * k + 1] = static_cast<uint32_t>(k);
+      flat_missing_tracks_true_[k] = 0;
+    }
+  }
+
+  flat_roots_.clear();
+  flat_roots_.reserve(roots_.size());
+  for (auto* root : roots_) {
+    flat_roots_.push_back(static_cast<uint32_t>(root - nodes_.data()));
+  }
+
+  // The cost of a tree is the average depth of its leaves. Subtrees may be shared by several nodes
+  // (see AddNodes) so the number of leaves and the sum of their depths are computed once per node,
+  // with an iterative depth-first search which also rejects cycles.
+  std::vector<double> leaf_counts(n_nodes, 0);
+  std::vector<double> depth_sums(n_nodes, 0);
+  std::vector<uint8_t> states(n_nodes, 0);  // 0: not visited, 1: children being visited, 2: done
+  InlinedVector<uint32_t> stack;
+  for (uint32_t root : flat_roots_) {
+    stack.push_back(root);
+    while (!stack.empty()) {
+      const uint32_t k = stack.back();
+      const uint32_t false_id = flat_children_[2 * static_cast<size_t>(k)];
+      const uint32_t true_id = flat_children_[2 * static_cast<size_t>(k) + 1];
+      if (states[k] == 2) {
+        stack.pop_back();
+      } else if (true_id == k) {
+        leaf_counts[k] = 1;
+        states[k] = 2;
+        stack.pop_back();
+      } else if (states[k] == 0) {
+        states[k] = 1;
+        for (uint32_t child : {false_id, true_id}) {
+          if (states[child] == 1) {
+            ORT_THROW("Node ", k, " and node ", child, " are part of a cycle.");
+          }
+          if (states[child] == 0) {
+            stack.push_back(child);
+          }
+        }
+      } else {
+        leaf_counts[k] = leaf_counts[true_id] + leaf_counts[false_id];
+        depth_sums[k] = depth_sums[true_id] + leaf_counts[true_id] + depth_sums[false_id] + leaf_counts[false_id];
+        states[k] = 2;
+        stack.pop_back();
+      }
+    }
+  }
+
+  cumulated_tree_costs_.resize(flat_roots_.size() + 1);
+  cumulated_tree_costs_[0] = 0;
+  for (size_t j = 0; j < flat_roots_.size(); ++j) {
+    // One more visit for the leaf itself.
+    cumulated_tree_costs_[j + 1] = cumulated_tree_costs_[j] + 1 + depth_sums[flat_roots_[j]] / leaf_counts[flat_roots_[j]];
+  }
+}
+
 template <typename InputType, typename ThresholdType, typename OutputType>
 Status TreeEnsembleCommon<InputType, ThresholdType, OutputType>::compute(OpKernelContext* ctx,
                                                                          const Tensor* X,
@@ -453,221 +611,103 @@ void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ComputeAgg(concur
 
   const InputType* x_data = X->Data<InputType>();
   int64_t* label_data = label == nullptr ? nullptr : label->MutableData<int64_t>();
-  auto max_num_threads = concurrency::ThreadPool::DegreeOfParallelism(ttp);
 
   if (n_targets_or_classes_ == 1) {
-    if (N == 1) {
-      ScoreValue<ThresholdType> score = {0, 0};
-      if (n_trees_ <= parallel_tree_ || max_num_threads == 1) { /* section A: 1 output, 1 row and not enough trees to parallelize */
-        for (int64_t j = 0; j < n_trees_; ++j) {
-          agg.ProcessTreeNodePrediction1(score, *ProcessTreeNodeLeave(roots_[onnxruntime::narrow<size_t>(j)], x_data));
-        }
-      } else { /* section B: 1 output, 1 row and enough trees to parallelize */
-        std::vector<ScoreValue<ThresholdType>> scores(onnxruntime::narrow<size_t>(n_trees_), {0, 0});
-        concurrency::ThreadPool::TryBatchParallelFor(
-            ttp,
-            SafeInt<int32_t>(n_trees_),
-            [this, &scores, &agg, x_data](ptrdiff_t j) {
-              agg.ProcessTreeNodePrediction1(scores[j], *ProcessTreeNodeLeave(roots_[j], x_data));
-            },
-            max_num_threads);
-
-        for (auto it = scores.cbegin(); it != scores.cend(); ++it) {
-          agg.MergePrediction1(score, *it);
-        }
-      }
-      agg.FinalizeScores1(z_data, score, label_data);
-    } else if (N <= parallel_N_ || max_num_threads == 1) { /* section C: 1 output, 2+ rows but not enough rows to parallelize */
-      // Not enough data to parallelize but the computation is split into batches of 128 rows,
-      // and then loop on trees to evaluate every tree on this batch.
-      // This change was introduced by PR: https://github.com/microsoft/onnxruntime/pull/13835.
-      // The input tensor (2D) is stored in a contiguous array. Therefore, it is faster
-      // to loop on tree first and inside that loop evaluate a tree on the input tensor (inner loop).
-      // The processor is faster when it has to move chunks of a contiguous array (branching).
-      // However, if the input tensor is too big, the data does not hold on caches (L1, L2, L3).
-      // In that case, looping first on tree or on data is almost the same. That's why the first loop
-      // split into batch so that every batch holds on caches, then loop on trees and finally loop
-      // on the batch rows.
-      std::vector<ScoreValue<ThresholdType>> scores(parallel_tree_N_);
-      size_t j;
-      int64_t i, batch, batch_end;
-
-      for (batch = 0; batch < N; batch += parallel_tree_N_) {
-        batch_end = std::min(N, batch + parallel_tree_N_);
-        for (i = batch; i < batch_end; ++i) {
-          scores[SafeInt<ptrdiff_t>(i - batch)] = {0, 0};
-        }
-        for (j = 0; j < static_cast<size_t>(n_trees_); ++j) {
-          for (i = batch; i < batch_end; ++i) {
-            agg.ProcessTreeNodePrediction1(scores[SafeInt<ptrdiff_t>(i - batch)], *ProcessTreeNodeLeave(roots_[j], x_data + i * stride));
-          }
-        }
-        for (i = batch; i < batch_end; ++i) {
-          agg.FinalizeScores1(z_data + i, scores[SafeInt<ptrdiff_t>(i - batch)],
-                              label_data == nullptr ? nullptr : (label_data + i));
-        }
-      }
-    } else if (n_trees_ > max_num_threads) { /* section D: 1 output, 2+ rows and enough trees to parallelize */
-      auto num_threads = std::min<int32_t>(max_num_threads, SafeInt<int32_t>(n_trees_));
-      std::vector<ScoreValue<ThresholdType>> scores(SafeInt<size_t>(num_threads) * N);
-      int64_t end_n, begin_n = 0;
-      while (begin_n < N) {
-        end_n = std::min(N, begin_n + parallel_tree_N_);
-        concurrency::ThreadPool::TrySimpleParallelFor(
-            ttp,
-            num_threads,
-            [this, &agg, &scores, num_threads, x_data, N, begin_n, end_n, stride](ptrdiff_t batch_num) {
-              auto work = concurrency::ThreadPool::PartitionWork(batch_num, num_threads, onnxruntime::narrow<size_t>(this->n_trees_));
-              for (int64_t i = begin_n; i < end_n; ++i) {
-                scores[batch_num * SafeInt<ptrdiff_t>(N) + i] = {0, 0};
-              }
-              for (auto j = work.start; j < work.end; ++j) {
-                for (int64_t i = begin_n; i < end_n; ++i) {
-                  agg.ProcessTreeNodePrediction1(scores[batch_num * SafeInt<ptrdiff_t>(N) + i],
-                                                 *ProcessTreeNodeLeave(roots_[j], x_data + i * stride));
-                }
-              }
-            });
-        begin_n = end_n;
-      }
-      concurrency::ThreadPool::TrySimpleParallelFor(
-          ttp,
-          num_threads,
-          [&agg, &scores, num_threads, label_data, z_data, N](ptrdiff_t batch_num) {
-            auto work = concurrency::ThreadPool::PartitionWork(batch_num, num_threads, onnxruntime::narrow<size_t>(N));
-            for (auto i = work.start; i < work.end; ++i) {
-              for (int64_t j = 1; j < num_threads; ++j) {
-                agg.MergePrediction1(scores[i], scores[j * SafeInt<ptrdiff_t>(N) + i]);
-              }
-              agg.FinalizeScores1(z_data + i, scores[i],
-                                  label_data == nullptr ? nullptr : (label_data + i));
-            }
-          });
-    } else { /* section E: 1 output, 2+ rows, parallelization by rows */
-      concurrency::ThreadPool::TryBatchParallelFor(
-          ttp,
-          SafeInt<int32_t>(N),
-          [this, &agg, x_data, z_data, stride, label_data](ptrdiff_t i) {
-            ScoreValue<ThresholdType> score = {0, 0};
-            for (size_t j = 0; j < static_cast<size_t>(n_trees_); ++j) {
-              agg.ProcessTreeNodePrediction1(score, *ProcessTreeNodeLeave(roots_[j], x_data + i * stride));
-            }
+    ComputeAggImpl<ScoreValue<ThresholdType>>(ttp, x_data, N, stride, z_data, label_data, agg);
+  } else {
+    ComputeAggImpl<InlinedVector<ScoreValue<ThresholdType>>>(ttp, x_data, N, stride, z_data, label_data, agg);
+  }
+}
 
-            agg.FinalizeScores1(z_data + i, score,
-                                label_data == nullptr ? nullptr : (label_data + i));
-          },
-          max_num_threads);
-    }
+template <typename InputType, typename ThresholdType, typename OutputType>
+template <typename ScoresType, typename AGG>
+void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ComputeAggImpl(concurrency::ThreadPool* ttp,
+                                                                              const InputType* x_data,
+                                                                              int64_t N, int64_t stride,
+                                                                              OutputType* z_data,
+                                                                              int64_t* label_data,
+                                                                              const AGG& agg) const {
+  auto max_num_threads = concurrency::ThreadPool::DegreeOfParallelism(ttp);
+  const double row_cost = cumulated_tree_costs_.back();
+  const double total_cost = row_cost * static_cast<double>(N);
+
+  if (max_num_threads == 1 || total_cost < 2 * kMinCostPerThread) {
+    // Not enough work to parallelize.
+    ComputeRows<ScoresType>(x_data, stride, 0, N, z_data, label_data, agg);
+  } else if (N >= kRowBlock * max_num_threads) {
+    // Parallelization by rows: every thread evaluates all the trees on its share of the row blocks.
+    const auto num_threads = static_cast<ptrdiff_t>(
+        std::min<double>(static_cast<double>(max_num_threads), total_cost / kMinCostPerThread));
+    const ptrdiff_t num_blocks = onnxruntime::narrow<ptrdiff_t>((N + kRowBlock - 1) / kRowBlock);
+    concurrency::ThreadPool::TrySimpleParallelFor(
+        ttp,
+        num_threads,
+        [this, &agg, num_threads, num_blocks, x_data, z_data, label_data, N, stride](ptrdiff_t batch_num) {
+          auto work = concurrency::ThreadPool::PartitionWork(batch_num, num_threads, num_blocks);
+          ComputeRows<ScoresType>(x_data, stride, work.start * kRowBlock, std::min<int64_t>(N, work.end * kRowBlock),
+                                  z_data, label_data, agg);
+        });
   } else {
-    if (N == 1) {                                               /* section A2: 2+ outputs, 1 row, not enough trees to parallelize */
-      if (n_trees_ <= parallel_tree_ || max_num_threads == 1) { /* section A2 */
-        InlinedVector<ScoreValue<ThresholdType>> scores(onnxruntime::narrow<size_t>(n_targets_or_classes_), {0, 0});
-        for (int64_t j = 0; j < n_trees_; ++j) {
-          agg.ProcessTreeNodePrediction(scores, *ProcessTreeNodeLeave(roots_[onnxruntime::narrow<size_t>(j)], x_data), weights_);
-        }
-        agg.FinalizeScores(scores, z_data, -1, label_data);
-      } else { /* section B2: 2+ outputs, 1 row, enough trees to parallelize */
-        auto num_threads = std::min<int32_t>(max_num_threads, SafeInt<int32_t>(n_trees_));
-        std::vector<InlinedVector<ScoreValue<ThresholdType>>> scores(num_threads);
-        concurrency::ThreadPool::TrySimpleParallelFor(
-            ttp,
-            num_threads,
-            [this, &agg, &scores, num_threads, x_data](ptrdiff_t batch_num) {
-              scores[batch_num].resize(onnxruntime::narrow<size_t>(n_targets_or_classes_), {0, 0});
-              auto work = concurrency::ThreadPool::PartitionWork(batch_num, num_threads, onnxruntime::narrow<size_t>(n_trees_));
-              for (auto j = work.start; j < work.end; ++j) {
-                agg.ProcessTreeNodePrediction(scores[batch_num], *ProcessTreeNodeLeave(roots_[j], x_data), weights_);
-              }
-            });
-        for (size_t i = 1, limit = scores.size(); i < limit; ++i) {
-          agg.MergePrediction(scores[0], scores[i]);
-        }
-        agg.FinalizeScores(scores[0], z_data, -1, label_data);
-      }
-    } else if (N <= parallel_N_ || max_num_threads == 1) { /* section C2: 2+ outputs, 2+ rows, not enough rows to parallelize */
-      std::vector<InlinedVector<ScoreValue<ThresholdType>>> scores(parallel_tree_N_);
-      size_t j, limit;
-      int64_t i, batch, batch_end;
-      batch_end = std::min(N, static_cast<int64_t>(parallel_tree_N_));
-      for (i = 0; i < batch_end; ++i) {
-        scores[SafeInt<ptrdiff_t>(i)].resize(onnxruntime::narrow<size_t>(n_targets_or_classes_));
-      }
-      for (batch = 0; batch < N; batch += parallel_tree_N_) {
-        batch_end = std::min(N, batch + parallel_tree_N_);
-        for (i = batch; i < batch_end; ++i) {
-          std::fill(scores[SafeInt<ptrdiff_t>(i - batch)].begin(), scores[SafeInt<ptrdiff_t>(i - batch)].end(), ScoreValue<ThresholdType>({0, 0}));
-        }
-        for (j = 0, limit = roots_.size(); j < limit; ++j) {
-          for (i = batch; i < batch_end; ++i) {
-            agg.ProcessTreeNodePrediction(scores[SafeInt<ptrdiff_t>(i - batch)], *ProcessTreeNodeLeave(roots_[j], x_data + i * stride), weights_);
+    // Parallelization by trees: there are not enough rows to keep every thread busy. The trees are split into
+    // chunks of the same cost, every thread evaluates its chunk on all rows, then the partial scores are merged.
+    const auto num_threads = static_cast<ptrdiff_t>(
+        std::min<double>({static_cast<double>(max_num_threads), total_cost / kMinCostPerThread,
+                          static_cast<double>(n_trees_)}));
+    std::vector<ScoresType> scores(SafeInt<size_t>(num_threads) * N);
+    concurrency::ThreadPool::TrySimpleParallelFor(
+        ttp,
+        num_threads,
+        [this, &agg, &scores, num_threads, row_cost, x_data, N, stride](ptrdiff_t batch_num) {
+          auto first_tree = [this, num_threads, row_cost](ptrdiff_t batch) {
+            if (batch == num_threads) {
+              return static_cast<size_t>(n_trees_);
+            }
+            auto it = std::lower_bound(cumulated_tree_costs_.cbegin(), cumulated_tree_costs_.cend() - 1,
+                                       row_cost * static_cast<double>(batch) / static_cast<double>(num_threads));
+            return static_cast<size_t>(it - cumulated_tree_costs_.cbegin());
+          };
+          ScoresType* batch_scores = scores.data() + batch_num * N;
+          for (int64_t i = 0; i < N; ++i) {
+            ResetScores(batch_scores[i]);
           }
-        }
-        for (i = batch; i < batch_end; ++i) {
-          agg.FinalizeScores(scores[SafeInt<ptrdiff_t>(i - batch)], z_data + i * n_targets_or_classes_, -1,
-                             label_data == nullptr ? nullptr : (label_data + i));
-        }
-      }
+          EvaluateTrees(first_tree(batch_num), first_tree(batch_num + 1), x_data, stride, 0, N,
+                        [this, &agg, batch_scores](int64_t i, const TreeNodeElement<ThresholdType>& leaf) {
+                          ProcessLeaf(agg, batch_scores[i], leaf);
+                        });
+        });
 
-    } else if (n_trees_ >= max_num_threads) { /* section: D2: 2+ outputs, 2+ rows, enough trees to parallelize*/
-      auto num_threads = std::min<int32_t>(max_num_threads, SafeInt<int32_t>(n_trees_));
-      std::vector<InlinedVector<ScoreValue<ThresholdType>>> scores(SafeInt<size_t>(num_threads) * N);
-      int64_t end_n, begin_n = 0;
-      while (begin_n < N) {
-        end_n = std::min(N, begin_n + parallel_tree_N_);
-        concurrency::ThreadPool::TrySimpleParallelFor(
-            ttp,
-            num_threads,
-            [this, &agg, &scores, num_threads, x_data, N, stride, begin_n, end_n](ptrdiff_t batch_num) {
-              auto work = concurrency::ThreadPool::PartitionWork(batch_num, num_threads, onnxruntime::narrow<size_t>(this->n_trees_));
-              for (int64_t i = begin_n; i < end_n; ++i) {
-                scores[batch_num * SafeInt<ptrdiff_t>(N) + i].resize(onnxruntime::narrow<size_t>(n_targets_or_classes_), {0, 0});
-              }
-              for (auto j = work.start; j < work.end; ++j) {
-                for (int64_t i = begin_n; i < end_n; ++i) {
-                  agg.ProcessTreeNodePrediction(scores[batch_num * SafeInt<ptrdiff_t>(N) + i],
-                                                *ProcessTreeNodeLeave(roots_[j], x_data + i * stride), weights_);
-                }
-              }
-            });
-        begin_n = end_n;
+    for (int64_t i = 0; i < N; ++i) {
+      for (ptrdiff_t j = 1; j < num_threads; ++j) {
+        MergeScores(agg, scores[i], scores[j * N + i]);
       }
-      concurrency::ThreadPool::TrySimpleParallelFor(
-          ttp,
-          num_threads,
-          [this, &agg, &scores, num_threads, label_data, z_data, N](ptrdiff_t batch_num) {
-            auto work = concurrency::ThreadPool::PartitionWork(batch_num, onnxruntime::narrow<ptrdiff_t>(num_threads), onnxruntime::narrow<ptrdiff_t>(N));
-            for (auto i = work.start; i < work.end; ++i) {
-              for (int64_t j = 1; j < num_threads; ++j) {
-                agg.MergePrediction(scores[i], scores[j * SafeInt<ptrdiff_t>(N) + i]);
-              }
-              agg.FinalizeScores(scores[i], z_data + i * this->n_targets_or_classes_, -1,
-                                 label_data == nullptr ? nullptr : (label_data + i));
-            }
-          });
-    } else { /* section E2: 2+ outputs, 2+ rows, parallelization by rows */
-      auto num_threads = std::min<int32_t>(max_num_threads, SafeInt<int32_t>(N));
-      concurrency::ThreadPool::TrySimpleParallelFor(
-          ttp,
-          num_threads,
-          [this, &agg, num_threads, x_data, z_data, label_data, N, stride](ptrdiff_t batch_num) {
-            size_t j, limit;
-            InlinedVector<ScoreValue<ThresholdType>> scores(onnxruntime::narrow<size_t>(n_targets_or_classes_));
-            auto work = concurrency::ThreadPool::PartitionWork(batch_num, onnxruntime::narrow<ptrdiff_t>(num_threads), onnxruntime::narrow<ptrdiff_t>(N));
-
-            for (auto i = work.start; i < work.end; ++i) {
-              std::fill(scores.begin(), scores.end(), ScoreValue<ThresholdType>({0, 0}));
-              for (j = 0, limit = roots_.size(); j < limit; ++j) {
-                agg.ProcessTreeNodePrediction(scores, *ProcessTreeNodeLeave(roots_[j], x_data + i * stride), weights_);
-              }
-
-              agg.FinalizeScores(scores,
-                                 z_data + i * n_targets_or_classes_, -1,
-                                 label_data == nullptr ? nullptr : (label_data + i));
-            }
-          });
+      FinalizeScores(agg, scores[i], z_data, label_data, i);
     }
   }
-}  // namespace detail
+}
+
+template <typename InputType, typename ThresholdType, typename OutputType>
+template <typename ScoresType, typename AGG>
+void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ComputeRows(const InputType* x_data, int64_t stride,
+                                                                           int64_t row_begin, int64_t row_end,
+                                                                           OutputType* z_data, int64_t* label_data,
+                                                                           const AGG& agg) const {
+  // The rows are split into batches small enough to stay in cache while every tree is evaluated on them.
+  // This change was introduced by PR: https://github.com/microsoft/onnxruntime/pull/13835.
+  std::vector<ScoresType> scores(static_cast<size_t>(std::min<int64_t>(parallel_tree_N_, row_end - row_begin)));
+  for (int64_t batch = row_begin; batch < row_end; batch += parallel_tree_N_) {
+    const int64_t batch_end = std::min<int64_t>(row_end, batch + parallel_tree_N_);
+    for (int64_t i = batch; i < batch_end; ++i) {
+      ResetScores(scores[static_cast<size_t>(i - batch)]);
+    }
+    EvaluateTrees(0, static_cast<size_t>(n_trees_), x_data, stride, batch, batch_end,
+                  [this, &agg, &scores, batch](int64_t i, const TreeNodeElement<ThresholdType>& leaf) {
+                    ProcessLeaf(agg, scores[static_cast<size_t>(i - batch)], leaf);
+                  });
+    for (int64_t i = batch; i < batch_end; ++i) {
+      FinalizeScores(agg, scores[static_cast<size_t>(i - batch)], z_data, label_data, i);
+    }
+  }
+}
 
 #define TREE_FIND_VALUE(CMP)                                                                           \
   if (has_missing_tracks_) {                                                                           \
@@ -767,6 +807,101 @@ TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ProcessTreeNodeLeave(
   return root;
 }
 
+#define TREE_EVALUATE_BLOCKS(COMPARE)                                                                  \
+  if (has_missing_tracks_) {                                                                           \
+    EvaluateTreeBlocks<COMPARE, true>(tree_begin, tree_end, x_data, stride, row_begin, row_end, fn);   \
+  } else {                                                                                             \
+    EvaluateTreeBlocks<COMPARE, false>(tree_begin, tree_end, x_data, stride, row_begin, row_end, fn);  \
+  }
+
+template <typename InputType, typename ThresholdType, typename OutputType>
+template <typename Fn>
+void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::EvaluateTrees(size_t tree_begin, size_t tree_end,
+                                                                             const InputType* x_data, int64_t stride,
+                                                                             int64_t row_begin, int64_t row_end,
+                                                                             Fn&& fn) const {
+  if (!same_mode_) {
+    // Different rules to compare to node thresholds, every row walks the nodes on its own.
+    for (size_t j = tree_begin; j < tree_end; ++j) {
+      for (int64_t i = row_begin; i < row_end; ++i) {
+        fn(i, *ProcessTreeNodeLeave(roots_[j], x_data + i * stride));
+      }
+    }
+    return;
+  }
+
+  switch (branch_mode_) {
+    case NODE_MODE::BRANCH_LEQ:
+      TREE_EVALUATE_BLOCKS(std::less_equal<>)
+      break;
+    case NODE_MODE::BRANCH_LT:
+      TREE_EVALUATE_BLOCKS(std::less<>)
+      break;
+    case NODE_MODE::BRANCH_GTE:
+      TREE_EVALUATE_BLOCKS(std::greater_equal<>)
+      break;
+    case NODE_MODE::BRANCH_GT:
+      TREE_EVALUATE_BLOCKS(std::greater<>)
+      break;
+    case NODE_MODE::BRANCH_EQ:
+      TREE_EVALUATE_BLOCKS(std::equal_to<>)
+      break;
+    case NODE_MODE::BRANCH_NEQ:
+      TREE_EVALUATE_BLOCKS(std::not_equal_to<>)
+      break;
+    case NODE_MODE::LEAF:
+      ORT_THROW("Unexpected branch mode in TreeEnsemble.");
+  }
+}
+
+template <typename InputType, typename ThresholdType, typename OutputType>
+template <typename Compare, bool HasMissingTracks, typename Fn>
+void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::EvaluateTreeBlocks(size_t tree_begin, size_t tree_end,
+                                                                                  const InputType* x_data,
+                                                                                  int64_t stride,
+                                                                                  int64_t row_begin, int64_t row_end,
+                                                                                  Fn& fn) const {
+  const int32_t* feature_ids = flat_feature_ids_.data();
+  const ThresholdType* thresholds = flat_thresholds_.data();
+  const uint32_t* children = flat_children_.data();
+  const InputType* rows[kRowBlock];
+  uint32_t ids[kRowBlock];
+  Compare compare;
+
+  for (size_t j = tree_begin; j < tree_end; ++j) {
+    for (int64_t block = row_begin; block < row_end; block += kRowBlock) {
+      const size_t block_size = static_cast<size_t>(std::min<int64_t>(kRowBlock, row_end - block));
+      for (size_t r = 0; r < block_size; ++r) {
+        rows[r] = x_data + (block + static_cast<int64_t>(r)) * stride;
+        ids[r] = flat_roots_[j];
+      }
+
+      // The rows of a block go down the tree one level at a time. Their walks are independent so the loads of
+      // one row overlap with the comparisons of the others, and the comparison result indexes the next node
+      // instead of being a hard to predict branch.
+      bool moved = true;
+      while (moved) {
+        moved = false;
+        for (size_t r = 0; r < block_size; ++r) {
+          const uint32_t id = ids[r];
+          const InputType val = rows[r][feature_ids[id]];
+          bool is_true = compare(val, thresholds[id]);
+          if constexpr (HasMissingTracks) {
+            is_true = is_true || (flat_missing_tracks_true_[id] && _isnan_(val));
+          }
+          const uint32_t next = children[2 * static_cast<size_t>(id) + static_cast<size_t>(is_true)];
+          moved = moved || next != id;
+          ids[r] = next;
+        }
+      }
+
+      for (size_t r = 0; r < block_size; ++r) {
+        fn(block + static_cast<int64_t>(r), nodes_[ids[r]]);
+      }
+    }
+  }
+}
+
 // TI: input type
 // TH: threshold type, double if T==double, float otherwise
 // TO: output type
@@ -783,9 +918,7 @@ class TreeEnsembleCommonClassifier : public TreeEnsembleCommon<InputType, Thresh
   virtual Status Init(const OpKernelInfo& info);
   virtual Status compute(OpKernelContext* ctx, const Tensor* X, Tensor* Z, Tensor* label) const;
 
-  Status Init(int parallel_tree,
-              int parallel_tree_N,
-              int parallel_N,
+  Status Init(int parallel_tree_N,
               const std::string& aggregate_function,
               const std::vector<float>& base_values,
               const std::vector<ThresholdType>& base_values_as_tensor,
@@ -822,9 +955,7 @@ Status TreeEnsembleCommonClassifier<InputType, ThresholdType, OutputType>::Init(
 #endif
 
   return Init(
-      80,
       128,
-      50,
       info.GetAttrOrDefault<std::string>("aggregate_function", "SUM"),
       info.GetAttrsOrDefault<float>("base_values"),
       base_values_as_tensor,
@@ -851,9 +982,7 @@ Status TreeEnsembleCommonClassifier<InputType, ThresholdType, OutputType>::Init(
 
 template <typename InputType, typename ThresholdType, typename OutputType>
 Status TreeEnsembleCommonClassifier<InputType, ThresholdType, OutputType>::Init(
-    int parallel_tree,
     int parallel_tree_N,
-    int parallel_N,
     const std::string& aggregate_function,
     const std::vector<float>& base_values,
     const std::vector<ThresholdType>& base_values_as_tensor,
@@ -877,9 +1006,7 @@ Status TreeEnsembleCommonClassifier<InputType, ThresholdType, OutputType>::Init(
     const std::vector<std::string>& classlabels_strings,
     const std::vector<int64_t>& classlabels_int64s) {
   auto status = TreeEnsembleCommon<InputType, ThresholdType, OutputType>::Init(
-      parallel_tree,
       parallel_tree_N,
-      parallel_N,
       aggregate_function,
       base_values,
       base_values_as_tensor,
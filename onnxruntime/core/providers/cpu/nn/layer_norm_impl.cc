@@ -5,6 +5,7 @@
 
 #include "core/common/safeint.h"
 #include "core/framework/tensor.h"
+#include "core/mlas/inc/mlas.h"
 #include "core/platform/threadpool.h"
 #include "core/providers/common.h"
 #include "core/util/math_cpuonly.h"
@@ -18,6 +19,76 @@ LayerNormImpl::LayerNormImpl(const OpKernelInfo& op_kernel_info, bool simplified
 }
 
 namespace {
+template <typename T, typename U>
+void ComputeJob(
+    const T* X_data,
+    const T* scale_data,
+    const T* bias_data,
+    const ptrdiff_t task_idx,
+    const int64_t norm_size,
+    const float epsilon,
+    const bool simplified,
+    T* Y_data,
+    U* mean_data,
+    U* inv_std_dev_data) {
+  const T* p_input = X_data + task_idx * norm_size;
+  T* p_output = Y_data + task_idx * norm_size;
+
+  T mean = 0;
+  T mean_square = 0;
+
+  for (int64_t h = 0; h < norm_size; h++) {
+    mean += p_input[h];
+    mean_square += p_input[h] * p_input[h];
+  }
+
+  mean = mean / norm_size;
+  if (simplified) {
+    mean_square = sqrt(mean_square / norm_size + epsilon);
+  } else {
+    mean_square = sqrt(mean_square / norm_size - mean * mean + epsilon);
+  }
+
+  for (int64_t h = 0; h < norm_size; h++) {
+    if (simplified) {
+      p_output[h] = p_input[h] / mean_square * scale_data[h];
+    } else if (nullptr == bias_data) {
+      p_output[h] = (p_input[h] - mean) / mean_square * scale_data[h];
+    } else {
+      p_output[h] = (p_input[h] - mean) / mean_square * scale_data[h] + bias_data[h];
+    }
+  }
+
+  if (mean_data != nullptr) {
+    // ONNX spec doesn't support 'double' for 'U' so when 'T' == double, 'U' == float and we need to narrow
+    mean_data[task_idx] = gsl::narrow_cast<U>(mean);
+  }
+
+  if (inv_std_dev_data != nullptr) {
+    inv_std_dev_data[task_idx] = gsl::narrow_cast<U>(1 / mean_square);
+  }
+}
+
+// The float row is normalized by the vectorized MLAS kernel, which gathers the row statistics in a single pass.
+void ComputeJob(
+    const float* X_data,
+    const float* scale_data,
+    const float* bias_data,
+    const ptrdiff_t task_idx,
+    const int64_t norm_size,
+    const float epsilon,
+    const bool simplified,
+    float* Y_data,
+    float* mean_data,
+    float* inv_std_dev_data) {
+  const size_t row_size = onnxruntime::narrow<size_t>(norm_size);
+
+  MlasLayerNormalization(X_data + task_idx * norm_size, scale_data, bias_data, Y_data + task_idx * norm_size,
+                         mean_data != nullptr ? mean_data + task_idx : nullptr,
+                         inv_std_dev_data != nullptr ? inv_std_dev_data + task_idx : nullptr,
+                         1, row_size, epsilon, simplified);
+}
+
 template <typename T, typename U>
 Status ComputeImpl(OpKernelContext* p_ctx, int64_t orig_axis, float epsilon, bool simplified) {
   // Inputs
@@ -77,42 +148,8 @@ Status ComputeImpl(OpKernelContext* p_ctx, int64_t orig_axis, float epsilon, boo
   concurrency::ThreadPool::TryBatchParallelFor(
       p_ctx->GetOperatorThreadPool(), static_cast<int32_t>(norm_count),
       [&](ptrdiff_t task_idx) {
-        const T* p_input = X_data + task_idx * norm_size;
-        T* p_output = Y_data + task_idx * norm_size;
-
-        T mean = 0;
-        T mean_square = 0;
-
-        for (int64_t h = 0; h < norm_size; h++) {
-          mean += p_input[h];
-          mean_square += p_input[h] * p_input[h];
-        }
-
-        mean = mean / norm_size;
-        if (simplified) {
-          mean_square = sqrt(mean_square / norm_size + epsilon);
-        } else {
-          mean_square = sqrt(mean_square / norm_size - mean * mean + epsilon);
-        }
-
-        for (int64_t h = 0; h < norm_size; h++) {
-          if (simplified) {
-            p_output[h] = p_input[h] / mean_square * scale_data[h];
-          } else if (nullptr == bias) {
-            p_output[h] = (p_input[h] - mean) / mean_square * scale_data[h];
-          } else {
-            p_output[h] = (p_input[h] - mean) / mean_square * scale_data[h] + bias_data[h];
-          }
-        }
-
-        if (mean_data != nullptr) {
-          // ONNX spec doesn't support 'double' for 'U' so when 'T' == double, 'U' == float and we need to narrow
-          mean_data[task_idx] = gsl::narrow_cast<U>(mean);
-        }
-
-        if (inv_std_dev_data != nullptr) {
-          inv_std_dev_data[task_idx] = gsl::narrow_cast<U>(1 / mean_square);
-        }
+        ComputeJob(X_data, scale_data, bias_data, task_idx, norm_size, epsilon, simplified,
+                   Y_data, mean_data, inv_std_dev_data);
       },
       0);
 
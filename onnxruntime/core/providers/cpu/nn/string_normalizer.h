@@ -3,10 +3,9 @@
 
 #pragma once
 
-#include "core/common/inlined_containers.h"
 #include "core/framework/op_kernel.h"
+#include "core/providers/cpu/string_table.h"
 
-#include <locale>
 #include <string>
 
 namespace onnxruntime {
@@ -28,10 +27,8 @@ class StringNormalizer : public OpKernel {
   bool is_case_sensitive_;
   CaseAction case_change_action_;
   CaseAction compare_caseaction_;  // used for case-insensitive compare
-  std::string locale_name_;
-  // Either if these are populated but not both
-  InlinedHashSet<std::string> stopwords_;
-  InlinedHashSet<std::wstring> wstopwords_;
+  // Stopwords, changed to compare_caseaction_ when the comparison is case-insensitive.
+  StringTable stopwords_;
 };
 
 }  // namespace onnxruntime
@@ -4,10 +4,12 @@
 #include "tfidfvectorizer.h"
 #include "core/common/common.h"
 #include "core/framework/tensor.h"
+#include "core/common/inlined_containers.h"
 #include "core/platform/threadpool.h"
+#include "core/providers/cpu/string_table.h"
 
 #include <functional>
-#include <unordered_map>
+#include <limits>
 #include <core/common/safeint.h>
 
 namespace onnxruntime {
@@ -24,61 +26,39 @@ ONNX_CPU_OPERATOR_KERNEL(
 
 namespace ngram_details {
 
-// NgrampPart implements a Trie like structure
-// for a unigram (1) it would insert into a root map with a valid id.
+inline uint64_t TransitionKey(uint32_t node, uint32_t token) {
+  return (uint64_t{node} << 32) | token;
+}
+
+// NgramTrieBuilder collects the n-grams into a Trie like structure of numbered nodes.
+// Node 0 is the root and a unigram (1) is a child of the root with a valid id.
 // for (1,2,3) node 2 would be a child of 1 but have id == 0
 // because (1,2) does not exists. Node 3 would have a valid id.
-template <class T>
-struct NgramPart;
-
-template <>
-struct NgramPart<int64_t>;
-
-template <>
-struct NgramPart<std::string>;
-
-using NgramPartInt = NgramPart<int64_t>;
-using NgramPartString = NgramPart<std::string>;
-
-// Avoid recursive class definitions using unique_ptr + forward declaration
-using IntMap = std::unordered_map<int64_t, std::unique_ptr<NgramPartInt>>;
-
-using StrMap = std::unordered_map<std::reference_wrapper<const std::string>, std::unique_ptr<NgramPartString>,
-                                  std::hash<std::string>, std::equal_to<std::string>>;
-
-template <>
-struct NgramPart<int64_t> {
-  size_t id_;  // 0 - means no entry, search for a bigger N
-  IntMap leafs_;
-  explicit NgramPart(size_t id) : id_(id) {}
-};
-
-template <>
-struct NgramPart<std::string> {
-  size_t id_;  // 0 - means no entry, search for a bigger N
-  StrMap leafs_;
-  explicit NgramPart(size_t id) : id_(id) {}
+struct NgramTrieBuilder {
+  std::vector<uint32_t> ngram_ids{0};  // 0 - means no entry, search for a bigger N
+  InlinedHashMap<uint64_t, uint32_t> children;
+
+  uint32_t AddChild(uint32_t node, uint32_t token) {
+    auto p = children.emplace(TransitionKey(node, token), static_cast<uint32_t>(ngram_ids.size()));
+    if (p.second) {
+      ngram_ids.push_back(0);
+    }
+    return p.first->second;
+  }
 };
 
 // Returns next ngram_id
-template <class K, class ForwardIter, class Map>
+template <class ForwardIter, class TokenId>
 inline size_t PopulateGrams(ForwardIter first, size_t ngrams, size_t ngram_size, size_t ngram_id,
-                            Map& c) {
+                            const TokenId& token_id, NgramTrieBuilder& trie) {
   for (; ngrams > 0; --ngrams) {
-    size_t n = 1;
-    Map* m = &c;
-    while (true) {
-      auto p = m->emplace(*first, std::make_unique<NgramPart<K>>(0));
-      ++first;
-      if (n == ngram_size) {
-        ORT_ENFORCE(p.first->second->id_ == 0, "Duplicate ngram detected, size: ", ngram_size, " id: ", ngram_id);
-        p.first->second->id_ = ngram_id;
-        ++ngram_id;
-        break;
-      }
-      ++n;
-      m = &p.first->second->leafs_;
+    uint32_t node = 0;
+    for (size_t n = 0; n < ngram_size; ++n, ++first) {
+      node = trie.AddChild(node, token_id(*first));
     }
+    ORT_ENFORCE(trie.ngram_ids[node] == 0, "Duplicate ngram detected, size: ", ngram_size, " id: ", ngram_id);
+    trie.ngram_ids[node] = static_cast<uint32_t>(ngram_id);
+    ++ngram_id;
   }
   return ngram_id;
 }
@@ -90,10 +70,6 @@ using namespace onnxruntime::ngram_details;
 
 namespace onnxruntime {
 
-inline const void* AdvanceElementPtr(const void* p, size_t elements, size_t element_size) {
-  return reinterpret_cast<const uint8_t*>(p) + elements * element_size;
-}
-
 // The weighting criteria.
 // "TF"(term frequency),
 //    the counts are propagated to output
@@ -128,11 +104,18 @@ struct TfIdfVectorizer::Impl {
   gsl::span<const int64_t> ngram_indexes_;
   gsl::span<const float> weights_;
 
-  // This map contains references to pool_string_ entries
-  // of pool_strings attribute
-  StrMap str_map_;
-  // This map contains pool_int64s entries
-  IntMap int64_map_;
+  // Pool entries are mapped to token ids: pool_strings entries by str_tokens_
+  // and pool_int64s entries by int64_tokens_.
+  bool string_pool_ = false;
+  StringTable str_tokens_;
+  PerfectHashMap<uint32_t> int64_tokens_;
+
+  // Flattened n-gram trie, see NgramTrieBuilder. ngram_ids_ is indexed by node,
+  // root_children_ by token id and children_ by TransitionKey(node, token).
+  // A child node of 0 means there is no such child.
+  std::vector<uint32_t> ngram_ids_;
+  std::vector<uint32_t> root_children_;
+  PerfectHashMap<uint32_t> children_;
 
   size_t output_size_ = 0;
 
@@ -141,6 +124,33 @@ struct TfIdfVectorizer::Impl {
   Impl(const Impl&) = delete;
   Impl& operator=(const Impl&) = delete;
 
+  uint32_t TokenId(const std::string& value) const {
+    return str_tokens_.Find(value);
+  }
+
+  uint32_t TokenId(int64_t value) const {
+    return int64_tokens_.Find(static_cast<uint64_t>(value));
+  }
+
+  uint32_t Child(uint32_t node, uint32_t token) const {
+    return node == 0 ? root_children_[token] : children_.Find(TransitionKey(node, token));
+  }
+
+  void BuildTrie(const NgramTrieBuilder& trie, size_t num_tokens) {
+    ngram_ids_ = trie.ngram_ids;
+    root_children_.assign(num_tokens, 0);
+    std::vector<std::pair<uint64_t, uint32_t>> children;
+    children.reserve(trie.children.size());
+    for (const auto& child : trie.children) {
+      if ((child.first >> 32) == 0) {
+        root_children_[static_cast<uint32_t>(child.first)] = child.second;
+      } else {
+        children.push_back(child);
+      }
+    }
+    children_ = PerfectHashMap<uint32_t>(children, 0);
+  }
+
   void IncrementCount(size_t ngram_id, size_t row_num,
                       std::vector<uint32_t>& frequencies) const {
     assert(ngram_id != 0);
@@ -220,6 +230,32 @@ TfIdfVectorizer::TfIdfVectorizer(const OpKernelInfo& info) : OpKernel(info), imp
 
   // Iterator via the pool. Insert 1 item for 1-grams, 2 items for 2-grams, etc.
   const auto total_items = (pool_strings.empty()) ? pool_int64s.size() : pool_strings.size();
+  ORT_ENFORCE(total_items < std::numeric_limits<uint32_t>::max(), "Too many pool entries: ", total_items);
+
+  // Give every distinct pool entry a token id.
+  size_t num_tokens = 0;
+  impl_->string_pool_ = !pool_strings.empty();
+  if (impl_->string_pool_) {
+    impl_->str_tokens_ = StringTable(pool_strings);
+    num_tokens = impl_->str_tokens_.IdBound();
+  } else {
+    InlinedHashMap<int64_t, uint32_t> token_ids;
+    token_ids.reserve(pool_int64s.size());
+    for (int64_t value : pool_int64s) {
+      token_ids.emplace(value, static_cast<uint32_t>(token_ids.size()));
+    }
+    std::vector<std::pair<uint64_t, uint32_t>> entries;
+    entries.reserve(token_ids.size());
+    for (const auto& token : token_ids) {
+      entries.emplace_back(static_cast<uint64_t>(token.first), token.second);
+    }
+    impl_->int64_tokens_ = PerfectHashMap<uint32_t>(entries, StringTable::kNotFound);
+    num_tokens = token_ids.size();
+  }
+  auto str_token_id = [this](const std::string& value) { return impl_->TokenId(value); };
+  auto int64_token_id = [this](int64_t value) { return impl_->TokenId(value); };
+
+  NgramTrieBuilder trie;
   size_t ngram_id = 1;  // start with 1, 0 - means no n-gram
   // Load into dictionary only required gram sizes
   const size_t min_gram_length = onnxruntime::narrow<size_t>(impl_->min_gram_length_);
@@ -238,9 +274,9 @@ TfIdfVectorizer::TfIdfVectorizer(const OpKernelInfo& info) : OpKernel(info), imp
       // Skip loading into hash_set ngrams that are not in the range of [min_gram_length-max_gram_length]
       if (ngram_size >= min_gram_length && ngram_size <= max_gram_length) {
         if (pool_strings.empty()) {
-          ngram_id = PopulateGrams<int64_t>(pool_int64s.begin() + start_idx, ngrams, ngram_size, ngram_id, impl_->int64_map_);
+          ngram_id = PopulateGrams(pool_int64s.begin() + start_idx, ngrams, ngram_size, ngram_id, int64_token_id, trie);
         } else {
-          ngram_id = PopulateGrams<std::string>(pool_strings.begin() + start_idx, ngrams, ngram_size, ngram_id, impl_->str_map_);
+          ngram_id = PopulateGrams(pool_strings.begin() + start_idx, ngrams, ngram_size, ngram_id, str_token_id, trie);
         }
       } else {
         ngram_id += ngrams;
@@ -248,6 +284,8 @@ TfIdfVectorizer::TfIdfVectorizer(const OpKernelInfo& info) : OpKernel(info), imp
     }
     ++ngram_size;
   }
+
+  impl_->BuildTrie(trie, num_tokens);
 }
 
 TfIdfVectorizer::~TfIdfVectorizer() = default;
@@ -314,65 +352,55 @@ void TfIdfVectorizer::OutputResult(OpKernelContext* ctx, size_t B, const std::ve
 void TfIdfVectorizer::ComputeImpl(OpKernelContext* ctx, ptrdiff_t row_num, size_t row_size,
                                   std::vector<uint32_t>& frequencies) const {
   auto X = ctx->Input<Tensor>(0);
-  const auto elem_size = X->DataType()->Size();
-
-  const void* const row_begin = AdvanceElementPtr(X->DataRaw(), row_num * row_size, elem_size);
-  const void* const row_end = AdvanceElementPtr(row_begin, row_size, elem_size);
-
   const auto& impl = *impl_;
-  const auto max_gram_length = impl.max_gram_length_;
-  const auto max_skip_distance = impl.max_skip_count_ + 1;  // Convert to distance
-  auto start_ngram_size = impl.min_gram_length_;
 
-  for (auto skip_distance = 1; skip_distance <= max_skip_distance; ++skip_distance) {
-    auto ngram_start = row_begin;
-    auto const ngram_row_end = row_end;
+  // Look up every item of the row once, the n-grams are then matched on token ids.
+  InlinedVector<uint32_t> tokens(row_size);
+  const size_t row_offset = SafeInt<size_t>(row_num) * row_size;
+  if (X->IsDataTypeString()) {
+    const std::string* items = X->Data<std::string>() + row_offset;
+    for (size_t i = 0; i < row_size; ++i) {
+      tokens[i] = impl.TokenId(items[i]);
+    }
+  } else if (X->IsDataType<int32_t>()) {
+    const int32_t* items = X->Data<int32_t>() + row_offset;
+    for (size_t i = 0; i < row_size; ++i) {
+      tokens[i] = impl.TokenId(int64_t{items[i]});
+    }
+  } else {
+    const int64_t* items = X->Data<int64_t>() + row_offset;
+    for (size_t i = 0; i < row_size; ++i) {
+      tokens[i] = impl.TokenId(items[i]);
+    }
+  }
+
+  const size_t max_gram_length = onnxruntime::narrow<size_t>(impl.max_gram_length_);
+  const size_t max_skip_distance = onnxruntime::narrow<size_t>(impl.max_skip_count_ + 1);  // Convert to distance
+  size_t start_ngram_size = onnxruntime::narrow<size_t>(impl.min_gram_length_);
 
-    while (ngram_start < ngram_row_end) {
+  for (size_t skip_distance = 1; skip_distance <= max_skip_distance; ++skip_distance) {
+    const size_t min_ngram_span = SafeInt<size_t>(skip_distance) * (start_ngram_size - 1);
+    for (size_t ngram_start = 0; ngram_start < row_size; ++ngram_start) {
       // We went far enough so no n-grams of any size can be gathered
-      auto at_least_this = AdvanceElementPtr(ngram_start, SafeInt<size_t>(skip_distance) * (start_ngram_size - 1), elem_size);
-      if (at_least_this >= ngram_row_end) {
+      if (min_ngram_span >= row_size - ngram_start) {
         break;
       }
 
-      auto ngram_item = ngram_start;
-      if (X->IsDataTypeString()) {
-        const std::string* str_item = reinterpret_cast<const std::string*>(ngram_item);
-        const StrMap* str_map = &impl.str_map_;
-        for (auto ngram_size = 1;
-             !str_map->empty() &&
-             ngram_size <= max_gram_length &&
-             str_item < ngram_row_end;
-             ++ngram_size, str_item += skip_distance) {
-          auto hit = str_map->find(*str_item);
-          if (hit == str_map->end()) {
-            break;
-          }
-          if (ngram_size >= start_ngram_size && hit->second->id_ != 0) {
-            impl.IncrementCount(hit->second->id_, row_num, frequencies);
-          }
-          str_map = &hit->second->leafs_;
+      uint32_t node = 0;
+      for (size_t ngram_size = 1, item = ngram_start;
+           ngram_size <= max_gram_length && item < row_size;
+           ++ngram_size, item += skip_distance) {
+        if (tokens[item] == StringTable::kNotFound) {
+          break;
         }
-      } else {
-        const IntMap* int_map = &impl.int64_map_;
-        for (auto ngram_size = 1;
-             !int_map->empty() &&
-             ngram_size <= max_gram_length &&
-             ngram_item < ngram_row_end;
-             ++ngram_size, ngram_item = AdvanceElementPtr(ngram_item, skip_distance, elem_size)) {
-          int64_t val = (X->IsDataType<int32_t>()) ? int64_t{*reinterpret_cast<const int32_t*>(ngram_item)} : *reinterpret_cast<const int64_t*>(ngram_item);
-          auto hit = int_map->find(val);
-          if (hit == int_map->end()) {
-            break;
-          }
-          if (ngram_size >= start_ngram_size && hit->second->id_ != 0) {
-            impl.IncrementCount(hit->second->id_, row_num, frequencies);
-          }
-          int_map = &hit->second->leafs_;
+        node = impl.Child(node, tokens[item]);
+        if (node == 0) {
+          break;
+        }
+        if (ngram_size >= start_ngram_size && impl.ngram_ids_[node] != 0) {
+          impl.IncrementCount(impl.ngram_ids_[node], row_num, frequencies);
         }
       }
-      // Sliding window shift
-      ngram_start = AdvanceElementPtr(ngram_start, 1, elem_size);
     }
     // We count UniGrams only once since they are not affected
     // by skip distance
@@ -418,8 +446,8 @@ Status TfIdfVectorizer::Compute(OpKernelContext* ctx) const {
   frequencies.resize(num_rows * impl_->output_size_, 0);
 
   if (total_items == 0 ||
-      (X->IsDataTypeString() && impl_->str_map_.empty()) ||
-      ((X->IsDataType<int32_t>() || X->IsDataType<int64_t>()) && impl_->int64_map_.empty())) {
+      X->IsDataTypeString() != impl_->string_pool_ ||
+      impl_->ngram_ids_.size() <= 1) {
     // TfidfVectorizer may receive an empty input when it follows a Tokenizer
     // (for example for a string containing only stopwords).
     // TfidfVectorizer returns a zero tensor of shape
@@ -78,6 +78,35 @@ class MatMulIntegerBase : public OpKernel {
     return Status::OK();
   }
 
+  Status UseSerializedPrePackedBuffers(const Tensor& tensor, int input_idx,
+                                       std::vector<BufferUniquePtr>& prepacked_buffers,
+                                       gsl::span<const size_t> prepacked_buffer_sizes,
+                                       /*out*/ bool& used_prepacked_buffers) override {
+    used_prepacked_buffers = false;
+
+    if (input_idx == GetBIdx() && prepacked_buffers.size() == 1 && tensor.Shape().NumDimensions() == 2) {
+      auto a_elem_type = Node().InputDefs()[GetAIdx()]->TypeAsProto()->tensor_type().elem_type();
+      bool a_is_signed = ONNX_NAMESPACE::TensorProto_DataType_INT8 == a_elem_type;
+      bool b_is_signed = tensor.IsDataType<int8_t>();
+
+      size_t K = static_cast<size_t>(tensor.Shape()[0]);
+      size_t N = static_cast<size_t>(tensor.Shape()[1]);
+      if (IsBTransposed()) {
+        std::swap(K, N);
+      }
+
+      const size_t packed_b_size = MlasGemmPackBSize(N, K, a_is_signed, b_is_signed);
+      if (packed_b_size != 0 && packed_b_size == prepacked_buffer_sizes[0]) {
+        used_prepacked_buffers = true;
+        b_shape_ = tensor.Shape();
+        b_is_signed_ = b_is_signed;
+        packed_b_ = std::move(prepacked_buffers[0]);
+      }
+    }
+
+    return Status::OK();
+  }
+
  protected:
   /**
    * @return input index of Matrix B, the weight tensor
@@ -32,6 +32,11 @@ class QLinearConv : public OpKernel {
                                    int input_idx,
                                    /*out*/ bool& used_shared_buffers) override;
 
+  Status UseSerializedPrePackedBuffers(const Tensor& tensor, int input_idx,
+                                       std::vector<BufferUniquePtr>& prepacked_buffers,
+                                       gsl::span<const size_t> prepacked_buffer_sizes,
+                                       /*out*/ bool& used_prepacked_buffers) override;
+
  private:
   enum InputTensors : int {
     IN_X = 0,
@@ -511,6 +516,61 @@ Status QLinearConv<ActType>::UseSharedPrePackedBuffers(std::vector<BufferUniqueP
   return Status::OK();
 }
 
+template <typename ActType>
+Status QLinearConv<ActType>::UseSerializedPrePackedBuffers(const Tensor& tensor, int input_idx,
+                                                           std::vector<BufferUniquePtr>& prepacked_buffers,
+                                                           gsl::span<const size_t> prepacked_buffer_sizes,
+                                                           /*out*/ bool& used_prepacked_buffers) {
+  used_prepacked_buffers = false;
+
+  // The symmetric paths keep their packed filter and column sums inside the kernel,
+  // so only the buffers produced by the generic packing path can be restored here.
+  if (input_idx != InputTensors::IN_W || prepacked_buffers.empty() ||
+      prepacked_buffers.size() != prepacked_buffer_sizes.size()) {
+    return Status::OK();
+  }
+
+  const auto& shape = tensor.Shape().GetDims();
+  const size_t rank = shape.size();
+  if (rank <= 2 || shape[0] % conv_attrs_.group != 0) {
+    return Status::OK();
+  }
+
+  const bool is_W_signed = tensor.IsDataType<int8_t>();
+  const size_t output_channels = static_cast<size_t>(shape[0]);
+  const size_t group_input_channels = static_cast<size_t>(shape[1]);
+  const size_t kernel_size =
+      static_cast<size_t>(std::accumulate(shape.data() + 2, shape.data() + rank, 1LL, std::multiplies<int64_t>()));
+  const size_t group_count = static_cast<size_t>(conv_attrs_.group);
+  const size_t group_output_channels = output_channels / group_count;
+
+  if (prepacked_buffers.size() == 1) {  // This means that only packed_W_ exists
+    const size_t packed_W_size = MlasGemmPackBSize(group_output_channels,
+                                                   group_input_channels * kernel_size,
+                                                   std::is_same<ActType, int8_t>::value,
+                                                   is_W_signed);
+    if (packed_W_size == 0 || prepacked_buffer_sizes[0] != static_cast<size_t>(SafeInt<size_t>(group_count) * packed_W_size)) {
+      return Status::OK();
+    }
+    packed_W_size_ = packed_W_size;
+    packed_W_buffer_ = std::move(prepacked_buffers[0]);
+  } else if (prepacked_buffers.size() == 2) {  // This means that only reordered_W_ exists
+    if (prepacked_buffers[0].get() != nullptr ||
+        prepacked_buffer_sizes[1] != static_cast<size_t>(SafeInt<size_t>(output_channels) * group_input_channels * kernel_size)) {
+      return Status::OK();
+    }
+    reordered_W_buffer_ = std::move(prepacked_buffers[1]);
+  } else {
+    return Status::OK();
+  }
+
+  W_shape_ = shape;
+  is_W_signed_ = is_W_signed;
+  is_W_packed_ = true;
+  used_prepacked_buffers = true;
+  return Status::OK();
+}
+
 template <typename ActType>
 Status QLinearConv<ActType>::Compute(OpKernelContext* context) const {
   const Tensor* X = context->Input<Tensor>(InputTensors::IN_X);
@@ -327,6 +327,89 @@ void ReduceAggregatorBase::FastReduceRKR(const Tensor&, const gsl::span<const in
   ValidateMustBeOverloaded();
 }
 
+// Columns are split between threads in blocks of a cache line so that threads never share output cache lines.
+constexpr int64_t kFastReduceFloatColumnBlock = 16;
+
+void FastReduceFloatKR(MLAS_REDUCE_KIND kind, const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                       Tensor& output, concurrency::ThreadPool* tp) {
+  const float* data = input.Data<float>();
+  float* out = output.MutableData<float>();
+  const int64_t stridei = fast_shape[1];
+  concurrency::ThreadPool::TryParallelFor(
+      tp, narrow<std::ptrdiff_t>(fast_shape[0]), ParallelReduceFastCost(1, stridei, sizeof(float), 6),
+      [=](std::ptrdiff_t first, std::ptrdiff_t last) {
+        MlasReduceRows(kind, data + first * stridei, narrow<size_t>(stridei), out + first,
+                       narrow<size_t>(last - first), narrow<size_t>(stridei));
+      });
+}
+
+void FastReduceFloatRK(MLAS_REDUCE_KIND kind, const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                       Tensor& output, concurrency::ThreadPool* tp) {
+  const float* data = input.Data<float>();
+  float* out = output.MutableData<float>();
+  const int64_t n_rows = fast_shape[0];
+  const int64_t N = fast_shape[1];
+  const int64_t n_blocks = (N + kFastReduceFloatColumnBlock - 1) / kFastReduceFloatColumnBlock;
+  concurrency::ThreadPool::TryParallelFor(
+      tp, narrow<std::ptrdiff_t>(n_blocks),
+      ParallelReduceFastCost(n_rows, kFastReduceFloatColumnBlock, sizeof(float), 6),
+      [=](std::ptrdiff_t first, std::ptrdiff_t last) {
+        const int64_t begin = first * kFastReduceFloatColumnBlock;
+        const int64_t end = std::min(last * kFastReduceFloatColumnBlock, N);
+        MlasReduceColumns(kind, data + begin, narrow<size_t>(N), out + begin,
+                          narrow<size_t>(n_rows), narrow<size_t>(end - begin));
+      });
+}
+
+void FastReduceFloatKRK(MLAS_REDUCE_KIND kind, const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                        Tensor& output, concurrency::ThreadPool* tp) {
+  const float* data = input.Data<float>();
+  float* out = output.MutableData<float>();
+  const int64_t n_rows = fast_shape[1];
+  const int64_t N = fast_shape[2];
+  const int64_t n_blocks = (N + kFastReduceFloatColumnBlock - 1) / kFastReduceFloatColumnBlock;
+  // Each unit of work is a block of columns of one kept outer index, so that
+  // small outer dimensions are still split between threads.
+  concurrency::ThreadPool::TryParallelFor(
+      tp, narrow<std::ptrdiff_t>(fast_shape[0] * n_blocks),
+      ParallelReduceFastCost(n_rows, kFastReduceFloatColumnBlock, sizeof(float), 6),
+      [=](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (int64_t i = first; i < last;) {
+          const int64_t d = i / n_blocks;
+          const int64_t first_block = i % n_blocks;
+          const int64_t last_block = std::min(n_blocks, first_block + (last - i));
+          const int64_t begin = first_block * kFastReduceFloatColumnBlock;
+          const int64_t end = std::min(last_block * kFastReduceFloatColumnBlock, N);
+          MlasReduceColumns(kind, data + d * n_rows * N + begin, narrow<size_t>(N), out + d * N + begin,
+                            narrow<size_t>(n_rows), narrow<size_t>(end - begin));
+          i += last_block - first_block;
+        }
+      });
+}
+
+void FastReduceFloatRKR(MLAS_REDUCE_KIND kind, const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                        Tensor& output, concurrency::ThreadPool* tp) {
+  const float* data = input.Data<float>();
+  float* out = output.MutableData<float>();
+  const int64_t d0 = fast_shape[0];
+  const int64_t d2 = fast_shape[2];
+  const int64_t inc = fast_shape[1] * d2;
+  // The partial results of the rows are combined with a sum for the sums of
+  // squares or absolute values, and with the reduction itself otherwise.
+  const MLAS_REDUCE_KIND combine_kind =
+      (kind == MlasReduceSumSquare || kind == MlasReduceSumAbsolute) ? MlasReduceSum : kind;
+  concurrency::ThreadPool::TryParallelFor(
+      tp, narrow<std::ptrdiff_t>(fast_shape[1]), ParallelReduceFastCost(1, d0 * d2, sizeof(float), 6),
+      [=](std::ptrdiff_t first, std::ptrdiff_t last) {
+        InlinedVector<float> partial(narrow<size_t>(d0));
+        for (std::ptrdiff_t d = first; d < last; ++d) {
+          MlasReduceRows(kind, data + d * d2, narrow<size_t>(inc), partial.data(),
+                         narrow<size_t>(d0), narrow<size_t>(d2));
+          MlasReduceRows(combine_kind, partial.data(), narrow<size_t>(d0), out + d, 1, narrow<size_t>(d0));
+        }
+      });
+}
+
 void NoTransposePrepareForReduce(const TensorShape& new_input_shape,
                                  gsl::span<const int64_t> reduced_axes,
                                  ResultsNoTransposePrepareForReduce& results) {
@@ -727,6 +810,7 @@ bool CommonFastReduceSwitch(OpKernelContext* ctx,
                             TensorShapeVector& output_shape,
                             TensorShapeVector& fast_axes,
                             FastReduceKind which_fast_reduce,
+                            bool vectorized_fast_reduce,
                             fast_reduce_fct* case_kr,
                             fast_reduce_fct* case_rk,
                             fast_reduce_fct* case_krk,
@@ -755,9 +839,10 @@ bool CommonFastReduceSwitch(OpKernelContext* ctx,
         }
         case FastReduceKind::kRK: {
           ValidateFastReduceRK(fast_shape, *output);
-          if ((fast_shape[0] > concurrency::ThreadPool::DegreeOfParallelism(ctx->GetOperatorThreadPool()) * 16) &&
-              (std::max(fast_shape[0], fast_shape[1]) >
-               concurrency::ThreadPool::DegreeOfParallelism(ctx->GetOperatorThreadPool()) * 256)) {
+          if (vectorized_fast_reduce ||
+              ((fast_shape[0] > concurrency::ThreadPool::DegreeOfParallelism(ctx->GetOperatorThreadPool()) * 16) &&
+               (std::max(fast_shape[0], fast_shape[1]) >
+                concurrency::ThreadPool::DegreeOfParallelism(ctx->GetOperatorThreadPool()) * 256))) {
             // See benchmarks in PR #7719.
             case_rk(*input, fast_shape, *output, ctx->GetOperatorThreadPool());
             return true;
@@ -767,7 +852,8 @@ bool CommonFastReduceSwitch(OpKernelContext* ctx,
         }
         case FastReduceKind::kKRK:
           ValidateFastReduceKRK(fast_shape, *output);
-          if (fast_shape[0] >= std::max(2, concurrency::ThreadPool::DegreeOfParallelism(ctx->GetOperatorThreadPool()))) {
+          if (vectorized_fast_reduce ||
+              fast_shape[0] >= std::max(2, concurrency::ThreadPool::DegreeOfParallelism(ctx->GetOperatorThreadPool()))) {
             // See benchmarks in PR #7719.
             case_krk(*input, fast_shape, *output, ctx->GetOperatorThreadPool());
             return true;
@@ -776,7 +862,8 @@ bool CommonFastReduceSwitch(OpKernelContext* ctx,
           }
         case FastReduceKind::kRKR:
           ValidateFastReduceRKR(fast_shape, *output);
-          if (fast_shape[1] >= std::max(2, concurrency::ThreadPool::DegreeOfParallelism(ctx->GetOperatorThreadPool()))) {
+          if (vectorized_fast_reduce ||
+              fast_shape[1] >= std::max(2, concurrency::ThreadPool::DegreeOfParallelism(ctx->GetOperatorThreadPool()))) {
             case_rkr(*input, fast_shape, *output, ctx->GetOperatorThreadPool());
             return true;
           } else {
@@ -805,7 +892,7 @@ bool CommonFastReduce(OpKernelContext* ctx,
                       TensorShapeVector& fast_axes) {
   return CommonFastReduceSwitch(ctx, axes_, keepdims_, noop_with_empty_axes,
                                 fast_kind, fast_shape, output_shape, fast_axes,
-                                AGG::WhichFastReduce(), &AGG::FastReduceKR, &AGG::FastReduceRK,
+                                AGG::WhichFastReduce(), AGG::IsVectorizedFastReduce(), &AGG::FastReduceKR, &AGG::FastReduceRK,
                                 &AGG::FastReduceKRK, &AGG::FastReduceRKR);
 }
 
@@ -976,8 +1063,8 @@ std::unique_ptr<Tensor> ReduceSum<T>::Impl(const Tensor& input, gsl::span<const
       }
       case FastReduceKind::kRK:
         ValidateFastReduceRK(fast_shape, *output);
-        if (std::max(fast_shape[0], fast_shape[1]) >
-            concurrency::ThreadPool::DegreeOfParallelism(tp) * 256) {
+        if (ReduceAggregatorSum<T>::IsVectorizedFastReduce() ||
+            std::max(fast_shape[0], fast_shape[1]) > concurrency::ThreadPool::DegreeOfParallelism(tp) * 256) {
           // See benchmarks in PR #7719.
           ReduceAggregatorSum<T>::FastReduceRK(input, fast_shape, *output, tp);
           return output;
@@ -986,7 +1073,8 @@ std::unique_ptr<Tensor> ReduceSum<T>::Impl(const Tensor& input, gsl::span<const
         }
       case FastReduceKind::kKRK:
         ValidateFastReduceKRK(fast_shape, *output);
-        if (fast_shape[0] >= std::max(2, concurrency::ThreadPool::DegreeOfParallelism(tp))) {
+        if (ReduceAggregatorSum<T>::IsVectorizedFastReduce() ||
+            fast_shape[0] >= std::max(2, concurrency::ThreadPool::DegreeOfParallelism(tp))) {
           // See benchmarks in PR #7719.
           ReduceAggregatorSum<T>::FastReduceKRK(input, fast_shape, *output, tp);
           return output;
@@ -995,7 +1083,8 @@ std::unique_ptr<Tensor> ReduceSum<T>::Impl(const Tensor& input, gsl::span<const
         }
       case FastReduceKind::kRKR:
         ValidateFastReduceRKR(fast_shape, *output);
-        if (fast_shape[0] >= std::max(2, concurrency::ThreadPool::DegreeOfParallelism(tp))) {
+        if (ReduceAggregatorSum<T>::IsVectorizedFastReduce() ||
+            fast_shape[0] >= std::max(2, concurrency::ThreadPool::DegreeOfParallelism(tp))) {
           ReduceAggregatorSum<T>::FastReduceRKR(input, fast_shape, *output, tp);
           return output;
         } else {
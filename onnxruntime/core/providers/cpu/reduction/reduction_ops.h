@@ -13,6 +13,7 @@
 #endif
 #include "core/util/math_cpuonly.h"
 #include "core/platform/threadpool.h"
+#include "core/mlas/inc/mlas.h"
 #include "core/common/safeint.h"
 #include <cmath>
 
@@ -68,6 +69,22 @@ FastReduceKind OptimizeShapeForFastReduce(gsl::span<const int64_t> input_shape,
                                           TensorShapeVector& fast_axes,
                                           bool keep_dims, bool noop_with_empty_axes = false);
 
+/**
+  Fast reductions of float tensors with the MLAS reduction kernels. Rows
+  are reduced with contiguous vector loads (KR), columns are reduced in
+  blocks whose partial results stay in cache while the rows are streamed
+  through (RK, KRK), and RKR reduces every kept index in two steps.
+  The aggregators apply any final transformation (mean, sqrt, log).
+*/
+void FastReduceFloatKR(MLAS_REDUCE_KIND kind, const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                       Tensor& output, concurrency::ThreadPool* tp);
+void FastReduceFloatRK(MLAS_REDUCE_KIND kind, const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                       Tensor& output, concurrency::ThreadPool* tp);
+void FastReduceFloatKRK(MLAS_REDUCE_KIND kind, const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                        Tensor& output, concurrency::ThreadPool* tp);
+void FastReduceFloatRKR(MLAS_REDUCE_KIND kind, const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                        Tensor& output, concurrency::ThreadPool* tp);
+
 class ResultsNoTransposePrepareForReduce {
  public:
   TensorShapeVector input_shape;
@@ -153,6 +170,8 @@ class ReduceAggregatorBase {
  public:
   // Fast reduction: see OptimizeShapeForFastReduce's comment.
   static inline FastReduceKind WhichFastReduce() { return FastReduceKind::kNone; }
+  // True if the fast reductions are faster than the former implementation for any shape.
+  static inline bool IsVectorizedFastReduce() { return false; }
   static void FastReduceKR(const Tensor&, const gsl::span<const int64_t>&, Tensor&, concurrency::ThreadPool*);
   static void FastReduceRK(const Tensor&, const gsl::span<const int64_t>&, Tensor&, concurrency::ThreadPool*);
   static void FastReduceKRK(const Tensor&, const gsl::span<const int64_t>&, Tensor&, concurrency::ThreadPool*);
@@ -205,6 +224,42 @@ class ReduceAggregator : public ReduceAggregatorBase {
   }
 };
 
+/* Aggregators whose fast reductions of float tensors are a single MLAS reduction. */
+template <typename T, typename TVAL, MLAS_REDUCE_KIND kind>
+class ReduceAggregatorVectorized : public ReduceAggregator<T, TVAL> {
+ public:
+  inline ReduceAggregatorVectorized(int64_t N, const T& init) : ReduceAggregator<T, TVAL>(N, init) {}
+
+  // Fast reduction
+  static inline FastReduceKind WhichFastReduce() {
+    return std::is_same<T, float>::value
+               ? FastReduceKind::kKR | FastReduceKind::kRK | FastReduceKind::kKRK | FastReduceKind::kRKR
+               : FastReduceKind::kNone;
+  }
+
+  static inline bool IsVectorizedFastReduce() { return std::is_same<T, float>::value; }
+
+  static void FastReduceKR(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                           Tensor& output, concurrency::ThreadPool* tp) {
+    FastReduceFloatKR(kind, input, fast_shape, output, tp);
+  }
+
+  static void FastReduceRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                           Tensor& output, concurrency::ThreadPool* tp) {
+    FastReduceFloatRK(kind, input, fast_shape, output, tp);
+  }
+
+  static void FastReduceKRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                            Tensor& output, concurrency::ThreadPool* tp) {
+    FastReduceFloatKRK(kind, input, fast_shape, output, tp);
+  }
+
+  static void FastReduceRKR(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                            Tensor& output, concurrency::ThreadPool* tp) {
+    FastReduceFloatRKR(kind, input, fast_shape, output, tp);
+  }
+};
+
 template <typename T>
 class ReduceAggregatorSum : public ReduceAggregator<T, T> {
  public:
@@ -222,6 +277,8 @@ class ReduceAggregatorSum : public ReduceAggregator<T, T> {
     return FastReduceKind::kKR | FastReduceKind::kRK | FastReduceKind::kKRK | FastReduceKind::kRKR;
   }
 
+  static inline bool IsVectorizedFastReduce() { return std::is_same<T, float>::value; }
+
   static void FastReduceKR(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
                            Tensor& output, concurrency::ThreadPool* tp) {
     const T* data = input.Data<T>();
@@ -283,9 +340,9 @@ class ReduceAggregatorSum : public ReduceAggregator<T, T> {
 };
 
 template <typename T, typename TVAL = T>
-class ReduceAggregatorSumSquare : public ReduceAggregator<T, TVAL> {
+class ReduceAggregatorSumSquare : public ReduceAggregatorVectorized<T, TVAL, MlasReduceSumSquare> {
  public:
-  inline ReduceAggregatorSumSquare(int64_t N, const T&) : ReduceAggregator<T, TVAL>(N, 0) {}
+  inline ReduceAggregatorSumSquare(int64_t N, const T&) : ReduceAggregatorVectorized<T, TVAL, MlasReduceSumSquare>(N, 0) {}
   inline TVAL aggall(const T* from_data) {
     return Eigen::Map<const Eigen::Matrix<T, Eigen::Dynamic, 1>>(from_data, onnxruntime::narrow<size_t>(this->N_)).squaredNorm();
   }
@@ -375,6 +432,8 @@ class ReduceAggregatorMax : public ReduceAggregator<T> {
     return FastReduceKind::kKR | FastReduceKind::kRK | FastReduceKind::kKRK | FastReduceKind::kRKR;
   }
 
+  static inline bool IsVectorizedFastReduce() { return std::is_same<T, float>::value; }
+
   static void FastReduceKR(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
                            Tensor& output, concurrency::ThreadPool* tp) {
     const T* data = input.Data<T>();
@@ -550,6 +609,8 @@ class ReduceAggregatorMin : public ReduceAggregator<T, T> {
     return FastReduceKind::kKR | FastReduceKind::kRK | FastReduceKind::kKRK | FastReduceKind::kRKR;
   }
 
+  static inline bool IsVectorizedFastReduce() { return std::is_same<T, float>::value; }
+
   static void FastReduceKR(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
                            Tensor& output, concurrency::ThreadPool* tp) {
     const T* data = input.Data<T>();
@@ -619,6 +680,35 @@ class ReduceAggregatorMin : public ReduceAggregator<T, T> {
   }
 };
 
+// Fast reductions of float tensors use the MLAS reduction kernels.
+#define REDUCE_AGGREGATOR_VECTORIZED_FAST_REDUCE(AGG, KIND)                                                   \
+  template <>                                                                                                 \
+  inline void AGG<float>::FastReduceKR(const Tensor& input, const gsl::span<const int64_t>& fast_shape,       \
+                                       Tensor& output, concurrency::ThreadPool* tp) {                         \
+    FastReduceFloatKR(KIND, input, fast_shape, output, tp);                                                   \
+  }                                                                                                           \
+  template <>                                                                                                 \
+  inline void AGG<float>::FastReduceRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,       \
+                                       Tensor& output, concurrency::ThreadPool* tp) {                         \
+    FastReduceFloatRK(KIND, input, fast_shape, output, tp);                                                   \
+  }                                                                                                           \
+  template <>                                                                                                 \
+  inline void AGG<float>::FastReduceKRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,      \
+                                        Tensor& output, concurrency::ThreadPool* tp) {                        \
+    FastReduceFloatKRK(KIND, input, fast_shape, output, tp);                                                  \
+  }                                                                                                           \
+  template <>                                                                                                 \
+  inline void AGG<float>::FastReduceRKR(const Tensor& input, const gsl::span<const int64_t>& fast_shape,      \
+                                        Tensor& output, concurrency::ThreadPool* tp) {                        \
+    FastReduceFloatRKR(KIND, input, fast_shape, output, tp);                                                  \
+  }
+
+REDUCE_AGGREGATOR_VECTORIZED_FAST_REDUCE(ReduceAggregatorSum, MlasReduceSum)
+REDUCE_AGGREGATOR_VECTORIZED_FAST_REDUCE(ReduceAggregatorMax, MlasReduceMaximum)
+REDUCE_AGGREGATOR_VECTORIZED_FAST_REDUCE(ReduceAggregatorMin, MlasReduceMinimum)
+
+#undef REDUCE_AGGREGATOR_VECTORIZED_FAST_REDUCE
+
 template <typename T>
 class ReduceAggregatorProd : public ReduceAggregator<T, T> {
  public:
@@ -630,9 +720,9 @@ class ReduceAggregatorProd : public ReduceAggregator<T, T> {
 };
 
 template <typename T>
-class ReduceAggregatorL1 : public ReduceAggregator<T, T> {
+class ReduceAggregatorL1 : public ReduceAggregatorVectorized<T, T, MlasReduceSumAbsolute> {
  public:
-  inline ReduceAggregatorL1(int64_t N, const T&) : ReduceAggregator<T, T>(N, 0) {}
+  inline ReduceAggregatorL1(int64_t N, const T&) : ReduceAggregatorVectorized<T, T, MlasReduceSumAbsolute>(N, 0) {}
   inline T aggall(const T* from_data) {
     return Eigen::Map<const Eigen::Matrix<T, Eigen::Dynamic, 1>>(from_data, onnxruntime::narrow<size_t>(this->N_)).cwiseAbs().sum();
   }
@@ -640,34 +730,100 @@ class ReduceAggregatorL1 : public ReduceAggregator<T, T> {
 };
 
 template <typename T>
-class ReduceAggregatorL2 : public ReduceAggregator<T, T> {
+class ReduceAggregatorL2 : public ReduceAggregatorVectorized<T, T, MlasReduceSumSquare> {
  public:
-  inline ReduceAggregatorL2(int64_t N, const T&) : ReduceAggregator<T, T>(N, 0) {}
+  inline ReduceAggregatorL2(int64_t N, const T&) : ReduceAggregatorVectorized<T, T, MlasReduceSumSquare>(N, 0) {}
   inline T aggall(const T* from_data) {
     return Eigen::Map<const Eigen::Matrix<T, Eigen::Dynamic, 1>>(from_data, onnxruntime::narrow<size_t>(this->N_)).norm();
   }
   inline void update(const T& v) { this->accumulator_ += v * v; }
   inline T get_value() { return reduce_sqrt<T>(this->accumulator_); }
+
+  // Fast reduction: the square root of the sum of squares.
+  static void FinalizeFastReduce(Tensor& output) {
+    T* out = output.MutableData<T>();
+    T* end = out + output.Shape().Size();
+    for (; out != end; ++out) {
+      *out = reduce_sqrt<T>(*out);
+    }
+  }
+
+  static void FastReduceKR(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                           Tensor& output, concurrency::ThreadPool* tp) {
+    ReduceAggregatorVectorized<T, T, MlasReduceSumSquare>::FastReduceKR(input, fast_shape, output, tp);
+    FinalizeFastReduce(output);
+  }
+
+  static void FastReduceRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                           Tensor& output, concurrency::ThreadPool* tp) {
+    ReduceAggregatorVectorized<T, T, MlasReduceSumSquare>::FastReduceRK(input, fast_shape, output, tp);
+    FinalizeFastReduce(output);
+  }
+
+  static void FastReduceKRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                            Tensor& output, concurrency::ThreadPool* tp) {
+    ReduceAggregatorVectorized<T, T, MlasReduceSumSquare>::FastReduceKRK(input, fast_shape, output, tp);
+    FinalizeFastReduce(output);
+  }
+
+  static void FastReduceRKR(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                            Tensor& output, concurrency::ThreadPool* tp) {
+    ReduceAggregatorVectorized<T, T, MlasReduceSumSquare>::FastReduceRKR(input, fast_shape, output, tp);
+    FinalizeFastReduce(output);
+  }
 };
 
 template <typename T>
-class ReduceAggregatorLogSum : public ReduceAggregator<T, T> {
+class ReduceAggregatorLogSum : public ReduceAggregatorVectorized<T, T, MlasReduceSum> {
  public:
-  inline ReduceAggregatorLogSum(int64_t N, const T&) : ReduceAggregator<T, T>(N, 0) {}
+  inline ReduceAggregatorLogSum(int64_t N, const T&) : ReduceAggregatorVectorized<T, T, MlasReduceSum>(N, 0) {}
   inline T aggall(const T* from_data) {
     return reduce_log<T>(Eigen::Map<const Eigen::Matrix<T, Eigen::Dynamic, 1>>(from_data, onnxruntime::narrow<size_t>(this->N_)).sum());
   }
   inline void update(const T& v) { this->accumulator_ += v; }
   inline T get_value() { return reduce_log<T>(this->accumulator_); }
+
+  // Fast reduction: the logarithm of the sum.
+  static void FinalizeFastReduce(Tensor& output) {
+    T* out = output.MutableData<T>();
+    T* end = out + output.Shape().Size();
+    for (; out != end; ++out) {
+      *out = reduce_log<T>(*out);
+    }
+  }
+
+  static void FastReduceKR(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                           Tensor& output, concurrency::ThreadPool* tp) {
+    ReduceAggregatorVectorized<T, T, MlasReduceSum>::FastReduceKR(input, fast_shape, output, tp);
+    FinalizeFastReduce(output);
+  }
+
+  static void FastReduceRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                           Tensor& output, concurrency::ThreadPool* tp) {
+    ReduceAggregatorVectorized<T, T, MlasReduceSum>::FastReduceRK(input, fast_shape, output, tp);
+    FinalizeFastReduce(output);
+  }
+
+  static void FastReduceKRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                            Tensor& output, concurrency::ThreadPool* tp) {
+    ReduceAggregatorVectorized<T, T, MlasReduceSum>::FastReduceKRK(input, fast_shape, output, tp);
+    FinalizeFastReduce(output);
+  }
+
+  static void FastReduceRKR(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                            Tensor& output, concurrency::ThreadPool* tp) {
+    ReduceAggregatorVectorized<T, T, MlasReduceSum>::FastReduceRKR(input, fast_shape, output, tp);
+    FinalizeFastReduce(output);
+  }
 };
 
 template <typename T>
-class ReduceAggregatorLogSumExp : public ReduceAggregator<T, T> {
+class ReduceAggregatorLogSumExp : public ReduceAggregatorVectorized<T, T, MlasReduceLogSumExp> {
  protected:
   T max_;
 
  public:
-  inline ReduceAggregatorLogSumExp(int64_t N, const T& init) : ReduceAggregator<T, T>(N, 0) {
+  inline ReduceAggregatorLogSumExp(int64_t N, const T& init) : ReduceAggregatorVectorized<T, T, MlasReduceLogSumExp>(N, 0) {
     max_ = reduce_isinf(init) ? this->accumulator_ : init;
   }
   inline T aggall(const T* from_data) {
@@ -3,6 +3,7 @@
 
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
+#include "core/providers/cpu/signal/fft_plan.h"
 
 namespace onnxruntime {
 
@@ -10,6 +11,7 @@ class DFT final : public OpKernel {
   bool is_onesided_ = true;
   int64_t axis_ = 0;
   bool is_inverse_ = false;
+  mutable signal::FFTPlanCache plan_cache_;
 
  public:
   explicit DFT(const OpKernelInfo& info) : OpKernel(info) {
@@ -22,6 +24,7 @@ class DFT final : public OpKernel {
 
 class STFT final : public OpKernel {
   bool is_onesided_ = true;
+  mutable signal::FFTPlanCache plan_cache_;
 
  public:
   explicit STFT(const OpKernelInfo& info) : OpKernel(info) {
@@ -0,0 +1,384 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cpu/signal/fft_plan.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#include "core/common/common.h"
+
+namespace onnxruntime {
+namespace signal {
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+
+// Returns exp(i * angle) computed in double precision, so the float twiddle factors are correctly rounded.
+template <typename T>
+std::complex<T> unit_phasor(double angle) {
+  return std::complex<T>(static_cast<T>(std::cos(angle)), static_cast<T>(std::sin(angle)));
+}
+
+// Multiplies without the NaN and infinity recovery of std::complex operator*, which compilers otherwise emit as a
+// library call per product.
+template <typename T>
+std::complex<T> multiply(const std::complex<T>& a, const std::complex<T>& b) {
+  return std::complex<T>(a.real() * b.real() - a.imag() * b.imag(), a.real() * b.imag() + a.imag() * b.real());
+}
+
+// Multiplies by -i.
+template <typename T>
+std::complex<T> multiply_by_minus_i(const std::complex<T>& value) {
+  return std::complex<T>(value.imag(), -value.real());
+}
+
+size_t next_power_of_2(size_t value) {
+  size_t result = 1;
+  while (result < value) {
+    result <<= 1;
+  }
+  return result;
+}
+
+}  // namespace
+
+template <typename T>
+ComplexFFT<T>::ComplexFFT(size_t length, bool inverse) : length_(length), inverse_(inverse) {
+  // Bluestein would need a transform of 2 * length - 1 elements, which doesn't exist for an empty signal.
+  ORT_ENFORCE(length > 0, "The FFT length must be greater than zero.");
+
+  // Radix 4 first: it needs fewer multiplications per element than two radix 2 stages.
+  static constexpr size_t kRadixes[] = {4, 2, 3, 5};
+  size_t remaining = length;
+  for (size_t radix : kRadixes) {
+    while (remaining > 1 && remaining % radix == 0) {
+      remaining /= radix;
+      stages_.push_back({radix, remaining});
+    }
+  }
+
+  const double direction = inverse ? 1.0 : -1.0;
+
+  if (remaining == 1) {
+    twiddles_.resize(length);
+    for (size_t i = 0; i < length; i++) {
+      twiddles_[i] = unit_phasor<T>(direction * 2 * kPi * static_cast<double>(i) / static_cast<double>(length));
+    }
+    return;
+  }
+
+  // Bluestein: the DFT is computed as a circular convolution with a chirp, and the convolution is computed with a
+  // forward power of 2 transform of at least 2 * length - 1 elements.
+  stages_.clear();
+
+  const size_t convolution_length = next_power_of_2(2 * length - 1);
+  convolution_fft_ = std::make_unique<ComplexFFT<T>>(convolution_length, false);
+
+  chirp_.resize(length);
+  for (size_t n = 0; n < length; n++) {
+    // Reduce n^2 modulo 2 * length to keep the angle small for long transforms.
+    const size_t n_squared = static_cast<size_t>((static_cast<uint64_t>(n) * n) % (2 * static_cast<uint64_t>(length)));
+    chirp_[n] = unit_phasor<T>(direction * kPi * static_cast<double>(n_squared) / static_cast<double>(length));
+  }
+
+  // The transform of the kernel absorbs the 1 / convolution_length scaling of the inverse transform.
+  const T scale = static_cast<T>(1) / static_cast<T>(convolution_length);
+  std::vector<std::complex<T>> kernel(convolution_length);
+  kernel[0] = std::conj(chirp_[0]) * scale;
+  for (size_t n = 1; n < length; n++) {
+    kernel[n] = std::conj(chirp_[n]) * scale;
+    kernel[convolution_length - n] = kernel[n];
+  }
+
+  kernel_fft_.resize(convolution_length);
+  convolution_fft_->Execute(kernel.data(), kernel_fft_.data(), nullptr);
+}
+
+template <typename T>
+size_t ComplexFFT<T>::ScratchSize() const {
+  return convolution_fft_ ? 2 * convolution_fft_->Length() : 0;
+}
+
+template <typename T>
+void ComplexFFT<T>::Execute(const std::complex<T>* input, std::complex<T>* output, std::complex<T>* scratch) const {
+  if (convolution_fft_) {
+    ExecuteBluestein(input, output, scratch);
+  } else if (stages_.empty()) {
+    output[0] = input[0];
+  } else {
+    Work(output, input, 1, 0);
+  }
+}
+
+template <typename T>
+void ComplexFFT<T>::ExecuteBluestein(const std::complex<T>* input, std::complex<T>* output,
+                                     std::complex<T>* scratch) const {
+  const size_t convolution_length = convolution_fft_->Length();
+  std::complex<T>* a = scratch;
+  std::complex<T>* a_fft = scratch + convolution_length;
+
+  for (size_t n = 0; n < length_; n++) {
+    a[n] = multiply(input[n], chirp_[n]);
+  }
+  std::fill(a + length_, a + convolution_length, std::complex<T>(0, 0));
+
+  convolution_fft_->Execute(a, a_fft, nullptr);
+
+  // The inverse transform of the product is computed as the conjugate of the forward transform of its conjugate.
+  for (size_t k = 0; k < convolution_length; k++) {
+    a_fft[k] = std::conj(multiply(a_fft[k], kernel_fft_[k]));
+  }
+
+  convolution_fft_->Execute(a_fft, a, nullptr);
+
+  for (size_t k = 0; k < length_; k++) {
+    output[k] = multiply(chirp_[k], std::conj(a[k]));
+  }
+}
+
+// Decimation in time: the `radix` sub-transforms of the inputs `fstride` apart are computed into consecutive blocks
+// of the output, then combined in place by the butterfly of the stage.
+template <typename T>
+void ComplexFFT<T>::Work(std::complex<T>* output, const std::complex<T>* input, size_t fstride, size_t stage) const {
+  const size_t radix = stages_[stage].radix;
+  const size_t m = stages_[stage].length;
+
+  std::complex<T>* out = output;
+  std::complex<T>* const out_end = output + radix * m;
+
+  if (m == 1) {
+    for (; out != out_end; ++out) {
+      *out = *input;
+      input += fstride;
+    }
+  } else {
+    for (; out != out_end; out += m) {
+      Work(out, input, fstride * radix, stage + 1);
+      input += fstride;
+    }
+  }
+
+  switch (radix) {
+    case 2:
+      Butterfly2(output, fstride, m);
+      break;
+    case 3:
+      Butterfly3(output, fstride, m);
+      break;
+    case 4:
+      Butterfly4(output, fstride, m);
+      break;
+    default:
+      Butterfly5(output, fstride, m);
+      break;
+  }
+}
+
+template <typename T>
+void ComplexFFT<T>::Butterfly2(std::complex<T>* output, size_t fstride, size_t m) const {
+  std::complex<T>* output1 = output + m;
+  for (size_t k = 0; k < m; k++) {
+    const std::complex<T> t = multiply(output1[k], twiddles_[k * fstride]);
+    output1[k] = output[k] - t;
+    output[k] += t;
+  }
+}
+
+template <typename T>
+void ComplexFFT<T>::Butterfly3(std::complex<T>* output, size_t fstride, size_t m) const {
+  const T sin_third = twiddles_[fstride * m].imag();
+  std::complex<T>* output1 = output + m;
+  std::complex<T>* output2 = output + 2 * m;
+
+  for (size_t k = 0; k < m; k++) {
+    const std::complex<T> s1 = multiply(output1[k], twiddles_[k * fstride]);
+    const std::complex<T> s2 = multiply(output2[k], twiddles_[2 * k * fstride]);
+    const std::complex<T> sum = s1 + s2;
+    const std::complex<T> difference = (s1 - s2) * sin_third;
+
+    const std::complex<T> middle = output[k] - sum * static_cast<T>(0.5);
+    output[k] += sum;
+    output1[k] = std::complex<T>(middle.real() - difference.imag(), middle.imag() + difference.real());
+    output2[k] = std::complex<T>(middle.real() + difference.imag(), middle.imag() - difference.real());
+  }
+}
+
+template <typename T>
+void ComplexFFT<T>::Butterfly4(std::complex<T>* output, size_t fstride, size_t m) const {
+  std::complex<T>* output1 = output + m;
+  std::complex<T>* output2 = output + 2 * m;
+  std::complex<T>* output3 = output + 3 * m;
+
+  for (size_t k = 0; k < m; k++) {
+    const std::complex<T> s0 = multiply(output1[k], twiddles_[k * fstride]);
+    const std::complex<T> s1 = multiply(output2[k], twiddles_[2 * k * fstride]);
+    const std::complex<T> s2 = multiply(output3[k], twiddles_[3 * k * fstride]);
+
+    const std::complex<T> s5 = output[k] - s1;
+    const std::complex<T> s6 = output[k] + s1;
+    const std::complex<T> s3 = s0 + s2;
+    const std::complex<T> s4 = s0 - s2;
+
+    output[k] = s6 + s3;
+    output2[k] = s6 - s3;
+    if (inverse_) {
+      output1[k] = std::complex<T>(s5.real() - s4.imag(), s5.imag() + s4.real());
+      output3[k] = std::complex<T>(s5.real() + s4.imag(), s5.imag() - s4.real());
+    } else {
+      output1[k] = std::complex<T>(s5.real() + s4.imag(), s5.imag() - s4.real());
+      output3[k] = std::complex<T>(s5.real() - s4.imag(), s5.imag() + s4.real());
+    }
+  }
+}
+
+template <typename T>
+void ComplexFFT<T>::Butterfly5(std::complex<T>* output, size_t fstride, size_t m) const {
+  const std::complex<T> ya = twiddles_[fstride * m];
+  const std::complex<T> yb = twiddles_[fstride * 2 * m];
+  std::complex<T>* output1 = output + m;
+  std::complex<T>* output2 = output + 2 * m;
+  std::complex<T>* output3 = output + 3 * m;
+  std::complex<T>* output4 = output + 4 * m;
+
+  for (size_t k = 0; k < m; k++) {
+    const std::complex<T> s0 = output[k];
+    const std::complex<T> s1 = multiply(output1[k], twiddles_[k * fstride]);
+    const std::complex<T> s2 = multiply(output2[k], twiddles_[2 * k * fstride]);
+    const std::complex<T> s3 = multiply(output3[k], twiddles_[3 * k * fstride]);
+    const std::complex<T> s4 = multiply(output4[k], twiddles_[4 * k * fstride]);
+
+    const std::complex<T> s7 = s1 + s4;
+    const std::complex<T> s10 = s1 - s4;
+    const std::complex<T> s8 = s2 + s3;
+    const std::complex<T> s9 = s2 - s3;
+
+    output[k] = s0 + s7 + s8;
+
+    const std::complex<T> s5 = s0 + s7 * ya.real() + s8 * yb.real();
+    const std::complex<T> s6(s10.imag() * ya.imag() + s9.imag() * yb.imag(),
+                             -s10.real() * ya.imag() - s9.real() * yb.imag());
+    output1[k] = s5 - s6;
+    output4[k] = s5 + s6;
+
+    const std::complex<T> s11 = s0 + s7 * yb.real() + s8 * ya.real();
+    const std::complex<T> s12(-s10.imag() * yb.imag() + s9.imag() * ya.imag(),
+                              s10.real() * yb.imag() - s9.real() * ya.imag());
+    output2[k] = s11 + s12;
+    output3[k] = s11 - s12;
+  }
+}
+
+template <typename T>
+FFTPlan<T>::FFTPlan(size_t length, bool inverse, bool real_input) : length_(length), inverse_(inverse) {
+  if (real_input && length % 2 == 0) {
+    const size_t half_length = length / 2;
+    half_fft_ = std::make_unique<ComplexFFT<T>>(half_length, inverse);
+
+    const double direction = inverse ? 1.0 : -1.0;
+    split_twiddles_.resize(half_length + 1);
+    for (size_t k = 0; k <= half_length; k++) {
+      split_twiddles_[k] = unit_phasor<T>(direction * 2 * kPi * static_cast<double>(k) / static_cast<double>(length));
+    }
+  } else {
+    fft_ = std::make_unique<ComplexFFT<T>>(length, inverse);
+  }
+}
+
+template <typename T>
+size_t FFTPlan<T>::ScratchSize() const {
+  if (half_fft_) {
+    return half_fft_->Length() + half_fft_->ScratchSize();
+  }
+  return length_ + fft_->ScratchSize();
+}
+
+template <typename T>
+void FFTPlan<T>::Transform(const std::complex<T>* input, std::complex<T>* output, std::complex<T>* scratch) const {
+  fft_->Execute(input, output, scratch);
+
+  if (inverse_) {
+    const T scale = static_cast<T>(1) / static_cast<T>(length_);
+    for (size_t i = 0; i < length_; i++) {
+      output[i] *= scale;
+    }
+  }
+}
+
+template <typename T>
+void FFTPlan<T>::TransformReal(const T* input, std::complex<T>* output, std::complex<T>* scratch) const {
+  size_t output_count;
+
+  if (half_fft_) {
+    // Pack the even and odd samples as the real and imaginary parts of a half length signal z. The transforms E and
+    // O of the even and odd samples are Hermitian, so they are recovered from Z = E + iO and X[k] = E[k] + w^k O[k].
+    const size_t half_length = half_fft_->Length();
+    std::complex<T>* z_fft = scratch;
+    half_fft_->Execute(reinterpret_cast<const std::complex<T>*>(input), z_fft, scratch + half_length);
+
+    for (size_t k = 0; k <= half_length; k++) {
+      const std::complex<T> z_k = z_fft[k == half_length ? 0 : k];
+      const std::complex<T> z_conj = std::conj(z_fft[k == 0 ? 0 : half_length - k]);
+      const std::complex<T> even = (z_k + z_conj) * static_cast<T>(0.5);
+      const std::complex<T> odd = multiply_by_minus_i((z_k - z_conj) * static_cast<T>(0.5));
+      output[k] = even + multiply(split_twiddles_[k], odd);
+    }
+    output_count = half_length + 1;
+  } else {
+    std::complex<T>* complex_input = scratch;
+    for (size_t i = 0; i < length_; i++) {
+      complex_input[i] = std::complex<T>(input[i], 0);
+    }
+    fft_->Execute(complex_input, output, scratch + length_);
+    output_count = length_;
+  }
+
+  if (inverse_) {
+    const T scale = static_cast<T>(1) / static_cast<T>(length_);
+    for (size_t i = 0; i < output_count; i++) {
+      output[i] *= scale;
+    }
+  }
+}
+
+template <>
+std::map<FFTPlanCache::Key, std::shared_ptr<const FFTPlan<float>>>& FFTPlanCache::Plans<float>() {
+  return float_plans_;
+}
+
+template <>
+std::map<FFTPlanCache::Key, std::shared_ptr<const FFTPlan<double>>>& FFTPlanCache::Plans<double>() {
+  return double_plans_;
+}
+
+template <typename T>
+std::shared_ptr<const FFTPlan<T>> FFTPlanCache::Get(size_t length, bool inverse, bool real_input) {
+  std::lock_guard<OrtMutex> lock(mutex_);
+
+  auto& plans = Plans<T>();
+  const Key key{length, inverse, real_input};
+  auto it = plans.find(key);
+  if (it != plans.end()) {
+    return it->second;
+  }
+
+  if (plans.size() >= kMaxPlans) {
+    plans.clear();
+  }
+
+  auto plan = std::make_shared<const FFTPlan<T>>(length, inverse, real_input);
+  plans.emplace(key, plan);
+  return plan;
+}
+
+template class ComplexFFT<float>;
+template class ComplexFFT<double>;
+template class FFTPlan<float>;
+template class FFTPlan<double>;
+template std::shared_ptr<const FFTPlan<float>> FFTPlanCache::Get<float>(size_t, bool, bool);
+template std::shared_ptr<const FFTPlan<double>> FFTPlanCache::Get<double>(size_t, bool, bool);
+
+}  // namespace signal
+}  // namespace onnxruntime
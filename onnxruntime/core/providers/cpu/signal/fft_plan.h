@@ -0,0 +1,106 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <complex>
+#include <map>
+#include <memory>
+#include <tuple>
+#include <vector>
+
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+namespace signal {
+
+// Unnormalized complex FFT of a fixed length. Lengths whose prime factors are 2, 3 and 5 use a mixed-radix
+// (4/2/3/5) Cooley-Tukey decomposition with precomputed twiddle factors; other lengths use Bluestein's algorithm
+// on top of a power of 2 transform.
+template <typename T>
+class ComplexFFT {
+ public:
+  ComplexFFT(size_t length, bool inverse);
+
+  size_t Length() const { return length_; }
+
+  // Number of complex elements of the scratch buffer passed to Execute.
+  size_t ScratchSize() const;
+
+  // Transforms `Length()` contiguous values. `input` and `output` must not overlap.
+  void Execute(const std::complex<T>* input, std::complex<T>* output, std::complex<T>* scratch) const;
+
+ private:
+  struct Stage {
+    size_t radix;
+    size_t length;  // length of each of the `radix` sub-transforms
+  };
+
+  void Work(std::complex<T>* output, const std::complex<T>* input, size_t fstride, size_t stage) const;
+  void Butterfly2(std::complex<T>* output, size_t fstride, size_t m) const;
+  void Butterfly3(std::complex<T>* output, size_t fstride, size_t m) const;
+  void Butterfly4(std::complex<T>* output, size_t fstride, size_t m) const;
+  void Butterfly5(std::complex<T>* output, size_t fstride, size_t m) const;
+  void ExecuteBluestein(const std::complex<T>* input, std::complex<T>* output, std::complex<T>* scratch) const;
+
+  size_t length_;
+  bool inverse_;
+  std::vector<Stage> stages_;
+  std::vector<std::complex<T>> twiddles_;
+
+  // Bluestein state: the chirp, the transform of the convolution kernel and the power of 2 transform.
+  std::vector<std::complex<T>> chirp_;
+  std::vector<std::complex<T>> kernel_fft_;
+  std::unique_ptr<ComplexFFT<T>> convolution_fft_;
+};
+
+// DFT of a fixed length, scaled by 1/length for the inverse transform. Real input of even length is transformed
+// as a complex signal of half the length followed by a split step.
+template <typename T>
+class FFTPlan {
+ public:
+  FFTPlan(size_t length, bool inverse, bool real_input);
+
+  size_t Length() const { return length_; }
+
+  // Number of complex elements of the scratch buffer passed to Transform and TransformReal.
+  size_t ScratchSize() const;
+
+  // Transforms `Length()` complex values into `Length()` complex values.
+  void Transform(const std::complex<T>* input, std::complex<T>* output, std::complex<T>* scratch) const;
+
+  // Transforms `Length()` real values into the `Length() / 2 + 1` non-redundant complex values. `output` must have
+  // room for `Length()` values. Requires a plan created with `real_input`.
+  void TransformReal(const T* input, std::complex<T>* output, std::complex<T>* scratch) const;
+
+ private:
+  size_t length_;
+  bool inverse_;
+  std::unique_ptr<ComplexFFT<T>> fft_;       // full length transform, used for complex or odd length real input
+  std::unique_ptr<ComplexFFT<T>> half_fft_;  // half length transform for even length real input
+  std::vector<std::complex<T>> split_twiddles_;
+};
+
+// Cache of the plans created by a kernel, so the factorization and the twiddle factors are computed once per
+// transform length instead of on every call. Plans are immutable and may be shared by concurrent runs.
+class FFTPlanCache {
+ public:
+  template <typename T>
+  std::shared_ptr<const FFTPlan<T>> Get(size_t length, bool inverse, bool real_input);
+
+ private:
+  // Bounds the memory held by a kernel that sees many different lengths.
+  static constexpr size_t kMaxPlans = 16;
+
+  using Key = std::tuple<size_t, bool, bool>;
+
+  template <typename T>
+  std::map<Key, std::shared_ptr<const FFTPlan<T>>>& Plans();
+
+  OrtMutex mutex_;
+  std::map<Key, std::shared_ptr<const FFTPlan<float>>> float_plans_;
+  std::map<Key, std::shared_ptr<const FFTPlan<double>>> double_plans_;
+};
+
+}  // namespace signal
+}  // namespace onnxruntime
@@ -0,0 +1,170 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cpu/string_table.h"
+
+#include <algorithm>
+#include <numeric>
+
+#include "core/common/common.h"
+
+namespace onnxruntime {
+
+namespace {
+// Average number of keys per bucket. Larger buckets need fewer pilots but take longer to place.
+constexpr size_t kKeysPerBucket = 2;
+constexpr size_t kMaxBuildAttempts = 32;
+}  // namespace
+
+PerfectHash::PerfectHash(gsl::span<const uint64_t> keys) {
+  const size_t num_keys = keys.size();
+  if (num_keys == 0) {
+    return;
+  }
+  ORT_ENFORCE(num_keys < std::numeric_limits<uint32_t>::max(), "Too many keys for a perfect hash: ", num_keys);
+
+  const size_t num_buckets = num_keys / kKeysPerBucket + 1;
+  size_t num_slots = num_keys + num_keys / 32 + 1;
+  for (size_t attempt = 0; attempt < kMaxBuildAttempts; ++attempt) {
+    seed_ = Mix(attempt + 1);
+    if (TryBuild(keys, num_buckets, num_slots)) {
+      num_slots_ = num_slots;
+      return;
+    }
+    num_slots += num_slots / 16 + 1;
+  }
+  ORT_THROW("Failed to build a perfect hash over ", num_keys, " keys. The keys must be distinct.");
+}
+
+bool PerfectHash::TryBuild(gsl::span<const uint64_t> keys, size_t num_buckets, size_t num_slots) {
+  const size_t num_keys = keys.size();
+  pilots_.assign(num_buckets, 0);
+
+  // Group the keys by bucket.
+  std::vector<uint32_t> bucket_start(num_buckets + 1, 0);
+  std::vector<uint32_t> key_bucket(num_keys);
+  for (size_t i = 0; i < num_keys; ++i) {
+    key_bucket[i] = static_cast<uint32_t>(Reduce(Mix(keys[i] ^ seed_), num_buckets));
+    ++bucket_start[key_bucket[i] + 1];
+  }
+  std::partial_sum(bucket_start.begin(), bucket_start.end(), bucket_start.begin());
+  std::vector<uint32_t> bucket_keys(num_keys);
+  {
+    std::vector<uint32_t> fill(bucket_start.begin(), bucket_start.end() - 1);
+    for (size_t i = 0; i < num_keys; ++i) {
+      bucket_keys[fill[key_bucket[i]]++] = static_cast<uint32_t>(i);
+    }
+  }
+
+  // Place the largest buckets first while most slots are still free.
+  std::vector<uint32_t> bucket_order(num_buckets);
+  std::iota(bucket_order.begin(), bucket_order.end(), 0);
+  std::stable_sort(bucket_order.begin(), bucket_order.end(), [&bucket_start](uint32_t a, uint32_t b) {
+    return bucket_start[a + 1] - bucket_start[a] > bucket_start[b + 1] - bucket_start[b];
+  });
+
+  std::vector<uint8_t> taken(num_slots, 0);
+  std::vector<size_t> positions;
+  for (uint32_t bucket : bucket_order) {
+    const uint32_t* first = bucket_keys.data() + bucket_start[bucket];
+    const uint32_t* last = bucket_keys.data() + bucket_start[bucket + 1];
+    if (first == last) {
+      break;
+    }
+
+    bool placed = false;
+    for (uint32_t pilot = 0; pilot <= std::numeric_limits<uint16_t>::max() && !placed; ++pilot) {
+      positions.clear();
+      placed = true;
+      for (const uint32_t* key = first; key != last; ++key) {
+        const size_t position = Position(keys[*key], static_cast<uint16_t>(pilot), num_slots);
+        if (taken[position] || std::find(positions.begin(), positions.end(), position) != positions.end()) {
+          placed = false;
+          break;
+        }
+        positions.push_back(position);
+      }
+      if (placed) {
+        pilots_[bucket] = static_cast<uint16_t>(pilot);
+        for (size_t position : positions) {
+          taken[position] = 1;
+        }
+      }
+    }
+    if (!placed) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+StringTable::StringTable(const std::vector<std::string>& strings) {
+  std::vector<std::string_view> views(strings.begin(), strings.end());
+  Build(views);
+}
+
+StringTable::StringTable(const std::vector<std::reference_wrapper<const std::string>>& strings) {
+  std::vector<std::string_view> views;
+  views.reserve(strings.size());
+  for (const std::string& str : strings) {
+    views.emplace_back(str);
+  }
+  Build(views);
+}
+
+void StringTable::Build(const std::vector<std::string_view>& strings) {
+  if (strings.empty()) {
+    return;
+  }
+
+  std::vector<uint64_t> hashes(strings.size());
+  std::vector<uint32_t> order(strings.size());
+  std::vector<uint32_t> unique;
+  for (size_t attempt = 0;; ++attempt) {
+    ORT_ENFORCE(attempt < kMaxBuildAttempts, "Failed to find a string hash seed without collisions.");
+    seed_ = PerfectHash::Mix(attempt + 1);
+    for (size_t i = 0; i < strings.size(); ++i) {
+      hashes[i] = Hash(strings[i], seed_);
+    }
+
+    // Drop the duplicates. Distinct strings with the same hash are resolved by hashing again with another seed.
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&hashes](uint32_t a, uint32_t b) { return hashes[a] < hashes[b]; });
+    unique.clear();
+    bool collision = false;
+    for (size_t i = 0; i < order.size() && !collision; ++i) {
+      if (i == 0 || hashes[order[i]] != hashes[order[i - 1]]) {
+        unique.push_back(order[i]);
+      } else {
+        collision = strings[order[i]] != strings[unique.back()];
+      }
+    }
+    if (!collision) {
+      break;
+    }
+  }
+  // Lay the strings out in the order of the input.
+  std::sort(unique.begin(), unique.end());
+
+  size_t arena_size = 0;
+  std::vector<uint64_t> unique_hashes;
+  unique_hashes.reserve(unique.size());
+  for (uint32_t i : unique) {
+    arena_size += strings[i].size();
+    unique_hashes.push_back(hashes[i]);
+  }
+  ORT_ENFORCE(arena_size < kUnusedLength, "The strings of a StringTable must be smaller than 4GB in total.");
+
+  size_ = unique.size();
+  hash_ = PerfectHash(unique_hashes);
+  entries_.assign(hash_.NumSlots(), {0, 0, kUnusedLength});
+  arena_.reserve(arena_size);
+  for (uint32_t i : unique) {
+    entries_[hash_.Slot(hashes[i])] = {hashes[i], static_cast<uint32_t>(arena_.size()),
+                                       static_cast<uint32_t>(strings[i].size())};
+    arena_.append(strings[i].data(), strings[i].size());
+  }
+}
+
+}  // namespace onnxruntime
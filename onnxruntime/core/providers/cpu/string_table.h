@@ -0,0 +1,174 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "core/common/gsl.h"
+
+namespace onnxruntime {
+
+// Perfect hash over a fixed set of distinct 64-bit keys, built with hash and displace: keys are grouped into small
+// buckets and each bucket stores the pilot that sends all its keys to free slots. Only the pilots are stored, so
+// users lay out their entries by slot and compare the key stored in the slot of a lookup. There are a few percent
+// more slots than keys to keep the construction fast.
+class PerfectHash {
+ public:
+  PerfectHash() = default;
+
+  // `keys` must be distinct.
+  explicit PerfectHash(gsl::span<const uint64_t> keys);
+
+  size_t NumSlots() const { return num_slots_; }
+
+  // Requires NumSlots() > 0.
+  size_t Slot(uint64_t key) const {
+    const uint16_t pilot = pilots_[Reduce(Mix(key ^ seed_), pilots_.size())];
+    return Position(key, pilot, num_slots_);
+  }
+
+  // Bijective finalizer of splitmix64.
+  static uint64_t Mix(uint64_t x) {
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+  }
+
+ private:
+  bool TryBuild(gsl::span<const uint64_t> keys, size_t num_buckets, size_t num_slots);
+
+  size_t Position(uint64_t key, uint16_t pilot, size_t num_slots) const {
+    return Reduce(Mix((key ^ seed_) + (uint64_t{pilot} + 1) * 0x9e3779b97f4a7c15ULL), num_slots);
+  }
+
+  // Maps the high 32 bits of a hash to [0, range).
+  static size_t Reduce(uint64_t hash, size_t range) {
+    return static_cast<size_t>(((hash >> 32) * range) >> 32);
+  }
+
+  uint64_t seed_ = 0;
+  size_t num_slots_ = 0;
+  std::vector<uint16_t> pilots_;
+};
+
+// Immutable map from distinct 64-bit keys to values. Each slot holds a key next to its value, so a lookup reads one
+// pilot and one entry.
+template <typename TValue>
+class PerfectHashMap {
+ public:
+  PerfectHashMap() = default;
+
+  // `entries` must have distinct keys. Missing keys are mapped to `default_value`.
+  PerfectHashMap(const std::vector<std::pair<uint64_t, TValue>>& entries, TValue default_value)
+      : default_value_(default_value) {
+    std::vector<uint64_t> keys;
+    keys.reserve(entries.size());
+    for (const auto& entry : entries) {
+      keys.push_back(entry.first);
+    }
+    hash_ = PerfectHash(keys);
+    // Unused slots hold the default value, so their key doesn't matter.
+    slots_.assign(hash_.NumSlots(), {0, default_value});
+    for (const auto& entry : entries) {
+      slots_[hash_.Slot(entry.first)] = entry;
+    }
+  }
+
+  bool Empty() const { return slots_.empty(); }
+
+  TValue Find(uint64_t key) const {
+    if (slots_.empty()) {
+      return default_value_;
+    }
+    const auto& slot = slots_[hash_.Slot(key)];
+    return slot.first == key ? slot.second : default_value_;
+  }
+
+ private:
+  PerfectHash hash_;
+  std::vector<std::pair<uint64_t, TValue>> slots_;
+  TValue default_value_{};
+};
+
+// Immutable set of distinct strings stored back to back in a single buffer. The id of a string is the slot of its
+// hash in a PerfectHash, so ids are below IdBound() and a few of them are unused. A lookup hashes the string once,
+// reads one pilot and one entry, and only compares bytes when the stored 64-bit hash and the length match.
+class StringTable {
+ public:
+  static constexpr uint32_t kNotFound = std::numeric_limits<uint32_t>::max();
+
+  StringTable() = default;
+  explicit StringTable(const std::vector<std::string>& strings);
+  explicit StringTable(const std::vector<std::reference_wrapper<const std::string>>& strings);
+
+  // Number of distinct strings.
+  size_t Size() const { return size_; }
+  bool Empty() const { return size_ == 0; }
+
+  size_t IdBound() const { return entries_.size(); }
+
+  std::string_view Get(uint32_t id) const {
+    return std::string_view(arena_.data() + entries_[id].offset, entries_[id].length);
+  }
+
+  // Returns the id of `str` or kNotFound.
+  uint32_t Find(std::string_view str) const {
+    if (entries_.empty()) {
+      return kNotFound;
+    }
+    const uint64_t hash = Hash(str, seed_);
+    const size_t slot = hash_.Slot(hash);
+    const Entry& entry = entries_[slot];
+    return entry.hash == hash && entry.length == str.size() &&
+                   std::memcmp(arena_.data() + entry.offset, str.data(), str.size()) == 0
+               ? static_cast<uint32_t>(slot)
+               : kNotFound;
+  }
+
+ private:
+  void Build(const std::vector<std::string_view>& strings);
+
+  static uint64_t Hash(std::string_view str, uint64_t seed) {
+    const char* p = str.data();
+    size_t n = str.size();
+    uint64_t h = seed ^ (uint64_t{n} * 0x9e3779b97f4a7c15ULL);
+    while (n >= 8) {
+      uint64_t word;
+      std::memcpy(&word, p, 8);
+      h = (h ^ (word * 0xff51afd7ed558ccdULL)) * 0xc4ceb9fe1a85ec53ULL;
+      h ^= h >> 29;
+      p += 8;
+      n -= 8;
+    }
+    if (n > 0) {
+      uint64_t word = 0;
+      std::memcpy(&word, p, n);
+      h = (h ^ (word * 0xff51afd7ed558ccdULL)) * 0xc4ceb9fe1a85ec53ULL;
+    }
+    return PerfectHash::Mix(h);
+  }
+
+  // Unused slots have a length that no stored string can have.
+  struct Entry {
+    uint64_t hash;
+    uint32_t offset;
+    uint32_t length;
+  };
+  static constexpr uint32_t kUnusedLength = std::numeric_limits<uint32_t>::max();
+
+  uint64_t seed_ = 0;
+  size_t size_ = 0;
+  std::string arena_;
+  std::vector<Entry> entries_;
+  PerfectHash hash_;
+};
+
+}  // namespace onnxruntime
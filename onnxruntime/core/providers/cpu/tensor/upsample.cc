@@ -1,7 +1,10 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
+
 #include "core/common/safeint.h"
+#include "core/mlas/inc/mlas.h"
 #include "core/platform/threadpool.h"
 #include "core/providers/cpu/tensor/upsample.h"
 #include "core/providers/cpu/tensor/upsample_antialias.h"
@@ -146,7 +149,8 @@ static Status UpsampleNearestImpl(const T* input,
                                   bool extrapolation_enabled,
                                   const T extrapolation_value,
                                   const GetOriginalCoordinateFunc& get_original_coordinate,
-                                  const GetNearestPixelFunc& get_nearest_pixel) {
+                                  const GetNearestPixelFunc& get_nearest_pixel,
+                                  concurrency::ThreadPool* tp) {
   int64_t n_dim = static_cast<int64_t>(input_shape.NumDimensions());
 
   std::vector<int64_t> input_dim_counters(narrow<size_t>(n_dim));
@@ -217,20 +221,37 @@ static Status UpsampleNearestImpl(const T* input,
     const std::vector<int64_t>& input_mapping_1 = input_mappings[1];
     const std::vector<int64_t>& input_mapping_2 = input_mappings[2];
     const std::vector<int64_t>& input_mapping_3 = input_mappings[3];
+    const int64_t output_dim3 = output_shape[3];
+
+    // The rows of the innermost dimension are partitioned across the threadpool. An output row that reads the
+    // same input row as the previous one is a copy of it.
+    concurrency::ThreadPool::TryParallelFor(
+        tp, static_cast<std::ptrdiff_t>(output_shape[0] * output_shape[1] * output_shape[2]),
+        static_cast<double>(output_dim3 * 2),
+        [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+          int64_t previous_input_row = -1;
+          for (std::ptrdiff_t row = first; row < last; ++row) {
+            const int64_t output_dim2_inx = row % output_shape[2];
+            const int64_t output_dim1_inx = (row / output_shape[2]) % output_shape[1];
+            const int64_t output_dim0_inx = row / output_shape[2] / output_shape[1];
+            const int64_t input_row = input_mapping_0[narrow<size_t>(output_dim0_inx)] +
+                                      input_mapping_1[narrow<size_t>(output_dim1_inx)] +
+                                      input_mapping_2[narrow<size_t>(output_dim2_inx)];
+            T* output_row = output + row * output_dim3;
+
+            if (row != first && input_row == previous_input_row) {
+              std::copy_n(output_row - output_dim3, narrow<size_t>(output_dim3), output_row);
+              continue;
+            }
+            previous_input_row = input_row;
 
-    for (int64_t output_dim0_inx = 0; output_dim0_inx < output_shape[0]; output_dim0_inx++) {
-      int64_t input_idx_0 = input_mapping_0[narrow<size_t>(output_dim0_inx)];
-      for (int64_t output_dim1_inx = 0; output_dim1_inx < output_shape[1]; output_dim1_inx++) {
-        int64_t input_idx_1 = input_idx_0 + input_mapping_1[narrow<size_t>(output_dim1_inx)];
-        for (int64_t output_dim2_inx = 0; output_dim2_inx < output_shape[2]; output_dim2_inx++) {
-          int64_t input_idx_2 = input_idx_1 + input_mapping_2[narrow<size_t>(output_dim2_inx)];
-          for (int64_t output_dim3_inx = 0; output_dim3_inx < output_shape[3]; output_dim3_inx++) {
-            int64_t input_idx_3 = input_idx_2 + input_mapping_3[narrow<size_t>(output_dim3_inx)];
-            output[output_idx++] = (input_idx_3 < 0) ? static_cast<T>(extrapolation_value) : input[narrow<size_t>(input_idx_3)];
+            for (int64_t output_dim3_inx = 0; output_dim3_inx < output_dim3; output_dim3_inx++) {
+              int64_t input_idx_3 = input_row + input_mapping_3[narrow<size_t>(output_dim3_inx)];
+              output_row[output_dim3_inx] = (input_idx_3 < 0) ? static_cast<T>(extrapolation_value)
+                                                              : input[narrow<size_t>(input_idx_3)];
+            }
           }
-        }
-      }
-    }
+        });
     return Status::OK();
   }
 
@@ -292,7 +313,8 @@ static Status UpsampleNearest(const T* input,
                               T extrapolation_value,
                               bool use_nearest2x_optimization,
                               const GetOriginalCoordinateFunc& get_original_coordinate,
-                              const GetNearestPixelFunc& get_nearest_pixel) {
+                              const GetNearestPixelFunc& get_nearest_pixel,
+                              concurrency::ThreadPool* tp) {
   ORT_RETURN_IF_ERROR(ValidateUpsampleInput(input, output, input_shape, output_shape, is_resize));
 
   // special case with fast path
@@ -304,7 +326,7 @@ static Status UpsampleNearest(const T* input,
 
   return UpsampleNearestImpl(input, output, input_shape, output_shape, scales, roi,
                              extrapolation_enabled, extrapolation_value,
-                             get_original_coordinate, get_nearest_pixel);
+                             get_original_coordinate, get_nearest_pixel, tp);
 }
 
 /*
@@ -511,6 +533,60 @@ BilinearParams SetupUpsampleBilinear(const int32_t input_height,
   return p;
 }
 
+void UpsampleBilinearRows(const BilinearParams& p,
+                          const int32_t image_count,
+                          const int32_t num_channels,
+                          const int32_t input_height,
+                          const int32_t input_width,
+                          const int32_t output_height,
+                          const int32_t output_width,
+                          const bool use_extrapolation,
+                          const float extrapolation_value,
+                          const float* const XdataBase,
+                          float* const YdataBase,
+                          concurrency::ThreadPool* tp) {
+  const size_t input_row_size = static_cast<size_t>(input_width) * num_channels;
+  const size_t output_row_size = static_cast<size_t>(output_width) * num_channels;
+  const size_t input_image_size = input_row_size * input_height;
+
+  concurrency::ThreadPool::TryParallelFor(
+      tp, static_cast<std::ptrdiff_t>(image_count) * output_height,
+      static_cast<double>(output_row_size * 2 + input_row_size * 2),
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        // Holds the blend of the two input rows that contribute to an output row.
+        std::vector<float> row_buffer(input_row_size);
+
+        for (std::ptrdiff_t i = first; i < last; ++i) {
+          const size_t image = static_cast<size_t>(i / output_height);
+          const int32_t y = static_cast<int32_t>(i % output_height);
+          const float* const Xdata = XdataBase + image * input_image_size;
+          float* const Ydata = YdataBase + static_cast<size_t>(i) * output_row_size;
+
+          // when use_extrapolation is set and original index of x or y is out of the dim range
+          // then use extrapolation_value as the output value.
+          if (use_extrapolation &&
+              (p.y_original[y] < 0 || p.y_original[y] > static_cast<float>(input_height - 1))) {
+            std::fill_n(Ydata, output_row_size, extrapolation_value);
+            continue;
+          }
+
+          MlasBilinearResizeRow(Xdata + static_cast<size_t>(p.input_width_mul_y1[y]) * num_channels,
+                                Xdata + static_cast<size_t>(p.input_width_mul_y2[y]) * num_channels,
+                                p.dy2[y], p.dy1[y], p.in_x1, p.in_x2, p.dx2, p.dx1,
+                                static_cast<size_t>(input_width), static_cast<size_t>(output_width),
+                                static_cast<size_t>(num_channels), row_buffer.data(), Ydata);
+
+          if (use_extrapolation) {
+            for (int32_t x = 0; x < output_width; ++x) {
+              if (p.x_original[x] < 0 || p.x_original[x] > static_cast<float>(input_width - 1)) {
+                std::fill_n(Ydata + static_cast<size_t>(x) * num_channels, num_channels, extrapolation_value);
+              }
+            }
+          }
+        }
+      });
+}
+
 // Same as above, but doesn't use any floating-point for the coefficient (i.e., d*_scale_10) computation
 BilinearParamsInteger SetupUpsampleBilinearInteger(const int32_t input_height,
                                                    const int32_t input_width,
@@ -873,50 +949,57 @@ std::array<float, CubicModeGridLength> GetCubicCoeffs(float s, float cubic_coeff
   return coeffs;
 }
 
-// Get the tensor data at the requested coordinate
-template <typename T>
-T GetDataForCoordinate(const T* Xdata,
-                       int64_t x, int64_t y,
-                       int64_t input_height, int64_t input_width) {
-  x = std::max(static_cast<int64_t>(0), std::min(x, input_width - 1));
-  y = std::max(static_cast<int64_t>(0), std::min(y, input_height - 1));
-  return Xdata[y * input_width + x];
-}
-
-// Computes cubic convolution interpolation in 1D
-template <typename T>
-float CubicInterpolation1D(const T* Xdata,
-                           int64_t x,
-                           int64_t y,
-                           int64_t input_height,
-                           int64_t input_width,
-                           std::array<float, CubicModeGridLength>& coeff_array,
-                           float coeff_sum,
-                           std::unordered_map<int64_t, float>& cache) {
-  // When calculating cubic interpolation we move the 4*4 grid across the original data and therefore there is
-  // opportunity to cache the results for previously seen combinations.
-  // Check if the result is already available in the cache
-  auto grid_start_pos = (y)*input_width + (x - 1);
-  if (cache.find(grid_start_pos) != cache.end()) {
-    return cache[grid_start_pos];
-  }
+// Maps each output index of a dimension to the 4 input indices of the cubic convolution, clamped to the input, and
+// to their weights. The weights of indices outside the input are set to 0 when exclude_outside is set, and the
+// weights are normalized so that their sum is 1.
+static void SetupCubicCoefficients(int64_t input_size,
+                                   int64_t output_size,
+                                   float scale,
+                                   float roi_start,
+                                   float roi_end,
+                                   float cubic_coeff_a,
+                                   bool exclude_outside,
+                                   const GetOriginalCoordinateFunc& get_original_coordinate,
+                                   std::vector<float>& original,
+                                   std::vector<int32_t>& indices,
+                                   std::vector<float>& weights) {
+  original.resize(narrow<size_t>(output_size));
+  indices.resize(narrow<size_t>(output_size) * CubicModeGridLength);
+  weights.resize(narrow<size_t>(output_size) * CubicModeGridLength);
+
+  for (int64_t o = 0; o < output_size; ++o) {
+    const float in = scale == 1 ? static_cast<float>(o)
+                                : get_original_coordinate(static_cast<float>(o), scale,
+                                                          static_cast<float>(output_size),
+                                                          static_cast<float>(input_size),
+                                                          roi_start, roi_end);
+    original[narrow<size_t>(o)] = in;
+
+    const int64_t in_int = static_cast<int64_t>(std::floor(in));
+    std::array<float, CubicModeGridLength> coeffs = GetCubicCoeffs(in - static_cast<float>(in_int), cubic_coeff_a);
+    float coeff_sum = 1;
+    if (exclude_outside) {
+      coeff_sum = 0;
+      for (int64_t i = 0; i < static_cast<int64_t>(CubicModeGridLength); ++i) {
+        const int64_t index = in_int - 1 + i;
+        if (index < 0 || index >= input_size) {
+          coeffs[narrow<size_t>(i)] = 0.0f;
+        }
+        coeff_sum += coeffs[narrow<size_t>(i)];
+      }
+    }
 
-  // get the neighbors in 1D and find interpolation for this dimension
-  // for 1D cubic interpolation 4 samples are used. 2 on the left and 2 on the right of x
-  float result = 0;
-  for (int i = 0, j = -1; i < static_cast<int>(CubicModeGridLength); i++, j++) {
-    auto orig_data = GetDataForCoordinate(Xdata, x + j, y, input_height, input_width);
-    result += coeff_array[narrow<size_t>(i)] / coeff_sum * orig_data;
+    for (int64_t i = 0; i < static_cast<int64_t>(CubicModeGridLength); ++i) {
+      const size_t k = narrow<size_t>(o) * CubicModeGridLength + narrow<size_t>(i);
+      indices[k] = static_cast<int32_t>(std::clamp(in_int - 1 + i, int64_t{0}, input_size - 1));
+      weights[k] = coeffs[narrow<size_t>(i)] / coeff_sum;
+    }
   }
-  cache[grid_start_pos] = result;
-
-  return result;
 }
-#if defined(_MSC_VER)
-#pragma warning(push)
-#pragma warning(disable : 6001)
-#endif
-template <typename T>
+
+// The bicubic interpolation is separable. MlasBicubicResizeRow blends the 4 input rows of an output row once, then
+// interpolates each output pixel from the blended row. The output rows of all images are partitioned across the
+// threadpool.
 void ResizeBiCubic(int64_t batch_size,
                    int64_t num_channels,
                    int64_t input_height,
@@ -930,140 +1013,69 @@ void ResizeBiCubic(int64_t batch_size,
                    float extrapolation_value,
                    bool exclude_outside,
                    const std::vector<float>& roi,
-                   const T* Xdata,
-                   T* Ydata,
-                   const GetOriginalCoordinateFunc& get_original_coordinate) {
+                   const float* XdataBase,
+                   float* YdataBase,
+                   const GetOriginalCoordinateFunc& get_original_coordinate,
+                   concurrency::ThreadPool* tp) {
   std::vector<float> y_original;
-  y_original.reserve(narrow<size_t>(output_height));
-
+  std::vector<int32_t> in_y;
+  std::vector<float> y_weights;
   std::vector<float> x_original;
-  x_original.reserve(narrow<size_t>(output_width));
+  std::vector<int32_t> in_x;
+  std::vector<float> x_weights;
 
-  std::unordered_map<float, std::array<float, CubicModeGridLength>> cubic_coeffs;
-  std::unordered_map<float, std::unordered_map<int64_t, float>> coeff_to_1Dinterpolation_map;
   auto roi_y_start = roi.size() / 2 - 2;
   auto roi_y_end = roi.size() - 2;
   auto roi_x_start = roi.size() / 2 - 1;
   auto roi_x_end = roi.size() - 1;
 
-  // generate coefficients in y direction
-  for (int64_t y = 0; y < output_height; ++y) {
-    float in_y = height_scale == 1 ? static_cast<float>(y)
-                                   : get_original_coordinate(static_cast<float>(y), height_scale,
-                                                             static_cast<float>(output_height),
-                                                             static_cast<float>(input_height),
-                                                             roi[roi_y_start], roi[roi_y_end]);
-    y_original.emplace_back(in_y);
-    auto s = y_original[narrow<size_t>(y)] - std::floor(y_original[narrow<size_t>(y)]);
-    if (cubic_coeffs.find(s) == cubic_coeffs.end()) {
-      cubic_coeffs[s] = GetCubicCoeffs(s, cubic_coeff_a);
-      coeff_to_1Dinterpolation_map[s] = {};
-    }
-  }
-
-  // generate coefficients in x direction
-  for (int64_t x = 0; x < output_width; ++x) {
-    float in_x = width_scale == 1 ? static_cast<float>(x)
-                                  : get_original_coordinate(static_cast<float>(x),
-                                                            width_scale,
-                                                            static_cast<float>(output_width),
-                                                            static_cast<float>(input_width),
-                                                            roi[roi_x_start], roi[roi_x_end]);
-    x_original.emplace_back(in_x);
-    auto s = x_original[narrow<size_t>(x)] - std::floor(x_original[narrow<size_t>(x)]);
-    if (cubic_coeffs.find(s) == cubic_coeffs.end()) {
-      cubic_coeffs[s] = GetCubicCoeffs(s, cubic_coeff_a);
-      coeff_to_1Dinterpolation_map[s] = {};
-    }
-  }
-
-  // setup up temp arrays to hold coefficients when exclude_outside is set to true
-  std::array<float, CubicModeGridLength> y_coeff_holder;
-  std::array<float, CubicModeGridLength> x_coeff_holder;
-  float y_coeff_sum = 1;
-  float x_coeff_sum = 1;
+  SetupCubicCoefficients(input_height, output_height, height_scale, roi[roi_y_start], roi[roi_y_end],
+                         cubic_coeff_a, exclude_outside, get_original_coordinate, y_original, in_y, y_weights);
+  SetupCubicCoefficients(input_width, output_width, width_scale, roi[roi_x_start], roi[roi_x_end],
+                         cubic_coeff_a, exclude_outside, get_original_coordinate, x_original, in_x, x_weights);
 
-  for (int64_t n = 0; n < batch_size; n++) {
-    for (int64_t c = 0; c < num_channels; c++) {
-      for (int64_t y = 0; y < output_height; ++y) {
-        auto in_y = y_original[narrow<size_t>(y)];
+  const size_t input_image_size = narrow<size_t>(input_height * input_width);
 
-        // when use_extrapolation is set and original index is out of the dim range
-        // then use extrapolation_value as the output value.
-        if (use_extrapolation && (in_y < 0 || in_y > static_cast<float>(input_height - 1))) {
-          for (int64_t x = 0; x < output_width; ++x) {
-            Ydata[y * output_width + x] = extrapolation_value;
-          }
-          continue;
-        }
+  concurrency::ThreadPool::TryParallelFor(
+      tp, static_cast<std::ptrdiff_t>(batch_size * num_channels * output_height),
+      static_cast<double>((output_width + input_width) * static_cast<int64_t>(CubicModeGridLength) * 2),
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        // Holds the blend of the 4 input rows that contribute to an output row.
+        std::vector<float> row_buffer(narrow<size_t>(input_width));
 
-        auto y_int = static_cast<int64_t>(std::floor(in_y));
-        auto& coeff_y = exclude_outside ? y_coeff_holder : cubic_coeffs[in_y - y_int];
-        y_coeff_sum = 1;
-
-        if (exclude_outside) {
-          // When true, the weight of sampling locations outside the grid will be set to 0
-          // and the weight will be renormalized so that their sum is 1.0
-          y_coeff_sum = 0;
-          auto& orig_y_coeffs = cubic_coeffs[in_y - y_int];
-          for (int64_t i = 0, y_val = y_int - 1; y_val <= y_int + 2; y_val++, i++) {
-            y_coeff_holder[narrow<size_t>(i)] = (y_val < 0 || y_val >= static_cast<float>(input_height)) ? 0.0f : orig_y_coeffs[narrow<size_t>(i)];
-            y_coeff_sum += y_coeff_holder[narrow<size_t>(i)];
-          }
-        }
-
-        for (int64_t x = 0; x < output_width; ++x) {
-          auto in_x = x_original[narrow<size_t>(x)];
+        for (std::ptrdiff_t i = first; i < last; ++i) {
+          const size_t image = static_cast<size_t>(i / output_height);
+          const size_t y = static_cast<size_t>(i % output_height);
+          const float* const Xdata = XdataBase + image * input_image_size;
+          float* const Ydata = YdataBase + static_cast<size_t>(i) * narrow<size_t>(output_width);
 
           // when use_extrapolation is set and original index is out of the dim range
           // then use extrapolation_value as the output value.
-          if (use_extrapolation && (in_x < 0 || in_x > static_cast<float>(input_width - 1))) {
-            Ydata[y * output_width + x] = extrapolation_value;
+          if (use_extrapolation && (y_original[y] < 0 || y_original[y] > static_cast<float>(input_height - 1))) {
+            std::fill_n(Ydata, narrow<size_t>(output_width), extrapolation_value);
             continue;
           }
 
-          auto x_int = static_cast<int64_t>(std::floor(in_x));
-          auto s_x = static_cast<float>(in_x - x_int);
-          auto& coeff_x = exclude_outside ? x_coeff_holder : cubic_coeffs[s_x];
-          x_coeff_sum = 1;
-
-          if (exclude_outside) {
-            // When true, the weight of sampling locations outside the grid will be set to 0
-            // and the weight will be renormalized so that their sum is 1.0
-            x_coeff_sum = 0;
-            auto& orig_x_coeff = cubic_coeffs[s_x];
-            for (int64_t i = 0, x_val = x_int - 1; x_val <= x_int + 2; x_val++, i++) {
-              x_coeff_holder[narrow<size_t>(i)] = (x_val < 0 || x_val >= static_cast<float>(input_width)) ? 0.0f : orig_x_coeff[narrow<size_t>(i)];
-              x_coeff_sum += x_coeff_holder[narrow<size_t>(i)];
-            }
+          const float* input_rows[CubicModeGridLength];
+          for (size_t k = 0; k < CubicModeGridLength; ++k) {
+            input_rows[k] = Xdata + static_cast<size_t>(in_y[y * CubicModeGridLength + k]) * narrow<size_t>(input_width);
           }
 
-          // Compute cubic interpolation in x dimension using the x coefficients.
-          // From the result of cubic interpolation in x dim, compute cubic interpolation in y dimension
-          auto& interpolation_result_cache = coeff_to_1Dinterpolation_map[s_x];
-          float result = 0;
-          for (int64_t y_val = y_int - 1, i = 0; y_val <= y_int + 2; y_val++, i++) {
-            auto x_interpolation_result = CubicInterpolation1D(Xdata, x_int, y_val,
-                                                               input_height, input_width, coeff_x, x_coeff_sum,
-                                                               interpolation_result_cache);
-            result += x_interpolation_result * coeff_y[narrow<size_t>(i)] / y_coeff_sum;
-          }
+          MlasBicubicResizeRow(input_rows, &y_weights[y * CubicModeGridLength], in_x.data(), x_weights.data(),
+                               narrow<size_t>(input_width), narrow<size_t>(output_width), 1,
+                               row_buffer.data(), Ydata);
 
-          Ydata[y * output_width + x] = static_cast<T>(result);
+          if (use_extrapolation) {
+            for (int64_t x = 0; x < output_width; ++x) {
+              if (x_original[narrow<size_t>(x)] < 0 ||
+                  x_original[narrow<size_t>(x)] > static_cast<float>(input_width - 1)) {
+                Ydata[x] = extrapolation_value;
+              }
+            }
+          }
         }
-      }
-
-      Xdata += input_height * input_width;
-      Ydata += output_height * output_width;
-
-      // clear the cache when moving to the next channel
-      coeff_to_1Dinterpolation_map.clear();
-    }
-  }
+      });
 }
-#if defined(_MSC_VER)
-#pragma warning(pop)
-#endif
 
 template <typename T>
 Status Upsample<T>::BaseCompute(OpKernelContext* context,
@@ -1105,7 +1117,8 @@ Status Upsample<T>::BaseCompute(OpKernelContext* context,
     case UpsampleMode::NN:
       return UpsampleNearest<T>(X->Data<T>(), Y->MutableData<T>(), X->Shape(), Y->Shape(),
                                 scales, roi, is_resize_, use_extrapolation_, static_cast<T>(extrapolation_value_),
-                                use_nearest2x_optimization_, get_original_coordinate_, get_nearest_pixel_);
+                                use_nearest2x_optimization_, get_original_coordinate_, get_nearest_pixel_,
+                                Y->Shape().Size() > 64 ? context->GetOperatorThreadPool() : nullptr);
     case UpsampleMode::LINEAR: {
       // Supports 'bilinear' and 'trilinear' sampling only
 
@@ -1307,7 +1320,8 @@ Status Upsample<T>::BaseCompute(OpKernelContext* context,
         ResizeBiCubic(batch_size, num_channels, input_height, input_width, output_height, output_width,
                       height_scale, width_scale, cubic_coeff_a_, use_extrapolation_,
                       extrapolation_value_, exclude_outside_, roi, X->Data<float>(),
-                      Y->MutableData<float>(), get_original_coordinate_);
+                      Y->MutableData<float>(), get_original_coordinate_,
+                      output_height * output_width * num_channels > 64 ? context->GetOperatorThreadPool() : nullptr);
       }
       return Status::OK();
     }
@@ -0,0 +1,294 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/dynamic_batcher.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "core/common/narrow.h"
+#include "core/framework/data_types.h"
+#include "core/framework/tensor.h"
+
+namespace onnxruntime {
+
+namespace {
+
+// Create an OrtValue for rows [offset, offset + rows) of a tensor batched along dimension 0.
+// The slice shares the buffer of the batched tensor, which is kept alive until the slice is released.
+OrtValue SliceBatchedTensor(const OrtValue& batched, int64_t offset, int64_t rows) {
+  const auto& tensor = batched.Get<Tensor>();
+  const size_t row_size = tensor.SizeInBytes() / narrow<size_t>(tensor.Shape()[0]);
+
+  TensorShape slice_shape = tensor.Shape();
+  slice_shape[0] = rows;
+  auto* slice_data = static_cast<uint8_t*>(const_cast<void*>(tensor.DataRaw())) + offset * row_size;
+  auto slice = std::make_unique<Tensor>(tensor.DataType(), slice_shape, slice_data, tensor.Location());
+
+  OrtValue slice_value;
+  slice_value.Init(slice.release(), DataTypeImpl::GetType<Tensor>(),
+                   [batched](void* p) { delete static_cast<Tensor*>(p); });
+  return slice_value;
+}
+
+}  // namespace
+
+DynamicBatcher::DynamicBatcher(int64_t max_batch_size, std::chrono::microseconds max_queue_delay,
+                               AllocatorPtr cpu_allocator, RunFn run_fn, profiling::Profiler& profiler,
+                               const logging::Logger& logger)
+    : max_batch_size_(max_batch_size),
+      max_queue_delay_(max_queue_delay),
+      cpu_allocator_(std::move(cpu_allocator)),
+      run_fn_(std::move(run_fn)),
+      profiler_(profiler),
+      logger_(logger) {
+  ORT_ENFORCE(max_batch_size_ > 1, "Dynamic batching requires a max batch size greater than 1.");
+}
+
+bool DynamicBatcher::CanBatch(const RunOptions& run_options, gsl::span<const OrtValue> feeds,
+                              gsl::span<const std::string> output_names, const std::vector<OrtValue>* p_fetches,
+                              const std::vector<OrtDevice>* p_fetches_device_info) const {
+  if (run_options.terminate || run_options.only_execute_path_to_fetches ||
+      !run_options.config_options.configurations.empty()) {
+    return false;
+  }
+
+  if (feeds.empty() || output_names.empty() || p_fetches == nullptr || p_fetches_device_info != nullptr) {
+    return false;
+  }
+
+  // pre-allocated outputs would need a copy from the batched outputs
+  for (const auto& fetch : *p_fetches) {
+    if (fetch.IsAllocated()) {
+      return false;
+    }
+  }
+
+  int64_t batch_size = -1;
+  for (const auto& feed : feeds) {
+    if (!feed.IsTensor()) {
+      return false;
+    }
+
+    const auto& tensor = feed.Get<Tensor>();
+    if (tensor.IsDataTypeString() || tensor.Location().device.Type() != OrtDevice::CPU ||
+        tensor.Shape().NumDimensions() == 0) {
+      return false;
+    }
+
+    const int64_t feed_batch_size = tensor.Shape()[0];
+    if (feed_batch_size <= 0 || (batch_size != -1 && feed_batch_size != batch_size)) {
+      return false;
+    }
+
+    batch_size = feed_batch_size;
+  }
+
+  return batch_size < max_batch_size_;
+}
+
+bool DynamicBatcher::IsCompatible(const Request& a, const Request& b) {
+  if (!std::equal(a.feed_names.begin(), a.feed_names.end(), b.feed_names.begin(), b.feed_names.end()) ||
+      !std::equal(a.output_names.begin(), a.output_names.end(), b.output_names.begin(), b.output_names.end())) {
+    return false;
+  }
+
+  for (size_t i = 0, end = a.feeds.size(); i < end; ++i) {
+    const auto& a_tensor = a.feeds[i].Get<Tensor>();
+    const auto& b_tensor = b.feeds[i].Get<Tensor>();
+    if (a_tensor.DataType() != b_tensor.DataType() ||
+        a_tensor.Shape().Slice(1) != b_tensor.Shape().Slice(1)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+Status DynamicBatcher::Run(const RunOptions& run_options,
+                           gsl::span<const std::string> feed_names, gsl::span<const OrtValue> feeds,
+                           gsl::span<const std::string> output_names, std::vector<OrtValue>& fetches) {
+  Request request{run_options, feed_names, feeds, output_names, fetches,
+                  feeds[0].Get<Tensor>().Shape()[0], std::chrono::high_resolution_clock::now()};
+
+  std::unique_lock<OrtMutex> lock(mutex_);
+  queue_.push_back(&request);
+  if (!has_leader_) {
+    has_leader_ = true;
+    request.is_leader = true;
+  } else {
+    // the batch of the current leader may be complete now
+    cv_.notify_all();
+  }
+
+  while (!request.done) {
+    if (request.is_leader) {
+      auto batch = CollectBatch(lock, request);
+
+      lock.unlock();
+      ExecuteBatch(batch);
+      lock.lock();
+
+      for (auto* batch_request : batch) {
+        batch_request->done = true;
+      }
+      cv_.notify_all();
+    } else {
+      cv_.wait(lock);
+    }
+  }
+
+  return request.status;
+}
+
+std::vector<DynamicBatcher::Request*> DynamicBatcher::CollectBatch(std::unique_lock<OrtMutex>& lock,
+                                                                   Request& leader) {
+  const auto deadline = leader.enqueue_time + max_queue_delay_;
+  for (;;) {
+    int64_t queued_batch_size = 0;
+    for (const auto* queued : queue_) {
+      if (IsCompatible(leader, *queued)) {
+        queued_batch_size += queued->batch_size;
+      }
+    }
+
+    const auto now = std::chrono::high_resolution_clock::now();
+    if (queued_batch_size >= max_batch_size_ || now >= deadline) {
+      break;
+    }
+
+    cv_.wait_for(lock, deadline - now);
+  }
+
+  std::vector<Request*> batch{&leader};
+  int64_t total_batch_size = leader.batch_size;
+  queue_.remove(&leader);
+  for (auto it = queue_.begin(); it != queue_.end();) {
+    if (total_batch_size + (*it)->batch_size <= max_batch_size_ && IsCompatible(leader, **it)) {
+      total_batch_size += (*it)->batch_size;
+      batch.push_back(*it);
+      it = queue_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  // the next request starts forming a batch while this one executes
+  if (!queue_.empty()) {
+    queue_.front()->is_leader = true;
+    cv_.notify_all();
+  } else {
+    has_leader_ = false;
+  }
+
+  return batch;
+}
+
+void DynamicBatcher::ExecuteBatch(gsl::span<Request* const> batch) {
+  int64_t total_batch_size = 0;
+  for (const auto* request : batch) {
+    total_batch_size += request->batch_size;
+  }
+
+  const auto dispatch_time = std::chrono::high_resolution_clock::now();
+  for (const auto* request : batch) {
+    LOGS(logger_, VERBOSE) << "Dynamic batching: request queued for "
+                           << std::chrono::duration_cast<std::chrono::microseconds>(dispatch_time -
+                                                                                    request->enqueue_time)
+                                  .count()
+                           << "us. Batch has " << batch.size() << " requests and " << total_batch_size << " rows.";
+    if (profiler_.IsEnabled()) {
+      profiler_.EndTimeAndRecordEvent(profiling::SESSION_EVENT, "dynamic_batching_queue", request->enqueue_time,
+                                      {{"batch_requests", std::to_string(batch.size())},
+                                       {"batch_size", std::to_string(total_batch_size)}});
+    }
+  }
+
+  if (batch.size() == 1) {
+    RunRequest(*batch[0]);
+    return;
+  }
+
+  bool outputs_batched = true;
+  Status status;
+  ORT_TRY {
+    status = ExecuteConcatenated(batch, total_batch_size, outputs_batched);
+  }
+  ORT_CATCH(const std::exception& ex) {
+    ORT_HANDLE_EXCEPTION([&]() {
+      status = ORT_MAKE_STATUS(ONNXRUNTIME, RUNTIME_EXCEPTION, "Exception running batched requests: ", ex.what());
+    });
+  }
+
+  if (!outputs_batched) {
+    // an output does not follow the batch dimension of the inputs so it can't be split between the requests
+    LOGS(logger_, WARNING) << "Dynamic batching: outputs are not batched along dimension 0. "
+                           << "Running the requests of the batch separately.";
+    for (auto* request : batch) {
+      RunRequest(*request);
+    }
+    return;
+  }
+
+  for (auto* request : batch) {
+    request->status = status;
+  }
+}
+
+void DynamicBatcher::RunRequest(Request& request) {
+  ORT_TRY {
+    request.status = run_fn_(request.run_options, request.feed_names, request.feeds, request.output_names,
+                             &request.fetches);
+  }
+  ORT_CATCH(const std::exception& ex) {
+    ORT_HANDLE_EXCEPTION([&]() {
+      request.status = ORT_MAKE_STATUS(ONNXRUNTIME, RUNTIME_EXCEPTION, "Exception running request: ", ex.what());
+    });
+  }
+}
+
+Status DynamicBatcher::ExecuteConcatenated(gsl::span<Request* const> batch, int64_t total_batch_size,
+                                           bool& outputs_batched) {
+  const Request& leader = *batch[0];
+
+  std::vector<OrtValue> batched_feeds(leader.feeds.size());
+  for (size_t i = 0, end = leader.feeds.size(); i < end; ++i) {
+    const auto& leader_tensor = leader.feeds[i].Get<Tensor>();
+    TensorShape batched_shape = leader_tensor.Shape();
+    batched_shape[0] = total_batch_size;
+    Tensor::InitOrtValue(leader_tensor.DataType(), batched_shape, cpu_allocator_, batched_feeds[i]);
+
+    auto* dst = static_cast<uint8_t*>(batched_feeds[i].GetMutable<Tensor>()->MutableDataRaw());
+    for (const auto* request : batch) {
+      const auto& tensor = request->feeds[i].Get<Tensor>();
+      std::memcpy(dst, tensor.DataRaw(), tensor.SizeInBytes());
+      dst += tensor.SizeInBytes();
+    }
+  }
+
+  std::vector<OrtValue> batched_fetches;
+  ORT_RETURN_IF_ERROR(run_fn_(leader.run_options, leader.feed_names, batched_feeds, leader.output_names,
+                              &batched_fetches));
+
+  for (const auto& fetch : batched_fetches) {
+    if (!fetch.IsTensor() || fetch.Get<Tensor>().Shape().NumDimensions() == 0 ||
+        fetch.Get<Tensor>().Shape()[0] != total_batch_size) {
+      outputs_batched = false;
+      return Status::OK();
+    }
+  }
+
+  int64_t offset = 0;
+  for (auto* request : batch) {
+    request->fetches.resize(batched_fetches.size());
+    for (size_t i = 0, end = batched_fetches.size(); i < end; ++i) {
+      request->fetches[i] = SliceBatchedTensor(batched_fetches[i], offset, request->batch_size);
+    }
+
+    offset += request->batch_size;
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
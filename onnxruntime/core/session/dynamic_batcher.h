@@ -0,0 +1,118 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <list>
+#include <string>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/logging/logging.h"
+#include "core/common/profiler.h"
+#include "core/common/status.h"
+#include "core/framework/allocator.h"
+#include "core/framework/ort_value.h"
+#include "core/framework/run_options.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+/**
+Combines concurrent Run calls on a session into a single execution of the model.
+
+Requests are batched along dimension 0 of every input and output, which must be the batch dimension of the model.
+Requests are compatible if they feed and fetch the same names, and their inputs have the same element types and
+the same shape apart from the batch dimension.
+
+There is no dedicated batching thread. The first request to arrive while no batch is being formed becomes the leader.
+It waits until the compatible requests in the queue add up to max_batch_size rows, or until it has been queued for
+max_queue_delay, then takes them out of the queue, hands the leadership to the next queued request and executes the
+batch on its own thread. The inputs of the requests are copied into one tensor per input, and each request receives
+outputs that are slices of the batched outputs. The slices share the buffers of the batched outputs.
+
+The time each request spends in the queue is recorded as a "dynamic_batching_queue" session event when profiling is
+enabled, and logged at VERBOSE level.
+*/
+class DynamicBatcher {
+ public:
+  using RunFn = std::function<Status(const RunOptions& run_options,
+                                     gsl::span<const std::string> feed_names, gsl::span<const OrtValue> feeds,
+                                     gsl::span<const std::string> output_names, std::vector<OrtValue>* p_fetches)>;
+
+  /**
+  @param max_batch_size Maximum number of rows of a batch.
+  @param max_queue_delay Maximum time a request waits for other requests to join its batch.
+  @param cpu_allocator Allocator for the batched inputs.
+  @param run_fn Function that runs the model on a set of inputs without batching.
+  */
+  DynamicBatcher(int64_t max_batch_size, std::chrono::microseconds max_queue_delay, AllocatorPtr cpu_allocator,
+                 RunFn run_fn, profiling::Profiler& profiler, const logging::Logger& logger);
+
+  /**
+  Returns true if the request can be batched with other requests: all inputs are non-string tensors in CPU memory
+  with the same non-zero batch size, the outputs are not pre-allocated, and the run options do not need to be
+  applied to this request alone.
+  */
+  bool CanBatch(const RunOptions& run_options, gsl::span<const OrtValue> feeds,
+                gsl::span<const std::string> output_names, const std::vector<OrtValue>* p_fetches,
+                const std::vector<OrtDevice>* p_fetches_device_info) const;
+
+  /**
+  Queue the request and return when the batch containing it has been executed.
+  The run options of the leader of the batch are used to execute the batch.
+  */
+  Status Run(const RunOptions& run_options,
+             gsl::span<const std::string> feed_names, gsl::span<const OrtValue> feeds,
+             gsl::span<const std::string> output_names, std::vector<OrtValue>& fetches);
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(DynamicBatcher);
+
+  struct Request {
+    const RunOptions& run_options;
+    gsl::span<const std::string> feed_names;
+    gsl::span<const OrtValue> feeds;
+    gsl::span<const std::string> output_names;
+    std::vector<OrtValue>& fetches;
+    int64_t batch_size;
+    std::chrono::high_resolution_clock::time_point enqueue_time;
+
+    bool is_leader{false};
+    bool done{false};
+    Status status;
+  };
+
+  static bool IsCompatible(const Request& a, const Request& b);
+
+  // Wait for the batch of the leader to fill up, take its requests out of the queue and hand over the leadership.
+  // The leader is the first request of the returned batch.
+  std::vector<Request*> CollectBatch(std::unique_lock<OrtMutex>& lock, Request& leader);
+
+  // Execute the batch and set the status and fetches of its requests.
+  void ExecuteBatch(gsl::span<Request* const> batch);
+
+  // Run a request on its own inputs. An exception is converted to the status of the request so that the other
+  // requests of the batch are still completed.
+  void RunRequest(Request& request);
+
+  // Run the batch on concatenated inputs and slice the outputs. outputs_batched is set to false if an output can't be
+  // split between the requests.
+  Status ExecuteConcatenated(gsl::span<Request* const> batch, int64_t total_batch_size, bool& outputs_batched);
+
+  const int64_t max_batch_size_;
+  const std::chrono::microseconds max_queue_delay_;
+  AllocatorPtr cpu_allocator_;
+  RunFn run_fn_;
+  profiling::Profiler& profiler_;
+  const logging::Logger& logger_;
+
+  OrtMutex mutex_;
+  OrtCondVar cv_;
+  std::list<Request*> queue_;
+  bool has_leader_{false};
+};
+
+}  // namespace onnxruntime
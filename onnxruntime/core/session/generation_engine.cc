@@ -0,0 +1,380 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/generation_engine.h"
+
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+
+#include "core/common/narrow.h"
+#include "core/common/safeint.h"
+#include "core/framework/framework_common.h"
+#include "core/framework/tensor.h"
+#include "core/graph/node_arg.h"
+#include "core/session/inference_session.h"
+
+namespace onnxruntime {
+
+namespace {
+
+// Returns the token with the highest logit at the last position of a row of logits with shape
+// (batch_size, sequence_length, vocab_size).
+template <typename T>
+int32_t ArgMaxOfLastPosition(const Tensor& logits, int64_t row) {
+  const auto& shape = logits.Shape();
+  const int64_t vocab_size = shape[2];
+  const T* first = logits.Data<T>() + SafeInt<size_t>((row * shape[1] + shape[1] - 1) * vocab_size);
+  const T* best = first;
+  for (const T* p = first + 1; p != first + vocab_size; ++p) {
+    if (static_cast<float>(*p) > static_cast<float>(*best)) {
+      best = p;
+    }
+  }
+  return narrow<int32_t>(best - first);
+}
+
+int32_t ArgMaxOfLastPosition(const Tensor& logits, int64_t row) {
+  if (logits.IsDataType<MLFloat16>()) {
+    return ArgMaxOfLastPosition<MLFloat16>(logits, row);
+  }
+  return ArgMaxOfLastPosition<float>(logits, row);
+}
+
+int32_t GetElementType(const NodeArg& node_arg) {
+  const auto* type = node_arg.TypeAsProto();
+  if (type == nullptr || !type->has_tensor_type()) {
+    return ONNX_NAMESPACE::TensorProto_DataType_UNDEFINED;
+  }
+  return type->tensor_type().elem_type();
+}
+
+}  // namespace
+
+Status GenerationEngine::Create(InferenceSession& session, size_t max_batch_size, int32_t eos_token_id,
+                                std::unique_ptr<GenerationEngine>& engine) {
+  ORT_RETURN_IF(max_batch_size == 0, "The max batch size of a generation engine must be greater than 0.");
+
+  auto inputs = session.GetModelInputs();
+  ORT_RETURN_IF_ERROR(inputs.first);
+  auto outputs = session.GetModelOutputs();
+  ORT_RETURN_IF_ERROR(outputs.first);
+  const InputDefList& input_defs = *inputs.second;
+  const OutputDefList& output_defs = *outputs.second;
+
+  ORT_RETURN_IF(input_defs.size() < 4 || output_defs.size() + 2 != input_defs.size(),
+                "Invalid GPT-2 decoder: the inputs shall be input_ids, position_ids, attention_mask and the past "
+                "state of each layer, and the outputs shall be logits and the present state of each layer.");
+  const int num_layers = narrow<int>(input_defs.size() - 3);
+
+  const char* const int32_inputs[] = {"input_ids", "position_ids", "attention_mask"};
+  for (size_t i = 0; i < 3; ++i) {
+    ORT_RETURN_IF(input_defs[i]->Name() != int32_inputs[i],
+                  "Invalid GPT-2 decoder: input ", i, " shall be named as ", int32_inputs[i],
+                  ", got: ", input_defs[i]->Name());
+    ORT_RETURN_IF(GetElementType(*input_defs[i]) != ONNX_NAMESPACE::TensorProto_DataType_INT32,
+                  "Invalid GPT-2 decoder: input ", int32_inputs[i], " shall be an int32 tensor.");
+  }
+
+  ORT_RETURN_IF(output_defs[0]->Name() != "logits",
+                "Invalid GPT-2 decoder: output 0 shall be named as logits, got: ", output_defs[0]->Name());
+  const int32_t logits_type = GetElementType(*output_defs[0]);
+  ORT_RETURN_IF(logits_type != ONNX_NAMESPACE::TensorProto_DataType_FLOAT &&
+                    logits_type != ONNX_NAMESPACE::TensorProto_DataType_FLOAT16,
+                "Invalid GPT-2 decoder: logits shall be a float or float16 tensor.");
+
+  const int32_t past_elem_type = GetElementType(*input_defs[3]);
+  for (int layer = 0; layer < num_layers; ++layer) {
+    const auto& past = *input_defs[3 + layer];
+    const auto& present = *output_defs[1 + layer];
+    ORT_RETURN_IF(past.Name() != "past_" + std::to_string(layer),
+                  "Invalid GPT-2 decoder: input ", 3 + layer, " shall be named as past_", layer, ", got: ",
+                  past.Name());
+    ORT_RETURN_IF(present.Name() != "present_" + std::to_string(layer),
+                  "Invalid GPT-2 decoder: output ", 1 + layer, " shall be named as present_", layer, ", got: ",
+                  present.Name());
+    ORT_RETURN_IF(GetElementType(past) != past_elem_type || GetElementType(present) != past_elem_type,
+                  "Invalid GPT-2 decoder: the past and present state of all layers shall have the same type.");
+  }
+  ORT_RETURN_IF(past_elem_type != ONNX_NAMESPACE::TensorProto_DataType_FLOAT &&
+                    past_elem_type != ONNX_NAMESPACE::TensorProto_DataType_FLOAT16,
+                "Invalid GPT-2 decoder: the past state shall be a float or float16 tensor.");
+
+  // Past state shape is like (2, batch_size, num_heads, past_seq_len, hidden_size/num_heads).
+  const auto* past_shape = input_defs[3]->Shape();
+  ORT_RETURN_IF(past_shape == nullptr || past_shape->dim_size() != 5,
+                "Invalid GPT-2 decoder: the past state is expected to have 5 dimensions.");
+  ORT_RETURN_IF(!past_shape->dim(2).has_dim_value() || past_shape->dim(2).dim_value() <= 0,
+                "Invalid GPT-2 decoder: past state dimension 2 shall have a positive value for number of heads.");
+  ORT_RETURN_IF(!past_shape->dim(4).has_dim_value() || past_shape->dim(4).dim_value() <= 0,
+                "Invalid GPT-2 decoder: past state dimension 4 shall have a positive value for hidden size per head.");
+
+  AllocatorPtr cpu_allocator = session.GetAllocator(OrtMemoryInfo(CPU, OrtDeviceAllocator));
+  ORT_RETURN_IF(cpu_allocator == nullptr, "The session has no CPU allocator. Was it initialized?");
+
+  MLDataType past_type = past_elem_type == ONNX_NAMESPACE::TensorProto_DataType_FLOAT16
+                             ? DataTypeImpl::GetType<MLFloat16>()
+                             : DataTypeImpl::GetType<float>();
+  engine = std::make_unique<GenerationEngine>(
+      max_batch_size, eos_token_id, num_layers, past_type,
+      past_shape->dim(2).dim_value(), past_shape->dim(4).dim_value(), std::move(cpu_allocator),
+      [&session](gsl::span<const std::string> feed_names, gsl::span<const OrtValue> feeds,
+                 gsl::span<const std::string> output_names, std::vector<OrtValue>& fetches) {
+        return session.Run(RunOptions(), feed_names, feeds, output_names, &fetches);
+      });
+  return Status::OK();
+}
+
+GenerationEngine::GenerationEngine(size_t max_batch_size, int32_t eos_token_id, int num_layers,
+                                   MLDataType past_type, int64_t num_heads, int64_t head_size,
+                                   AllocatorPtr cpu_allocator, RunFn run_fn)
+    : max_batch_size_(max_batch_size),
+      eos_token_id_(eos_token_id),
+      num_layers_(num_layers),
+      past_type_(past_type),
+      num_heads_(num_heads),
+      head_size_(head_size),
+      cpu_allocator_(std::move(cpu_allocator)),
+      run_fn_(std::move(run_fn)) {
+  ORT_ENFORCE(max_batch_size_ > 0, "The max batch size of a generation engine must be greater than 0.");
+
+  feed_names_ = {"input_ids", "position_ids", "attention_mask"};
+  output_names_ = {"logits"};
+  for (int layer = 0; layer < num_layers_; ++layer) {
+    feed_names_.push_back("past_" + std::to_string(layer));
+    output_names_.push_back("present_" + std::to_string(layer));
+  }
+}
+
+Status GenerationEngine::AddRequest(gsl::span<const int32_t> prompt, size_t max_new_tokens, TokenCallback callback,
+                                    int64_t& request_id) {
+  ORT_RETURN_IF(prompt.empty(), "The prompt of a generation request must not be empty.");
+  ORT_RETURN_IF(max_new_tokens == 0, "The max number of new tokens of a generation request must be greater than 0.");
+  ORT_RETURN_IF(!callback, "A generation request requires a token callback.");
+
+  auto request = std::make_unique<Request>();
+  request->prompt.assign(prompt.begin(), prompt.end());
+  request->max_new_tokens = max_new_tokens;
+  request->callback = std::move(callback);
+
+  std::lock_guard<OrtMutex> lock(mutex_);
+  request->id = next_request_id_++;
+  request_id = request->id;
+  queue_.push_back(std::move(request));
+  return Status::OK();
+}
+
+Status GenerationEngine::Step(bool& has_pending_requests) {
+  const size_t num_unfinished = narrow<size_t>(std::count_if(batch_.cbegin(), batch_.cend(),
+                                                             [](const auto& request) { return !request->finished; }));
+
+  std::vector<std::unique_ptr<Request>> admitted;
+  {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    while (!queue_.empty() && num_unfinished + admitted.size() < max_batch_size_) {
+      admitted.push_back(std::move(queue_.front()));
+      queue_.pop_front();
+    }
+  }
+
+  for (auto& request : admitted) {
+    ORT_RETURN_IF_ERROR(RunPrompt(*request));
+  }
+
+  const bool batch_changed = num_unfinished != batch_.size() ||
+                             std::any_of(admitted.cbegin(), admitted.cend(),
+                                         [](const auto& request) { return !request->finished; });
+  if (batch_changed) {
+    RepackBatch(admitted);
+  }
+
+  if (!batch_.empty()) {
+    ORT_RETURN_IF_ERROR(RunDecodeStep());
+  }
+
+  std::lock_guard<OrtMutex> lock(mutex_);
+  has_pending_requests = !queue_.empty() ||
+                         std::any_of(batch_.cbegin(), batch_.cend(),
+                                     [](const auto& request) { return !request->finished; });
+  return Status::OK();
+}
+
+Status GenerationEngine::RunPrompt(Request& request) {
+  const int64_t sequence_length = narrow<int64_t>(request.prompt.size());
+  const int64_t dims[] = {1, sequence_length};
+
+  std::vector<OrtValue> feeds;
+  feeds.reserve(feed_names_.size());
+
+  OrtValue input_ids = CreateInt32Tensor(dims);
+  std::copy(request.prompt.cbegin(), request.prompt.cend(), input_ids.GetMutable<Tensor>()->MutableData<int32_t>());
+  feeds.push_back(input_ids);
+
+  OrtValue position_ids = CreateInt32Tensor(dims);
+  auto positions = position_ids.GetMutable<Tensor>()->MutableDataAsSpan<int32_t>();
+  std::iota(positions.begin(), positions.end(), 0);
+  feeds.push_back(position_ids);
+
+  OrtValue attention_mask = CreateInt32Tensor(dims);
+  auto mask = attention_mask.GetMutable<Tensor>()->MutableDataAsSpan<int32_t>();
+  std::fill(mask.begin(), mask.end(), 1);
+  feeds.push_back(attention_mask);
+
+  OrtValue empty_past;
+  Tensor::InitOrtValue(past_type_, TensorShape({2, 1, num_heads_, 0, head_size_}), cpu_allocator_, empty_past);
+  for (int layer = 0; layer < num_layers_; ++layer) {
+    feeds.push_back(empty_past);
+  }
+
+  std::vector<OrtValue> fetches;
+  ORT_RETURN_IF_ERROR(Run(feeds, fetches));
+
+  request.past_length = sequence_length;
+  request.prompt_past.assign(fetches.begin() + 1, fetches.end());
+  EmitToken(request, ArgMaxOfLastPosition(fetches[0].Get<Tensor>(), 0));
+  return Status::OK();
+}
+
+Status GenerationEngine::RunDecodeStep() {
+  const int64_t batch_size = narrow<int64_t>(batch_.size());
+  const int64_t token_dims[] = {batch_size, 1};
+  const int64_t mask_dims[] = {batch_size, past_length_ + 1};
+
+  std::vector<OrtValue> feeds;
+  feeds.reserve(feed_names_.size());
+
+  OrtValue input_ids = CreateInt32Tensor(token_dims);
+  OrtValue position_ids = CreateInt32Tensor(token_dims);
+  OrtValue attention_mask = CreateInt32Tensor(mask_dims);
+  auto* tokens = input_ids.GetMutable<Tensor>()->MutableData<int32_t>();
+  auto* positions = position_ids.GetMutable<Tensor>()->MutableData<int32_t>();
+  auto* mask = attention_mask.GetMutable<Tensor>()->MutableData<int32_t>();
+  for (const auto& request : batch_) {
+    *tokens++ = request->next_token;
+    *positions++ = narrow<int32_t>(request->past_length);
+    // The past of the sequence is right-aligned, and the new token follows it.
+    const int64_t padding = past_length_ - request->past_length;
+    mask = std::fill_n(mask, padding, 0);
+    mask = std::fill_n(mask, request->past_length + 1, 1);
+  }
+  feeds.push_back(input_ids);
+  feeds.push_back(position_ids);
+  feeds.push_back(attention_mask);
+  feeds.insert(feeds.end(), past_.cbegin(), past_.cend());
+
+  std::vector<OrtValue> fetches;
+  ORT_RETURN_IF_ERROR(Run(feeds, fetches));
+
+  past_.assign(fetches.begin() + 1, fetches.end());
+  ++past_length_;
+
+  const Tensor& logits = fetches[0].Get<Tensor>();
+  for (int64_t row = 0; row < batch_size; ++row) {
+    Request& request = *batch_[narrow<size_t>(row)];
+    ++request.past_length;
+    EmitToken(request, ArgMaxOfLastPosition(logits, row));
+  }
+
+  return Status::OK();
+}
+
+void GenerationEngine::EmitToken(Request& request, int32_t token) {
+  request.next_token = token;
+  ++request.num_new_tokens;
+  request.finished = token == eos_token_id_ || request.num_new_tokens == request.max_new_tokens;
+  request.callback(request.id, token, request.finished);
+}
+
+void GenerationEngine::RepackBatch(std::vector<std::unique_ptr<Request>>& admitted) {
+  // Where the past of a sequence of the new batch comes from: a row of the current batch or the prompt of a request.
+  struct Source {
+    const std::vector<OrtValue>* past;
+    int64_t row;
+  };
+
+  std::vector<std::unique_ptr<Request>> batch;
+  std::vector<Source> sources;
+  for (size_t row = 0; row < batch_.size(); ++row) {
+    if (!batch_[row]->finished) {
+      sources.push_back({&past_, narrow<int64_t>(row)});
+      batch.push_back(std::move(batch_[row]));
+    }
+  }
+  for (auto& request : admitted) {
+    if (!request->finished) {
+      sources.push_back({&request->prompt_past, 0});
+      batch.push_back(std::move(request));
+    }
+  }
+
+  int64_t past_length = 0;
+  for (const auto& request : batch) {
+    past_length = std::max(past_length, request->past_length);
+  }
+
+  const int64_t batch_size = narrow<int64_t>(batch.size());
+  const size_t position_bytes = SafeInt<size_t>(head_size_) * past_type_->Size();
+  std::vector<OrtValue> past(num_layers_);
+  for (int layer = 0; layer < num_layers_; ++layer) {
+    if (batch.empty()) {
+      break;
+    }
+
+    Tensor::InitOrtValue(past_type_, TensorShape({2, batch_size, num_heads_, past_length, head_size_}),
+                         cpu_allocator_, past[layer]);
+    Tensor& target = *past[layer].GetMutable<Tensor>();
+    // The padding is masked out, but is cleared so that it always holds finite values.
+    memset(target.MutableDataRaw(), 0, target.SizeInBytes());
+    auto* target_data = static_cast<uint8_t*>(target.MutableDataRaw());
+
+    for (int64_t row = 0; row < batch_size; ++row) {
+      const Tensor& source = (*sources[narrow<size_t>(row)].past)[layer].Get<Tensor>();
+      const int64_t source_batch_size = source.Shape()[1];
+      const int64_t source_past_length = source.Shape()[3];
+      const int64_t source_row = sources[narrow<size_t>(row)].row;
+      const int64_t length = batch[narrow<size_t>(row)]->past_length;
+      const auto* source_data = static_cast<const uint8_t*>(source.DataRaw());
+
+      for (int64_t kv = 0; kv < 2; ++kv) {
+        for (int64_t head = 0; head < num_heads_; ++head) {
+          const int64_t source_offset =
+              ((kv * source_batch_size + source_row) * num_heads_ + head) * source_past_length +
+              source_past_length - length;
+          const int64_t target_offset = ((kv * batch_size + row) * num_heads_ + head) * past_length +
+                                        past_length - length;
+          memcpy(target_data + SafeInt<size_t>(target_offset) * position_bytes,
+                 source_data + SafeInt<size_t>(source_offset) * position_bytes,
+                 SafeInt<size_t>(length) * position_bytes);
+        }
+      }
+    }
+  }
+
+  for (auto& request : batch) {
+    request->prompt_past.clear();
+  }
+
+  batch_ = std::move(batch);
+  past_ = std::move(past);
+  past_length_ = past_length;
+}
+
+Status GenerationEngine::Run(gsl::span<const OrtValue> feeds, std::vector<OrtValue>& fetches) const {
+  ORT_RETURN_IF_ERROR(run_fn_(feed_names_, feeds, output_names_, fetches));
+  ORT_RETURN_IF(fetches.size() != output_names_.size(), "The decoder returned ", fetches.size(),
+                " outputs, expected ", output_names_.size());
+  const int64_t batch_size = feeds[0].Get<Tensor>().Shape()[0];
+  const auto& logits_shape = fetches[0].Get<Tensor>().Shape();
+  ORT_RETURN_IF(logits_shape.NumDimensions() != 3 || logits_shape[0] != batch_size,
+                "The decoder logits are expected to have shape (batch_size, sequence_length, vocab_size), got ",
+                logits_shape);
+  return Status::OK();
+}
+
+OrtValue GenerationEngine::CreateInt32Tensor(gsl::span<const int64_t> dims) const {
+  OrtValue value;
+  Tensor::InitOrtValue(DataTypeImpl::GetType<int32_t>(), TensorShape(dims), cpu_allocator_, value);
+  return value;
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,142 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/status.h"
+#include "core/framework/allocator.h"
+#include "core/framework/data_types.h"
+#include "core/framework/ort_value.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+class InferenceSession;
+
+/**
+Generates tokens for a stream of requests with a GPT-2 decoder model, and batches the requests continuously.
+
+The decoder has the signature of the decoder subgraph of GreedySearch: the inputs are input_ids, position_ids and
+attention_mask (int32), followed by past_0 .. past_{L-1} with shape (2, batch_size, num_heads, past_sequence_length,
+head_size). The outputs are logits with shape (batch_size, sequence_length, vocab_size), followed by
+present_0 .. present_{L-1}.
+
+Each call to Step admits queued requests into the free slots of the batch. It runs the prompt of each admitted request
+through the decoder on its own, and then runs one decode step for all the sequences in the batch. Every token is
+passed to the callback of its request as soon as it is generated. A sequence leaves the batch when it generates the
+EOS token or reaches its maximum number of new tokens, which frees its slot for a queued request. Tokens are selected
+greedily.
+
+The past state of the batch is kept in one tensor per layer. The past of each sequence is right-aligned in its row, and
+the attention mask hides the padding on its left. The state is only repacked when sequences join or leave the batch.
+Otherwise the present outputs of a step are fed back as the past inputs of the next step.
+
+Requests can be added from any thread, but Step must not be called concurrently.
+*/
+class GenerationEngine {
+ public:
+  using RunFn = std::function<Status(gsl::span<const std::string> feed_names, gsl::span<const OrtValue> feeds,
+                                     gsl::span<const std::string> output_names, std::vector<OrtValue>& fetches)>;
+
+  /** Called with each generated token of a request. finished is true for the last token of the request. */
+  using TokenCallback = std::function<void(int64_t request_id, int32_t token, bool finished)>;
+
+  /**
+  Create an engine that runs the decoder loaded in an initialized session. The session must outlive the engine.
+  @param max_batch_size Maximum number of sequences decoded together.
+  @param eos_token_id Token that ends a sequence. A negative value disables it.
+  */
+  static Status Create(InferenceSession& session, size_t max_batch_size, int32_t eos_token_id,
+                       std::unique_ptr<GenerationEngine>& engine);
+
+  /**
+  @param num_layers Number of past inputs of the decoder.
+  @param past_type Element type of the past inputs.
+  @param cpu_allocator Allocator for the decoder inputs.
+  @param run_fn Function that runs the decoder.
+  */
+  GenerationEngine(size_t max_batch_size, int32_t eos_token_id, int num_layers, MLDataType past_type,
+                   int64_t num_heads, int64_t head_size, AllocatorPtr cpu_allocator, RunFn run_fn);
+
+  /**
+  Queue a request. It is admitted into the batch by a later call to Step.
+  @param prompt Token ids of the prompt. Must not be empty.
+  @param max_new_tokens Maximum number of tokens to generate. Must be greater than 0.
+  @param callback Called with each generated token, on the thread that calls Step.
+  @param request_id Id of the request, which is passed to the callback.
+  */
+  Status AddRequest(gsl::span<const int32_t> prompt, size_t max_new_tokens, TokenCallback callback,
+                    int64_t& request_id);
+
+  /**
+  Admit queued requests into the batch and generate the next token of every sequence in the batch.
+  @param has_pending_requests Set to true if requests are still queued or being generated.
+  */
+  Status Step(bool& has_pending_requests);
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(GenerationEngine);
+
+  struct Request {
+    int64_t id;
+    std::vector<int32_t> prompt;
+    size_t max_new_tokens;
+    TokenCallback callback;
+
+    size_t num_new_tokens{0};
+    // Last generated token, which is the input of the next decode step.
+    int32_t next_token{0};
+    // Number of tokens in the past state of the sequence.
+    int64_t past_length{0};
+    bool finished{false};
+    // Present outputs of the prompt, until the request joins the batch.
+    std::vector<OrtValue> prompt_past;
+  };
+
+  // Run the prompt of a request and generate its first token.
+  Status RunPrompt(Request& request);
+
+  // Run one decode step of the batch and generate the next token of each sequence.
+  Status RunDecodeStep();
+
+  // Record a token generated for a request and pass it to the callback.
+  void EmitToken(Request& request, int32_t token);
+
+  // Build the batch of the unfinished requests of batch_ followed by the admitted requests, and copy their past
+  // state into new past tensors.
+  void RepackBatch(std::vector<std::unique_ptr<Request>>& admitted);
+
+  Status Run(gsl::span<const OrtValue> feeds, std::vector<OrtValue>& fetches) const;
+
+  OrtValue CreateInt32Tensor(gsl::span<const int64_t> dims) const;
+
+  const size_t max_batch_size_;
+  const int32_t eos_token_id_;
+  const int num_layers_;
+  const MLDataType past_type_;
+  const int64_t num_heads_;
+  const int64_t head_size_;
+  AllocatorPtr cpu_allocator_;
+  RunFn run_fn_;
+  std::vector<std::string> feed_names_;
+  std::vector<std::string> output_names_;
+
+  // Requests in the batch, in the order of the rows of the past state.
+  std::vector<std::unique_ptr<Request>> batch_;
+  // Past state of the batch, one tensor per layer with shape (2, batch_size, num_heads, past_length_, head_size).
+  std::vector<OrtValue> past_;
+  int64_t past_length_{0};
+
+  OrtMutex mutex_;
+  std::deque<std::unique_ptr<Request>> queue_;
+  int64_t next_request_id_{0};
+};
+
+}  // namespace onnxruntime
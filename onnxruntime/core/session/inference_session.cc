@@ -689,10 +689,15 @@ common::Status InferenceSession::SaveToOrtFormat(const PathString& filepath) con
   ORT_RETURN_IF_ERROR(
       kernel_type_str_resolver.SaveToOrtFormat(builder, fbs_kernel_type_str_resolver));
 
+  flatbuffers::Offset<fbs::PrePackedInitializers> fbs_prepacked_initializers;
+  ORT_RETURN_IF_ERROR(
+      session_state_->SavePrePackedInitializersToOrtFormat(builder, fbs_prepacked_initializers));
+
   fbs::InferenceSessionBuilder sb(builder);
   sb.add_ort_version(ort_model_version);
   sb.add_model(fbs_model);
   sb.add_kernel_type_str_resolver(fbs_kernel_type_str_resolver);
+  sb.add_prepacked_initializers(fbs_prepacked_initializers);
   auto session = sb.Finish();
   builder.Finish(session, fbs::InferenceSessionIdentifier());
 
@@ -1460,6 +1465,10 @@ common::Status InferenceSession::Initialize() {
     session_activity_started_ = true;
 #endif
 
+    const bool use_shared_prepacked_weights_cache =
+        session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigDisableSharedPrepackedWeightsCache,
+                                                           "0") != "1";
+
     // now that we have all the execution providers, create the session state
     session_state_ = std::make_unique<SessionState>(
         model_->MainGraph(),
@@ -1470,7 +1479,9 @@ common::Status InferenceSession::Initialize() {
         *session_logger_,
         session_profiler_,
         session_options_,
-        prepacked_weights_container_);
+        prepacked_weights_container_,
+        nullptr,
+        use_shared_prepacked_weights_cache ? environment_.GetSharedPrepackedWeightsCache() : nullptr);
 
     bool use_env_allocators =
         session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigUseEnvAllocators, "0") == "1";
@@ -1702,6 +1713,16 @@ common::Status InferenceSession::Initialize() {
 #endif  // !defined(ORT_MINIMAL_BUILD) || defined(ORT_EXTENDED_MINIMAL_BUILD)
     }
 
+    if (loading_ort_format) {
+      // use the pre-packed weights saved with the model if there are any
+      const auto* fbs_prepacked_initializers =
+          fbs::GetInferenceSession(ort_format_model_bytes_.data())->prepacked_initializers();
+      if (fbs_prepacked_initializers != nullptr) {
+        session_state_->SetPrePackedInitializersFromOrtFormat(*fbs_prepacked_initializers,
+                                                              using_ort_model_bytes_for_initializers_);
+      }
+    }
+
     ORT_RETURN_IF_ERROR_SESSIONID_(
         session_state_->FinalizeSessionState(model_location_, kernel_registry_manager_,
                                              // need to keep the initializers if saving the optimized model
@@ -1758,6 +1779,8 @@ common::Status InferenceSession::Initialize() {
     // Resolve memory pattern flags of the main graph and subgraph session states
     ResolveMemoryPatternFlags(*session_state_);
 
+    ORT_RETURN_IF_ERROR_SESSIONID_(InitializeDynamicBatcher());
+
     is_inited_ = true;
 
     if (!using_ort_model_bytes_for_initializers_) {
@@ -2145,6 +2168,18 @@ Status InferenceSession::Run(const RunOptions& run_options,
                              gsl::span<const std::string> feed_names, gsl::span<const OrtValue> feeds,
                              gsl::span<const std::string> output_names, std::vector<OrtValue>* p_fetches,
                              const std::vector<OrtDevice>* p_fetches_device_info) {
+  if (dynamic_batcher_ &&
+      dynamic_batcher_->CanBatch(run_options, feeds, output_names, p_fetches, p_fetches_device_info)) {
+    return dynamic_batcher_->Run(run_options, feed_names, feeds, output_names, *p_fetches);
+  }
+
+  return RunImpl(run_options, feed_names, feeds, output_names, p_fetches, p_fetches_device_info);
+}
+
+Status InferenceSession::RunImpl(const RunOptions& run_options,
+                                 gsl::span<const std::string> feed_names, gsl::span<const OrtValue> feeds,
+                                 gsl::span<const std::string> output_names, std::vector<OrtValue>* p_fetches,
+                                 const std::vector<OrtDevice>* p_fetches_device_info) {
   TimePoint tp;
   if (session_profiler_.IsEnabled()) {
     tp = session_profiler_.Start();
@@ -2199,6 +2234,18 @@ Status InferenceSession::Run(const RunOptions& run_options,
         ORT_RETURN_IF_ERROR_SESSIONID_(ValidateAndParseShrinkArenaString(shrink_memory_arenas, arenas_to_shrink));
       }
 
+      // share of the intra-op thread pool this run may use while other runs execute concurrently
+      int intra_op_thread_budget = 0;
+      const std::string& intra_op_thread_budget_str =
+          run_options.config_options.GetConfigOrDefault(kOrtRunOptionsConfigIntraOpThreadBudget, "0");
+      if (!TryParseStringWithClassicLocale(intra_op_thread_budget_str, intra_op_thread_budget) ||
+          intra_op_thread_budget < 0) {
+        ORT_RETURN_IF_ERROR_SESSIONID_(ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                                                       "Invalid value for ", kOrtRunOptionsConfigIntraOpThreadBudget,
+                                                       ": '", intra_op_thread_budget_str,
+                                                       "'. Expected a non-negative integer."));
+      }
+
       FeedsFetchesInfo info(feed_names, output_names, session_state_->GetOrtValueNameIdxMap());
       FeedsFetchesManager feeds_fetches_manager{std::move(info)};
 
@@ -2260,6 +2307,8 @@ Status InferenceSession::Run(const RunOptions& run_options,
 #endif
 
       if (retval.IsOK()) {
+        concurrency::ThreadPool::ThreadBudgetScope intra_op_thread_budget_scope(GetIntraOpThreadPoolToUse(),
+                                                                               intra_op_thread_budget);
         retval = utils::ExecuteGraph(*session_state_, feeds_fetches_manager, feeds, *p_fetches,
                                      session_options_.execution_mode,
                                      run_options,
@@ -2707,6 +2756,56 @@ void InferenceSession::ShrinkMemoryArenas(gsl::span<const AllocatorPtr> arenas_t
   }
 }
 
+common::Status InferenceSession::InitializeDynamicBatcher() {
+  int64_t max_batch_size = 0;
+  int64_t max_queue_delay_us = 0;
+  ORT_RETURN_IF_ERROR(ParseStringWithClassicLocale(
+      session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigDynamicBatchingMaxBatchSize, "0"),
+      max_batch_size));
+  ORT_RETURN_IF_ERROR(ParseStringWithClassicLocale(
+      session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigDynamicBatchingMaxQueueDelayUs,
+                                                         "1000"),
+      max_queue_delay_us));
+  ORT_RETURN_IF(max_batch_size < 0 || max_queue_delay_us < 0,
+                "Dynamic batching max batch size and max queue delay must be non-negative.");
+
+  if (max_batch_size <= 1) {
+    return Status::OK();
+  }
+
+  if (!is_concurrent_run_supported_) {
+    LOGS(*session_logger_, WARNING) << "Dynamic batching is disabled as the session does not support concurrent Run "
+                                    << "calls.";
+    return Status::OK();
+  }
+
+  // dimension 0 of every input and output is the batch dimension, so it can't have a fixed value
+  const auto& graph_viewer = session_state_->GetGraphViewer();
+  for (const auto* defs : {&graph_viewer.GetInputs(), &graph_viewer.GetOutputs()}) {
+    for (const auto* node_arg : *defs) {
+      const auto* shape = node_arg->Shape();
+      if (shape != nullptr && (shape->dim_size() == 0 || shape->dim(0).has_dim_value())) {
+        LOGS(*session_logger_, WARNING) << "Dynamic batching is disabled as dimension 0 of '" << node_arg->Name()
+                                        << "' is not a batch dimension.";
+        return Status::OK();
+      }
+    }
+  }
+
+  dynamic_batcher_ = std::make_unique<DynamicBatcher>(
+      max_batch_size, std::chrono::microseconds(max_queue_delay_us),
+      session_state_->GetAllocator(OrtDevice()),
+      [this](const RunOptions& run_options, gsl::span<const std::string> feed_names, gsl::span<const OrtValue> feeds,
+             gsl::span<const std::string> output_names, std::vector<OrtValue>* p_fetches) {
+        return RunImpl(run_options, feed_names, feeds, output_names, p_fetches, nullptr);
+      },
+      session_profiler_, *session_logger_);
+
+  LOGS(*session_logger_, INFO) << "Dynamic batching enabled with max batch size " << max_batch_size
+                               << " and max queue delay " << max_queue_delay_us << "us.";
+  return Status::OK();
+}
+
 #if !defined(ORT_MINIMAL_BUILD)
 // assumes model has already been loaded before
 common::Status InferenceSession::DoPostLoadProcessing(onnxruntime::Model& model) {
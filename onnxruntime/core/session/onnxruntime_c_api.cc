@@ -27,6 +27,7 @@
 #include "core/framework/ort_value.h"
 #include "core/providers/get_execution_providers.h"
 #include "core/session/environment.h"
+#include "core/session/generation_engine.h"
 #include "core/framework/callback.h"
 #include "core/framework/tensorprotoutils.h"
 #include "core/framework/onnxruntime_typeinfo.h"
@@ -870,6 +871,53 @@ ORT_API_STATUS_IMPL(OrtApis::RunAsync, _Inout_ OrtSession* sess, _In_opt_ const
   API_IMPL_END
 }
 
+ORT_API_STATUS_IMPL(OrtApis::CreateGenerationEngine, _Inout_ OrtSession* sess, _In_ size_t max_batch_size,
+                    _In_ int32_t eos_token_id, _Outptr_ OrtGenerationEngine** out) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+  std::unique_ptr<::onnxruntime::GenerationEngine> engine;
+  ORT_API_RETURN_IF_STATUS_NOT_OK(::onnxruntime::GenerationEngine::Create(*session, max_batch_size, eos_token_id,
+                                                                          engine));
+  *out = reinterpret_cast<OrtGenerationEngine*>(engine.release());
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::GenerationEngine_AddRequest, _Inout_ OrtGenerationEngine* engine,
+                    _In_reads_(prompt_length) const int32_t* prompt, _In_ size_t prompt_length,
+                    _In_ size_t max_new_tokens, _In_ OrtGenerationTokenCallbackFn callback, _In_opt_ void* user_data,
+                    _Out_ int64_t* request_id) {
+  API_IMPL_BEGIN
+  if (callback == nullptr) {
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "callback must not be null");
+  }
+
+  auto generation_engine = reinterpret_cast<::onnxruntime::GenerationEngine*>(engine);
+  ORT_API_RETURN_IF_STATUS_NOT_OK(generation_engine->AddRequest(
+      gsl::make_span(prompt, prompt_length), max_new_tokens,
+      [callback, user_data](int64_t id, int32_t token, bool finished) {
+        callback(user_data, id, token, finished ? 1 : 0);
+      },
+      *request_id));
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::GenerationEngine_Step, _Inout_ OrtGenerationEngine* engine,
+                    _Out_ int* has_pending_requests) {
+  API_IMPL_BEGIN
+  auto generation_engine = reinterpret_cast<::onnxruntime::GenerationEngine*>(engine);
+  bool has_pending = false;
+  ORT_API_RETURN_IF_STATUS_NOT_OK(generation_engine->Step(has_pending));
+  *has_pending_requests = has_pending ? 1 : 0;
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API(void, OrtApis::ReleaseGenerationEngine, _Frees_ptr_opt_ OrtGenerationEngine* engine) {
+  delete reinterpret_cast<::onnxruntime::GenerationEngine*>(engine);
+}
+
 struct OrtIoBinding {
   std::unique_ptr<::onnxruntime::IOBinding> binding_;
   explicit OrtIoBinding(std::unique_ptr<::onnxruntime::IOBinding>&& binding) : binding_(std::move(binding)) {}
@@ -2230,6 +2278,8 @@ ORT_API_STATUS_IMPL(OrtApis::CreateArenaCfgV2, _In_reads_(num_keys) const char*
       cfg->initial_growth_chunk_size_bytes = static_cast<int>(arena_config_values[i]);
     } else if (strcmp(arena_config_keys[i], "max_power_of_two_extend_bytes") == 0) {
       cfg->max_power_of_two_extend_bytes = static_cast<int64_t>(arena_config_values[i]);
+    } else if (strcmp(arena_config_keys[i], "thread_cache_max_bytes") == 0) {
+      cfg->thread_cache_max_bytes = static_cast<int64_t>(arena_config_values[i]);
     } else {
       std::ostringstream oss;
       oss << "Invalid key found: " << arena_config_keys[i];
@@ -2713,6 +2763,11 @@ static constexpr OrtApi ort_api_1_to_17 = {
     &OrtApis::GetCUDAProviderOptionsByName,
     &OrtApis::KernelContext_GetResource,
     // End of Version 16 - DO NOT MODIFY ABOVE (see above text for more information)
+
+    &OrtApis::CreateGenerationEngine,
+    &OrtApis::GenerationEngine_AddRequest,
+    &OrtApis::GenerationEngine_Step,
+    &OrtApis::ReleaseGenerationEngine,
 };
 
 // OrtApiBase can never change as there is no way to know what version of OrtApiBase is returned by OrtGetApiBase.
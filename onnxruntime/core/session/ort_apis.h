@@ -491,4 +491,13 @@ ORT_API_STATUS_IMPL(GetTensorRTProviderOptionsByName, _In_ const OrtTensorRTProv
 ORT_API_STATUS_IMPL(UpdateCUDAProviderOptionsWithValue, _Inout_ OrtCUDAProviderOptionsV2* cuda_options, _In_ const char* key, _In_ void* value);
 ORT_API_STATUS_IMPL(GetCUDAProviderOptionsByName, _In_ const OrtCUDAProviderOptionsV2* cuda_options, _In_ const char* key, _Outptr_ void** ptr);
 ORT_API_STATUS_IMPL(KernelContext_GetResource, _In_ const OrtKernelContext* context, _In_ int resource_version, _In_ int resource_id, _Outptr_ void** stream);
+
+ORT_API_STATUS_IMPL(CreateGenerationEngine, _Inout_ OrtSession* session, _In_ size_t max_batch_size,
+                    _In_ int32_t eos_token_id, _Outptr_ OrtGenerationEngine** out);
+ORT_API_STATUS_IMPL(GenerationEngine_AddRequest, _Inout_ OrtGenerationEngine* engine,
+                    _In_reads_(prompt_length) const int32_t* prompt, _In_ size_t prompt_length,
+                    _In_ size_t max_new_tokens, _In_ OrtGenerationTokenCallbackFn callback, _In_opt_ void* user_data,
+                    _Out_ int64_t* request_id);
+ORT_API_STATUS_IMPL(GenerationEngine_Step, _Inout_ OrtGenerationEngine* engine, _Out_ int* has_pending_requests);
+ORT_API(void, ReleaseGenerationEngine, _Frees_ptr_opt_ OrtGenerationEngine*);
 }  // namespace OrtApis
@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #include "core/common/utf8_util.h"
+#include "core/common/utf8_case.h"
 #include "gtest/gtest.h"
 
 namespace onnxruntime {
@@ -41,5 +42,71 @@ TEST(Utf8UtilTest, Validate) {
   }
 }
 
+TEST(Utf8UtilTest, Decode) {
+  using namespace utf8_util;
+  for (auto& s : samples) {
+    const auto* p = reinterpret_cast<const unsigned char*>(s.sequence);
+    const size_t len = strnlen(s.sequence, onnxruntime::kMaxStrLen);
+    char32_t code_point = 0;
+    const size_t bytes = utf8_decode(p, len, code_point);
+    ASSERT_EQ(s.valid, bytes == len);
+    if (s.valid) {
+      unsigned char encoded[4];
+      ASSERT_EQ(utf8_encode(code_point, encoded), len);
+      ASSERT_EQ(memcmp(encoded, p, len), 0);
+    }
+  }
+
+  // Overlong encodings and surrogates are rejected.
+  for (const char* sequence : {"\xc0\x80", "\xc1\xbf", "\xe0\x80\x80", "\xed\xa0\x80", "\xf4\x90\x80\x80"}) {
+    char32_t code_point = 0;
+    ASSERT_EQ(utf8_decode(reinterpret_cast<const unsigned char*>(sequence), strlen(sequence), code_point), 0u);
+  }
+}
+
+TEST(Utf8UtilTest, ChangeCase) {
+  using namespace utf8_util;
+  struct CaseSample {
+    std::string text;
+    std::string upper;
+    std::string lower;
+  };
+  const std::vector<CaseSample> case_samples = {
+      {"", "", ""},
+      {"Hello, World! [ASCII @ `text` {longer than a word}]", "HELLO, WORLD! [ASCII @ `TEXT` {LONGER THAN A WORD}]",
+       "hello, world! [ascii @ `text` {longer than a word}]"},
+      {"\xc3\xa9" "cole \xc3\x89" "COLE", "\xc3\x89" "COLE \xc3\x89" "COLE", "\xc3\xa9" "cole \xc3\xa9" "cole"},
+      // Cyrillic, greek final sigma and the eszett, which has no single character upper case.
+      {"\xd0\x9f\xd1\x80\xd0\xb8\xd0\xb2\xd0\xb5\xd1\x82", "\xd0\x9f\xd0\xa0\xd0\x98\xd0\x92\xd0\x95\xd0\xa2",
+       "\xd0\xbf\xd1\x80\xd0\xb8\xd0\xb2\xd0\xb5\xd1\x82"},
+      {"\xcf\x82\xce\xa3", "\xce\xa3\xce\xa3", "\xcf\x82\xcf\x83"},
+      {"stra\xc3\x9f" "e", "STRA\xc3\x9f" "E", "stra\xc3\x9f" "e"},
+      // U+023A lower case is U+2C65, which is one byte longer. The Kelvin sign lower case is ASCII.
+      {"\xc8\xba\xc8\xba\xe2\x84\xaa", "\xc8\xba\xc8\xba\xe2\x84\xaa", "\xe2\xb1\xa5\xe2\xb1\xa5k"},
+      // Characters outside of the BMP.
+      {"\xf0\x90\x90\x80\xf0\x90\x90\xa8", "\xf0\x90\x90\x80\xf0\x90\x90\x80", "\xf0\x90\x90\xa8\xf0\x90\x90\xa8"},
+      {"\xe4\xb8\xad\xe6\x96\x87", "\xe4\xb8\xad\xe6\x96\x87", "\xe4\xb8\xad\xe6\x96\x87"},
+  };
+
+  for (const auto& sample : case_samples) {
+    for (bool upper : {true, false}) {
+      std::string out(utf8_change_case_bound(sample.text.size()), '\0');
+      size_t out_len = 0;
+      ASSERT_TRUE(utf8_change_case(reinterpret_cast<const unsigned char*>(sample.text.data()), sample.text.size(),
+                                   upper, reinterpret_cast<unsigned char*>(&out[0]), out_len));
+      out.resize(out_len);
+      EXPECT_EQ(out, upper ? sample.upper : sample.lower) << sample.text;
+    }
+  }
+
+  for (auto& s : samples) {
+    const size_t len = strnlen(s.sequence, onnxruntime::kMaxStrLen);
+    std::string out(utf8_change_case_bound(len), '\0');
+    size_t out_len = 0;
+    EXPECT_EQ(s.valid, utf8_change_case(reinterpret_cast<const unsigned char*>(s.sequence), len, true,
+                                        reinterpret_cast<unsigned char*>(&out[0]), out_len));
+  }
+}
+
 }  // namespace test
 }  // namespace onnxruntime
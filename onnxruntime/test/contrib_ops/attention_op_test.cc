@@ -302,6 +302,69 @@ static void RunAttentionTest(
                    kv_sequence_length, past_present_share_buffer, use_scale, do_neox_rotary);
 }
 
+// Run Attention on CPU with the past state in pages. The past and present data have the dense layout
+// (2, batch_size, num_heads, sequence_length, head_size), and are scattered to the pages listed in page_table.
+static void RunPagedAttentionTest(
+    const std::vector<float>& input_data,
+    const std::vector<float>& weights_data,
+    const std::vector<float>& bias_data,
+    const std::vector<float>& output_data,
+    const std::vector<float>& past_data,
+    const std::vector<float>& present_data,
+    int batch_size,
+    int sequence_length,
+    int hidden_size,
+    int number_of_heads,
+    bool is_unidirectional,
+    int past_sequence_length,
+    int page_size,
+    int num_pages,
+    const std::vector<int32_t>& page_table) {
+  const int head_size = hidden_size / number_of_heads;
+  const int max_pages_per_sequence = static_cast<int>(page_table.size()) / batch_size;
+
+  auto to_pages = [&](const std::vector<float>& dense, int dense_sequence_length) {
+    std::vector<float> pages(2LL * num_pages * number_of_heads * page_size * head_size, 0.0f);
+    for (int kv = 0; kv < 2; kv++) {
+      for (int b = 0; b < batch_size; b++) {
+        for (int n = 0; n < number_of_heads; n++) {
+          for (int t = 0; t < dense_sequence_length; t++) {
+            const int page = page_table[b * max_pages_per_sequence + t / page_size];
+            const float* src = dense.data() +
+                               (((kv * batch_size + b) * number_of_heads + n) * dense_sequence_length + t) * head_size;
+            float* dst = pages.data() + (((kv * num_pages + page) * number_of_heads + n) * page_size + t % page_size) *
+                                            head_size;
+            std::copy_n(src, head_size, dst);
+          }
+        }
+      }
+    }
+    return pages;
+  };
+
+  OpTester tester("Attention", 1, onnxruntime::kMSDomain);
+  tester.AddAttribute<int64_t>("num_heads", static_cast<int64_t>(number_of_heads));
+  tester.AddAttribute<int64_t>("unidirectional", static_cast<int64_t>(is_unidirectional ? 1 : 0));
+  tester.AddAttribute<int64_t>("past_present_share_buffer", static_cast<int64_t>(1));
+
+  std::vector<int64_t> cache_dims = {2, num_pages, number_of_heads, page_size, head_size};
+  tester.AddInput<float>("input", {batch_size, sequence_length, hidden_size}, input_data);
+  tester.AddInput<float>("weight", {hidden_size, 3 * hidden_size}, weights_data);
+  tester.AddInput<float>("bias", {3 * hidden_size}, bias_data);
+  tester.AddOptionalInputEdge<int32_t>();
+  tester.AddInput<float>("past", cache_dims, to_pages(past_data, past_sequence_length));
+  tester.AddOptionalInputEdge<float>();
+  tester.AddInput<int32_t>("past_sequence_length", {1}, {past_sequence_length});
+  tester.AddInput<int32_t>("page_table", {batch_size, max_pages_per_sequence}, page_table);
+
+  tester.AddOutput<float>("output", {batch_size, sequence_length, hidden_size}, output_data);
+  tester.AddOutput<float>("present", cache_dims, to_pages(present_data, past_sequence_length + sequence_length));
+
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(DefaultCpuExecutionProvider());
+  tester.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+}
+
 TEST(AttentionTest, AttentionBatch1) {
   int batch_size = 1;
   int sequence_length = 2;
@@ -1036,7 +1099,7 @@ TEST(AttentionTest, AttentionPastStateBatch1_SharedPastPresent) {
   RawAttentionPastStateBatch1(true);
 }
 
-void RawAttentionPastStateBatch2(bool past_present_share_buffer) {
+void RawAttentionPastStateBatch2(bool past_present_share_buffer, bool paged_past_present = false) {
   int batch_size = 2;
   int sequence_length = 1;
   int hidden_size = 4;
@@ -1144,7 +1207,15 @@ void RawAttentionPastStateBatch2(bool past_present_share_buffer) {
   bool use_past_state = true;
   int past_sequence_length = 3;
 
-  if (!past_present_share_buffer) {
+  if (paged_past_present) {
+    // Pages of 2 tokens, which are not in the order of the sequences. Page 2 is not used.
+    constexpr int page_size = 2;
+    constexpr int num_pages = 5;
+    std::vector<int32_t> page_table = {3, 0, 1, 4};
+    RunPagedAttentionTest(input_data, weight_data, bias_data, output_data, past_data, present_data,
+                          batch_size, sequence_length, hidden_size, number_of_heads, is_unidirectional,
+                          past_sequence_length, page_size, num_pages, page_table);
+  } else if (!past_present_share_buffer) {
     RunAttentionTest(input_data, weight_data, bias_data, mask_index_data, output_data,
                      batch_size, sequence_length, hidden_size, number_of_heads, false, is_unidirectional,
                      use_past_state, past_sequence_length, &past_data, &present_data);
@@ -1169,6 +1240,10 @@ TEST(AttentionTest, AttentionPastStateBatch2_SharedPastPresent) {
   RawAttentionPastStateBatch2(true);
 }
 
+TEST(AttentionTest, AttentionPastStateBatch2_PagedPastPresent) {
+  RawAttentionPastStateBatch2(true, true);
+}
+
 void RawAttentionPastStateBatch2WithPadding(bool past_present_share_buffer) {
   int batch_size = 2;
   int sequence_length = 1;
@@ -1,12 +1,18 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
+#include <map>
 #include <memory>
+#include <numeric>
+#include <string>
 #include <vector>
 #include "gtest/gtest.h"
 #include "core/common/gsl.h"
+#include "core/graph/model.h"
 #include "core/session/onnxruntime_cxx_api.h"
 #include "test/common/cuda_op_test_utils.h"
+#include "test/util/include/asserts.h"
 
 extern std::unique_ptr<Ort::Env> ort_env;
 
@@ -143,5 +149,269 @@ TEST(GreedySearchTest, GptGreedySearchFp32) {
   }
 }
 
+namespace {
+// Runs tiny_gpt2_greedysearch_with_init_decoder.onnx on CPU with the eos_token_id attribute replaced.
+void RunGptGreedySearchOnCpu(int64_t eos_token_id, const std::vector<int32_t>& input_ids,
+                             const std::vector<int64_t>& input_ids_shape, int32_t max_length,
+                             std::vector<int32_t>& sequences, int64_t& pad_token_id) {
+  ONNX_NAMESPACE::ModelProto model_proto;
+  ASSERT_STATUS_OK(Model::Load(ORT_TSTR("testdata/transformers/tiny_gpt2_greedysearch_with_init_decoder.onnx"),
+                               model_proto));
+  for (auto& node : *model_proto.mutable_graph()->mutable_node()) {
+    if (node.op_type() != "GreedySearch") {
+      continue;
+    }
+    for (auto& attribute : *node.mutable_attribute()) {
+      if (attribute.name() == "eos_token_id") {
+        attribute.set_i(eos_token_id);
+      } else if (attribute.name() == "pad_token_id") {
+        pad_token_id = attribute.i();
+      }
+    }
+  }
+  std::string model_data;
+  ASSERT_TRUE(model_proto.SerializeToString(&model_data));
+
+  std::vector<int64_t> parameter_shape{1};
+  std::vector<int32_t> max_length_data{max_length};
+  std::vector<int32_t> min_length{1};
+  std::vector<float> repetition_penalty{1.0f};
+
+  Ort::MemoryInfo info("Cpu", OrtDeviceAllocator, 0, OrtMemTypeDefault);
+  std::vector<Ort::Value> ort_inputs;
+  ort_inputs.push_back(Ort::Value::CreateTensor(info, const_cast<int32_t*>(input_ids.data()), input_ids.size(),
+                                                input_ids_shape.data(), input_ids_shape.size()));
+  ort_inputs.push_back(Ort::Value::CreateTensor(info, max_length_data.data(), max_length_data.size(),
+                                                parameter_shape.data(), parameter_shape.size()));
+  ort_inputs.push_back(Ort::Value::CreateTensor(info, min_length.data(), min_length.size(),
+                                                parameter_shape.data(), parameter_shape.size()));
+  ort_inputs.push_back(Ort::Value::CreateTensor(info, repetition_penalty.data(), repetition_penalty.size(),
+                                                parameter_shape.data(), parameter_shape.size()));
+  const char* input_names[] = {"input_ids", "max_length", "min_length", "repetition_penalty"};
+  const char* const output_names[] = {"sequences"};
+
+  Ort::Session session(*ort_env, model_data.data(), model_data.size(), Ort::SessionOptions{});
+  auto ort_outputs = session.Run(Ort::RunOptions{}, input_names, ort_inputs.data(), ort_inputs.size(),
+                                 output_names, 1);
+  ASSERT_EQ(ort_outputs.size(), 1U);
+  std::vector<int64_t> expected_output_shape{input_ids_shape[0], max_length};
+  ASSERT_EQ(expected_output_shape, ort_outputs[0].GetTensorTypeAndShapeInfo().GetShape());
+  const auto* result_vals = ort_outputs[0].GetTensorData<int32_t>();
+  sequences.assign(result_vals, result_vals + input_ids_shape[0] * max_length);
+}
+}  // namespace
+
+// On CPU, the sequences that meet the EOS token are removed from the batch of the decoder subgraph. The sequences
+// that keep running shall generate the same tokens as in a run where no sequence finishes early.
+TEST(GreedySearchTest, GptGreedySearchRetiresFinishedSequences) {
+  // The rows 0 and 2 generate 731, 114, 114, ... and the rows 1 and 3 generate 204, 204, ...
+  std::vector<int64_t> input_ids_shape{4, 4};
+  std::vector<int32_t> input_ids{
+      0, 0, 195, 731,
+      0, 0, 0, 52,
+      0, 0, 195, 731,
+      0, 0, 0, 52};
+  constexpr int32_t max_length = 10;
+  constexpr int32_t eos_token_id = 114;
+  const int64_t sequence_length = input_ids_shape[1];
+
+  int64_t pad_token_id = 0;
+  std::vector<int32_t> reference;
+  RunGptGreedySearchOnCpu(-1, input_ids, input_ids_shape, max_length, reference, pad_token_id);
+  std::vector<int32_t> sequences;
+  RunGptGreedySearchOnCpu(eos_token_id, input_ids, input_ids_shape, max_length, sequences, pad_token_id);
+
+  std::vector<bool> finishes_early;
+  for (int64_t row = 0; row < input_ids_shape[0]; ++row) {
+    auto begin = reference.cbegin() + row * max_length;
+    finishes_early.push_back(std::find(begin + sequence_length, begin + max_length - 1, eos_token_id) !=
+                             begin + max_length - 1);
+  }
+  ASSERT_EQ(finishes_early, (std::vector<bool>{true, false, true, false}));
+
+  for (int64_t row = 0; row < input_ids_shape[0]; ++row) {
+    bool eos_met = false;
+    for (int64_t i = 0; i < max_length; ++i) {
+      const size_t index = static_cast<size_t>(row * max_length + i);
+      eos_met = eos_met || (i >= sequence_length && reference[index] == eos_token_id);
+      // The EOS token and the tokens after it are replaced by the padding token.
+      EXPECT_EQ(sequences[index], eos_met ? static_cast<int32_t>(pad_token_id) : reference[index])
+          << "row " << row << ", position " << i;
+    }
+  }
+}
+
+namespace {
+// Loads the GPT-2 decoder subgraph of tiny_gpt2_beamsearch.onnx as a model. Unlike the decoder of the greedy search
+// models, it accepts input_ids with any sequence length, so it can also run the prompts.
+void LoadGptDecoder(std::string& model_data) {
+  ONNX_NAMESPACE::ModelProto model_proto;
+  ASSERT_STATUS_OK(Model::Load(ORT_TSTR("testdata/transformers/tiny_gpt2_beamsearch.onnx"), model_proto));
+
+  ONNX_NAMESPACE::ModelProto decoder_proto;
+  decoder_proto.set_ir_version(model_proto.ir_version());
+  *decoder_proto.mutable_opset_import() = model_proto.opset_import();
+  auto* ms_opset = decoder_proto.add_opset_import();
+  ms_opset->set_domain(kMSDomain);
+  ms_opset->set_version(1);
+  for (const auto& node : model_proto.graph().node()) {
+    for (const auto& attribute : node.attribute()) {
+      if (node.op_type() == "BeamSearch" && attribute.name() == "decoder") {
+        *decoder_proto.mutable_graph() = attribute.g();
+      }
+    }
+  }
+  ASSERT_TRUE(decoder_proto.has_graph());
+  ASSERT_TRUE(decoder_proto.SerializeToString(&model_data));
+}
+
+// Generates the tokens of a single sequence with the decoder, feeding the present state back as past state.
+std::vector<int32_t> GenerateGreedily(Ort::Session& session, const std::vector<int32_t>& prompt,
+                                      size_t max_new_tokens) {
+  const size_t num_layers = session.GetInputCount() - 3;
+  std::vector<std::string> names{"input_ids", "position_ids", "attention_mask"};
+  std::vector<std::string> output_names{"logits"};
+  for (size_t layer = 0; layer < num_layers; ++layer) {
+    names.push_back("past_" + std::to_string(layer));
+    output_names.push_back("present_" + std::to_string(layer));
+  }
+  std::vector<const char*> input_name_ptrs;
+  std::vector<const char*> output_name_ptrs;
+  for (const auto& name : names) input_name_ptrs.push_back(name.c_str());
+  for (const auto& name : output_names) output_name_ptrs.push_back(name.c_str());
+
+  Ort::MemoryInfo info("Cpu", OrtDeviceAllocator, 0, OrtMemTypeDefault);
+  Ort::AllocatorWithDefaultOptions allocator;
+  std::vector<int64_t> past_shape = session.GetInputTypeInfo(3).GetTensorTypeAndShapeInfo().GetShape();
+  past_shape[1] = 1;
+  past_shape[3] = 0;
+  std::vector<Ort::Value> past;
+  for (size_t layer = 0; layer < num_layers; ++layer) {
+    past.push_back(Ort::Value::CreateTensor<float>(allocator, past_shape.data(), past_shape.size()));
+  }
+
+  std::vector<int32_t> input_ids = prompt;
+  std::vector<int32_t> position_ids(prompt.size());
+  std::iota(position_ids.begin(), position_ids.end(), 0);
+  std::vector<int32_t> attention_mask(prompt.size(), 1);
+
+  std::vector<int32_t> tokens;
+  while (tokens.size() < max_new_tokens) {
+    std::vector<int64_t> ids_shape{1, static_cast<int64_t>(input_ids.size())};
+    std::vector<int64_t> mask_shape{1, static_cast<int64_t>(attention_mask.size())};
+    std::vector<Ort::Value> inputs;
+    inputs.push_back(Ort::Value::CreateTensor(info, input_ids.data(), input_ids.size(), ids_shape.data(), 2));
+    inputs.push_back(Ort::Value::CreateTensor(info, position_ids.data(), position_ids.size(), ids_shape.data(), 2));
+    inputs.push_back(Ort::Value::CreateTensor(info, attention_mask.data(), attention_mask.size(),
+                                              mask_shape.data(), 2));
+    for (auto& value : past) {
+      inputs.push_back(std::move(value));
+    }
+
+    auto outputs = session.Run(Ort::RunOptions{}, input_name_ptrs.data(), inputs.data(), inputs.size(),
+                               output_name_ptrs.data(), output_name_ptrs.size());
+
+    const auto logits_shape = outputs[0].GetTensorTypeAndShapeInfo().GetShape();
+    const int64_t vocab_size = logits_shape[2];
+    const float* last = outputs[0].GetTensorData<float>() + (logits_shape[1] - 1) * vocab_size;
+    tokens.push_back(static_cast<int32_t>(std::max_element(last, last + vocab_size) - last));
+
+    const int32_t position = position_ids.back() + 1;
+    input_ids = {tokens.back()};
+    position_ids = {position};
+    attention_mask.push_back(1);
+    past.clear();
+    for (size_t i = 1; i < outputs.size(); ++i) {
+      past.push_back(std::move(outputs[i]));
+    }
+  }
+
+  return tokens;
+}
+
+struct GeneratedTokens {
+  std::map<int64_t, std::vector<int32_t>> tokens;
+  std::map<int64_t, int> num_finished;
+};
+
+void CollectToken(void* user_data, int64_t request_id, int32_t token, int finished) {
+  auto* generated = static_cast<GeneratedTokens*>(user_data);
+  // No token may follow the last token of a request.
+  EXPECT_EQ(generated->num_finished[request_id], 0);
+  generated->tokens[request_id].push_back(token);
+  generated->num_finished[request_id] += finished != 0 ? 1 : 0;
+}
+}  // namespace
+
+// Requests are admitted into the batch while other sequences are being generated, and leave it at different steps.
+// Each sequence shall generate the same tokens as when it is generated on its own.
+TEST(GenerationEngineTest, ContinuousBatching) {
+  std::string model_data;
+  LoadGptDecoder(model_data);
+  Ort::Session session(*ort_env, model_data.data(), model_data.size(), Ort::SessionOptions{});
+
+  const std::vector<std::vector<int32_t>> prompts{
+      {52}, {195, 731}, {41, 554, 74, 622, 206}, {0, 52, 328}, {731}};
+  const std::vector<size_t> max_new_tokens{6, 3, 5, 8, 4};
+
+  Ort::GenerationEngine engine(session, 2, -1);
+  GeneratedTokens generated;
+  std::vector<int64_t> request_ids;
+  for (size_t i = 0; i < 3; ++i) {
+    request_ids.push_back(engine.AddRequest(prompts[i].data(), prompts[i].size(), max_new_tokens[i],
+                                            CollectToken, &generated));
+  }
+
+  ASSERT_TRUE(engine.Step());
+  for (size_t i = 3; i < prompts.size(); ++i) {
+    request_ids.push_back(engine.AddRequest(prompts[i].data(), prompts[i].size(), max_new_tokens[i],
+                                            CollectToken, &generated));
+  }
+
+  while (engine.Step()) {
+  }
+
+  for (size_t i = 0; i < prompts.size(); ++i) {
+    EXPECT_EQ(generated.tokens[request_ids[i]], GenerateGreedily(session, prompts[i], max_new_tokens[i]))
+        << "request " << i;
+    EXPECT_EQ(generated.num_finished[request_ids[i]], 1) << "request " << i;
+  }
+}
+
+// A sequence leaves the batch after it generates the EOS token, and the other sequences keep running.
+TEST(GenerationEngineTest, EosToken) {
+  std::string model_data;
+  LoadGptDecoder(model_data);
+  Ort::Session session(*ort_env, model_data.data(), model_data.size(), Ort::SessionOptions{});
+
+  const std::vector<int32_t> prompt_0{195, 731};
+  const std::vector<int32_t> prompt_1{41, 554, 74, 622, 206};
+  constexpr size_t max_new_tokens = 6;
+  const std::vector<int32_t> reference_0 = GenerateGreedily(session, prompt_0, max_new_tokens);
+  const std::vector<int32_t> reference_1 = GenerateGreedily(session, prompt_1, max_new_tokens);
+
+  // The second token of the first sequence is the EOS token. Each sequence ends at its first occurrence.
+  const int32_t eos_token_id = reference_0[1];
+  auto expected_0 = reference_0;
+  expected_0.erase(std::find(expected_0.begin(), expected_0.end(), eos_token_id) + 1, expected_0.end());
+  auto expected_1 = reference_1;
+  auto eos_1 = std::find(expected_1.begin(), expected_1.end(), eos_token_id);
+  if (eos_1 != expected_1.end()) {
+    expected_1.erase(eos_1 + 1, expected_1.end());
+  }
+
+  Ort::GenerationEngine engine(session, 2, eos_token_id);
+  GeneratedTokens generated;
+  const int64_t id_0 = engine.AddRequest(prompt_0.data(), prompt_0.size(), max_new_tokens, CollectToken, &generated);
+  const int64_t id_1 = engine.AddRequest(prompt_1.data(), prompt_1.size(), max_new_tokens, CollectToken, &generated);
+  while (engine.Step()) {
+  }
+
+  EXPECT_EQ(generated.tokens[id_0], expected_0);
+  EXPECT_EQ(generated.tokens[id_1], expected_1);
+  EXPECT_EQ(generated.num_finished[id_0], 1);
+  EXPECT_EQ(generated.num_finished[id_1], 1);
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -0,0 +1,126 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "gtest/gtest.h"
+#include "core/framework/allocator.h"
+#include "core/framework/tensor.h"
+#include "contrib_ops/cpu/transformers/paged_kv_cache.h"
+#include "test/util/include/asserts.h"
+
+namespace onnxruntime {
+namespace test {
+
+using contrib::transformers::PagedKVCache;
+
+namespace {
+constexpr int kNumSequences = 2;
+constexpr int kPageSize = 2;
+constexpr int kMaxSequenceLength = 8;
+constexpr int kMaxPagesPerSequence = kMaxSequenceLength / kPageSize;
+
+// Key of position t of a sequence. The cache has a single layer with one head of size 1.
+float& Key(PagedKVCache& cache, int sequence_index, int t) {
+  const int32_t* page_table = cache.GetPageTable().Get<Tensor>().Data<int32_t>();
+  const int32_t page = page_table[sequence_index * kMaxPagesPerSequence + t / kPageSize];
+  float* keys = const_cast<OrtValue&>(cache.GetCache(0)).GetMutable<Tensor>()->MutableData<float>();
+  return keys[page * kPageSize + t % kPageSize];
+}
+
+int32_t Page(const PagedKVCache& cache, int sequence_index, int page_index) {
+  const int32_t* page_table = cache.GetPageTable().Get<Tensor>().Data<int32_t>();
+  return page_table[sequence_index * kMaxPagesPerSequence + page_index];
+}
+}  // namespace
+
+TEST(PagedKVCacheTest, ReorderSharesPagesAndCopiesOnWrite) {
+  auto allocator = std::make_shared<CPUAllocator>();
+  PagedKVCache cache(1, kNumSequences, 1, 1, kPageSize, kMaxSequenceLength, DataTypeImpl::GetType<float>(),
+                     allocator, allocator);
+
+  ASSERT_STATUS_OK(cache.Reserve(0, 3));
+  EXPECT_EQ(cache.NumPages() - cache.NumFreePages(), 4);
+  for (int i = 0; i < kNumSequences; i++) {
+    for (int t = 0; t < 3; t++) {
+      Key(cache, i, t) = static_cast<float>(10 * i + t);
+    }
+  }
+
+  // Both sequences continue sequence 0. The pages of sequence 1 are released, and no data is copied.
+  std::vector<int32_t> source_indices = {0, 0};
+  cache.Reorder(source_indices);
+  EXPECT_EQ(cache.NumPages() - cache.NumFreePages(), 2);
+  EXPECT_EQ(Page(cache, 0, 0), Page(cache, 1, 0));
+  EXPECT_EQ(Page(cache, 0, 1), Page(cache, 1, 1));
+
+  // Position 3 is written next. It is in the second page, which is shared, so one of the sequences gets a copy.
+  ASSERT_STATUS_OK(cache.Reserve(3, 4));
+  EXPECT_EQ(cache.NumPages() - cache.NumFreePages(), 3);
+  EXPECT_EQ(Page(cache, 0, 0), Page(cache, 1, 0));
+  EXPECT_NE(Page(cache, 0, 1), Page(cache, 1, 1));
+  for (int i = 0; i < kNumSequences; i++) {
+    for (int t = 0; t < 3; t++) {
+      EXPECT_EQ(Key(cache, i, t), static_cast<float>(t));
+    }
+  }
+
+  Key(cache, 0, 3) = 3.0f;
+  Key(cache, 1, 3) = 13.0f;
+  EXPECT_EQ(Key(cache, 0, 3), 3.0f);
+  EXPECT_EQ(Key(cache, 1, 3), 13.0f);
+}
+
+TEST(PagedKVCacheTest, GrowKeepsPages) {
+  auto allocator = std::make_shared<CPUAllocator>();
+  PagedKVCache cache(1, kNumSequences, 1, 1, kPageSize, kMaxSequenceLength, DataTypeImpl::GetType<float>(),
+                     allocator, allocator);
+
+  ASSERT_STATUS_OK(cache.Reserve(0, 1));
+  const int initial_pages = cache.NumPages();
+  for (int i = 0; i < kNumSequences; i++) {
+    Key(cache, i, 0) = static_cast<float>(i + 1);
+  }
+
+  // The cache grows when the sequences get longer, and the existing pages keep their data.
+  for (int length = 2; length <= kMaxSequenceLength; length++) {
+    ASSERT_STATUS_OK(cache.Reserve(length - 1, length));
+  }
+
+  EXPECT_GT(cache.NumPages(), initial_pages);
+  EXPECT_EQ(cache.NumPages() - cache.NumFreePages(), kNumSequences * kMaxPagesPerSequence);
+  for (int i = 0; i < kNumSequences; i++) {
+    EXPECT_EQ(Key(cache, i, 0), static_cast<float>(i + 1));
+  }
+
+  EXPECT_FALSE(cache.Reserve(kMaxSequenceLength, kMaxSequenceLength + 1).IsOK());
+}
+
+TEST(PagedKVCacheTest, CompactReleasesPagesOfRemovedSequences) {
+  auto allocator = std::make_shared<CPUAllocator>();
+  PagedKVCache cache(1, kNumSequences, 1, 1, kPageSize, kMaxSequenceLength, DataTypeImpl::GetType<float>(),
+                     allocator, allocator);
+
+  ASSERT_STATUS_OK(cache.Reserve(0, 3));
+  for (int i = 0; i < kNumSequences; i++) {
+    for (int t = 0; t < 3; t++) {
+      Key(cache, i, t) = static_cast<float>(10 * i + t);
+    }
+  }
+
+  // Only sequence 1 is kept. It becomes sequence 0, and the pages of the removed sequence are released.
+  std::vector<int32_t> kept_sequences = {1};
+  cache.Compact(kept_sequences);
+  EXPECT_EQ(cache.GetPageTable().Get<Tensor>().Shape(), TensorShape({1, kMaxPagesPerSequence}));
+  EXPECT_EQ(cache.NumPages() - cache.NumFreePages(), 2);
+  for (int t = 0; t < 3; t++) {
+    EXPECT_EQ(Key(cache, 0, t), static_cast<float>(10 + t));
+  }
+
+  ASSERT_STATUS_OK(cache.Reserve(3, 5));
+  EXPECT_EQ(cache.NumPages() - cache.NumFreePages(), 3);
+  for (int t = 0; t < 3; t++) {
+    EXPECT_EQ(Key(cache, 0, t), static_cast<float>(10 + t));
+  }
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -5,6 +5,7 @@
 #include <unordered_map>
 #include <unordered_set>
 #include <sstream>
+#include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
 #ifdef ORT_ENABLE_STREAM
@@ -368,6 +369,7 @@ class PlannerTest : public ::testing::Test {
   const SequentialExecutionPlan& GetPlan() const { return *plan_; }
   const SessionState& GetState() const { return *state_; }
   ExecutionProviders& GetExecutionProviders() { return execution_providers_; }
+  void SetExecutionMode(ExecutionMode execution_mode) { sess_options_->execution_mode = execution_mode; }
   void SetNodePartitionConfigFilePath(const char* config_file_path) {
     ORT_THROW_IF_ERROR(sess_options_->config_options.AddConfigEntry(kNodePartitionConfigFile, config_file_path));
   }
@@ -433,6 +435,49 @@ TEST_F(PlannerTest, ChainTest) {
   CheckFreed(3, {"W"});
 }
 
+// Test the dependency counts used to dispatch the nodes of a single CPU stream with ORT_PARALLEL.
+// node0 produces the input of both node1 and node2.
+TEST_F(PlannerTest, WorkStealingScheduleForParallelExecution) {
+  std::string X("X"), Y("Y"), Z1("Z1"), Z2("Z2");
+
+  auto* node0 = AddNormalNode(X, Y);
+  auto* node1 = AddNormalNode(Y, Z1);
+  auto* node2 = AddNormalNode(Y, Z2);
+
+  SetExecutionMode(ExecutionMode::ORT_PARALLEL);
+  CreatePlan({}, false);
+
+  const auto& plan = *GetState().GetExecutionPlan();
+  ASSERT_TRUE(plan.HasWorkStealingSchedule());
+  EXPECT_THAT(plan.entry_nodes, ::testing::ElementsAre(node0->Index()));
+  EXPECT_EQ(plan.node_num_producers[node0->Index()], 0);
+  EXPECT_EQ(plan.node_num_producers[node1->Index()], 1);
+  EXPECT_EQ(plan.node_num_producers[node2->Index()], 1);
+  EXPECT_THAT(plan.node_consumers[node0->Index()],
+              ::testing::UnorderedElementsAre(node1->Index(), node2->Index()));
+
+  // Y is released by whichever of its consumers completes last
+  int y_idx;
+  ASSERT_STATUS_OK(GetState().GetOrtValueNameIdxMap().GetIdx(Y, y_idx));
+  auto release_action = std::find_if(plan.release_actions.begin(), plan.release_actions.end(),
+                                     [y_idx](const SequentialExecutionPlan::ReleaseAction& action) {
+                                       return action.value_index == static_cast<size_t>(y_idx);
+                                     });
+  ASSERT_NE(release_action, plan.release_actions.end());
+  EXPECT_EQ(release_action->ref_count, 2U);
+}
+
+// The sequential executor runs the stream in order, so no dependency counts are needed.
+TEST_F(PlannerTest, NoWorkStealingScheduleForSequentialExecution) {
+  std::string X("X"), Y("Y"), Z("Z");
+  AddNormalNode(X, Y);
+  AddNormalNode(Y, Z);
+
+  CreatePlan({}, false);
+
+  EXPECT_FALSE(GetState().GetExecutionPlan()->HasWorkStealingSchedule());
+}
+
 /* InputOutputTest: Test that:
 (a) All inputs are classified as kPreExisting,
 (b) All outer scope node args are classified as kPreExisting,
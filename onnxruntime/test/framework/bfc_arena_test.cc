@@ -6,6 +6,7 @@
 #include "gtest/gtest.h"
 #include "gmock/gmock.h"
 #include <cstdlib>
+#include <thread>
 #include "core/framework/stream_handles.h"
 
 namespace onnxruntime {
@@ -303,6 +304,88 @@ TEST(BFCArenaTest, TestShrink) {
   EXPECT_EQ(stats.total_allocated_bytes, 10 * 1024 * 1024) << "Expect 10M bytes but actually " << stats.total_allocated_bytes << " bytes";
 }
 
+TEST(BFCArenaTest, TestThreadCache) {
+  AllocatorStats stats;
+  BFCArena a(std::unique_ptr<IAllocator>(new CPUAllocator()), 1 << 30, ArenaExtendStrategy::kSameAsRequested,
+             BFCArena::DEFAULT_INITIAL_CHUNK_SIZE_BYTES, BFCArena::DEFAULT_MAX_DEAD_BYTES_PER_CHUNK,
+             BFCArena::DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES, BFCArena::DEFAULT_MAX_POWER_OF_TWO_EXTEND_BYTES,
+             /*thread_cache_max_bytes*/ 4096);
+
+  // first allocation misses, the freed chunk is kept by this thread and reused
+  void* p1 = a.Alloc(1000);
+  a.Free(p1);
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.num_thread_cache_misses, 1);
+  EXPECT_EQ(stats.bytes_in_thread_caches, 1024);
+  EXPECT_EQ(stats.bytes_in_use, 0);
+
+  void* p2 = a.Alloc(900);
+  EXPECT_EQ(p1, p2);
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.num_thread_cache_hits, 1);
+  EXPECT_EQ(stats.num_allocs, 2);
+  EXPECT_EQ(stats.bytes_in_thread_caches, 0);
+  EXPECT_EQ(stats.bytes_in_use, 1024);
+
+  // a chunk freed by another thread goes back to the shared bins and is forgotten by the owning cache
+  std::thread t([&a, p2]() { a.Free(p2); });
+  t.join();
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.bytes_in_use, 0);
+  EXPECT_EQ(stats.bytes_in_thread_caches, 0);
+
+  // chunks that don't fit in the cache are returned to the shared bins
+  void* p3 = a.Alloc(4096);
+  void* p4 = a.Alloc(256);
+  a.Free(p3);
+  a.Free(p4);
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.bytes_in_thread_caches, 4096);
+  EXPECT_EQ(stats.bytes_in_use, 0);
+
+  // large allocations bypass the cache
+  void* p5 = a.Alloc(2 * 1024 * 1024);
+  a.Free(p5);
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.num_thread_cache_misses, 3);
+  EXPECT_EQ(stats.bytes_in_thread_caches, 4096);
+
+  // Shrink returns the cached chunks to the shared bins so the regions can be released
+  EXPECT_EQ(a.Shrink(), Status::OK());
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.bytes_in_thread_caches, 0);
+  EXPECT_EQ(stats.total_allocated_bytes, 0);
+}
+
+TEST(BFCArenaTest, TestThreadCacheReleasedOnThreadExit) {
+  AllocatorStats stats;
+  BFCArena a(std::unique_ptr<IAllocator>(new CPUAllocator()), 1 << 30, ArenaExtendStrategy::kSameAsRequested,
+             BFCArena::DEFAULT_INITIAL_CHUNK_SIZE_BYTES, BFCArena::DEFAULT_MAX_DEAD_BYTES_PER_CHUNK,
+             BFCArena::DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES, BFCArena::DEFAULT_MAX_POWER_OF_TWO_EXTEND_BYTES,
+             /*thread_cache_max_bytes*/ 4096);
+
+  // the chunks cached by a thread go back to the arena when it exits, and a chunk it handed out that is
+  // still in use is freed to the shared bins.
+  void* in_use = nullptr;
+  std::thread t([&a, &in_use]() {
+    a.Free(a.Alloc(1000));
+    in_use = a.Alloc(2000);
+  });
+  t.join();
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.bytes_in_thread_caches, 0);
+  EXPECT_EQ(stats.num_thread_cache_misses, 2);
+  EXPECT_EQ(stats.bytes_in_use, 2048);
+
+  a.Free(in_use);
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.bytes_in_use, 0);
+  EXPECT_EQ(stats.bytes_in_thread_caches, 0);
+  EXPECT_EQ(a.Shrink(), Status::OK());
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.total_allocated_bytes, 0);
+}
+
 class BadAllocator : public IAllocator {
  public:
   BadAllocator() : IAllocator(OrtMemoryInfo(CPU, OrtAllocatorType::OrtDeviceAllocator)) {}
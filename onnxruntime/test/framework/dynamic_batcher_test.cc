@@ -0,0 +1,134 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <atomic>
+#include <thread>
+
+#include "core/framework/tensor.h"
+#include "core/session/dynamic_batcher.h"
+#include "gtest/gtest.h"
+#include "test/framework/test_utils.h"
+#include "test/test_environment.h"
+#include "test/util/include/asserts.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+AllocatorPtr CpuAllocator() {
+  return TestCPUExecutionProvider()->CreatePreferredAllocators()[0];
+}
+
+// Y = 2 * X
+Status DoubleInput(gsl::span<const OrtValue> feeds, std::vector<OrtValue>& fetches) {
+  const auto& input = feeds[0].Get<Tensor>();
+  fetches.resize(1);
+  Tensor::InitOrtValue(input.DataType(), input.Shape(), CpuAllocator(), fetches[0]);
+  const auto x = input.DataAsSpan<float>();
+  float* y = fetches[0].GetMutable<Tensor>()->MutableData<float>();
+  for (size_t i = 0; i < x.size(); ++i) {
+    y[i] = 2.f * x[i];
+  }
+  return Status::OK();
+}
+
+// Runs the requests on separate threads. Request i has one row with the value i + 1.
+void RunConcurrentRequests(DynamicBatcher& batcher, int num_requests, std::vector<Status>& statuses,
+                           std::vector<std::vector<OrtValue>>& fetches) {
+  const std::vector<std::string> feed_names{"X"};
+  const std::vector<std::string> output_names{"Y"};
+  statuses.resize(num_requests);
+  fetches.resize(num_requests);
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_requests; ++i) {
+    threads.emplace_back([&, i]() {
+      OrtValue input;
+      const float value = static_cast<float>(i + 1);
+      CreateMLValue<float>(CpuAllocator(), {1, 2}, {value, -value}, &input);
+      std::vector<OrtValue> feeds{input};
+      statuses[i] = batcher.Run(RunOptions{}, feed_names, feeds, output_names, fetches[i]);
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+}  // namespace
+
+TEST(DynamicBatcherTest, BatchesConcurrentRequests) {
+  constexpr int num_requests = 4;
+  std::atomic<int> num_runs{0};
+  std::atomic<int64_t> last_batch_size{0};
+  auto run_fn = [&](const RunOptions&, gsl::span<const std::string>, gsl::span<const OrtValue> feeds,
+                    gsl::span<const std::string>, std::vector<OrtValue>* p_fetches) {
+    ++num_runs;
+    last_batch_size = feeds[0].Get<Tensor>().Shape()[0];
+    return DoubleInput(feeds, *p_fetches);
+  };
+
+  // the batch is only executed early once all the requests have arrived
+  profiling::Profiler profiler;
+  DynamicBatcher batcher(num_requests, std::chrono::seconds(10), CpuAllocator(), run_fn, profiler,
+                         DefaultLoggingManager().DefaultLogger());
+
+  std::vector<Status> statuses;
+  std::vector<std::vector<OrtValue>> fetches;
+  RunConcurrentRequests(batcher, num_requests, statuses, fetches);
+
+  EXPECT_EQ(num_runs, 1);
+  EXPECT_EQ(last_batch_size, num_requests);
+  for (int i = 0; i < num_requests; ++i) {
+    ASSERT_STATUS_OK(statuses[i]);
+    ASSERT_EQ(fetches[i].size(), 1u);
+    const auto& output = fetches[i][0].Get<Tensor>();
+    ASSERT_EQ(output.Shape(), TensorShape({1, 2}));
+    const float value = static_cast<float>(i + 1);
+    EXPECT_EQ(output.Data<float>()[0], 2.f * value);
+    EXPECT_EQ(output.Data<float>()[1], -2.f * value);
+  }
+}
+
+// If the outputs of a batch can't be split, the requests run one by one. An exception in one of them fails that
+// request only.
+TEST(DynamicBatcherTest, ExceptionInFallbackRunFailsOneRequest) {
+  constexpr int num_requests = 3;
+  auto run_fn = [&](const RunOptions&, gsl::span<const std::string>, gsl::span<const OrtValue> feeds,
+                    gsl::span<const std::string>, std::vector<OrtValue>* p_fetches) -> Status {
+    const auto& input = feeds[0].Get<Tensor>();
+    if (input.Shape()[0] > 1) {
+      // an output that doesn't follow the batch dimension
+      p_fetches->resize(1);
+      Tensor::InitOrtValue(input.DataType(), TensorShape({1}), CpuAllocator(), (*p_fetches)[0]);
+      return Status::OK();
+    }
+
+    if (input.Data<float>()[0] == 2.f) {
+      ORT_THROW("Request 2 failed");
+    }
+
+    return DoubleInput(feeds, *p_fetches);
+  };
+
+  profiling::Profiler profiler;
+  DynamicBatcher batcher(num_requests, std::chrono::seconds(10), CpuAllocator(), run_fn, profiler,
+                         DefaultLoggingManager().DefaultLogger());
+
+  std::vector<Status> statuses;
+  std::vector<std::vector<OrtValue>> fetches;
+  RunConcurrentRequests(batcher, num_requests, statuses, fetches);
+
+  for (int i = 0; i < num_requests; ++i) {
+    if (i + 1 == 2) {
+      EXPECT_FALSE(statuses[i].IsOK());
+      EXPECT_NE(statuses[i].ErrorMessage().find("Request 2 failed"), std::string::npos);
+    } else {
+      ASSERT_STATUS_OK(statuses[i]);
+      EXPECT_EQ(fetches[i][0].Get<Tensor>().Data<float>()[0], 2.f * static_cast<float>(i + 1));
+    }
+  }
+}
+
+}  // namespace test
+}  // namespace onnxruntime
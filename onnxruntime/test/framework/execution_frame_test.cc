@@ -8,6 +8,7 @@
 #include "core/graph/model.h"
 #include "core/providers/cpu/cpu_execution_provider.h"
 #include "core/session/inference_session.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 #include "test_utils.h"
 #include "test/test_environment.h"
 #include "test/framework/TestAllocatorManager.h"
@@ -330,6 +331,128 @@ TEST_F(ExecutionFrameTest, MemPatternTest) {
   ASSERT_EQ(p->GetBlock(4)->offset_, kAllocAlignment);
 }
 
+#ifndef ENABLE_TRAINING
+TEST_F(ExecutionFrameTest, BucketedMemPatternTest) {
+  auto cpu_xp = CreateCPUExecutionProvider();
+  auto xp_type = cpu_xp->Type();
+  std::unordered_map<std::string, int> domain_to_version;
+  domain_to_version[onnxruntime::kOnnxDomain] = 7;
+  onnxruntime::Model model("test", true, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+                           domain_to_version, {}, DefaultLoggingManager().DefaultLogger());
+  onnxruntime::Graph& graph = model.MainGraph();
+  TypeProto tensor_float;
+  tensor_float.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  onnxruntime::NodeArg input_def1("X1", &tensor_float),
+      input_def2("X2", &tensor_float),
+      gemm_out_def("T1", &tensor_float),
+      relu_out_def("T2", &tensor_float),
+      clip_out_def("T3", &tensor_float);
+
+  graph.AddNode("node1", "MatMul", "gemm1", ArgMap{&input_def1, &input_def2}, ArgMap{&gemm_out_def})
+      .SetExecutionProviderType(xp_type);
+  graph.AddNode("node2", "Relu", "relu1", ArgMap{&gemm_out_def}, ArgMap{&relu_out_def})
+      .SetExecutionProviderType(xp_type);
+  graph.AddNode("node3", "Clip", "clip1", ArgMap{&relu_out_def}, ArgMap{&clip_out_def})
+      .SetExecutionProviderType(xp_type);
+
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  KernelRegistryManager kernel_registry_manager;
+
+  ExecutionProviders execution_providers;
+  ASSERT_STATUS_OK(execution_providers.Add(xp_type, std::move(cpu_xp)));
+  ASSERT_STATUS_OK(kernel_registry_manager.RegisterKernels(execution_providers));
+
+  DataTransferManager dtm;
+  profiling::Profiler profiler;
+
+  SessionOptions sess_options;
+  sess_options.enable_mem_pattern = true;
+  sess_options.execution_mode = ExecutionMode::ORT_SEQUENTIAL;
+  sess_options.use_deterministic_compute = false;
+  sess_options.enable_mem_reuse = true;
+  ASSERT_STATUS_OK(sess_options.config_options.AddConfigEntry(kOrtSessionOptionsConfigMemoryPatternShapeBucket,
+                                                              "pow2"));
+
+  SessionState state(graph, execution_providers, &tp_, nullptr, dtm,
+                     DefaultLoggingManager().DefaultLogger(), profiler, sess_options);
+
+  ASSERT_STATUS_OK(state.FinalizeSessionState(ORT_TSTR(""), kernel_registry_manager));
+  ASSERT_TRUE(state.UseMemoryPatternShapeBuckets());
+
+  const OrtValueNameIdxMap& mlvalue_name_idx_map(state.GetOrtValueNameIdxMap());
+
+  int x1_idx = -1, x2_idx = -1, t1_idx = -1, t2_idx = -1, t3_idx = -1;
+  ASSERT_STATUS_OK(mlvalue_name_idx_map.GetIdx("X1", x1_idx));
+  ASSERT_STATUS_OK(mlvalue_name_idx_map.GetIdx("X2", x2_idx));
+  ASSERT_STATUS_OK(mlvalue_name_idx_map.GetIdx("T1", t1_idx));
+  ASSERT_STATUS_OK(mlvalue_name_idx_map.GetIdx("T2", t2_idx));
+  ASSERT_STATUS_OK(mlvalue_name_idx_map.GetIdx("T3", t3_idx));
+
+  auto cpu_allocator = execution_providers.Get(xp_type)->CreatePreferredAllocators()[0];
+  const auto& device = cpu_allocator->Info().device;
+  const auto float_type = DataTypeImpl::GetType<float>();
+
+  // sequence length 3 and 4 share the bucket of 4
+  auto create_feeds = [&](int64_t seq_len) {
+    std::vector<OrtValue> feeds(2);
+    CreateMLValue<float>(cpu_allocator, std::vector<int64_t>{seq_len, 64},
+                         std::vector<float>(seq_len * 64, 1.0f), &feeds[0]);
+    CreateMLValue<float>(cpu_allocator, std::vector<int64_t>{64, 64}, std::vector<float>(64 * 64, 1.0f),
+                         &feeds[1]);
+    return feeds;
+  };
+
+  std::vector<OrtValue> outputs;
+
+  // no pattern is cached yet, so one is generated for sequence length 3
+  auto feeds_3 = create_feeds(3);
+  {
+    ExecutionFrame frame(AsSpan({x1_idx, x2_idx}), feeds_3, AsSpan({t3_idx}), outputs, {}, {}, state);
+    ASSERT_TRUE(frame.HasMemoryPatternsToCache());
+    OrtValue t1, t2;
+    ASSERT_STATUS_OK(frame.AllocateMLValueTensorSelfOwnBuffer(t1,
+                                                              t1_idx, float_type, device, TensorShape({3, 64})));
+    ASSERT_STATUS_OK(frame.AllocateMLValueTensorSelfOwnBuffer(t2,
+                                                              t2_idx, float_type, device, TensorShape({3, 64})));
+    MemoryPatternGroup pattern;
+    ASSERT_STATUS_OK(frame.GeneratePatterns(pattern));
+    ASSERT_STATUS_OK(state.UpdateMemoryPatternGroupCache(feeds_3, std::move(pattern)));
+  }
+
+  // sequence length 4 uses the pattern of the bucket. T1 fits in its block, T2 doesn't so the pattern is grown.
+  auto feeds_4 = create_feeds(4);
+  {
+    ExecutionFrame frame(AsSpan({x1_idx, x2_idx}), feeds_4, AsSpan({t3_idx}), outputs, {}, {}, state);
+    ASSERT_FALSE(frame.HasMemoryPatternsToCache());
+    OrtValue t1, t2;
+    ASSERT_STATUS_OK(frame.AllocateMLValueTensorSelfOwnBuffer(t1,
+                                                              t1_idx, float_type, device, TensorShape({2, 64})));
+    ASSERT_FALSE(frame.HasMemoryPatternsToCache());
+    ASSERT_STATUS_OK(frame.AllocateMLValueTensorSelfOwnBuffer(t2,
+                                                              t2_idx, float_type, device, TensorShape({4, 64})));
+    ASSERT_TRUE(frame.HasMemoryPatternsToCache());
+    MemoryPatternGroup pattern;
+    ASSERT_STATUS_OK(frame.GeneratePatterns(pattern));
+    ASSERT_STATUS_OK(state.UpdateMemoryPatternGroupCache(feeds_4, std::move(pattern)));
+  }
+
+  // the grown pattern is shared by the bucket and has blocks for the largest sizes seen
+  std::shared_ptr<const InlinedHashMap<int, TensorShape>> inferred_shapes;
+  auto cached = state.GetMemoryPatternGroup(feeds_3, AsSpan({x1_idx, x2_idx}), inferred_shapes);
+  ASSERT_NE(cached, nullptr);
+  ASSERT_EQ(cached, state.GetMemoryPatternGroup(feeds_4, AsSpan({x1_idx, x2_idx}), inferred_shapes));
+  const auto* p = cached->GetPatterns(device);
+  ASSERT_NE(p, nullptr);
+  ASSERT_EQ(p->GetBlock(t1_idx)->size_, 3u * 64 * sizeof(float));
+  ASSERT_EQ(p->GetBlock(t2_idx)->size_, 4u * 64 * sizeof(float));
+
+  // sequence length 5 is in the next bucket
+  auto feeds_5 = create_feeds(5);
+  ASSERT_EQ(state.GetMemoryPatternGroup(feeds_5, AsSpan({x1_idx, x2_idx}), inferred_shapes), nullptr);
+}
+#endif
+
 #ifdef ENABLE_TRAINING
 TEST_F(ExecutionFrameTest, MemPatternWithExternalOutputsTest) {
   auto cpu_xp = CreateCPUExecutionProvider();
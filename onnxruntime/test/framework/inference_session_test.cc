@@ -13,6 +13,7 @@
 
 #include <google/protobuf/io/zero_copy_stream_impl.h>
 #include "core/common/denormal.h"
+#include "core/common/span_utils.h"
 #include "core/common/logging/logging.h"
 #include "core/common/logging/sinks/clog_sink.h"
 #include "core/common/profiler.h"
@@ -821,6 +822,167 @@ TEST(InferenceSessionTests, MultipleSessionsNoTimeout) {
   thread2.join();
 }
 
+TEST(InferenceSessionTests, DynamicBatchingOfConcurrentRuns) {
+  // Y = X * X with a symbolic batch dimension
+  onnxruntime::Model model("dynamic_batching", false, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+  ONNX_NAMESPACE::TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_param("batch");
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+  auto& input_x = graph.GetOrCreateNodeArg("X", &float_tensor);
+  auto& output_y = graph.GetOrCreateNodeArg("Y", &float_tensor);
+  graph.AddNode("mul", "Mul", "square the input", {&input_x, &input_x}, {&output_y});
+  ASSERT_STATUS_OK(graph.Resolve());
+  const std::string model_file_name = "dynamic_batching_test.onnx";
+  ASSERT_STATUS_OK(onnxruntime::Model::Save(model, model_file_name));
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.DynamicBatchingOfConcurrentRuns";
+  so.enable_profiling = true;
+  so.profile_file_prefix = ORT_TSTR("onnxprofile_dynamic_batching_test");
+  // the batch is only executed early once all the requests have arrived
+  constexpr int num_requests = 4;
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigDynamicBatchingMaxBatchSize,
+                                                    std::to_string(num_requests).c_str()));
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigDynamicBatchingMaxQueueDelayUs,
+                                                    "10000000"));
+
+  InferenceSession session_object{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session_object.Load(model_file_name));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_requests; ++i) {
+    threads.emplace_back([&session_object, i]() {
+      OrtValue input;
+      const float value = static_cast<float>(i + 1);
+      CreateMLValue<float>(TestCPUExecutionProvider()->CreatePreferredAllocators()[0], {1, 2}, {value, -value},
+                           &input);
+      NameMLValMap feeds{{"X", input}};
+      const std::vector<std::string> output_names{"Y"};
+      std::vector<OrtValue> fetches;
+      ASSERT_STATUS_OK(session_object.Run(RunOptions{}, feeds, output_names, &fetches));
+      VerifyOutputs(fetches, {1, 2}, {value * value, value * value});
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  // each request reports its queueing latency, and all of them were executed in one batch
+  std::ifstream profile(session_object.EndProfiling());
+  ASSERT_TRUE(profile);
+  std::string line;
+  int num_queue_events = 0;
+  while (std::getline(profile, line)) {
+    if (line.find("dynamic_batching_queue") != std::string::npos) {
+      ++num_queue_events;
+      EXPECT_NE(line.find("\"batch_requests\" : \"" + std::to_string(num_requests) + "\""), std::string::npos)
+          << line;
+    }
+  }
+
+  ASSERT_EQ(num_queue_events, num_requests);
+}
+
+#ifndef ENABLE_TRAINING
+TEST(InferenceSessionTests, SymbolicMemoryPatternsForNewShapes) {
+  // Y = T1 + Tanh(T1) with T1 = X * W, where X has the symbolic dimensions batch and seq
+  onnxruntime::Model model("symbolic_mem_patterns", false, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+  ONNX_NAMESPACE::TypeProto input_type;
+  input_type.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  auto* input_shape = input_type.mutable_tensor_type()->mutable_shape();
+  input_shape->add_dim()->set_dim_param("batch");
+  input_shape->add_dim()->set_dim_param("seq");
+  input_shape->add_dim()->set_dim_value(8);
+  auto& input_x = graph.GetOrCreateNodeArg("X", &input_type);
+
+  ONNX_NAMESPACE::TensorProto weights;
+  weights.set_name("W");
+  weights.set_data_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  weights.add_dims(8);
+  weights.add_dims(16);
+  for (int i = 0; i < 8 * 16; ++i) {
+    weights.add_float_data(static_cast<float>(i % 7 - 3) / 8.f);
+  }
+  graph.AddInitializedTensor(weights);
+
+  auto& t1 = graph.GetOrCreateNodeArg("T1", nullptr);
+  auto& t2 = graph.GetOrCreateNodeArg("T2", nullptr);
+  auto& output_y = graph.GetOrCreateNodeArg("Y", nullptr);
+  graph.AddNode("matmul", "MatMul", "", {&input_x, graph.GetNodeArg("W")}, {&t1});
+  graph.AddNode("tanh", "Tanh", "", {&t1}, {&t2});
+  graph.AddNode("add", "Add", "", {&t1, &t2}, {&output_y});
+  ASSERT_STATUS_OK(graph.Resolve());
+  std::string model_data;
+  ASSERT_TRUE(model.ToProto().SerializeToString(&model_data));
+
+  auto create_session = [&model_data](bool enable_mem_pattern) {
+    SessionOptions so;
+    so.session_logid = "InferenceSessionTests.SymbolicMemoryPatternsForNewShapes";
+    so.enable_mem_pattern = enable_mem_pattern;
+    auto session = std::make_unique<InferenceSession>(so, GetEnvironment());
+    std::stringstream model_stream(model_data);
+    ORT_THROW_IF_ERROR(session->Load(model_stream));
+    ORT_THROW_IF_ERROR(session->Initialize());
+    return session;
+  };
+  auto session = create_session(true);
+  auto reference_session = create_session(false);
+
+  const SessionState& session_state = session->GetSessionState();
+  int x_idx = -1;
+  int t1_idx = -1;
+  ASSERT_STATUS_OK(session_state.GetOrtValueNameIdxMap().GetIdx("X", x_idx));
+  ASSERT_STATUS_OK(session_state.GetOrtValueNameIdxMap().GetIdx("T1", t1_idx));
+
+  auto cpu_allocator = TestCPUExecutionProvider()->CreatePreferredAllocators()[0];
+  const std::vector<std::pair<int64_t, int64_t>> batch_and_seq{{2, 3}, {5, 7}};
+  for (const auto& [batch, seq] : batch_and_seq) {
+    const int64_t num_elements = batch * seq * 8;
+    std::vector<float> values(static_cast<size_t>(num_elements));
+    for (int64_t i = 0; i < num_elements; ++i) {
+      values[static_cast<size_t>(i)] = static_cast<float>(i % 11 - 5) / 4.f;
+    }
+    OrtValue input;
+    CreateMLValue<float>(cpu_allocator, {batch, seq, 8}, values, &input);
+    const std::vector<OrtValue> tensor_inputs{input};
+
+    // the pattern for a shape that was never run is available before the first run, so it isn't traced.
+    std::shared_ptr<const InlinedHashMap<int, TensorShape>> inferred_shapes;
+    auto patterns = session_state.GetMemoryPatternGroup(tensor_inputs, AsSpan({x_idx}), inferred_shapes);
+    ASSERT_NE(patterns, nullptr);
+    const auto* pattern = patterns->GetPatterns(cpu_allocator->Info().device);
+    ASSERT_NE(pattern, nullptr);
+    ASSERT_NE(pattern->GetBlock(t1_idx), nullptr);
+    EXPECT_GE(pattern->GetBlock(t1_idx)->size_, static_cast<size_t>(batch * seq * 16) * sizeof(float));
+
+    NameMLValMap feeds{{"X", input}};
+    const std::vector<std::string> output_names{"Y"};
+    std::vector<OrtValue> fetches;
+    std::vector<OrtValue> reference_fetches;
+    ASSERT_STATUS_OK(session->Run(RunOptions{}, feeds, output_names, &fetches));
+    ASSERT_STATUS_OK(reference_session->Run(RunOptions{}, feeds, output_names, &reference_fetches));
+
+    // the run used the symbolic pattern rather than replacing it with a traced one.
+    EXPECT_EQ(session_state.GetMemoryPatternGroup(tensor_inputs, AsSpan({x_idx}), inferred_shapes), patterns);
+
+    const auto& output = fetches[0].Get<Tensor>();
+    const auto& reference_output = reference_fetches[0].Get<Tensor>();
+    ASSERT_EQ(output.Shape(), TensorShape({batch, seq, 16}));
+    ASSERT_EQ(output.Shape(), reference_output.Shape());
+    const auto output_values = output.DataAsSpan<float>();
+    const auto reference_values = reference_output.DataAsSpan<float>();
+    for (size_t i = 0; i < output_values.size(); ++i) {
+      EXPECT_EQ(output_values[i], reference_values[i]) << "i=" << i;
+    }
+  }
+}
+#endif
+
 TEST(InferenceSessionTests, PreAllocateOutputVector) {
   SessionOptions so;
 
@@ -2955,5 +3117,112 @@ TEST(InferenceSessionTests, InterThreadPoolWithDenormalAsZero) {
   VerifyThreadPoolWithDenormalAsZero(session2.GetInterOpThreadPoolToUse(), false);
 }
 
+// Initializers with aligned external data are used in place with kOrtSessionOptionsUseMmapForExternalInitializers,
+// and misaligned ones are copied. The external data is in memory rather than in a file so that the test can check
+// the address of the initializer, it is loaded the same way as a mapped file.
+TEST(InferenceSessionTests, UseMmapForExternalInitializers) {
+  constexpr int64_t kSize = 64;
+  alignas(64) static float weights[2 * kSize + 1];
+  for (size_t i = 0; i < std::size(weights); ++i) {
+    weights[i] = static_cast<float>(i);
+  }
+  const float* aligned_weights = weights;
+  // 4 bytes past a 64 byte boundary
+  const float* misaligned_weights = weights + kSize + 1;
+
+  ModelProto model_proto;
+  model_proto.set_ir_version(ONNX_NAMESPACE::Version::IR_VERSION);
+  auto* opset = model_proto.add_opset_import();
+  opset->set_domain(kOnnxDomain);
+  opset->set_version(13);
+
+  auto* graph_proto = model_proto.mutable_graph();
+  graph_proto->set_name("mmap_external_initializers");
+  auto add_external_initializer = [graph_proto](const std::string& name, const float* data) {
+    auto* initializer = graph_proto->add_initializer();
+    initializer->set_name(name);
+    initializer->set_data_type(TensorProto_DataType_FLOAT);
+    initializer->add_dims(kSize);
+    initializer->set_data_location(TensorProto_DataLocation_EXTERNAL);
+    auto* entry = initializer->add_external_data();
+    entry->set_key("location");
+    entry->set_value(ToUTF8String(utils::kTensorProtoMemoryAddressTag));
+    entry = initializer->add_external_data();
+    entry->set_key("offset");
+    entry->set_value(std::to_string(reinterpret_cast<intptr_t>(data)));
+    entry = initializer->add_external_data();
+    entry->set_key("length");
+    entry->set_value(std::to_string(kSize * sizeof(float)));
+  };
+  add_external_initializer("W_aligned", aligned_weights);
+  add_external_initializer("W_misaligned", misaligned_weights);
+
+  auto add_value_info = [](ValueInfoProto* value_info, const std::string& name) {
+    value_info->set_name(name);
+    auto* tensor_type = value_info->mutable_type()->mutable_tensor_type();
+    tensor_type->set_elem_type(TensorProto_DataType_FLOAT);
+    tensor_type->mutable_shape()->add_dim()->set_dim_value(kSize);
+  };
+  add_value_info(graph_proto->add_input(), "X");
+  add_value_info(graph_proto->add_output(), "Y");
+
+  auto* add_aligned = graph_proto->add_node();
+  add_aligned->set_op_type("Add");
+  add_aligned->add_input("X");
+  add_aligned->add_input("W_aligned");
+  add_aligned->add_output("T");
+  auto* add_misaligned = graph_proto->add_node();
+  add_misaligned->set_op_type("Add");
+  add_misaligned->add_input("T");
+  add_misaligned->add_input("W_misaligned");
+  add_misaligned->add_output("Y");
+
+  std::string model_data;
+  ASSERT_TRUE(model_proto.SerializeToString(&model_data));
+
+  std::vector<float> x(kSize);
+  std::vector<float> expected_y(kSize);
+  for (int64_t i = 0; i < kSize; ++i) {
+    x[i] = 0.5f * static_cast<float>(i);
+    expected_y[i] = x[i] + aligned_weights[i] + misaligned_weights[i];
+  }
+
+  for (const char* use_mmap : {"0", "1"}) {
+    SessionOptions so;
+    so.session_logid = "InferenceSessionTests.UseMmapForExternalInitializers";
+    so.graph_optimization_level = TransformerLevel::Default;
+    ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsUseMmapForExternalInitializers, use_mmap));
+
+    InferenceSessionWrapper session{so, GetEnvironment()};
+    ASSERT_STATUS_OK(session.Load(model_data.data(), static_cast<int>(model_data.size())));
+    ASSERT_STATUS_OK(session.Initialize());
+
+    const SessionState& session_state = session.GetSessionState();
+    auto get_initializer = [&session_state](const std::string& name) -> const Tensor& {
+      int idx = -1;
+      ORT_THROW_IF_ERROR(session_state.GetOrtValueNameIdxMap().GetIdx(name, idx));
+      return session_state.GetInitializedTensors().at(idx).Get<Tensor>();
+    };
+
+    if (std::string(use_mmap) == "1") {
+      const Tensor& aligned = get_initializer("W_aligned");
+      EXPECT_EQ(aligned.Data<float>(), aligned_weights);
+
+      const Tensor& misaligned = get_initializer("W_misaligned");
+      EXPECT_NE(misaligned.Data<float>(), misaligned_weights);
+      EXPECT_EQ(std::vector<float>(misaligned.Data<float>(), misaligned.Data<float>() + kSize),
+                std::vector<float>(misaligned_weights, misaligned_weights + kSize));
+    }
+
+    OrtValue input;
+    CreateMLValue<float>(TestCPUExecutionProvider()->CreatePreferredAllocators()[0], {kSize}, x, &input);
+    NameMLValMap feeds{{"X", input}};
+    const std::vector<std::string> output_names{"Y"};
+    std::vector<OrtValue> fetches;
+    ASSERT_STATUS_OK(session.Run(RunOptions{}, feeds, output_names, &fetches));
+    VerifyOutputs(fetches[0].Get<Tensor>(), {kSize}, expected_y);
+  }
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -33,6 +33,7 @@ struct OrtModelTestInfo {
   NameMLValMap inputs;
   std::vector<std::string> output_names;
   std::function<void(const std::vector<OrtValue>&)> output_verifier;
+  std::function<void(const SessionState&)> session_state_verifier;
   std::vector<std::pair<std::string, std::string>> configs;
   bool run_use_buffer{false};
   bool disable_copy_ort_buffer{false};
@@ -74,6 +75,10 @@ static void RunOrtModel(const OrtModelTestInfo& test_info) {
 
   ASSERT_STATUS_OK(session_object.Initialize());
 
+  if (test_info.session_state_verifier) {
+    test_info.session_state_verifier(session_object.GetSessionState());
+  }
+
   std::vector<OrtValue> fetches;
   ASSERT_STATUS_OK(session_object.Run(test_info.inputs, test_info.output_names, &fetches));
   test_info.output_verifier(fetches);
@@ -322,6 +327,50 @@ TEST(OrtModelOnlyTests, SerializeToOrtFormat) {
   RunOrtModel(test_info);
 }
 
+// test that the pre-packed weights are saved in the ORT format model and used instead of pre-packing when loading it
+TEST(OrtModelOnlyTests, SerializePrePackedInitializers) {
+  const auto ort_file = ORT_TSTR("testdata/matmul_1.onnx.prepacked.test_output.ort");
+
+  {
+    SessionOptions so;
+    so.session_logid = "SerializePrePackedInitializers";
+    so.optimized_model_filepath = ort_file;
+    ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigSaveModelFormat, "ORT"));
+    ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigSavePrePackedInitializers, "1"));
+    InferenceSessionWrapper session_object{so, GetEnvironment()};
+    ASSERT_STATUS_OK(session_object.Load(ORT_TSTR("testdata/matmul_1.onnx")));
+    ASSERT_STATUS_OK(session_object.Initialize());
+    ASSERT_EQ(session_object.GetSessionState().GetNumberOfPrepacksCounter(), static_cast<size_t>(1));
+  }
+
+  for (bool use_buffer_for_initializers : {false, true}) {
+    OrtModelTestInfo test_info;
+    test_info.model_filename = ort_file;
+    test_info.logid = "LoadPrePackedInitializers";
+    test_info.run_use_buffer = use_buffer_for_initializers;
+    test_info.disable_copy_ort_buffer = use_buffer_for_initializers;
+    test_info.use_buffer_for_initializers = use_buffer_for_initializers;
+
+    OrtValue ml_value;
+    CreateMLValue<float>(TestCPUExecutionProvider()->CreatePreferredAllocators()[0], {3, 2},
+                         {1.f, 2.f, 3.f, 4.f, 5.f, 6.f}, &ml_value);
+    test_info.inputs.insert(std::make_pair("X", ml_value));
+
+    test_info.output_names = {"Y"};
+    test_info.output_verifier = [](const std::vector<OrtValue>& fetches) {
+      const auto& output = fetches[0].Get<Tensor>();
+      ASSERT_EQ(output.Shape(), TensorShape({3, 1}));
+      EXPECT_THAT(output.DataAsSpan<float>(), ::testing::ElementsAre(5.f, 11.f, 17.f));
+    };
+    test_info.session_state_verifier = [](const SessionState& session_state) {
+      ASSERT_EQ(session_state.GetNumberOfPrepacksCounter(), static_cast<size_t>(1));
+      ASSERT_EQ(session_state.GetUsedSerializedPrePackedWeightCounter(), static_cast<size_t>(1));
+    };
+
+    RunOrtModel(test_info);
+  }
+}
+
 TEST(OrtModelOnlyTests, SparseInitializerHandling) {
   const auto ort_file = ORT_TSTR("testdata/ort_minimal_test_models/sparse_initializer_handling.onnx.test_output.ort");
   SaveAndCompareModels(ORT_TSTR("testdata/ort_minimal_test_models/sparse_initializer_handling.onnx"), ort_file);
@@ -3,7 +3,10 @@
 
 #include "core/framework/data_types.h"
 #include "core/framework/op_kernel.h"
+#include "core/graph/model.h"
 #include "test/providers/provider_test_utils.h"
+#include "test/test_environment.h"
+#include "test/util/include/inference_session_wrapper.h"
 #include "test_utils.h"
 #include "core/session/inference_session.h"
 
@@ -117,6 +120,77 @@ TEST(ParallelExecutor, TestStatusPropagation) {
   }
 }
 
+// Runs a graph with several branches with the work-stealing schedule of ORT_PARALLEL and checks the outputs against
+// ORT_SEQUENTIAL. Four unary ops of X are combined by binary ops into the outputs Y and Y2. `a`, `b` and `f` have
+// more than one consumer so they are released by whichever consumer completes last.
+TEST(ParallelExecutor, WorkStealingScheduleMatchesSequential) {
+  std::unordered_map<std::string, int> domain_to_version{{kOnnxDomain, 13}};
+  Model model("work_stealing", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+              domain_to_version, std::vector<ONNX_NAMESPACE::FunctionProto>(),
+              DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+
+  TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1024);
+  auto arg = [&graph, &float_tensor](const std::string& name) { return &graph.GetOrCreateNodeArg(name, &float_tensor); };
+  graph.AddNode("relu", "Relu", "", {arg("X")}, {arg("a")});
+  graph.AddNode("sigmoid", "Sigmoid", "", {arg("X")}, {arg("b")});
+  graph.AddNode("neg", "Neg", "", {arg("X")}, {arg("c")});
+  graph.AddNode("abs", "Abs", "", {arg("X")}, {arg("d")});
+  graph.AddNode("add_ab", "Add", "", {arg("a"), arg("b")}, {arg("e")});
+  graph.AddNode("mul_cd", "Mul", "", {arg("c"), arg("d")}, {arg("f")});
+  graph.AddNode("sub_ef", "Sub", "", {arg("e"), arg("f")}, {arg("g")});
+  graph.AddNode("add_ga", "Add", "", {arg("g"), arg("a")}, {arg("Y")});
+  graph.AddNode("mul_bf", "Mul", "", {arg("b"), arg("f")}, {arg("Y2")});
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  std::string model_data;
+  ASSERT_TRUE(model.ToProto().SerializeToString(&model_data));
+
+  std::vector<float> x(1024);
+  for (size_t i = 0; i < x.size(); ++i) {
+    x[i] = static_cast<float>(i % 37) * 0.25f - 4.f;
+  }
+  OrtValue input;
+  CreateMLValue<float>(TestCPUExecutionProvider()->CreatePreferredAllocators()[0], {1024}, x, &input);
+  NameMLValMap feeds{{"X", input}};
+  const std::vector<std::string> output_names{"Y", "Y2"};
+
+  auto create_session = [&model_data](ExecutionMode execution_mode, std::unique_ptr<InferenceSessionWrapper>& session) {
+    SessionOptions so;
+    so.execution_mode = execution_mode;
+    so.inter_op_param.thread_pool_size = 4;
+    so.graph_optimization_level = TransformerLevel::Default;
+    session = std::make_unique<InferenceSessionWrapper>(so, GetEnvironment());
+    ASSERT_STATUS_OK(session->Load(model_data.data(), static_cast<int>(model_data.size())));
+    ASSERT_STATUS_OK(session->Initialize());
+  };
+
+  std::unique_ptr<InferenceSessionWrapper> sequential_session;
+  create_session(ExecutionMode::ORT_SEQUENTIAL, sequential_session);
+  std::vector<OrtValue> expected;
+  ASSERT_STATUS_OK(sequential_session->Run(RunOptions{}, feeds, output_names, &expected));
+
+  std::unique_ptr<InferenceSessionWrapper> parallel_session;
+  create_session(ExecutionMode::ORT_PARALLEL, parallel_session);
+  ASSERT_TRUE(parallel_session->GetSessionState().GetExecutionPlan()->HasWorkStealingSchedule());
+
+  // the nodes complete in a different order in each run
+  for (int run = 0; run < 50; ++run) {
+    std::vector<OrtValue> fetches;
+    ASSERT_STATUS_OK(parallel_session->Run(RunOptions{}, feeds, output_names, &fetches));
+    ASSERT_EQ(fetches.size(), expected.size());
+    for (size_t i = 0; i < fetches.size(); ++i) {
+      const auto expected_values = expected[i].Get<Tensor>().DataAsSpan<float>();
+      const auto values = fetches[i].Get<Tensor>().DataAsSpan<float>();
+      ASSERT_EQ(std::vector<float>(values.begin(), values.end()),
+                std::vector<float>(expected_values.begin(), expected_values.end()))
+          << "output " << output_names[i] << " of run " << run;
+    }
+  }
+}
+
 class ParallelExecutorThreadPoolTest : public testing::TestWithParam<int> {
 };
 
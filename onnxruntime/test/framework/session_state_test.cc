@@ -1,6 +1,7 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
 #include <iostream>
 
 #include "asserts.h"
@@ -380,12 +381,27 @@ class PrePackingTestOpKernel : public OpKernel {
     return Status::OK();
   }
 
+  Status UseSerializedPrePackedBuffers(const Tensor& tensor, int input_idx,
+                                       std::vector<BufferUniquePtr>& prepacked_buffers,
+                                       gsl::span<const size_t> prepacked_buffer_sizes,
+                                       /*out*/ bool& used_prepacked_buffers) override {
+    ORT_UNUSED_PARAMETER(tensor);
+    ORT_UNUSED_PARAMETER(input_idx);
+    ORT_UNUSED_PARAMETER(prepacked_buffer_sizes);
+
+    weight_packed_ = std::move(prepacked_buffers[0]);
+    used_prepacked_buffers = true;
+    ++use_prepacked_buffers_calls_count;
+    return Status::OK();
+  }
+
   int prepack_calls_count = 0;
   int store_pre_packed_weight_calls_count = 0;
+  int use_prepacked_buffers_calls_count = 0;
   IAllocatorUniquePtr<void> weight_packed_;
 };
 
-static void CreateSimpleGraph(Graph& graph) {
+static void CreateSimpleGraph(Graph& graph, float initializer_value = 1.0f) {
   // node creation and placement
   TypeProto type;
   type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
@@ -406,7 +422,7 @@ static void CreateSimpleGraph(Graph& graph) {
   // add an initializer
   ONNX_NAMESPACE::TensorProto tensor;
   tensor.add_dims(1);
-  tensor.add_float_data(1.0f);
+  tensor.add_float_data(initializer_value);
   tensor.set_data_type(TensorProto_DataType_FLOAT);
   tensor.set_name("node_0_input_1");
   graph.AddInitializedTensor(tensor);
@@ -974,6 +990,153 @@ TEST_F(SessionStateTestSharedInitalizersWithPrePacking, test4) {
   ASSERT_EQ(if_node_branches_shared_prepack_counter_2, static_cast<size_t>(2));
 }
 
+// Pre-packing enabled + environment level shared pre-packed weights cache = pre-packed weights are de-duplicated
+// across sessions without sharing initializers, and released once no session uses them anymore
+TEST_F(SessionStateTestSharedInitalizersWithPrePacking, SharedPrepackedWeightsCache) {
+  SessionOptions sess_options;
+  sess_options.enable_mem_pattern = true;
+  sess_options.execution_mode = ExecutionMode::ORT_SEQUENTIAL;
+  sess_options.use_deterministic_compute = false;
+  sess_options.enable_mem_reuse = true;
+  // Enable pre-packing
+  sess_options.config_options.configurations[kOrtSessionOptionsConfigDisablePrepacking] = "0";
+
+  SharedPrepackedWeightsCache shared_prepacked_weights_cache({"PrePackingTest"});
+
+  // First session/model
+  Model model_1("graph_main", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+                domain_to_version, std::vector<ONNX_NAMESPACE::FunctionProto>(),
+                DefaultLoggingManager().DefaultLogger());
+
+  CreateSimpleGraph(model_1.MainGraph());
+  PlaceAllNodesToCPUEP(model_1.MainGraph());
+  auto session_state_1 = std::make_unique<SessionState>(model_1.MainGraph(),
+                                                        execution_providers,
+                                                        tp.get(),
+                                                        nullptr, /*inter_op_thread_pool*/
+                                                        dtm,
+                                                        DefaultLoggingManager().DefaultLogger(),
+                                                        profiler,
+                                                        sess_options,
+                                                        nullptr, /*prepacked_weights_container*/
+                                                        nullptr, /*parent_allocators*/
+                                                        &shared_prepacked_weights_cache);
+
+  ASSERT_STATUS_OK(session_state_1->FinalizeSessionState(std::basic_string<PATH_CHAR_TYPE>(),
+                                                         kernel_registry_manager));
+
+  const auto* kernel = reinterpret_cast<const PrePackingTestOpKernel*>(session_state_1->GetKernel(0));
+
+  // The first session populates the cache and uses the cached copy
+  ASSERT_EQ(session_state_1->GetNumberOfPrepacksCounter(), static_cast<size_t>(1));
+  ASSERT_EQ(session_state_1->GetUsedSharedPrePackedWeightCounter(), static_cast<size_t>(0));
+  ASSERT_EQ(kernel->prepack_calls_count, 1);
+  ASSERT_EQ(kernel->store_pre_packed_weight_calls_count, 1);
+  ASSERT_EQ(shared_prepacked_weights_cache.GetNumberOfElements(), static_cast<size_t>(1));
+
+  // Second session/model
+  Model model_2("graph_main", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+                domain_to_version, std::vector<ONNX_NAMESPACE::FunctionProto>(),
+                DefaultLoggingManager().DefaultLogger());
+
+  CreateSimpleGraph(model_2.MainGraph());
+  PlaceAllNodesToCPUEP(model_2.MainGraph());
+  auto session_state_2 = std::make_unique<SessionState>(model_2.MainGraph(),
+                                                        execution_providers,
+                                                        tp.get(),
+                                                        nullptr, /*inter_op_thread_pool*/
+                                                        dtm,
+                                                        DefaultLoggingManager().DefaultLogger(),
+                                                        profiler,
+                                                        sess_options,
+                                                        nullptr, /*prepacked_weights_container*/
+                                                        nullptr, /*parent_allocators*/
+                                                        &shared_prepacked_weights_cache);
+
+  ASSERT_STATUS_OK(session_state_2->FinalizeSessionState(std::basic_string<PATH_CHAR_TYPE>(),
+                                                         kernel_registry_manager));
+
+  const auto* kernel_2 = reinterpret_cast<const PrePackingTestOpKernel*>(session_state_2->GetKernel(0));
+
+  // The second session finds the pre-packed weight of the first one in the cache and doesn't pre-pack it again
+  ASSERT_EQ(session_state_2->GetNumberOfPrepacksCounter(), static_cast<size_t>(1));
+  ASSERT_EQ(session_state_2->GetUsedSharedPrePackedWeightCounter(), static_cast<size_t>(1));
+  ASSERT_EQ(kernel_2->prepack_calls_count, 0);
+  ASSERT_EQ(kernel_2->use_prepacked_buffers_calls_count, 1);
+  ASSERT_EQ(kernel->weight_packed_.get(), kernel_2->weight_packed_.get());
+  ASSERT_EQ(shared_prepacked_weights_cache.GetNumberOfElements(), static_cast<size_t>(1));
+
+  // Third session/model with a different initializer
+  Model model_3("graph_main", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+                domain_to_version, std::vector<ONNX_NAMESPACE::FunctionProto>(),
+                DefaultLoggingManager().DefaultLogger());
+
+  CreateSimpleGraph(model_3.MainGraph(), 2.0f);
+  PlaceAllNodesToCPUEP(model_3.MainGraph());
+  auto session_state_3 = std::make_unique<SessionState>(model_3.MainGraph(),
+                                                        execution_providers,
+                                                        tp.get(),
+                                                        nullptr, /*inter_op_thread_pool*/
+                                                        dtm,
+                                                        DefaultLoggingManager().DefaultLogger(),
+                                                        profiler,
+                                                        sess_options,
+                                                        nullptr, /*prepacked_weights_container*/
+                                                        nullptr, /*parent_allocators*/
+                                                        &shared_prepacked_weights_cache);
+
+  ASSERT_STATUS_OK(session_state_3->FinalizeSessionState(std::basic_string<PATH_CHAR_TYPE>(),
+                                                         kernel_registry_manager));
+
+  const auto* kernel_3 = reinterpret_cast<const PrePackingTestOpKernel*>(session_state_3->GetKernel(0));
+
+  // The cache is keyed by the contents of the initializer, so the weight is packed and cached separately
+  // even though the kernel produces the same pre-packed buffer for it
+  ASSERT_EQ(session_state_3->GetUsedSharedPrePackedWeightCounter(), static_cast<size_t>(0));
+  ASSERT_EQ(kernel_3->prepack_calls_count, 1);
+  ASSERT_NE(kernel->weight_packed_.get(), kernel_3->weight_packed_.get());
+  ASSERT_EQ(shared_prepacked_weights_cache.GetNumberOfElements(), static_cast<size_t>(2));
+
+  // The entries are kept alive as long as one session uses them
+  session_state_1.reset();
+  ASSERT_EQ(shared_prepacked_weights_cache.GetNumberOfElements(), static_cast<size_t>(2));
+
+  session_state_2.reset();
+  ASSERT_EQ(shared_prepacked_weights_cache.GetNumberOfElements(), static_cast<size_t>(1));
+
+  session_state_3.reset();
+  ASSERT_EQ(shared_prepacked_weights_cache.GetNumberOfElements(), static_cast<size_t>(0));
+}
+
+TEST(SharedPrepackedWeightsCacheTest, FindAndInsert) {
+  SharedPrepackedWeightsCache cache;
+  auto make_weights = [&cache](float value) {
+    PrePackedWeights weights;
+    weights.buffers_.push_back(IAllocator::MakeUniquePtr<void>(cache.GetAllocator(), 4 * sizeof(float)));
+    weights.buffer_sizes_.push_back(4 * sizeof(float));
+    std::fill_n(static_cast<float*>(weights.buffers_[0].get()), 4, value);
+    return weights;
+  };
+
+  EXPECT_EQ(cache.Find("key"), nullptr);
+
+  bool found_existing = true;
+  auto cached = cache.GetOrInsert("key", make_weights(1.f), found_existing);
+  EXPECT_FALSE(found_existing);
+  EXPECT_EQ(cache.Find("key"), cached);
+
+  // a session that packed the weight concurrently gets the entry that was inserted first
+  auto same = cache.GetOrInsert("key", make_weights(1.f), found_existing);
+  EXPECT_TRUE(found_existing);
+  EXPECT_EQ(cached.get(), same.get());
+  EXPECT_EQ(cache.GetNumberOfElements(), static_cast<size_t>(1));
+
+  cached.reset();
+  same.reset();
+  EXPECT_EQ(cache.Find("key"), nullptr);
+  EXPECT_EQ(cache.GetNumberOfElements(), static_cast<size_t>(0));
+}
+
 INSTANTIATE_TEST_SUITE_P(SessionStateTests,
                          SessionStatePrepackingTest,
                          testing::Values(PrepackingTestParam{false, false},
@@ -0,0 +1,172 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/allocator.h"
+#include "core/framework/symbolic_mem_pattern_planner.h"
+#include "core/framework/symbolic_shape_inference.h"
+#include "core/graph/model.h"
+
+#include "gtest/gtest.h"
+#include "test/test_environment.h"
+
+using namespace ONNX_NAMESPACE;
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+std::string ShapeToString(const SymbolicShapeInference& inference, const std::string& name) {
+  const SymbolicShape* shape = inference.GetShape(name);
+  if (shape == nullptr) {
+    return "unknown";
+  }
+  std::string result;
+  for (const auto& dim : *shape) {
+    result += result.empty() ? "[" : ",";
+    result += dim.has_value() ? dim->ToString(inference.SymbolNames()) : "?";
+  }
+  return result + "]";
+}
+
+SymbolicDim Product(int64_t coefficient, std::initializer_list<int> symbols) {
+  SymbolicDim result(coefficient);
+  for (int symbol : symbols) {
+    result = *result.Multiply(SymbolicDim::Symbol(symbol));
+  }
+  return result;
+}
+}  // namespace
+
+TEST(SymbolicMemPatternPlannerTest, SymbolicDim) {
+  const SymbolicDim batch_seq = Product(4, {0, 1});
+  const SymbolicDim seq = Product(2, {1});
+  EXPECT_EQ(*batch_seq.Divide(seq), Product(2, {0}));
+  EXPECT_FALSE(seq.Divide(batch_seq).has_value());
+  EXPECT_FALSE(batch_seq.Divide(SymbolicDim(3)).has_value());
+  EXPECT_EQ(*seq.Add(Product(3, {1})), Product(5, {1}));
+  EXPECT_FALSE(seq.Add(batch_seq).has_value());
+  EXPECT_TRUE(seq.IsBoundedBy(batch_seq));
+  EXPECT_FALSE(batch_seq.IsBoundedBy(seq));
+  EXPECT_FALSE(Product(8, {1}).IsBoundedBy(batch_seq));
+
+  int64_t value = 0;
+  ASSERT_TRUE(batch_seq.Evaluate(std::vector<int64_t>{3, 5}, value));
+  EXPECT_EQ(value, 60);
+  EXPECT_FALSE(batch_seq.Evaluate(std::vector<int64_t>{int64_t{1} << 40, int64_t{1} << 40}, value));
+  EXPECT_EQ(batch_seq.ToString(std::vector<std::string>{"batch", "seq"}), "4*batch*seq");
+}
+
+TEST(SymbolicMemPatternPlannerTest, InferShapes) {
+  Model model("symbolic_shapes", false, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+
+  TypeProto input_type;
+  input_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  auto* input_shape = input_type.mutable_tensor_type()->mutable_shape();
+  input_shape->add_dim()->set_dim_param("batch");
+  input_shape->add_dim()->set_dim_param("seq");
+  input_shape->add_dim()->set_dim_value(8);
+  auto& input = graph.GetOrCreateNodeArg("X", &input_type);
+
+  TensorProto weights;
+  weights.set_name("W");
+  weights.set_data_type(TensorProto_DataType_FLOAT);
+  weights.add_dims(8);
+  weights.add_dims(16);
+  for (int i = 0; i < 8 * 16; ++i) {
+    weights.add_float_data(1.f);
+  }
+  graph.AddInitializedTensor(weights);
+
+  // the ONNX shape inference can't express the dimension inferred for -1 in terms of the inputs.
+  TensorProto target_shape;
+  target_shape.set_name("target_shape");
+  target_shape.set_data_type(TensorProto_DataType_INT64);
+  target_shape.add_dims(2);
+  target_shape.add_int64_data(-1);
+  target_shape.add_int64_data(4);
+  graph.AddInitializedTensor(target_shape);
+
+  auto& matmul_out = graph.GetOrCreateNodeArg("matmul_out", nullptr);
+  auto& reshape_out = graph.GetOrCreateNodeArg("reshape_out", nullptr);
+  auto& transpose_out = graph.GetOrCreateNodeArg("transpose_out", nullptr);
+  graph.AddNode("matmul", "MatMul", "", {&input, graph.GetNodeArg("W")}, {&matmul_out});
+  graph.AddNode("reshape", "Reshape", "", {&matmul_out, graph.GetNodeArg("target_shape")}, {&reshape_out});
+  graph.AddNode("transpose", "Transpose", "", {&reshape_out}, {&transpose_out});
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  GraphViewer graph_viewer(graph);
+  SymbolicShapeInference inference(graph_viewer, graph_viewer.GetInputs());
+  EXPECT_EQ(ShapeToString(inference, "matmul_out"), "[batch,seq,16]");
+  EXPECT_EQ(ShapeToString(inference, "reshape_out"), "[4*batch*seq,4]");
+  EXPECT_EQ(ShapeToString(inference, "transpose_out"), "[4,4*batch*seq]");
+  EXPECT_EQ(inference.GetSize("transpose_out")->ToString(inference.SymbolNames()), "16*batch*seq");
+  EXPECT_EQ(ShapeToString(inference, "unknown_value"), "unknown");
+}
+
+TEST(SymbolicMemPatternPlannerTest, GeneratePatterns) {
+  const OrtDevice cpu;
+  SymbolicMemPatternPlanner planner;
+  // value 0: 64 * batch * seq bytes, value 1: 64 * batch bytes, value 2: 32 * seq bytes, value 3: 100 bytes
+  planner.TraceAllocation(0, cpu, Product(64, {0, 1}));
+  planner.TraceAllocation(1, cpu, Product(64, {0}));
+  planner.TraceFree(0);
+  // fits in the slot of value 0.
+  planner.TraceAllocation(2, cpu, Product(32, {1}));
+  planner.TraceFree(1);
+  // the slot of value 1 can't hold a constant size larger than 64.
+  planner.TraceAllocation(3, cpu, SymbolicDim(100));
+  EXPECT_EQ(planner.NumSlots(), 3u);
+
+  for (const auto& symbol_values : {std::vector<int64_t>{1, 1}, std::vector<int64_t>{3, 100}}) {
+    const int64_t batch = symbol_values[0];
+    const int64_t seq = symbol_values[1];
+    MemoryPatternGroup group;
+    ASSERT_TRUE(planner.GeneratePatterns(symbol_values, group).IsOK());
+    ASSERT_EQ(group.locations.size(), 1u);
+    const MemoryPattern* pattern = group.GetPatterns(cpu);
+    ASSERT_NE(pattern, nullptr);
+
+    auto aligned = [](int64_t size) {
+      return static_cast<size_t>((size + kAllocAlignment - 1) / kAllocAlignment * kAllocAlignment);
+    };
+    const size_t slot_0 = aligned(64 * batch * seq);
+    const size_t slot_1 = aligned(64 * batch);
+    EXPECT_EQ(pattern->GetBlock(0)->offset_, 0u);
+    EXPECT_EQ(pattern->GetBlock(0)->size_, slot_0);
+    EXPECT_EQ(pattern->GetBlock(1)->offset_, slot_0);
+    EXPECT_EQ(pattern->GetBlock(1)->size_, slot_1);
+    EXPECT_EQ(pattern->GetBlock(2)->offset_, 0u);
+    EXPECT_EQ(pattern->GetBlock(2)->size_, aligned(32 * seq));
+    EXPECT_EQ(pattern->GetBlock(3)->offset_, slot_0 + slot_1);
+    EXPECT_EQ(pattern->GetBlock(3)->size_, aligned(100));
+    EXPECT_EQ(pattern->PeakSize(), slot_0 + slot_1 + aligned(100));
+  }
+
+  MemoryPatternGroup group;
+  EXPECT_FALSE(planner.GeneratePatterns(std::vector<int64_t>{0, 1}, group).IsOK());
+}
+
+TEST(SymbolicMemPatternPlannerTest, GrowSlot) {
+  const OrtDevice cpu;
+  SymbolicMemPatternPlanner planner;
+  planner.TraceAllocation(0, cpu, Product(4, {0}));
+  planner.TraceFree(0);
+  // the free slot grows as its previous value is bounded by the new one.
+  planner.TraceAllocation(1, cpu, Product(1024, {0, 0}));
+  planner.TraceAllocation(2, cpu, SymbolicDim(256));
+  EXPECT_EQ(planner.NumSlots(), 2u);
+
+  MemoryPatternGroup group;
+  ASSERT_TRUE(planner.GeneratePatterns(std::vector<int64_t>{10}, group).IsOK());
+  const MemoryPattern* pattern = group.GetPatterns(cpu);
+  EXPECT_EQ(pattern->GetBlock(0)->offset_, 0u);
+  EXPECT_EQ(pattern->GetBlock(0)->size_, 256u);
+  EXPECT_EQ(pattern->GetBlock(1)->offset_, 0u);
+  EXPECT_EQ(pattern->GetBlock(1)->size_, 102400u);
+  EXPECT_EQ(pattern->GetBlock(2)->offset_, 102400u);
+  EXPECT_EQ(pattern->PeakSize(), 102400u + 256u);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
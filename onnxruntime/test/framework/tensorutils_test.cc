@@ -191,6 +191,29 @@ TEST(TensorProtoUtilsTest, UnpackTensorWithExternalData) {
   TestUnpackExternalTensor<bool>(TensorProto_DataType_BOOL, model_path);
 }
 
+TEST(TensorProtoUtilsTest, HasAlignedExternalData) {
+  TensorProto tensor_proto;
+  tensor_proto.set_data_type(TensorProto_DataType_FLOAT);
+  tensor_proto.add_dims(16);
+  EXPECT_FALSE(utils::HasAlignedExternalData(tensor_proto, 64));
+
+  tensor_proto.set_data_location(onnx::TensorProto_DataLocation_EXTERNAL);
+  onnx::StringStringEntryProto* location = tensor_proto.mutable_external_data()->Add();
+  location->set_key("location");
+  location->set_value("weights.bin");
+  // no offset means the data starts at the beginning of the file
+  EXPECT_TRUE(utils::HasAlignedExternalData(tensor_proto, 64));
+
+  onnx::StringStringEntryProto* offset = tensor_proto.mutable_external_data()->Add();
+  offset->set_key("offset");
+  offset->set_value("128");
+  EXPECT_TRUE(utils::HasAlignedExternalData(tensor_proto, 64));
+
+  offset->set_value("96");
+  EXPECT_FALSE(utils::HasAlignedExternalData(tensor_proto, 64));
+  EXPECT_TRUE(utils::HasAlignedExternalData(tensor_proto, 32));
+}
+
 template <typename T>
 static NodeProto CreateConstantNode(const std::string& attrib_name, AttributeProto_AttributeType type,
                                     std::function<void(AttributeProto&)> add_data) {
@@ -0,0 +1,157 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_util.h"
+
+static uint16_t FloatToBf16(float Value) {
+  uint32_t Bits;
+  std::memcpy(&Bits, &Value, sizeof(Bits));
+  Bits += 0x7FFF + ((Bits >> 16) & 1);
+  return static_cast<uint16_t>(Bits >> 16);
+}
+
+static float Bf16ToFloat(uint16_t Value) {
+  uint32_t Bits = uint32_t(Value) << 16;
+  float Result;
+  std::memcpy(&Result, &Bits, sizeof(Result));
+  return Result;
+}
+
+template <bool Packed, bool Threaded>
+class MlasBf16GemmTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<uint16_t> BufferA;
+  MatrixGuardBuffer<uint16_t> BufferB;
+  MatrixGuardBuffer<uint8_t> BufferBPacked;
+  MatrixGuardBuffer<float> BufferBias;
+  MatrixGuardBuffer<float> BufferC;
+  MatrixGuardBuffer<uint16_t> BufferCBf16;
+  std::vector<double> CReference;
+  MLAS_THREADPOOL* threadpool_;
+
+  void Test(size_t M, size_t N, size_t K, size_t BatchSize, bool WithBias, bool CIsBf16) {
+    uint16_t* A = BufferA.GetBuffer(K * M * BatchSize);
+    uint16_t* B = BufferB.GetBuffer(N * K * BatchSize);
+    float* Bias = WithBias ? BufferBias.GetBuffer(N * BatchSize) : nullptr;
+    float* C = BufferC.GetBuffer(N * M * BatchSize, true);
+    uint16_t* CBf16 = BufferCBf16.GetBuffer(N * M * BatchSize, true);
+    CReference.resize(N * M * BatchSize);
+
+    std::default_random_engine generator(static_cast<unsigned>(M * N * K * BatchSize));
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+
+    for (size_t i = 0; i < K * M * BatchSize; i++) {
+      A[i] = FloatToBf16(distribution(generator));
+    }
+    for (size_t i = 0; i < N * K * BatchSize; i++) {
+      B[i] = FloatToBf16(distribution(generator));
+    }
+    if (WithBias) {
+      for (size_t i = 0; i < N * BatchSize; i++) {
+        Bias[i] = distribution(generator);
+      }
+    }
+
+    const size_t PackedBSize = MlasBf16GemmPackBSize(N, K);
+    uint8_t* PackedB = Packed ? BufferBPacked.GetBuffer(PackedBSize * BatchSize) : nullptr;
+
+    std::vector<MLAS_BF16_GEMM_DATA_PARAMS> GemmParameters(BatchSize);
+
+    for (size_t i = 0; i < BatchSize; i++) {
+      auto& params = GemmParameters[i];
+      params.A = reinterpret_cast<const MLAS_BF16*>(A + K * M * i);
+      params.lda = K;
+      if (Packed) {
+        MlasBf16GemmPackB(CblasNoTrans, N, K, reinterpret_cast<const MLAS_BF16*>(B + K * N * i), N,
+                          PackedB + PackedBSize * i);
+        params.B = PackedB + PackedBSize * i;
+        params.ldb = 0;
+      } else {
+        params.B = B + K * N * i;
+        params.ldb = N;
+      }
+      params.Bias = WithBias ? Bias + N * i : nullptr;
+      params.C = CIsBf16 ? static_cast<void*>(CBf16 + M * N * i) : static_cast<void*>(C + M * N * i);
+      params.ldc = N;
+      params.CIsBf16 = CIsBf16;
+    }
+
+    MlasBf16GemmBatch(M, N, K, BatchSize, GemmParameters.data(), threadpool_);
+
+    for (size_t b = 0; b < BatchSize; b++) {
+      for (size_t m = 0; m < M; m++) {
+        for (size_t n = 0; n < N; n++) {
+          double Sum = WithBias ? Bias[N * b + n] : 0.0;
+          for (size_t k = 0; k < K; k++) {
+            Sum += double(Bf16ToFloat(A[K * M * b + K * m + k])) * double(Bf16ToFloat(B[K * N * b + N * k + n]));
+          }
+          CReference[N * M * b + N * m + n] = Sum;
+        }
+      }
+    }
+
+    // The products of bfloat16 values are exact in single precision, so the
+    // error comes from the accumulation, and from the final rounding when the
+    // result is bfloat16.
+    const double Tolerance = CIsBf16 ? 1.0 / 128 : 1.0 / 4096;
+
+    for (size_t i = 0; i < M * N * BatchSize; i++) {
+      const double Result = CIsBf16 ? Bf16ToFloat(CBf16[i]) : C[i];
+      const double Expected = CReference[i];
+      ASSERT_LE(std::fabs(Result - Expected), Tolerance * (std::fabs(Expected) + 1.0))
+          << "M/N/K/Batch:" << M << "/" << N << "/" << K << "/" << BatchSize
+          << " Bias:" << WithBias << " CIsBf16:" << CIsBf16 << " @" << i
+          << ", got: " << Result << ", expecting: " << Expected;
+    }
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static std::string suite_name = std::string("Bf16Gemm") +
+                                    (Packed ? "_Packed" : "_NoPack") +
+                                    (Threaded ? "_Threaded" : "_SingleThread");
+    return suite_name.c_str();
+  }
+
+  MlasBf16GemmTest() : threadpool_(Threaded ? GetMlasThreadPool() : nullptr) {}
+
+  void ExecuteShort(void) override {
+    for (bool CIsBf16 : {false, true}) {
+      for (bool WithBias : {false, true}) {
+        Test(1, 1, 1, 1, WithBias, CIsBf16);
+        Test(1, 16, 32, 1, WithBias, CIsBf16);
+        Test(5, 19, 7, 2, WithBias, CIsBf16);
+        Test(16, 32, 64, 1, WithBias, CIsBf16);
+        Test(31, 47, 33, 1, WithBias, CIsBf16);
+        Test(33, 100, 257, 3, WithBias, CIsBf16);
+        Test(130, 300, 520, 1, WithBias, CIsBf16);
+      }
+    }
+    Test(4, 8, 0, 1, true, false);
+    Test(0, 8, 4, 1, true, false);
+    Test(4, 0, 4, 1, true, false);
+    Test(4, 8, 4, 0, true, false);
+  }
+};
+
+template <>
+MlasBf16GemmTest<false, false>* MlasTestFixture<MlasBf16GemmTest<false, false>>::mlas_tester(nullptr);
+template <>
+MlasBf16GemmTest<false, true>* MlasTestFixture<MlasBf16GemmTest<false, true>>::mlas_tester(nullptr);
+template <>
+MlasBf16GemmTest<true, false>* MlasTestFixture<MlasBf16GemmTest<true, false>>::mlas_tester(nullptr);
+template <>
+MlasBf16GemmTest<true, true>* MlasTestFixture<MlasBf16GemmTest<true, true>>::mlas_tester(nullptr);
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  size_t count = 0;
+  if (is_short_execute) {
+    count += MlasDirectShortExecuteTests<MlasBf16GemmTest<false, false>>::RegisterShortExecute();
+    count += MlasDirectShortExecuteTests<MlasBf16GemmTest<true, false>>::RegisterShortExecute();
+    if (GetMlasThreadPool() != nullptr) {
+      count += MlasDirectShortExecuteTests<MlasBf16GemmTest<false, true>>::RegisterShortExecute();
+      count += MlasDirectShortExecuteTests<MlasBf16GemmTest<true, true>>::RegisterShortExecute();
+    }
+  }
+  return count;
+});
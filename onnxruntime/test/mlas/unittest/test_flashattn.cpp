@@ -0,0 +1,162 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_util.h"
+
+template <bool Threaded>
+class MlasFlashAttentionTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<float> BufferQuery;
+  MatrixGuardBuffer<float> BufferKey;
+  MatrixGuardBuffer<float> BufferValue;
+  MatrixGuardBuffer<float> BufferKeyBias;
+  MatrixGuardBuffer<float> BufferOutput;
+  MatrixGuardBuffer<float> BufferOutputReference;
+  MLAS_THREADPOOL* threadpool_;
+
+  void Test(size_t B, size_t N, size_t S, size_t T, size_t H, size_t Hv, bool Causal, bool HasKeyBias) {
+    float* Query = BufferQuery.GetBuffer(B * N * S * H);
+    float* Key = BufferKey.GetBuffer(B * N * T * H);
+    float* Value = BufferValue.GetBuffer(B * N * T * Hv);
+    float* KeyBias = HasKeyBias ? BufferKeyBias.GetBuffer(B * T) : nullptr;
+    float* Output = BufferOutput.GetBuffer(B * S * N * Hv);
+    float* OutputReference = BufferOutputReference.GetBuffer(B * S * N * Hv);
+
+    std::default_random_engine generator(static_cast<unsigned>(B * N * S * T * H));
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+
+    for (size_t i = 0; i < B * N * S * H; i++) {
+      Query[i] = distribution(generator);
+    }
+    for (size_t i = 0; i < B * N * T * H; i++) {
+      Key[i] = distribution(generator);
+    }
+    for (size_t i = 0; i < B * N * T * Hv; i++) {
+      Value[i] = distribution(generator);
+    }
+    if (HasKeyBias) {
+      // Mask the keys at the end of each batch, like right side padding.
+      for (size_t b = 0; b < B; b++) {
+        for (size_t t = 0; t < T; t++) {
+          KeyBias[b * T + t] = (t + b < T) ? 0.0f : -10000.0f;
+        }
+      }
+    }
+
+    MLAS_FLASH_ATTENTION_PARAMS Params;
+    Params.BatchSize = B;
+    Params.NumHeads = N;
+    Params.SequenceLength = S;
+    Params.KvSequenceLength = T;
+    Params.QkHeadSize = H;
+    Params.VHeadSize = Hv;
+    Params.Scale = 1.0f / std::sqrt(static_cast<float>(H));
+    Params.Causal = Causal;
+    Params.Query = Query;
+    Params.Key = Key;
+    Params.Value = Value;
+    Params.KeyBias = KeyBias;
+    Params.Output = Output;
+
+    MlasFlashAttention(&Params, threadpool_);
+    ReferenceAttention(Params, OutputReference);
+
+    constexpr float AbsoluteTolerance = 1e-5f;
+    constexpr float RelativeTolerance = 1e-4f;
+
+    for (size_t i = 0; i < B * S * N * Hv; i++) {
+      float diff = std::fabs(Output[i] - OutputReference[i]);
+      ASSERT_TRUE(diff <= AbsoluteTolerance || diff <= std::fabs(OutputReference[i]) * RelativeTolerance)
+          << "B/N/S/T/H/Hv:" << B << "/" << N << "/" << S << "/" << T << "/" << H << "/" << Hv
+          << " Causal:" << Causal << " KeyBias:" << HasKeyBias << " @" << i
+          << ", got: " << Output[i] << ", expecting: " << OutputReference[i];
+    }
+  }
+
+  static void ReferenceAttention(const MLAS_FLASH_ATTENTION_PARAMS& Params, float* Output) {
+    const size_t S = Params.SequenceLength;
+    const size_t T = Params.KvSequenceLength;
+    const size_t H = Params.QkHeadSize;
+    const size_t Hv = Params.VHeadSize;
+    std::vector<double> Scores(T);
+
+    for (size_t b = 0; b < Params.BatchSize; b++) {
+      for (size_t n = 0; n < Params.NumHeads; n++) {
+        const size_t HeadOffset = b * Params.NumHeads + n;
+        for (size_t s = 0; s < S; s++) {
+          const float* q = Params.Query + (HeadOffset * S + s) * H;
+          const size_t KeyCount = Params.Causal ? T - S + s + 1 : T;
+
+          double Maximum = std::numeric_limits<double>::lowest();
+          for (size_t t = 0; t < KeyCount; t++) {
+            const float* k = Params.Key + (HeadOffset * T + t) * H;
+            double Score = 0.0;
+            for (size_t h = 0; h < H; h++) {
+              Score += double(q[h]) * double(k[h]);
+            }
+            Score *= Params.Scale;
+            if (Params.KeyBias != nullptr) {
+              Score += Params.KeyBias[b * T + t];
+            }
+            Scores[t] = Score;
+            Maximum = (std::max)(Maximum, Score);
+          }
+
+          double Sum = 0.0;
+          for (size_t t = 0; t < KeyCount; t++) {
+            Scores[t] = std::exp(Scores[t] - Maximum);
+            Sum += Scores[t];
+          }
+
+          float* o = Output + ((b * S + s) * Params.NumHeads + n) * Hv;
+          for (size_t h = 0; h < Hv; h++) {
+            double Accumulation = 0.0;
+            for (size_t t = 0; t < KeyCount; t++) {
+              Accumulation += Scores[t] * Params.Value[(HeadOffset * T + t) * Hv + h];
+            }
+            o[h] = float(Accumulation / Sum);
+          }
+        }
+      }
+    }
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name(Threaded ? "FlashAttention_Threaded" : "FlashAttention_SingleThread");
+    return suite_name.c_str();
+  }
+
+  MlasFlashAttentionTest() : threadpool_(Threaded ? GetMlasThreadPool() : nullptr) {}
+
+  void ExecuteShort(void) override {
+    for (bool Causal : {false, true}) {
+      for (bool HasKeyBias : {false, true}) {
+        Test(1, 1, 1, 1, 8, 8, Causal, HasKeyBias);
+        Test(2, 3, 5, 5, 16, 16, Causal, HasKeyBias);
+        // Queries of the current step attend to past keys.
+        Test(2, 2, 1, 37, 32, 32, Causal, HasKeyBias);
+        Test(1, 2, 7, 300, 24, 40, Causal, HasKeyBias);
+        // More than one block of queries and keys.
+        Test(1, 2, 130, 130, 64, 64, Causal, HasKeyBias);
+        Test(2, 1, 70, 600, 16, 8, Causal, HasKeyBias);
+      }
+    }
+  }
+};
+
+template <>
+MlasFlashAttentionTest<false>* MlasTestFixture<MlasFlashAttentionTest<false>>::mlas_tester(nullptr);
+template <>
+MlasFlashAttentionTest<true>* MlasTestFixture<MlasFlashAttentionTest<true>>::mlas_tester(nullptr);
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  size_t count = 0;
+  if (is_short_execute) {
+    count += MlasDirectShortExecuteTests<MlasFlashAttentionTest<false>>::RegisterShortExecute();
+    if (GetMlasThreadPool() != nullptr) {
+      count += MlasDirectShortExecuteTests<MlasFlashAttentionTest<true>>::RegisterShortExecute();
+    }
+  }
+  return count;
+});
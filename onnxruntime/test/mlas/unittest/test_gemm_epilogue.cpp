@@ -0,0 +1,234 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_util.h"
+
+template <bool Threaded>
+class MlasGemmEpilogueTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<float> BufferA;
+  MatrixGuardBuffer<float> BufferB;
+  MatrixGuardBuffer<uint8_t> BufferBPacked;
+  MatrixGuardBuffer<float> BufferC;
+  MatrixGuardBuffer<float> BufferBias;
+  MatrixGuardBuffer<float> BufferResidual;
+  MatrixGuardBuffer<uint8_t> BufferQuantA;
+  MatrixGuardBuffer<uint8_t> BufferQuantB;
+  std::vector<double> CReference;
+  MLAS_THREADPOOL* threadpool_;
+
+  static double ReferenceEpilogue(double Value, const MLAS_GEMM_EPILOGUE& Epilogue, size_t m, size_t n) {
+    if (Epilogue.Bias != nullptr) {
+      Value += Epilogue.Bias[n];
+    }
+    if (Epilogue.Residual != nullptr) {
+      Value += Epilogue.Residual[m * Epilogue.ldr + n];
+    }
+    switch (Epilogue.Activation.ActivationKind) {
+      case MlasReluActivation:
+        Value = std::max(Value, 0.0);
+        break;
+      case MlasGeluActivation:
+        Value = 0.5 * Value * (1.0 + std::erf(Value / std::sqrt(2.0)));
+        break;
+      case MlasSiluActivation:
+        Value = Value / (1.0 + std::exp(-Value));
+        break;
+      default:
+        break;
+    }
+    return Value;
+  }
+
+  void InitializeEpilogue(MLAS_GEMM_EPILOGUE& Epilogue, size_t M, size_t N, MLAS_ACTIVATION_KIND ActivationKind,
+                          bool HasBias, bool HasResidual, std::default_random_engine& generator) {
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+
+    if (HasBias) {
+      float* Bias = BufferBias.GetBuffer(N);
+      for (size_t i = 0; i < N; i++) {
+        Bias[i] = distribution(generator);
+      }
+      Epilogue.Bias = Bias;
+    }
+    if (HasResidual) {
+      const size_t ldr = N + 3;
+      float* Residual = BufferResidual.GetBuffer(M * ldr);
+      for (size_t i = 0; i < M * ldr; i++) {
+        Residual[i] = distribution(generator);
+      }
+      Epilogue.Residual = Residual;
+      Epilogue.ldr = ldr;
+    }
+    Epilogue.Activation.ActivationKind = ActivationKind;
+  }
+
+  void TestSgemm(size_t M, size_t N, size_t K, bool TransA, bool Packed, float alpha, float beta,
+                 MLAS_ACTIVATION_KIND ActivationKind, bool HasBias, bool HasResidual) {
+    const size_t lda = TransA ? M : K;
+
+    float* A = BufferA.GetBuffer(K * M);
+    float* B = BufferB.GetBuffer(N * K);
+    float* C = BufferC.GetBuffer(N * M);
+    CReference.resize(N * M);
+
+    std::default_random_engine generator(static_cast<unsigned>(M * 131 + N * 17 + K));
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+
+    for (size_t i = 0; i < K * M; i++) {
+      A[i] = distribution(generator);
+    }
+    for (size_t i = 0; i < N * K; i++) {
+      B[i] = distribution(generator);
+    }
+    for (size_t i = 0; i < N * M; i++) {
+      C[i] = distribution(generator);
+    }
+
+    MLAS_GEMM_EPILOGUE Epilogue;
+    InitializeEpilogue(Epilogue, M, N, ActivationKind, HasBias, HasResidual, generator);
+
+    for (size_t m = 0; m < M; m++) {
+      for (size_t n = 0; n < N; n++) {
+        double Sum = 0.0;
+        for (size_t k = 0; k < K; k++) {
+          const double a = TransA ? A[k * lda + m] : A[m * lda + k];
+          Sum += a * B[k * N + n];
+        }
+        CReference[m * N + n] = ReferenceEpilogue(alpha * Sum + beta * C[m * N + n], Epilogue, m, n);
+      }
+    }
+
+    MLAS_SGEMM_DATA_PARAMS Data;
+    Data.A = A;
+    Data.lda = lda;
+    Data.C = C;
+    Data.ldc = N;
+    Data.alpha = alpha;
+    Data.beta = beta;
+    Data.Epilogue = &Epilogue;
+
+    if (Packed) {
+      void* PackedB = BufferBPacked.GetBuffer(MlasGemmPackBSize(N, K), true);
+      MlasGemmPackB(CblasNoTrans, N, K, B, N, PackedB);
+      Data.B = static_cast<const float*>(PackedB);
+      Data.BIsPacked = true;
+    } else {
+      Data.B = B;
+      Data.ldb = N;
+    }
+
+    MlasGemm(TransA ? CblasTrans : CblasNoTrans, CblasNoTrans, M, N, K, Data, threadpool_);
+
+    for (size_t i = 0; i < M * N; i++) {
+      ASSERT_LE(std::fabs(C[i] - CReference[i]), 1e-4 * (std::fabs(CReference[i]) + 1.0))
+          << "M/N/K:" << M << "/" << N << "/" << K << " TransA:" << TransA << " Packed:" << Packed
+          << " Activation:" << int(ActivationKind) << " Bias/Residual:" << HasBias << "/" << HasResidual
+          << " @" << i << ", got: " << C[i] << ", expecting: " << CReference[i];
+    }
+  }
+
+  void TestQgemm(size_t M, size_t N, size_t K, MLAS_ACTIVATION_KIND ActivationKind, bool HasBias, bool HasResidual) {
+    uint8_t* A = BufferQuantA.GetBuffer(K * M);
+    uint8_t* B = BufferQuantB.GetBuffer(N * K);
+    float* C = BufferC.GetBuffer(N * M);
+    CReference.resize(N * M);
+
+    std::default_random_engine generator(static_cast<unsigned>(M * 131 + N * 17 + K));
+    std::uniform_int_distribution<int> distribution(0, 255);
+
+    for (size_t i = 0; i < K * M; i++) {
+      A[i] = static_cast<uint8_t>(distribution(generator));
+    }
+    for (size_t i = 0; i < N * K; i++) {
+      B[i] = static_cast<uint8_t>(distribution(generator));
+    }
+
+    const uint8_t ZeroPointA = 128;
+    const uint8_t ZeroPointB = 120;
+    const float Scale = 1.0f / (64.0f * float(K));
+
+    MLAS_GEMM_EPILOGUE Epilogue;
+    InitializeEpilogue(Epilogue, M, N, ActivationKind, HasBias, HasResidual, generator);
+
+    for (size_t m = 0; m < M; m++) {
+      for (size_t n = 0; n < N; n++) {
+        int32_t Sum = 0;
+        for (size_t k = 0; k < K; k++) {
+          Sum += (int32_t(A[m * K + k]) - ZeroPointA) * (int32_t(B[k * N + n]) - ZeroPointB);
+        }
+        CReference[m * N + n] = ReferenceEpilogue(double(Sum) * Scale, Epilogue, m, n);
+      }
+    }
+
+    MLAS_QGEMM_SCALE_BIAS_OUTPUT_PROCESSOR OutputProcessor(C, N, &Scale, nullptr,
+                                                           MLAS_QGEMM_OUTPUT_MODE::ZeroMode,
+                                                           MLAS_QUANTIZATION_GRANULARITY::PerMatrix,
+                                                           &Epilogue);
+
+    MLAS_GEMM_QUANT_SHAPE_PARAMS Shape;
+    Shape.M = M;
+    Shape.N = N;
+    Shape.K = K;
+
+    MLAS_GEMM_QUANT_DATA_PARAMS Data;
+    Data.A = A;
+    Data.lda = K;
+    Data.ZeroPointA = ZeroPointA;
+    Data.B = B;
+    Data.ldb = N;
+    Data.ZeroPointB = &ZeroPointB;
+    Data.C = reinterpret_cast<int32_t*>(C);
+    Data.ldc = N;
+    Data.OutputProcessor = &OutputProcessor;
+
+    MlasGemm(Shape, Data, threadpool_);
+
+    for (size_t i = 0; i < M * N; i++) {
+      ASSERT_LE(std::fabs(C[i] - CReference[i]), 1e-4 * (std::fabs(CReference[i]) + 1.0))
+          << "M/N/K:" << M << "/" << N << "/" << K << " Activation:" << int(ActivationKind)
+          << " Bias/Residual:" << HasBias << "/" << HasResidual
+          << " @" << i << ", got: " << C[i] << ", expecting: " << CReference[i];
+    }
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static std::string suite_name = std::string("GemmEpilogue") + (Threaded ? "_Threaded" : "_SingleThread");
+    return suite_name.c_str();
+  }
+
+  MlasGemmEpilogueTest() : threadpool_(Threaded ? GetMlasThreadPool() : nullptr) {}
+
+  void ExecuteShort(void) override {
+    for (MLAS_ACTIVATION_KIND ActivationKind :
+         {MlasIdentityActivation, MlasReluActivation, MlasGeluActivation, MlasSiluActivation}) {
+      for (bool Packed : {false, true}) {
+        TestSgemm(1, 64, 32, false, Packed, 1.0f, 0.0f, ActivationKind, true, false);
+        TestSgemm(7, 1, 19, false, Packed, 1.0f, 0.0f, ActivationKind, true, true);
+        TestSgemm(13, 40, 300, false, Packed, 0.5f, 1.0f, ActivationKind, true, true);
+        TestSgemm(33, 257, 64, true, Packed, 1.0f, 0.0f, ActivationKind, false, true);
+        TestSgemm(70, 33, 0, false, Packed, 1.0f, 0.5f, ActivationKind, true, false);
+        TestSgemm(130, 150, 260, true, Packed, 1.0f, -0.5f, ActivationKind, true, true);
+      }
+      TestQgemm(1, 40, 64, ActivationKind, true, false);
+      TestQgemm(29, 75, 130, ActivationKind, true, true);
+    }
+  }
+};
+
+template <>
+MlasGemmEpilogueTest<false>* MlasTestFixture<MlasGemmEpilogueTest<false>>::mlas_tester(nullptr);
+template <>
+MlasGemmEpilogueTest<true>* MlasTestFixture<MlasGemmEpilogueTest<true>>::mlas_tester(nullptr);
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  size_t count = 0;
+  if (is_short_execute) {
+    count += MlasDirectShortExecuteTests<MlasGemmEpilogueTest<false>>::RegisterShortExecute();
+    if (GetMlasThreadPool() != nullptr) {
+      count += MlasDirectShortExecuteTests<MlasGemmEpilogueTest<true>>::RegisterShortExecute();
+    }
+  }
+  return count;
+});
@@ -0,0 +1,142 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_util.h"
+
+class MlasLayerNormTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<float> BufferInput;
+  MatrixGuardBuffer<float> BufferSkip;
+  MatrixGuardBuffer<float> BufferSkipBias;
+  MatrixGuardBuffer<float> BufferScale;
+  MatrixGuardBuffer<float> BufferBias;
+  MatrixGuardBuffer<float> BufferOutput;
+  MatrixGuardBuffer<float> BufferSkipOutput;
+  MatrixGuardBuffer<float> BufferMean;
+  MatrixGuardBuffer<float> BufferInvStdDev;
+
+  static void ReferenceStatistics(const double* Values, size_t N, float Epsilon, bool Simplified,
+                                  double& Mean, double& InvStdDev) {
+    Mean = 0.0;
+    if (!Simplified) {
+      for (size_t n = 0; n < N; n++) Mean += Values[n];
+      Mean /= double(N);
+    }
+    double Variance = 0.0;
+    for (size_t n = 0; n < N; n++) Variance += (Values[n] - Mean) * (Values[n] - Mean);
+    InvStdDev = 1.0 / std::sqrt(Variance / double(N) + Epsilon);
+  }
+
+  float* InitializeBuffer(MatrixGuardBuffer<float>& Buffer, size_t Count, std::default_random_engine& generator,
+                          float Offset) {
+    std::uniform_real_distribution<float> distribution(-2.0f, 2.0f);
+    float* Data = Buffer.GetBuffer(Count);
+    for (size_t i = 0; i < Count; i++) {
+      Data[i] = distribution(generator) + Offset;
+    }
+    return Data;
+  }
+
+  void Test(size_t M, size_t N, bool Simplified, bool HasBias) {
+    std::default_random_engine generator(static_cast<unsigned>(M * 131 + N));
+    const float Epsilon = 1e-5f;
+
+    const float* Input = InitializeBuffer(BufferInput, M * N, generator, 3.0f);
+    const float* Scale = InitializeBuffer(BufferScale, N, generator, 0.0f);
+    const float* Bias = HasBias ? InitializeBuffer(BufferBias, N, generator, 0.0f) : nullptr;
+    float* Output = BufferOutput.GetBuffer(M * N);
+    float* Mean = BufferMean.GetBuffer(M);
+    float* InvStdDev = BufferInvStdDev.GetBuffer(M);
+
+    MlasLayerNormalization(Input, Scale, Bias, Output, Mean, InvStdDev, M, N, Epsilon, Simplified);
+
+    std::vector<double> Values(N);
+    for (size_t m = 0; m < M; m++) {
+      for (size_t n = 0; n < N; n++) Values[n] = Input[m * N + n];
+      double RowMean, RowInvStdDev;
+      ReferenceStatistics(Values.data(), N, Epsilon, Simplified, RowMean, RowInvStdDev);
+
+      if (!Simplified) {
+        ASSERT_NEAR(Mean[m], RowMean, 1e-5 * (std::fabs(RowMean) + 1.0)) << "M/N:" << M << "/" << N << " row " << m;
+      }
+      ASSERT_NEAR(InvStdDev[m], RowInvStdDev, 1e-4 * RowInvStdDev) << "M/N:" << M << "/" << N << " row " << m;
+
+      for (size_t n = 0; n < N; n++) {
+        double Expected = (Values[n] - RowMean) * RowInvStdDev * Scale[n];
+        if (Bias != nullptr) Expected += Bias[n];
+        ASSERT_NEAR(Output[m * N + n], Expected, 1e-4 * (std::fabs(Expected) + 1.0))
+            << "M/N:" << M << "/" << N << " Simplified:" << Simplified << " Bias:" << HasBias
+            << " @" << m << "," << n;
+      }
+    }
+  }
+
+  void TestSkip(size_t N, bool Simplified, bool HasSkipBias, bool HasBias, bool HasSkipOutput) {
+    std::default_random_engine generator(static_cast<unsigned>(N * 7 + HasSkipBias + 2 * HasBias));
+    const float Epsilon = 1e-6f;
+
+    const float* Input = InitializeBuffer(BufferInput, N, generator, 1.0f);
+    const float* Skip = InitializeBuffer(BufferSkip, N, generator, 0.0f);
+    const float* SkipBias = HasSkipBias ? InitializeBuffer(BufferSkipBias, N, generator, 0.0f) : nullptr;
+    const float* Scale = InitializeBuffer(BufferScale, N, generator, 0.0f);
+    const float* Bias = HasBias ? InitializeBuffer(BufferBias, N, generator, 0.0f) : nullptr;
+    float* Output = BufferOutput.GetBuffer(N);
+    float* SkipOutput = HasSkipOutput ? BufferSkipOutput.GetBuffer(N) : nullptr;
+
+    MlasSkipLayerNormalization(Input, Skip, SkipBias, Scale, Bias, Output, SkipOutput, N, Epsilon, Simplified);
+
+    std::vector<double> Values(N);
+    for (size_t n = 0; n < N; n++) {
+      Values[n] = double(Input[n]) + Skip[n] + (SkipBias != nullptr ? SkipBias[n] : 0.0f);
+    }
+    double RowMean, RowInvStdDev;
+    ReferenceStatistics(Values.data(), N, Epsilon, Simplified, RowMean, RowInvStdDev);
+
+    for (size_t n = 0; n < N; n++) {
+      if (SkipOutput != nullptr) {
+        ASSERT_NEAR(SkipOutput[n], Values[n], 1e-6 * (std::fabs(Values[n]) + 1.0)) << "N:" << N << " @" << n;
+      }
+      double Expected = (Values[n] - RowMean) * RowInvStdDev * Scale[n];
+      if (Bias != nullptr) Expected += Bias[n];
+      ASSERT_NEAR(Output[n], Expected, 1e-4 * (std::fabs(Expected) + 1.0))
+          << "N:" << N << " Simplified:" << Simplified << " SkipBias/Bias/SkipOutput:" << HasSkipBias << "/"
+          << HasBias << "/" << HasSkipOutput << " @" << n;
+    }
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name("LayerNorm");
+    return suite_name.c_str();
+  }
+
+  void ExecuteShort(void) override {
+    for (bool Simplified : {false, true}) {
+      for (bool HasBias : {false, true}) {
+        if (Simplified && HasBias) {
+          continue;
+        }
+        Test(1, 1, Simplified, HasBias);
+        Test(3, 7, Simplified, HasBias);
+        Test(5, 16, Simplified, HasBias);
+        Test(17, 63, Simplified, HasBias);
+        Test(4, 768, Simplified, HasBias);
+        Test(2, 1027, Simplified, HasBias);
+      }
+      for (size_t N : {1, 5, 8, 13, 768, 1029}) {
+        for (bool HasSkipBias : {false, true}) {
+          for (bool HasSkipOutput : {false, true}) {
+            TestSkip(N, Simplified, HasSkipBias, !Simplified, HasSkipOutput);
+          }
+        }
+      }
+    }
+  }
+};
+
+template <>
+MlasLayerNormTest* MlasTestFixture<MlasLayerNormTest>::mlas_tester(nullptr);
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  return is_short_execute ? MlasDirectShortExecuteTests<MlasLayerNormTest>::RegisterShortExecute() : 0;
+});
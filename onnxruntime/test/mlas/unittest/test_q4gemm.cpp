@@ -72,6 +72,10 @@ class Q4GemmShortExecuteTest : public MlasTestFixture<MlasQ4GemmTest<QType, Thre
       test_registered += RegisterSingleTest(1, 32, b, true);
       test_registered += RegisterSingleTest(1, b, b, false);
     }
+    for (size_t m = 2; m <= 9; m++) {
+      test_registered += RegisterSingleTest(m, 37, 200, true);
+      test_registered += RegisterSingleTest(m, 128, 96, false);
+    }
     test_registered += RegisterSingleTest(43, 500, 401, true);
     // test_registered += RegisterSingleTest(1001, 1027, 1031, 1, false);
 
@@ -0,0 +1,146 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_util.h"
+
+class MlasReduceTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<float> BufferInput;
+  MatrixGuardBuffer<float> BufferOutput;
+  std::vector<double> Values;
+
+  static double ReferenceReduce(MLAS_REDUCE_KIND ReduceKind, const std::vector<double>& Values) {
+    double Result = 0.0;
+    switch (ReduceKind) {
+      case MlasReduceSum:
+        for (double v : Values) Result += v;
+        break;
+      case MlasReduceSumSquare:
+        for (double v : Values) Result += v * v;
+        break;
+      case MlasReduceSumAbsolute:
+        for (double v : Values) Result += std::fabs(v);
+        break;
+      case MlasReduceMaximum:
+        Result = -std::numeric_limits<double>::infinity();
+        for (double v : Values) Result = std::max(Result, v);
+        break;
+      case MlasReduceMinimum:
+        Result = std::numeric_limits<double>::infinity();
+        for (double v : Values) Result = std::min(Result, v);
+        break;
+      case MlasReduceLogSumExp: {
+        double Maximum = -std::numeric_limits<double>::infinity();
+        for (double v : Values) Maximum = std::max(Maximum, v);
+        if (std::isinf(Maximum)) {
+          return Maximum;
+        }
+        for (double v : Values) Result += std::exp(v - Maximum);
+        Result = std::log(Result) + Maximum;
+        break;
+      }
+      default:
+        break;
+    }
+    return Result;
+  }
+
+  void Test(MLAS_REDUCE_KIND ReduceKind, size_t M, size_t N, bool ReduceRows) {
+    const size_t ldi = N + 5;
+
+    float* Input = BufferInput.GetBuffer(M * ldi);
+    float* Output = BufferOutput.GetBuffer(ReduceRows ? M : N);
+
+    std::default_random_engine generator(static_cast<unsigned>(M * 257 + N));
+    std::uniform_real_distribution<float> distribution(-8.0f, 8.0f);
+
+    for (size_t i = 0; i < M * ldi; i++) {
+      Input[i] = distribution(generator);
+    }
+
+    if (ReduceRows) {
+      MlasReduceRows(ReduceKind, Input, ldi, Output, M, N);
+    } else {
+      MlasReduceColumns(ReduceKind, Input, ldi, Output, M, N);
+    }
+
+    const size_t OutputCount = ReduceRows ? M : N;
+    const size_t ReduceCount = ReduceRows ? N : M;
+
+    for (size_t i = 0; i < OutputCount; i++) {
+      Values.resize(ReduceCount);
+      for (size_t j = 0; j < ReduceCount; j++) {
+        Values[j] = ReduceRows ? Input[i * ldi + j] : Input[j * ldi + i];
+      }
+      const double Expected = ReferenceReduce(ReduceKind, Values);
+      ASSERT_LE(std::fabs(Output[i] - Expected), 1e-5 * (std::fabs(Expected) + 1.0) + 1e-6 * ReduceCount)
+          << "Kind:" << int(ReduceKind) << " M/N:" << M << "/" << N << " Rows:" << ReduceRows
+          << " @" << i << ", got: " << Output[i] << ", expecting: " << Expected;
+    }
+  }
+
+  void TestSpecialValues(MLAS_REDUCE_KIND ReduceKind) {
+    const float Infinity = std::numeric_limits<float>::infinity();
+    const float Input[3][5] = {
+        {-Infinity, -Infinity, -Infinity, -Infinity, -Infinity},
+        {1.0f, Infinity, -2.0f, 0.5f, 3.0f},
+        {-Infinity, 1.0f, -1.0f, -Infinity, 2.0f},
+    };
+
+    float Output[5];
+    MlasReduceRows(ReduceKind, &Input[0][0], 5, Output, 3, 5);
+
+    for (size_t i = 0; i < 3; i++) {
+      Values.assign(std::begin(Input[i]), std::end(Input[i]));
+      const double Expected = ReferenceReduce(ReduceKind, Values);
+      if (std::isinf(Expected)) {
+        EXPECT_EQ(Output[i], Expected) << "Kind:" << int(ReduceKind) << " row " << i;
+      } else {
+        EXPECT_NEAR(Output[i], Expected, 1e-5 * (std::fabs(Expected) + 1.0)) << "Kind:" << int(ReduceKind) << " row " << i;
+      }
+    }
+
+    MlasReduceColumns(ReduceKind, &Input[0][0], 5, Output, 3, 5);
+
+    for (size_t i = 0; i < 5; i++) {
+      Values = {Input[0][i], Input[1][i], Input[2][i]};
+      const double Expected = ReferenceReduce(ReduceKind, Values);
+      if (std::isinf(Expected)) {
+        EXPECT_EQ(Output[i], Expected) << "Kind:" << int(ReduceKind) << " column " << i;
+      } else {
+        EXPECT_NEAR(Output[i], Expected, 1e-5 * (std::fabs(Expected) + 1.0)) << "Kind:" << int(ReduceKind) << " column " << i;
+      }
+    }
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name("Reduce");
+    return suite_name.c_str();
+  }
+
+  void ExecuteShort(void) override {
+    for (int kind = 0; kind < MlasReduceKindCount; kind++) {
+      const auto ReduceKind = static_cast<MLAS_REDUCE_KIND>(kind);
+      for (bool ReduceRows : {true, false}) {
+        Test(ReduceKind, 1, 1, ReduceRows);
+        Test(ReduceKind, 3, 7, ReduceRows);
+        Test(ReduceKind, 5, 16, ReduceRows);
+        Test(ReduceKind, 17, 63, ReduceRows);
+        Test(ReduceKind, 64, 3, ReduceRows);
+        Test(ReduceKind, 130, 1000, ReduceRows);
+        Test(ReduceKind, 1000, 17, ReduceRows);
+      }
+    }
+    for (MLAS_REDUCE_KIND ReduceKind : {MlasReduceMaximum, MlasReduceMinimum, MlasReduceLogSumExp}) {
+      TestSpecialValues(ReduceKind);
+    }
+  }
+};
+
+template <>
+MlasReduceTest* MlasTestFixture<MlasReduceTest>::mlas_tester(nullptr);
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  return is_short_execute ? MlasDirectShortExecuteTests<MlasReduceTest>::RegisterShortExecute() : 0;
+});
@@ -0,0 +1,207 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_util.h"
+
+class MlasBilinearResizeTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<float> BufferInput;
+  MatrixGuardBuffer<float> BufferBuffer;
+  MatrixGuardBuffer<float> BufferOutput;
+  std::vector<int32_t> InputColumn1;
+  std::vector<int32_t> InputColumn2;
+  std::vector<float> ColumnWeight1;
+  std::vector<float> ColumnWeight2;
+
+  void Test(size_t InputHeight, size_t InputWidth, size_t OutputHeight, size_t OutputWidth, size_t Channels) {
+    const size_t InputRowSize = InputWidth * Channels;
+    const size_t OutputRowSize = OutputWidth * Channels;
+
+    float* Input = BufferInput.GetBuffer(InputHeight * InputRowSize);
+    float* Buffer = BufferBuffer.GetBuffer(InputRowSize);
+    float* Output = BufferOutput.GetBuffer(OutputRowSize);
+
+    std::default_random_engine generator(static_cast<unsigned>(InputHeight * 31 + InputWidth * 7 + Channels));
+    std::uniform_real_distribution<float> distribution(-10.0f, 10.0f);
+
+    for (size_t i = 0; i < InputHeight * InputRowSize; i++) {
+      Input[i] = distribution(generator);
+    }
+
+    // Use the half pixel coordinate transformation to map the output pixels to the input pixels.
+    auto Interpolate = [](size_t OutputIndex, size_t InputSize, size_t OutputSize,
+                          int32_t& Index1, int32_t& Index2, float& Weight1, float& Weight2) {
+      float Original = (float(OutputIndex) + 0.5f) * float(InputSize) / float(OutputSize) - 0.5f;
+      Original = std::max(0.0f, std::min(Original, float(InputSize - 1)));
+      Index1 = std::min(int32_t(Original), int32_t(InputSize - 1));
+      Index2 = std::min(Index1 + 1, int32_t(InputSize - 1));
+      Weight2 = Original - float(Index1);
+      Weight1 = 1.0f - Weight2;
+      if (Index1 == Index2) {
+        Weight1 = 0.5f;
+        Weight2 = 0.5f;
+      }
+    };
+
+    InputColumn1.resize(OutputWidth);
+    InputColumn2.resize(OutputWidth);
+    ColumnWeight1.resize(OutputWidth);
+    ColumnWeight2.resize(OutputWidth);
+
+    for (size_t x = 0; x < OutputWidth; x++) {
+      Interpolate(x, InputWidth, OutputWidth, InputColumn1[x], InputColumn2[x], ColumnWeight1[x], ColumnWeight2[x]);
+    }
+
+    for (size_t y = 0; y < OutputHeight; y++) {
+      int32_t InputRow1, InputRow2;
+      float RowWeight1, RowWeight2;
+      Interpolate(y, InputHeight, OutputHeight, InputRow1, InputRow2, RowWeight1, RowWeight2);
+
+      const float* Row1 = Input + InputRow1 * InputRowSize;
+      const float* Row2 = Input + InputRow2 * InputRowSize;
+
+      MlasBilinearResizeRow(Row1, Row2, RowWeight1, RowWeight2, InputColumn1.data(), InputColumn2.data(),
+                            ColumnWeight1.data(), ColumnWeight2.data(), InputWidth, OutputWidth, Channels,
+                            Buffer, Output);
+
+      for (size_t x = 0; x < OutputWidth; x++) {
+        for (size_t c = 0; c < Channels; c++) {
+          const size_t Offset1 = InputColumn1[x] * Channels + c;
+          const size_t Offset2 = InputColumn2[x] * Channels + c;
+          const double Expected = double(RowWeight1) * ColumnWeight1[x] * Row1[Offset1] +
+                                  double(RowWeight1) * ColumnWeight2[x] * Row1[Offset2] +
+                                  double(RowWeight2) * ColumnWeight1[x] * Row2[Offset1] +
+                                  double(RowWeight2) * ColumnWeight2[x] * Row2[Offset2];
+          ASSERT_NEAR(Output[x * Channels + c], Expected, 1e-4)
+              << "Input:" << InputHeight << "x" << InputWidth << " Output:" << OutputHeight << "x" << OutputWidth
+              << " Channels:" << Channels << " @" << y << "," << x << "," << c;
+        }
+      }
+    }
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name("BilinearResize");
+    return suite_name.c_str();
+  }
+
+  void ExecuteShort(void) override {
+    for (size_t Channels : {1, 3, 4, 13, 32}) {
+      Test(1, 1, 3, 5, Channels);
+      Test(4, 4, 8, 8, Channels);
+      Test(7, 9, 3, 4, Channels);
+      Test(16, 15, 37, 29, Channels);
+      Test(32, 64, 32, 64, Channels);
+    }
+  }
+};
+
+template <>
+MlasBilinearResizeTest* MlasTestFixture<MlasBilinearResizeTest>::mlas_tester(nullptr);
+
+class MlasBicubicResizeTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<float> BufferInput;
+  MatrixGuardBuffer<float> BufferBuffer;
+  MatrixGuardBuffer<float> BufferOutput;
+  std::vector<int32_t> InputColumns;
+  std::vector<float> ColumnWeights;
+
+  // Maps an output pixel to the four nearest input pixels, clamped to the image, with the weights of the cubic
+  // convolution (a = -0.75) and the half pixel coordinate transformation.
+  static void Interpolate(size_t OutputIndex, size_t InputSize, size_t OutputSize, int32_t* Indices, float* Weights) {
+    const float Original = (float(OutputIndex) + 0.5f) * float(InputSize) / float(OutputSize) - 0.5f;
+    const float Floor = std::floor(Original);
+    const float s = Original - Floor;
+    const float a = -0.75f;
+    const float Distances[4] = {s + 1.0f, s, 1.0f - s, 2.0f - s};
+    for (int i = 0; i < 4; i++) {
+      const float d = Distances[i];
+      Weights[i] = d <= 1.0f ? ((a + 2.0f) * d - (a + 3.0f)) * d * d + 1.0f
+                             : ((a * d - 5.0f * a) * d + 8.0f * a) * d - 4.0f * a;
+      const int32_t Index = int32_t(Floor) - 1 + i;
+      Indices[i] = std::max(0, std::min(Index, int32_t(InputSize - 1)));
+    }
+  }
+
+  void Test(size_t InputHeight, size_t InputWidth, size_t OutputHeight, size_t OutputWidth, size_t Channels) {
+    const size_t InputRowSize = InputWidth * Channels;
+    const size_t OutputRowSize = OutputWidth * Channels;
+
+    float* Input = BufferInput.GetBuffer(InputHeight * InputRowSize);
+    float* Buffer = BufferBuffer.GetBuffer(InputRowSize);
+    float* Output = BufferOutput.GetBuffer(OutputRowSize);
+
+    std::default_random_engine generator(static_cast<unsigned>(InputHeight * 31 + InputWidth * 7 + Channels));
+    std::uniform_real_distribution<float> distribution(-10.0f, 10.0f);
+
+    for (size_t i = 0; i < InputHeight * InputRowSize; i++) {
+      Input[i] = distribution(generator);
+    }
+
+    InputColumns.resize(OutputWidth * 4);
+    ColumnWeights.resize(OutputWidth * 4);
+
+    for (size_t x = 0; x < OutputWidth; x++) {
+      Interpolate(x, InputWidth, OutputWidth, &InputColumns[x * 4], &ColumnWeights[x * 4]);
+    }
+
+    for (size_t y = 0; y < OutputHeight; y++) {
+      int32_t InputRowIndices[4];
+      float RowWeights[4];
+      Interpolate(y, InputHeight, OutputHeight, InputRowIndices, RowWeights);
+
+      const float* InputRows[4];
+      for (int i = 0; i < 4; i++) {
+        InputRows[i] = Input + InputRowIndices[i] * InputRowSize;
+      }
+
+      MlasBicubicResizeRow(InputRows, RowWeights, InputColumns.data(), ColumnWeights.data(), InputWidth,
+                           OutputWidth, Channels, Buffer, Output);
+
+      for (size_t x = 0; x < OutputWidth; x++) {
+        for (size_t c = 0; c < Channels; c++) {
+          double Expected = 0.0;
+          for (int i = 0; i < 4; i++) {
+            for (int j = 0; j < 4; j++) {
+              Expected += double(RowWeights[i]) * ColumnWeights[x * 4 + j] *
+                          InputRows[i][InputColumns[x * 4 + j] * Channels + c];
+            }
+          }
+          ASSERT_NEAR(Output[x * Channels + c], Expected, 1e-4)
+              << "Input:" << InputHeight << "x" << InputWidth << " Output:" << OutputHeight << "x" << OutputWidth
+              << " Channels:" << Channels << " @" << y << "," << x << "," << c;
+        }
+      }
+    }
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name("BicubicResize");
+    return suite_name.c_str();
+  }
+
+  void ExecuteShort(void) override {
+    for (size_t Channels : {1, 3, 4, 13, 32}) {
+      Test(1, 1, 3, 5, Channels);
+      Test(4, 4, 8, 8, Channels);
+      Test(7, 9, 3, 4, Channels);
+      Test(16, 15, 37, 29, Channels);
+      Test(32, 64, 32, 64, Channels);
+    }
+  }
+};
+
+template <>
+MlasBicubicResizeTest* MlasTestFixture<MlasBicubicResizeTest>::mlas_tester(nullptr);
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  size_t count = 0;
+  if (is_short_execute) {
+    count += MlasDirectShortExecuteTests<MlasBilinearResizeTest>::RegisterShortExecute();
+    count += MlasDirectShortExecuteTests<MlasBicubicResizeTest>::RegisterShortExecute();
+  }
+  return count;
+});
@@ -0,0 +1,107 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_util.h"
+
+template <bool Threaded>
+class MlasSparseGemmTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<float> BufferA;
+  MatrixGuardBuffer<float> BufferB;
+  MatrixGuardBuffer<uint8_t> BufferBPacked;
+  MatrixGuardBuffer<float> BufferC;
+  std::vector<double> CReference;
+  MLAS_THREADPOOL* threadpool_;
+
+  void Test(size_t M, size_t N, size_t K, float Density, bool TransA, bool TransB, float alpha, float beta) {
+    const size_t lda = TransA ? M : K;
+    const size_t ldb = TransB ? K : N;
+
+    float* A = BufferA.GetBuffer(K * M);
+    float* B = BufferB.GetBuffer(N * K);
+    float* C = BufferC.GetBuffer(N * M);
+    CReference.resize(N * M);
+
+    std::default_random_engine generator(static_cast<unsigned>(M * N * K + size_t(Density * 100)));
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+    std::uniform_real_distribution<float> selection(0.0f, 1.0f);
+
+    for (size_t i = 0; i < K * M; i++) {
+      A[i] = distribution(generator);
+    }
+    for (size_t i = 0; i < N * K; i++) {
+      B[i] = (selection(generator) < Density) ? distribution(generator) : 0.0f;
+    }
+    for (size_t i = 0; i < N * M; i++) {
+      C[i] = distribution(generator);
+    }
+
+    for (size_t m = 0; m < M; m++) {
+      for (size_t n = 0; n < N; n++) {
+        double Sum = 0.0;
+        for (size_t k = 0; k < K; k++) {
+          const double a = TransA ? A[k * lda + m] : A[m * lda + k];
+          const double b = TransB ? B[n * ldb + k] : B[k * ldb + n];
+          Sum += a * b;
+        }
+        CReference[m * N + n] = alpha * Sum + beta * C[m * N + n];
+      }
+    }
+
+    const size_t PackedBSize = MlasSparseGemmPackBSize(TransB ? CblasTrans : CblasNoTrans, N, K, B, ldb, 1.0f);
+    ASSERT_GT(PackedBSize, size_t(0));
+    uint8_t* PackedB = BufferBPacked.GetBuffer(PackedBSize, true);
+    MlasSparseGemmPackB(TransB ? CblasTrans : CblasNoTrans, N, K, B, ldb, PackedB);
+
+    MlasSparseGemm(TransA ? CblasTrans : CblasNoTrans, M, N, K, alpha, A, lda, PackedB, beta, C, N, threadpool_);
+
+    for (size_t i = 0; i < M * N; i++) {
+      ASSERT_LE(std::fabs(C[i] - CReference[i]), 1e-4 * (std::fabs(CReference[i]) + 1.0))
+          << "M/N/K:" << M << "/" << N << "/" << K << " Density:" << Density
+          << " TransA/TransB:" << TransA << "/" << TransB << " alpha/beta:" << alpha << "/" << beta
+          << " @" << i << ", got: " << C[i] << ", expecting: " << CReference[i];
+    }
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static std::string suite_name = std::string("SparseGemm") + (Threaded ? "_Threaded" : "_SingleThread");
+    return suite_name.c_str();
+  }
+
+  MlasSparseGemmTest() : threadpool_(Threaded ? GetMlasThreadPool() : nullptr) {}
+
+  void ExecuteShort(void) override {
+    for (float Density : {0.0f, 0.1f, 0.5f, 1.0f}) {
+      Test(1, 1, 1, Density, false, false, 1.0f, 0.0f);
+      Test(1, 40, 96, Density, false, false, 1.0f, 0.0f);
+      Test(5, 19, 7, Density, true, false, 1.0f, 0.0f);
+      Test(16, 32, 64, Density, false, true, 0.5f, 1.0f);
+      Test(31, 47, 300, Density, false, false, 1.0f, 0.0f);
+      Test(33, 257, 513, Density, true, true, 1.0f, -0.5f);
+      Test(130, 150, 260, Density, false, false, 2.0f, 0.0f);
+    }
+
+    // B holds more non-zero elements than the requested maximum density.
+    std::vector<float> B(16 * 16, 1.0f);
+    B[0] = 0.0f;
+    EXPECT_EQ(MlasSparseGemmPackBSize(CblasNoTrans, 16, 16, B.data(), 16, 0.5f), size_t(0));
+    EXPECT_GT(MlasSparseGemmPackBSize(CblasNoTrans, 16, 16, B.data(), 16, 1.0f), size_t(0));
+  }
+};
+
+template <>
+MlasSparseGemmTest<false>* MlasTestFixture<MlasSparseGemmTest<false>>::mlas_tester(nullptr);
+template <>
+MlasSparseGemmTest<true>* MlasTestFixture<MlasSparseGemmTest<true>>::mlas_tester(nullptr);
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  size_t count = 0;
+  if (is_short_execute) {
+    count += MlasDirectShortExecuteTests<MlasSparseGemmTest<false>>::RegisterShortExecute();
+    if (GetMlasThreadPool() != nullptr) {
+      count += MlasDirectShortExecuteTests<MlasSparseGemmTest<true>>::RegisterShortExecute();
+    }
+  }
+  return count;
+});
@@ -1911,6 +1911,59 @@ TEST_F(GraphTransformationTests, Gemm_LeakyRelu_Fusion) {
   ASSERT_TRUE(op_to_count["Gemm"] == 0);
   ASSERT_TRUE(op_to_count["com.microsoft.FusedGemm"] == 1);
 }
+
+// Gelu and SiLU are applied by MLAS in the epilogue of the fused GEMM.
+TEST_F(GraphTransformationTests, Gemm_Gelu_Silu_Fusion) {
+  for (const char* activation : {"Gelu", "QuickGelu"}) {
+    auto build_test_case = [&](ModelTestBuilder& builder) {
+      auto* input_arg = builder.MakeInput<float>({5, 24}, -2.f, 2.f);
+      auto* weight_arg = builder.MakeInitializer<float>({24, 16}, -0.5f, 0.5f);
+      auto* bias_arg = builder.MakeInitializer<float>({16}, -0.5f, 0.5f);
+      auto* gemm_out_arg = builder.MakeIntermediate();
+      auto* output_arg = builder.MakeOutput();
+      builder.AddNode("Gemm", {input_arg, weight_arg, bias_arg}, {gemm_out_arg});
+      auto& act_node = builder.AddNode(activation, {gemm_out_arg}, {output_arg}, kMSDomain);
+      if (std::string(activation) == "QuickGelu") {
+        act_node.AddAttribute("alpha", 1.0f);
+      }
+    };
+
+    auto check_graph = [&](InferenceSessionWrapper& session) {
+      auto op_to_count = CountOpsInGraph(session.GetGraph());
+      EXPECT_EQ(op_to_count["Gemm"], 0);
+      EXPECT_EQ(op_to_count["com.microsoft.FusedGemm"], 1);
+    };
+
+    TransformerTester(build_test_case, check_graph, TransformerLevel::Level1, TransformerLevel::Level2,
+                      13, 1e-5, 1e-4);
+  }
+}
+
+// The residual of Relu(Add(Gemm(A, B), R)) is added in the epilogue of the fused GEMM.
+TEST_F(GraphTransformationTests, Gemm_Residual_Relu_Fusion) {
+  auto build_test_case = [&](ModelTestBuilder& builder) {
+    auto* input_arg = builder.MakeInput<float>({5, 24}, -2.f, 2.f);
+    auto* weight_arg = builder.MakeInitializer<float>({24, 16}, -0.5f, 0.5f);
+    auto* residual_arg = builder.MakeInput<float>({5, 16}, -2.f, 2.f);
+    auto* gemm_out_arg = builder.MakeIntermediate();
+    auto* add_out_arg = builder.MakeIntermediate();
+    auto* output_arg = builder.MakeOutput();
+    builder.AddNode("Gemm", {input_arg, weight_arg}, {gemm_out_arg});
+    builder.AddNode("Add", {gemm_out_arg, residual_arg}, {add_out_arg});
+    builder.AddNode("Relu", {add_out_arg}, {output_arg});
+  };
+
+  auto check_graph = [&](InferenceSessionWrapper& session) {
+    auto op_to_count = CountOpsInGraph(session.GetGraph());
+    EXPECT_EQ(op_to_count["Gemm"], 0);
+    EXPECT_EQ(op_to_count["Add"], 0);
+    EXPECT_EQ(op_to_count["com.microsoft.FusedGemm"], 1);
+  };
+
+  TransformerTester(build_test_case, check_graph, TransformerLevel::Default, TransformerLevel::Level2,
+                    13, 1e-5, 1e-4);
+}
+
 #endif
 
 // (A')'B' = AB'
@@ -2152,6 +2205,43 @@ TEST_F(GraphTransformationTests, GemmSumFusionBasic) {
   ASSERT_TRUE(new_output_defs[0]->Name() == "output");
 }
 
+// Add(Gemm(A, B, _), C) -> Gemm(A, B, C)
+TEST_F(GraphTransformationTests, GemmSumFusionAdd) {
+  auto build_test_case = [&](ModelTestBuilder& builder) {
+    auto* a_arg = builder.MakeInput<float>({{4, 8}});
+    auto* b_arg = builder.MakeInitializer<float>({8, 6}, -1.f, 1.f);
+    auto* c_arg = builder.MakeInput<float>({{4, 6}});
+    auto* gemm_out = builder.MakeIntermediate();
+    auto* output = builder.MakeOutput();
+
+    builder.AddNode("Gemm", {a_arg, b_arg}, {gemm_out});
+    builder.AddNode("Add", {c_arg, gemm_out}, {output});
+  };
+
+  auto pre_graph_checker = [](Graph& graph) {
+    auto op_to_count = CountOpsInGraph(graph);
+    TEST_RETURN_IF_NOT(op_to_count["Gemm"] == 1);
+    TEST_RETURN_IF_NOT(op_to_count["Add"] == 1);
+    return Status::OK();
+  };
+
+  auto post_graph_checker = [](Graph& graph) {
+    auto op_to_count = CountOpsInGraph(graph);
+    TEST_RETURN_IF_NOT(op_to_count["Gemm"] == 1);
+    TEST_RETURN_IF_NOT(op_to_count["Add"] == 0);
+    for (const Node& node : graph.Nodes()) {
+      TEST_RETURN_IF_NOT(node.InputDefs().size() == 3u);
+      TEST_RETURN_IF_NOT(node.GetAttributes().at("beta").f() == 1.0f);
+    }
+    return Status::OK();
+  };
+
+  auto rule_transformer = std::make_unique<RuleBasedGraphTransformer>("RuleTransformer");
+  ASSERT_STATUS_OK(rule_transformer->Register(std::make_unique<GemmSumFusion>()));
+  ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, {11, 13, 14}, *logger_, std::move(rule_transformer),
+                                        TransformerLevel::Level1, 1, pre_graph_checker, post_graph_checker));
+}
+
 // Sum(Gemm(A, B, _), C) -> Gemm(A, B, C), with attributes
 TEST_F(GraphTransformationTests, GemmSumFusionAttributes) {
   constexpr const ORTCHAR_T* model_uri = MODEL_FOLDER "fusion/gemm_sum_attributes.onnx";
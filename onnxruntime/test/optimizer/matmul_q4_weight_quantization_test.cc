@@ -0,0 +1,101 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "graph_transform_test_builder.h"
+
+#include "core/graph/graph.h"
+#include "core/mlas/inc/mlas_q4.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
+#include "test/util/include/asserts.h"
+
+namespace onnxruntime {
+namespace test {
+
+#ifndef DISABLE_CONTRIB_OPS
+
+// The weight holds integers in [-8, 7], and every block of 32 values along K holds both -8 and 7,
+// so the weight is exactly representable with either block quantization type and the results match
+// the fp32 MatMul up to the order of the accumulation.
+static std::vector<float> MakeQ4ExactWeight(int64_t K, int64_t N) {
+  std::vector<float> weight(static_cast<size_t>(K * N));
+  for (int64_t k = 0; k < K; k++) {
+    for (int64_t n = 0; n < N; n++) {
+      weight[static_cast<size_t>(k * N + n)] = static_cast<float>((k * 7 + n * 3) % 16 - 8);
+    }
+  }
+  return weight;
+}
+
+static void TestMatMulQ4WeightQuantization(const std::vector<int64_t>& input_shape, int64_t K, int64_t N,
+                                           const char* quant_type, bool chained) {
+  auto build_test_case = [&](ModelTestBuilder& builder) {
+    auto* input_arg = builder.MakeInput<float>(input_shape, -1.f, 1.f);
+    auto* weight_arg = builder.MakeInitializer<float>({K, N}, MakeQ4ExactWeight(K, N));
+    auto* output_arg = builder.MakeOutput();
+    if (chained) {
+      auto* matmul_out_arg = builder.MakeIntermediate();
+      auto* relu_out_arg = builder.MakeIntermediate();
+      auto* weight2_arg = builder.MakeInitializer<float>({N, N}, MakeQ4ExactWeight(N, N));
+      builder.AddNode("MatMul", {input_arg, weight_arg}, {matmul_out_arg});
+      builder.AddNode("Relu", {matmul_out_arg}, {relu_out_arg});
+      builder.AddNode("MatMul", {relu_out_arg, weight2_arg}, {output_arg});
+    } else {
+      builder.AddNode("MatMul", {input_arg, weight_arg}, {output_arg});
+    }
+  };
+
+  auto check_graph = [&](InferenceSessionWrapper& session) {
+    auto op_to_count = CountOpsInGraph(session.GetGraph());
+    EXPECT_EQ(op_to_count["MatMul"], 0);
+    EXPECT_EQ(op_to_count["com.microsoft.MatMulFpQ4"], chained ? 2 : 1);
+  };
+
+  auto add_session_options = [&](SessionOptions& session_options) {
+    ASSERT_STATUS_OK(session_options.config_options.AddConfigEntry(
+        kOrtSessionOptionsMatMulQ4WeightQuantization, quant_type));
+  };
+
+  TransformerTester(build_test_case,
+                    check_graph,
+                    TransformerLevel::Level1,
+                    TransformerLevel::Level2,
+                    13, 1e-3, 1e-5,
+                    nullptr, add_session_options);
+}
+
+TEST(MatMulQ4WeightQuantizationTests, MatMulToMatMulFpQ4) {
+  if (MlasQ4GemmPackBSize(BlkQ4Zp8, 1, 1) == 0) {
+    GTEST_SKIP() << "No int4 MatMul kernel on this platform";
+  }
+  // GEMV path for token generation
+  TestMatMulQ4WeightQuantization({1, 1, 96}, 96, 40, "zp8", false);
+  TestMatMulQ4WeightQuantization({1, 1, 96}, 96, 40, "sym", false);
+  // partial block along K and a batch of rows
+  TestMatMulQ4WeightQuantization({2, 11, 50}, 50, 33, "zp8", false);
+  TestMatMulQ4WeightQuantization({5, 64}, 64, 64, "sym", true);
+}
+
+TEST(MatMulQ4WeightQuantizationTests, DisabledByDefault) {
+  auto build_test_case = [&](ModelTestBuilder& builder) {
+    auto* input_arg = builder.MakeInput<float>({4, 32}, -1.f, 1.f);
+    auto* weight_arg = builder.MakeInitializer<float>({32, 16}, MakeQ4ExactWeight(32, 16));
+    auto* output_arg = builder.MakeOutput();
+    builder.AddNode("MatMul", {input_arg, weight_arg}, {output_arg});
+  };
+
+  auto check_graph = [&](InferenceSessionWrapper& session) {
+    auto op_to_count = CountOpsInGraph(session.GetGraph());
+    EXPECT_EQ(op_to_count["MatMul"], 1);
+    EXPECT_EQ(op_to_count["com.microsoft.MatMulFpQ4"], 0);
+  };
+
+  TransformerTester(build_test_case, check_graph, TransformerLevel::Level1, TransformerLevel::Level2);
+}
+
+#endif  // DISABLE_CONTRIB_OPS
+
+}  // namespace test
+}  // namespace onnxruntime
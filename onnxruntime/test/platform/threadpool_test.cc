@@ -12,8 +12,10 @@
 
 #include "gtest/gtest.h"
 #include <algorithm>
+#include <future>
 #include <memory>
 #include <functional>
+#include <thread>
 
 #ifdef _WIN32
 #include <Windows.h>
@@ -510,6 +512,77 @@ TEST(ThreadPoolTest, TestStagedMultiLoopSections_4Thread_100Loop) {
   TestStagedMultiLoopSections("TestStagedMultiLoopSections_4Thread_100Loop", 4, 100);
 }
 
+TEST(ThreadPoolTest, TestThreadBudget) {
+  auto tp = std::make_unique<ThreadPool>(&onnxruntime::Env::Default(), onnxruntime::ThreadOptions{}, nullptr, 4, true);
+  const int full_d_of_p = ThreadPool::DegreeOfParallelism(tp.get());
+  // DegreeOfParallelism is scaled on hybrid CPUs
+  const int granularity = full_d_of_p / 4;
+
+  {
+    ThreadPool::ThreadBudgetScope scope(tp.get(), 2);
+    ASSERT_EQ(ThreadPool::DegreeOfParallelism(tp.get()), 2 * granularity);
+  }
+
+  {
+    // a single request using a fair share gets the whole pool
+    ThreadPool::ThreadBudgetScope scope(tp.get(), 0);
+    ASSERT_EQ(ThreadPool::DegreeOfParallelism(tp.get()), full_d_of_p);
+  }
+
+  {
+    // budgets larger than the pool are capped
+    ThreadPool::ThreadBudgetScope scope(tp.get(), 16);
+    ASSERT_EQ(ThreadPool::DegreeOfParallelism(tp.get()), full_d_of_p);
+  }
+
+  // the budget only applies on the thread that entered the scope
+  ASSERT_EQ(ThreadPool::DegreeOfParallelism(tp.get()), full_d_of_p);
+}
+
+TEST(ThreadPoolTest, TestThreadBudgetConcurrentRequests) {
+  auto tp = std::make_unique<ThreadPool>(&onnxruntime::Env::Default(), onnxruntime::ThreadOptions{}, nullptr, 4, true);
+  const int full_d_of_p = ThreadPool::DegreeOfParallelism(tp.get());
+  const int granularity = full_d_of_p / 4;
+
+  // run body on the current thread while another request holds a scope with other_budget
+  auto run_with_concurrent_request = [&](int other_budget, const std::function<void()>& body) {
+    std::promise<void> other_started;
+    std::promise<void> body_done;
+    std::thread other([&]() {
+      ThreadPool::ThreadBudgetScope scope(tp.get(), other_budget);
+      other_started.set_value();
+      body_done.get_future().wait();
+    });
+    other_started.get_future().wait();
+    body();
+    body_done.set_value();
+    other.join();
+  };
+
+  // two requests using a fair share split the pool
+  run_with_concurrent_request(0, [&]() {
+    ThreadPool::ThreadBudgetScope scope(tp.get(), 0);
+    ASSERT_EQ(ThreadPool::DegreeOfParallelism(tp.get()), 2 * granularity);
+  });
+
+  // threads reserved by an explicit budget are not part of the fair share
+  run_with_concurrent_request(3, [&]() {
+    ThreadPool::ThreadBudgetScope scope(tp.get(), 0);
+    ASSERT_EQ(ThreadPool::DegreeOfParallelism(tp.get()), granularity);
+
+    // loops still run every iteration when the request is left with a single thread
+    auto test_data = CreateTestData(50);
+    ThreadPool::TrySimpleParallelFor(tp.get(), 50, [&](std::ptrdiff_t i) {
+      IncrementElement(*test_data, i);
+    });
+    ValidateTestData(*test_data);
+  });
+
+  // once the concurrent request completes the whole pool is available again
+  ThreadPool::ThreadBudgetScope scope(tp.get(), 0);
+  ASSERT_EQ(ThreadPool::DegreeOfParallelism(tp.get()), full_d_of_p);
+}
+
 #ifdef _WIN32
 #if WINAPI_FAMILY_PARTITION(WINAPI_PARTITION_DESKTOP)
 #pragma warning(push)
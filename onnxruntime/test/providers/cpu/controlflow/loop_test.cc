@@ -1038,6 +1038,72 @@ TEST(Loop, IterationCountAsOutput) {
   test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
 }
 
+// 'cond' is passed through so the number of iterations is known after the first one and the Loop outputs are
+// written in place. sum_in is a subgraph input so it has to be copied to its Loop output.
+TEST(Loop, LoopOutputsWrittenInPlace) {
+  auto create_subgraph = []() {
+    Model model("Loop outputs written in place", false, DefaultLoggingManager().DefaultLogger());
+    auto& graph = model.MainGraph();
+
+    /* Inputs: iter_num, cond_in, loop carried state variables.
+
+         cond_in     sum_in
+            |        |    |
+            |        [Add]
+            |          |
+            |       sum_out
+            |          |
+            |      [Identity]
+            |          |
+         cond_in   sum_out, sum_in, sum_copy
+    */
+
+    TypeProto int64_scalar;
+    int64_scalar.mutable_tensor_type()->set_elem_type(TensorProto_DataType_INT64);
+    int64_scalar.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+
+    TypeProto bool_scalar;
+    bool_scalar.mutable_tensor_type()->set_elem_type(TensorProto_DataType_BOOL);
+    bool_scalar.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+
+    TypeProto float_tensor;
+    float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+    float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+
+    auto& iter_num_in = graph.GetOrCreateNodeArg("iter_num_in", &int64_scalar);
+    auto& cond_in = graph.GetOrCreateNodeArg("cond_in", &bool_scalar);
+    auto& sum_in = graph.GetOrCreateNodeArg("sum_in", &float_tensor);
+
+    auto& sum_out = graph.GetOrCreateNodeArg("sum_out", &float_tensor);
+    auto& sum_copy = graph.GetOrCreateNodeArg("sum_copy", &float_tensor);
+
+    graph.AddNode("add", "Add", "Double sum_in", {&sum_in, &sum_in}, {&sum_out});
+    graph.AddNode("copy", "Identity", "Copy sum_out", {&sum_out}, {&sum_copy});
+
+    graph.SetInputs({&iter_num_in, &cond_in, &sum_in});
+    graph.SetOutputs({&cond_in, &sum_out, &sum_in, &sum_copy});
+
+    auto status = graph.Resolve();
+    EXPECT_EQ(status, Status::OK());
+
+    return graph.ToGraphProto();
+  };
+
+  OpTester test("Loop", 11);
+  auto body = create_subgraph();
+  test.AddAttribute<GraphProto>("body", body);
+  test.AddInput<int64_t>("M", {1}, {4});
+  test.AddInput<bool>("cond", {1}, {true});
+  test.AddInput<float>("sum", {2}, {1.f, 2.f});
+
+  test.AddOutput<float>("sum_final", {2}, {16.f, 32.f});
+  test.AddOutput<float>("sum_ins", {4, 2}, {1.f, 2.f, 2.f, 4.f, 4.f, 8.f, 8.f, 16.f});
+  test.AddOutput<float>("sum_copies", {4, 2}, {2.f, 4.f, 4.f, 8.f, 8.f, 16.f, 16.f, 32.f});
+
+  // Disable TensorRT on unsupported data type BOOL
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+}
+
 #ifdef USE_CUDA
 // test that when part of the subgraph run on CUDA it executes successfully
 TEST(Loop, MixedExecutionProviders) {
@@ -667,6 +667,50 @@ TYPED_TEST(GemmOpTypedTests, TestGemmWithAlphaOpset11) {
       .RunWithConfig();
 }
 
+TEST(GemmOpTest, GemmSparseInitializer) {
+  // A constant B with few non-zero elements is prepacked for the sparse GEMM. The values are small integers so
+  // that the results are exact in any order of accumulation.
+  constexpr int64_t M = 5, K = 36, N = 20;
+  std::vector<float> a(M * K);
+  std::vector<float> b(N * K, 0.0f);  // transposed
+  std::vector<float> c(N);
+  std::vector<float> y(M * N);
+  for (size_t i = 0; i < a.size(); i++) {
+    a[i] = static_cast<float>(static_cast<int64_t>(i % 7) - 3);
+  }
+  for (int64_t n = 0; n < N; n++) {
+    for (int64_t k = 0; k < K; k++) {
+      if ((k * 3 + n * 7) % 19 == 0) {
+        b[n * K + k] = static_cast<float>((k + 2 * n) % 5 - 2);
+      }
+    }
+    c[n] = static_cast<float>(n % 3);
+  }
+  for (int64_t m = 0; m < M; m++) {
+    for (int64_t n = 0; n < N; n++) {
+      float sum = 0.0f;
+      for (int64_t k = 0; k < K; k++) {
+        sum += a[m * K + k] * b[n * K + k];
+      }
+      y[m * N + n] = 0.5f * sum + 2.0f * c[n];
+    }
+  }
+
+  OpTester test("Gemm", 13);
+  test.AddAttribute("transA", static_cast<int64_t>(0));
+  test.AddAttribute("transB", static_cast<int64_t>(1));
+  test.AddAttribute("alpha", 0.5f);
+  test.AddAttribute("beta", 2.0f);
+  test.AddInput<float>("A", {M, K}, a);
+  test.AddInput<float>("B", {N, K}, b, true);
+  test.AddInput<float>("C", {N}, c, true);
+  test.AddOutput<float>("Y", {M, N}, y);
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.emplace_back(DefaultCpuExecutionProvider());
+  test.ConfigEps(std::move(execution_providers))
+      .RunWithConfig();
+}
+
 #ifndef ENABLE_TRAINING
 // Prepacking is disabled in training builds so no need to test the feature in a training build.
 TEST(GemmOpTest, SharedPrepackedWeights) {
@@ -292,6 +292,63 @@ TEST(MathOpTest, MatMul_bfloat16) {
 }
 #endif
 
+TEST(MathOpTest, MatMul_bfloat16_Cpu) {
+  // A has a batch dimension that is broadcast over B. B is tested both as a constant, which is prepacked, and as
+  // a graph input.
+  std::vector<float> a{1.0f, 2.0f, 3.0f, 4.0f, 5.0f,
+                       -1.0f, -2.0f, -3.0f, -4.0f, -5.0f,
+                       0.5f, 0.25f, 0.0f, -0.5f, 2.0f,
+                       1.0f, 0.0f, 1.0f, 0.0f, 1.0f};
+  std::vector<float> b{1.0f, 0.0f, -1.0f,
+                       2.0f, 1.0f, 0.5f,
+                       0.0f, 1.0f, 1.0f,
+                       -1.0f, 2.0f, 0.0f,
+                       1.0f, 1.0f, 1.0f};
+  std::vector<float> y{6.0f, 18.0f, 8.0f,
+                       -6.0f, -18.0f, -8.0f,
+                       3.5f, 1.25f, 1.625f,
+                       2.0f, 2.0f, 1.0f};
+
+  for (bool b_is_initializer : {false, true}) {
+    OpTester test("MatMul", 13);
+    test.AddInput<BFloat16>("A", {2, 2, 5}, FloatsToBFloat16s(a));
+    test.AddInput<BFloat16>("B", {5, 3}, FloatsToBFloat16s(b), b_is_initializer);
+    test.AddOutput<BFloat16>("Y", {2, 2, 3}, FloatsToBFloat16s(y));
+    std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+    execution_providers.emplace_back(DefaultCpuExecutionProvider());
+    test.ConfigEps(std::move(execution_providers))
+        .RunWithConfig();
+  }
+}
+
+TEST(MathOpTest, MatMulSparseInitializer) {
+  // A constant B with one non-zero element per column is prepacked for the sparse GEMM. Y[.., n] = A[.., 2 * n].
+  constexpr int64_t M = 7, K = 40, N = 20;
+  std::vector<float> a(2 * M * K);
+  std::vector<float> b(K * N, 0.0f);
+  std::vector<float> y(2 * M * N);
+  for (size_t i = 0; i < a.size(); i++) {
+    a[i] = static_cast<float>(i % 9) - 4.0f;
+  }
+  for (int64_t n = 0; n < N; n++) {
+    b[2 * n * N + n] = 1.0f;
+  }
+  for (int64_t m = 0; m < 2 * M; m++) {
+    for (int64_t n = 0; n < N; n++) {
+      y[m * N + n] = a[m * K + 2 * n];
+    }
+  }
+
+  OpTester test("MatMul", 13);
+  test.AddInput<float>("A", {2, M, K}, a);
+  test.AddInput<float>("B", {K, N}, b, true);
+  test.AddOutput<float>("Y", {2, M, N}, y);
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.emplace_back(DefaultCpuExecutionProvider());
+  test.ConfigEps(std::move(execution_providers))
+      .RunWithConfig();
+}
+
 #ifndef ENABLE_TRAINING
 // Prepacking is disabled in full training build so no need to test the feature in a training build.
 TEST(MathOpTest, MatMulSharedPrepackedWeights) {
@@ -242,57 +242,55 @@ void GenTreeAndRunTest_as_tensor(int opsetml, const std::vector<T>& X, const std
 }  // namespace test
 
 TEST(MLOpTest, TreeRegressorMultiTargetBatchTreeA2) {
-  // TreeEnsemble implements different paths depending on n_trees or N.
-  // This test and the next ones go through all sections for multi-targets.
+  // This test and the next ones cover one or several rows with one to 130 trees for multi-targets.
   std::vector<float> X = {1.f, 0.0f, 0.4f, 3.0f, 44.0f, -3.f, 12.0f, 12.9f, -312.f, 23.0f, 11.3f, -222.f, 23.0f, 11.3f, -222.f, 23.0f, 3311.3f, -222.f, 23.0f, 11.3f, -222.f, 43.0f, 413.3f, -114.f};
   std::vector<float> results = {1.33333333f, 29.f, 3.f, 14.f, 2.f, 23.f, 2.f, 23.f, 2.f, 23.f, 2.66666667f, 17.f, 2.f, 23.f, 3.f, 14.f};
   std::vector<float> base_values{0.f, 0.f};
-  GenTreeAndRunTest(1, X, base_values, results, "AVERAGE", true, 8, 1);  // section A2
-  GenTreeAndRunTest(3, X, base_values, results, "AVERAGE", true, 8, 1);  // section A2
+  GenTreeAndRunTest(1, X, base_values, results, "AVERAGE", true, 8, 1);
+  GenTreeAndRunTest(3, X, base_values, results, "AVERAGE", true, 8, 1);
 }
 
 TEST(MLOpTest, TreeRegressorMultiTargetBatchTreeA2_as_tensor) {
-  // TreeEnsemble implements different paths depending on n_trees or N.
-  // This test and the next ones go through all sections for multi-targets.
+  // Same as TreeRegressorMultiTargetBatchTreeA2 with tensor attributes.
   std::vector<double> X = {1.f, 0.0f, 0.4f, 3.0f, 44.0f, -3.f, 12.0f, 12.9f, -312.f, 23.0f, 11.3f, -222.f, 23.0f, 11.3f, -222.f, 23.0f, 3311.3f, -222.f, 23.0f, 11.3f, -222.f, 43.0f, 413.3f, -114.f};
   std::vector<float> results = {1.33333333f, 29.f, 3.f, 14.f, 2.f, 23.f, 2.f, 23.f, 2.f, 23.f, 2.66666667f, 17.f, 2.f, 23.f, 3.f, 14.f};
   std::vector<double> base_values{0.f, 0.f};
-  GenTreeAndRunTest_as_tensor(3, X, base_values, results, "AVERAGE", true, 8, 1);  // section A2
+  GenTreeAndRunTest_as_tensor(3, X, base_values, results, "AVERAGE", true, 8, 1);
 }
 
 TEST(MLOpTest, TreeRegressorMultiTargetBatchTreeB2) {
   std::vector<float> X = {1.f, 0.0f, 0.4f, 3.0f, 44.0f, -3.f, 12.0f, 12.9f, -312.f, 23.0f, 11.3f, -222.f, 23.0f, 11.3f, -222.f, 23.0f, 3311.3f, -222.f, 23.0f, 11.3f, -222.f, 43.0f, 413.3f, -114.f};
   std::vector<float> results = {1.33333333f, 29.f, 3.f, 14.f, 2.f, 23.f, 2.f, 23.f, 2.f, 23.f, 2.66666667f, 17.f, 2.f, 23.f, 3.f, 14.f};
   std::vector<float> base_values{0.f, 0.f};
-  GenTreeAndRunTest(1, X, base_values, results, "AVERAGE", true, 8, 130);  // section B2
-  GenTreeAndRunTest(3, X, base_values, results, "AVERAGE", true, 8, 130);  // section B2
+  GenTreeAndRunTest(1, X, base_values, results, "AVERAGE", true, 8, 130);
+  GenTreeAndRunTest(3, X, base_values, results, "AVERAGE", true, 8, 130);
 }
 
 TEST(MLOpTest, TreeRegressorMultiTargetBatchTreeC2) {
   std::vector<float> X = {1.f, 0.0f, 0.4f, 3.0f, 44.0f, -3.f, 12.0f, 12.9f, -312.f, 23.0f, 11.3f, -222.f, 23.0f, 11.3f, -222.f, 23.0f, 3311.3f, -222.f, 23.0f, 11.3f, -222.f, 43.0f, 413.3f, -114.f};
   std::vector<float> results = {1.33333333f, 29.f, 3.f, 14.f, 2.f, 23.f, 2.f, 23.f, 2.f, 23.f, 2.66666667f, 17.f, 2.f, 23.f, 3.f, 14.f};
   std::vector<float> base_values{0.f, 0.f};
-  GenTreeAndRunTest(1, X, base_values, results, "AVERAGE", false, 200, 130);  // section C2
-  GenTreeAndRunTest(3, X, base_values, results, "AVERAGE", false, 200, 130);  // section C2
-  GenTreeAndRunTest(3, X, base_values, results, "AVERAGE", false, 400, 130);  // section C2
+  GenTreeAndRunTest(1, X, base_values, results, "AVERAGE", false, 200, 130);
+  GenTreeAndRunTest(3, X, base_values, results, "AVERAGE", false, 200, 130);
+  GenTreeAndRunTest(3, X, base_values, results, "AVERAGE", false, 400, 130);
 }
 
 TEST(MLOpTest, TreeRegressorMultiTargetBatchTreeD2) {
   std::vector<float> X = {1.f, 0.0f, 0.4f, 3.0f, 44.0f, -3.f, 12.0f, 12.9f, -312.f, 23.0f, 11.3f, -222.f, 23.0f, 11.3f, -222.f, 23.0f, 3311.3f, -222.f, 23.0f, 11.3f, -222.f, 43.0f, 413.3f, -114.f};
   std::vector<float> results = {1.33333333f, 29.f, 3.f, 14.f, 2.f, 23.f, 2.f, 23.f, 2.f, 23.f, 2.66666667f, 17.f, 2.f, 23.f, 3.f, 14.f};
   std::vector<float> base_values{0.f, 0.f};
-  GenTreeAndRunTest(1, X, base_values, results, "AVERAGE", true, 8, 30);     // section D2
-  GenTreeAndRunTest(3, X, base_values, results, "AVERAGE", true, 8, 30);     // section D2
-  GenTreeAndRunTest(1, X, base_values, results, "AVERAGE", false, 200, 30);  // section D2
-  GenTreeAndRunTest(3, X, base_values, results, "AVERAGE", false, 200, 30);  // section D2
+  GenTreeAndRunTest(1, X, base_values, results, "AVERAGE", true, 8, 30);
+  GenTreeAndRunTest(3, X, base_values, results, "AVERAGE", true, 8, 30);
+  GenTreeAndRunTest(1, X, base_values, results, "AVERAGE", false, 200, 30);
+  GenTreeAndRunTest(3, X, base_values, results, "AVERAGE", false, 200, 30);
 }
 
 TEST(MLOpTest, TreeRegressorMultiTargetBatchTreeE2) {
   std::vector<float> X = {1.f, 0.0f, 0.4f, 3.0f, 44.0f, -3.f, 12.0f, 12.9f, -312.f, 23.0f, 11.3f, -222.f, 23.0f, 11.3f, -222.f, 23.0f, 3311.3f, -222.f, 23.0f, 11.3f, -222.f, 43.0f, 413.3f, -114.f};
   std::vector<float> results = {1.33333333f, 29.f, 3.f, 14.f, 2.f, 23.f, 2.f, 23.f, 2.f, 23.f, 2.66666667f, 17.f, 2.f, 23.f, 3.f, 14.f};
   std::vector<float> base_values{0.f, 0.f};
-  GenTreeAndRunTest(1, X, base_values, results, "AVERAGE", false, 200, 1);  // section E2
-  GenTreeAndRunTest(3, X, base_values, results, "AVERAGE", false, 200, 1);  // section E2
+  GenTreeAndRunTest(1, X, base_values, results, "AVERAGE", false, 200, 1);
+  GenTreeAndRunTest(3, X, base_values, results, "AVERAGE", false, 200, 1);
 }
 
 TEST(MLOpTest, TreeRegressorMultiTargetAverage) {
@@ -568,32 +566,38 @@ TEST(MLOpTest, TreeRegressorSingleTargetSumBatch) {
 }
 
 TEST(MLOpTest, TreeRegressorSingleTargetBatchTreeA) {
-  // TreeEnsemble implements different paths depending on n_trees or N.
-  // This test and the next ones goe through all sections for one target.
-  GenTreeAndRunTest1(1, "SUM", true, 3, 1);  // section A
-  GenTreeAndRunTest1(3, "SUM", true, 3, 1);  // section A
+  // This test and the next ones cover one or several rows with one to 130 trees for one target.
+  GenTreeAndRunTest1(1, "SUM", true, 3, 1);
+  GenTreeAndRunTest1(3, "SUM", true, 3, 1);
 }
 
 TEST(MLOpTest, TreeRegressorSingleTargetBatchTreeB) {
-  GenTreeAndRunTest1(1, "AVERAGE", true, 3, 30);  // section B
-  GenTreeAndRunTest1(3, "AVERAGE", true, 3, 30);  // section B
+  GenTreeAndRunTest1(1, "AVERAGE", true, 3, 30);
+  GenTreeAndRunTest1(3, "AVERAGE", true, 3, 30);
 }
 
 TEST(MLOpTest, TreeRegressorSingleTargetBatchTreeC) {
-  GenTreeAndRunTest1(1, "AVERAGE", false, 3, 1);  // section C
-  GenTreeAndRunTest1(3, "AVERAGE", false, 3, 1);  // section C
+  GenTreeAndRunTest1(1, "AVERAGE", false, 3, 1);
+  GenTreeAndRunTest1(3, "AVERAGE", false, 3, 1);
 }
 
 TEST(MLOpTest, TreeRegressorSingleTargetBatchTreeD) {
-  GenTreeAndRunTest1(1, "AVERAGE", false, 201, 30);   // section D
-  GenTreeAndRunTest1(3, "AVERAGE", false, 201, 30);   // section D
-  GenTreeAndRunTest1(1, "AVERAGE", false, 201, 130);  // section D
-  GenTreeAndRunTest1(3, "AVERAGE", false, 201, 130);  // section D
+  GenTreeAndRunTest1(1, "AVERAGE", false, 201, 30);
+  GenTreeAndRunTest1(3, "AVERAGE", false, 201, 30);
+  GenTreeAndRunTest1(1, "AVERAGE", false, 201, 130);
+  GenTreeAndRunTest1(3, "AVERAGE", false, 201, 130);
 }
 
 TEST(MLOpTest, TreeRegressorSingleTargetBatchTreeE) {
-  GenTreeAndRunTest1(1, "AVERAGE", false, 201, 1);  // section E
-  GenTreeAndRunTest1(3, "AVERAGE", false, 201, 1);  // section E
+  GenTreeAndRunTest1(1, "AVERAGE", false, 201, 1);
+  GenTreeAndRunTest1(3, "AVERAGE", false, 201, 1);
+}
+
+TEST(MLOpTest, TreeRegressorSingleTargetManyTrees) {
+  // Enough trees for the evaluation to be split between threads by trees or by rows.
+  GenTreeAndRunTest1(3, "AVERAGE", true, 3, 500);
+  GenTreeAndRunTest1(3, "AVERAGE", false, 3, 500);
+  GenTreeAndRunTest1(3, "AVERAGE", false, 201, 500);
 }
 
 TEST(MLOpTest, TreeRegressorSingleTargetAverage) {
@@ -760,5 +764,59 @@ TEST(MLOpTest, TreeRegressorTrueNodeBeforeNode) {
   test.Run();
 }
 
+void GenTreeAndRunTestMissingTracks(const std::string& mode0, const std::string& mode1,
+                                    const std::vector<float>& results, int64_t n_repeats) {
+  OpTester test("TreeEnsembleRegressor", 3, onnxruntime::kMLDomain);
+
+  // Two stumps, a missing value follows the true branch in the first one and the false branch in the second one.
+  std::vector<int64_t> lefts = {1, 0, 0, 1, 0, 0};
+  std::vector<int64_t> rights = {2, 0, 0, 2, 0, 0};
+  std::vector<int64_t> treeids = {0, 0, 0, 1, 1, 1};
+  std::vector<int64_t> nodeids = {0, 1, 2, 0, 1, 2};
+  std::vector<int64_t> featureids = {0, 0, 0, 1, 0, 0};
+  std::vector<float> thresholds = {0.5f, 0, 0, 0.5f, 0, 0};
+  std::vector<std::string> modes = {mode0, "LEAF", "LEAF", mode1, "LEAF", "LEAF"};
+  std::vector<int64_t> missing_tracks_true = {1, 0, 0, 0, 0, 0};
+
+  std::vector<int64_t> target_treeids = {0, 0, 1, 1};
+  std::vector<int64_t> target_nodeids = {1, 2, 1, 2};
+  std::vector<int64_t> target_ids = {0, 0, 0, 0};
+  std::vector<float> target_weights = {1.f, 2.f, 10.f, 20.f};
+
+  test.AddAttribute("nodes_truenodeids", lefts);
+  test.AddAttribute("nodes_falsenodeids", rights);
+  test.AddAttribute("nodes_treeids", treeids);
+  test.AddAttribute("nodes_nodeids", nodeids);
+  test.AddAttribute("nodes_featureids", featureids);
+  test.AddAttribute("nodes_values", thresholds);
+  test.AddAttribute("nodes_modes", modes);
+  test.AddAttribute("nodes_missing_value_tracks_true", missing_tracks_true);
+  test.AddAttribute("target_treeids", target_treeids);
+  test.AddAttribute("target_nodeids", target_nodeids);
+  test.AddAttribute("target_ids", target_ids);
+  test.AddAttribute("target_weights", target_weights);
+  test.AddAttribute("n_targets", (int64_t)1);
+
+  // Repeats the rows so that several blocks of rows walk the trees together.
+  const float nan = std::numeric_limits<float>::quiet_NaN();
+  std::vector<float> X = {0.f, 1.f, 1.f, 0.f, nan, nan};
+  std::vector<float> xn, yn;
+  for (int64_t i = 0; i < n_repeats; ++i) {
+    xn.insert(xn.end(), X.begin(), X.end());
+    yn.insert(yn.end(), results.begin(), results.end());
+  }
+  test.AddInput<float>("X", {3 * n_repeats, 2}, xn);
+  test.AddOutput<float>("Y", {3 * n_repeats, 1}, yn);
+  test.Run();
+}
+
+TEST(MLOpTest, TreeRegressorMissingValueTracks) {
+  GenTreeAndRunTestMissingTracks("BRANCH_LT", "BRANCH_LT", {21.f, 12.f, 21.f}, 1);
+  GenTreeAndRunTestMissingTracks("BRANCH_LT", "BRANCH_LT", {21.f, 12.f, 21.f}, 30);
+  // Different modes in the same ensemble.
+  GenTreeAndRunTestMissingTracks("BRANCH_LT", "BRANCH_GT", {11.f, 22.f, 21.f}, 1);
+  GenTreeAndRunTestMissingTracks("BRANCH_LT", "BRANCH_GT", {11.f, 22.f, 21.f}, 30);
+}
+
 }  // namespace test
 }  // namespace onnxruntime
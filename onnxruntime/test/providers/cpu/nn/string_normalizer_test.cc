@@ -1,6 +1,6 @@
 ﻿// Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
-#if ((__cplusplus >= 201703L) || (defined(_MSVC_LANG) && (_MSVC_LANG >= 201703L)))
+#if defined(__cpp_char8_t)
 // TODO: handle the u8string.
 #else
 #include "gtest/gtest.h"
@@ -202,6 +202,39 @@ TEST(ContribOpTest, StringNormalizerTest) {
   }
 }
 
+TEST(ContribOpTest, StringNormalizerUnicodeTest) {
+  // - case-INSENSETIVE approach without a locale
+  // - stopwords match regardless of their case, including non-ASCII ones
+  // - LOWER
+  {
+    OpTester test("StringNormalizer", opset_ver, domain);
+    InitTestAttr(test, "LOWER", false, {u8"ÉCOLE", u8"ΣΟΦΙΑ"}, "");
+    std::vector<int64_t> dims{5};
+    std::vector<std::string> input = {std::string(u8"École"),
+                                      std::string(u8"Σοφια"),
+                                      std::string(u8"Straße"),
+                                      std::string(u8"ПРИВЕТ"),
+                                      std::string("MiXeD CaSe AsCiI TeXt")};
+    test.AddInput<std::string>("T", dims, input);
+
+    std::vector<std::string> output = {std::string(u8"straße"),
+                                       std::string(u8"привет"),
+                                       std::string("mixed case ascii text")};
+    test.AddOutput<std::string>("Y", {3}, output);
+    test.Run(OpTester::ExpectResult::kExpectSuccess);
+  }
+  // - invalid utf8 input fails when its case changes
+  {
+    OpTester test("StringNormalizer", opset_ver, domain);
+    InitTestAttr(test, "UPPER", true, {}, "");
+    std::vector<int64_t> dims{2};
+    std::vector<std::string> input = {std::string("monday"), std::string("\xc3\x28")};
+    test.AddInput<std::string>("T", dims, input);
+    test.AddOutput<std::string>("Y", dims, {std::string("MONDAY"), std::string()});
+    test.Run(OpTester::ExpectResult::kExpectFailure, "Input contains invalid utf8 chars");
+  }
+}
+
 }  // namespace test
 }  // namespace onnxruntime
 #endif
\ No newline at end of file
@@ -3,6 +3,7 @@
 
 #include <random>
 #include <cmath>
+#include <numeric>
 #include <type_traits>
 #include "gtest/gtest.h"
 #include "test/common/dnnl_op_test_utils.h"
@@ -3734,6 +3735,95 @@ TEST(ReductionOpTest, ReduceInfLogSumExp_double) {
   test.Run();
 }
 
+// Float reductions use the MLAS reduction kernels for every layout of the reduced axes.
+TEST(ReductionOpTest, ReduceFloat_VectorizedLayouts) {
+  struct Layout {
+    std::vector<int64_t> shape;
+    std::vector<int64_t> axes;
+  };
+  const std::vector<Layout> layouts = {
+      {{37, 19}, {1}},       // KR
+      {{37, 19}, {0}},       // RK
+      {{5, 33, 18}, {1}},    // KRK
+      {{6, 21, 7}, {0, 2}},  // RKR
+  };
+  const std::vector<std::string> ops = {"ReduceSum", "ReduceMean", "ReduceSumSquare", "ReduceL1", "ReduceL2",
+                                        "ReduceLogSum", "ReduceLogSumExp", "ReduceMax", "ReduceMin"};
+
+  std::default_random_engine generator(1234);
+  std::uniform_real_distribution<float> distribution(-2.0f, 2.0f);
+
+  for (const auto& layout : layouts) {
+    const int64_t size = std::accumulate(layout.shape.begin(), layout.shape.end(), int64_t{1}, std::multiplies<int64_t>());
+    std::vector<int64_t> output_shape;
+    std::vector<int64_t> output_strides(layout.shape.size(), 0);
+    int64_t output_size = 1;
+    for (int64_t d = static_cast<int64_t>(layout.shape.size()) - 1; d >= 0; --d) {
+      if (std::find(layout.axes.begin(), layout.axes.end(), d) == layout.axes.end()) {
+        output_strides[d] = output_size;
+        output_size *= layout.shape[d];
+        output_shape.insert(output_shape.begin(), layout.shape[d]);
+      }
+    }
+
+    for (const auto& op : ops) {
+      std::vector<float> data(size);
+      for (auto& v : data) {
+        v = distribution(generator);
+        if (op == "ReduceLogSum") {
+          v = std::fabs(v);
+        }
+      }
+
+      // Group the input values by output element.
+      std::vector<std::vector<double>> groups(output_size);
+      for (int64_t i = 0; i < size; ++i) {
+        int64_t remainder = i;
+        int64_t o = 0;
+        for (int64_t d = static_cast<int64_t>(layout.shape.size()) - 1; d >= 0; --d) {
+          o += (remainder % layout.shape[d]) * output_strides[d];
+          remainder /= layout.shape[d];
+        }
+        groups[o].push_back(data[i]);
+      }
+
+      std::vector<float> expected(output_size);
+      for (int64_t o = 0; o < output_size; ++o) {
+        const auto& g = groups[o];
+        double sum = 0, sum_square = 0, sum_abs = 0, sum_exp = 0;
+        const double max = *std::max_element(g.begin(), g.end());
+        const double min = *std::min_element(g.begin(), g.end());
+        for (double v : g) {
+          sum += v;
+          sum_square += v * v;
+          sum_abs += std::fabs(v);
+          sum_exp += std::exp(v - max);
+        }
+        double result = 0;
+        if (op == "ReduceSum") result = sum;
+        if (op == "ReduceMean") result = sum / g.size();
+        if (op == "ReduceSumSquare") result = sum_square;
+        if (op == "ReduceL1") result = sum_abs;
+        if (op == "ReduceL2") result = std::sqrt(sum_square);
+        if (op == "ReduceLogSum") result = std::log(sum);
+        if (op == "ReduceLogSumExp") result = std::log(sum_exp) + max;
+        if (op == "ReduceMax") result = max;
+        if (op == "ReduceMin") result = min;
+        expected[o] = static_cast<float>(result);
+      }
+
+      OpTester test(op.c_str());
+      test.AddAttribute("axes", layout.axes);
+      test.AddAttribute("keepdims", (int64_t)0);
+      test.AddInput<float>("data", layout.shape, data);
+      test.AddOutput<float>("reduced", output_shape, expected, false, 1e-4f, 1e-4f);
+      std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+      execution_providers.push_back(DefaultCpuExecutionProvider());
+      test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+    }
+  }
+}
+
 // Specific cases for Reduce.
 
 TEST(ReductionOpTest, OptimizeShapeForFastReduce_R_K) {
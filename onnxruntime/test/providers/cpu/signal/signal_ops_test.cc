@@ -1,6 +1,8 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <cmath>
+#include <complex>
 #include <functional>
 #include <vector>
 
@@ -176,6 +178,116 @@ TEST(SignalOpsTest, STFTFloat) {
   test.Run();
 }
 
+// Computes the DFT of `length` values of a real (components == 1) or complex (components == 2) signal.
+static vector<float> NaiveDFT(const vector<float>& input, int64_t length, int64_t components, bool inverse,
+                              bool onesided, const vector<float>* window = nullptr, size_t offset = 0) {
+  const int64_t output_length = onesided ? (length >> 1) + 1 : length;
+  vector<float> output;
+  output.reserve(static_cast<size_t>(output_length * 2));
+  constexpr double pi = 3.14159265358979323846;
+  const double direction = inverse ? 1.0 : -1.0;
+  for (int64_t k = 0; k < output_length; k++) {
+    std::complex<double> sum(0, 0);
+    for (int64_t n = 0; n < length; n++) {
+      const size_t index = offset + static_cast<size_t>(n * components);
+      std::complex<double> x(input[index], components == 2 ? input[index + 1] : 0.0);
+      if (window != nullptr) {
+        x *= (*window)[static_cast<size_t>(n)];
+      }
+      const double angle = direction * 2 * pi * static_cast<double>((n * k) % length) / static_cast<double>(length);
+      sum += x * std::complex<double>(std::cos(angle), std::sin(angle));
+    }
+    if (inverse) {
+      sum /= static_cast<double>(length);
+    }
+    output.push_back(static_cast<float>(sum.real()));
+    output.push_back(static_cast<float>(sum.imag()));
+  }
+  return output;
+}
+
+// Covers the mixed radix (400 = 4 * 4 * 5 * 5, 480 = 4 * 4 * 2 * 3 * 5) and Bluestein (7, 97) transforms of real and
+// complex signals.
+TEST(SignalOpsTest, DFTFloat_mixed_radix_and_bluestein) {
+  RandomValueGenerator random(GetTestRandomSeed());
+  constexpr int64_t num_batches = 2;
+  for (int64_t length : {6, 7, 97, 400, 480}) {
+    for (int64_t components : {1, 2}) {
+      for (bool inverse : {false, true}) {
+        for (bool onesided : {false, true}) {
+          if (onesided && components == 2) {
+            continue;
+          }
+          OpTester test("DFT", kMinOpsetVersion);
+          vector<int64_t> input_shape{num_batches, length, components};
+          vector<float> input = random.Uniform<float>(input_shape, -1.f, 1.f);
+
+          const int64_t output_length = onesided ? (length >> 1) + 1 : length;
+          vector<float> expected_output;
+          for (int64_t b = 0; b < num_batches; b++) {
+            auto batch_output = NaiveDFT(input, length, components, inverse, onesided, nullptr,
+                                         static_cast<size_t>(b * length * components));
+            expected_output.insert(expected_output.end(), batch_output.begin(), batch_output.end());
+          }
+
+          test.AddInput<float>("input", input_shape, input);
+          test.AddAttribute<int64_t>("onesided", static_cast<int64_t>(onesided));
+          test.AddAttribute<int64_t>("inverse", static_cast<int64_t>(inverse));
+          test.AddOutput<float>("output", {num_batches, output_length, 2}, expected_output);
+          test.SetOutputAbsErr("output", 0.001f);
+          test.Run();
+        }
+      }
+    }
+  }
+}
+
+TEST(SignalOpsTest, STFTFloat_frame_length_400) {
+  RandomValueGenerator random(GetTestRandomSeed());
+  constexpr int64_t signal_length = 1200;
+  constexpr int64_t frame_length = 400;
+  constexpr int64_t frame_step = 160;
+  constexpr int64_t n_dfts = (signal_length - frame_length) / frame_step + 1;
+
+  const vector<int64_t> signal_shape{1, signal_length, 1};
+  const vector<int64_t> window_shape{frame_length};
+
+  OpTester test("STFT", kMinOpsetVersion);
+  vector<float> signal = random.Uniform<float>(signal_shape, -1.f, 1.f);
+  vector<float> window = random.Uniform<float>(window_shape, 0.f, 1.f);
+  test.AddInput<float>("signal", signal_shape, signal);
+  test.AddInput<int64_t>("frame_step", {}, {frame_step});
+  test.AddInput<float>("window", window_shape, window);
+  test.AddInput<int64_t>("frame_length", {}, {frame_length});
+
+  vector<float> expected_output;
+  for (int64_t i = 0; i < n_dfts; i++) {
+    auto frame_output = NaiveDFT(signal, frame_length, 1, false, true, &window, static_cast<size_t>(i * frame_step));
+    expected_output.insert(expected_output.end(), frame_output.begin(), frame_output.end());
+  }
+  test.AddOutput<float>("output", {1, n_dfts, (frame_length >> 1) + 1, 2}, expected_output);
+  test.SetOutputAbsErr("output", 0.001f);
+  test.Run();
+}
+
+// A transform of length 0 is rejected instead of building an empty FFT plan.
+TEST(SignalOpsTest, DFTFloat_empty_axis) {
+  OpTester test("DFT", kMinOpsetVersion);
+  test.AddInput<float>("input", {1, 0, 1}, {});
+  test.AddOutput<float>("output", {1, 0, 2}, {});
+  test.Run(OpTester::ExpectResult::kExpectFailure, "The DFT axis must not be empty.");
+}
+
+TEST(SignalOpsTest, STFTFloat_frame_length_0) {
+  OpTester test("STFT", kMinOpsetVersion);
+  test.AddInput<float>("signal", {1, 64, 1}, vector<float>(64, 1));
+  test.AddInput<int64_t>("frame_step", {}, {8});
+  test.AddOptionalInputEdge<float>();
+  test.AddInput<int64_t>("frame_length", {}, {0});
+  test.AddOutput<float>("output", {1, 57, 1, 2}, vector<float>(114, 0));
+  test.Run(OpTester::ExpectResult::kExpectFailure, "The frame_length or the window size must be greater than zero.");
+}
+
 TEST(SignalOpsTest, HannWindowFloat) {
   OpTester test("HannWindow", kMinOpsetVersion);
 
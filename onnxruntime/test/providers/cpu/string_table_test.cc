@@ -0,0 +1,66 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cpu/string_table.h"
+
+#include <unordered_set>
+
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+
+TEST(StringTableTest, Empty) {
+  StringTable table(std::vector<std::string>{});
+  EXPECT_TRUE(table.Empty());
+  EXPECT_EQ(table.Find(""), StringTable::kNotFound);
+  EXPECT_EQ(table.Find("a"), StringTable::kNotFound);
+}
+
+TEST(StringTableTest, FindAndGet) {
+  std::vector<std::string> strings;
+  for (int i = 0; i < 20000; ++i) {
+    strings.push_back("key_" + std::to_string(i) + std::string(i % 37, 'x'));
+  }
+  strings.push_back("");
+  // Duplicates share an id.
+  strings.push_back("key_7xxxxxxx");
+  strings.push_back("");
+
+  StringTable table(strings);
+  ASSERT_EQ(table.Size(), 20001u);
+
+  std::unordered_set<uint32_t> ids;
+  for (const auto& str : strings) {
+    const uint32_t id = table.Find(str);
+    ASSERT_NE(id, StringTable::kNotFound) << str;
+    ASSERT_LT(id, table.IdBound());
+    EXPECT_EQ(table.Get(id), str);
+    ids.insert(id);
+  }
+  EXPECT_EQ(ids.size(), table.Size());
+
+  EXPECT_EQ(table.Find("key_"), StringTable::kNotFound);
+  EXPECT_EQ(table.Find("key_7"), StringTable::kNotFound);
+  EXPECT_EQ(table.Find("key_20000"), StringTable::kNotFound);
+  EXPECT_EQ(table.Find(std::string("key_1\0", 6)), StringTable::kNotFound);
+}
+
+TEST(StringTableTest, PerfectHashMap) {
+  std::vector<std::pair<uint64_t, uint32_t>> entries;
+  for (uint32_t i = 0; i < 5000; ++i) {
+    entries.emplace_back(uint64_t{i} * 7919, i);
+  }
+  entries.emplace_back(std::numeric_limits<uint64_t>::max(), 5000);
+
+  PerfectHashMap<uint32_t> map(entries, std::numeric_limits<uint32_t>::max());
+  for (const auto& entry : entries) {
+    EXPECT_EQ(map.Find(entry.first), entry.second);
+  }
+  for (uint64_t key = 1; key < 7919; key += 97) {
+    EXPECT_EQ(map.Find(key), std::numeric_limits<uint32_t>::max());
+  }
+}
+
+}  // namespace test
+}  // namespace onnxruntime